@@ -94,11 +94,16 @@ namespace Trick {
 
         int integrate();
 
+        bool has_dense_output() { return true; }
+
+        int interpolate_state( double theta, double* state_out);
+
         Integrator_type get_Integrator_type() { return(ABM_Method); };
 
         int counter;
         int primed;
         double **stored_data;
+        bool priming_step;    // -- the last step was one of the Runge Kutta steps that fill stored_data
 
     };
 }
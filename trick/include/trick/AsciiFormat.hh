@@ -0,0 +1,136 @@
+/*
+PURPOSE:
+    (Number to text conversion shared by the ascii data recording format and the variable server.)
+*/
+
+#ifndef ASCIIFORMAT_HH
+#define ASCIIFORMAT_HH
+
+#include <string>
+#include <stddef.h>
+
+namespace Trick {
+
+    /**
+     * A printf floating point format such as "%20.16g".  Formats made of a single %g conversion with an
+     * optional width, precision, and '-' flag are converted without printf and give the same characters
+     * printf would.  Any other format is handed to snprintf.  The round trip format writes the fewest
+     * digits that read back to the same value, without padding.
+     */
+    class AsciiFloatFormat {
+
+        public:
+            AsciiFloatFormat() ;
+            AsciiFloatFormat( const std::string & in_format ) ;
+
+            /**
+             @brief Sets the printf format and checks whether it can be converted without snprintf.
+             @return always 0
+            */
+            int set_format( const std::string & in_format ) ;
+
+            /**
+             @brief Selects the round trip format, or goes back to the printf format when false.
+             @return always 0
+            */
+            int set_round_trip( bool in_round_trip ) ;
+
+            /** printf format string.\n */
+            std::string format ;   /**< trick_io(**) trick_units(--) */
+
+            /** True to write the shortest text that reads back to the same value.\n */
+            bool round_trip ;      /**< trick_io(**) trick_units(--) */
+
+            /** True when #format is converted without snprintf.\n */
+            bool fast ;            /**< trick_io(**) trick_units(--) */
+
+            /** Field width of #format.\n */
+            int width ;            /**< trick_io(**) trick_units(--) */
+
+            /** Significant digits of #format.\n */
+            int precision ;        /**< trick_io(**) trick_units(--) */
+
+            /** True if #format pads on the right.\n */
+            bool left_justify ;    /**< trick_io(**) trick_units(--) */
+    } ;
+
+    /**
+     * Builds a line of text in a caller supplied buffer in a single pass.  Each append writes at the end of
+     * the line and advances the end, so there is no strcat or strlen rescanning of the line.  Appends that
+     * do not fit are dropped and mark the row as overflowed; the caller may rewind to a saved length,
+     * flush, and try again.  The buffer is not null terminated unless terminate() is called.
+     */
+    class AsciiRow {
+
+        public:
+            AsciiRow( char * in_buffer , size_t in_capacity ) ;
+
+            /** Empties the row. */
+            void clear() { len = 0 ; overflowed = false ; }
+
+            /** Shortens the row to in_len characters, clearing the overflow. */
+            void rewind( size_t in_len ) { len = in_len ; overflowed = false ; }
+
+            /** Returns the characters written so far. */
+            size_t length() const { return len ; }
+
+            /** Returns the start of the row. */
+            char * data() const { return buffer ; }
+
+            /** Returns true if an append did not fit. */
+            bool overflow() const { return overflowed ; }
+
+            /** Null terminates the row.  Returns false if there is no room for the terminator. */
+            bool terminate() ;
+
+            void append( char ch ) {
+                if ( len < capacity ) {
+                    buffer[len++] = ch ;
+                } else {
+                    overflowed = true ;
+                }
+            }
+            void append( const char * str , size_t str_len ) ;
+            void append( const char * str ) ;
+            void append( const std::string & str ) { append(str.c_str(), str.length()) ; }
+
+            /** Appends the same characters as printf "%d", "%ld", or "%lld" */
+            void append_int( long long value ) ;
+
+            /** Appends the same characters as printf "%u", "%lu", or "%llu" */
+            void append_uint( unsigned long long value ) ;
+
+            /** Appends a double with the given format */
+            void append_double( double value , const AsciiFloatFormat & fmt ) ;
+
+            /** Appends a float with the given format.  The round trip format writes the shortest text for the float. */
+            void append_float( float value , const AsciiFloatFormat & fmt ) ;
+
+        private:
+            void append_printf( const char * format , double value ) ;
+
+            char * buffer ;
+            size_t capacity ;
+            size_t len ;
+            bool overflowed ;
+    } ;
+
+    /**
+     @brief Writes the shortest digits that read back to value.  value must be finite and greater than 0.
+     The digits, read as an integer, times 10^decimal_exponent are the value.
+     @return the number of digits written to digits, at most 17.
+    */
+    int shortest_digits( double value , char * digits , int & decimal_exponent ) ;
+    int shortest_digits( float value , char * digits , int & decimal_exponent ) ;
+
+    /**
+     @brief Writes value correctly rounded to precision significant digits.  value must be finite and greater
+     than 0 and precision at most 17.  The digits, read as an integer, times 10^decimal_exponent are the
+     rounded value.
+     @return the number of digits written, or 0 if the fast method could not decide the rounding.
+    */
+    int precision_digits( double value , int precision , char * digits , int & decimal_exponent ) ;
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef BINARYCHECKPOINTAGENT_HH
+#define BINARYCHECKPOINTAGENT_HH
+/*
+    PURPOSE: ( BinaryCheckPointAgent - writes and restores checkpoints as a binary image of each allocation.)
+*/
+
+#include <map>
+#include <string>
+#include <vector>
+#include "trick/CheckPointAgent.hh"
+
+namespace Trick {
+
+    /**
+     This class writes a checkpoint as one binary block per allocation instead of the declaration and
+     assignment statements of the ClassicCheckPointAgent.  The checkpointable members of a block are copied as
+     they are in memory.  The type attributes of an allocation are only walked once per type to build a copy
+     plan that gathers the contiguous runs of plain data, translates pointers to an allocation name and offset,
+     and stores the contents of strings.
+
+     Incremental checkpoints write the data of the blocks whose content hash changed since the previous
+     checkpoint written by this agent.  The unchanged blocks refer to the previous checkpoint file, which has
+     to stay next to the incremental one.  Every full_interval-th checkpoint is written in full.
+
+     A checkpoint written by a forked child is made the base of the next incremental checkpoint of the parent
+     with adopt_checkpoint.
+
+     A binary checkpoint is restored with the MemoryManager init_from_checkpoint and read_checkpoint calls
+     while this agent is the current CheckPointAgent.  write_classic_checkpoint converts one to the text format.
+     */
+    class BinaryCheckPointAgent: public CheckPointAgent {
+
+        public:
+
+        /**
+         Constructor.
+         @param  MM MemoryManager.
+         */
+        BinaryCheckPointAgent( Trick::MemoryManager *MM);
+
+        ~BinaryCheckPointAgent();
+
+        /**
+         Test incoming attributes permission check.
+         @param attr Attributes with permision to check.
+         */
+        virtual bool input_perm_check(ATTRIBUTES * attr) ;
+
+        /**
+         Test outgoing attributes permission check.
+         @param attr Attributes with permision to check.
+         */
+        virtual bool output_perm_check(ATTRIBUTES * attr) ;
+
+        /**
+         Not used, the declarations are part of the binary blocks.
+         */
+        void write_decl(std::ostream& chkpnt_os, ALLOC_INFO *alloc_info);
+
+        /**
+         Not used, the values are part of the binary blocks.
+         */
+        void assign_rvalue( std::ostream& chkpnt_os, void* address, ATTRIBUTES* attr, int curr_dim, int offset);
+
+        /**
+         Write the binary checkpoint of the given allocations.
+         @param chkpnt_os Output stream to which the checkpoint is written.
+         @param allocations The allocations to checkpoint, named and in declaration order.
+         @return always true
+         */
+        virtual bool write_checkpoint( std::ostream& chkpnt_os, std::vector<ALLOC_INFO*>& allocations);
+
+        /**
+         Restore memory allocations from a binary checkpoint stream.  The earlier checkpoints an incremental
+         checkpoint refers to are read from the directory of the file set with set_file_name.
+         @param checkpoint_stream Input stream from which the checkpoint is read.
+         @return 0/1 success flag
+         */
+        int restore( std::istream* checkpoint_stream);
+
+        /**
+         Set the name of the file the next checkpoint is written to or read from.  Incremental checkpoints
+         are only written when the file name is known.
+         @param file_name checkpoint file name
+         */
+        void set_file_name( std::string file_name);
+
+        /**
+         Turn incremental checkpoints on or off.  The first checkpoint after this call is written in full.
+         @param flag true = write only the blocks that changed since the previous checkpoint.
+         */
+        void set_incremental( bool flag);
+
+        /**
+         Convert a binary checkpoint file to the classic text format.  The checkpoint is restored and written
+         by a forked copy of this process so the memory of the simulation is not touched.
+         @param binary_file_name binary checkpoint to read.
+         @param classic_file_name text checkpoint to write.
+         @return 0 on success.
+         */
+        int write_classic_checkpoint( std::string binary_file_name, std::string classic_file_name);
+
+        /**
+         Make a checkpoint written by another copy of this agent, in a forked child, the previous checkpoint
+         of the next incremental one.  Only the index at the end of the file is read.
+         @param file_name checkpoint file name
+         @return 0 on success, otherwise the next checkpoint is written in full.
+         */
+        int adopt_checkpoint( std::string file_name);
+
+        /**
+         Test whether a file is a binary checkpoint.
+         @param file_name checkpoint file name
+         @return true if the file starts with the binary checkpoint signature.
+         */
+        static bool is_binary_checkpoint( std::string file_name);
+
+        bool incremental;  /**< ** Write incremental checkpoints. */
+        int full_interval; /**< ** Number of checkpoints in a chain before another full checkpoint. */
+
+        private:
+
+        /** How one part of an object is copied to and from a block.\n */
+        enum CopyType {
+            COPY_PLAIN ,      /**< bytes copied as they are */
+            COPY_BITFIELD ,   /**< one bit field, stored as an int */
+            COPY_POINTER ,    /**< pointers, stored as an allocation name and offset */
+            COPY_STRING ,     /**< std::strings, stored as their contents */
+            COPY_WSTRING ,    /**< std::wstrings, stored as their contents */
+            COPY_NESTED       /**< elements of a structured type, copied with its own plan */
+        } ;
+
+        struct CopyOp ;
+        typedef std::vector<CopyOp> CopyPlan;
+
+        /** One step of a copy plan.\n */
+        struct CopyOp {
+            CopyType type;       /**< how the data is copied */
+            bool absolute;       /**< offset is the address of a static member */
+            bool input;          /**< the data may be restored */
+            long offset;         /**< offset of the data in the object */
+            size_t size;         /**< bytes of a plain copy, element size otherwise */
+            int count;           /**< number of elements */
+            bool char_string;    /**< pointers that may point to unmanaged C strings */
+            ATTRIBUTES* attr;    /**< attributes of bit fields */
+            const CopyPlan* plan; /**< plan of the elements of a nested copy */
+        } ;
+
+        /** A block as it was found in a checkpoint file.\n */
+        struct Block {
+            std::string name;
+            int stcl;
+            int type;
+            std::string user_type_name;
+            int size;
+            int num;
+            int num_index;
+            int index[TRICK_MAX_INDEX];
+            unsigned long long hash;
+            bool has_data;
+            size_t data_offset;
+            size_t data_size;
+        } ;
+
+        /** A checkpoint file read into memory.\n */
+        struct CheckPointFile {
+            std::string file_name;
+            std::string contents;
+            unsigned long long id;
+            unsigned long long base_id;
+            std::string base_name;
+            std::vector<Block> blocks;
+            std::map<std::string, size_t> block_index;
+        } ;
+
+        Trick::MemoryManager* mem_mgr;
+        std::string file_name;
+        std::map<ATTRIBUTES*, CopyPlan*> plans;
+
+        std::map<std::string, unsigned long long> last_hashes;
+        std::vector<std::string> chain;
+        unsigned long long last_id;
+        unsigned long long checkpoint_count;
+        int restore_status;
+
+        const CopyPlan* get_plan( ATTRIBUTES* attr_list);
+        void add_var_ops( CopyPlan& plan, ATTRIBUTES* attr, long offset, bool absolute, bool input);
+        void add_op( CopyPlan& plan, const CopyOp& op);
+
+        void write_plan( std::string& buf, const CopyPlan& plan, char* base);
+        void write_pointer( std::string& buf, void* ptr, bool char_string);
+        bool read_plan( const std::string& buf, size_t& pos, size_t end, const CopyPlan& plan, char* base, bool input,
+                        std::map<std::string, char*>& addresses);
+        bool read_pointer( const std::string& buf, size_t& pos, size_t end, void** ptr, bool input,
+                           std::map<std::string, char*>& addresses);
+
+        void write_block_data( std::string& buf, ALLOC_INFO* alloc_info);
+        bool read_file( CheckPointFile& file, std::istream* is);
+        const Block* find_data( std::vector<CheckPointFile*>& files, size_t file_index, const Block& block, size_t& data_file);
+        std::string make_declaration( const Block& block);
+    } ;
+}
+
+#endif
@@ -84,6 +84,13 @@ namespace Trick {
                                     int         curr_dim,
                                     int         offset
                                     )=0;
+        /**
+         Write the whole checkpoint of the given allocations at once, in place of the declaration and
+         assignment statements written through write_decl and assign_rvalue.
+         @return false if the agent writes declaration and assignment statements.
+         */
+        virtual bool write_checkpoint( std::ostream& , std::vector<ALLOC_INFO*>& ) { return false ; }
+
         /**
          Restore Checkpoint.
          */
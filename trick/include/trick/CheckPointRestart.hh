@@ -9,11 +9,14 @@
 #include <string>
 #include <vector>
 #include <queue>
+#include <sys/types.h>
 
 #include "trick/Scheduler.hh"
 
 namespace Trick {
 
+    class BinaryCheckPointAgent ;
+
     /**
      *
      * This class wraps the MemoryManager class for use in Trick simulations
@@ -48,10 +51,42 @@ namespace Trick {
              * Internal call the MemoryManager checkpoint method with the string argument file_name
              * @param file_name - file name to write checkpoint
              * @param print_status - print a message when checkpoint is written
-             * @return always 0
+             * @return 0, 1 when the checkpoint was skipped because the previous one is still being written
              */
             int do_checkpoint( std::string file_name , bool print_status) ;
 
+            /** Process id of the forked child writing a checkpoint, 0 when none is being written. */
+            pid_t checkpoint_pid ;                                   /**< trick_io(**) */
+
+            /** Name of the checkpoint file the child is writing. */
+            std::string checkpoint_pid_file ;                        /**< trick_io(**) */
+
+            /** Print a message when the child is done. */
+            bool checkpoint_pid_print ;                              /**< trick_io(**) */
+
+            /** Wall clock time the child was forked. */
+            double checkpoint_pid_start ;                            /**< trick_io(**) */
+
+            /**
+             * Writes the checkpoint from a forked child.  The checkpoint is written to a temporary file
+             * and renamed when complete, so a checkpoint file is never partially written.
+             * @return the exit status of the child, 0 on success
+             */
+            int write_forked_checkpoint() ;
+
+            /**
+             * Collects the status of the forked child writing a checkpoint.
+             * @param block - wait for the child to finish
+             * @return always 0
+             */
+            int reap_checkpoint( bool block ) ;
+
+            /**
+             * Returns the binary checkpoint agent, creating it on first use.
+             * @return the binary checkpoint agent
+             */
+            Trick::BinaryCheckPointAgent * get_binary_agent() ;
+
         public:
 
             /** Times to dump a checkpoint. Saved as simulation tics.\n */
@@ -96,6 +131,30 @@ namespace Trick {
             /** CPU to use for checkpoints\n */
             int cpu_num ;                                  /**< trick_units(--) */
 
+            /** If true checkpoints are written in the binary format\n */
+            bool binary_checkpoint ;                                /**< trick_units(--) */
+
+            /** If true binary checkpoints only save the allocations that changed since the last one\n */
+            bool incremental_checkpoint ;                           /**< trick_units(--) */
+
+            /** If true checkpoints are written in the background by a forked copy of the simulation\n */
+            bool async_checkpoint ;                                 /**< trick_units(--) */
+
+            /** Longest wait for a background checkpoint before its child is stopped, <= 0 waits forever\n */
+            double async_checkpoint_timeout ;                       /**< trick_units(s) */
+
+            /** Status of the last checkpoint written in the background, 0 = success\n */
+            int last_checkpoint_status ;                            /**< trick_io(*o) trick_units(--) */
+
+            /** Time the last background checkpoint took to write\n */
+            double last_checkpoint_write_time ;                     /**< trick_io(*o) trick_units(s) */
+
+            /** Number of checkpoints skipped because the previous one was still being written\n */
+            unsigned int skipped_checkpoints ;                      /**< trick_io(*o) trick_units(--) */
+
+            /** Agent that writes and loads the binary checkpoints, created on first use\n */
+            Trick::BinaryCheckPointAgent * binary_agent ;           /**< ** */
+
             /**
              * This is the constructor of the CheckPointRestart class.  It initializes
              * the checkpoint, pre_load_checkpoint, and the restart_queues
@@ -176,7 +235,8 @@ namespace Trick {
             /**
              @brief @userdesc Command to set the CPU to use for checkpoints.  The default is to use the same CPU as the main thread.
              If the main thread of the simulation is running at high real-time priority, it is recommended to
-             choose a different CPU to use for checkpointing.
+             choose a different CPU to use for checkpointing.  Setting a CPU writes checkpoints in the background,
+             see set_async_checkpoint.
              @par Python Usage:
              @code trick.checkpoint_cpu(<in_cpu_num>) @endcode
              @param in_cpu_num - CPU number that Trick will use to perform checkpoints
@@ -184,6 +244,89 @@ namespace Trick {
              */
             int set_cpu_num(int in_cpu_num) ;
 
+            /**
+             @brief @userdesc Command to write checkpoints in the background.  At the checkpoint time the simulation
+             forks, and the child writes the checkpoint from its copy-on-write image of memory while the
+             simulation keeps running.  The child drops any real-time priority and runs on the checkpoint cpu
+             when one is set.  Only one checkpoint is written at a time: a checkpoint that comes due while the previous
+             one is still being written is skipped with a warning and counted in skipped_checkpoints.  Only the
+             end checkpoint and loading a checkpoint wait for the previous one.
+             @par Python Usage:
+             @code trick.checkpoint_async(<yes_no>) @endcode
+             @param yes_no - boolean yes (C integer 1) = write checkpoints in the background, no (C integer 0) = write them in the main thread
+             @return always 0
+             */
+            int set_async_checkpoint(bool yes_no) ;
+
+            /**
+             @brief @userdesc Command to set the longest time a background checkpoint may take.  When the
+             child is still writing this long after it was forked, it is stopped at the end of the frame or when the
+             simulation waits for it, and the checkpoint fails.  The default is 600 seconds.
+             @par Python Usage:
+             @code trick.checkpoint_async_timeout(<in_timeout>) @endcode
+             @param in_timeout - longest wait in seconds, <= 0 waits forever
+             @return always 0
+             */
+            int set_async_checkpoint_timeout(double in_timeout) ;
+
+            /**
+             @brief @userdesc Command to test whether a checkpoint is being written in the background.
+             @par Python Usage:
+             @code trick.checkpoint_in_progress() @endcode
+             @return true while a forked child is writing a checkpoint
+             */
+            bool checkpoint_in_progress() ;
+
+            /**
+             @brief @userdesc Command to wait for the checkpoint being written in the background to finish.
+             The result is in last_checkpoint_status.  A child that does not finish within
+             async_checkpoint_timeout is stopped and the checkpoint fails.
+             @par Python Usage:
+             @code trick.checkpoint_wait() @endcode
+             @return status of the last checkpoint written in the background, 0 = success
+             */
+            int wait_checkpoint() ;
+
+            /**
+             * Reports a background checkpoint that finished without waiting for it, called every frame.
+             * @return always 0
+             */
+            int poll_checkpoint() ;
+
+            /**
+             @brief @userdesc Command to write checkpoints in the binary format.  A binary checkpoint holds a binary
+             image of each allocation and is much faster to write and load than the text format.  It can only be
+             loaded by the same simulation executable on the same kind of machine.  load_checkpoint recognizes
+             binary checkpoints by themselves.
+             @par Python Usage:
+             @code trick.checkpoint_binary(<yes_no>) @endcode
+             @param yes_no - boolean yes (C integer 1) = write binary checkpoints, no (C integer 0) = write text checkpoints
+             @return always 0
+             */
+            int set_binary_checkpoint(bool yes_no) ;
+
+            /**
+             @brief @userdesc Command to write incremental binary checkpoints.  An incremental checkpoint only saves
+             the allocations that changed since the previous checkpoint and refers to the previous checkpoint file
+             for the others, so the files of a chain have to be kept together.  Every tenth checkpoint, and any
+             checkpoint that would overwrite a file of its own chain, is written in full.
+             @par Python Usage:
+             @code trick.checkpoint_incremental(<yes_no>) @endcode
+             @param yes_no - boolean yes (C integer 1) = write incremental checkpoints, no (C integer 0) = write full checkpoints
+             @return always 0
+             */
+            int set_incremental_checkpoint(bool yes_no) ;
+
+            /**
+             @brief @userdesc Command to convert a binary checkpoint to the text format.  The simulation is not changed.
+             @par Python Usage:
+             @code trick.checkpoint_convert("<binary_file_name>", "<text_file_name>") @endcode
+             @param binary_file_name - binary checkpoint file to read
+             @param text_file_name - text checkpoint file to write
+             @return 0 on success
+             */
+            int convert_checkpoint(std::string binary_file_name, std::string text_file_name) ;
+
             /**
              * Get the write_checkpoint_job and safestore_checkpoint jobs.
              * @return always 0
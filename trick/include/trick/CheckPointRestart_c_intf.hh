@@ -34,6 +34,27 @@ int checkpoint_safestore(int yes_no) ;
 /* set the cpu to use for checkpoints */
 int checkpoint_cpu( int in_cpu_num ) ;
 
+/* write checkpoints in the binary format */
+int checkpoint_binary( int yes_no ) ;
+
+/* write incremental binary checkpoints */
+int checkpoint_incremental( int yes_no ) ;
+
+/* convert a binary checkpoint to the text format */
+int checkpoint_convert( const char * binary_file_name , const char * text_file_name ) ;
+
+/* write checkpoints from a forked child */
+int checkpoint_async( int yes_no ) ;
+
+/* set the longest wait for a forked checkpoint */
+int checkpoint_async_timeout( double in_timeout ) ;
+
+/* test whether a forked checkpoint is still being written */
+int checkpoint_in_progress() ;
+
+/* wait for a forked checkpoint to finish */
+int checkpoint_wait() ;
+
 /* safestore checkpoint call accessible from C code */
 int checkpoint_safestore_period( double in_period ) ;
 
@@ -11,6 +11,7 @@ PROGRAMMERS:
 #include <string>
 
 #include "trick/DataRecordGroup.hh"
+#include "trick/AsciiFormat.hh"
 
 #ifdef SWIG
 %feature("shadow") Trick::DRAscii::DRAscii(std::string in_name) %{
@@ -54,6 +55,9 @@ namespace Trick {
             /** Delimiter for separating ascii format fields.\n */
             std::string delimiter;           /**< trick_units(--) */
 
+            /** Write float and double values with the fewest digits that read back to the same value.\n */
+            bool ascii_round_trip;           /**< trick_units(--) */
+
             #ifndef SWIG
             /**
              @brief DRAscii default constructor.
@@ -85,6 +89,11 @@ namespace Trick {
              */
             virtual int format_specific_write_data(unsigned int writer_offset) ;
 
+            /**
+             @copybrief Trick::DataRecordGroup::format_specific_write_rows
+             */
+            virtual int format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) ;
+
             /**
              @copybrief Trick::DataRecordGroup::format_specific_shutdown
              */
@@ -131,16 +140,40 @@ namespace Trick {
             */
             virtual int set_single_prec_only(bool in_single_prec_only) ;
 
+            /**
+             @brief @userdesc Command to print float and double variable values with the fewest digits that read
+             back to the same value instead of with the printf formats (default is false).  Values are not padded.
+             @par Python Usage:
+             @code <dr_group>.set_ascii_round_trip(<in_ascii_round_trip>) @endcode
+             @param in_ascii_round_trip - boolean true indicates print the shortest round trip values
+             @return always 0
+            */
+            int set_ascii_round_trip(bool in_ascii_round_trip) ;
+
         private:
 
             /**
-             @brief Copies value of variable to ascii buffer
+             @brief Appends the value of variable to the row
              @return always 0
             */
-            int copy_data_ascii_item( Trick::DataRecordBuffer * DI, int item_num, char *buf ) ;
+            int copy_data_ascii_item( Trick::DataRecordBuffer * DI, int item_num, Trick::AsciiRow & row ) ;
+
+            /**
+             @brief Appends one record as a line of text to the row
+            */
+            void format_row( Trick::AsciiRow & row , unsigned int writer_offset ) ;
+
+            /** #ascii_float_format parsed for the row builder */
+            Trick::AsciiFloatFormat float_format ; /**< trick_io(**)  */
+
+            /** #ascii_double_format parsed for the row builder */
+            Trick::AsciiFloatFormat double_format ; /**< trick_io(**)  */
 
             /** Output stream for the log file */
-            std::fstream out_stream ; /**< trick_io(**)  */
+            Trick::DataRecordStream out_stream ; /**< trick_io(**)  */
+
+            /** Largest number of characters one record may format to */
+            unsigned int max_row_size ; /**< trick_io(**)  */
 
     } ;
 
@@ -10,6 +10,8 @@ PROGRAMMERS:
 
 #include <stdio.h>
 #include <string>
+#include <vector>
+#include <sys/uio.h>
 
 #include "trick/DataRecordGroup.hh"
 
@@ -110,14 +112,31 @@ namespace Trick {
              */
             virtual int format_specific_write_data(unsigned int writer_offset) ;
 
+            /**
+             @copybrief Trick::DataRecordGroup::format_specific_write_rows
+             */
+            virtual int format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) ;
+
             /**
              @copybrief Trick::DataRecordGroup::shutdown
              */
             virtual int format_specific_shutdown() ;
 
         private:
+            /** Copies one record to dest.  Returns the number of bytes copied. */
+            unsigned int pack_record( char * dest , unsigned int writer_offset ) ;
+
+            /** Adds one piece of the header to the list written by writev */
+            static void add_iovec( std::vector< struct iovec > & iov , const void * base , size_t len ) ;
+
             /** The log file.\n */
-            int fd ;             /**< trick_io(**) trick_units(--) */
+            Trick::DataRecordStream stream ;   /**< trick_io(**) trick_units(--) */
+
+            /** Number of bytes in one record in the log file.\n */
+            unsigned int row_size ;            /**< trick_io(**) trick_units(--) */
+
+            /** Number of records #writer_buff holds.\n */
+            unsigned int rows_per_block ;      /**< trick_io(**) trick_units(--) */
 
     } ;
 
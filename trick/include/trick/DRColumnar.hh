@@ -0,0 +1,155 @@
+/*
+PURPOSE:
+    (Data Record Columnar class.)
+*/
+
+#ifndef DRCOLUMNAR_HH
+#define DRCOLUMNAR_HH
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "trick/DataRecordGroup.hh"
+
+#ifdef SWIG
+%feature("shadow") Trick::DRColumnar::DRColumnar(std::string in_name) %{
+    def __init__(self, *args):
+        this = $action(*args)
+        try: self.this.append(this)
+        except: self.this = this
+        this.own(0)
+        self.this.own(0)
+%}
+#endif
+
+namespace Trick {
+
+    /**
+      The DRColumnar recording format is a Trick simulation specific format laid out so that a reader can pull a
+      single variable or a time window out of a large file without reading the rest of it.  Files written in this
+      format are named log_<group_name>.trkc.  The header is the same as the Trick::DRBinary header with a
+      "Trick-CL-<e>" magic string.  The records follow in chunks.  Each chunk holds the values of one variable
+      after another instead of one record after another.  An index of the chunks is appended when the file is
+      closed.  See trick/columnar_log.h for the structures.
+
+      <center>
+      <table>
+      <tr><th>Value</th><th>Description</th><th>Type</th><th>Bytes</th></tr>
+      <tr><td colspan=4 align=center>START OF HEADER</td></tr>
+      <tr><td>Trick-CL-\<e\></td><td>\<e\> is endianness, 1 character: L for little endian, B for big endian</td>
+       <td>string</td><td>10</td></tr>
+      <tr><td colspan=4 align=center>PARAMETER DESCRIPTIONS, SAME AS Trick::DRBinary</td></tr>
+      <tr><td colspan=4 align=center>END OF HEADER, START OF CHUNK</td></tr>
+      <tr><td>\<num_rows\></td><td>Number of records in the chunk</td><td>uint32</td><td>4</td></tr>
+      <tr><td>0</td><td>Reserved</td><td>uint32</td><td>4</td></tr>
+      <tr><td>\<time\></td><td>Time of the first record in the chunk</td><td>double</td><td>8</td></tr>
+      <tr><td>\<time\></td><td>Time of the last record in the chunk</td><td>double</td><td>8</td></tr>
+      <tr><td>\<min\> \<max\></td><td>Smallest and largest value of parameter \#1 in the chunk</td><td>double</td><td>16</td></tr>
+      <tr><td></td><td>.</td><td></td><td></td></tr>
+      <tr><td>\<min\> \<max\></td><td>Smallest and largest value of parameter \#n in the chunk</td><td>double</td><td>16</td></tr>
+      <tr><td>\<values\></td><td>parameter \#1 Values</td><td>10</td><td>8 * \<num_rows\></td></tr>
+      <tr><td></td><td>.</td><td></td><td></td></tr>
+      <tr><td>\<values\></td><td>parameter \#n Values</td><td>\<type\></td><td>\<size\> * \<num_rows\></td></tr>
+      <tr><td colspan=4 align=center>REPEAT CHUNK</td></tr>
+      <tr><td colspan=4 align=center>START OF FOOTER, WRITTEN WHEN THE FILE IS CLOSED</td></tr>
+      <tr><td>\<offset\></td><td>File offset of each chunk</td><td>uint64</td><td>8 * \<num_chunks\></td></tr>
+      <tr><td>\<num_chunks\></td><td>Number of chunks</td><td>uint64</td><td>8</td></tr>
+      <tr><td>TRKCFOOT</td><td>Footer marker</td><td>string</td><td>8</td></tr>
+      </table>
+      <b>Columnar Data Format</b>
+      </center>
+
+      Records are held in memory until a chunk is full.  The last partial chunk is written at shutdown.  Compression
+      is not applied to this format because readers map the file into memory.
+    */
+    class DRColumnar : public Trick::DataRecordGroup {
+
+        public:
+
+            #ifndef SWIG
+            /**
+             @brief DRColumnar default constructor.
+             */
+            DRColumnar() {}
+            #endif
+            ~DRColumnar() {}
+
+            /**
+             @brief @userdesc Create a new Columnar data recording group.
+             @par Python Usage:
+             @code <my_drg> = trick.DRColumnar("<in_name>") @endcode
+             @copydoc Trick::DataRecordGroup::DataRecordGroup(string in_name)
+             */
+            DRColumnar( std::string in_name ) ;
+
+            /**
+             @brief @userdesc Command to set the number of records in each chunk of the log file (default 4096).
+             Smaller chunks let readers skip more precisely to a time window, larger chunks have less overhead.
+             Must be called before the group is initialized.
+             @par Python Usage:
+             @code <dr_group>.set_chunk_size(<rows>) @endcode
+             @param rows - number of records per chunk
+             @return 0 if successful, -1 if rows is 0
+            */
+            int set_chunk_size( unsigned int rows ) ;
+
+            /**
+             @copybrief Trick::DataRecordGroup::format_specific_header
+             */
+            virtual int format_specific_header(std::fstream & outstream) ;
+
+            /**
+             @copybrief Trick::DataRecordGroup::format_specific_init
+             */
+            virtual int format_specific_init() ;
+
+            /**
+             @copybrief Trick::DataRecordGroup::format_specific_write_data
+             */
+            virtual int format_specific_write_data(unsigned int writer_offset) ;
+
+            /**
+             @copybrief Trick::DataRecordGroup::format_specific_write_rows
+             */
+            virtual int format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) ;
+
+            /**
+             @copybrief Trick::DataRecordGroup::shutdown
+             */
+            virtual int format_specific_shutdown() ;
+
+        protected:
+            /** Number of records in each chunk.\n */
+            unsigned int rows_per_chunk ;      /**< trick_io(*io) trick_units(--) */
+
+        private:
+            /** Copies one record into the columns of the current chunk and updates the ranges. */
+            void add_row( unsigned int writer_offset ) ;
+
+            /** Writes the current chunk to the file.  Returns the number of bytes written. */
+            int write_chunk() ;
+
+            /** The log file.\n */
+            Trick::DataRecordStream stream ;   /**< trick_io(**) trick_units(--) */
+
+            /** Records in the current chunk.\n */
+            unsigned int chunk_rows ;          /**< trick_io(**) trick_units(--) */
+
+            /** Offset of each column in #writer_buff.\n */
+            std::vector< unsigned int > column_offset ;   /**< trick_io(**) */
+
+            /** Smallest and largest value of each variable in the current chunk, interleaved.\n */
+            std::vector< double > column_range ;          /**< trick_io(**) */
+
+            /** Offset of the next byte written to the file.\n */
+            uint64_t file_offset ;             /**< trick_io(**) trick_units(--) */
+
+            /** File offset of each chunk written.\n */
+            std::vector< uint64_t > chunk_offsets ;       /**< trick_io(**) */
+
+    } ;
+
+} ;
+
+#endif
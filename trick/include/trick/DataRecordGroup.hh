@@ -14,6 +14,7 @@ PROGRAMMERS:
 #include <pthread.h>
 
 #include "trick/SimObject.hh"
+#include "trick/DataRecordStream.hh"
 #include "trick/reference.h"
 
 namespace Trick {
@@ -133,6 +134,12 @@ namespace Trick {
             /**  Type of buffering.\n */
             DR_Buffering buffer_type ;  /**< trick_io(*io) trick_units(--) */
 
+            /**  Compression of the log file, Trick::DR_Compression.  Used by the ascii and binary formats.\n */
+            int compression ;           /**< trick_io(*io) trick_units(--) */
+
+            /**  zlib compression level 1-9.\n */
+            int compression_level ;     /**< trick_io(*io) trick_units(--) */
+
             /**  The job class name for this recording group.\n */
             std::string job_class ;          /**< trick_io(*io) trick_units(--) */
 
@@ -223,6 +230,18 @@ namespace Trick {
             */
             virtual int set_max_file_size(uint64_t bytes) ;
 
+            /**
+             @brief @userdesc Command to compress the log file as it is written (default is DR_No_Compression).
+             Compression is done by the thread writing the data, which is the data record writer thread
+             for DR_Buffer groups.  Only the ascii and binary formats compress.  The file name gets a ".gz" suffix.
+             @par Python Usage:
+             @code <dr_group>.set_compression(<compression> [, <level>]) @endcode
+             @param in_compression - Trick::DR_Compression
+             @param level - zlib compression level 1-9, 1 is fastest
+             @return always 0
+            */
+            virtual int set_compression(int in_compression , int level = 1) ;
+
 
             /**
              @brief @userdesc Command to print double variable values as single precision (float) in the log file to save space.
@@ -308,6 +327,14 @@ namespace Trick {
             */
             virtual int format_specific_write_data(unsigned int writer_offset) = 0 ;
 
+            /**
+             @brief Transfer num_rows consecutive records starting at writer_offset.  The records do not wrap
+             around the end of the buffer.  The default calls format_specific_write_data for each record.
+             Formats override this to write many records per system call.
+             @returns the number of bytes written
+            */
+            virtual int format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) ;
+
             /**
              @brief Shutdown loggroup. implemented in derived groups.
              @returns always 0
@@ -408,7 +435,11 @@ namespace Trick {
             /** Max number of digits to expect per recorded value.\n */
             static const unsigned int record_size = 25; /**< trick_io(**) trick_units(--) */
 
-            /** Data thread condition mutex.  */
+            /** Target number of bytes to collect before writing to the log file.\n */
+            static const unsigned int write_block_size = 65536; /**< trick_io(**) trick_units(--) */
+
+            /** Serializes writers.  Forced writes from the recording thread and the writer thread may
+                both call write_data.  The recording thread does not take it to add a record. */
             pthread_mutex_t buffer_mutex;    /**< trick_io(**) */
 
             /** Current time saved in Trick::DataRecordGroup::data_record.\n */
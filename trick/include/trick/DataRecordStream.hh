@@ -0,0 +1,94 @@
+/*
+PURPOSE:
+    (Output file used by the ascii and binary data recording formats.)
+*/
+
+#ifndef DATARECORDSTREAM_HH
+#define DATARECORDSTREAM_HH
+
+#include <string>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace Trick {
+
+    /**
+     * The DR_Compression enumeration represents the possible compression of a recording file.
+     */
+    enum DR_Compression {
+        DR_No_Compression = 0,  /**< write the file as is */
+        DR_Gzip = 1             /**< compress the file as a gzip stream, ".gz" is appended to the file name */
+    } ;
+
+    /**
+     * File descriptor based log file.  Writes go straight to the file, or through a zlib deflate
+     * stream when compression is on.  Compression runs in whichever thread writes the data, which is
+     * the data record writer thread for DR_Buffer groups.
+     */
+    class DataRecordStream {
+
+        public:
+            DataRecordStream() ;
+            ~DataRecordStream() ;
+
+            /**
+             @brief Creates the file.
+             @param file_name - name of the file, ".gz" is appended if compressing
+             @param in_compression - Trick::DR_Compression
+             @param level - zlib compression level 1-9
+             @param append - add to the end of an existing file instead of truncating it
+             @return 0 if successful, -1 if the file could not be created
+            */
+            int open( std::string file_name , int in_compression = DR_No_Compression , int level = 1 ,
+             bool append = false ) ;
+
+            /**
+             @brief Writes len bytes.
+             @return the number of uncompressed bytes accepted, -1 on error
+            */
+            ssize_t write( const void * buf , size_t len ) ;
+
+            /**
+             @brief Writes iovcnt buffers in one call.
+             @return the number of uncompressed bytes accepted, -1 on error
+            */
+            ssize_t writev( const struct iovec * iov , int iovcnt ) ;
+
+            /**
+             @brief Finishes the compressed stream, if any, and closes the file.
+             @return 0 if successful
+            */
+            int close() ;
+
+            /** @return true if the file is open */
+            bool is_open() ;
+
+        protected:
+            /** Writes all len bytes to the file descriptor, retrying partial writes */
+            ssize_t write_all( const char * buf , size_t len ) ;
+
+            /** Writes the buffers straight to the file */
+            ssize_t writev_plain( const struct iovec * iov , int iovcnt ) ;
+
+            /** Writes the buffers through the deflate stream */
+            ssize_t writev_compressed( const struct iovec * iov , int iovcnt ) ;
+
+            /** Runs deflate over the input and writes the output */
+            int deflate_buffer( const void * buf , size_t len , int flush ) ;
+
+            /** The file descriptor */
+            int fd ;                        /**< trick_io(**) */
+
+            /** Compression type, Trick::DR_Compression */
+            int compression ;               /**< trick_io(**) */
+
+            /** zlib stream, allocated when compressing */
+            void * zstream ;                /**< trick_io(**) */
+
+            /** Buffer for compressed output */
+            char * zbuffer ;                /**< trick_io(**) */
+    } ;
+
+} ;
+
+#endif
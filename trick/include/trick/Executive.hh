@@ -77,6 +77,9 @@ namespace Trick {
             /** Allows the current thread to give up the cpu during multi process job completion and dependency checking.\n */
             bool rt_nap;                      /**< trick_units(--) */
 
+            /** Scheduled job queues dispatch from a timing wheel instead of scanning all jobs each pass.\n */
+            bool job_dispatch_schedule;       /**< trick_units(--) */
+
             /** Software frame time.  The end_of_frame jobs will be run at this frequency.\n */
             double software_frame;            /**< trick_units(s) */
 
@@ -396,6 +399,14 @@ namespace Trick {
             */
             bool get_rt_nap() ;
 
+            /**
+             @userdesc Command to get the job dispatch schedule toggle value.
+             @par Python Usage:
+             @code <my_int> = trick.exec_get_job_dispatch_schedule() @endcode
+             @return boolean (C integer 0/1) Executive::job_dispatch_schedule
+            */
+            bool get_job_dispatch_schedule() ;
+
             /**
              @userdesc Command to get starting index to first scheduled class job.
              @par Python Usage:
@@ -607,6 +618,17 @@ namespace Trick {
              */
             int set_rt_nap(bool on_off) ;
 
+            /**
+             @userdesc Command to enable the job dispatch schedule in the scheduled job queues of all threads.
+             Jobs are bucketed by their next call time so each pass only visits the jobs that are due instead
+             of scanning every job in the queue.  Job execution order is unchanged.  The default is disabled.
+             @par Python Usage:
+             @code trick.exec_set_job_dispatch_schedule(<on_off>) @endcode
+             @param on_off - boolean yes (C integer 1) = enable dispatch schedule, no (C integer 0) = scan all jobs
+             @return always 0
+             */
+            int set_job_dispatch_schedule(bool on_off) ;
+
             /**
              @userdesc Command to set the real-time frame for real-time synchronization.
              @par Python Usage:
@@ -766,6 +788,21 @@ namespace Trick {
              */
             int set_job_onoff(std::string job_name, int instance_num, int on) ;
 
+            /**
+             @userdesc Command to mark the job with the name "job_name" as parallel.
+             If job_name is a job tag (from the S_define file), then mark all jobs with that tag.
+             Parallel jobs of the same class and phase in one thread are run together on the thread's
+             job pool when the thread has parallel workers.  They must not depend on one another
+             through shared data.  Ordering between them may be kept with depends lists.
+             @par Python Usage:
+             @code trick.exec_set_job_parallel("<job_name>", <instance>, <on>) @endcode
+             @param job_name - name of job from S_job_execution file
+             @param instance - the instance number of the job in the sim_object.  Starts at 1.
+             @param on - 1 to mark the job parallel, 0 to run it serially
+             @return 0 if successful or -1 if the job cannot be found
+             */
+            int set_job_parallel(std::string job_name, int instance_num, int on) ;
+
             /**
              @userdesc Command to change job cycle time with the name "job_name".
              If job_name is a job tag (from the S_define file), then change cycle time of all jobs with that tag.
@@ -778,6 +815,14 @@ namespace Trick {
              */
             int set_job_cycle(std::string job_name, int instance_num, double in_cycle) ;
 
+            /**
+             Notifies the thread job queue that a job next call time was changed outside of the scheduler.
+             Required when the dispatch schedule is enabled and the next call time was moved earlier.
+             @param job - the job with the changed next call time
+             @return 0 if successful or -1 if the job is not in its thread job queue
+             */
+            int reschedule_job(Trick::JobData * job) ;
+
             /**
              @userdesc Command to turn on/off all jobs in the sim_object.
              @par Python Usage:
@@ -987,9 +1032,12 @@ namespace Trick {
              * @brief Adds JobData pointer to assigned thread queue if scheduled class job.  For non-scheduled jobs i.e. "initialization",
              * all jobs added to main thread queues.
              * @param job_data - pointer to current job to be added to queue.
+             * @param batch - if not NULL, the job is collected here by queue instead of pushed.  The caller adds the
+             *        collected jobs with Trick::ScheduledJobQueue::push_all.
              * @return always 0
              */
-            virtual int add_job_to_queue( Trick::JobData * job_data ) ;
+            virtual int add_job_to_queue( Trick::JobData * job_data ,
+             std::map< Trick::ScheduledJobQueue * , std::vector< Trick::JobData * > > * batch = NULL ) ;
 
             /**
              * @brief Removes the sim_object and all of its jobs from the simulation.
@@ -1096,6 +1144,30 @@ namespace Trick {
             */
             virtual int set_thread_process_type(unsigned int thread_id , int process_type) ;
 
+            /**
+             @userdesc Command to set how a thread waits for other threads and for the jobs it depends on.
+             Spinning gives the lowest latency but occupies a processor for the whole wait.  Spin then
+             futex spins an adaptive number of times before blocking.  Block gives up the processor at once.
+             The main thread's policy is used when it waits for child threads.
+             @par Python Usage:
+             @code trick.exec_set_thread_wait_policy(<thread_id>, <policy>) @endcode
+             @param thread_id - thread id as specified in S_define file
+             @param policy - integer representation of enumeration.  0 = spin, 1 = spin then futex, 2 = block
+             @return 0 if successful, -2 if thread does not exist. -1 if policy does not exist
+            */
+            virtual int set_thread_wait_policy(unsigned int thread_id , int policy) ;
+
+            /**
+             @userdesc Command to set the number of helper threads that run the parallel jobs of a thread.
+             The thread itself also runs parallel jobs.  0 runs all jobs serially on the thread.
+             @par Python Usage:
+             @code trick.exec_set_thread_parallel_workers(<thread_id>, <num_workers>) @endcode
+             @param thread_id - thread id as specified in S_define file
+             @param num_workers - number of helper threads
+             @return 0 if successful, -2 if thread does not exist.
+            */
+            virtual int set_thread_parallel_workers(unsigned int thread_id , unsigned int num_workers) ;
+
             /**
              @userdesc Command to set an asynchronous_must_finish child thread's cycle_time.
              @par Python Usage:
@@ -0,0 +1,88 @@
+#ifndef IPCONDITION_HH
+#define IPCONDITION_HH
+/*
+    PURPOSE: ( IPCondition Class evaluates simple event conditions without Python.)
+*/
+
+#include <string>
+#include <vector>
+#include "trick/reference.h"
+
+namespace Trick {
+
+/**
+  This class holds an event condition string compiled to an expression tree over model variable addresses.
+  Only a subset of Python is compiled:  model variables that hold a single number or bool, number literals, True,
+  False, the comparisons <, <=, >, >=, == and !=, and, or, not, and parentheses.  Any other condition is left to
+  Python.
+ */
+    class IPCondition {
+
+        public:
+            /**
+             @brief Compiles a condition string.
+             @param str - the condition input boolean expression
+             @return the compiled condition, or NULL if str uses anything that is not compiled
+            */
+            static IPCondition * compile( const std::string & str ) ;
+
+            ~IPCondition() ;
+
+            /**
+             @brief Looks up the variable references again, called when a checkpoint is loaded.
+             @return true if all variables were found
+            */
+            bool resolve() ;
+
+            /**
+             @brief Evaluates the condition.
+             @param result - set to 1 if the condition is true, 0 otherwise
+             @return false if a variable could not be reached or holds an unsigned value beyond long long, and the
+             condition must be evaluated by Python
+            */
+            bool evaluate( int & result ) ;
+
+        private:
+            enum NodeType { LITERAL , VARIABLE , NOT , AND , OR , LT , LE , GT , GE , EQ , NE } ;
+
+            /** A number, either an integer or a double, as Python sees it.\n */
+            struct Value {
+                bool is_int ;
+                long long i ;
+                double d ;
+            } ;
+
+            /** One node of the expression tree, children are indexes into nodes.\n */
+            struct Node {
+                NodeType type ;
+                Value value ;
+                std::string name ;
+                REF2 * ref ;
+                int left ;
+                int right ;
+            } ;
+
+            IPCondition() ;
+
+            int parse_or( const char *& p ) ;
+            int parse_and( const char *& p ) ;
+            int parse_not( const char *& p ) ;
+            int parse_comparison( const char *& p ) ;
+            int parse_operand( const char *& p ) ;
+            int add_node( NodeType type , int left = -1 , int right = -1 ) ;
+            bool resolve_node( Node & node ) ;
+
+            bool get_value( int index , Value & value ) ;
+            bool get_bool( int index , bool & result ) ;
+
+            std::vector< Node > nodes ;
+            int root ;
+
+            // Not copyable, the condition owns its references.
+            IPCondition( const IPCondition & ) ;
+            IPCondition & operator=( const IPCondition & ) ;
+    } ;
+
+}
+
+#endif
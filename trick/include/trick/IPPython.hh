@@ -81,6 +81,22 @@ namespace Trick {
             */
             virtual int parse_condition(std::string in_string, int & cond_return_val) ;
 
+            /**
+             @brief Compiles a condition statement once so that it can be run without parsing the string each time.
+             @return the compiled Python code object, or NULL if the string does not compile
+            */
+            void * compile_condition(std::string in_string) ;
+
+            /**
+             @brief Command to run a condition statement compiled by compile_condition.
+            */
+            int parse_condition(void * in_code, int & cond_return_val) ;
+
+            /**
+             @brief Releases a condition statement compiled by compile_condition.
+            */
+            void delete_condition(void * in_code) ;
+
             /**
              @brief Restore variables with memory manager names to python space.
              @return always 0
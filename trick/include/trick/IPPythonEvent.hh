@@ -16,6 +16,7 @@
 namespace Trick {
 
     class IPPython ;
+    class IPCondition ;
     class MTV ;
 
     /** Data associated with each event condition.\n */
@@ -42,6 +43,10 @@ namespace Trick {
         Trick::JobData * job ;                  /**< trick_io(**) trick_units(--) */
         /** Type of condition string: 0=python, 1=variable, 2=job.\n */
         int  cond_type ;                        /**< trick_io(*io) trick_units(--) */
+        /** Python condition string compiled to an expression tree over model variables, NULL if it needs Python.\n */
+        Trick::IPCondition * expr ;             /**< trick_io(**) trick_units(--) */
+        /** Python condition string compiled to a Python code object, used when there is no expression tree.\n */
+        void * code ;                           /**< trick_io(**) trick_units(--) */
     } ;
 
     /** Data associated with each event action.\n */
@@ -104,6 +109,8 @@ namespace Trick {
             int fired_count ;                       /**< trick_io(*io) trick_units(--) */
             /** @userdesc Last simulation time that this event fired.\n */
             double fired_time ;                     /**< trick_io(*io) trick_units(s) */
+            /** @userdesc Total wall clock time spent evaluating this event's conditions.\n */
+            double cond_eval_time ;                 /**< trick_io(*io) trick_units(s) */
             /** Count of how many actions this event has.\n */
             int action_count ;                      /**< trick_io(*io) trick_units(--) */
             /** @userdesc Count of how many times this event has run its actions.\n */
@@ -405,6 +412,15 @@ namespace Trick {
 
         private:
 
+            /* Compiles a python condition string to an expression tree, or to a python code object */
+            void compile_condition(condition_t * cond) ;
+
+            /* Deletes the compiled forms of a condition */
+            void delete_compiled_condition(condition_t * cond) ;
+
+            /* Evaluates a python condition string with its compiled forms */
+            int evaluate_condition_string(condition_t * cond) ;
+
             /* A static pointer to the python input processor set at the S_define level */
             static Trick::IPPython * ip ;
 
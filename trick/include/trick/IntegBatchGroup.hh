@@ -0,0 +1,212 @@
+/*
+PURPOSE:
+    ( Batched integration of many small, identical state vectors )
+*/
+
+#ifndef INTEGBATCHGROUP_HH
+#define INTEGBATCHGROUP_HH
+
+// Local includes
+#include "trick/Integrator.hh"
+
+// System includes
+#include <vector>
+
+namespace Trick {
+
+    /**
+     * An IntegBatchGroup integrates the state vectors of many objects that
+     * use the same integration technique and the same state size with one
+     * integrator.
+     *
+     * Before each integration pass the states and derivatives of the members
+     * are gathered into contiguous structure-of-arrays buffers, in which
+     * element k of every member is stored consecutively. The buffers are
+     * advanced with a single call to the integrator, and the results are
+     * scattered back to the members.
+     *
+     * The integration techniques advance each element of the state
+     * independently of the others, so a member of a group arrives at the
+     * same bits as it would with an integrator of its own.
+     *
+     * Groups are created and owned by an IntegLoopScheduler, see
+     * IntegLoopScheduler::add_batch_state.
+     */
+    class IntegBatchGroup {
+
+        public:
+
+            /**
+             * Constructor.
+             * @param in_alg           Integration technique.
+             * @param in_size          Size of the state vector of each member.
+             *                         For a second order group, the size of
+             *                         the position vector.
+             * @param in_second_order  True if the members are integrated with
+             *                         integrate_2nd_order_ode.
+             */
+            IntegBatchGroup (
+                Integrator_type in_alg,
+                unsigned int in_size,
+                bool in_second_order);
+
+            /**
+             * Destructor. Deletes the integrator.
+             */
+            ~IntegBatchGroup ();
+
+            /**
+             * Determine if states with the specified technique and size
+             * belong to this group.
+             */
+            bool matches (
+                Integrator_type in_alg,
+                unsigned int in_size,
+                bool in_second_order) const;
+
+            /**
+             * Add a member to a first order group.
+             * @param state  State vector of the member, advanced in place.
+             * @param deriv  Time derivative of the state vector.
+             */
+            void add_state (double * state, double * deriv);
+
+            /**
+             * Add a member to a second order group.
+             * @param position  Position vector, advanced in place.
+             * @param velocity  Velocity vector, advanced in place.
+             * @param accel     Acceleration vector.
+             */
+            void add_state (double * position, double * velocity, double * accel);
+
+            /**
+             * Remove a member from the group.
+             * @param state  State (or position) vector of the member.
+             * @return True if the member was found.
+             */
+            bool remove_state (double * state);
+
+            /**
+             * Get the number of members.
+             */
+            unsigned int get_num_states () const {
+                return (unsigned int)states.size();
+            }
+
+            /**
+             * Get the integrator of the group, creating it when the group
+             * is new or its members changed.
+             * @return The integrator, or NULL if the group is empty or the
+             *         technique is not known.
+             */
+            Trick::Integrator * get_integrator ();
+
+            /**
+             * Delete the integrator. The next call to get_integrator creates
+             * a new one.
+             */
+            void reset_integrator ();
+
+            /**
+             * Gather the members into the buffers, perform one integration
+             * pass, and scatter the results back to the members.
+             * @param beg_time  Time at the start of the integration interval.
+             * @param dt        Time span of the integration interval.
+             * @param ex_pass   The expected integration pass, starting at 1.
+             * @return The next intermediate step, zero when done.
+             */
+            int integrate (double beg_time, double dt, int ex_pass);
+
+            /**
+             * Write the states of the members at a point in the step just
+             * completed, see Integrator::set_dense_state.
+             * @param theta  Fraction of the step, from 0 to 1.
+             * @return Zero = success, non-zero = the integrator has no
+             *         dense output for the last step.
+             */
+            int set_dense_state (double theta);
+
+            /**
+             * Determine if the states of the members can be interpolated
+             * over the step just completed.
+             */
+            bool has_dense_state ();
+
+            /**
+             * Write the states of the members at the start of the step just
+             * completed, to take a rejected step again, see
+             * Integrator::restore_start_state.
+             * @return Zero = success, non-zero = the state cannot be
+             *         restored.
+             */
+            int restore_start_state ();
+
+        protected:
+
+            /**
+             * Integration technique of the members.
+             */
+            Integrator_type alg; //!< trick_units(--)
+
+            /**
+             * Size of the state (or position) vector of each member.
+             */
+            unsigned int size; //!< trick_units(--)
+
+            /**
+             * True for members integrated as second order ODEs.
+             */
+            bool second_order; //!< trick_units(--)
+
+            /**
+             * Set when the members changed since the integrator was created.
+             */
+            bool rebuild; //!< trick_units(--)
+
+            /**
+             * State (or position) vector of each member.
+             */
+            std::vector<double *> states; //!< trick_io(**)
+
+            /**
+             * Derivative (or velocity) vector of each member.
+             */
+            std::vector<double *> rates; //!< trick_io(**)
+
+            /**
+             * Acceleration vector of each member of a second order group.
+             */
+            std::vector<double *> accels; //!< trick_io(**)
+
+            /**
+             * Gathered states (or positions), element k of member m at
+             * k * number of members + m.
+             */
+            std::vector<double> state_buf; //!< trick_io(**)
+
+            /**
+             * Gathered derivatives (or velocities).
+             */
+            std::vector<double> rate_buf; //!< trick_io(**)
+
+            /**
+             * Gathered accelerations.
+             */
+            std::vector<double> accel_buf; //!< trick_io(**)
+
+            /**
+             * The integrator that advances the buffers.
+             */
+            Trick::Integrator * integ; //!< trick_io(**)
+
+        private:
+            // Copy the buffers back to the members.
+            void scatter ();
+
+            // Not copyable, the group owns its integrator.
+            IntegBatchGroup (const IntegBatchGroup &);
+            IntegBatchGroup & operator= (const IntegBatchGroup &);
+    };
+}
+
+#endif
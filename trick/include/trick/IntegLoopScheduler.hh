@@ -14,6 +14,7 @@ PROGRAMMERS:
 
 // Local includes
 #include "trick/IntegLoopManager.hh"
+#include "trick/IntegBatchGroup.hh"
 #include "trick/Integrator.hh"
 #include "trick/IntegAlgorithms.hh"
 
@@ -96,6 +97,61 @@ namespace Trick {
              */
             bool first_step_deriv; //!< trick_units(--)
 
+            /**
+             * Locate dynamic events on the dense output of the integrators
+             * over the step just taken instead of integrating to each
+             * estimate of the event time. State is integrated again only
+             * from the located event to the end of the cycle. Loops with an
+             * integrator that has no dense output, or that unloads its state
+             * by index, search by integration as before.
+             */
+            bool dense_events; //!< trick_units(--)
+
+            /**
+             * Divide each integration cycle into substeps whose size is
+             * chosen from the error estimate of the integrators, see
+             * set_adaptive_step. The error tolerances are those of each
+             * integrator, see Integrator::set_tolerance.
+             */
+            bool adaptive_step; //!< trick_units(--)
+
+            /**
+             * Smallest adaptive substep. A substep this small is accepted
+             * whatever its error.
+             */
+            double min_substep; //!< trick_units(s)
+
+            /**
+             * Largest adaptive substep, zero for the integration cycle.
+             */
+            double max_substep; //!< trick_units(s)
+
+            /**
+             * Size of the next adaptive substep, carried from one cycle to
+             * the next. Zero starts with a whole cycle.
+             */
+            double substep; //!< trick_units(s)
+
+            /**
+             * Number of adaptive substeps accepted.
+             */
+            long long num_substeps; //!< trick_units(--)
+
+            /**
+             * Number of adaptive substeps rejected and taken again.
+             */
+            long long num_rejected_substeps; //!< trick_units(--)
+
+            /**
+             * Smallest adaptive substep accepted.
+             */
+            double min_substep_taken; //!< trick_units(s)
+
+            /**
+             * Largest adaptive substep accepted.
+             */
+            double max_substep_taken; //!< trick_units(s)
+
             /**
              * Pointer to the Trick::Integrator object that directs
              * the integration process.
@@ -129,9 +185,9 @@ namespace Trick {
             IntegLoopScheduler ();
 
             /**
-             * Destructor.
+             * Destructor. Deletes the batch integration groups.
              */
-            virtual ~IntegLoopScheduler () {}
+            virtual ~IntegLoopScheduler ();
 
 
             /**
@@ -236,6 +292,41 @@ namespace Trick {
             }
 
 
+            /**
+             * Turns locating dynamic events on the dense output of the
+             * integrators on or off.
+             * @param yes_no  New value for dense_events.
+             */
+            void set_dense_events (bool yes_no) {
+                dense_events = yes_no;
+            }
+
+
+            /**
+             * Turns adaptive substeps on or off. Every integrator of the loop
+             * needs an embedded error estimate, for example
+             * Runge_Kutta_Fehlberg_45. In the input file:
+             * @code
+             * dyn_integloop.integ_sched.set_adaptive_step(True)
+             * @endcode
+             * @param yes_no  New value for adaptive_step.
+             */
+            void set_adaptive_step (bool yes_no) {
+                adaptive_step = yes_no;
+            }
+
+            /**
+             * Set the smallest and the largest adaptive substep.
+             * @param in_min_substep  Smallest substep, in Trick seconds.
+             * @param in_max_substep  Largest substep, in Trick seconds,
+             *                        zero for the integration cycle.
+             */
+            void set_substep_limits (double in_min_substep, double in_max_substep) {
+                min_substep = in_min_substep;
+                max_substep = in_max_substep;
+            }
+
+
             /**
              * Set the verbosity of each integrator associated with this
              * integ_loop scheduler to the specified level.
@@ -256,6 +347,46 @@ namespace Trick {
                 Integrator_type alg, unsigned int state_size);
 
 
+            /**
+             * Integrate a first order state vector as part of a batch.
+             * All states added with the same technique and size are
+             * advanced together by one integrator after the integration
+             * class jobs of each integration pass. The object that owns the
+             * state must not also advance it in an integration class job;
+             * its derivative class jobs compute deriv as usual.
+             * States are added and removed outside of the integration loop,
+             * for example in initialization jobs.
+             * @param alg    Integration technique.
+             * @param size   Number of elements in state and in deriv.
+             * @param state  State vector, advanced in place.
+             * @param deriv  Time derivative of the state vector.
+             * @return Zero = success, non-zero = failure (state not added).
+             */
+            int add_batch_state (
+                Integrator_type alg, unsigned int size,
+                double * state, double * deriv);
+
+            /**
+             * Integrate a second order state as part of a batch.
+             * @param alg       Integration technique.
+             * @param size      Number of elements in each of the vectors.
+             * @param position  Position vector, advanced in place.
+             * @param velocity  Velocity vector, advanced in place.
+             * @param accel     Acceleration vector.
+             * @return Zero = success, non-zero = failure (state not added).
+             */
+            int add_batch_state (
+                Integrator_type alg, unsigned int size,
+                double * position, double * velocity, double * accel);
+
+            /**
+             * Stop integrating a state added with add_batch_state.
+             * @param state  State (or position) vector given to add_batch_state.
+             * @return Zero = success, non-zero = failure (state not found).
+             */
+            int remove_batch_state (double * state);
+
+
             /**
              * Get the interval between calls to the integ_loop job.
              * @return Integration cycle time, in Trick seconds.
@@ -342,6 +473,12 @@ namespace Trick {
              */
             SimObject * parent_sim_object; //!< trick_units(--)
 
+            /**
+             * Size of the last step taken by integrate, the step the states
+             * can be interpolated over.
+             */
+            double last_substep; //!< trick_units(s)
+
 
             /**
              * Pre-integration jobs managed by this loop.
@@ -368,6 +505,11 @@ namespace Trick {
              */
             Trick::ScheduledJobQueue post_integ_jobs; //!< trick_units(--)
 
+            /**
+             * Batch integration groups, one per technique and state size.
+             */
+            std::vector<Trick::IntegBatchGroup*> batch_groups; //!< trick_io(**)
+
 
             // Member functions
 
@@ -391,6 +533,13 @@ namespace Trick {
             SimObjectVector::iterator find_sim_object (
                 Trick::SimObject & sim_obj);
 
+            /**
+             * Find or create the batch group for the specified technique
+             * and state size.
+             */
+            Trick::IntegBatchGroup * get_batch_group (
+                Integrator_type alg, unsigned int size, bool second_order);
+
 
             /**
              * Integrate sim objects over the specified time span.
@@ -404,6 +553,34 @@ namespace Trick {
              */
             virtual int integrate_dt (double beg_time, double del_time);
 
+            /**
+             * Integrate sim objects over the specified time span in adaptive
+             * substeps. A substep whose error is above the tolerance is taken
+             * again from its start with a smaller size.
+             *
+             * @return          Zero/non-zero success indicator.
+             * @param beg_time  Time at the start of the integration interval.
+             * @param del_time  Time span of the integration interval.
+             */
+            int integrate_adaptive (double beg_time, double del_time);
+
+            /**
+             * Get the largest error ratio of the integrators of the loop over
+             * the step just completed, see Integrator::get_error_ratio.
+             * @return          The error ratio, negative if an integrator
+             *                  has no error estimate.
+             * @param order     Set to the lowest error order of the
+             *                  integrators.
+             */
+            double get_error_ratio (int & order);
+
+            /**
+             * Write the states at the start of the step just completed back
+             * to the integrated objects.
+             * @return          Zero/non-zero success indicator.
+             */
+            int restore_start_state ();
+
             /**
              * Process dynamic events.
              *
@@ -412,6 +589,22 @@ namespace Trick {
              * @param end_time  Time at the end of the integration interval.
              */
             int process_dynamic_events (double end_time);
+
+            /**
+             * Determine if every integrator of the loop can interpolate its
+             * state over the step just completed.
+             */
+            bool has_dense_state ();
+
+            /**
+             * Write the interpolated states of every integrator of the loop
+             * at the specified time to the integrated objects.
+             * @return          Zero/non-zero success indicator.
+             * @param time      Time to interpolate to.
+             * @param beg_time  Time at the start of the step just completed.
+             * @param del_time  Time span of the step just completed.
+             */
+            int set_dense_state (double time, double beg_time, double del_time);
     };
 }
 
@@ -53,7 +53,7 @@ namespace Trick {
     public:
 
         Integrator();
-        virtual ~Integrator() {};
+        virtual ~Integrator();
 
         virtual void initialize(int State_size, double Dt) = 0;
         virtual int integrate() = 0;
@@ -133,6 +133,61 @@ namespace Trick {
 
         int verbosity;
 
+        /* Dense output.  The model states unloaded through state_out, integrate_1st_order_ode or
+           integrate_2nd_order_ode at the end of a step are remembered so the state anywhere in the
+           step can be written back to them, see set_dense_state. */
+        double **dense_addr;     // ** model states unloaded at the end of the last step
+        int num_dense_addr;      // ** number of addresses in dense_addr
+        double dense_time;       // ** integrator time when dense_addr was recorded
+        double *dense_ws;        // ** interpolated state workspace
+
+        /* Compute the state at time_0 + theta * dt, 0 <= theta <= 1, of the step just completed.
+           Returns 0 on success, 1 if the technique has no dense output. */
+        virtual int interpolate_state (double theta, double* state_out);
+
+        /* True if the technique implements interpolate_state. */
+        virtual bool has_dense_output() { return false; }
+
+        /* True if the technique has dense output and the last step was completed and unloaded through
+           state_out, integrate_1st_order_ode or integrate_2nd_order_ode. */
+        bool has_dense_state();
+
+        /* Write the state at time_0 + theta * dt of the step just completed to the model states.
+           Call it only while has_dense_state is true, the time may be changed in between.
+           Returns 0 on success, 1 if the state cannot be interpolated. */
+        int set_dense_state (double theta);
+
+        /* Step size control.  A technique with an embedded error estimate measures the error of the
+           step just completed against a tolerance of rel_tol * |state| + abs_tol per state element,
+           see get_error_ratio. */
+        double rel_tol;          // -- relative error tolerance of every state element
+        double abs_tol;          // -- absolute error tolerance of every state element
+        double *state_rel_tol;   // ** relative error tolerance per state element, see set_state_tolerance
+        double *state_abs_tol;   // ** absolute error tolerance per state element, see set_state_tolerance
+        double *error_ws;        // ** error estimate and end state workspace
+
+        /* Order of the lower order solution of the embedded error estimate, 0 if the technique has none. */
+        virtual int get_error_order() { return 0; }
+
+        /* Estimate the error of each state element over the step just completed and copy the state at
+           the end of the step.  Returns 0 on success, 1 if the technique has no error estimate. */
+        virtual int estimate_error (double* error_out, double* state_out);
+
+        /* Write the state at the start of the step just completed back to the model states, to take a
+           rejected step again.  Returns 0 on success, 1 if the state cannot be restored. */
+        virtual int restore_start_state();
+
+        /* The largest ratio of the error estimate to the tolerance over all state elements, a step is
+           accepted when it is at most 1.  Returns a negative number if there is no error estimate. */
+        double get_error_ratio();
+
+        /* Set the error tolerances of every state element. */
+        void set_tolerance (double in_rel_tol, double in_abs_tol);
+
+        /* Set the error tolerances of one state element.  Returns 0 on success, 1 if the index is out of
+           range. */
+        int set_state_tolerance (int index, double in_rel_tol, double in_abs_tol);
+
         virtual bool get_first_step_deriv() ;
         virtual void set_first_step_deriv(bool first_step) ;
         virtual bool get_last_step_deriv() ;
@@ -141,6 +196,10 @@ namespace Trick {
         virtual void reset() {}
         virtual Integrator_type get_Integrator_type() { return (User_Defined); };
 
+    protected:
+        void record_dense_addr (int index, double* addr);
+        static double hermite (double theta, double h, double y0, double f0, double y1, double f1);
+
     };
 
     Integrator* getIntegrator( Integrator_type Alg, unsigned int State_size, double Dt = 0.0 );
@@ -148,7 +207,7 @@ namespace Trick {
 //    Integrator* getEr7Integrator(
 //       er7_utils::Integration::Technique, unsigned int State_size, double Dt);
 
-//    void deleteIntegrator( Integrator*&);
+    void deleteIntegrator( Integrator*& );
 }
 
 #endif
@@ -2,26 +2,52 @@
 #define INTERPOLATOR_HH
 
 #include <stdexcept>
+#include <vector>
 
 namespace Trick {
 
+    /**
+     Multilinear interpolation of an N dimensional table.  The bracket found in each dimension is
+     remembered and tried first on the next evaluation, so tables evaluated with slowly changing
+     parameters are not searched from the start.  A binary search is used when the cached bracket
+     and its neighbors miss.
+
+     An Interpolator is not thread-safe.  eval and evalBatch update the cached brackets and the
+     scratch arrays of the object, so each thread needs its own Interpolator.  Interpolators may
+     share the same table and breakpoint arrays.
+    */
     class Interpolator {
 
     public:
 
-    Interpolator (double* Table, double** BreakPointArrays, unsigned int* BreakPointArraySizes, unsigned int NParams)
-    : table(Table),
-      breakPointArrays(BreakPointArrays),
-      breakPointArraySizes(BreakPointArraySizes),
-      nParams(NParams) {};
+    Interpolator (double* Table, double** BreakPointArrays, unsigned int* BreakPointArraySizes, unsigned int NParams) ;
 
+    /**
+     Evaluate the table at nParams parameters passed as arguments.  Kept for existing callers;
+     the arguments are copied to an array and passed to eval(double[]).  At most 256 parameters.
+    */
     double eval (double param1, ...) ;
     double eval (double params[]) ;
 
+    /**
+     Evaluate the table at nPoints points.  params holds nParams parameters for each point, point
+     after point.  The points are processed in blocks so that the interpolation arithmetic of a
+     block is done in loops the compiler can vectorize.
+    */
+    void evalBatch (unsigned int nPoints, double params[], double results[]) ;
+
+    /**
+     Precompute the slopes of the table along its last dimension.  Evaluations then use one
+     table entry and its slope instead of two table entries in that dimension.  Must be called
+     again if the table is changed.
+    */
+    void precomputeSlopes () ;
+    void clearSlopes () ;
+
     private:
 
     Interpolator(){};
-    double eval (double param[], unsigned int param_index, unsigned int offset) ;
+    unsigned int findBracket (unsigned int param_index, double x) ;
 
     // DATA MEMBERS
     double*  table;                  /**< Interpolation data. */
@@ -29,6 +55,15 @@ namespace Trick {
     unsigned int*     breakPointArraySizes;   /**< Array that specifies the size of each breakpoint array.*/
     unsigned int      nParams;                /**< Number of independent variables. Same as number of breakpoint arrays. */
 
+    std::vector<unsigned int> lastBracket;    /**< trick_io(**) Bracket found in each dimension by the last evaluation. */
+    std::vector<unsigned int> strides;        /**< trick_io(**) Table offset between neighboring breakpoints of each dimension. */
+    std::vector<unsigned int> cornerOffsets;  /**< trick_io(**) Table offset of each corner of a bracket from its first corner. */
+    std::vector<double> slopes;               /**< trick_io(**) Table slopes along the last dimension, if precomputed. */
+
+    std::vector<double> weights;              /**< trick_io(**) Scratch interpolation weights. */
+    std::vector<double> corners;              /**< trick_io(**) Scratch corner values. */
+    std::vector<unsigned int> batchOffsets;   /**< trick_io(**) Scratch first corner offsets of a batch block. */
+
     };
 
 } // endof namespace Trick
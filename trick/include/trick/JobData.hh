@@ -44,6 +44,9 @@ namespace Trick {
             /** Indicates if the job is complete */
             bool complete;                  /**< trick_units(--) */
 
+            /** Job is independent of the other parallel jobs of its class and phase in the same thread */
+            bool parallel;                  /**< trick_units(--) */
+
             /** Indicates if a scheduler is handling this job */
             bool handled;                   /**< trick_units(--) */
 
@@ -128,6 +131,9 @@ namespace Trick {
             /** Internal next rate in tics */
             long long next_tics;            /**< trick_units(--) */
 
+            /** Index of the job in the ScheduledJobQueue dispatching it, set when its dispatch schedule is built */
+            unsigned int queue_index ;      /**< trick_io(**) */
+
             /** time tic value from the executive */
             static long long time_tic_value ;      /**< trick_io(**) */
 
@@ -121,6 +121,23 @@ namespace Trick {
              */
             virtual int write_command(MS_SIM_COMMAND command) = 0 ;
 
+            /**
+             @brief Reads the next block of frame data written by the other simulation with write_payload.
+             Payloads are read in the order they were written.
+             @return the size of the payload read, or -1 if the read failed or the connection has no payloads
+             */
+            virtual int read_payload(void * data __attribute__((unused)), size_t size __attribute__((unused))) {
+                return -1 ;
+            }
+
+            /**
+             @brief Writes a block of frame data to the other simulation.
+             @return the number of bytes written, or -1 if the write failed or the connection has no payloads
+             */
+            virtual int write_payload(const void * data __attribute__((unused)), size_t size __attribute__((unused))) {
+                return -1 ;
+            }
+
             /** Limit of how long to wait for a message.\n */
             double sync_wait_limit ;  /**< trick_units(s) */
     } ;
@@ -30,17 +30,10 @@ PROGRAMMERS:
 #endif
 
 //-----------------------------------------------------------------------------
-// MACROS USED TO IMPLEMENT QUEUES FOR READ/WRITE DATA IN MSSharedMemData
-#define MSQ_MAXSIZE 5
-#define MSQ_DECLARE(q,type) type q[MSQ_MAXSIZE] ; /**< trick_io(**) trick_units(--) */\
-                         int q##_front ;    /**< trick_io(**) trick_units(--) */\
-                         int q##_back ;     /**< trick_io(**) trick_units(--) */
-#define MSQ_INIT(q)      q##_front = q##_back = 0
-#define MSQ_ISEMPTY(q)   (q##_front==q##_back)
-#define MSQ_FRONT(q)     q[q##_front]
-#define MSQ_POP(q)       ++q##_front %= (MSQ_MAXSIZE)
-#define MSQ_SIZE(q)      q##_back-q##_front
-#define MSQ_PUSH(q,data) q[q##_back] = data ; ++q##_back %= (MSQ_MAXSIZE)
+// SIZES OF THE RINGS IN MSSharedMemData, EACH A POWER OF 2
+#define MS_RING_RECORD_SIZE 8           // every time and command is sent as a long long
+#define MS_RING_RECORDS_SIZE (16 * MS_RING_RECORD_SIZE)
+#define MS_RING_PAYLOAD_SIZE 65536
 //-----------------------------------------------------------------------------
 
 namespace Trick {
@@ -59,13 +52,33 @@ namespace Trick {
      *
      */
 
+    /**
+     * A single producer, single consumer ring of bytes in shared memory.  head and tail only grow, wrapping around
+     * at 2^32, so head - tail is the number of bytes in the ring.  A reader with nothing to read sleeps on head
+     * with a futex, and a writer with no room sleeps on tail.
+     */
+    typedef struct {
+        unsigned int head ;             /**< trick_io(**) trick_units(--) bytes written, changed by the writer only */
+        unsigned int tail ;             /**< trick_io(**) trick_units(--) bytes read, changed by the reader only */
+        unsigned int head_waiters ;     /**< trick_io(**) trick_units(--) readers sleeping on head */
+        unsigned int tail_waiters ;     /**< trick_io(**) trick_units(--) writers sleeping on tail */
+        unsigned int size ;             /**< trick_io(**) trick_units(--) size of the data, a power of 2 */
+    } MSRing ;
+
     /** The data to read/write between the master and slave in shared memory.\n */
     typedef struct {
         pid_t master_pid ;                      /**< trick_units(--) */
-        MSQ_DECLARE (master_time, long long)
-        MSQ_DECLARE (master_command, MS_SIM_COMMAND)
-        MSQ_DECLARE (slave_command, MS_SIM_COMMAND)
-        // checkpoint data is not sent every frame, so dont need a queue
+        MSRing master_time ;                    /**< trick_io(**) trick_units(--) */
+        MSRing master_command ;                 /**< trick_io(**) trick_units(--) */
+        MSRing slave_command ;                  /**< trick_io(**) trick_units(--) */
+        MSRing master_payload ;                 /**< trick_io(**) trick_units(--) */
+        MSRing slave_payload ;                  /**< trick_io(**) trick_units(--) */
+        char master_time_data[MS_RING_RECORDS_SIZE] ;       /**< trick_io(**) trick_units(--) */
+        char master_command_data[MS_RING_RECORDS_SIZE] ;    /**< trick_io(**) trick_units(--) */
+        char slave_command_data[MS_RING_RECORDS_SIZE] ;     /**< trick_io(**) trick_units(--) */
+        char master_payload_data[MS_RING_PAYLOAD_SIZE] ;    /**< trick_io(**) trick_units(--) */
+        char slave_payload_data[MS_RING_PAYLOAD_SIZE] ;     /**< trick_io(**) trick_units(--) */
+        // checkpoint data is not sent every frame, so dont need a ring
         int slave_port;                         /**< trick_units(--) slave's dmtcp checkpoint port */
         char chkpnt_name[256];                  /**< trick_units(--) checkpoint dir/filename */
     } MSSharedMemData;
@@ -175,6 +188,27 @@ namespace Trick {
              */
             virtual int write_name(char * in_data, size_t size) ;
 
+            /**
+             @brief Reads the next block of frame data written by the other simulation.  Blocks until a payload
+             arrives or the sync wait limit expires.
+             @return the size of the payload, or -1 if none was read.  A payload larger than size is truncated.
+             */
+            virtual int read_payload(void * data, size_t size) ;
+
+            /**
+             @brief Writes a block of frame data to the other simulation.  Blocks while the ring is full, up to
+             the sync wait limit.
+             @return the number of bytes written, or -1 if the payload did not fit
+             */
+            virtual int write_payload(const void * data, size_t size) ;
+
+            /**
+             @brief @userdesc Clears the round trip statistics.
+             @par Python Usage:
+             @code <sharedmem_object>.reset_round_trip_stats() @endcode
+             */
+            void reset_round_trip_stats() ;
+
             /** Wait a short time before next read attempt, return total time waited.\n */
             double read_wait(struct timespec *start) ;
 
@@ -183,6 +217,27 @@ namespace Trick {
 
             /** Address of data to read/write between the master and slave in shared memory.\n */
             MSSharedMemData * shm_addr ;    /**< trick_units(--) */
+
+            /** Number of round trips measured.  A round trip is from the first write after a read to the next
+                read that returns data, e.g. from the slave sending its command to the master time arriving.\n */
+            long long round_trip_count ;    /**< trick_io(*o) trick_units(--) */
+            double round_trip_min ;         /**< trick_io(*o) trick_units(s) */
+            double round_trip_max ;         /**< trick_io(*o) trick_units(s) */
+            double round_trip_avg ;         /**< trick_io(*o) trick_units(s) */
+
+        private:
+            /** Starts a round trip if none is pending, called after every write.\n */
+            void start_round_trip() ;
+
+            /** Ends the pending round trip, called after every read that returned data.\n */
+            void end_round_trip() ;
+
+            /** Waits for need bytes to read from ring, or for room to write need bytes.\n */
+            bool ring_wait(MSRing * ring , unsigned int need , bool reader) ;
+
+            /** Monotonic time when the pending round trip started, 0 if none.\n */
+            double round_trip_start ;       /**< trick_io(**) trick_units(s) */
+            double round_trip_total ;       /**< trick_io(**) trick_units(s) */
     } ;
 }
 
@@ -133,6 +133,18 @@ namespace Trick {
              */
             virtual int write_name(char * in_data, size_t size) ;
 
+            /**
+             @brief Reads a block of frame data written with write_payload.  Calls tc_read for the size, then the data.
+             @return the size of the payload, or -1 if the read failed.  A payload larger than size is truncated.
+             */
+            virtual int read_payload(void * data, size_t size) ;
+
+            /**
+             @brief Writes a block of frame data to the other simulation.  Calls tc_write for the size, then the data.
+             @return the number of bytes written, or -1 if the write failed
+             */
+            virtual int write_payload(const void * data, size_t size) ;
+
             /** The Trickcomm socket connection between the master and slave.\n */
             TCDevice tc_dev ;        /**< trick_units(--) */
 
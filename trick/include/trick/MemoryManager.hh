@@ -366,6 +366,19 @@ namespace Trick {
              */
             void write_checkpoint( const char* filename, std::vector<const char*>& var_name_list);
 
+#ifndef SWIG
+            /**
+             Hold the lock on the MemoryManager maps.  Held across a fork() so that the child's copy of the
+             maps is consistent, and released by both the parent and the child after the fork.
+             */
+            void lock() { pthread_mutex_lock(&mm_mutex) ; }
+
+            /**
+             Release the lock taken by lock().
+             */
+            void unlock() { pthread_mutex_unlock(&mm_mutex) ; }
+#endif
+
             /**
              Restore a checkpoint from the given stream.
              @param in_s - input stream.
@@ -537,7 +550,8 @@ namespace Trick {
             int io_get_fixed_truncated_size(char *ptr, ATTRIBUTES * A, char *str, int dims, ATTRIBUTES * left_type);
 
             /**
-             Get information for the allocation containing the specified address.
+             Get information for the allocation containing the specified address.  Lookups search a sorted
+             copy of the allocation map that is rebuilt after enough lookups miss it following a change.
              @param addr The Address.
              */
             ALLOC_INFO* get_alloc_info_of( void* addr);
@@ -548,6 +562,13 @@ namespace Trick {
              */
             ALLOC_INFO* get_alloc_info_at( void* addr);
 
+            /**
+             Get the allocation generation.  The generation changes each time an allocation is added to,
+             moved in, or removed from the allocation map.  Callers may cache the results of
+             get_alloc_info_of until it changes.
+             */
+            unsigned long long get_alloc_generation() { return alloc_generation ; } ;
+
             /**
              Names an allocation in the ALLOC_INFO map to the incoming name.
              @param addr The Address.
@@ -677,6 +698,31 @@ namespace Trick {
 
             int alloc_info_map_counter ;     /**< ** counter to assign unique ids to allocations as they are added to map */
             int extern_alloc_info_map_counter ; /**< ** counter to assign unique ids to allocations as they are added to map */
+            unsigned long long alloc_generation ; /**< ** incremented each time alloc_info_map changes */
+
+            /** A sorted, flat copy of alloc_info_map searched by get_alloc_info_of.\n */
+            struct AllocIndex {
+                /** The end address and record of one allocation.\n */
+                struct Entry {
+                    char* end ;        /**< end address of the allocation */
+                    ALLOC_INFO* info ; /**< the allocation */
+                } ;
+                unsigned long long generation ;  /**< alloc_generation the index was built from */
+                std::vector<char*> top ;         /**< every alloc_index_stride-th start address, small enough to stay cached */
+                std::vector<char*> starts ;      /**< start addresses of the allocations, ascending */
+                std::vector<Entry> entries ;     /**< the allocations, in the order of starts */
+            } ;
+            static const unsigned int alloc_index_stride = 64 ;       /**< ** allocations per top level entry */
+            static const unsigned int alloc_index_reader_slots = 16 ; /**< ** reader counters, spread over by thread */
+            AllocIndex* alloc_index ;            /**< ** current index, replaced and never changed in place */
+            std::vector<AllocIndex*> retired_alloc_indexes ; /**< ** replaced indexes that may still be searched */
+            unsigned int alloc_index_readers[alloc_index_reader_slots * 16] ; /**< ** get_alloc_info_of calls searching an index, one counter every 64 bytes */
+            unsigned int alloc_index_misses ;    /**< ** lookups that searched alloc_info_map since the index was built */
+
+            /**
+             Rebuild alloc_index from alloc_info_map if it changed.  Does nothing if mm_mutex is held.
+             */
+            void update_alloc_index() ;
 
             std::vector<ALLOC_INFO*> dependencies; /**< ** list of allocations used in a checkpoint. */
             std::vector<ALLOC_INFO*> stl_dependencies; /**< ** list of allocations known to be STL checkpoint allocations */
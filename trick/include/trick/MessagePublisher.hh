@@ -5,6 +5,7 @@
 */
 #include <string>
 #include <list>
+#include <pthread.h>
 #include "trick/MessageSubscriber.hh"
 
 namespace Trick {
@@ -27,6 +28,9 @@ namespace Trick {
             /** Print format that accomodates enough significant digits to handle tics_per_sec */
             char print_format[64] ;
 
+            /** Held while a message is sent to the subscribers.\n */
+            pthread_mutex_t publish_mutex ; /**< trick_io(**) */
+
             /**
              @brief sets the print format
              */
@@ -68,6 +72,19 @@ namespace Trick {
              */
             int publish(int level, std::string message) ;
 
+#ifndef SWIG
+            /**
+             @brief Hold off publishing.  Held across a fork() so that the child does not inherit a message
+             half sent to the subscribers, and released by both the parent and the child after the fork.
+             */
+            void lock() { pthread_mutex_lock(&publish_mutex) ; }
+
+            /**
+             @brief Release the lock taken by lock().
+             */
+            void unlock() { pthread_mutex_unlock(&publish_mutex) ; }
+#endif
+
             /**
              @brief gets the subscriber from the list
              @param sub_name - name of the subscriber to get.
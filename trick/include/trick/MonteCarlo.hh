@@ -8,6 +8,7 @@
 #include <deque>
 #include <vector>
 #include <climits>
+#include <string.h>
 
 #include "trick/MonteVar.hh"
 #include "trick/Executive.hh"
@@ -60,6 +61,9 @@ namespace Trick {
         /** Variable values specific to this Monte Carlo iteration. */
         std::vector <std::string> variables; /**< \n trick_units(--) */
 
+        /** Raw values of MonteCarlo::variables for this iteration, sent to slaves in batches. */
+        std::vector <std::string> values;    /**< \n trick_units(--) */
+
         /** Manner in which this run exited. */
         ExitStatus exit_status;    /**< \n trick_units(--) */
 
@@ -109,7 +113,8 @@ namespace Trick {
         enum Command {
             PROCESS_RUN, /**< process a new run */
             SHUTDOWN,    /**< kill any executing run, call shutdown jobs, and shutdown cleanly */
-            DIE          /**< kill any executing run, do not call shutdown jobs, and exit */
+            DIE,         /**< kill any executing run, do not call shutdown jobs, and exit */
+            PROCESS_BATCH /**< process several runs sent over a connection that stays open */
         };
 
         /** Unique identifier assigned by the master. */
@@ -127,6 +132,12 @@ namespace Trick {
         /** Run most recently dispatched to this slave. */
         MonteRun *current_run;           /**< \n trick_units(--) */
 
+        /** Runs of the current batch that follow #current_run. */
+        std::deque <MonteRun *> batch_runs;   /**< \n trick_io(**) trick_units(--) */
+
+        /** Connection kept open to send batches to this slave. */
+        TCDevice batch_device;           /**< \n trick_io(**) */
+
         /** Number of runs dispatched to this slave. */
         unsigned int num_dispatches;     /**< \n trick_units(--) */
 
@@ -174,6 +185,8 @@ namespace Trick {
             cpu_time(0),
             remote_shell(Trick::TRICK_SSH),
             multiplier(1) {
+            memset(&batch_device, 0, sizeof(TCDevice)) ;
+            batch_device.socket = TRICKCOMM_INVALID_SOCKET ;
             if (name.empty()) {
                 machine_name = "localhost";
             }
@@ -324,12 +337,22 @@ namespace Trick {
         /** Highest level of messages to report. */
         Verbosity verbosity;                            /**< \n trick_units(--) */
 
+        /**
+         * Number of runs sent to a slave in one dispatch. A value greater than zero sends batches of runs over a
+         * connection that stays open, and the slave assigns numeric variable values through the memory manager instead
+         * of the input processor. Defaults to zero, which sends each run as input file text over a new connection.
+         */
+        unsigned int batch_size;                        /**< \n trick_units(--) */
+
         /** Device over which connections are accepted. */
         TCDevice listen_device;                         /**< \n trick_units(--) */
 
         /** Device over which data is sent and received. */
         TCDevice connection_device;                     /**< \n trick_units(--) */
 
+        /** Device over which a slave receives batches from the master. */
+        TCDevice batch_device;                          /**< \n trick_io(**) */
+
         /** Runs to be dispatched. */
         std::deque <Trick::MonteRun *> runs;                 /**< \n trick_io(**) trick_units(--) */
 
@@ -555,6 +578,16 @@ namespace Trick {
          */
         Verbosity get_verbosity();
 
+        /**
+         * Sets #batch_size. It must be set in the input file so that the master and slaves agree.
+         */
+        void set_batch_size(unsigned int batch_size);
+
+        /**
+         * Gets #batch_size.
+         */
+        unsigned int get_batch_size();
+
         /**
          * Sets #num_runs.
          *
@@ -840,6 +873,33 @@ namespace Trick {
          */
         void dispatch_run_to_slave(MonteRun *run, MonteSlave *slave);
 
+        /**
+         * Dispatches up to #batch_size runs to the specified slave over its MonteSlave::batch_device.
+         *
+         * @param slave the target slave
+         */
+        void dispatch_batch_to_slave(MonteSlave *slave);
+
+        /**
+         * Encodes the specified runs for a MonteSlave::PROCESS_BATCH command.
+         *
+         * @param batch the runs to encode
+         * @param buffer the string to which the encoded runs are appended
+         */
+        void pack_batch(std::vector<MonteRun *> &batch, std::string &buffer);
+
+        /**
+         * Makes the next run of the slave's batch its current run after the current run was reported.
+         *
+         * @param slave the slave processing the batch
+         *
+         * @return true if the slave has another run in its batch
+         */
+        bool next_batch_run(MonteSlave &slave);
+
+        /** Requeues the unreported runs of the slave's batch. */
+        void requeue_batch_runs(MonteSlave &slave);
+
         /** Updates the #num_slaves and #slaves_head to reflect the #slaves. */
         void sync_slaves_head();
 
@@ -866,6 +926,49 @@ namespace Trick {
         /** Processes an incoming run. */
         int slave_process_run();
 
+        /** Processes an incoming batch of runs. */
+        int slave_process_batch();
+
+        /**
+         * Decodes a MonteSlave::PROCESS_BATCH message.
+         *
+         * @param buffer the encoded runs
+         * @param size the number of bytes in buffer
+         * @param names the variable names
+         * @param units the variable units
+         * @param batch the decoded runs, allocated with new
+         *
+         * @return 0 on success, -1 if the message is malformed
+         */
+        int unpack_batch(const char *buffer, int size, std::vector<std::string> &names,
+                         std::vector<std::string> &units, std::vector<MonteRun *> &batch);
+
+        /**
+         * Assigns a value to a variable through the memory manager.
+         *
+         * @param name the variable name
+         * @param unit the units of the value, may be empty
+         * @param value the value
+         *
+         * @return true if the value was assigned, false if it must be assigned by the input processor
+         */
+        bool assign_variable(const std::string &name, const std::string &unit, const std::string &value);
+
+        /**
+         * Creates the run directory, writes the monte_input file, and starts the run in the child process.
+         *
+         * @param input the input file text of the run
+         */
+        void slave_start_run(const std::string &input);
+
+        /**
+         * Waits for the child process executing a run and reports a crash or timeout to the master.
+         *
+         * @param pid the child process
+         * @param run_id the run the child is executing
+         */
+        void slave_wait_for_run(pid_t pid, unsigned int run_id);
+
         /** Shuts down the slave. */
         void slave_shutdown();
 
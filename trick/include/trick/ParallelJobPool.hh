@@ -0,0 +1,163 @@
+/*
+    PURPOSE:
+        (Trick work-stealing pool for running independent jobs of one thread in parallel)
+*/
+
+#ifndef PARALLELJOBPOOL_HH
+#define PARALLELJOBPOOL_HH
+
+#include <deque>
+#include <vector>
+#include <iostream>
+#include <pthread.h>
+
+#include "trick/ThreadBase.hh"
+#include "trick/ThreadWait.hh"
+
+namespace Trick {
+
+    class JobData ;
+    class Threads ;
+    class ParallelJobPool ;
+
+    /**
+     * A helper thread of a Trick::ParallelJobPool.  Each worker owns a deque of jobs.  It runs jobs
+     * from the back of its own deque and steals from the front of the other deques when its own is
+     * empty.
+     */
+    class ParallelJobWorker : public Trick::ThreadBase {
+        public:
+            ParallelJobWorker( ParallelJobPool * in_pool , unsigned int in_index , std::string in_name ) ;
+            virtual ~ParallelJobWorker() ;
+
+            /** Waits for each batch and helps run it. */
+            virtual void * thread_body() ;
+
+            /** Pool this worker belongs to */
+            ParallelJobPool * pool ;         /**< trick_io(**) */
+
+            /** Index of this worker's deque in the pool.  Index 0 belongs to the dispatching thread. */
+            unsigned int index ;             /**< trick_units(--) */
+    } ;
+
+    /**
+     * Runs jobs of one Trick::Threads job queue that are marked parallel across a pool of workers.
+     *
+     * The owning thread offers each job it pulls from its queue to defer_job().  Consecutive parallel
+     * jobs of the same job class and phase are collected into a batch.  The batch is run and waited on
+     * before a job of another class or phase, a job that is not parallel, or a job that depends on a job
+     * already in the batch.  The class and phase ordering of the queue is kept.  Dependencies on jobs
+     * outside the batch are satisfied before the batch starts.  Only independence between jobs of the
+     * same batch is assumed.
+     *
+     * System jobs set their own next call time after running and are never batched.
+     *
+     * The owning thread waits for the rest of a batch with its own wait policy, see Trick::ThreadWait.
+     * Derivative jobs of an integration loop are offered to the pool of the thread running the loop.
+     */
+    class ParallelJobPool {
+
+        friend class ParallelJobWorker ;
+
+        public:
+            ParallelJobPool() ;
+            ~ParallelJobPool() ;
+
+            /**
+             * Sets the thread that owns the pool and runs the batch dispatch.
+             */
+            void set_owner( Trick::Threads * in_owner ) ;
+
+            /**
+             * Sets the number of helper threads.  The owning thread always takes part in a batch as well.
+             * 0 disables the pool so all jobs run serially on the owning thread.
+             * @param num - number of helper threads
+             * @return always 0
+             */
+            int set_num_workers( unsigned int num ) ;
+
+            /** Returns the number of helper threads */
+            unsigned int get_num_workers() ;
+
+            /**
+             * Offers a job to the current batch.  If the job cannot join the current batch the batch is
+             * run first.
+             * @param job - job to offer
+             * @param sched_job - false for jobs called by an integration loop.  Their return value is
+             *  ignored and they are not marked complete, as when the loop calls them itself.
+             * @return true if the job was deferred, false if the caller should run it now
+             */
+            bool defer_job( Trick::JobData * job , bool sched_job = true ) ;
+
+            /**
+             * Runs the current batch, if any, and waits for all of its jobs to complete.
+             */
+            void flush() ;
+
+            /** Stops and joins the helper threads. */
+            void shutdown() ;
+
+            /** Prints the pool settings and counters */
+            void dump( std::ostream & oss ) ;
+
+            /** Number of batches run */
+            long long num_batches ;          /**< trick_units(--) */
+
+            /** Number of jobs run through the pool */
+            long long num_pool_jobs ;        /**< trick_units(--) */
+
+            /** Number of jobs stolen from another deque */
+            long long num_steals ;           /**< trick_units(--) */
+
+        protected:
+            /** Pops a job from the back of deque index, or steals one from the front of another deque. */
+            Trick::JobData * next_job( unsigned int index ) ;
+
+            /** Runs jobs until no deque has any left */
+            void work( unsigned int index ) ;
+
+            /** Calls one job and marks it complete */
+            void call_job( Trick::JobData * job ) ;
+
+            /** Thread that owns the queue and dispatches batches */
+            Trick::Threads * owner ;         /**< trick_io(**) */
+
+            /** Helper threads */
+            std::vector< ParallelJobWorker * > workers ;   /**< trick_io(**) */
+
+            /** Jobs collected for the next batch */
+            std::vector< Trick::JobData * > batch ;        /**< trick_io(**) */
+
+            /** One deque per participant, index 0 is the owning thread */
+            std::vector< std::deque< Trick::JobData * > > deques ;   /**< trick_io(**) */
+
+            /** One mutex per deque */
+            std::vector< pthread_mutex_t * > deque_mutexes ;        /**< trick_io(**) */
+
+            /** The batch holds scheduled jobs, see defer_job */
+            bool batch_sched_jobs ;          /**< trick_io(**) */
+
+            /** Jobs in the running batch that have not completed */
+            volatile int remaining ;         /**< trick_io(**) */
+
+            /** Set by the participant that completes the last job of the running batch */
+            volatile bool batch_done ;       /**< trick_io(**) */
+
+            /** Signaled when batch_done is set, the owning thread blocks on it under a blocking wait policy */
+            ThreadSignal done_signal ;       /**< trick_io(**) */
+
+            /** Incremented for each batch so sleeping helpers know there is work */
+            volatile unsigned int generation ;   /**< trick_io(**) */
+
+            /** Set to stop the helper threads */
+            volatile bool stopping ;         /**< trick_io(**) */
+
+            /** Mutex and condition variable the helpers sleep on between batches */
+            pthread_mutex_t batch_mutex ;    /**< trick_io(**) */
+            pthread_cond_t batch_cv ;        /**< trick_io(**) */
+    } ;
+
+}
+
+#endif
+
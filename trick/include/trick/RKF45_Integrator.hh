@@ -96,6 +96,14 @@ namespace Trick {
 
         int integrate();
 
+        bool has_dense_output() { return true; }
+
+        int interpolate_state( double theta, double* state_out);
+
+        int get_error_order() { return 4; }
+
+        int estimate_error( double* error_out, double* state_out);
+
         void set_first_step_deriv(bool first_step);
 
         Integrator_type get_Integrator_type() { return(Runge_Kutta_Fehlberg_45); } ;
@@ -96,6 +96,10 @@ namespace Trick {
 
         int integrate();
 
+        bool has_dense_output() { return true; }
+
+        int interpolate_state( double theta, double* state_out);
+
         Integrator_type get_Integrator_type() { return(Runge_Kutta_Fehlberg_78); } ;
 
     };
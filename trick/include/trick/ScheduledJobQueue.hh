@@ -7,6 +7,7 @@
 #define SCHEDULEDJOBQUEUE_HH
 
 #include <string>
+#include <vector>
 
 #include "trick/JobData.hh"
 
@@ -17,6 +18,12 @@ namespace Trick {
      * allocate memory during normal cycling through jobs and is considerably
      * faster than the generalized priority_queue.
      *
+     * Optionally the queue maintains a dispatch schedule, a timing wheel of job indexes bucketed
+     * by next call time.  When enabled, find_next_job(long long) only visits the jobs that are due
+     * at the requested time instead of scanning the entire list.  Jobs are still returned in
+     * job_class, phase, sim_object, and job id order.  The wheel is a fixed ring of slots linking
+     * job indexes, allocated when the wheel is built, so dispatching does not allocate either.
+     *
      * @author Robert W. Bailey
      * @author many other Trick developers of the past who did not add their names.
      * @author Alexander S. Lin
@@ -47,6 +54,14 @@ namespace Trick {
              */
             int push(JobData * in_job ) ;
 
+            /**
+             * @brief Adds a group of jobs into list.  The jobs are sorted once and merged into the list
+             * in a single pass.  The resulting order is the same as calling push for each job in turn.
+             * @param in_jobs - Jobs to add to the list
+             * @return always 0.
+             */
+            int push_all(std::vector< JobData * > & in_jobs ) ;
+
             /**
              * @brief Adds a new job into list ignoring the sim_object id.  This is useful for
              * schedulers that redefine the order sim_objects are processed and are only
@@ -190,12 +205,44 @@ namespace Trick {
              */
             int test_next_job_call_time(Trick::JobData * curr_job, long long time_tics) ;
 
+            /**
+             * @brief Enables/disables the dispatch schedule used by find_next_job(long long).
+             * @param yes_no - true to dispatch from the timing wheel, false to scan the list.
+             * @return always 0
+             */
+            int set_dispatch_schedule(bool yes_no) ;
+
+            /**
+             * @brief Gets the dispatch schedule flag.
+             * @return true if the dispatch schedule is enabled.
+             */
+            bool get_dispatch_schedule() ;
+
+            /**
+             * @brief Marks the dispatch schedule for a full rebuild the next time it is used.  Required
+             * after next call times of many jobs are changed outside of the queue.
+             * @return always 0
+             */
+            int rebuild_dispatch_schedule() ;
+
+            /**
+             * @brief Refiles a job in the dispatch schedule after its next call time was changed outside of
+             * the queue.  Only required when the next call time was moved earlier; later times are picked up
+             * automatically.
+             * @param in_job - Job with the changed next call time
+             * @return 0 if the job was refiled, -1 if the job is not in this queue.
+             */
+            int reschedule_job(JobData * in_job) ;
+
         private:
 
             /** number of jobs in list */
             unsigned int list_size ;
 
-            /** Simple reallocable list of JobData pointers.  */
+            /** number of jobs list can hold before it is reallocated */
+            unsigned int list_capacity ;
+
+            /** Simple reallocable list of JobData pointers.  Grows geometrically.  */
             JobData ** list ; /* ** This list is allocated outside of the memory manager. */
 
             /** current index to top job in list */
@@ -203,6 +250,79 @@ namespace Trick {
 
             /** next lowest job call time as tracked by calls to find_next_job(long long) */
             long long next_job_time ;
+
+            /** find_next_job(long long) dispatches from the timing wheel instead of scanning the list */
+            bool dispatch_schedule ;
+
+            /** the timing wheel must be rebuilt from the list before it is used */
+            bool dispatch_dirty ;
+
+            /** dispatch_due holds the jobs due at dispatch_tics for the current pass */
+            bool dispatch_due_valid ;
+
+            /** time of the current dispatch pass in tics */
+            long long dispatch_tics ;
+
+            /** list index the current pass resumes its search of dispatch_due from */
+            unsigned int dispatch_pos ;
+
+            /** number of timing wheel slots, a power of 2 */
+            unsigned int dispatch_num_slots ;
+
+            /** span of call times held by one timing wheel slot in tics */
+            long long dispatch_slot_tics ;
+
+            /** time the timing wheel was last swept up to.  The wheel holds only later times. */
+            long long dispatch_swept ;
+
+            /** Links of the circular lists of the timing wheel.  Node ii below list_size is the job at list
+                index ii, the next dispatch_num_slots nodes head the wheel slots, and the last node heads the
+                parked jobs, whose next call time fell behind the current time.  A node not in a list links
+                to itself. */
+            std::vector< unsigned int > dispatch_next ; /* ** */
+            std::vector< unsigned int > dispatch_prev ; /* ** */
+
+            /** time each job index is filed under in the timing wheel */
+            std::vector< long long > dispatch_filed ; /* ** */
+
+            /** list indexes of system jobs.  These set their own next call times and are tested every pass. */
+            std::vector< unsigned int > dispatch_polled ; /* ** */
+
+            /** bits of the list indexes of the jobs due in the current pass */
+            std::vector< unsigned long long > dispatch_due ; /* ** */
+
+            /** Grows the capacity of list to hold at least in_size jobs */
+            void reserve( unsigned int in_size ) ;
+
+            /** Allocates the timing wheel and fills it and dispatch_polled from the current list */
+            void build_dispatch_wheel() ;
+
+            /** Removes a node from its timing wheel list */
+            void unlink_dispatch_node( unsigned int node ) ;
+
+            /** Adds a node to the end of the timing wheel list starting at head */
+            void link_dispatch_node( unsigned int node , unsigned int head ) ;
+
+            /** Returns the head node of a timing wheel slot */
+            unsigned int dispatch_slot_head( long long slot ) ;
+
+            /** Files a job index in the timing wheel at the incoming time */
+            void file_dispatch_job( unsigned int index , long long time_tics ) ;
+
+            /** Marks a job swept from the timing wheel due, or refiles it */
+            void sweep_dispatch_job( unsigned int index , long long time_tics ) ;
+
+            /** Collects the jobs due at the incoming time into dispatch_due */
+            void build_dispatch_due( long long time_tics ) ;
+
+            /** find_next_job(long long) implementation when the dispatch schedule is enabled */
+            JobData * find_next_dispatch_job( long long time_tics ) ;
+
+            /** Returns the earliest valid time before limit in a timing wheel slot */
+            long long earliest_dispatch_time( unsigned int head , long long time_tics , long long limit ) ;
+
+            /** Folds the earliest valid timing wheel time after the incoming time into next_job_time */
+            void test_next_dispatch_time( long long time_tics ) ;
     } ;
 
 }
@@ -0,0 +1,130 @@
+/*
+    PURPOSE:
+        (Trick thread wait policy implementation)
+*/
+
+#ifndef THREADWAIT_HH
+#define THREADWAIT_HH
+
+#include <iostream>
+#include <map>
+#include <pthread.h>
+
+namespace Trick {
+
+    class JobData ;
+
+    /** This is a list of the ways a thread may wait for another thread or job to complete */
+    enum ThreadWaitPolicy {
+        TW_SPIN,            /**< Spin on the completion flag, releasing the processor if rt_nap is set */
+        TW_SPIN_FUTEX,      /**< Spin an adaptive number of times, then block until signaled */
+        TW_BLOCK            /**< Block until signaled without spinning */
+    } ;
+
+    /**
+     * Wake word owned by a thread that other threads wait on.  The owning thread calls signal()
+     * each time it sets a completion flag, either Trick::Threads::child_complete or a
+     * Trick::JobData::complete flag of one of its jobs.  Waiters block on the word with a futex on
+     * Linux and a condition variable elsewhere.  A signal with no blocked waiters does not make a
+     * system call.
+     */
+    class ThreadSignal {
+        public:
+            ThreadSignal() ;
+            ~ThreadSignal() ;
+
+            /** Returns the current sequence number.  Read before testing the completion flag. */
+            unsigned int get_seq() ;
+
+            /** Advance the sequence number and wake all blocked waiters. */
+            void signal() ;
+
+            /** Block while the sequence number equals in_seq. */
+            void wait( unsigned int in_seq ) ;
+
+        protected:
+            /** Incremented each time the owning thread sets a completion flag */
+            volatile unsigned int seq ;      /**< trick_io(**) */
+
+            /** Number of threads blocked or about to block on seq */
+            volatile int num_waiters ;       /**< trick_io(**) */
+
+            /** Mutex and condition variable used when futexes are not available */
+            pthread_mutex_t wait_mutex ;     /**< trick_io(**) */
+            pthread_cond_t wait_cv ;         /**< trick_io(**) */
+    } ;
+
+    /**
+     * Waiting side of the thread synchronization.  One instance belongs to each Trick::Threads and
+     * determines how that thread waits for other threads and for job dependencies.  The spin count
+     * of TW_SPIN_FUTEX adapts to how long previous waits took.  Time spent waiting is accumulated
+     * per job dependency.
+     */
+    class ThreadWait {
+        public:
+            ThreadWait() ;
+
+            /**
+             * Sets the wait policy
+             * @param in_policy - incoming wait policy as an integer
+             * @return 0 if successful, -1 if policy does not exist
+             */
+            int set_policy( int in_policy ) ;
+
+            /** Returns the wait policy */
+            ThreadWaitPolicy get_policy() ;
+
+            /**
+             * Sets the range the adaptive spin count may move within.  The current spin count is clamped
+             * to the new range.
+             * @return 0 if successful, -1 if the range is invalid
+             */
+            int set_spin_range( unsigned int in_min , unsigned int in_max ) ;
+
+            /**
+             * Waits until flag is true.
+             * @param flag - completion flag to wait on
+             * @param signal - wake word of the thread that sets the flag, may be NULL to always spin
+             * @param rt_nap - release the processor while spinning
+             * @return nanoseconds waited
+             */
+            long long wait( volatile bool & flag , ThreadSignal * signal , bool rt_nap ) ;
+
+            /** Waits for a job dependency to complete and adds the wait time to the dependency counters. */
+            void wait_depend( Trick::JobData * depend_job , ThreadSignal * signal , bool rt_nap ) ;
+
+            /** Clears all of the wait counters */
+            void clear_wait_times() ;
+
+            /** Prints the wait policy and the counters to the incoming stream */
+            void dump( std::ostream & oss ) ;
+
+            /** Wait policy of this thread */
+            ThreadWaitPolicy policy ;        /**< trick_units(--) */
+
+            /** Current adaptive spin count used by TW_SPIN_FUTEX */
+            unsigned int spin_count ;        /**< trick_units(--) */
+
+            /** Lower bound of the adaptive spin count */
+            unsigned int min_spin_count ;    /**< trick_units(--) */
+
+            /** Upper bound of the adaptive spin count */
+            unsigned int max_spin_count ;    /**< trick_units(--) */
+
+            /** Number of waits that found the flag not yet set */
+            long long num_waits ;            /**< trick_units(--) */
+
+            /** Number of waits that had to block */
+            long long num_blocks ;           /**< trick_units(--) */
+
+            /** Total time spent waiting for other threads and dependencies */
+            long long total_wait_ns ;        /**< trick_units(--) */
+
+            /** Time spent waiting on each job dependency */
+            std::map< Trick::JobData * , long long > depend_wait_ns ;   /**< trick_io(**) */
+    } ;
+
+}
+
+#endif
+
@@ -17,6 +17,8 @@
 
 #include "trick/ThreadBase.hh"
 #include "trick/ThreadTrigger.hh"
+#include "trick/ThreadWait.hh"
+#include "trick/ParallelJobPool.hh"
 #include "trick/SimObject.hh"
 #include "trick/ScheduledJobQueue.hh"
 
@@ -93,6 +95,37 @@ namespace Trick {
              */
             int set_async_wait(int yes_no) ;
 
+            /**
+             * Sets how this thread waits for other threads and job dependencies
+             * @param in_policy - incoming wait policy as an integer.  0 = spin, 1 = spin then futex, 2 = block
+             * @return 0 if successful, -1 if policy does not exist
+             */
+            int set_wait_policy(int in_policy) ;
+
+            /**
+             * Sets child_complete and wakes any thread blocked waiting for this thread.
+             */
+            void set_child_complete() ;
+
+            /**
+             * Sets a job complete flag and wakes any thread blocked waiting for the job.
+             * @param job - job that ran on this thread
+             */
+            void set_job_complete( Trick::JobData * job ) ;
+
+            /**
+             * Waits using this thread's wait policy until another thread has set its child_complete flag.
+             * @param other - thread to wait for
+             */
+            void wait_for_thread( Trick::Threads * other ) ;
+
+            /**
+             * Waits using this thread's wait policy until a job this thread depends on has completed.
+             * @param depend_job - job to wait for
+             * @param depend_thread - thread the job runs on, may be NULL
+             */
+            void wait_for_job( Trick::JobData * depend_job , Trick::Threads * depend_thread ) ;
+
             /**
              * This job resets the scheduler queues during a checkpoint restart.
              * @return error code or 0 for no errors.
@@ -152,6 +185,15 @@ namespace Trick {
             /** Wait for asynchronous jobs to finish at shutdown */
             bool shutdown_wait_async;       /**< trick_units(--) */
 
+            /** How this thread waits for other threads and job dependencies, with wait time counters */
+            ThreadWait wait_control ;       /**< trick_units(--) */
+
+            /** Signaled when child_complete or a job complete flag on this thread is set */
+            ThreadSignal complete_signal ;  /**< trick_io(**) */
+
+            /** Helper threads that run the parallel jobs of this thread's scheduled queue */
+            ParallelJobPool parallel_pool ; /**< trick_io(**) */
+
     } ;
 
 }
@@ -0,0 +1,107 @@
+/*
+    PURPOSE:
+        (Copy plan of the variables of a variable server client.)
+*/
+
+#ifndef VARIABLECOPYPLAN_HH
+#define VARIABLECOPYPLAN_HH
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+namespace Trick {
+
+    class VariableReference ;
+
+/**
+  The copy plan groups the variables of a variable server client whose address and size cannot change,
+  variables without a pointer in their address path that are not strings.  The copy buffers of these
+  variables are laid out in one block, sorted by address, so that variables next to each other in the
+  simulation are copied with a single memcpy.  All other variables are copied one at a time by the
+  client thread.
+
+  Clients with the same grouped variables may share one snapshot.  The first client to copy in a given
+  copy phase at a given simulation time gathers the variables and every other client copying in the same
+  phase at the same time copies the whole snapshot with one memcpy.  Only the jobs that copy every client
+  at the same point of a running frame share.  Asynchronous and freeze copies always gather, simulation
+  time does not advance in freeze.
+
+  Building the plan must not run while the copy buffers are read or written.  The client thread builds
+  the plan while holding its copy mutex.
+ */
+
+    class VariableCopyPlan {
+        public:
+            VariableCopyPlan() ;
+            ~VariableCopyPlan() ;
+
+            /**
+             @brief Builds the plan for the list of variables.  The copy buffers of the grouped variables are
+             moved into the plan's blocks keeping their contents.
+             @param vars - the variables of the client
+             @param private_address - address of data that belongs to the client, variables of this address
+             are never shared
+             @param share - join the snapshot shared by clients with the same grouped variables
+             @param alloc_generation - the memory manager's allocation generation the variables were resolved in
+            */
+            void build( std::vector< VariableReference * > & vars , void * private_address , bool share ,
+             unsigned long long alloc_generation ) ;
+
+            /** Marks the plan out of date.  The variables are copied one at a time until the plan is rebuilt. */
+            void invalidate() { valid = false ; }
+
+            /**
+             @brief Returns true if the plan matches the variable list and no allocation was added or removed
+             since it was built.  A new allocation may resolve a variable that is copied one at a time.
+             @param alloc_generation - the memory manager's current allocation generation
+            */
+            bool is_valid( unsigned long long alloc_generation ) const {
+                return valid and alloc_generation == generation ;
+            }
+
+            /**
+             @brief Copies the grouped variables into their buffer_in.
+             @param tics - simulation time of the copy, used to match the shared snapshot
+             @param share_phase - VS_COPY_TOP_OF_FRAME or VS_COPY_SCHEDULED to copy from or into the shared
+             snapshot of that phase if the plan joined one, VS_COPY_ASYNC to always gather
+            */
+            void copy( long long tics , int share_phase ) ;
+
+            /** Returns the variables that are not grouped and must be copied one at a time. */
+            const std::vector< VariableReference * > & get_single_vars() const { return single_vars ; }
+
+            /** Returns the number of memcpy calls used to copy the grouped variables. */
+            size_t get_num_segments() const { return segments.size() ; }
+
+            /** Snapshot shared between plans, defined in VariableCopyPlan.cpp. */
+            struct SharedSnapshot ;
+
+        private:
+            /** A run of simulation memory copied with one memcpy. */
+            struct Segment {
+                const char * source ;
+                size_t offset ;
+                size_t size ;
+            } ;
+
+            /** Leaves the shared snapshot and frees the blocks. */
+            void release() ;
+
+            /** Copies the segments into block. */
+            void gather( char * block ) ;
+
+            bool valid ;
+            unsigned long long generation ;
+            std::vector< Segment > segments ;
+            std::vector< VariableReference * > grouped_vars ;
+            std::vector< size_t > grouped_offsets ;
+            std::vector< VariableReference * > single_vars ;
+            char * blocks[2] ;
+            size_t block_size ;
+            SharedSnapshot * shared ;
+    } ;
+
+}
+
+#endif
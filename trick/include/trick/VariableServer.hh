@@ -12,11 +12,13 @@
 #include <string>
 #include <pthread.h>
 #include "trick/tc.h"
+#include "trick/AsciiFormat.hh"
 #include "trick/reference.h"
 #include "trick/JobData.hh"
 #include "trick/variable_server_sync_types.h"
 #include "trick/VariableServerThread.hh"
 #include "trick/VariableServerListenThread.hh"
+#include "trick/VariableServerEventLoop.hh"
 #include "trick/ThreadBase.hh"
 
 namespace Trick {
@@ -112,6 +114,59 @@ namespace Trick {
             */
             void delete_vst(pthread_t thread_id) ;
 
+            /**
+             @brief Adds a client served by an event loop to the list of clients.
+            */
+            void add_event_client(VariableServerThread * in_vst) ;
+
+            /**
+             @brief Removes a client served by an event loop from the list of clients.
+            */
+            void delete_event_client(VariableServerThread * in_vst) ;
+
+            /**
+             @brief Sets the client whose commands an event loop thread is parsing, returned by get_vst
+             for that thread.  NULL clears it.
+            */
+            void set_event_loop_vst(pthread_t thread_id, VariableServerThread * in_vst) ;
+
+            /**
+             @brief @userdesc Serve TCP clients on this many event loop threads instead of one thread per client
+             (default 0, one thread per client).  Each loop waits on its clients' sockets with epoll.  Must be set
+             before initialization.  UDP and multicast clients always use their own thread.
+             @par Python Usage:
+             @code trick.var_server_set_event_loops(<num_loops>) @endcode
+             @param num_loops - number of event loop threads, 0 for one thread per client
+            */
+            void set_num_event_loops(unsigned int num_loops) ;
+
+            /**
+             @brief @userdesc Gets the number of event loop threads requested.
+             @par Python Usage:
+             @code <my_int> = trick.var_server_get_event_loops() @endcode
+            */
+            unsigned int get_num_event_loops() ;
+
+            /**
+             @brief @userdesc Sets the number of bytes an event loop holds for a client that is not reading its data
+             before disconnecting that client (default 1048576).  Event loops never wait for a client, data the
+             socket does not take right away is held and sent when the socket is writable again.
+             @par Python Usage:
+             @code trick.var_server_set_event_output_limit(<bytes>) @endcode
+            */
+            void set_event_output_limit(unsigned int in_limit) ;
+
+            /**
+             @brief Gets the event output limit in bytes.
+            */
+            unsigned int get_event_output_limit() ;
+
+            /**
+             @brief Gets the event loop serving the fewest clients.
+             @return the event loop, or NULL if clients use their own threads
+            */
+            Trick::VariableServerEventLoop * get_event_loop() ;
+
             /**
              @brief @userdesc Return host name from the listen device.
              @par Python Usage:
@@ -278,7 +333,22 @@ namespace Trick {
             /** Map thread id to the VariableServerThread object.\n */
             std::map < pthread_t , VariableServerThread * > var_server_threads ; /**<  trick_io(**) */
 
-            /** Mutex to ensure only one thread manipulates the map of var_server_threads\n */
+            /** All clients, served by their own thread or by an event loop.\n */
+            std::vector < VariableServerThread * > clients ; /**<  trick_io(**) */
+
+            /** Map event loop thread id to the client whose commands it is parsing.\n */
+            std::map < pthread_t , VariableServerThread * > event_loop_vsts ; /**<  trick_io(**) */
+
+            /** Requested number of event loop threads, 0 for one thread per client.\n */
+            unsigned int num_event_loops ;   /**<  trick_units(--) */
+
+            /** Bytes held for an event loop client that is not reading before the client is disconnected.\n */
+            unsigned int event_output_limit ; /**<  trick_units(--) */
+
+            /** The event loop threads.\n */
+            std::vector < VariableServerEventLoop * > event_loops ; /**<  trick_io(**) */
+
+            /** Mutex to ensure only one thread manipulates the map of var_server_threads and the list of clients\n */
             pthread_mutex_t map_mutex ;     /**<  trick_io(**) */
 
             /** Map of additional listen threads created by create_tcp_socket.\n */
@@ -289,13 +359,14 @@ namespace Trick {
 
 }
 
-int vs_format_ascii(Trick::VariableReference * var, char *value);
+int vs_format_ascii(Trick::VariableReference * var, Trick::AsciiRow & row, bool round_trip);
 
 Trick::VariableServer * var_server_get_var_server() ;
 
 // external calls to be made available from input processor
 int var_add(std::string in_name) ;
 int var_add(std::string in_name, std::string units_name) ;
+int var_add_list(std::string in_names) ;
 int var_remove(std::string in_name) ;
 int var_units(std::string var_name , std::string units_name) ;
 int var_exists(std::string in_name) ;
@@ -312,6 +383,8 @@ int var_debug(int level) ;
 int var_ascii() ;
 int var_binary() ;
 int var_binary_nonames() ;
+int var_ascii_round_trip(bool on_off) ;
+int var_share_snapshot(bool on_off) ;
 int var_validate_address(int on_off) ;
 int var_set_copy_mode(int mode) ;
 int var_set_write_mode(int mode) ;
@@ -0,0 +1,125 @@
+/*
+PURPOSE:
+    (C++ client of the variable server binary protocol.)
+ICG: (No)
+*/
+
+#ifndef VARIABLESERVERCLIENT_HH
+#define VARIABLESERVERCLIENT_HH
+
+#include <string>
+#include <vector>
+
+#include "trick/tc.h"
+#include "trick/VariableServerDecoder.hh"
+
+namespace Trick {
+
+    /**
+      Subscribes to sim variables over one variable server connection and decodes the binary
+      messages straight into caller owned destinations.
+
+      @code
+      struct State { double pos[3] ; double vel[3] ; long long tics ; } state ;
+      Trick::VariableServerClient client ;
+      client.add_variable("ball.state.output.position", state.pos, 3) ;
+      client.add_variable("ball.state.output.velocity", state.vel, 3) ;
+      client.add_variable("trick_sys.sched.time_tics", &state.tics) ;
+      client.connect("localhost", port) ;
+      client.set_cycle(0.01) ;
+      while ( client.receive() > 0 ) { ... use state ... }
+      @endcode
+
+      Values are sent raw, so units given to var_add have no effect on them.  The client does
+      its own byte swapping, so the server's var_byteswap is not used.
+    */
+    class VariableServerClient {
+
+        public:
+
+            VariableServerClient() ;
+            ~VariableServerClient() ;
+
+            /**
+             @brief Connect to the variable server and subscribe to the variables added so far.
+             @param names - send variable names with the values (var_binary) and match values by
+                            name.  Without names (var_binary_nonames) values are matched by order.
+            */
+            int connect( const std::string & host , int port , bool names = false ) ;
+            int disconnect() ;
+            bool is_connected() const ;
+
+            /** Send a command, e.g. "trick.var_pause()".  A newline is added. */
+            int send_command( const std::string & command ) ;
+
+            /**
+             @brief Subscribe to a variable.  Each frame copies its value to dest.
+             @param dest_size - size of dest in bytes.  A value of another size is copied as far
+                                as it fits and counted in get_num_size_mismatches.
+            */
+            int add_variable( const std::string & name , void * dest , unsigned int dest_size ) ;
+
+            /** Subscribe to a variable or an array of count elements. */
+            template < class T > int add_variable( const std::string & name , T * dest , unsigned int count = 1 ) {
+                return add_variable( name , (void *)dest , (unsigned int)(sizeof(T) * count) ) ;
+            }
+
+            /** Unsubscribe from all variables (var_clear). */
+            int clear_variables() ;
+
+            /** Seconds between frames (var_cycle). */
+            int set_cycle( double period ) ;
+            /** VS_COPY_ASYNC, VS_COPY_SCHEDULED or VS_COPY_TOP_OF_FRAME (var_set_copy_mode). */
+            int set_copy_mode( int mode ) ;
+            /** VS_WRITE_ASYNC or VS_WRITE_WHEN_COPIED (var_set_write_mode). */
+            int set_write_mode( int mode ) ;
+            int pause( bool on_off ) ;
+            /** Ask for one frame now (var_send). */
+            int request_frame() ;
+
+            /** @return 1 if name exists in the sim, 0 if not, -1 on error. */
+            int var_exists( const std::string & name ) ;
+
+            /**
+             @brief Wait for the next complete frame.
+             @return 1 when a frame was decoded, -1 if the connection closed or failed.
+            */
+            int receive() ;
+            /**
+             @brief Decode what has arrived without waiting.
+             @return 1 if a frame was completed, 0 if not, -1 if the connection closed or failed.
+            */
+            int poll() ;
+
+            /** Values of the last frame, valid until the next receive or poll. */
+            const std::vector< VariableServerValue > & get_values() const ;
+
+            unsigned long get_num_frames() const ;
+            unsigned long get_num_bytes() const ;
+            unsigned long get_num_size_mismatches() const ;
+
+        private:
+
+            VariableServerClient( const VariableServerClient & ) ;
+            VariableServerClient & operator = ( const VariableServerClient & ) ;
+
+            int read_socket( bool wait ) ;
+            int decode_buffer( int wanted_kind ) ;
+            int wait_for( int wanted_kind ) ;
+
+            TCDevice connection ;                   /**< trick_io(**) */
+            bool connected ;                        /**< trick_io(**) */
+            VariableServerDecoder decoder ;         /**< trick_io(**) */
+            std::vector< std::string > names ;      /**< trick_io(**) Variables to add on connect. */
+
+            std::vector< char > buffer ;            /**< trick_io(**) Receive buffer. */
+            size_t begin ;                          /**< trick_io(**) First byte not decoded. */
+            size_t end ;                            /**< trick_io(**) End of the received bytes. */
+
+            unsigned long num_frames ;              /**< trick_io(**) */
+            unsigned long num_bytes ;               /**< trick_io(**) */
+    } ;
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+PURPOSE:
+    (Decodes the binary messages of the variable server.)
+ICG: (No)
+*/
+
+#ifndef VARIABLESERVERDECODER_HH
+#define VARIABLESERVERDECODER_HH
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace Trick {
+
+    /** A value as it arrived from the variable server, in host byte order. */
+    struct VariableServerValue {
+        int type ;           /**< trick_io(**) TRICK_TYPE of the variable. */
+        unsigned int size ;  /**< trick_io(**) Size of the value in bytes. */
+        const char * data ;  /**< trick_io(**) The value, within the receive buffer. */
+    } ;
+
+    /**
+      Decodes var_binary and var_binary_nonames messages, as written by
+      VariableServerThread::write_binary_data, in place.  Each variable is bound to a
+      destination that its value is copied into as soon as it is decoded.  No memory is
+      allocated while decoding.
+
+      The server writes in its own byte order.  The order is detected from the message
+      header and values are swapped in the receive buffer when it differs from the host
+      order, so var_byteswap should be left off.
+    */
+    class VariableServerDecoder {
+
+        public:
+
+            /** What the last decoded message was. */
+            enum MessageKind {
+                VALUES ,          /**< Values of part of a frame. */
+                FRAME ,           /**< Values that completed a frame. */
+                EXISTS ,          /**< The answer to var_exists, in get_message_value. */
+                LIST_SIZE ,       /**< The answer to var_send_list_size, in get_message_value. */
+                STDIO             /**< Redirected output of the sim, skipped. */
+            } ;
+
+            VariableServerDecoder() ;
+
+            /** Set when the server was sent var_binary instead of var_binary_nonames. */
+            void set_names( bool names_sent ) ;
+
+            /**
+             @brief Bind the next variable of the server's list to a destination.
+             @param name - the variable name given to var_add
+             @param dest - where its value is copied, may be NULL
+             @param dest_size - size of dest in bytes.  Strings are truncated and terminated to fit.
+             @return the index of the variable
+            */
+            unsigned int add_variable( const std::string & name , void * dest , unsigned int dest_size ) ;
+            void clear() ;
+            unsigned int num_variables() const ;
+
+            /**
+             @brief Decode the message at buffer[begin].
+             @return the length of the message, 0 if the message is not complete
+                     in buffer[begin, end), or -1 if it cannot be decoded.
+            */
+            int decode( char * buffer , size_t begin , size_t end ) ;
+
+            /** Kind of the last decoded message. */
+            MessageKind get_message_kind() const ;
+            /** The result of a var_exists or var_send_list_size message. */
+            int get_message_value() const ;
+
+            /** Values of the last complete frame.  data points into the buffer given to decode. */
+            const std::vector< VariableServerValue > & get_values() const ;
+
+            /** Offsets into the buffer given to decode move down by shift, e.g. after the buffer is compacted. */
+            void shift( size_t shift ) ;
+            /** Offset of the first message of the frame being decoded, or of the next frame. */
+            size_t get_frame_begin() const ;
+            bool in_frame() const ;
+
+            /** Values whose size differed from the size of their destination. */
+            unsigned long get_num_size_mismatches() const ;
+            bool get_server_swapped() const ;
+
+        private:
+
+            struct Binding {
+                std::string name ;
+                void * dest ;
+                unsigned int dest_size ;
+                int type ;
+                unsigned int size ;
+                size_t offset ;
+            } ;
+
+            int decode_values( char * buffer , size_t begin , size_t length ) ;
+            void store( Binding & binding , char * data , int type , unsigned int size , size_t offset ) ;
+
+            std::vector< Binding > bindings ;               /**< trick_io(**) */
+            std::vector< VariableServerValue > values ;     /**< trick_io(**) */
+            unsigned int next_variable ;                    /**< trick_io(**) Index of the next variable of the frame. */
+            size_t frame_begin ;                            /**< trick_io(**) */
+            bool names ;                                    /**< trick_io(**) */
+            bool server_swapped ;                           /**< trick_io(**) */
+            MessageKind message_kind ;                      /**< trick_io(**) */
+            int message_value ;                             /**< trick_io(**) */
+            unsigned long num_size_mismatches ;             /**< trick_io(**) */
+    } ;
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*
+    PURPOSE:
+        (VariableServerEventLoop)
+*/
+
+#ifndef VARIABLESERVEREVENTLOOP_HH
+#define VARIABLESERVEREVENTLOOP_HH
+
+#include <vector>
+#include <pthread.h>
+#include "trick/ThreadBase.hh"
+
+namespace Trick {
+
+    class VariableServerThread ;
+
+/**
+  This class serves many variable server clients on one thread.  The clients are VariableServerThread
+  objects whose own threads are never started.  The loop waits on all of their sockets with epoll, parses
+  the commands of each client as they arrive, and does the asynchronous copy and write of each client when
+  its var_cycle time comes.  Commands and data go through the same VariableServerThread code as a client
+  with its own thread, so the commands and the ascii and binary formats are the same.
+ */
+    class VariableServerEventLoop : public Trick::ThreadBase {
+
+        public:
+            VariableServerEventLoop() ;
+            virtual ~VariableServerEventLoop() ;
+
+            /**
+             @brief Creates the epoll and wake up descriptors.
+             @return 0 if successful, -1 if event loops are not supported on this platform
+            */
+            int init() ;
+
+            /**
+             @brief Hands an accepted client to the loop.  Called from the listen thread.
+            */
+            void add_client( VariableServerThread * vst ) ;
+
+            /**
+             @brief Gets the number of clients served by this loop, used to balance the loops.
+            */
+            unsigned int get_num_clients() ;
+
+            /**
+             @brief The loop waiting on the client sockets.
+            */
+            virtual void * thread_body() ;
+
+            /**
+             @brief Disconnects and deletes all clients.  Called when the thread is cancelled.
+            */
+            void remove_all_clients() ;
+
+        protected:
+            /**
+             @brief Takes the clients handed over by add_client and starts waiting on their sockets.
+            */
+            void register_new_clients() ;
+
+            /**
+             @brief Stops waiting on the client socket, removes the client from the variable server,
+             disconnects, and deletes it.
+            */
+            void remove_client( VariableServerThread * vst ) ;
+
+            /** The epoll descriptor of the client sockets.\n */
+            int epoll_fd ;           /**<  trick_io(**) */
+
+            /** Descriptor written by add_client to wake up the loop.\n */
+            int wake_fd ;            /**<  trick_io(**) */
+
+            /** Clients served by the loop, only touched by the loop thread.\n */
+            std::vector < VariableServerThread * > clients ;  /**<  trick_io(**) */
+
+            /** Clients handed over by add_client and not registered yet.\n */
+            std::vector < VariableServerThread * > new_clients ;  /**<  trick_io(**) */
+
+            /** Mutex protecting new_clients.\n */
+            pthread_mutex_t new_clients_mutex ;  /**<  trick_io(**) */
+
+            /** Number of clients including new_clients.\n */
+            unsigned int num_clients ;  /**<  trick_io(**) */
+
+    } ;
+
+}
+
+#endif
@@ -29,10 +29,14 @@ namespace Trick {
             cv_converter * conversion_factor ; // ** udunits conversion factor
             void * buffer_in ;
             void * buffer_out ;
+            void * own_buffer_in ;    // ** buffers allocated for this variable, the copy plan may move
+            void * own_buffer_out ;   // ** buffer_in and buffer_out into its blocks
             void * address ;          // -- address of data copied to buffer
             int size ;                // -- size of data copied to buffer
             TRICK_TYPE string_type ;  // -- indicate if this is a string or wstring
             bool need_deref ;         // -- inidicate this is a painter to be dereferenced
+            void * validated_address ;                 // ** last address found in the memory manager
+            unsigned long long validated_generation ;  // ** memory manager allocation generation of that check
     } ;
 
 }
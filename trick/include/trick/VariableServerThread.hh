@@ -12,6 +12,7 @@
 #include "trick/tc.h"
 #include "trick/ThreadBase.hh"
 #include "trick/VariableServerReference.hh"
+#include "trick/VariableCopyPlan.hh"
 #include "trick/variable_server_sync_types.h"
 
 namespace Trick {
@@ -78,6 +79,16 @@ namespace Trick {
             */
             int var_add( std::string in_name, std::string units_name ) ;
 
+            /**
+             @brief @userdesc Command to add a list of variables to the registered variables in one command.
+             This is the same as a var_add command for each name, in order, without a round trip per name.
+             @par Python Usage:
+             @code trick.var_add_list("<name_1>, <name_2>, ...") @endcode
+             @param in_names - the variable names to retrieve, separated by commas
+             @return always 0
+            */
+            int var_add_list( std::string in_names ) ;
+
             /**
              @brief @userdesc Command to remove a variable (previously registered with var_add)
              from the list of registered variables for value retrieval.
@@ -210,6 +221,29 @@ namespace Trick {
             */
             int var_binary_nonames() ;
 
+            /**
+             @brief @userdesc Command to instruct the variable server to return ASCII floating point values with the
+             fewest digits that read back to the same value (default is false).  When off, doubles are returned
+             with 16 significant digits and floats with 8.
+             @par Python Usage:
+             @code trick.var_ascii_round_trip(<on_off>) @endcode
+             @param on_off - true to return the shortest round trip values
+             @return always 0
+            */
+            int var_ascii_round_trip(bool on_off) ;
+
+            /**
+             @brief @userdesc Command to share one copy of the variables with other clients watching the same
+             variables (default is false).  The first client to copy at a simulation time copies the variables
+             from the simulation, the other clients copy that snapshot.  Only used in the VS_COPY_SCHEDULED and
+             VS_COPY_TOP_OF_FRAME copy modes.
+             @par Python Usage:
+             @code trick.var_share_snapshot(<on_off>) @endcode
+             @param on_off - true to share the copy with other clients
+             @return always 0
+            */
+            int var_share_snapshot(bool on_off) ;
+
             /**
              @brief @userdesc Command to tell the server when to copy data
              - VS_COPY_ASYNC = copies data asynchronously. (default)
@@ -363,8 +397,10 @@ namespace Trick {
 
             /**
              @brief Copy client variable values from Trick memory to each variable's output buffer.
+             @param share_phase - VS_COPY_TOP_OF_FRAME or VS_COPY_SCHEDULED when called by the job of that
+             copy phase, the copy may use the snapshot shared with other clients.  VS_COPY_ASYNC otherwise.
             */
-            int copy_sim_data();
+            int copy_sim_data( int share_phase = VS_COPY_ASYNC );
 
             /**
              @brief Write data in the appropriate format (var_ascii or var_binary) from variable output buffers to socket.
@@ -415,13 +451,86 @@ namespace Trick {
             */
             int create_mcast_socket(const char * mcast_address, const char * address, unsigned short in_port) ;
 
+            /**
+             @brief Accepts a connection on the listen device for a client served by an event loop instead of
+             its own thread.  Writes to the client never block, see write_connection.
+             @param output_limit - bytes held for the client before it is disconnected
+             @return 0 if the connection was accepted
+            */
+            int accept_event_connection( unsigned int output_limit ) ;
+
+            /**
+             @brief Called by the event loop when the socket is readable.  Reads what is on the socket without
+             blocking and parses the complete commands.
+             @return 0, or -1 if the client disconnected or sent var_exit
+            */
+            int read_event_commands() ;
+
+            /**
+             @brief Called by the event loop to do the work thread_body does each cycle, copying and writing
+             data when the next cycle time is reached.
+             @param now - the monotonic clock time in seconds
+             @return 0, or -1 if the client should be disconnected
+            */
+            int service_event( double now ) ;
+
+            /**
+             @brief Gets the monotonic clock time in seconds of the next service_event cycle.
+            */
+            double get_next_event_time() ;
+
+            /**
+             @brief Called by the event loop when the socket is writable.  Sends the data held by
+             write_connection that the socket takes without blocking.
+             @return 0, or -1 if the client should be disconnected
+            */
+            int flush_event_output() ;
+
         protected:
 
+            /**
+             @brief Prints, logs, and parses the commands in msg.  msg must have room for a null terminator at msg_len.
+            */
+            void parse_commands( char * msg , int msg_len ) ;
+
+            /**
+             @brief Runs the commands in msg without the input processor if every command in msg is a core
+             trick.var_* command with literal arguments.
+             @return true if the commands were run, false if msg must be given to the input processor
+            */
+            bool parse_native_commands( const char * msg ) ;
+
+            /**
+             @brief Parses the complete commands read by read_event_commands, unless the client is paused for a
+             checkpoint reload.
+            */
+            void parse_event_commands() ;
+
+            /**
+             @brief Copies and writes data according to the asynchronous copy and write modes.
+             @return 0, or -1 if the write failed
+            */
+            int copy_and_write_async() ;
+
+            /**
+             @brief Writes to the client.  Clients served by an event loop are written without blocking, the
+             bytes the socket does not take are held in event_output and sent by flush_event_output.  A client
+             holding more than event_output_limit bytes is disconnected.
+             @param limit_output - false to hold the bytes even past event_output_limit, for a file the client asked for
+             @return size, or -1 if the write failed and the client should be disconnected
+            */
+            int write_connection( const char * buffer , int size , bool limit_output = true ) ;
+
             /**
              @brief Called by send_sie commands to transmit files through the socket.
             */
             int transmit_file(std::string file_name);
 
+            /**
+             @brief Called by copy_sim_data to copy a variable that is not in the copy plan.
+            */
+            void copy_variable( VariableReference * curr_var ) ;
+
             /**
              @brief Called by write_data to write data to socket in var_binary format.
             */
@@ -515,6 +624,9 @@ namespace Trick {
             /** Toggle to tell variable server return data in binary format without the variable names.\n */
             bool binary_data_nonames ;       /**<  trick_io(**) */
 
+            /** Toggle to tell variable server to return the shortest round trip ASCII floating point values.\n */
+            bool ascii_round_trip ;          /**<  trick_io(**) */
+
             /** Toggle to tell variable server to send data multicast or point to point.\n */
             bool multicast ;                 /**<  trick_io(**) */
 
@@ -539,6 +651,12 @@ namespace Trick {
             /** number of packets copied to client \n */
             unsigned int packets_copied ; /**< trick_io(**) */
 
+            /** Groups the variables with fixed addresses into as few copies as possible.\n */
+            VariableCopyPlan copy_plan ;  /**< trick_io(**) */
+
+            /** Toggle to share the copy of the variables with clients watching the same variables.\n */
+            bool share_snapshot ;         /**< trick_io(**) */
+
             /** Toggle to indicate sending python stdout and stderr to client\n */
             bool send_stdio ;                /**<  trick_io(**) */
 
@@ -548,6 +666,24 @@ namespace Trick {
             /** Message with '\r' characters removed\n */
             char *stripped_msg;           /**<  trick_io(**) */
 
+            /** Bytes read by an event loop that are not parsed yet\n */
+            std::string event_msg ;       /**<  trick_io(**) */
+
+            /** Monotonic clock time in seconds of the next event loop cycle\n */
+            double next_event_time ;      /**<  trick_io(**) */
+
+            /** Set when the client is served by an event loop and written without blocking\n */
+            bool event_client ;           /**<  trick_io(**) */
+
+            /** Bytes written to an event loop client that the socket has not taken yet\n */
+            std::string event_output ;    /**<  trick_io(**) */
+
+            /** Most bytes held in event_output before the client is disconnected\n */
+            unsigned int event_output_limit ;  /**<  trick_io(**) */
+
+            /** Protects event_output, written by the event loop and by the copy jobs of the main thread\n */
+            pthread_mutex_t event_output_mutex ;  /**<  trick_io(**) */
+
             /** Maximum size of incoming message\n */
             static const unsigned int MAX_CMD_LEN = 200000 ;
     } ;
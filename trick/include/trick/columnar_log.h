@@ -0,0 +1,46 @@
+#ifndef COLUMNAR_LOG_H
+#define COLUMNAR_LOG_H
+
+/*
+    PURPOSE: ( On disk layout of the Trick columnar log file written by Trick::DRColumnar and read by the
+               data products.  See Trick::DRColumnar for a description of the whole file. )
+*/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** First 8 characters of the file.  The next 2 are "-L" for little endian or "-B" for big endian. */
+#define TRICK_COLUMNAR_MAGIC "Trick-CL"
+
+/** Last 8 characters of a file that was closed normally */
+#define TRICK_COLUMNAR_FOOTER_MAGIC "TRKCFOOT"
+
+/**
+ * Start of each chunk.  The header is followed by a pair of doubles for each variable holding the
+ * smallest and largest value of the variable in the chunk.  The column of each variable follows in
+ * header order, num_rows values of the variable's size each.
+ */
+typedef struct {
+    uint32_t num_rows ;     /* number of records in the chunk */
+    uint32_t reserved ;     /* always 0 */
+    double first_time ;     /* sys.exec.out.time of the first record */
+    double last_time ;      /* sys.exec.out.time of the last record */
+} COLUMNAR_CHUNK_HEADER ;
+
+/**
+ * End of a file that was closed normally.  It follows the file offset of each chunk as a uint64_t.
+ * A file without the footer, as after a crash, is read by hopping from chunk header to chunk header.
+ */
+typedef struct {
+    uint64_t num_chunks ;   /* number of chunk offsets before the footer */
+    char magic[8] ;         /* TRICK_COLUMNAR_FOOTER_MAGIC */
+} COLUMNAR_FOOTER ;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
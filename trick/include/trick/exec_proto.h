@@ -21,6 +21,7 @@ extern "C" {
     long long exec_get_freeze_frame_tics(void) ;
     long long exec_get_freeze_time_tics( void ) ;
     double exec_get_job_cycle(const char * job_name) ;
+    int exec_get_job_dispatch_schedule(void) ;
     SIM_MODE exec_get_mode(void) ;
     unsigned int exec_get_num_threads(void) ;
     int exec_get_old_time_tic_value( void ) ;
@@ -48,7 +49,9 @@ extern "C" {
     int exec_set_freeze_frame(double) ;
     int exec_set_enable_freeze( int on_off ) ;
     int exec_set_job_cycle(const char * job_name, int instance_num, double in_cycle) ;
+    int exec_set_job_dispatch_schedule(int on_off) ;
     int exec_set_job_onoff(const char * job_name , int instance_num, int on) ;
+    int exec_set_job_parallel(const char * job_name , int instance_num, int on) ;
     int exec_set_rt_nap(int on_off) ;
     int exec_set_sim_object_onoff(const char * sim_object_name , int on) ;
     int exec_set_software_frame(double) ;
@@ -62,6 +65,8 @@ extern "C" {
     int exec_set_thread_cpu_affinity(unsigned int thread_id , int cpu_num) ;
     int exec_set_thread_priority(unsigned int thread_id , unsigned int req_priority) ;
     int exec_set_thread_process_type( unsigned int thread_id , int process_type ) ;
+    int exec_set_thread_wait_policy( unsigned int thread_id , int policy ) ;
+    int exec_set_thread_parallel_workers( unsigned int thread_id , unsigned int num_workers ) ;
     int exec_set_time( double in_time ) ;
     int exec_set_time_tics( long long in_time_tics ) ;
     int exec_set_time_tic_value( int in_time_tics ) ;
@@ -14,6 +14,7 @@ int exec_get_sim_objects(std::vector<Trick::SimObject *>& in_sim_object_vector )
 
 Trick::JobData * exec_get_job(const char * job_name, unsigned int j_instance = 1 ) ;
 Trick::JobData * exec_get_curr_job() ;
+int exec_reschedule_job( Trick::JobData * job ) ;
 
 Trick::Threads * exec_get_thread( unsigned int thread_id ) ;
 
@@ -70,6 +70,7 @@
 #include "trick/DataRecordDispatcher.hh"
 #include "trick/DRAscii.hh"
 #include "trick/DRBinary.hh"
+#include "trick/DRColumnar.hh"
 #include "trick/DRHDF5.hh"
 #include "trick/DebugPause.hh"
 #include "trick/EchoJobs.hh"
@@ -70,6 +70,7 @@ int   get_truncated_size(void *addr) ;
 int   io_get_fixed_truncated_size(char *ptr, ATTRIBUTES * A, char *str, int dims, ATTRIBUTES * left_type) ;
 ALLOC_INFO* get_alloc_info_of(void * addr);
 ALLOC_INFO* get_alloc_info_at(void * addr);
+unsigned long long get_alloc_generation(void);
 int set_alloc_name_at(void * addr, const char * name );
 
 void ref_free( REF2 *R ) ;
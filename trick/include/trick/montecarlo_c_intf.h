@@ -89,6 +89,18 @@ void mc_set_max_tries(unsigned int max_tries);
  */
 unsigned int mc_get_max_tries();
 
+/**
+ * @relates Trick::MonteCarlo
+ * @copydoc set_batch_size
+ */
+void mc_set_batch_size(unsigned int batch_size);
+
+/**
+ * @relates Trick::MonteCarlo
+ * @copydoc get_batch_size
+ */
+unsigned int mc_get_batch_size();
+
 /**
  * @relates Trick::MonteCarlo
  * @copydoc set_user_cmd_string
@@ -18,6 +18,10 @@ void var_server_set_user_tag(const char * tag) ;
 int var_server_get_enabled() ;
 void var_server_set_enabled(int on_off) ;
 
+unsigned int var_server_get_event_loops() ;
+void var_server_set_event_loops(unsigned int num_loops) ;
+void var_server_set_event_output_limit(unsigned int in_limit) ;
+
 int var_server_create_tcp_socket(const char * address, unsigned short port) ;
 int var_server_create_udp_socket(const char * address, unsigned short port) ;
 int var_server_create_multicast_socket(const char * mcast_address, const char * address, unsigned short port) ;
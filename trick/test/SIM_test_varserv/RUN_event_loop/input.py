@@ -0,0 +1,16 @@
+import trick
+
+def main():
+	trick.var_server_set_port(40001)
+
+	# Serve all clients on two epoll event loop threads instead of one thread per client.
+	trick.var_server_set_event_loops(2)
+	trick.var_server_set_event_output_limit(1048576)
+
+	trick.real_time_enable()
+	trick.itimer_enable()
+
+	trick.exec_set_terminate_time(3000.0)
+
+if __name__ == "__main__":
+	main()
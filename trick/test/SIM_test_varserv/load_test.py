@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+Variable server load test.  Opens many client connections to a running sim, has every client watch
+the same variables at the same cycle, and reports how many messages each client received and how late
+they arrived.  Run the sim with RUN_event_loop/input.py to test the event loops or RUN_test/realtime.py
+for one thread per client, then for example
+
+    ./load_test.py --port 40001 --clients 2000 --cycle 0.1 --duration 30
+
+Raise the open file limit (ulimit -n) above the number of clients first.
+"""
+
+import argparse
+import selectors
+import socket
+import sys
+import time
+
+VARIABLES = [ "vsx.vst.a", "vsx.vst.c", "vsx.vst.e", "vsx.vst.g", "vsx.vst.i", "vsx.vst.j", "vsx.vst.k" ]
+
+def main():
+    parser = argparse.ArgumentParser(description="Variable server load test")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=40001)
+    parser.add_argument("--clients", type=int, default=1000)
+    parser.add_argument("--cycle", type=float, default=0.1, help="var_cycle of each client in seconds")
+    parser.add_argument("--duration", type=float, default=30.0, help="seconds to receive data")
+    parser.add_argument("--binary", action="store_true", help="use var_binary instead of var_ascii")
+    parser.add_argument("--sync", type=int, default=0, help="var_sync mode of each client")
+    args = parser.parse_args()
+
+    commands = "trick.var_set_client_tag(\"load_test\")\n"
+    commands += "trick.var_binary()\n" if args.binary else "trick.var_ascii()\n"
+    commands += "trick.var_sync(%d)\n" % args.sync
+    commands += "trick.var_cycle(%g)\n" % args.cycle
+    for var in VARIABLES:
+        commands += "trick.var_add(\"%s\")\n" % var
+    commands = commands.encode()
+
+    sel = selectors.DefaultSelector()
+    received = {}
+    start = time.monotonic()
+    for ii in range(args.clients):
+        try:
+            sock = socket.create_connection((args.host, args.port))
+        except OSError as err:
+            print("connection %d failed: %s" % (ii, err))
+            break
+        sock.sendall(commands)
+        sock.setblocking(False)
+        sel.register(sock, selectors.EVENT_READ, ii)
+        received[ii] = [0, 0]
+    connected = len(received)
+    print("%d clients connected in %.2f s" % (connected, time.monotonic() - start))
+
+    # Ascii messages end with a newline.  Binary messages are not split out, reads are counted instead.
+    start = time.monotonic()
+    closed = 0
+    while time.monotonic() - start < args.duration:
+        for key, mask in sel.select(timeout=1.0):
+            try:
+                data = key.fileobj.recv(65536)
+            except OSError:
+                data = b""
+            if not data:
+                sel.unregister(key.fileobj)
+                key.fileobj.close()
+                closed += 1
+                continue
+            received[key.data][0] += data.count(b"\n") if not args.binary else 1
+            received[key.data][1] += len(data)
+    elapsed = time.monotonic() - start
+
+    counts = sorted(r[0] for r in received.values())
+    total_bytes = sum(r[1] for r in received.values())
+    expected = elapsed / args.cycle
+    print("clients %d, closed by server %d" % (connected, closed))
+    print("messages per client: min %d median %d max %d (expected about %d)" %
+          (counts[0], counts[len(counts) // 2], counts[-1], expected))
+    print("total %.1f messages/s, %.1f KB/s" % (sum(counts) / elapsed, total_bytes / elapsed / 1024.0))
+    if not args.binary and counts[0] < 0.9 * expected:
+        print("slowest client received less than 90% of the expected messages")
+        return 1
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,20 @@
+dyn.baseball.pos[0] = 16.0
+dyn.baseball.pos[1] = 0.1
+dyn.baseball.pos[2] = 2.0
+
+dyn.baseball.vel[0] = -30.0
+dyn.baseball.vel[1] = -0.1
+dyn.baseball.vel[2] = 1.0
+
+dyn.baseball.theta = trick.attach_units("d",-90.0)
+dyn.baseball.phi = trick.attach_units("d",1.0)
+dyn.baseball.omega0 = trick.attach_units("rev/s",30.0)
+
+# Integrate in adaptive substeps sized by the error estimate of RKF45.
+# The loop still ends each 0.1 second cycle exactly on the cycle time.
+integ = dyn_integloop.getIntegrator(trick.Runge_Kutta_Fehlberg_45, 6)
+integ.set_tolerance(1.0e-10, 1.0e-10)
+dyn_integloop.set_integ_cycle(0.1)
+dyn_integloop.integ_sched.set_adaptive_step(True)
+
+trick.exec_set_terminate_time(5.2)
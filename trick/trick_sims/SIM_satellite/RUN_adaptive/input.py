@@ -0,0 +1,34 @@
+# A batch run, without real time or graphics.
+trick.exec_set_job_onoff("dyn.sat_graph_comm.connect", 1, False)
+trick.exec_set_job_onoff("dyn.sat_graph_comm.send_packet", 1, False)
+trick.exec_set_job_onoff("dyn.sat_graph_comm.send_packet", 2, False)
+
+# Integrate in adaptive substeps sized by the error estimate of RKF45.
+# The loop still ends each 0.1 second cycle exactly on the cycle time,
+# where the scheduled print_state job sees the state.
+integ = dyn_integloop.getIntegrator(trick.Runge_Kutta_Fehlberg_45, 18)
+integ.set_tolerance(1.0e-10, 1.0e-10)
+dyn_integloop.integ_sched.set_adaptive_step(True)
+
+# Fire Thrusters at the given times.
+read = 10
+trick.add_read(read,"""dyn.satellite.thruster_T1.on = True""")
+
+read = 20
+trick.add_read(read,"""dyn.satellite.thruster_T1.on = False""")
+trick.add_read(read,"""dyn.satellite.thruster_T3.on = True""")
+
+read = 30
+trick.add_read(read,"""dyn.satellite.thruster_T3.on = False""")
+
+read = 50
+trick.add_read(read,"""dyn.satellite.thruster_T3.on = True""")
+
+read = 60
+trick.add_read(read,"""dyn.satellite.thruster_T3.on = False""")
+trick.add_read(read,"""dyn.satellite.thruster_T1.on = True""")
+
+read = 70
+trick.add_read(read,"""dyn.satellite.thruster_T1.on = False""")
+
+trick.stop(5400)
@@ -14,12 +14,15 @@ class Arena {
         void unblock(unsigned int x, unsigned int y);
         void mark(unsigned int x, unsigned int y, char c);
         std::vector<GridSquare*> getNeighbors(GridSquare* gridSquarePointer);
+        int getNeighbors(GridSquare* gridSquarePointer, GridSquare* neighbors[8]);
         GridSquare* getGridSquare(unsigned int x, unsigned int y);
         int getGridSquareCoordinates(GridSquare* gridSquarePointer, Point& coords);
         int movementCostEstimate(GridSquare* orig, GridSquare* dest, int& cost);
         int distanceBetween(GridSquare* orig, GridSquare* dest, int& distance);
         int getHeight(){return height;}
         int getWidth(){return width;}
+        unsigned int newSearch();
+        unsigned int getSearchId(){return searchId;}
 
         friend std::ostream& operator<< (std::ostream& s, const Arena& arena);
 
@@ -27,6 +30,7 @@ class Arena {
         int height;
         int width;
         GridSquare *grid;
+        unsigned int searchId;
         int calcOffset(unsigned int x, unsigned int y, size_t& offset);
         int calcOffset(GridSquare* gridSquare, size_t& offset);
 };
@@ -2,4 +2,48 @@
 #define FINDPATH_HH
 #include "arena.hh"
 std::vector<Point> FindPath( GridSquare* origin, GridSquare* goal, Arena* arena);
+
+// A* path finder that keeps its search tree between calls. When only the
+// goal changes, or updateCell() blocks squares, the next findPath() resumes
+// the previous search instead of starting over.
+class PathFinder {
+    public:
+        PathFinder(Arena* arena);
+        std::vector<Point> findPath(GridSquare* origin, GridSquare* goal);
+        void updateCell(unsigned int x, unsigned int y, bool blocked);
+        void reset();
+        unsigned int getExpansions(){return expansions;}
+
+    private:
+        struct OpenEntry {
+            int f_score;
+            int g_score;
+            unsigned int order;
+            GridSquare* gridSquare;
+        };
+        struct OpenEntryCompare {
+            bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+                if (a.f_score != b.f_score) {
+                    return a.f_score > b.f_score;
+                }
+                return a.order > b.order;
+            }
+        };
+
+        Arena* arena;
+        GridSquare* origin;
+        GridSquare* goal;
+        unsigned int searchId;
+        unsigned int order;
+        unsigned int expansions;
+        std::vector<OpenEntry> openHeap;
+        std::vector<GridSquare*> repairQueue;
+
+        void startSearch(GridSquare* origin);
+        void retarget(GridSquare* goal);
+        void removeSubtree(GridSquare* root);
+        void pushOpen(GridSquare* gridSquare);
+        bool isStale(const OpenEntry& entry);
+        std::vector<Point> buildPath(GridSquare* gridSquare);
+};
 #endif
@@ -8,5 +8,12 @@ class GridSquare {
     GridSquare* parent;
     int g_score;
     int f_score;
+    // Path search bookkeeping. isOpen and isClosed are only meaningful
+    // when searchId matches the Arena's current search. openOrder breaks
+    // f_score ties in favor of the square opened first.
+    unsigned int searchId;
+    unsigned int openOrder;
+    bool isOpen;
+    bool isClosed;
 };
 #endif
@@ -3,25 +3,36 @@
 #include <stdlib.h>    // abs()
 #include <iostream>
 
+static void initSearchState(GridSquare& gridSquare) {
+    gridSquare.parent = (GridSquare*)0;
+    gridSquare.g_score = 0;
+    gridSquare.f_score = 0;
+    gridSquare.searchId = 0;
+    gridSquare.openOrder = 0;
+    gridSquare.isOpen = false;
+    gridSquare.isClosed = false;
+}
+
 Arena::Arena(unsigned int width, unsigned int height)
-    : height(height), width(width) {
+    : height(height), width(width), searchId(0) {
 
     unsigned int area = height * width;
     grid = new GridSquare[area];
-    for (int i=0; i < area; i++) {
+    for (unsigned int i=0; i < area; i++) {
         grid[i].isBlocked = false;
         grid[i].mark = ' ' ;
+        initSearchState(grid[i]);
     }
 }
 
 Arena::Arena(unsigned int width, unsigned int height, unsigned char bits[])
-      : height(height), width(width) {
+      : height(height), width(width), searchId(0) {
 
    unsigned int area = height * width;
    grid = new GridSquare[area];
 
    unsigned int cx =0;
-   for (int row=0; row<height; row++) {
+   for (unsigned int row=0; row<height; row++) {
        unsigned char octet = bits[cx];
        unsigned int bx=0;
        while ( bx < width ) {
@@ -33,6 +44,7 @@ Arena::Arena(unsigned int width, unsigned int height, unsigned char bits[])
            grid[ii].isBlocked = (0x01 & octet);
            octet = octet >> 1;
            grid[ii].mark = ' ' ;
+           initSearchState(grid[ii]);
            bx++;
        }
        cx ++;
@@ -41,7 +53,20 @@ Arena::Arena(unsigned int width, unsigned int height, unsigned char bits[])
 }
 
 Arena::~Arena() {
-    delete grid;
+    delete [] grid;
+}
+
+// Start a new path search. GridSquares whose searchId differs from the
+// returned id are treated as unvisited, so nothing has to be cleared.
+unsigned int Arena::newSearch() {
+    if (++searchId == 0) {
+        unsigned int area = height * width;
+        for (unsigned int i=0; i < area; i++) {
+            initSearchState(grid[i]);
+        }
+        searchId = 1;
+    }
+    return searchId;
 }
 
 //straightDistance
@@ -58,13 +83,22 @@ int Arena::distanceBetween( GridSquare* orig, GridSquare* dest, int& distance )
     return 1;
 }
 
-//manhattenDistance
+// The estimate must never fall by more than the cost of a step, or the g_scores of expanded
+// GridSquares are not the least costs and a PathFinder cannot resume its search for a new goal.
+// With diagonal steps that is the octile distance, otherwise the manhattan distance.
 int Arena::movementCostEstimate( GridSquare* orig, GridSquare* dest, int& costEstimate ) {
     Point origPt;
     Point destPt;
     if ((( getGridSquareCoordinates(orig, origPt) ) == 0) &&
         (( getGridSquareCoordinates(dest, destPt) ) == 0)) {
-        costEstimate = 10 * (abs(destPt.x - origPt.x) + abs(destPt.y - origPt.y));
+        int dx = abs(destPt.x - origPt.x);
+        int dy = abs(destPt.y - origPt.y);
+#ifdef DIAGONAL_NEIGHBORS
+        int diagonal = (dx < dy) ? dx : dy;
+        costEstimate = 14 * diagonal + 10 * (dx + dy - 2 * diagonal);
+#else
+        costEstimate = 10 * (dx + dy);
+#endif
         return 0;
     }
     std::cerr << "Arena::movementCostEstimate: bad pointer parameter(s)." << std::endl;
@@ -93,7 +127,7 @@ void Arena::mark(unsigned int x, unsigned int y, char c) {
 }
 
 int Arena::calcOffset(unsigned int x, unsigned int y, size_t& offset) {
-    if ((x < width) && (y < height)) {
+    if ((x < (unsigned int)width) && (y < (unsigned int)height)) {
         offset = x+width*y;
         return 0;
     }
@@ -104,7 +138,7 @@ int Arena::calcOffset(GridSquare* gridSquare, size_t& offset) {
 
     if (gridSquare >= grid) {
         size_t toffset = (gridSquare - grid);
-        if (toffset < (width * height)) {
+        if (toffset < (size_t)(width * height)) {
             offset = toffset;
             return 0;
         }
@@ -132,9 +166,11 @@ int Arena::getGridSquareCoordinates( GridSquare* gridSquarePointer, Point& coord
     }
 }
 
-std::vector<GridSquare*> Arena::getNeighbors( GridSquare* gridSquarePointer ) {
+// Fill neighbors with the unblocked neighbors of gridSquarePointer and
+// return how many there are. No memory is allocated.
+int Arena::getNeighbors( GridSquare* gridSquarePointer, GridSquare* neighbors[8] ) {
 
-    std::vector<GridSquare*> neighbors;
+    int count = 0;
     GridSquare* neighbor;
     Point loc;
 
@@ -143,42 +179,49 @@ std::vector<GridSquare*> Arena::getNeighbors( GridSquare* gridSquarePointer ) {
 #ifdef DIAGONAL_NEIGHBORS
         if ((neighbor=getGridSquare(loc.x+1, loc.y+1)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
         if ((neighbor=getGridSquare(loc.x+1, loc.y-1)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
         if ((neighbor=getGridSquare(loc.x-1, loc.y-1)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
         if ((neighbor=getGridSquare(loc.x-1, loc.y+1)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
 #endif
         if ((neighbor=getGridSquare(loc.x, loc.y+1)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
         if ((neighbor=getGridSquare(loc.x, loc.y-1)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
         if ((neighbor=getGridSquare(loc.x-1, loc.y)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
         if ((neighbor=getGridSquare(loc.x+1, loc.y)) != (GridSquare*)0) {
             if (!neighbor->isBlocked)
-                neighbors.push_back(neighbor);
+                neighbors[count++] = neighbor;
         }
 
     } else {
         std::cerr << "Arena::getNeighbors: invalid gridSquarePointer.";
     }
-    return neighbors;
+    return count;
+}
+
+std::vector<GridSquare*> Arena::getNeighbors( GridSquare* gridSquarePointer ) {
+
+    GridSquare* neighbors[8];
+    int count = getNeighbors( gridSquarePointer, neighbors );
+    return std::vector<GridSquare*>( neighbors, neighbors + count );
 }
 
 std::ostream& operator<< (std::ostream& s, const Arena& arena) {
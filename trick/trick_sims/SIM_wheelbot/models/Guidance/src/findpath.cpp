@@ -1,106 +1,192 @@
 #include <stdlib.h>
 #include <vector>    // std::vector
-#include <algorithm> // std::find
+#include <algorithm> // std::push_heap, std::pop_heap, std::make_heap, std::reverse
 #include "findpath.hh"
 
 std::vector<Point> FindPath( GridSquare* origin, GridSquare* goal, Arena* arena) {
 
-    std::vector<GridSquare*> openSet;
-    std::vector<GridSquare*> closedSet;
     std::vector<Point> failure;
 
+    if (arena == (Arena*)0) {
+        return failure;
+    }
+    PathFinder pathFinder(arena);
+    return pathFinder.findPath(origin, goal);
+}
+
+PathFinder::PathFinder(Arena* arena)
+    : arena(arena), origin((GridSquare*)0), goal((GridSquare*)0),
+      searchId(0), order(0), expansions(0) {
+}
+
+// Forget the search tree. The next findPath() starts from scratch.
+void PathFinder::reset() {
+    origin = (GridSquare*)0;
+    goal = (GridSquare*)0;
+    openHeap.clear();
+}
+
+void PathFinder::startSearch( GridSquare* newOrigin ) {
+
+    searchId = arena->newSearch();
+    openHeap.clear();
+    order = 0;
+    origin = newOrigin;
+
+    origin->parent = (GridSquare*)0;
+    origin->g_score = 0;
+    origin->searchId = searchId;
+    origin->isOpen = false;
+    origin->isClosed = false;
+    pushOpen(origin);
+}
+
+// Re-key the open set for a new goal. The g_scores of the open and closed
+// GridSquares are costs from the origin, so they stay valid. Those of the
+// closed squares are least costs only because the cost estimate is
+// consistent, see Arena::movementCostEstimate().
+void PathFinder::retarget( GridSquare* newGoal ) {
+
+    goal = newGoal;
+    std::vector<OpenEntry>::iterator curr, kept;
+    for (curr=kept=openHeap.begin(); curr != openHeap.end(); ++curr) {
+        if ( !isStale(*curr) ) {
+            int estimated_cost_to_goal;
+            arena->movementCostEstimate(curr->gridSquare, goal, estimated_cost_to_goal);
+            curr->f_score = curr->g_score + estimated_cost_to_goal;
+            curr->gridSquare->f_score = curr->f_score;
+            *kept++ = *curr;
+        }
+    }
+    openHeap.erase(kept, openHeap.end());
+    std::make_heap(openHeap.begin(), openHeap.end(), OpenEntryCompare());
+}
+
+void PathFinder::pushOpen( GridSquare* gridSquare ) {
+
+    int estimated_cost_to_goal;
+    arena->movementCostEstimate(gridSquare, goal, estimated_cost_to_goal);
+    gridSquare->f_score = gridSquare->g_score + estimated_cost_to_goal;
+    if (!gridSquare->isOpen) {
+        gridSquare->openOrder = order++;
+        gridSquare->isOpen = true;
+    }
+
+    OpenEntry entry;
+    entry.f_score = gridSquare->f_score;
+    entry.g_score = gridSquare->g_score;
+    entry.order = gridSquare->openOrder;
+    entry.gridSquare = gridSquare;
+    openHeap.push_back(entry);
+    std::push_heap(openHeap.begin(), openHeap.end(), OpenEntryCompare());
+}
+
+// A GridSquare is pushed again whenever its g_score improves, rather than
+// being moved within the heap. Only the entry carrying its current g_score
+// is live.
+bool PathFinder::isStale( const OpenEntry& entry ) {
+    return ( !entry.gridSquare->isOpen ||
+             (entry.gridSquare->g_score != entry.g_score) );
+}
+
+std::vector<Point> PathFinder::buildPath( GridSquare* current ) {
+
+    std::vector<Point> path;
+    while (current != (GridSquare*)0) {
+        Point coordinates;
+        if ( arena->getGridSquareCoordinates( current, coordinates ) == 0) {
+            path.push_back(coordinates);
+        }
+        current = current->parent;
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<Point> PathFinder::findPath( GridSquare* newOrigin, GridSquare* newGoal ) {
+
+    std::vector<Point> failure;
 
     if (arena == (Arena*)0) {
         return failure;
     }
     Point origPt, goalPt;
-    if (arena->getGridSquareCoordinates(origin, origPt) != 0) {
+    if (arena->getGridSquareCoordinates(newOrigin, origPt) != 0) {
         std::cerr << "FindPath: Bad Origin.";
         return failure;
     }
-    if (arena->getGridSquareCoordinates(goal, goalPt) != 0) {
+    if (arena->getGridSquareCoordinates(newGoal, goalPt) != 0) {
         std::cerr << "FindPath: Bad Goal.";
         return failure;
     }
 
-    origin->parent = (GridSquare*)0;
-    origin->g_score = 0;
-    int f_score;
-    arena->movementCostEstimate(origin, goal, f_score);
-    origin->f_score = f_score;
+    // The search tree can be reused only if it is rooted at the same origin
+    // and no other search has run on the arena since.
+    if ((newOrigin != origin) || (searchId != arena->getSearchId())) {
+        goal = newGoal;
+        startSearch(newOrigin);
+    } else if (newGoal != goal) {
+        retarget(newGoal);
+    }
 
-    openSet.push_back(origin);
+    // The goal was expanded by an earlier search, so its path is final.
+    if ((goal->searchId == searchId) && goal->isClosed) {
+        return buildPath(goal);
+    }
 
-    while ( !openSet.empty() ) {
+    GridSquare* neighbors[8];
 
-        // Get the item in the openSet that has the lowest f_score.
-        std::vector<GridSquare*>::iterator curr, best;
-        for (best=curr=openSet.begin(); curr != openSet.end(); ++curr) {
-             if ( (*curr)->f_score < (*best)->f_score ) {
-                 best = curr;
-             }
-        }
+    while ( !openHeap.empty() ) {
 
-        // Get and remove the best from the open set. This is current.
-        GridSquare* current = *best;
-        openSet.erase(best);
+        // Get the item in the open set that has the lowest f_score.
+        OpenEntry best = openHeap.front();
+        GridSquare* current = best.gridSquare;
+        if ( isStale(best) ) {
+            std::pop_heap(openHeap.begin(), openHeap.end(), OpenEntryCompare());
+            openHeap.pop_back();
+            continue;
+        }
 
         // if the current position is the goal then backtrack, build
-        // and return the path to get here.
+        // and return the path to get here. The goal stays in the open
+        // set so that a later search for another goal can expand it.
         if (current == goal) {
-            std::vector<Point> path;
-            while (current != (GridSquare*)0) {
-                Point coordinates;
-                if ( arena->getGridSquareCoordinates( current, coordinates ) == 0) {
-                    path.insert( path.begin(), coordinates);
-                }
-                current = current->parent;
-            }
-            return path;
+            return buildPath(current);
         }
 
-        // Add current to the closed set.
-        closedSet.push_back(current);
-
-        // Get the neighbors of current.
-        std::vector<GridSquare*> neighbors = arena->getNeighbors( current );
-
-        // For each of the neighbors
-        std::vector<GridSquare*>::iterator neighborsIterator;
-        for ( neighborsIterator=neighbors.begin();
-              neighborsIterator!=neighbors.end();
-              ++neighborsIterator) {
+        // Move current from the open set to the closed set.
+        std::pop_heap(openHeap.begin(), openHeap.end(), OpenEntryCompare());
+        openHeap.pop_back();
+        current->isOpen = false;
+        current->isClosed = true;
+        expansions++;
 
-            GridSquare* neighbor = *neighborsIterator;
+        // For each of the neighbors of current.
+        int count = arena->getNeighbors( current, neighbors );
+        for (int ii = 0; ii < count; ii++) {
 
-            // Search for the neighbor in the closed set.
-            std::vector<GridSquare*>::iterator closedSetIterator =
-                find ( closedSet.begin(), closedSet.end(), neighbor );
+            GridSquare* neighbor = neighbors[ii];
+            bool visited = (neighbor->searchId == searchId);
 
             // if neighbor is not in the closed set.
-            if (closedSetIterator == closedSet.end()) {
+            if (!visited || !neighbor->isClosed) {
 
                 // Calculate a g_score for this neighbor.
                 int cost_to_move_to_neighbor;
                 arena->distanceBetween( current, neighbor, cost_to_move_to_neighbor );
                 int neighbor_g_score = current->g_score + cost_to_move_to_neighbor;
 
-                // Search for the neighbor in the openset.
-                std::vector<GridSquare*>::iterator openSetIterator =
-                    find ( openSet.begin(), openSet.end(), neighbor );
-
-                // if neighbor is in the openset and the tentative g score is better than the current score
-                if ((openSetIterator == openSet.end()) || (neighbor_g_score < neighbor->g_score)) {
+                // if neighbor is not in the openset or the tentative g score is better than the current score
+                if (!visited || !neighbor->isOpen || (neighbor_g_score < neighbor->g_score)) {
 
+                    if (!visited) {
+                        neighbor->searchId = searchId;
+                        neighbor->isOpen = false;
+                        neighbor->isClosed = false;
+                    }
                     neighbor->parent = current;
                     neighbor->g_score = neighbor_g_score;
-                    int estimated_cost_to_goal;
-                    arena->movementCostEstimate(neighbor, goal, estimated_cost_to_goal );
-                    neighbor->f_score = neighbor->g_score + estimated_cost_to_goal;
-
-                    if (openSetIterator == openSet.end()) {
-                        openSet.push_back(neighbor);
-                    }
+                    pushOpen(neighbor);
                 }
             }
         }
@@ -108,3 +194,83 @@ std::vector<Point> FindPath( GridSquare* origin, GridSquare* goal, Arena* arena)
     std::cerr << "Failed to find a path to the goal.";
     return failure;
 }
+
+// Remove the subtree of the search tree rooted at a newly blocked
+// GridSquare. Costs through it are no longer valid. Squares outside the
+// subtree keep their g_scores, since blocking only removes routes. Closed
+// squares bordering the removed subtree are opened again so that the search
+// can reach the removed squares by other routes.
+void PathFinder::removeSubtree( GridSquare* root ) {
+
+    GridSquare* neighbors[8];
+
+    repairQueue.clear();
+    repairQueue.push_back(root);
+    root->isOpen = false;
+    root->isClosed = false;
+    for (size_t head = 0; head < repairQueue.size(); head++) {
+        GridSquare* current = repairQueue[head];
+        int count = arena->getNeighbors( current, neighbors );
+        for (int ii = 0; ii < count; ii++) {
+            GridSquare* neighbor = neighbors[ii];
+            if ((neighbor->searchId == searchId) && (neighbor->parent == current) &&
+                (neighbor->isOpen || neighbor->isClosed)) {
+                neighbor->isOpen = false;
+                neighbor->isClosed = false;
+                repairQueue.push_back(neighbor);
+            }
+        }
+    }
+    for (size_t head = 0; head < repairQueue.size(); head++) {
+        repairQueue[head]->searchId = 0;
+    }
+    for (size_t head = 1; head < repairQueue.size(); head++) {
+        int count = arena->getNeighbors( repairQueue[head], neighbors );
+        for (int ii = 0; ii < count; ii++) {
+            GridSquare* neighbor = neighbors[ii];
+            if ((neighbor->searchId == searchId) && neighbor->isClosed) {
+                neighbor->isClosed = false;
+                pushOpen(neighbor);
+            }
+        }
+    }
+}
+
+// Block or unblock a GridSquare and keep as much of the search tree as is
+// still correct. Unblocking a square next to a closed square may lower the
+// costs of squares that were already expanded, so the next findPath()
+// starts over.
+void PathFinder::updateCell( unsigned int x, unsigned int y, bool blocked ) {
+
+    GridSquare* gridSquare = arena->getGridSquare(x, y);
+    if ((gridSquare == (GridSquare*)0) || (gridSquare->isBlocked == blocked)) {
+        return;
+    }
+    if (blocked) {
+        arena->block(x, y);
+    } else {
+        arena->unblock(x, y);
+    }
+    if ((origin == (GridSquare*)0) || (searchId != arena->getSearchId())) {
+        return;
+    }
+
+    if (blocked) {
+        if (gridSquare == origin) {
+            reset();
+        } else if (gridSquare->searchId == searchId) {
+            // An open square may still have a subtree. removeSubtree() reopens
+            // closed squares and they keep their children.
+            removeSubtree(gridSquare);
+        }
+    } else {
+        GridSquare* neighbors[8];
+        int count = arena->getNeighbors( gridSquare, neighbors );
+        for (int ii = 0; ii < count; ii++) {
+            if ((neighbors[ii]->searchId == searchId) && neighbors[ii]->isClosed) {
+                reset();
+                return;
+            }
+        }
+    }
+}
@@ -193,8 +193,9 @@ TEST(ArenaTest, movementCostEstimate_three)
   GridSquare *agridSquare = arena.getGridSquare(1,2);
   GridSquare *anothergridSquare = arena.getGridSquare(3,4);
   int costestimate;
+  //Two diagonal steps, as the Guidance library is built with DIAGONAL_NEIGHBORS
   arena.movementCostEstimate(agridSquare,anothergridSquare,costestimate);
-  EXPECT_EQ (costestimate, 40);
+  EXPECT_EQ (costestimate, 28);
 }
 
 TEST(ArenaTest, distanceBetween_one)
@@ -373,3 +374,21 @@ TEST(ArenaTest, getNeighbors_four)
 
 
 }
+
+TEST(ArenaTest, getNeighbors_five)
+{
+  //Tests that the array form of getNeighbors returns the same neighbors as the vector form
+  Arena arena(3,3);
+  GridSquare *agridSquare = arena.getGridSquare(1,1);
+  arena.block(0,0);
+  arena.block(2,2);
+
+  std::vector<GridSquare*> neighborvector = arena.getNeighbors(agridSquare);
+  GridSquare* neighbors[8];
+  int count = arena.getNeighbors(agridSquare, neighbors);
+
+  ASSERT_EQ (count, (int)neighborvector.size());
+  for (int ii = 0; ii < count; ii++) {
+    EXPECT_EQ (neighbors[ii], neighborvector[ii]);
+  }
+}
@@ -179,6 +179,56 @@ TEST(FindPathTest, FindPath_five)
 
 }
 
+TEST(FindPathTest, PathFinder_one)
+{
+ //Tests that a PathFinder finds the same path as FindPath when only the goal changes
+ Arena arena(10,7);
+ Arena otherarena(10,7);
+
+ arena.block(3,2);
+ arena.block(3,3);
+ arena.block(3,4);
+ otherarena.block(3,2);
+ otherarena.block(3,3);
+ otherarena.block(3,4);
+
+ PathFinder pathfinder(&arena);
+ std::vector<Point> firstpath = pathfinder.findPath(arena.getGridSquare(1,3), arena.getGridSquare(8,1));
+ std::vector<Point> secondpath = pathfinder.findPath(arena.getGridSquare(1,3), arena.getGridSquare(8,5));
+ std::vector<Point> freshpath = FindPath(otherarena.getGridSquare(1,3), otherarena.getGridSquare(8,5), &otherarena);
+
+ EXPECT_GT(firstpath.size(),0);
+ ASSERT_EQ(secondpath.size(),freshpath.size());
+ for (unsigned int ii = 0; ii < freshpath.size(); ii++) {
+   EXPECT_EQ(secondpath[ii].x, freshpath[ii].x);
+   EXPECT_EQ(secondpath[ii].y, freshpath[ii].y);
+ }
+}
+
+TEST(FindPathTest, PathFinder_two)
+{
+ //Tests that a PathFinder avoids a square blocked after its first search
+ Arena arena(10,7);
+ PathFinder pathfinder(&arena);
+
+ GridSquare *origin = arena.getGridSquare(1,3);
+ GridSquare *goal = arena.getGridSquare(8,3);
+
+ std::vector<Point> firstpath = pathfinder.findPath(origin,goal);
+ ASSERT_GT(firstpath.size(),2);
+
+ Point middle = firstpath[firstpath.size()/2];
+ pathfinder.updateCell(middle.x, middle.y, true);
+ std::vector<Point> secondpath = pathfinder.findPath(origin,goal);
+
+ ASSERT_GT(secondpath.size(),0);
+ EXPECT_EQ(secondpath.back().x, 8);
+ EXPECT_EQ(secondpath.back().y, 3);
+ for (unsigned int ii = 0; ii < secondpath.size(); ii++) {
+   EXPECT_FALSE(arena.getGridSquare(secondpath[ii].x, secondpath[ii].y)->isBlocked);
+ }
+}
+
 /*TEST(FindPathTest, FindPath_three)
 {
   //Tests if FindPath returns the correct values
@@ -241,3 +291,102 @@ TEST(FindPathTest, FindPath_five)
  EXPECT_EQ(desiredvalues[6].x, returnvalue[6].x);
  EXPECT_EQ(desiredvalues[6].y, returnvalue[6].y);
 }*/
+
+static unsigned int test_seed;
+static unsigned int test_random() {
+    test_seed = test_seed * 1103515245 + 12345;
+    return (test_seed >> 16) & 0x7fff;
+}
+
+// Returns the cost of a path, or -1 if it steps onto a blocked square or between squares that are not neighbors.
+static int pathCost(Arena& arena, const std::vector<Point>& path) {
+    int cost = 0;
+    for (unsigned int ii = 0; ii < path.size(); ii++) {
+        GridSquare* gridSquare = arena.getGridSquare(path[ii].x, path[ii].y);
+        if (gridSquare->isBlocked) {
+            return -1;
+        }
+        if (ii > 0) {
+            int dx = abs(path[ii].x - path[ii-1].x);
+            int dy = abs(path[ii].y - path[ii-1].y);
+            if ((dx > 1) || (dy > 1)) {
+                return -1;
+            }
+            int step;
+            arena.distanceBetween(arena.getGridSquare(path[ii-1].x, path[ii-1].y), gridSquare, step);
+            cost += step;
+        }
+    }
+    return cost;
+}
+
+TEST(FindPathTest, PathFinder_three)
+{
+ //Tests that a PathFinder avoids an area blocked twice in a row, half of its
+ //squares at a time, wherever the area lies in the search tree
+ for (unsigned int bx = 0; bx < 10; bx++) {
+   for (unsigned int by = 0; by < 10; by++) {
+     Arena arena(12,12);
+     PathFinder pathfinder(&arena);
+     GridSquare *origin = arena.getGridSquare(1,11);
+     GridSquare *goal = arena.getGridSquare(10,2);
+
+     ASSERT_GT(pathfinder.findPath(origin,arena.getGridSquare(7,1)).size(),0);
+     for (unsigned int pass = 0; pass < 2; pass++) {
+       for (unsigned int ii = pass; ii < 9; ii += 2) {
+         unsigned int x = bx + ii % 3;
+         unsigned int y = by + ii / 3;
+         if ((arena.getGridSquare(x,y) != origin) && (arena.getGridSquare(x,y) != goal)) {
+           pathfinder.updateCell(x, y, true);
+         }
+       }
+       std::vector<Point> path = pathfinder.findPath(origin,goal);
+       for (unsigned int ii = 0; ii < path.size(); ii++) {
+         EXPECT_FALSE(arena.getGridSquare(path[ii].x, path[ii].y)->isBlocked)
+           << "area at " << bx << "," << by << " pass " << pass;
+       }
+     }
+   }
+ }
+}
+
+TEST(FindPathTest, PathFinder_random)
+{
+ //Tests that a PathFinder finds paths as short as a fresh FindPath on random
+ //arenas, as the goal moves and squares are blocked between searches
+ for (unsigned int trial = 0; trial < 50; trial++) {
+   Arena arena(30,30);
+   Arena freshArena(30,30);
+   test_seed = trial + 1;
+   for (unsigned int y = 0; y < 30; y++) {
+     for (unsigned int x = 0; x < 30; x++) {
+       if ((test_random() % 4) == 0) {
+         arena.block(x, y);
+         freshArena.block(x, y);
+       }
+     }
+   }
+   arena.unblock(1,1);
+   freshArena.unblock(1,1);
+
+   PathFinder pathfinder(&arena);
+   for (unsigned int search = 0; search < 20; search++) {
+     unsigned int gx = test_random() % 30;
+     unsigned int gy = test_random() % 30;
+     if ((trial % 2) == 1) {
+       for (unsigned int ii = 0; ii < 3; ii++) {
+         unsigned int x = test_random() % 30;
+         unsigned int y = test_random() % 30;
+         if ((x != 1) || (y != 1)) {
+           pathfinder.updateCell(x, y, true);
+           freshArena.block(x, y);
+         }
+       }
+     }
+     std::vector<Point> path = pathfinder.findPath(arena.getGridSquare(1,1), arena.getGridSquare(gx,gy));
+     std::vector<Point> freshPath = FindPath(freshArena.getGridSquare(1,1), freshArena.getGridSquare(gx,gy), &freshArena);
+     ASSERT_EQ(path.empty(), freshPath.empty()) << "trial " << trial << " search " << search;
+     EXPECT_EQ(pathCost(freshArena, freshPath), pathCost(arena, path)) << "trial " << trial << " search " << search;
+   }
+ }
+}
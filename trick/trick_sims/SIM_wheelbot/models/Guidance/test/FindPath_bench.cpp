@@ -0,0 +1,139 @@
+/*
+   PURPOSE: (Benchmark of FindPath and of PathFinder replanning.)
+
+   Searches a 1000 x 1000 arena with a quarter of its squares blocked at random and with walls that
+   force the path to wind back and forth across the arena. Each case plans
+   from one corner region to a sequence of goals near the far corner, as the wheelbot does when its
+   destination moves, first with a fresh FindPath() per goal and then with one PathFinder that keeps
+   its search tree. The last case blocks a few squares between goals, as when the wheelbot finds new
+   obstacles.
+
+   It is not part of the tests. Build it against the Guidance library with
+       c++ -O2 -I../include FindPath_bench.cpp ../lib/libGuidance.a -o FindPath_bench
+
+   usage: FindPath_bench [width height]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "findpath.hh"
+
+static double wall_time() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+// Small deterministic generator so every platform benches the same arena.
+static unsigned int seed = 12345;
+static unsigned int next_random() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+}
+
+static void buildArena(Arena& arena, int width, int height) {
+    seed = 12345;
+    for (int y=0; y < height; y++) {
+        for (int x=0; x < width; x++) {
+            if ((next_random() % 4) == 0) {
+                arena.block(x, y);
+            }
+        }
+    }
+    // Every tenth of the width a wall, open alternately at the bottom and the top.
+    for (int x = width / 10; x < width - width / 10; x += width / 10) {
+        bool gapAtBottom = ((x / (width / 10)) % 2) == 1;
+        for (int y=0; y < height; y++) {
+            bool inGap = gapAtBottom ? (y >= height - height / 20) : (y < height / 20);
+            if (!inGap) {
+                arena.block(x, y);
+            }
+        }
+    }
+}
+
+static const int NUM_GOALS = 20;
+
+static void report(const char* name, double seconds, size_t pathLength, int found) {
+    std::cout << std::setw(28) << std::left << name
+              << std::setw(10) << std::right << std::fixed << std::setprecision(2) << seconds * 1000.0 << " ms"
+              << std::setw(10) << found << " paths"
+              << std::setw(10) << pathLength << " squares" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    int width = 1000;
+    int height = 1000;
+    if (argc > 2) {
+        width = atoi(argv[1]);
+        height = atoi(argv[2]);
+    }
+
+    Arena arena(width, height);
+    buildArena(arena, width, height);
+
+    int ox = width / 20;
+    int oy = height / 20;
+    arena.unblock(ox, oy);
+    GridSquare* origin = arena.getGridSquare(ox, oy);
+
+    // Goals walk along a short line near the far corner.
+    Point goals[NUM_GOALS];
+    for (int ii=0; ii < NUM_GOALS; ii++) {
+        goals[ii].x = width - width / 20 - ii;
+        goals[ii].y = height - height / 20;
+        arena.unblock(goals[ii].x, goals[ii].y);
+    }
+
+    std::cout << "Arena " << width << " x " << height << ", " << NUM_GOALS << " goals" << std::endl;
+
+    // A fresh search per goal.
+    size_t length = 0;
+    int found = 0;
+    double start = wall_time();
+    for (int ii=0; ii < NUM_GOALS; ii++) {
+        std::vector<Point> path = FindPath(origin, arena.getGridSquare(goals[ii].x, goals[ii].y), &arena);
+        length += path.size();
+        found += !path.empty();
+    }
+    report("FindPath", wall_time() - start, length, found);
+
+    // One PathFinder. Only the goal changes.
+    PathFinder pathFinder(&arena);
+    length = 0;
+    found = 0;
+    start = wall_time();
+    for (int ii=0; ii < NUM_GOALS; ii++) {
+        std::vector<Point> path = pathFinder.findPath(origin, arena.getGridSquare(goals[ii].x, goals[ii].y));
+        length += path.size();
+        found += !path.empty();
+    }
+    report("PathFinder goal change", wall_time() - start, length, found);
+    std::cout << "    expansions " << pathFinder.getExpansions() << std::endl;
+
+    // One PathFinder. A few squares are blocked between goals.
+    PathFinder changingFinder(&arena);
+    length = 0;
+    found = 0;
+    start = wall_time();
+    for (int ii=0; ii < NUM_GOALS; ii++) {
+        for (int jj=0; jj < 4; jj++) {
+            int x = next_random() % width;
+            int y = next_random() % height;
+            bool isGoal = (y == goals[0].y) && (x <= goals[0].x) && (x > goals[0].x - NUM_GOALS);
+            if (((x != ox) || (y != oy)) && !isGoal) {
+                changingFinder.updateCell(x, y, true);
+            }
+        }
+        std::vector<Point> path = changingFinder.findPath(origin, arena.getGridSquare(goals[ii].x, goals[ii].y));
+        length += path.size();
+        found += !path.empty();
+    }
+    report("PathFinder blocked squares", wall_time() - start, length, found);
+    std::cout << "    expansions " << changingFinder.getExpansions() << std::endl;
+
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <vector>
 #include <iostream>
 #include "Log/TrickBinary.hh"
+#include "Log/TrickBinaryFile.hh"
 #include <string.h>
 #include <stdlib.h>
 
@@ -42,7 +43,6 @@ void usage() {
 
 int main(int argc, char* argv[])
 {
-    double t, y ;
     char *trk_file_name = NULL;
     char *ascii_file_name = NULL;
     FILE *fp;
@@ -54,13 +54,18 @@ int main(int argc, char* argv[])
     int Format=0;  /* default to csv */
     string delimiter(",");  /* default delimter */
 
-    int i, done;
+    int i;
     char *prog_name = argv[0];
 
-    DataStream* each_ds;
-    vector <DataStream*> ds_list;
+    // All columns are read from the file together, block_size records at a time
+    const size_t block_size = 1024;
+    TrickBinaryFile* trk_file;
+    vector <int> columns;
+    vector < vector <double> > block;
+    vector <double*> block_ptrs;
+    size_t first_record, num_read, row;
     // idx is used when comparing with the size() of the vector
-    vector <DataStream*>::size_type idx;
+    vector <int>::size_type idx;
 
     if (argc <= 1 ) {
         cerr << prog_name << ": No arguments were supplied.\n";
@@ -146,6 +151,17 @@ int main(int argc, char* argv[])
         exit(EXIT_FAILURE);
     }
 
+    if (( trk_file = TrickBinaryFile::open(trk_file_name)) == NULL ) {
+        cerr << "Unable to read the Trk data log file.\n";
+        cerr.flush();
+        exit(EXIT_FAILURE);
+    }
+    block.resize(number_of_parameters, vector <double>(block_size));
+    for ( i=0; i<number_of_parameters; i++ ) {
+        columns.push_back(i);
+        block_ptrs.push_back(&block[i][0]);
+    }
+
     string ascii_title("Results");
     if (ascii_file_name != NULL) {
         ascii_title = ascii_file_name;
@@ -165,34 +181,24 @@ int main(int argc, char* argv[])
             fprintf(fp,"%4s<Columns>\n", "");
             for ( i=0; i<number_of_parameters; i++ ) {
                 fprintf(fp, "%8s<Column name=\"%s\" units=\"%s\" />\n", "", param_names[i], param_units[i]);
-                if (( each_ds = new TrickBinary(trk_file_name, param_names[i] )) == NULL) {
-                    cerr << ".\n";
-                    cerr.flush();
-                    exit(EXIT_FAILURE);
-                } else {
-                    ds_list.push_back(each_ds);
-                }
             }
             fprintf(fp,"%4s</Columns>\n", "");
 
             fprintf(fp,"%4s<Data>\n", "");
-            done = 0;
-            while ( !done ) {
-                current_line.clear();
-                sprintf(buf, "%8s<Row>", "");
-                current_line.append(buf);
-                for ( idx = 0; idx < ds_list.size(); idx++ ) {
-                    if ( ds_list[idx]->get( &t, &y) == 0 ) {
-                        done = 1;
-                        break;
-                    }
-                    sprintf(buf, "<Col>%.15G</Col>", y);
+            first_record = 0;
+            while (( num_read = trk_file->get_block(first_record, block_size, columns, NULL, &block_ptrs[0])) > 0 ) {
+                for ( row = 0; row < num_read; row++ ) {
+                    current_line.clear();
+                    sprintf(buf, "%8s<Row>", "");
                     current_line.append(buf);
-                }
-                current_line.append("</Row>");
-                if ( !done ) {
+                    for ( idx = 0; idx < columns.size(); idx++ ) {
+                        sprintf(buf, "<Col>%.15G</Col>", block[idx][row]);
+                        current_line.append(buf);
+                    }
+                    current_line.append("</Row>");
                     fprintf(fp, "%s\n", current_line.c_str());
                 }
+                first_record += num_read;
             }
             fprintf(fp,"%4s</Data>\n", "");
             fprintf(fp,"</DataTable>\n");
@@ -207,51 +213,33 @@ int main(int argc, char* argv[])
                 } else {
                     fprintf(fp,"%s%s {%s}", delimiter.c_str(), param_names[i], param_units[i]);
                 }
-
-                if (( each_ds = new TrickBinary(trk_file_name, param_names[i] )) == NULL) {
-                    cerr << ".\n";
-                    cerr.flush();
-                    exit(EXIT_FAILURE);
-                } else {
-                    ds_list.push_back(each_ds);
-                }
             }
 
             fprintf(fp,"\n");
 
-            done = 0;
-            while ( !done ) {
-                current_line.clear();
-                for ( idx = 0; idx < ds_list.size(); idx++ ) {
-                    if ( ds_list[idx]->get( &t, &y) == 0 ) {
-                        done = 1;
-                        break;
-                    }
-                    if ( idx != 0) {
-                        sprintf(buf, "%s", delimiter.c_str());
+            first_record = 0;
+            while (( num_read = trk_file->get_block(first_record, block_size, columns, NULL, &block_ptrs[0])) > 0 ) {
+                for ( row = 0; row < num_read; row++ ) {
+                    current_line.clear();
+                    for ( idx = 0; idx < columns.size(); idx++ ) {
+                        if ( idx != 0) {
+                            current_line.append(delimiter);
+                        }
+                        if ( Format == FIX ) {
+                            sprintf(buf, "%20.16g", block[idx][row]);
+                        } else {
+                            sprintf(buf, "%.15G", block[idx][row]);
+                        }
                         current_line.append(buf);
                     }
-                    if ( Format == FIX ) {
-                        sprintf(buf, "%20.16g", y);
-                        current_line.append(buf);
-                    } else {
-                        sprintf(buf, "%.15G", y);
-                        current_line.append(buf);
-                    }
-                }
-                if ( !done ) {
                     fprintf(fp, "%s\n", current_line.c_str());
                 }
+                first_record += num_read;
             }
             break;
     }
 
-    // release memory for the DataStream list
-    // vector clear function won't delete objects created by new
-    for ( idx = 0; idx < ds_list.size(); idx++) {
-        delete ds_list[idx];
-    }
-    ds_list.clear();
+    TrickBinaryFile::release(trk_file);
 
     // relese memory for the name list
     for (i = 0; i < number_of_parameters; i ++) {
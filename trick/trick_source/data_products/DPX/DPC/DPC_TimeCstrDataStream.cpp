@@ -22,6 +22,7 @@ DPC_TimeCstrDataStream::DPC_TimeCstrDataStream(DataStream* in_ds,
   this->period = time_constraints->getPeriod();
 
   this->ds = in_ds;
+  this->ds->setTimeWindow(this->tstart, this->tstop);
   this->bix = 0;
   this->eos[0] = 0;
   this->eos[1] = 0;
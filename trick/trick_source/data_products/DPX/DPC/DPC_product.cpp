@@ -1,6 +1,7 @@
 
 #include "DPC/DPC_product.hh"
 #include "DPM/DPM_parse_tree.hh"
+#include "../../Log/TrickBinaryFile.hh"
 
 #include <libxml/parser.h>
 #include <libxml/tree.h>
@@ -9,6 +10,46 @@
 #include <unistd.h> // for link()
 #include <stdlib.h> // for getenv()
 #include <string.h> // for strlen()
+#include <set>
+
+// Adds the names of the variables of the pages, the tables, or both of a
+// product, including the inputs of its external functions, to names.
+static void add_var_names( DPM_product *product_spec,
+                           bool pages,
+                           bool tables,
+                           std::set<std::string> &names ) {
+
+    const char *name;
+    int pagix, relix, curvix, caseix, tabix, colix, fnix, inix;
+
+    for (pagix = 0 ; pages && pagix < product_spec->NumberOfPages() ; pagix++ ) {
+        DPM_page *page_spec = product_spec->getPage(pagix);
+        for (relix = 0 ; relix < page_spec->NumberOfRelations() ; relix++ ) {
+            DPM_relation *relation_spec = page_spec->getRelation(relix);
+            for (curvix = 0 ; curvix < relation_spec->NumberOfCurves() ; curvix++ ) {
+                DPM_curve *curve_spec = relation_spec->getCurve(curvix);
+                for (caseix = 0 ; caseix < curve_spec->NumberOfVarCases() ; caseix++ ) {
+                    if ((name = curve_spec->getXVarName(caseix)) != NULL) names.insert(name);
+                    if ((name = curve_spec->getYVarName(caseix)) != NULL) names.insert(name);
+                    if ((name = curve_spec->getZVarName(caseix)) != NULL) names.insert(name);
+                }
+            }
+        }
+    }
+    for (tabix = 0 ; tables && tabix < product_spec->NumberOfTables() ; tabix++ ) {
+        DPM_table *table_spec = product_spec->getTable(tabix);
+        for (colix = 0 ; colix < table_spec->NumberOfColumns() ; colix++ ) {
+            DPM_var *var = table_spec->getColumn(colix)->getVar();
+            if ((var != NULL) && ((name = var->getName()) != NULL)) names.insert(name);
+        }
+    }
+    for (fnix = 0 ; fnix < product_spec->NumberOfExtFns() ; fnix++ ) {
+        DPM_extfn *extfn_spec = product_spec->getExtFn(fnix);
+        for (inix = 0 ; inix < extfn_spec->NumberOfInputs() ; inix++ ) {
+            if ((name = extfn_spec->getInputVar(inix)) != NULL) names.insert(name);
+        }
+    }
+}
 
 DPC_product::DPC_product( DPM_session          *Session,
                           const char           *ProductFileName
@@ -24,6 +65,9 @@ DPC_product::DPC_product( DPM_session          *Session,
     xmlNode *root_node;
 
     int n_pages, n_tables, pagix, tabix, runix, n_runs;
+    std::vector<std::string> run_dirs;
+    std::set<std::string> var_names;
+    std::vector<TrickBinaryFile *> preloaded_files;
 
     // ###############################################################
     // Validate arguements.
@@ -61,8 +105,30 @@ DPC_product::DPC_product( DPM_session          *Session,
     total_time_constraints = *my_time_constraints + *parentTimeConstraints;
 
     const char* session_mode = Session->AttributeValue("mode");
+    bool make_pages  = (session_mode == NULL) || (strcasecmp( session_mode, "plot") == 0);
+    bool make_tables = (session_mode == NULL) || (strcasecmp( session_mode, "table") == 0);
 
-    if ((session_mode == NULL) || (strcasecmp( session_mode, "plot") == 0)) {
+    // ###############################################################
+    // Load the log files of all of the RUNs in parallel. Only the
+    // files that log the product's variables are loaded, and only
+    // within its time window: the session's for pages, which narrow
+    // it themselves, and the product's for tables. The curves and
+    // tables created below share the loaded files.
+    // ###############################################################
+    add_var_names( product_spec, make_pages, make_tables, var_names);
+    if (!var_names.empty()) {
+        DPM_time_constraints *window = &total_time_constraints;
+        if (make_pages && (product_spec->NumberOfPages() > 0)) {
+            window = parentTimeConstraints;
+        }
+        n_runs = (int)Session->run_list.size();
+        for (runix = 0 ; runix < n_runs ; runix++ ) {
+            run_dirs.push_back( Session->run_list[runix]->getDir());
+        }
+        TrickBinaryFile::preload( run_dirs, var_names, window->getStart(), window->getStop(), preloaded_files);
+    }
+
+    if (make_pages) {
 
         // ###############################################################
         // Create subordinate pages.
@@ -88,7 +154,7 @@ DPC_product::DPC_product( DPM_session          *Session,
         }
     }
 
-    if ((session_mode == NULL) || (strcasecmp( session_mode, "table") == 0)) {
+    if (make_tables) {
 
         // ###############################################################
         // Create subordinate tables.
@@ -117,6 +183,9 @@ DPC_product::DPC_product( DPM_session          *Session,
         }
     }
 
+    for (unsigned int ii = 0 ; ii < preloaded_files.size() ; ii++ ) {
+        TrickBinaryFile::release( preloaded_files[ii]);
+    }
 }
 // DESTRUCTOR
 DPC_product::~DPC_product() {
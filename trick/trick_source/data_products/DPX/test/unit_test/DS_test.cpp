@@ -1,8 +1,13 @@
 #define protected public
 
 #include <iostream>
+#include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <vector>
 #include "Log/DataStream.hh"
+#include "Log/TrickBinaryFile.hh"
+#include "trick/parameter_types.h"
 #include "Log/DataStreamFactory.hh"
 #include "DPC/DPC_UnitConvDataStream.hh"
 #include "DPC/DPC_TimeCstrDataStream.hh"
@@ -254,6 +259,161 @@ TEST_F(DSTest, DataStream_Binary) {
 		"get : time = 3     value= -36.7438     return = 1", output.c_str());
     EXPECT_EQ(result, 0);
 
+	// TIME WINDOW
+	// The time index holds blocks of 256 records.  The block holding time 700 starts at time 512.
+	testds->setTimeWindow(700.0, 800.0);
+	output = run('b');
+	output = run('g');
+	result = strcmp_IgnoreWhiteSpace(
+		"get : time = 512     value= -36.9078     return = 1", output.c_str());
+	EXPECT_EQ(result, 0);
+
+	// END
+	output = run('e');
+	result = strcmp_IgnoreWhiteSpace("end : return = 0", output.c_str());
+	EXPECT_EQ(result, 0);
+
+	delete data_stream_factory;
+}
+
+// TRICK BINARY FILE
+TEST_F(DSTest, TrickBinaryFile_Shared) {
+
+	const char* file_name = "../TEST_DATA/RUN_BINARY/log_helios.trk";
+
+	// Every open of a file shares one mapping.
+	TrickBinaryFile* file = TrickBinaryFile::open(file_name);
+	ASSERT_TRUE(file != NULL);
+	TrickBinaryFile* again = TrickBinaryFile::open(file_name);
+	EXPECT_EQ(file, again);
+	TrickBinaryFile::release(again);
+
+	int time_column = file->locate("sys.exec.out.time");
+	int elevation_column = file->locate("sun_predictor.sun.solar_elevation");
+	EXPECT_EQ(time_column, 0);
+	ASSERT_GT(elevation_column, 0);
+	EXPECT_EQ(file->locate("sun_predictor.sun.no_such_thing"), -1);
+	EXPECT_STREQ(file->getTimeUnits().c_str(), "s");
+	size_t num_records = file->getNumRecords();
+	ASSERT_GT(num_records, 4u);
+
+	// GET BLOCK
+	std::vector<int> columns(1, elevation_column);
+	double time[4];
+	double elevation[4];
+	double* values[1] = { elevation };
+	EXPECT_EQ(file->get_block(0, 4, columns, time, values), 4u);
+	const double expected[4] = { -36.7426, -36.743, -36.7434, -36.7438 };
+	for (int ii = 0; ii < 4; ii++) {
+		EXPECT_EQ(time[ii], (double)ii);
+		EXPECT_NEAR(elevation[ii], expected[ii], 1.0e-4);
+		EXPECT_EQ(elevation[ii], file->getValue(ii, elevation_column));
+	}
+
+	// A block is cut short at the end of the file.
+	EXPECT_EQ(file->get_block(num_records - 2, 4, columns, time, NULL), 2u);
+	EXPECT_EQ(time[1], file->getTime(num_records - 1));
+	EXPECT_EQ(file->get_block(num_records, 4, columns, time, values), 0u);
+
+	TrickBinaryFile::release(file);
+}
+
+TEST_F(DSTest, TrickBinaryFile_BadHeader) {
+
+	const char* file_name = "bad_header.trk";
+	const char magic[10] = { 'T', 'r', 'i', 'c', 'k', '-', '1', '0', '-', 'L' };
+	int header[6][5] = {
+		{ 1, 0, 0, TRICK_DOUBLE, 8 },           // one double without a name
+		{ 2000000000, 0, 0, TRICK_DOUBLE, 8 },  // more parameters than the file can hold
+		{ -1, 0, 0, TRICK_DOUBLE, 8 },          // negative parameter count
+		{ 1, -100, 0, TRICK_DOUBLE, 8 },        // negative name length
+		{ 1, 0, 100, TRICK_DOUBLE, 8 },         // units longer than the file
+		{ 1, 0, 0, TRICK_DOUBLE, -8 } } ;       // negative parameter size
+
+	for (int ii = 0; ii < 6; ii++) {
+		FILE* fp = fopen(file_name, "w");
+		ASSERT_TRUE(fp != NULL);
+		fwrite(magic, sizeof(magic), 1, fp);
+		fwrite(header[ii], sizeof(header[ii]), 1, fp);
+		fclose(fp);
+		TrickBinaryFile* file = TrickBinaryFile::open(file_name);
+		EXPECT_EQ(file != NULL, ii == 0) << "header " << ii;
+		TrickBinaryFile::release(file);
+	}
+	unlink(file_name);
+}
+
+// TRICK COLUMNAR DATASTREAM
+TEST_F(DSTest, DataStream_Columnar) {
+
+	RUN_dir = "../TEST_DATA/RUN_COLUMNAR";
+    VarName = "sun_predictor.sun.solar_elevation";
+
+    data_stream_factory = new DataStreamFactory();
+    testds = data_stream_factory->create(RUN_dir, VarName, NULL);
+
+    // GET FILE NAME
+    output = run('f');
+    result = strcmp_IgnoreWhiteSpace(
+    	"getFileName : filename = \"../TEST_DATA/RUN_COLUMNAR/log_helios.trkc\"", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	// GET UNIT
+    output = run('u');
+    result = strcmp_IgnoreWhiteSpace("getUnit : unitspec = \"degree\"", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	// GET TIME UNIT
+    output = run('t');
+    result = strcmp_IgnoreWhiteSpace("getTimeUnit : timeunitspec = \"s\"", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	// GET
+    output = run('g');
+    result = strcmp_IgnoreWhiteSpace(
+		"get : time = 0     value = -36.7426     return = 1", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	output = run('g');
+    result = strcmp_IgnoreWhiteSpace(
+		"get : time = 1     value = -36.743     return = 1", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	// PEEK
+    output = run('p');
+    result = strcmp_IgnoreWhiteSpace(
+		"peek : time = 2     value= -36.7434     return = 1", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	output = run('p');
+    result = strcmp_IgnoreWhiteSpace(
+		"peek : time = 2     value= -36.7434     return = 1", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	// BEGIN
+    output = run('b');
+    output = run('g');
+    result = strcmp_IgnoreWhiteSpace(
+		"get : time = 0     value = -36.7426      return = 1", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	// STEP
+    output = run('s');
+    output = run('s');
+    output = run('g');
+    result = strcmp_IgnoreWhiteSpace(
+		"get : time = 3     value= -36.7438     return = 1", output.c_str());
+    EXPECT_EQ(result, 0);
+
+	// TIME WINDOW
+	// Chunks hold 256 records.  The chunk holding time 700 starts at time 512.
+	testds->setTimeWindow(700.0, 800.0);
+	output = run('b');
+	output = run('g');
+	result = strcmp_IgnoreWhiteSpace(
+		"get : time = 512     value= -36.9078     return = 1", output.c_str());
+	EXPECT_EQ(result, 0);
+
 	// END
 	output = run('e');
 	result = strcmp_IgnoreWhiteSpace("end : return = 0", output.c_str());
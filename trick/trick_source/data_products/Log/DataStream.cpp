@@ -25,6 +25,10 @@ int DataStream::getValueAtTime(double time , double * value ) {
 
 }
 
+void DataStream::setTimeWindow(double , double ) {
+        // Nada
+}
+
 string DataStream::getFileName() {
         return(fileName_) ;
 }
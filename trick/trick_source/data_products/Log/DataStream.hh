@@ -21,6 +21,11 @@ class DataStream {
                virtual string getUnit() ;
                virtual string getTimeUnit() ;
 
+               // Limits the stream to records between start and stop.  Streams that can skip
+               // whole blocks of records outside of the window override this.  Records outside
+               // of the window may still be returned.
+               virtual void setTimeWindow(double start , double stop ) ;
+
                virtual void begin() = 0 ;
                virtual int end() = 0 ;
                virtual int step() = 0 ;
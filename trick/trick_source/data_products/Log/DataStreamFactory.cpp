@@ -91,6 +91,23 @@ DataStream* DataStreamFactory::create( const char* iRunDir,
         }
     }
 
+    // Trick columnar binary
+    rewinddir(dirp) ;
+    while ((dp = readdir(dirp)) != NULL) {
+        len = strlen(dp->d_name);
+        if ( len > 5 && !strcmp( &(dp->d_name[len - 5]) , ".trkc")) {
+        	full_path = (char*) malloc (runDir.length() + strlen(dp->d_name) + 2) ;
+            sprintf(full_path, "%s/%s", runDir.c_str(), dp->d_name);
+            if ( TrickColumnarLocateParam((const char*)full_path , paramName.c_str()) ) {
+            	closedir(dirp) ;
+                stream = new TrickColumnar(full_path , (char *)paramName.c_str()) ;
+                free( full_path ) ;
+                return(stream) ;
+            }
+            free( full_path ) ;
+        }
+    }
+
     // CSV Files
     rewinddir(dirp) ;
     while ((dp = readdir(dirp)) != NULL) {
@@ -185,5 +202,14 @@ int getVariableNames( const char* pathToData,
         return 1 ;
 }
 
+    if ( len > 5 && !strcmp( &pathToData[len - 5] , ".trkc" )) {
+    	*numVariables  = TrickColumnarGetNumVariables(pathToData) ;
+        if ( *numVariables == 0 ) {
+        	return 0 ;
+        }
+        *variableNames = TrickColumnarGetVariableNames(pathToData) ;
+        return 1 ;
+    }
+
     return(0);
 }
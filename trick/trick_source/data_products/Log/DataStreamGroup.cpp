@@ -12,6 +12,7 @@ DataStreamGroup::DataStreamGroup()
         frequencyMultiple_ = 0.0 ;
         isEOF_ = 0 ;
         timeMatchTolerance_ = 1.0e-9 ;
+        currTimeValid_ = 0 ;
 }
 
 DataStreamGroup::~DataStreamGroup() {
@@ -36,13 +37,19 @@ void DataStreamGroup::setStopTime( double time ) {
 
 void DataStreamGroup::add( DataStream* ds ) {
 
+        index_[ds] = dataStreams_.size() ;
         dataStreams_.push_back(ds) ;
         currTime_.push_back(0.0);
+        lastRead_.push_back(LastRead()) ;
+        currTimeValid_ = 0 ;
 }
 
 void DataStreamGroup::clear()
 {
         dataStreams_.clear() ;
+        currTime_.clear() ;
+        lastRead_.clear() ;
+        index_.clear() ;
 }
 
 void DataStreamGroup::setPreserveTimeOn() {
@@ -63,6 +70,7 @@ void DataStreamGroup::begin()
         for ( ii = 0; ii < dataStreams_.size(); ii++ ) {
                 dataStreams_[ii]->begin();
         }
+        currTimeValid_ = 0 ;
 
         // Reset frequency
         if ( frequency_ == 0.0 ) {
@@ -89,9 +97,7 @@ void DataStreamGroup::begin()
 
         // Grab data from each stream without stepping
         for ( ii = 0; ii < dataStreams_.size(); ii++ ) {
-                dataStreams_[ii]->peek(&lastRead_[dataStreams_[ii]].time,
-                                       &lastRead_[dataStreams_[ii]].value);
-
+                dataStreams_[ii]->peek(&lastRead_[ii].time, &lastRead_[ii].value);
         }
 }
 
@@ -140,23 +146,38 @@ void DataStreamGroup::step() {
 // data points if the time stamps do not match
 double DataStreamGroup::getTime( ) {
 
-        double minTime = DBL_MAX;
-        double time, val ;
         unsigned int ii ;
 
         for ( ii = 0 ; ii < dataStreams_.size() ; ii++ ) {
+                peekTime_(ii) ;
+        }
+        currTimeValid_ = 1 ;
+        return( minTime_() ) ;
+}
 
-                if ( ! dataStreams_[ii]->end() ) {
-                        dataStreams_[ii]->peek(&time, &val) ;
-                        currTime_[ii] = time ;
-                } else {
-                        currTime_[ii] = DBL_MAX ;
-                }
+// Updates the time of the next record of one stream
+void DataStreamGroup::peekTime_( unsigned int ii ) {
+
+        double time, val ;
 
+        if ( ! dataStreams_[ii]->end() ) {
+                dataStreams_[ii]->peek(&time, &val) ;
+                currTime_[ii] = time ;
+        } else {
+                currTime_[ii] = DBL_MAX ;
+        }
+}
+
+// Minimum of the next time stamps already peeked
+double DataStreamGroup::minTime_( ) {
+
+        double minTime = DBL_MAX;
+        unsigned int ii ;
+
+        for ( ii = 0 ; ii < currTime_.size() ; ii++ ) {
                 if (currTime_[ii] < minTime) {
                         minTime = currTime_[ii];
                 }
-
         }
         return( minTime ) ;
 }
@@ -199,21 +220,26 @@ int DataStreamGroup::stepInTime_() {
 
         double t, x ;
 
-        // Get all values in all data log groups
-        // Also get mininum time stamp from all log data files
-        minTime = getTime();
+        // Get mininum time stamp from all log data files.
+        // Only the streams read since the last step are peeked again.
+        if ( currTimeValid_ ) {
+                minTime = minTime_();
+        } else {
+                minTime = getTime();
+        }
 
         // Take a step through time (sounds like a song)
         for ( ii = 0 ; ii < dataStreams_.size() ; ii++ ) {
-                if ( currTime_[ii] == minTime && !dataStreams_[ii]->end() ) {
+                if ( currTime_[ii] == minTime && currTime_[ii] != DBL_MAX ) {
                         dataStreams_[ii]->get(&t, &x);
+                        peekTime_(ii) ;
                 }
         }
 
         // Check for end of file
         isEOF = 1 ;
         for ( ii = 0 ; ii < dataStreams_.size() ; ii++ ) {
-                if ( ! dataStreams_[ii]->end() ) {
+                if ( currTime_[ii] != DBL_MAX ) {
                         isEOF = 0 ;
                         break ;
                 }
@@ -224,9 +250,8 @@ int DataStreamGroup::stepInTime_() {
         }
 
         // Now that a time step has occured
-        // Get the new mininum time stamp and associated
-        // values from all log data files
-        minTime = getTime();
+        // Get the new mininum time stamp
+        minTime = minTime_();
 
 
         // Step depending on frequency
@@ -292,6 +317,9 @@ int DataStreamGroup::matchTimeStamps() {
         int frequency_match ;
         double maxTime ;
 
+        // The streams are read here without peeking, getTime() peeks them again
+        currTimeValid_ = 0 ;
+
         frequency_match = 0 ;
         while ( !frequency_match ) {
 
@@ -301,13 +329,13 @@ int DataStreamGroup::matchTimeStamps() {
 
                         // get the next record out of the file and find the maximum time stamp
                         for ( ii = 0 ; ii < dataStreams_.size() ; ii++ ) {
-                                if ( ! dataStreams_[ii]->get(&lastRead_[dataStreams_[ii]].time,
-                                        &lastRead_[dataStreams_[ii]].value) ) {
+                                LastRead & last = lastRead_[ii] ;
+                                if ( ! dataStreams_[ii]->get(&last.time, &last.value) ) {
                                         isEOF_ = 1 ;
                                         return(0) ;
                                 }
-                                if (lastRead_[dataStreams_[ii]].time > maxTime ) {
-                                        maxTime = lastRead_[dataStreams_[ii]].time ;
+                                if (last.time > maxTime ) {
+                                        maxTime = last.time ;
                                 }
                         }
 
@@ -319,10 +347,9 @@ int DataStreamGroup::matchTimeStamps() {
 
                         // keep getting records from the all streams until we past the largest time step
                         for ( ii = 0 ; ii < dataStreams_.size() ; ii++ ) {
-                                while ( maxTime -
-                                        lastRead_[dataStreams_[ii]].time > timeMatchTolerance_ ) {
-                                        if ( ! dataStreams_[ii]->get(&lastRead_[dataStreams_[ii]].time,
-                                                &lastRead_[dataStreams_[ii]].value)) {
+                                LastRead & last = lastRead_[ii] ;
+                                while ( maxTime - last.time > timeMatchTolerance_ ) {
+                                        if ( ! dataStreams_[ii]->get(&last.time, &last.value)) {
                                                 isEOF_ = 1 ;
                                                 return(0) ;
                                         }
@@ -333,7 +360,7 @@ int DataStreamGroup::matchTimeStamps() {
                         // check to see if all the time stamps match or not
                         matched_time_stamps = 1 ;
                         for ( ii = 0 ; ii < dataStreams_.size() ; ii++ ) {
-                                if ( DPLOG_ABS(lastRead_[dataStreams_[ii]].time - maxTime) > timeMatchTolerance_ ) {
+                                if ( DPLOG_ABS(lastRead_[ii].time - maxTime) > timeMatchTolerance_ ) {
                                         matched_time_stamps = 0 ;
                                         break ;
                                 }
@@ -360,8 +387,13 @@ int DataStreamGroup::matchTimeStamps() {
 
 int DataStreamGroup::getLastRead( DataStream *ds , double *time , double *value) {
 
-        *time = lastRead_[ds].time ;
-        *value = lastRead_[ds].value ;
+        map < DataStream * , unsigned int >::iterator it = index_.find(ds) ;
+
+        if ( it == index_.end() ) {
+                return (0) ;
+        }
+        *time = lastRead_[it->second].time ;
+        *value = lastRead_[it->second].value ;
         return (1) ;
 }
 
@@ -43,8 +43,10 @@ class DataStreamGroup {
         } ;
 
         vector < DataStream* >dataStreams_;
-        vector < double > currTime_ ;
-        map    < DataStream * , struct LastRead > lastRead_ ;
+        vector < double > currTime_ ;   // Time of the next record of each stream, DBL_MAX at the end
+        bool currTimeValid_ ;           // False when the streams were read without updating currTime_
+        vector < struct LastRead > lastRead_ ;          // Parallel to dataStreams_
+        map    < DataStream * , unsigned int > index_ ;  // Index of each stream in dataStreams_
 
         bool preserveTime_ ;    // While iterating, step() insures all time
                                 // stamps are same.  step() will skip points
@@ -60,6 +62,8 @@ class DataStreamGroup {
                                           // assume they are equivalent
 
         int stepInTime_();
+        void peekTime_(unsigned int ii);
+        double minTime_();
 
         bool isEOF_ ;
 
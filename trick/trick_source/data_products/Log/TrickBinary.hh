@@ -4,7 +4,12 @@
 
 #include <stdio.h>
 #include "DataStream.hh"
+#include "TrickBinaryFile.hh"
 
+/*
+ * Reads one variable from a Trick binary log file (.trk).  The file is shared with the other TrickBinary
+ * streams of the same file, see TrickBinaryFile.
+ */
 class TrickBinary : public DataStream {
 
        public:
@@ -18,18 +23,17 @@ class TrickBinary : public DataStream {
                int end() ;
                int step() ;
 
+               void setTimeWindow( double start , double stop ) ;
+
        private:
-               FILE *fp_ ;
-               int swap_ ;
-               int time_size_ ;
-               int num_params_ ;
-               int record_offset_ ;
-               int record_size_ ;
-               char * record_ ;
-               int type_ ;
-               int size_ ;
-
-               int data_offset_ ;
+               int seekRecord() ;
+
+               TrickBinaryFile * file_ ;
+               int column_ ;
+               size_t record_ ;         // index of the next record
+               bool windowed_ ;
+               double window_start_ ;
+               double window_stop_ ;
 
 } ;
 
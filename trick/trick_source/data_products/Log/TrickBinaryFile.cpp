@@ -0,0 +1,487 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include "TrickBinaryFile.hh"
+#include "trick/parameter_types.h"
+#include "trick_byte_order.h"
+#include "trick_byteswap.h"
+#include "trick/units_conv.h"
+
+std::map< std::string , TrickBinaryFile * > TrickBinaryFile::open_files_ ;
+pthread_mutex_t TrickBinaryFile::open_files_mutex_ = PTHREAD_MUTEX_INITIALIZER ;
+
+namespace {
+
+// Maps Trick-05 and Trick-07 parameter types to Trick-10 types.
+// 18 = TRICK_COMPLX , 19 = TRICK_DBL_COMPLX , 20 = TRICK_REF. These don't exist in 10
+int sevenToTenType( int type ) {
+        switch ( type ) {
+                case 0: return TRICK_CHARACTER ;
+                case 1: return TRICK_UNSIGNED_CHARACTER ;
+                case 2: return TRICK_STRING ;
+                case 3: return TRICK_SHORT ;
+                case 4: return TRICK_UNSIGNED_SHORT ;
+                case 5: return TRICK_INTEGER ;
+                case 6: return TRICK_UNSIGNED_INTEGER ;
+                case 7: return TRICK_LONG ;
+                case 8: return TRICK_UNSIGNED_LONG ;
+                case 9: return TRICK_FLOAT ;
+                case 10: return TRICK_DOUBLE ;
+                case 11: return TRICK_BITFIELD ;
+                case 12: return TRICK_UNSIGNED_BITFIELD ;
+                case 13: return TRICK_LONG_LONG ;
+                case 14: return TRICK_UNSIGNED_LONG_LONG ;
+                case 15: return TRICK_FILE_PTR ;
+                case 16: return TRICK_VOID ;
+                case 17: return TRICK_BOOLEAN ;
+                case 21: return TRICK_WCHAR ;
+                case 22: return TRICK_WSTRING ;
+                case 99: return TRICK_VOID_PTR ;
+                case 102: return TRICK_ENUMERATED ;
+                case 103: return TRICK_STRUCTURED ;
+        }
+        return TRICK_VOID ;
+}
+
+// Reads an int of the header.  Returns 0 past the end of the file.
+int readHeaderInt( const char * map , size_t map_size , size_t * offset , int swap , int * value ) {
+        if ( *offset + 4 > map_size ) {
+                return 0 ;
+        }
+        memcpy(value , map + *offset , 4) ;
+        *offset += 4 ;
+        if ( swap ) { *value = trick_byteswap_int(*value) ; }
+        return 1 ;
+}
+
+int readHeaderString( const char * map , size_t map_size , size_t * offset , int swap , std::string & value ) {
+        int len ;
+        if ( ! readHeaderInt(map , map_size , offset , swap , &len) or len < 0 or map_size - *offset < (size_t)len ) {
+                return 0 ;
+        }
+        value.assign(map + *offset , len) ;
+        *offset += len ;
+        return 1 ;
+}
+
+}
+
+TrickBinaryFile * TrickBinaryFile::open( const char * file_name ) {
+
+        TrickBinaryFile * file ;
+
+        pthread_mutex_lock(&open_files_mutex_) ;
+        std::map< std::string , TrickBinaryFile * >::iterator it = open_files_.find(file_name) ;
+        if ( it != open_files_.end() ) {
+                file = it->second ;
+                file->ref_count_++ ;
+        } else {
+                file = new TrickBinaryFile(file_name) ;
+                if ( file->readHeader() ) {
+                        open_files_[file_name] = file ;
+                } else {
+                        delete file ;
+                        file = 0 ;
+                }
+        }
+        pthread_mutex_unlock(&open_files_mutex_) ;
+        return file ;
+}
+
+void TrickBinaryFile::release( TrickBinaryFile * file ) {
+        if ( file ) {
+                pthread_mutex_lock(&open_files_mutex_) ;
+                if ( --file->ref_count_ == 0 ) {
+                        open_files_.erase(file->file_name_) ;
+                        delete file ;
+                }
+                pthread_mutex_unlock(&open_files_mutex_) ;
+        }
+}
+
+TrickBinaryFile::TrickBinaryFile( const std::string & file_name ) :
+ file_name_(file_name) , ref_count_(1) , map_(0) , map_size_(0) , swap_(0) , time_column_(-1) ,
+ data_offset_(0) , record_size_(0) , num_records_(0) , file_size_(0) , file_mtime_(0) , index_built_(false) {
+        pthread_mutex_init(&index_mutex_ , 0) ;
+}
+
+TrickBinaryFile::~TrickBinaryFile() {
+        if ( map_ ) {
+                munmap(map_ , map_size_) ;
+        }
+        pthread_mutex_destroy(&index_mutex_) ;
+}
+
+/*
+ * Maps the file and reads the parameter list.  Returns 0 if this is not a Trick binary log file.
+ */
+int TrickBinaryFile::readHeader() {
+
+        const size_t file_type_len = 10 ;
+        int fd ;
+        struct stat st ;
+        void * map ;
+        int my_byte_order ;
+        int num_params ;
+        size_t offset ;
+
+        if ((fd = ::open(file_name_.c_str() , O_RDONLY)) < 0 ) {
+                std::cerr << "ERROR:  Couldn't open \"" << file_name_ << "\": " << std::strerror(errno) << std::endl;
+                return 0 ;
+        }
+        if ( fstat(fd , &st) != 0 or (size_t)st.st_size < file_type_len ) {
+                close(fd) ;
+                return 0 ;
+        }
+        map = mmap(0 , st.st_size , PROT_READ , MAP_PRIVATE , fd , 0) ;
+        close(fd) ;
+        if ( map == MAP_FAILED ) {
+                std::cerr << "ERROR:  Couldn't map \"" << file_name_ << "\": " << std::strerror(errno) << std::endl;
+                return 0 ;
+        }
+        map_ = (char *)map ;
+        map_size_ = st.st_size ;
+        file_size_ = st.st_size ;
+        file_mtime_ = st.st_mtime ;
+        // The records are read in order.
+        madvise(map_ , map_size_ , MADV_SEQUENTIAL) ;
+
+        std::string file_type(map_ , file_type_len) ;
+        if ( file_type.compare(0 , 8 , "Trick-05") and file_type.compare(0 , 8 , "Trick-07") and
+             file_type.compare(0 , 8 , "Trick-10") ) {
+                return 0 ;
+        }
+        bool is_05 = ! file_type.compare(0 , 8 , "Trick-05") ;
+        bool is_10 = ! file_type.compare(0 , 8 , "Trick-10") ;
+
+        TRICK_GET_BYTE_ORDER(my_byte_order) ;
+        switch ( file_type[file_type_len - 1] ) {
+            case 'L':
+                    swap_ = ( my_byte_order == TRICK_LITTLE_ENDIAN ) ? 0 : 1 ;
+                    break ;
+            case 'B':
+                    swap_ = ( my_byte_order == TRICK_BIG_ENDIAN ) ? 0 : 1 ;
+                    break ;
+        }
+
+        offset = file_type_len ;
+        // Every parameter takes at least two lengths, a type and a size.
+        if ( ! readHeaderInt(map_ , map_size_ , &offset , swap_ , &num_params) or num_params < 0 or
+             (size_t)num_params > (map_size_ - offset) / 16 ) {
+                return 0 ;
+        }
+
+        params_.resize(num_params) ;
+        for ( int ii = 0 ; ii < num_params ; ii++ ) {
+                Param & param = params_[ii] ;
+
+                if ( ! readHeaderString(map_ , map_size_ , &offset , swap_ , param.name) or
+                     ! readHeaderString(map_ , map_size_ , &offset , swap_ , param.units) or
+                     ! readHeaderInt(map_ , map_size_ , &offset , swap_ , &param.type) or
+                     ! readHeaderInt(map_ , map_size_ , &offset , swap_ , &param.size) or param.size < 0 ) {
+                        return 0 ;
+                }
+
+                // If this is an 05 log file, we need to convert the units to 07 units
+                // ( where explicit asterisk for multiplication is required. )
+                if ( is_05 ) {
+                        char new_units_spec[100];
+                        new_units_spec[0] = 0;
+                        if ( convert_units_spec ((char *)param.units.c_str(), new_units_spec) != 0 ) {
+                                printf (" ERROR: Attempt to convert Trick-05 units spec \"%s\" failed.\n\n",param.units.c_str());
+                        }
+                        param.units = new_units_spec ;
+                }
+
+                // adjust the recorded types for 05 & 07 because they are 1 less than Trick10 types (because of Penn!)
+                if ( ! is_10 ) {
+                        param.type = sevenToTenType(param.type) ;
+                }
+
+                // correct the "type" according to the size recorded
+                switch ( param.type ) {
+                    case TRICK_LONG:
+                        if ( param.size == 4 ) {
+                                param.type = TRICK_INTEGER ;
+                        } else if ( param.size == 8 ) {
+                                param.type = TRICK_LONG_LONG ;
+                        }
+                        break ;
+                    case TRICK_UNSIGNED_LONG:
+                        if ( param.size == 4 ) {
+                                param.type = TRICK_UNSIGNED_INTEGER ;
+                        } else if ( param.size == 8 ) {
+                                param.type = TRICK_UNSIGNED_LONG_LONG ;
+                        }
+                        break ;
+                    default:
+                        break ;
+                }
+
+                if ( param.name == "sys.exec.out.time" ) {
+                        time_column_ = ii ;
+                        time_units_ = param.units ;
+                }
+
+                param.offset = record_size_ ;
+                record_size_ += param.size ;
+        }
+
+        data_offset_ = offset ;
+        num_records_ = record_size_ ? (map_size_ - data_offset_) / record_size_ : 0 ;
+        return 1 ;
+}
+
+int TrickBinaryFile::locate( const char * param_name ) const {
+        for ( unsigned int ii = 0 ; ii < params_.size() ; ii++ ) {
+                if ( params_[ii].name == param_name ) {
+                        return ii ;
+                }
+        }
+        return -1 ;
+}
+
+double TrickBinaryFile::getTime( size_t record ) const {
+
+        const char * p = map_ + data_offset_ + record * record_size_ ;
+
+        // The time is the first value of a record.
+        if ( time_column_ < 0 or params_[time_column_].size == 8 ) {
+                double time ;
+                memcpy(&time , p , sizeof(time)) ;
+                return swap_ ? trick_byteswap_double(time) : time ;
+        } else {
+                float time ;
+                memcpy(&time , p , sizeof(time)) ;
+                return swap_ ? trick_byteswap_float(time) : time ;
+        }
+}
+
+double TrickBinaryFile::getValue( size_t record , int column ) const {
+
+        const Param & param = params_[column] ;
+        const char * p = map_ + data_offset_ + record * record_size_ + param.offset ;
+        union {
+                char c[8] ;
+                signed char sc ; unsigned char uc ;
+                short s ; unsigned short us ;
+                int i ; unsigned int ui ;
+                long l ; unsigned long ul ;
+                long long ll ; unsigned long long ull ;
+                float f ; double d ;
+        } v ;
+
+        if ( param.size < 1 or param.size > 8 ) {
+                return 0.0 ;
+        }
+        memcpy(v.c , p , param.size) ;
+
+        switch ( param.type ) {
+                case TRICK_CHARACTER:
+                        return (double)(char)v.c[0] ;
+                case TRICK_UNSIGNED_CHARACTER:
+                        return (double)v.uc ;
+                case TRICK_SHORT:
+                        return (double)(swap_ ? trick_byteswap_short(v.s) : v.s) ;
+                case TRICK_UNSIGNED_SHORT:
+                        return (double)(swap_ ? (unsigned short)trick_byteswap_short(v.us) : v.us) ;
+                case TRICK_ENUMERATED:
+                case TRICK_INTEGER:
+                        return (double)(swap_ ? trick_byteswap_int(v.i) : v.i) ;
+                case TRICK_UNSIGNED_INTEGER:
+                        return (double)(swap_ ? (unsigned int)trick_byteswap_int(v.ui) : v.ui) ;
+                case TRICK_LONG:
+                        return (double)(swap_ ? trick_byteswap_long(v.l) : v.l) ;
+                case TRICK_UNSIGNED_LONG:
+                        return (double)(swap_ ? (unsigned long)trick_byteswap_long(v.ul) : v.ul) ;
+                case TRICK_FLOAT:
+                        return (double)(swap_ ? trick_byteswap_float(v.f) : v.f) ;
+                case TRICK_DOUBLE:
+                        return swap_ ? trick_byteswap_double(v.d) : v.d ;
+                case TRICK_BITFIELD:
+                        switch ( param.size ) {
+                                case 1 : return (double)(char)v.c[0] ;
+                                case 2 : return (double)(swap_ ? trick_byteswap_short(v.s) : v.s) ;
+                                case 4 : return (double)(swap_ ? trick_byteswap_int(v.i) : v.i) ;
+                        }
+                        break ;
+                case TRICK_UNSIGNED_BITFIELD:
+                        switch ( param.size ) {
+                                case 1 : return (double)v.uc ;
+                                case 2 : return (double)(swap_ ? (unsigned short)trick_byteswap_short(v.us) : v.us) ;
+                                case 4 : return (double)(swap_ ? (unsigned int)trick_byteswap_int(v.ui) : v.ui) ;
+                        }
+                        break ;
+                case TRICK_LONG_LONG:
+                        return (double)(swap_ ? trick_byteswap_long_long(v.ll) : v.ll) ;
+                case TRICK_UNSIGNED_LONG_LONG:
+                        return (double)(swap_ ? (unsigned long long)trick_byteswap_long_long(v.ull) : v.ull) ;
+                case TRICK_BOOLEAN:
+                        switch ( param.size ) {
+                                case 1 : return (double)v.uc ;
+                                case 4 : return (double)(swap_ ? trick_byteswap_int(v.i) : v.i) ;
+                        }
+                        break ;
+        }
+        return 0.0 ;
+}
+
+size_t TrickBinaryFile::get_block( size_t first , size_t num_records , const std::vector< int > & columns ,
+                                   double * time , double ** values ) const {
+
+        if ( first >= num_records_ ) {
+                return 0 ;
+        }
+        if ( num_records > num_records_ - first ) {
+                num_records = num_records_ - first ;
+        }
+
+        // Record by record, so each record is brought in from the file once for all columns.
+        for ( size_t ii = 0 ; ii < num_records ; ii++ ) {
+                if ( time ) {
+                        time[ii] = getTime(first + ii) ;
+                }
+                if ( values ) {
+                        for ( unsigned int jj = 0 ; jj < columns.size() ; jj++ ) {
+                                values[jj][ii] = getValue(first + ii , columns[jj]) ;
+                        }
+                }
+        }
+        return num_records ;
+}
+
+namespace {
+
+// The time index file starts with the magic, then the size and modification time of the log file it was built
+// from, the number of records, and the block size, followed by the min and max time of each block.
+const char time_index_magic[8] = { 'T' , 'r' , 'k' , 'T' , 'i' , 'd' , 'x' , '1' } ;
+
+struct TimeIndexHeader {
+        char magic[8] ;
+        long long file_size ;
+        long long file_mtime ;
+        long long num_records ;
+        long long block_size ;
+} ;
+
+}
+
+const std::vector< TrickBinaryFile::TimeBlock > & TrickBinaryFile::getTimeIndex() {
+
+        pthread_mutex_lock(&index_mutex_) ;
+        if ( ! index_built_ ) {
+                if ( ! readTimeIndex() ) {
+                        size_t num_blocks = (num_records_ + time_block_size - 1) / time_block_size ;
+                        time_index_.resize(num_blocks) ;
+                        for ( size_t bb = 0 ; bb < num_blocks ; bb++ ) {
+                                size_t first = bb * time_block_size ;
+                                size_t last = std::min(first + time_block_size , num_records_) ;
+                                TimeBlock & block = time_index_[bb] ;
+                                // Logs are usually in time order, but a restarted run may go back in time.
+                                block.min = block.max = getTime(first) ;
+                                for ( size_t ii = first + 1 ; ii < last ; ii++ ) {
+                                        double time = getTime(ii) ;
+                                        if ( time < block.min ) {
+                                                block.min = time ;
+                                        } else if ( time > block.max ) {
+                                                block.max = time ;
+                                        }
+                                }
+                        }
+                        writeTimeIndex() ;
+                }
+                index_built_ = true ;
+        }
+        pthread_mutex_unlock(&index_mutex_) ;
+        return time_index_ ;
+}
+
+void TrickBinaryFile::load( double start , double stop ) {
+
+        const std::vector< TimeBlock > & index = getTimeIndex() ;
+        const size_t page_size = sysconf(_SC_PAGESIZE) ;
+        volatile char sum = 0 ;
+
+        for ( size_t bb = 0 ; bb < index.size() ; bb++ ) {
+                if ( index[bb].max < start or index[bb].min > stop ) {
+                        continue ;
+                }
+                size_t first = data_offset_ + bb * time_block_size * record_size_ ;
+                size_t last = std::min(first + time_block_size * record_size_ , map_size_) ;
+                // One read per page brings the block in, the pages of the time index are already in.
+                for ( size_t offset = first - first % page_size ; offset < last ; offset += page_size ) {
+                        sum += map_[offset] ;
+                }
+        }
+}
+
+/*
+ * Reads the saved time index.  Returns 0 if there is none or it was not built from this log file.
+ */
+int TrickBinaryFile::readTimeIndex() {
+
+        TimeIndexHeader header ;
+        std::string index_name = file_name_ + ".tidx" ;
+        size_t num_blocks = (num_records_ + time_block_size - 1) / time_block_size ;
+        FILE * fp ;
+        int ret = 0 ;
+
+        if ((fp = fopen(index_name.c_str() , "r")) == 0 ) {
+                return 0 ;
+        }
+        if ( fread(&header , sizeof(header) , 1 , fp) == 1 and
+             ! memcmp(header.magic , time_index_magic , sizeof(header.magic)) and
+             header.file_size == file_size_ and header.file_mtime == file_mtime_ and
+             header.num_records == (long long)num_records_ and header.block_size == (long long)time_block_size ) {
+                time_index_.resize(num_blocks) ;
+                ret = ( num_blocks == 0 or fread(&time_index_[0] , sizeof(TimeBlock) , num_blocks , fp) == num_blocks ) ;
+        }
+        fclose(fp) ;
+        if ( ! ret ) {
+                time_index_.clear() ;
+        }
+        return ret ;
+}
+
+/*
+ * Saves the time index next to the log file.  The log directory may not be writable, in which case the index is
+ * built again next time.
+ */
+void TrickBinaryFile::writeTimeIndex() const {
+
+        TimeIndexHeader header ;
+        std::string index_name = file_name_ + ".tidx" ;
+        std::string tmp_name = index_name + ".tmp" ;
+        FILE * fp ;
+        int ok ;
+
+        memset(&header , 0 , sizeof(header)) ;
+        memcpy(header.magic , time_index_magic , sizeof(header.magic)) ;
+        header.file_size = file_size_ ;
+        header.file_mtime = file_mtime_ ;
+        header.num_records = num_records_ ;
+        header.block_size = time_block_size ;
+
+        if ((fp = fopen(tmp_name.c_str() , "w")) == 0 ) {
+                return ;
+        }
+        ok = ( fwrite(&header , sizeof(header) , 1 , fp) == 1 ) ;
+        if ( ok and ! time_index_.empty() ) {
+                ok = ( fwrite(&time_index_[0] , sizeof(TimeBlock) , time_index_.size() , fp) == time_index_.size() ) ;
+        }
+        ok = ( fclose(fp) == 0 ) and ok ;
+        // Renamed into place so a reader never sees a partial index.
+        if ( ! ok or rename(tmp_name.c_str() , index_name.c_str()) != 0 ) {
+                unlink(tmp_name.c_str()) ;
+        }
+}
@@ -0,0 +1,107 @@
+
+#ifndef TRICKBINARYFILE_HH
+#define TRICKBINARYFILE_HH
+
+#include <stddef.h>
+#include <pthread.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/*
+ * A Trick binary log file (.trk) mapped into memory.  The file is mapped once and shared by every reader of
+ * the same file name, so the DataStreams of many variables of one log read the file once.  Any number of
+ * columns can be read with get_block.
+ *
+ * The time range of every block of time_block_size records is indexed so readers of a time window can skip
+ * the blocks outside of it.  The index is built on first use and saved next to the log file (<log>.tidx).
+ */
+class TrickBinaryFile {
+
+       public:
+               struct Param {
+                       std::string name ;
+                       std::string units ;
+                       int type ;
+                       int size ;
+                       size_t offset ;          // offset of the value in a record
+               } ;
+
+               struct TimeBlock {
+                       double min ;
+                       double max ;
+               } ;
+
+               static const size_t time_block_size = 256 ;
+
+               // Returns the shared file, mapping it on first use, or 0 if it is not a Trick binary log file.
+               // Every open is paired with a release.
+               static TrickBinaryFile * open( const char * file_name ) ;
+               static void release( TrickBinaryFile * file ) ;
+
+               // Opens the Trick binary log files of every directory that log any of param_names, builds their
+               // time indexes, and reads their records between start and stop, one thread per file up to the
+               // number of processors.  The opened files are appended to files, release them when done.
+               static void preload( const std::vector< std::string > & dirs , const std::set< std::string > & param_names ,
+                                    double start , double stop , std::vector< TrickBinaryFile * > & files ) ;
+
+               // Returns the column of the parameter, or -1 if it is not logged.
+               int locate( const char * param_name ) const ;
+
+               const Param & getParam( int column ) const { return params_[column] ; }
+               int getNumParams() const { return (int)params_.size() ; }
+               size_t getNumRecords() const { return num_records_ ; }
+               const std::string & getTimeUnits() const { return time_units_ ; }
+
+               double getTime( size_t record ) const ;
+               double getValue( size_t record , int column ) const ;
+
+               // Reads up to num_records records starting at first.  The time of each record goes to time[],
+               // and the value of columns[jj] goes to values[jj][].  Either time or values may be 0.
+               // Returns the number of records read.
+               size_t get_block( size_t first , size_t num_records , const std::vector< int > & columns ,
+                                 double * time , double ** values ) const ;
+
+               // Returns the time range of each block of time_block_size records, block b holding records
+               // b * time_block_size up to (b + 1) * time_block_size.
+               const std::vector< TimeBlock > & getTimeIndex() ;
+
+               // Brings the blocks of records with times between start and stop in from the disk.
+               void load( double start , double stop ) ;
+
+       private:
+               TrickBinaryFile( const std::string & file_name ) ;
+               ~TrickBinaryFile() ;
+
+               int readHeader() ;
+               int readTimeIndex() ;
+               void writeTimeIndex() const ;
+
+               static std::map< std::string , TrickBinaryFile * > open_files_ ;
+               static pthread_mutex_t open_files_mutex_ ;
+
+               std::string file_name_ ;
+               int ref_count_ ;
+               char * map_ ;
+               size_t map_size_ ;
+               int swap_ ;
+               int time_column_ ;
+               std::string time_units_ ;
+               std::vector< Param > params_ ;
+               size_t data_offset_ ;
+               size_t record_size_ ;
+               size_t num_records_ ;
+               long long file_size_ ;
+               long long file_mtime_ ;
+
+               pthread_mutex_t index_mutex_ ;
+               bool index_built_ ;
+               std::vector< TimeBlock > time_index_ ;
+
+               // Not copyable, the file owns its mapping.
+               TrickBinaryFile( const TrickBinaryFile & ) ;
+               TrickBinaryFile & operator=( const TrickBinaryFile & ) ;
+} ;
+
+#endif
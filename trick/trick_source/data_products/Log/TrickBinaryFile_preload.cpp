@@ -0,0 +1,114 @@
+#include <dirent.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "TrickBinaryFile.hh"
+
+namespace {
+
+// The files left to open, shared by the preload threads.
+struct PreloadQueue {
+        pthread_mutex_t mutex ;
+        const std::vector< std::string > * file_names ;
+        const std::set< std::string > * param_names ;
+        double start ;
+        double stop ;
+        size_t next ;
+        std::vector< TrickBinaryFile * > files ;
+} ;
+
+// Returns true if the file logs any of the parameters.  Every file logs the time, which does not count.
+bool logs_any( const TrickBinaryFile * file , const std::set< std::string > & param_names ) {
+        for ( int ii = 0 ; ii < file->getNumParams() ; ii++ ) {
+                const std::string & name = file->getParam(ii).name ;
+                if ( name != "sys.exec.out.time" and param_names.count(name) ) {
+                        return true ;
+                }
+        }
+        return false ;
+}
+
+void * preload_files( void * arg ) {
+
+        PreloadQueue * queue = (PreloadQueue *)arg ;
+
+        while ( true ) {
+                size_t ii ;
+                pthread_mutex_lock(&queue->mutex) ;
+                ii = queue->next++ ;
+                pthread_mutex_unlock(&queue->mutex) ;
+                if ( ii >= queue->file_names->size() ) {
+                        break ;
+                }
+                TrickBinaryFile * file = TrickBinaryFile::open((*queue->file_names)[ii].c_str()) ;
+                if ( file and ! logs_any(file , *queue->param_names) ) {
+                        TrickBinaryFile::release(file) ;
+                        file = 0 ;
+                }
+                if ( file ) {
+                        file->load(queue->start , queue->stop) ;
+                }
+                queue->files[ii] = file ;
+        }
+        return 0 ;
+}
+
+}
+
+void TrickBinaryFile::preload( const std::vector< std::string > & dirs , const std::set< std::string > & param_names ,
+                               double start , double stop , std::vector< TrickBinaryFile * > & files ) {
+
+        std::vector< std::string > file_names ;
+        PreloadQueue queue ;
+        std::vector< pthread_t > threads ;
+        long num_threads ;
+
+        for ( unsigned int ii = 0 ; ii < dirs.size() ; ii++ ) {
+                DIR * dirp ;
+                struct dirent * dp ;
+                if ((dirp = opendir(dirs[ii].c_str())) == 0 ) {
+                        continue ;
+                }
+                while ((dp = readdir(dirp)) != 0 ) {
+                        size_t len = strlen(dp->d_name) ;
+                        if ( len > 4 and ! strcmp(&dp->d_name[len - 4] , ".trk") ) {
+                                file_names.push_back(dirs[ii] + "/" + dp->d_name) ;
+                        }
+                }
+                closedir(dirp) ;
+        }
+
+        pthread_mutex_init(&queue.mutex , 0) ;
+        queue.file_names = &file_names ;
+        queue.param_names = &param_names ;
+        queue.start = start ;
+        queue.stop = stop ;
+        queue.next = 0 ;
+        queue.files.resize(file_names.size() , 0) ;
+
+        num_threads = sysconf(_SC_NPROCESSORS_ONLN) ;
+        if ( num_threads < 1 ) {
+                num_threads = 1 ;
+        }
+        if ( (size_t)num_threads > file_names.size() ) {
+                num_threads = file_names.size() ;
+        }
+        for ( long ii = 0 ; ii < num_threads ; ii++ ) {
+                pthread_t thread ;
+                if ( pthread_create(&thread , 0 , preload_files , &queue) == 0 ) {
+                        threads.push_back(thread) ;
+                }
+        }
+        // Whatever is left when no thread could be started is loaded here.
+        preload_files(&queue) ;
+        for ( unsigned int ii = 0 ; ii < threads.size() ; ii++ ) {
+                pthread_join(threads[ii] , 0) ;
+        }
+        pthread_mutex_destroy(&queue.mutex) ;
+
+        for ( unsigned int ii = 0 ; ii < queue.files.size() ; ii++ ) {
+                if ( queue.files[ii] ) {
+                        files.push_back(queue.files[ii]) ;
+                }
+        }
+}
@@ -0,0 +1,456 @@
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <float.h>
+#include <stdint.h>
+#include <string>
+#include "TrickColumnar.hh"
+#include "trick/parameter_types.h"
+#include "trick/columnar_log.h"
+#include "trick_byte_order.h"
+#include "trick_byteswap.h"
+#include "trick/map_trick_units_to_udunits.hh"
+
+namespace {
+
+struct ColumnarParam {
+        std::string name ;
+        std::string units ;
+        int type ;
+        int size ;
+} ;
+
+// Maps the whole file read only.  Returns 0 if the file could not be mapped.
+char * mapColumnarFile( const char * file_name , size_t * size ) {
+
+        int fd ;
+        struct stat st ;
+        void * map ;
+
+        if ((fd = open(file_name , O_RDONLY)) < 0 ) {
+                std::cerr << "ERROR:  Couldn't open \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return 0 ;
+        }
+        if ( fstat(fd , &st) != 0 or st.st_size == 0 ) {
+                close(fd) ;
+                return 0 ;
+        }
+        map = mmap(0 , st.st_size , PROT_READ , MAP_PRIVATE , fd , 0) ;
+        close(fd) ;
+        if ( map == MAP_FAILED ) {
+                std::cerr << "ERROR:  Couldn't map \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return 0 ;
+        }
+        *size = st.st_size ;
+        return (char *)map ;
+}
+
+int32_t readInt( const char * p , int swap ) {
+        int32_t value ;
+        memcpy(&value , p , sizeof(value)) ;
+        return swap ? trick_byteswap_int(value) : value ;
+}
+
+uint64_t readUint64( const char * p , int swap ) {
+        uint64_t value ;
+        memcpy(&value , p , sizeof(value)) ;
+        return swap ? (uint64_t)trick_byteswap_long_long(value) : value ;
+}
+
+double readDouble( const char * p , int swap ) {
+        double value ;
+        memcpy(&value , p , sizeof(value)) ;
+        return swap ? trick_byteswap_double(value) : value ;
+}
+
+// Reads the header.  Returns the offset of the first chunk, or 0 if this is not a columnar log file.
+size_t readColumnarHeader( const char * map , size_t map_size , int * swap , std::vector< ColumnarParam > & params ) {
+
+        const size_t file_type_len = 10 ;
+        size_t offset ;
+        int my_byte_order ;
+        int num_params ;
+        int len ;
+        int ii ;
+
+        if ( map_size < file_type_len + 4 or strncmp(map , TRICK_COLUMNAR_MAGIC , strlen(TRICK_COLUMNAR_MAGIC)) ) {
+                return 0 ;
+        }
+
+        TRICK_GET_BYTE_ORDER(my_byte_order) ;
+        switch ( map[file_type_len - 1] ) {
+            case 'L':
+                    *swap = ( my_byte_order == TRICK_LITTLE_ENDIAN ) ? 0 : 1 ;
+                    break ;
+            case 'B':
+                    *swap = ( my_byte_order == TRICK_BIG_ENDIAN ) ? 0 : 1 ;
+                    break ;
+            default:
+                    return 0 ;
+        }
+
+        offset = file_type_len ;
+        num_params = readInt(map + offset , *swap) ;
+        offset += 4 ;
+
+        // Every parameter takes at least two lengths, a type and a size.
+        if ( num_params < 0 or (size_t)num_params > (map_size - offset) / 16 ) {
+                return 0 ;
+        }
+
+        params.resize(num_params) ;
+        for ( ii = 0 ; ii < num_params ; ii++ ) {
+                if ( map_size - offset < 4 ) return 0 ;
+                len = readInt(map + offset , *swap) ;
+                offset += 4 ;
+                if ( len < 0 or map_size - offset < (size_t)len + 4 ) return 0 ;
+                params[ii].name.assign(map + offset , len) ;
+                offset += len ;
+
+                len = readInt(map + offset , *swap) ;
+                offset += 4 ;
+                if ( len < 0 or map_size - offset < (size_t)len + 8 ) return 0 ;
+                params[ii].units.assign(map + offset , len) ;
+                offset += len ;
+
+                params[ii].type = readInt(map + offset , *swap) ;
+                params[ii].size = readInt(map + offset + 4 , *swap) ;
+                offset += 8 ;
+                if ( params[ii].size < 0 ) return 0 ;
+        }
+
+        return offset ;
+}
+
+// Reads the parameter list of a file.  Returns 0 if the file is not a columnar log file.
+int readColumnarParams( const char * file_name , std::vector< ColumnarParam > & params ) {
+
+        char * map ;
+        size_t map_size ;
+        int swap ;
+        size_t data_offset ;
+
+        if ((map = mapColumnarFile(file_name , &map_size)) == 0 ) {
+                return 0 ;
+        }
+        data_offset = readColumnarHeader(map , map_size , &swap , params) ;
+        munmap(map , map_size) ;
+        return data_offset != 0 ;
+}
+
+}
+
+TrickColumnar::TrickColumnar(char * file_name , char * param_name ) :
+ map_(0) ,
+ map_size_(0) ,
+ swap_(0) ,
+ num_params_(0) ,
+ time_type_(TRICK_DOUBLE) ,
+ time_size_(8) ,
+ type_(TRICK_DOUBLE) ,
+ size_(8) ,
+ ranges_size_(0) ,
+ time_column_(0) ,
+ param_column_(0) ,
+ param_found_(0) ,
+ chunk_(0) ,
+ row_(0) ,
+ window_start_(-DBL_MAX) ,
+ window_stop_(DBL_MAX) {
+
+        std::vector< ColumnarParam > params ;
+        size_t offset ;
+        size_t row_size = 0 ;
+        int time_index = 0 ;
+        int ii ;
+
+        fileName_ = file_name ;
+
+        if ((map_ = mapColumnarFile(file_name , &map_size_)) == 0 ) {
+                return ;
+        }
+        if ((offset = readColumnarHeader(map_ , map_size_ , &swap_ , params)) == 0 ) {
+                std::cerr << "ERROR:  \"" << file_name << "\" is not a Trick columnar log file" << std::endl;
+                return ;
+        }
+
+        num_params_ = params.size() ;
+        for ( ii = 0 ; ii < num_params_ ; ii++ ) {
+                if ( params[ii].name == "sys.exec.out.time" ) {
+                        time_index = ii ;
+                        time_type_ = params[ii].type ;
+                        time_size_ = params[ii].size ;
+                        time_column_ = row_size ;
+                        unitTimeStr_ = params[ii].units ;
+                }
+                if ( params[ii].name == param_name ) {
+                        if ( params[ii].units == "--" ) {
+                                unitStr_ = params[ii].units ;
+                        } else {
+                                unitStr_ = map_trick_units_to_udunits(params[ii].units) ;
+                        }
+                        type_ = params[ii].type ;
+                        size_ = params[ii].size ;
+                        param_column_ = row_size ;
+                        param_found_ = 1 ;
+                }
+                row_size += params[ii].size ;
+        }
+        ranges_size_ = num_params_ * 2 * sizeof(double) ;
+
+        // Use the chunk index at the end of the file if the file was closed normally.  The index is only used
+        // if every chunk it points to lies within the file.
+        if ( map_size_ >= offset + sizeof(COLUMNAR_FOOTER) and
+             ! strncmp(map_ + map_size_ - 8 , TRICK_COLUMNAR_FOOTER_MAGIC , 8) ) {
+                uint64_t num_chunks = readUint64(map_ + map_size_ - sizeof(COLUMNAR_FOOTER) , swap_) ;
+                size_t index_end = map_size_ - sizeof(COLUMNAR_FOOTER) ;
+                if ( num_chunks <= (index_end - offset) / sizeof(uint64_t) ) {
+                        size_t index = index_end - num_chunks * sizeof(uint64_t) ;
+                        for ( uint64_t jj = 0 ; jj < num_chunks ; jj++ ) {
+                                Chunk chunk ;
+                                chunk.offset = readUint64(map_ + index + jj * sizeof(uint64_t) , swap_) ;
+                                if ( chunkSize(chunk.offset , row_size) == 0 ) {
+                                        chunks_.clear() ;
+                                        break ;
+                                }
+                                chunks_.push_back(chunk) ;
+                        }
+                }
+        }
+
+        // Otherwise hop from chunk header to chunk header.  A partial chunk at the end is ignored.
+        if ( chunks_.empty() ) {
+                size_t chunk_size ;
+                while ( (chunk_size = chunkSize(offset , row_size)) != 0 ) {
+                        Chunk chunk ;
+                        chunk.offset = offset ;
+                        chunks_.push_back(chunk) ;
+                        offset += chunk_size ;
+                }
+        }
+
+        for ( ii = 0 ; ii < (int)chunks_.size() ; ii++ ) {
+                const char * ranges = map_ + chunks_[ii].offset + sizeof(COLUMNAR_CHUNK_HEADER) ;
+                chunks_[ii].num_rows = readInt(map_ + chunks_[ii].offset , swap_) ;
+                chunks_[ii].time_min = readDouble(ranges + time_index * 2 * sizeof(double) , swap_) ;
+                chunks_[ii].time_max = readDouble(ranges + (time_index * 2 + 1) * sizeof(double) , swap_) ;
+        }
+}
+
+TrickColumnar::~TrickColumnar()
+{
+        if ( map_ ) {
+                munmap(map_ , map_size_) ;
+        }
+}
+
+// Returns the size of the chunk whose header is at offset, or 0 if the chunk does not lie within the file.
+size_t TrickColumnar::chunkSize( size_t offset , size_t row_size ) {
+
+        size_t fixed_size = sizeof(COLUMNAR_CHUNK_HEADER) + ranges_size_ ;
+        size_t num_rows ;
+
+        if ( offset > map_size_ or map_size_ - offset < fixed_size ) {
+                return 0 ;
+        }
+        num_rows = (uint32_t)readInt(map_ + offset , swap_) ;
+        if ( row_size > 0 and num_rows > (map_size_ - offset - fixed_size) / row_size ) {
+                return 0 ;
+        }
+        return fixed_size + num_rows * row_size ;
+}
+
+double TrickColumnar::readValue( size_t column_offset , unsigned int row , int type , int size ) {
+
+        if ( chunk_ >= chunks_.size() or row >= chunks_[chunk_].num_rows ) {
+                return 0.0 ;
+        }
+        const Chunk & chunk = chunks_[chunk_] ;
+        const char * p = map_ + chunk.offset + sizeof(COLUMNAR_CHUNK_HEADER) + ranges_size_ +
+                         column_offset * chunk.num_rows + (size_t)row * size ;
+        union {
+                char c[8] ;
+                int8_t i8 ; uint8_t u8 ;
+                int16_t i16 ; uint16_t u16 ;
+                int32_t i32 ; uint32_t u32 ;
+                int64_t i64 ; uint64_t u64 ;
+                float f ; double d ;
+        } v ;
+        int is_signed ;
+
+        if ( size < 1 or size > 8 ) {
+                return 0.0 ;
+        }
+        memcpy(v.c , p , size) ;
+
+        switch ( type ) {
+                case TRICK_FLOAT:
+                        return swap_ ? trick_byteswap_float(v.f) : v.f ;
+                case TRICK_DOUBLE:
+                        return swap_ ? trick_byteswap_double(v.d) : v.d ;
+                case TRICK_CHARACTER:
+                case TRICK_SHORT:
+                case TRICK_INTEGER:
+                case TRICK_LONG:
+                case TRICK_LONG_LONG:
+                case TRICK_BITFIELD:
+                case TRICK_ENUMERATED:
+                        is_signed = 1 ;
+                        break ;
+                case TRICK_UNSIGNED_CHARACTER:
+                case TRICK_UNSIGNED_SHORT:
+                case TRICK_UNSIGNED_INTEGER:
+                case TRICK_UNSIGNED_LONG:
+                case TRICK_UNSIGNED_LONG_LONG:
+                case TRICK_UNSIGNED_BITFIELD:
+                case TRICK_BOOLEAN:
+                        is_signed = 0 ;
+                        break ;
+                default:
+                        return 0.0 ;
+        }
+
+        // Integers are read by their recorded size, so a long from a 32 bit sim reads correctly.
+        switch ( size ) {
+                case 1:
+                        return is_signed ? (double)v.i8 : (double)v.u8 ;
+                case 2:
+                        if ( swap_ ) { v.i16 = trick_byteswap_short(v.i16) ; }
+                        return is_signed ? (double)v.i16 : (double)v.u16 ;
+                case 4:
+                        if ( swap_ ) { v.i32 = trick_byteswap_int(v.i32) ; }
+                        return is_signed ? (double)v.i32 : (double)v.u32 ;
+                case 8:
+                        if ( swap_ ) { v.i64 = trick_byteswap_long_long(v.i64) ; }
+                        return is_signed ? (double)v.i64 : (double)v.u64 ;
+        }
+        return 0.0 ;
+}
+
+int TrickColumnar::seekRow() {
+        if ( ! param_found_ ) {
+                return 0 ;
+        }
+        while ( chunk_ < chunks_.size() ) {
+                const Chunk & chunk = chunks_[chunk_] ;
+                if ( row_ < chunk.num_rows and
+                     ( row_ > 0 or ( chunk.time_max >= window_start_ and chunk.time_min <= window_stop_ ))) {
+                        return 1 ;
+                }
+                chunk_++ ;
+                row_ = 0 ;
+        }
+        return 0 ;
+}
+
+int TrickColumnar::get( double * time , double * value ) {
+
+        if ( ! seekRow() ) {
+                return 0 ;
+        }
+        *time = readValue(time_column_ , row_ , time_type_ , time_size_) ;
+        *value = readValue(param_column_ , row_ , type_ , size_) ;
+        row_++ ;
+        return 1 ;
+}
+
+int TrickColumnar::peek( double * time , double * value ) {
+
+        unsigned int chunk = chunk_ ;
+        unsigned int row = row_ ;
+        int ret ;
+
+        ret = get( time , value ) ;
+        chunk_ = chunk ;
+        row_ = row ;
+
+        return(ret) ;
+}
+
+void TrickColumnar::begin() {
+        chunk_ = 0 ;
+        row_ = 0 ;
+}
+
+int TrickColumnar::end() {
+        return ! seekRow() ;
+}
+
+int TrickColumnar::step() {
+        if ( ! seekRow() ) {
+                return 0 ;
+        }
+        row_++ ;
+        return 1 ;
+}
+
+void TrickColumnar::setTimeWindow( double start , double stop ) {
+        window_start_ = start ;
+        window_stop_ = stop ;
+}
+
+int TrickColumnarGetNumVariables(const char* file_name) {
+        std::vector< ColumnarParam > params ;
+        if ( ! readColumnarParams(file_name , params) ) {
+                return 0 ;
+        }
+        return params.size() ;
+}
+
+char** TrickColumnarGetVariableNames(const char* file_name) {
+
+        std::vector< ColumnarParam > params ;
+        char** variable_names ;
+        unsigned int ii ;
+
+        if ( ! readColumnarParams(file_name , params) ) {
+                return 0 ;
+        }
+        variable_names = new char*[params.size()] ;
+        for ( ii = 0 ; ii < params.size() ; ii++ ) {
+                variable_names[ii] = new char[params[ii].name.length() + 1] ;
+                strcpy(variable_names[ii] , params[ii].name.c_str()) ;
+        }
+        return variable_names ;
+}
+
+char** TrickColumnarGetVariableUnits(const char* file_name) {
+
+        std::vector< ColumnarParam > params ;
+        char** variable_units ;
+        unsigned int ii ;
+
+        if ( ! readColumnarParams(file_name , params) ) {
+                return 0 ;
+        }
+        variable_units = new char*[params.size()] ;
+        for ( ii = 0 ; ii < params.size() ; ii++ ) {
+                variable_units[ii] = new char[params[ii].units.length() + 1] ;
+                strcpy(variable_units[ii] , params[ii].units.c_str()) ;
+        }
+        return variable_units ;
+}
+
+int TrickColumnarLocateParam( const char * file_name , const char * param_name ) {
+
+        std::vector< ColumnarParam > params ;
+        unsigned int ii ;
+
+        if ( ! readColumnarParams(file_name , params) ) {
+                return 0 ;
+        }
+        for ( ii = 0 ; ii < params.size() ; ii++ ) {
+                if ( params[ii].name == param_name ) {
+                        return 1 ;
+                }
+        }
+        return 0 ;
+}
@@ -0,0 +1,69 @@
+
+#ifndef TRICKCOLUMNAR_HH
+#define TRICKCOLUMNAR_HH
+
+#include <stddef.h>
+#include <vector>
+#include "DataStream.hh"
+
+/*
+ * Reads one variable from a Trick columnar log file (.trkc).  The file is mapped into memory and only the
+ * time column and the column of the requested variable are touched.  Chunks outside of the time window
+ * given to setTimeWindow are skipped without reading their columns.
+ */
+class TrickColumnar : public DataStream {
+
+       public:
+               TrickColumnar(char * file, char * param ) ;
+               ~TrickColumnar() ;
+
+               int get(double * time , double * value ) ;
+               int peek(double * time , double * value ) ;
+
+               void begin() ;
+               int end() ;
+               int step() ;
+
+               void setTimeWindow(double start , double stop ) ;
+
+       private:
+               struct Chunk {
+                       size_t offset ;          // file offset of the chunk header
+                       unsigned int num_rows ;
+                       double time_min ;
+                       double time_max ;
+               } ;
+
+               // Moves the cursor past empty chunks and chunks outside of the time window.
+               // Returns 0 at the end of the file.
+               int seekRow() ;
+               // Returns the size of the chunk at offset, or 0 if it does not fit in the file.
+               size_t chunkSize( size_t offset , size_t row_size ) ;
+               double readValue( size_t column_offset , unsigned int row , int type , int size ) ;
+
+               char * map_ ;
+               size_t map_size_ ;
+               int swap_ ;
+               int num_params_ ;
+               int time_type_ ;
+               int time_size_ ;
+               int type_ ;
+               int size_ ;
+               size_t ranges_size_ ;      // bytes of min/max pairs after each chunk header
+               size_t time_column_ ;      // bytes before the time column in a chunk, per row
+               size_t param_column_ ;     // bytes before the parameter column in a chunk, per row
+               int param_found_ ;         // the parameter is in the file
+               std::vector< Chunk > chunks_ ;
+
+               unsigned int chunk_ ;
+               unsigned int row_ ;
+               double window_start_ ;
+               double window_stop_ ;
+} ;
+
+int    TrickColumnarLocateParam( const char * file_name , const char * param_name ) ;
+char** TrickColumnarGetVariableNames(const char* file_name) ;
+int    TrickColumnarGetNumVariables(const char* file_name) ;
+char** TrickColumnarGetVariableUnits(const char* file_name) ;
+
+#endif
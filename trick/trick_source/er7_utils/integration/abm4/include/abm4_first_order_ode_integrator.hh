@@ -96,6 +96,34 @@ public:
     */
    virtual ABM4FirstOrderODEIntegrator * create_copy () const;
 
+   /**
+    * Indicates whether the state can be interpolated, which needs a primer
+    * that can be interpolated.
+    * @return True if the primer has dense output.
+    */
+   virtual bool has_dense_output () const
+   {
+      return (primer != NULL) && primer->has_dense_output();
+   }
+
+   /**
+    * Interpolate the state within the integration cycle just completed.
+    * A priming cycle uses the primer's dense output. An ABM4 cycle uses a
+    * cubic Hermite through the start and end of the cycle, with the
+    * derivative at the predicted state standing in for the derivative at
+    * the end.
+    * @param[in]  dyn_dt     Integration interval, dynamic time seconds.
+    * @param[in]  theta      Fraction of the cycle, 0 at its start, 1 at its end.
+    * @param[in]  end_state  Generalized position at the end of the cycle.
+    * @param[out] position   Interpolated generalized position.
+    * @return True if the state was interpolated.
+    */
+   virtual bool interpolate_state (
+      double dyn_dt,
+      double theta,
+      double const * ER7_UTILS_RESTRICT end_state,
+      double * ER7_UTILS_RESTRICT position) const;
+
 
 protected:
 
@@ -149,6 +177,10 @@ protected:
       This array is rotated so that deriv_hist[0] contains the state derivatives
       at the start of the current cycle, deriv_hist[1] the derivatives at the
       start of the previous cycle, and so on. */
+
+   double * pred_deriv; /*!< trick_units(--) @n
+      The state derivatives at the predicted state of the current cycle,
+      saved for the dense output. */
 };
 
 }
@@ -41,7 +41,8 @@ ABM4FirstOrderODEIntegrator::ABM4FirstOrderODEIntegrator (
 :
    Er7UtilsDeletable (),
    PrimingFirstOrderODEIntegrator (),
-   init_state (NULL)
+   init_state (NULL),
+   pred_deriv (NULL)
 {
    alloc::initialize_2D_array<double, 4> (deriv_hist);
 }
@@ -52,11 +53,13 @@ ABM4FirstOrderODEIntegrator::ABM4FirstOrderODEIntegrator (
 :
    Er7UtilsDeletable (),
    PrimingFirstOrderODEIntegrator (src),
-   init_state (NULL)
+   init_state (NULL),
+   pred_deriv (NULL)
 {
    // Replicate the source's contents if they exist.
    if (src.init_state != NULL) {
       init_state = alloc::replicate_array<double> (state_size, src.init_state);
+      pred_deriv = alloc::replicate_array<double> (state_size, src.pred_deriv);
       alloc::replicate_2D_array<double, 4> (state_size, src.deriv_hist,
                                             deriv_hist);
    }
@@ -74,10 +77,12 @@ ABM4FirstOrderODEIntegrator::ABM4FirstOrderODEIntegrator (
 :
    Er7UtilsDeletable (),
    PrimingFirstOrderODEIntegrator (4, primer_constructor, size, controls_in),
-   init_state(NULL)
+   init_state(NULL),
+   pred_deriv(NULL)
 {
    // Allocate storage for the ABM method.
    init_state = alloc::allocate_array<double> (state_size);
+   pred_deriv = alloc::allocate_array<double> (state_size);
    alloc::allocate_2D_array<double, 4> (state_size, deriv_hist);
 }
 
@@ -88,6 +93,7 @@ ABM4FirstOrderODEIntegrator::~ABM4FirstOrderODEIntegrator (
 {
    // Free ABM storage memory.
    alloc::deallocate_array<double> (init_state);
+   alloc::deallocate_array<double> (pred_deriv);
    alloc::deallocate_2D_array<double, 4> (deriv_hist);
 }
 
@@ -108,6 +114,7 @@ ABM4FirstOrderODEIntegrator::swap (
 {
    PrimingFirstOrderODEIntegrator::swap (other);
    std::swap (init_state, other.init_state);
+   std::swap (pred_deriv, other.pred_deriv);
    std::swap (deriv_hist[0], other.deriv_hist[0]);
    std::swap (deriv_hist[1], other.deriv_hist[1]);
    std::swap (deriv_hist[2], other.deriv_hist[2]);
@@ -181,8 +188,10 @@ ABM4FirstOrderODEIntegrator::technique_integrate (
    /**
     * - ABM4 target stage 2 advances the state to the end of the integration
     *   interval using the third order Adams-Moulton method as a corrector.
+    *   The derivatives at the predicted state are saved for the dense output.
     */
    case 2:
+      integ_utils::copy_array (velocity, state_size, pred_deriv);
 
       abm::corrector_step<4> (init_state, velocity, deriv_hist,
                               corrector_weights, wscale, dt, state_size,
@@ -193,6 +202,35 @@ ABM4FirstOrderODEIntegrator::technique_integrate (
    return 1.0;
 }
 
+
+// Interpolate the state over the integration cycle just completed.
+bool
+ABM4FirstOrderODEIntegrator::interpolate_state (
+   double dt,
+   double theta,
+   double const * ER7_UTILS_RESTRICT end_state,
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   // The primer made the cycle until priming completes.
+   if (! primed) {
+      return primer->interpolate_state (dt, theta, end_state, position);
+   }
+
+   double theta2 = theta * theta;
+   double theta3 = theta2 * theta;
+   double h_00 = 2.0 * theta3 - 3.0 * theta2 + 1.0;
+   double h_10 = (theta3 - 2.0 * theta2 + theta) * dt;
+   double h_01 = 3.0 * theta2 - 2.0 * theta3;
+   double h_11 = (theta3 - theta2) * dt;
+
+   for (unsigned int ii = 0; ii < state_size; ++ii) {
+      position[ii] = h_00 * init_state[ii] + h_10 * deriv_hist[0][ii] +
+                     h_01 * end_state[ii] + h_11 * pred_deriv[ii];
+   }
+   return true;
+}
+
 }
 /**
  * @if Er7UtilsUseGroups
@@ -102,6 +102,71 @@ public:
       const double * ER7_UTILS_RESTRICT velocity,
       double * ER7_UTILS_RESTRICT position) = 0;
 
+   /**
+    * Get the order of the lower order solution of an embedded error estimate.
+    * The default implementation has no error estimate.
+    * @return Order of the error estimate, zero if there is none.
+    */
+   virtual unsigned int get_error_order () const
+   {
+      return 0;
+   }
+
+   /**
+    * Estimate the error in the state over the integration cycle just
+    * completed.
+    * The default implementation has no error estimate.
+    * @param[in]  dyn_dt  Dynamic time step of the cycle, in dynamic time seconds.
+    * @param[out] error   Error estimate (unused)
+    * @return True if the error was estimated.
+    */
+   virtual bool estimate_error (
+      double dyn_dt ER7_UTILS_UNUSED,
+      double * ER7_UTILS_RESTRICT error ER7_UTILS_UNUSED) const
+   {
+      return false;
+   }
+
+   /**
+    * Get the state at the start of the integration cycle just completed.
+    * The default implementation does not save that state.
+    * @param[out] position  Generalized position vector (unused)
+    * @return True if the state was copied.
+    */
+   virtual bool get_initial_state (
+      double * ER7_UTILS_RESTRICT position ER7_UTILS_UNUSED) const
+   {
+      return false;
+   }
+
+   /**
+    * Indicates whether interpolate_state is implemented.
+    * The default implementation has no dense output.
+    * @return True if the state can be interpolated.
+    */
+   virtual bool has_dense_output () const
+   {
+      return false;
+   }
+
+   /**
+    * Interpolate the state within the integration cycle just completed.
+    * The default implementation has no dense output.
+    * @param[in]  dyn_dt     Dynamic time step of the cycle, in dynamic time seconds.
+    * @param[in]  theta      Fraction of the cycle, 0 at its start, 1 at its end.
+    * @param[in]  end_state  Generalized position at the end of the cycle (unused)
+    * @param[out] position   Interpolated generalized position (unused)
+    * @return True if the state was interpolated.
+    */
+   virtual bool interpolate_state (
+      double dyn_dt ER7_UTILS_UNUSED,
+      double theta ER7_UTILS_UNUSED,
+      double const * ER7_UTILS_RESTRICT end_state ER7_UTILS_UNUSED,
+      double * ER7_UTILS_RESTRICT position ER7_UTILS_UNUSED) const
+   {
+      return false;
+   }
+
 
 protected:
 
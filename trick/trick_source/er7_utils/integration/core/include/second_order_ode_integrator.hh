@@ -124,6 +124,48 @@ public:
       double * ER7_UTILS_RESTRICT velocity,
       double * ER7_UTILS_RESTRICT position) = 0;
 
+   /**
+    * Get the order of the lower order solution of an embedded error estimate.
+    * The default implementation has no error estimate.
+    * @return Order of the error estimate, zero if there is none.
+    */
+   virtual unsigned int get_error_order () const
+   {
+      return 0;
+   }
+
+   /**
+    * Estimate the error in the generalized position and velocity over the
+    * integration cycle just completed.
+    * The default implementation has no error estimate.
+    * @param[in]  dyn_dt     Dynamic time step of the cycle, in dynamic time seconds.
+    * @param[out] vel_error  Velocity error estimate (unused)
+    * @param[out] pos_error  Position error estimate (unused)
+    * @return True if the error was estimated.
+    */
+   virtual bool estimate_error (
+      double dyn_dt ER7_UTILS_UNUSED,
+      double * ER7_UTILS_RESTRICT vel_error ER7_UTILS_UNUSED,
+      double * ER7_UTILS_RESTRICT pos_error ER7_UTILS_UNUSED) const
+   {
+      return false;
+   }
+
+   /**
+    * Get the generalized position and velocity at the start of the
+    * integration cycle just completed.
+    * The default implementation does not save that state.
+    * @param[out] velocity  Generalized velocity vector (unused)
+    * @param[out] position  Generalized position vector (unused)
+    * @return True if the state was copied.
+    */
+   virtual bool get_initial_state (
+      double * ER7_UTILS_RESTRICT velocity ER7_UTILS_UNUSED,
+      double * ER7_UTILS_RESTRICT position ER7_UTILS_UNUSED) const
+   {
+      return false;
+   }
+
 
 protected:
 
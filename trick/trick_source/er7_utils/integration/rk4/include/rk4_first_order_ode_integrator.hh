@@ -103,6 +103,30 @@ public:
       const double * ER7_UTILS_RESTRICT velocity,
       double * ER7_UTILS_RESTRICT position);
 
+   /**
+    * Indicates that the state can be interpolated.
+    * @return Always returns true.
+    */
+   virtual bool has_dense_output () const
+   {
+      return true;
+   }
+
+   /**
+    * Interpolate the state with the third order continuous extension of RK4.
+    * The end state is not used, the extension reproduces it at theta = 1.
+    * @param[in]  dyn_dt     Integration interval, dynamic time seconds.
+    * @param[in]  theta      Fraction of the cycle, 0 at its start, 1 at its end.
+    * @param[in]  end_state  Generalized position at the end of the cycle.
+    * @param[out] position   Interpolated generalized position.
+    * @return Always returns true.
+    */
+   virtual bool interpolate_state (
+      double dyn_dt,
+      double theta,
+      double const * ER7_UTILS_RESTRICT end_state,
+      double * ER7_UTILS_RESTRICT position) const;
+
 
 protected:
 
@@ -0,0 +1,245 @@
+/**
+ * @if Er7UtilsUseGroups
+ * @addtogroup Er7Utils
+ * @{
+ * @addtogroup Integration
+ * @{
+ * @endif
+ */
+
+/**
+ * @file
+ * Defines the RK4 step functions shared by the RK4 integrators, templated on
+ * the state size.
+ */
+
+/*
+Purpose: ()
+*/
+
+
+#ifndef ER7_UTILS_RK4_STEPS_HH
+#define ER7_UTILS_RK4_STEPS_HH
+
+// Interface includes
+#include "er7_utils/interface/include/er7_class.hh"
+
+// Integration includes
+#include "er7_utils/integration/core/include/integ_utils.hh"
+#include "er7_utils/integration/core/include/rk_utils.hh"
+
+
+namespace er7_utils {
+
+/**
+ * RK4 steps with the state size known at compile time or at run time.
+ * The integrators pick a fixed size for common state sizes and zero for
+ * all others. Both perform the same operations in the same order.
+ */
+namespace rk4_steps {
+
+/**
+ * Advance state to the target stage of an RK4 integration cycle.
+ * @tparam fixed_size  State size, or zero if the size is only known at run
+ *                     time. The integ_utils and rk functions are always
+ *                     inlined, so with a fixed size the compiler can unroll
+ *                     and vectorize their loops.
+ * @param[in]     dt            Integration interval step.
+ * @param[in]     target_stage  The stage of the integration process.
+ * @param[in]     state_size    State size, used when fixed_size is zero.
+ * @param[in]     velocity      Time derivative of the state.
+ * @param[in,out] init_state    State at the start of the cycle.
+ * @param[in,out] deriv_hist    Derivatives at each stage of the cycle.
+ * @param[in,out] position      State vector.
+ * @return The step factor.
+ */
+template <unsigned int fixed_size>
+inline double
+rk4_step (
+   double dt,
+   unsigned int target_stage,
+   unsigned int state_size,
+   const double * ER7_UTILS_RESTRICT velocity,
+   double * ER7_UTILS_RESTRICT init_state,
+   double * const * deriv_hist,
+   double * ER7_UTILS_RESTRICT position)
+{
+   using namespace er7_utils;
+
+   const int size = (fixed_size != 0) ? fixed_size : state_size;
+   double step_factor;
+
+   switch (target_stage) {
+   case 1:
+      integ_utils::inplace_euler_step_save_both (
+         velocity, 0.5*dt, size,
+         init_state, deriv_hist[0], position);
+      step_factor = 0.5;
+      break;
+
+   case 2:
+      integ_utils::euler_step_save_deriv (
+         init_state, velocity, 0.5*dt, size,
+         deriv_hist[1], position);
+      step_factor = 0.5;
+      break;
+
+   case 3:
+      integ_utils::euler_step_save_deriv (
+         init_state, velocity, dt, size,
+         deriv_hist[2], position);
+      step_factor = 1.0;
+      break;
+
+   case 4:
+      // The last derivative is saved for the dense output.
+      integ_utils::copy_array (velocity, size, deriv_hist[3]);
+      rk::rk4_final_step (
+         init_state, deriv_hist, velocity, dt, size,
+         position);
+      step_factor = 1.0;
+      break;
+
+
+   default:
+      step_factor = 1.0;
+      break;
+   }
+
+   return step_factor;
+}
+
+
+/**
+ * Advance a simple second order ODE to the target stage of an RK4
+ * integration cycle.
+ * @tparam fixed_size  Position size, or zero if the size is only known at run
+ *                     time. The integ_utils and rk functions are always
+ *                     inlined, so with a fixed size the compiler can unroll
+ *                     and vectorize their loops.
+ * @return The step factor.
+ */
+template <unsigned int fixed_size>
+inline double
+rk4_simple_step (
+   double dyn_dt,
+   unsigned int target_stage,
+   int state_size,
+   double const * ER7_UTILS_RESTRICT accel,
+   double * ER7_UTILS_RESTRICT init_pos,
+   double * ER7_UTILS_RESTRICT init_vel,
+   double * const * posdot_hist,
+   double * const * veldot_hist,
+   double * ER7_UTILS_RESTRICT velocity,
+   double * ER7_UTILS_RESTRICT position)
+{
+   using namespace er7_utils;
+
+   const int size = (fixed_size != 0) ? fixed_size : state_size;
+   double step_factor;
+
+   /*
+    * ### Overview
+    *
+    * This method applies the canonical fourth order Runga Kutta technique
+    * to a simple second order ODE. One integration cycle comprises four
+    * intermediate steps that operate per the following Butcher tableau:
+    * @code
+    *  0  |
+    * 1/2 | 1/2
+    * 1/2 |  0  1/2
+    *  1  |  0   0   1
+    * ----+----------------
+    *  1  | 1/6 1/3 1/3 1/6
+    * @endcode
+    *
+    * The 4th order Runga Kutta Butcher tableau is of such a simple form
+    * that a tableau-based formulation is not used. The code instead
+    * implements the tableau directly.
+    *
+    * ### Algorithm
+    *
+    * The input target stage (1 to 4) specifies the RK4 intermediate step.
+    * A target_stage based switch statement directs the computation.
+    */
+
+   // Advance state per RK4.
+   switch (target_stage) {
+
+   /**
+    * - First intermediate step:@n
+    *   Advance state (position and velocity) to the midpoint of the
+    *   integration interval as a simple Euler half step, saving the
+    *   initial position and velocity for use in subsequent stages.
+    */
+   case 1:
+      integ_utils::inplace_two_state_euler_step_save_all (
+         accel, 0.5*dyn_dt, size,
+         init_pos, init_vel,
+         posdot_hist[0], veldot_hist[0], position, velocity);
+      step_factor = 0.5;
+      break;
+
+   /**
+    * - Second intermediate step:@n
+    *   Advance the initial state (position and velocity) to the midpoint of
+    *   the integration interval as a simple Euler half step, but using
+    *   accelerations calculated based on the state obtained from the
+    *   first intermediate step.
+    */
+   case 2:
+      rk::rk_two_state_intermediate_step (
+         init_pos, init_vel, accel, 0.5*dyn_dt, size,
+         posdot_hist[1], veldot_hist[1], position, velocity);
+      step_factor = 0.5;
+      break;
+
+   /**
+    * - Third intermediate step:@n
+    *   Advance the initial state (position and velocity) to the end of
+    *   the integration interval as a simple Euler full step, but using
+    *   accelerations calculated based on the state obtained from the
+    *   second intermediate step.
+    */
+   case 3:
+      rk::rk_two_state_intermediate_step (
+         init_pos, init_vel, accel, dyn_dt, size,
+         posdot_hist[2], veldot_hist[2], position, velocity);
+      step_factor = 1.0;
+      break;
+
+   /**
+    * - Final step:@n
+    *   Advance the initial state (position and velocity) to the end of
+    *   the integration interval as a weighted Euler step, using the Butcher
+    *   tableau 'b' vector (1/6, 1/3, 1/3, 1/6) to form a weighted velocity
+    *   to propagate position, weighted acceleration to propagate velocity.
+    */
+   case 4:
+      rk::rk4_two_state_final_step (
+         init_pos, init_vel, posdot_hist, veldot_hist, accel,
+         dyn_dt, size,
+         position, velocity);
+      step_factor = 1.0;
+      break;
+
+   default:
+      step_factor = 1.0;
+      break;
+   }
+
+   return step_factor;
+}
+
+}
+
+}
+
+
+#endif
+/**
+ * @if Er7UtilsUseGroups
+ * @}
+ * @}
+ * @endif
+ */
@@ -28,6 +28,7 @@ Purpose: ()
 
 // Model includes
 #include "../include/rk4_first_order_ode_integrator.hh"
+#include "../include/rk4_steps.hh"
 
 
 namespace er7_utils {
@@ -120,44 +121,48 @@ RK4FirstOrderODEIntegrator::integrate (
    const double * ER7_UTILS_RESTRICT velocity,
    double * ER7_UTILS_RESTRICT position)
 {
-   double step_factor;
-
-   switch (target_stage) {
-   case 1:
-      integ_utils::inplace_euler_step_save_both (
-         velocity, 0.5*dt, state_size,
-         init_state, deriv_hist[0], position);
-      step_factor = 0.5;
-      break;
-
-   case 2:
-      integ_utils::euler_step_save_deriv (
-         init_state, velocity, 0.5*dt, state_size,
-         deriv_hist[1], position);
-      step_factor = 0.5;
-      break;
-
+   // State sizes 3 and 6 use a step with the size known at compile time,
+   // the sizes where RK4_steps_bench measures a gain. The operations are the
+   // same as in the general step.
+   switch (state_size) {
    case 3:
-      integ_utils::euler_step_save_deriv (
-         init_state, velocity, dt, state_size,
-         deriv_hist[2], position);
-      step_factor = 1.0;
-      break;
-
-   case 4:
-      rk::rk4_final_step (
-         init_state, deriv_hist, velocity, dt, state_size,
-         position);
-      step_factor = 1.0;
-      break;
-
-
+      return rk4_steps::rk4_step<3> (
+         dt, target_stage, state_size, velocity,
+         init_state, deriv_hist, position);
+   case 6:
+      return rk4_steps::rk4_step<6> (
+         dt, target_stage, state_size, velocity,
+         init_state, deriv_hist, position);
    default:
-      step_factor = 1.0;
-      break;
+      return rk4_steps::rk4_step<0> (
+         dt, target_stage, state_size, velocity,
+         init_state, deriv_hist, position);
    }
+}
+
 
-   return step_factor;
+// Interpolate the state with the continuous extension of RK4.
+bool
+RK4FirstOrderODEIntegrator::interpolate_state (
+   double dt,
+   double theta,
+   double const * ER7_UTILS_RESTRICT end_state ER7_UTILS_UNUSED,
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   double theta2 = theta * theta;
+   double theta3 = theta2 * theta;
+   double b_1  = (theta - 1.5 * theta2 + theta3 * (2.0 / 3.0)) * dt;
+   double b_23 = (theta2 - theta3 * (2.0 / 3.0)) * dt;
+   double b_4  = (theta3 * (2.0 / 3.0) - 0.5 * theta2) * dt;
+
+   for (unsigned int ii = 0; ii < state_size; ++ii) {
+      position[ii] = init_state[ii] +
+                     b_1 * deriv_hist[0][ii] +
+                     b_23 * (deriv_hist[1][ii] + deriv_hist[2][ii]) +
+                     b_4 * deriv_hist[3][ii];
+   }
+   return true;
 }
 
 }
@@ -31,6 +31,7 @@ Purpose: ()
 
 // Model includes
 #include "../include/rk4_second_order_ode_integrator.hh"
+#include "../include/rk4_steps.hh"
 
 
 namespace er7_utils {
@@ -72,99 +73,23 @@ RK4SimpleSecondOrderODEIntegrator::integrate (
    double * ER7_UTILS_RESTRICT velocity,
    double * ER7_UTILS_RESTRICT position)
 {
-   double step_factor;
-
-   /**
-    * ### Overview
-    *
-    * This method applies the canonical fourth order Runga Kutta technique
-    * to a simple second order ODE. One integration cycle comprises four
-    * intermediate steps that operate per the following Butcher tableau:
-    * @code
-    *  0  |
-    * 1/2 | 1/2
-    * 1/2 |  0  1/2
-    *  1  |  0   0   1
-    * ----+----------------
-    *  1  | 1/6 1/3 1/3 1/6
-    * @endcode
-    *
-    * The 4th order Runga Kutta Butcher tableau is of such a simple form
-    * that a tableau-based formulation is not used. The code instead
-    * implements the tableau directly.
-    *
-    * ### Algorithm
-    *
-    * The input target stage (1 to 4) specifies the RK4 intermediate step.
-    * A target_stage based switch statement directs the computation.
-    */
-
-   // Advance state per RK4.
-   switch (target_stage) {
-
-   /**
-    * - First intermediate step:@n
-    *   Advance state (position and velocity) to the midpoint of the
-    *   integration interval as a simple Euler half step, saving the
-    *   initial position and velocity for use in subsequent stages.
-    */
-   case 1:
-      integ_utils::inplace_two_state_euler_step_save_all (
-         accel, 0.5*dyn_dt, state_size[0],
-         init_pos, init_vel,
-         posdot_hist[0], veldot_hist[0], position, velocity);
-      step_factor = 0.5;
-      break;
-
-   /**
-    * - Second intermediate step:@n
-    *   Advance the initial state (position and velocity) to the midpoint of
-    *   the integration interval as a simple Euler half step, but using
-    *   accelerations calculated based on the state obtained from the
-    *   first intermediate step.
-    */
-   case 2:
-      rk::rk_two_state_intermediate_step (
-         init_pos, init_vel, accel, 0.5*dyn_dt, state_size[0],
-         posdot_hist[1], veldot_hist[1], position, velocity);
-      step_factor = 0.5;
-      break;
-
-   /**
-    * - Third intermediate step:@n
-    *   Advance the initial state (position and velocity) to the end of
-    *   the integration interval as a simple Euler full step, but using
-    *   accelerations calculated based on the state obtained from the
-    *   second intermediate step.
-    */
+   // Position sizes 3 and 6 use a step with the size known at compile time,
+   // the sizes where RK4_steps_bench measures a gain. The operations are the
+   // same as in the general step.
+   switch (state_size[0]) {
    case 3:
-      rk::rk_two_state_intermediate_step (
-         init_pos, init_vel, accel, dyn_dt, state_size[0],
-         posdot_hist[2], veldot_hist[2], position, velocity);
-      step_factor = 1.0;
-      break;
-
-   /**
-    * - Final step:@n
-    *   Advance the initial state (position and velocity) to the end of
-    *   the integration interval as a weighted Euler step, using the Butcher
-    *   tableau 'b' vector (1/6, 1/3, 1/3, 1/6) to form a weighted velocity
-    *   to propagate position, weighted acceleration to propagate velocity.
-    */
-   case 4:
-      rk::rk4_two_state_final_step (
-         init_pos, init_vel, posdot_hist, veldot_hist, accel,
-         dyn_dt, state_size[0],
-         position, velocity);
-      step_factor = 1.0;
-      break;
-
+      return rk4_steps::rk4_simple_step<3> (
+         dyn_dt, target_stage, state_size[0], accel, init_pos, init_vel,
+         posdot_hist, veldot_hist, velocity, position);
+   case 6:
+      return rk4_steps::rk4_simple_step<6> (
+         dyn_dt, target_stage, state_size[0], accel, init_pos, init_vel,
+         posdot_hist, veldot_hist, velocity, position);
    default:
-      step_factor = 1.0;
-      break;
+      return rk4_steps::rk4_simple_step<0> (
+         dyn_dt, target_stage, state_size[0], accel, init_pos, init_vel,
+         posdot_hist, veldot_hist, velocity, position);
    }
-
-   return step_factor;
 }
 
 
@@ -104,6 +104,59 @@ public:
       const double * ER7_UTILS_RESTRICT velocity,
       double * ER7_UTILS_RESTRICT position);
 
+   /**
+    * Get the order of the embedded fourth order solution.
+    * @return Always returns 4.
+    */
+   virtual unsigned int get_error_order () const
+   {
+      return 4;
+   }
+
+   /**
+    * Estimate the error as the difference between the fifth and fourth
+    * order solutions.
+    * @param[in]  dyn_dt  Integration interval, dynamic time seconds.
+    * @param[out] error   Error estimate.
+    * @return Always returns true.
+    */
+   virtual bool estimate_error (
+      double dyn_dt,
+      double * ER7_UTILS_RESTRICT error) const;
+
+   /**
+    * Get the state at the start of the integration cycle.
+    * @param[out] position  Generalized position vector.
+    * @return Always returns true.
+    */
+   virtual bool get_initial_state (
+      double * ER7_UTILS_RESTRICT position) const;
+
+   /**
+    * Indicates that the state can be interpolated.
+    * @return Always returns true.
+    */
+   virtual bool has_dense_output () const
+   {
+      return true;
+   }
+
+   /**
+    * Interpolate the state with a cubic Hermite through the start and end of
+    * the cycle. The last stage, evaluated at the end of the cycle, stands in
+    * for the derivative there.
+    * @param[in]  dyn_dt     Integration interval, dynamic time seconds.
+    * @param[in]  theta      Fraction of the cycle, 0 at its start, 1 at its end.
+    * @param[in]  end_state  Generalized position at the end of the cycle.
+    * @param[out] position   Interpolated generalized position.
+    * @return Always returns true.
+    */
+   virtual bool interpolate_state (
+      double dyn_dt,
+      double theta,
+      double const * ER7_UTILS_RESTRICT end_state,
+      double * ER7_UTILS_RESTRICT position) const;
+
 
 protected:
 
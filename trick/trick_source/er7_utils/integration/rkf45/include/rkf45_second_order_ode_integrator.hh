@@ -242,6 +242,38 @@ public:
       double const * ER7_UTILS_RESTRICT accel,
       double * ER7_UTILS_RESTRICT velocity,
       double * ER7_UTILS_RESTRICT position);
+
+   /**
+    * Get the order of the embedded fourth order solution.
+    * @return Always returns 4.
+    */
+   virtual unsigned int get_error_order () const
+   {
+      return 4;
+   }
+
+   /**
+    * Estimate the error as the difference between the fifth and fourth
+    * order solutions.
+    * @param[in]  dyn_dt     Integration interval, dynamic time seconds.
+    * @param[out] vel_error  Velocity error estimate.
+    * @param[out] pos_error  Position error estimate.
+    * @return Always returns true.
+    */
+   virtual bool estimate_error (
+      double dyn_dt,
+      double * ER7_UTILS_RESTRICT vel_error,
+      double * ER7_UTILS_RESTRICT pos_error) const;
+
+   /**
+    * Get the position and velocity at the start of the integration cycle.
+    * @param[out] velocity  Generalized velocity vector.
+    * @param[out] position  Generalized position vector.
+    * @return Always returns true.
+    */
+   virtual bool get_initial_state (
+      double * ER7_UTILS_RESTRICT velocity,
+      double * ER7_UTILS_RESTRICT position) const;
 };
 
 
@@ -0,0 +1,250 @@
+/**
+ * @if Er7UtilsUseGroups
+ * @addtogroup Er7Utils
+ * @{
+ * @addtogroup Integration
+ * @{
+ * @endif
+ */
+
+/**
+ * @file
+ * Defines the RKF45 step functions shared by the RKF45 integrators, templated
+ * on the state size.
+ */
+
+/*
+Purpose: ()
+*/
+
+
+#ifndef ER7_UTILS_RKF45_STEPS_HH
+#define ER7_UTILS_RKF45_STEPS_HH
+
+// Interface includes
+#include "er7_utils/interface/include/er7_class.hh"
+
+// Integration includes
+#include "er7_utils/integration/core/include/integ_utils.hh"
+
+// Local includes
+#include "rkf45_butcher_tableau.hh"
+
+
+namespace er7_utils {
+
+/**
+ * RKF45 steps with the state size known at compile time or at run time.
+ * The integrators pick a fixed size for common state sizes and zero for
+ * all others. Both perform the same operations in the same order.
+ */
+namespace rkf45_steps {
+
+/**
+ * Advance state to the target stage of an RKF45 integration cycle.
+ * @tparam fixed_size  State size, or zero if the size is only known at run
+ *                     time. The integ_utils functions are always inlined,
+ *                     so with a fixed size the compiler can unroll and
+ *                     vectorize their loops.
+ * @param[in]     dt            Integration interval step.
+ * @param[in]     target_stage  The stage of the integration process.
+ * @param[in]     state_size    State size, used when fixed_size is zero.
+ * @param[in]     velocity      Time derivative of the state.
+ * @param[in,out] init_state    State at the start of the cycle.
+ * @param[in,out] deriv_hist    Derivatives at each stage of the cycle.
+ * @param[in,out] position      State vector.
+ * @return The step factor.
+ */
+template <unsigned int fixed_size>
+inline double
+rkf45_step (
+   double dt,
+   unsigned int target_stage,
+   unsigned int state_size,
+   const double * ER7_UTILS_RESTRICT velocity,
+   double * ER7_UTILS_RESTRICT init_state,
+   double ** deriv_hist,
+   double * ER7_UTILS_RESTRICT position)
+{
+   const int size = (fixed_size != 0) ? fixed_size : state_size;
+   double step_factor;
+
+   switch (target_stage) {
+
+   // Initial stage (stage 1):
+   // Save initial state and update per RKF45 RKa[1] (one element).
+   case 1:
+      integ_utils::inplace_euler_step_save_both (
+         velocity,
+         RKFehlberg45ButcherTableau::RKa[1][0]*dt, size,
+         init_state, deriv_hist[0], position);
+      step_factor = RKFehlberg45ButcherTableau::RKc[1];
+      break;
+
+   // Intermediate stages (2 to 5):
+   // Update state per RKF45 RKa[target_stage] (target_stage elements).
+   case 2:
+      integ_utils::weighted_step_save_deriv<2> (
+         init_state, velocity,
+         RKFehlberg45ButcherTableau::RKa[2],
+         dt, size,
+         deriv_hist, position);
+      step_factor = RKFehlberg45ButcherTableau::RKc[2];
+      break;
+
+   case 3:
+      integ_utils::weighted_step_save_deriv<3> (
+         init_state, velocity,
+         RKFehlberg45ButcherTableau::RKa[3],
+         dt, size,
+         deriv_hist, position);
+      step_factor = RKFehlberg45ButcherTableau::RKc[3];
+      break;
+
+   case 4:
+      integ_utils::weighted_step_save_deriv<4> (
+         init_state, velocity,
+         RKFehlberg45ButcherTableau::RKa[4],
+         dt, size,
+         deriv_hist, position);
+      step_factor = RKFehlberg45ButcherTableau::RKc[4];
+      break;
+
+   case 5:
+      integ_utils::weighted_step_save_deriv<5> (
+         init_state, velocity,
+         RKFehlberg45ButcherTableau::RKa[5],
+         dt, size,
+         deriv_hist, position);
+      step_factor = RKFehlberg45ButcherTableau::RKc[5];
+      break;
+
+   // Final stage (6):
+   // Update state per RKF45 RKb5 (6 elements).
+   // The last derivative is saved for the error estimate.
+   case 6:
+      integ_utils::weighted_step_save_deriv<6> (
+         init_state, velocity,
+         RKFehlberg45ButcherTableau::RKb5, dt, size,
+         deriv_hist, position);
+      step_factor = RKFehlberg45ButcherTableau::RKc[5];
+      break;
+
+   default:
+      step_factor = 1.0;
+      break;
+   }
+
+   return step_factor;
+}
+
+
+/**
+ * Advance a simple second order ODE to the target stage of an RKF45
+ * integration cycle.
+ * @tparam fixed_size  Position size, or zero if the size is only known at run
+ *                     time. The integ_utils functions are always inlined,
+ *                     so with a fixed size the compiler can unroll and
+ *                     vectorize their loops.
+ * @return The step factor.
+ */
+template <unsigned int fixed_size>
+inline double
+rkf45_simple_step (
+   double dyn_dt,
+   unsigned int target_stage,
+   int state_size,
+   double const * ER7_UTILS_RESTRICT accel,
+   double * ER7_UTILS_RESTRICT init_pos,
+   double * ER7_UTILS_RESTRICT init_vel,
+   double ** posdot_hist,
+   double ** veldot_hist,
+   double * ER7_UTILS_RESTRICT velocity,
+   double * ER7_UTILS_RESTRICT position)
+{
+   const int size = (fixed_size != 0) ? fixed_size : state_size;
+   double step_factor;
+
+   switch (target_stage) {
+
+   // Initial stage (stage 1):
+   // Save initial state and update per RKF45 RKa[1] (one element).
+   case 1:
+      integ_utils::inplace_two_state_euler_step_save_all (
+         accel,
+         RKFehlberg45ButcherTableau::RKa[1][0]*dyn_dt,
+         size,
+         init_pos, init_vel,
+         posdot_hist[0], veldot_hist[0],
+         position, velocity);
+      step_factor = RKFehlberg45ButcherTableau::RKc[1];
+      break;
+
+   // Intermediate stages (2 to 5):
+   // Advance position and velocity per RKF45 RKa[target_stage], saving
+   // velocity and acceleration in the derivatives history buffers.
+   case 2:
+      integ_utils::two_state_weighted_step_save_derivs<2> (
+         init_pos, init_vel, accel,
+         RKFehlberg45ButcherTableau::RKa[2], dyn_dt, size,
+         posdot_hist, veldot_hist, position, velocity);
+      step_factor = RKFehlberg45ButcherTableau::RKc[2];
+      break;
+
+   case 3:
+      integ_utils::two_state_weighted_step_save_derivs<3> (
+         init_pos, init_vel, accel,
+         RKFehlberg45ButcherTableau::RKa[3], dyn_dt, size,
+         posdot_hist, veldot_hist, position, velocity);
+      step_factor = RKFehlberg45ButcherTableau::RKc[3];
+      break;
+
+   case 4:
+      integ_utils::two_state_weighted_step_save_derivs<4> (
+         init_pos, init_vel, accel,
+         RKFehlberg45ButcherTableau::RKa[4], dyn_dt, size,
+         posdot_hist, veldot_hist, position, velocity);
+      step_factor = RKFehlberg45ButcherTableau::RKc[4];
+      break;
+
+   case 5:
+      integ_utils::two_state_weighted_step_save_derivs<5> (
+         init_pos, init_vel, accel,
+         RKFehlberg45ButcherTableau::RKa[5], dyn_dt, size,
+         posdot_hist, veldot_hist, position, velocity);
+      step_factor = RKFehlberg45ButcherTableau::RKc[5];
+      break;
+
+   // Final stage (6):
+   // Update state per RKF45 RKb5 (6 elements).
+   // The last derivatives are saved for the error estimate.
+   case 6:
+      integ_utils::two_state_copy_array (
+         velocity, accel, size, posdot_hist[5], veldot_hist[5]);
+      integ_utils::two_state_weighted_step<6> (
+         init_pos, init_vel, accel, posdot_hist, veldot_hist,
+         RKFehlberg45ButcherTableau::RKb5, dyn_dt, size,
+         position, velocity);
+      step_factor = 1.0;
+      break;
+
+   default:
+      step_factor = 1.0;
+      break;
+   }
+
+   return step_factor;
+}
+
+}
+
+}
+
+
+#endif
+/**
+ * @if Er7UtilsUseGroups
+ * @}
+ * @}
+ * @endif
+ */
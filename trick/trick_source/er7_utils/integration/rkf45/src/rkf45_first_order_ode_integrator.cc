@@ -29,6 +29,7 @@ Purpose: ()
 // Model includes
 #include "../include/rkf45_first_order_ode_integrator.hh"
 #include "../include/rkf45_butcher_tableau.hh"
+#include "../include/rkf45_steps.hh"
 
 
 namespace er7_utils {
@@ -120,75 +121,73 @@ RKFehlberg45FirstOrderODEIntegrator::integrate (
    const double * ER7_UTILS_RESTRICT velocity,
    double * ER7_UTILS_RESTRICT position)
 {
-   double step_factor;
-
-   // Integrate to the next stage
-   switch (target_stage) {
-
-   // Initial stage (stage 1):
-   // Save initial state and update per RKF45 RKa[1] (one element).
-   case 1:
-      integ_utils::inplace_euler_step_save_both (
-         velocity,
-         RKFehlberg45ButcherTableau::RKa[1][0]*dt, state_size,
-         init_state, deriv_hist[0], position);
-      step_factor = RKFehlberg45ButcherTableau::RKc[1];
-      break;
-
-   // Intermediate stages (2 to 5):
-   // Update state per RKF45 RKa[target_stage] (target_stage elements).
-   case 2:
-      integ_utils::weighted_step_save_deriv<2> (
-         init_state, velocity,
-         RKFehlberg45ButcherTableau::RKa[2],
-         dt, state_size,
-         deriv_hist, position);
-      step_factor = RKFehlberg45ButcherTableau::RKc[2];
-      break;
-
+   // State size 3 uses a step with the size known at compile time, the
+   // size where RKF45_steps_bench measures a gain. The operations are the
+   // same as in the general step.
+   switch (state_size) {
    case 3:
-      integ_utils::weighted_step_save_deriv<3> (
-         init_state, velocity,
-         RKFehlberg45ButcherTableau::RKa[3],
-         dt, state_size,
-         deriv_hist, position);
-      step_factor = RKFehlberg45ButcherTableau::RKc[3];
-      break;
-
-   case 4:
-      integ_utils::weighted_step_save_deriv<4> (
-         init_state, velocity,
-         RKFehlberg45ButcherTableau::RKa[4],
-         dt, state_size,
-         deriv_hist, position);
-      step_factor = RKFehlberg45ButcherTableau::RKc[4];
-      break;
-
-   case 5:
-      integ_utils::weighted_step_save_deriv<5> (
-         init_state, velocity,
-         RKFehlberg45ButcherTableau::RKa[5],
-         dt, state_size,
-         deriv_hist, position);
-      step_factor = RKFehlberg45ButcherTableau::RKc[5];
-      break;
-
-   // Final stage (6):
-   // Update state per RKF45 RKb5 (6 elements).
-   case 6:
-      integ_utils::weighted_step<6> (
-         init_state, velocity, deriv_hist,
-         RKFehlberg45ButcherTableau::RKb5, dt, state_size,
-         position);
-      step_factor = RKFehlberg45ButcherTableau::RKc[5];
-      break;
-
+      return rkf45_steps::rkf45_step<3> (
+         dt, target_stage, state_size, velocity,
+         init_state, deriv_hist, position);
    default:
-      step_factor = 1.0;
-      break;
+      return rkf45_steps::rkf45_step<0> (
+         dt, target_stage, state_size, velocity,
+         init_state, deriv_hist, position);
    }
+}
+
+
+// Estimate the error of the fourth order solution.
+bool
+RKFehlberg45FirstOrderODEIntegrator::estimate_error (
+   double dt,
+   double * ER7_UTILS_RESTRICT error)
+const
+{
+   for (unsigned int ii = 0; ii < state_size; ++ii) {
+      double sum = 0.0;
+      for (int jj = 0; jj < 6; ++jj) {
+         sum += (RKFehlberg45ButcherTableau::RKb5[jj] -
+                 RKFehlberg45ButcherTableau::RKb4[jj]) * deriv_hist[jj][ii];
+      }
+      error[ii] = sum * dt;
+   }
+   return true;
+}
+
 
-   return step_factor;
+// Get the state at the start of the integration cycle.
+bool
+RKFehlberg45FirstOrderODEIntegrator::get_initial_state (
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   integ_utils::copy_array (init_state, state_size, position);
+   return true;
+}
+
+
+// Interpolate the state with a cubic Hermite over the integration cycle.
+bool
+RKFehlberg45FirstOrderODEIntegrator::interpolate_state (
+   double dt,
+   double theta,
+   double const * ER7_UTILS_RESTRICT end_state,
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   double theta2 = theta * theta;
+   double theta3 = theta2 * theta;
+   double h_00 = 2.0 * theta3 - 3.0 * theta2 + 1.0;
+   double h_10 = (theta3 - 2.0 * theta2 + theta) * dt;
+   double h_01 = 3.0 * theta2 - 2.0 * theta3;
+   double h_11 = (theta3 - theta2) * dt;
+
+   for (unsigned int ii = 0; ii < state_size; ++ii) {
+      position[ii] = h_00 * init_state[ii] + h_10 * deriv_hist[0][ii] +
+                     h_01 * end_state[ii] + h_11 * deriv_hist[4][ii];
+   }
+   return true;
 }
 
 }
@@ -29,52 +29,12 @@ Purpose: ()
 // Local includes
 #include "../include/rkf45_butcher_tableau.hh"
 #include "../include/rkf45_second_order_ode_integrator.hh"
+#include "../include/rkf45_steps.hh"
 
 
 namespace er7_utils {
 
 
-/**
- * Make a simple Runge Kutta Fehlberg 4/5 intermediate step.
- * @tparam        target_stage  The stage of the integration process
- *                              that the integrator should try to attain.
- * @param[in]     dyn_dt        Dynamic time step, in dynamic time seconds.
- * @param[in]     state_size    The size of the state vectors.
- * @param[in]     init_pos      Initial position.
- * @param[in]     init_vel      Initial velocity.
- * @param[in]     accel         Current acceleration.
- * @param[in,out] veldot_hist   Velocity derivative (acceleration) history.
- * @param[in,out] posdot_hist   Position derivative (velocity) history.
- * @param[in,out] velocity      Generalized velocity vector.
- * @param[in,out] position      Generalized position vector.
- *
- * @return Fractional amount by which time should be advanced.
- */
-template <int target_stage>
-inline double ER7_UTILS_ALWAYS_INLINE
-rkf45_simple_intermediate_step (
-   double dyn_dt,
-   int state_size[2],
-   double const * ER7_UTILS_RESTRICT init_pos,
-   double const * ER7_UTILS_RESTRICT init_vel,
-   double const * ER7_UTILS_RESTRICT accel,
-   double * ER7_UTILS_RESTRICT * ER7_UTILS_RESTRICT veldot_hist,
-   double * ER7_UTILS_RESTRICT * ER7_UTILS_RESTRICT posdot_hist,
-   double * ER7_UTILS_RESTRICT velocity,
-   double * ER7_UTILS_RESTRICT position)
-{
-   // Advance position and velocity per the 'a' element of the Butcher tableau,
-   // saving velocity and acceleration in the derivatives history buffers.
-   integ_utils::two_state_weighted_step_save_derivs<target_stage> (
-      init_pos, init_vel, accel,
-      RKFehlberg45ButcherTableau::RKa[target_stage], dyn_dt, state_size[0],
-      posdot_hist, veldot_hist, position, velocity);
-
-   // Advance time per the 'c' element of the Butcher tableau.
-   return RKFehlberg45ButcherTableau::RKc[target_stage];
-}
-
-
 /**
  * Make a generalized deriv Runge Kutta Fehlberg 4/5 intermediate step.
  * @tparam        target_stage  The stage of the integration process
@@ -367,69 +327,48 @@ RKFehlberg45SimpleSecondOrderODEIntegrator::integrate (
    double * ER7_UTILS_RESTRICT velocity,
    double * ER7_UTILS_RESTRICT position)
 {
-   double step_factor;
-
-   switch (target_stage) {
-
-   // Initial stage (stage 1):
-   // Save initial state and update per RKF45 RKa[1] (one element).
-   case 1:
-      integ_utils::inplace_two_state_euler_step_save_all (
-         accel,
-         RKFehlberg45ButcherTableau::RKa[1][0]*dyn_dt,
-         state_size[0],
-         init_pos, init_vel,
-         posdot_hist[0], veldot_hist[0],
-         position, velocity);
-      step_factor = RKFehlberg45ButcherTableau::RKc[1];
-      break;
-
-   // Intermediate stages (2 to 5):
-   // Update state per RKF45 RKa[target_stage] (target_stage elements).
-   case 2:
-      step_factor =
-         rkf45_simple_intermediate_step<2> (
-            dyn_dt, state_size, init_pos, init_vel, accel,
-            veldot_hist, posdot_hist, velocity, position);
-      break;
-
-   case 3:
-      step_factor =
-         rkf45_simple_intermediate_step<3> (
-            dyn_dt, state_size, init_pos, init_vel, accel,
-            veldot_hist, posdot_hist, velocity, position);
-      break;
-
-   case 4:
-      step_factor =
-         rkf45_simple_intermediate_step<4> (
-            dyn_dt, state_size, init_pos, init_vel, accel,
-            veldot_hist, posdot_hist, velocity, position);
-      break;
-
-   case 5:
-      step_factor =
-         rkf45_simple_intermediate_step<5> (
-            dyn_dt, state_size, init_pos, init_vel, accel,
-            veldot_hist, posdot_hist, velocity, position);
-      break;
+   // No position size gains from a step with the size known at compile
+   // time in RKF45_steps_bench, so all sizes use the general step.
+   return rkf45_steps::rkf45_simple_step<0> (
+      dyn_dt, target_stage, state_size[0], accel, init_pos, init_vel,
+      posdot_hist, veldot_hist, velocity, position);
+}
 
-   // Final stage (6):
-   // Update state per RKF45 RKb5 (6 elements).
-   case 6:
-      integ_utils::two_state_weighted_step<6> (
-         init_pos, init_vel, accel, posdot_hist, veldot_hist,
-         RKFehlberg45ButcherTableau::RKb5, dyn_dt, state_size[0],
-         position, velocity);
-      step_factor = 1.0;
-      break;
 
-   default:
-      step_factor = 1.0;
-      break;
+// Estimate the error of the fourth order solution.
+bool
+RKFehlberg45SimpleSecondOrderODEIntegrator::estimate_error (
+   double dyn_dt,
+   double * ER7_UTILS_RESTRICT vel_error,
+   double * ER7_UTILS_RESTRICT pos_error)
+const
+{
+   for (int ii = 0; ii < state_size[0]; ++ii) {
+      double pos_sum = 0.0;
+      double vel_sum = 0.0;
+      for (int jj = 0; jj < 6; ++jj) {
+         double weight = RKFehlberg45ButcherTableau::RKb5[jj] -
+                         RKFehlberg45ButcherTableau::RKb4[jj];
+         pos_sum += weight * posdot_hist[jj][ii];
+         vel_sum += weight * veldot_hist[jj][ii];
+      }
+      pos_error[ii] = pos_sum * dyn_dt;
+      vel_error[ii] = vel_sum * dyn_dt;
    }
+   return true;
+}
 
-   return step_factor;
+
+// Get the position and velocity at the start of the integration cycle.
+bool
+RKFehlberg45SimpleSecondOrderODEIntegrator::get_initial_state (
+   double * ER7_UTILS_RESTRICT velocity,
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   integ_utils::two_state_copy_array (
+      init_pos, init_vel, state_size[0], position, velocity);
+   return true;
 }
 
 
@@ -242,6 +242,37 @@ public:
       double const * ER7_UTILS_RESTRICT accel,
       double * ER7_UTILS_RESTRICT velocity,
       double * ER7_UTILS_RESTRICT position);
+
+   /**
+    * Get the order of the embedded seventh order solution.
+    * @return 7 when built with RKFEHLBERG78_USE_STEP_10, otherwise 0:
+    *         the abbreviated tableau does not compute the stage that only
+    *         the seventh order solution needs.
+    */
+   virtual unsigned int get_error_order () const;
+
+   /**
+    * Estimate the error as the difference between the eighth and seventh
+    * order solutions.
+    * @param[in]  dyn_dt     Dynamic time step, in dynamic time seconds.
+    * @param[out] vel_error  Velocity error estimate.
+    * @param[out] pos_error  Position error estimate.
+    * @return True if the error was estimated, see get_error_order.
+    */
+   virtual bool estimate_error (
+      double dyn_dt,
+      double * ER7_UTILS_RESTRICT vel_error,
+      double * ER7_UTILS_RESTRICT pos_error) const;
+
+   /**
+    * Get the position and velocity at the start of the integration cycle.
+    * @param[out] velocity  Generalized velocity vector.
+    * @param[out] position  Generalized position vector.
+    * @return Always returns true.
+    */
+   virtual bool get_initial_state (
+      double * ER7_UTILS_RESTRICT velocity,
+      double * ER7_UTILS_RESTRICT position) const;
 };
 
 
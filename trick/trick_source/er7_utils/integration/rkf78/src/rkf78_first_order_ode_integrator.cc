@@ -252,11 +252,12 @@ RKFehlberg78FirstOrderODEIntegrator::integrate (
 
    // Final stage (13):
    // Update state per RKF78 RKb8 (13 elements).
+   // The last derivative is saved for the error estimate.
    case 13:
-      integ_utils::weighted_step<13> (
-         init_state, velocity, deriv_hist,
+      integ_utils::weighted_step_save_deriv<13> (
+         init_state, velocity,
          RKF78_BUTCHER_TABLEAU::RKb8, dt, state_size,
-         position);
+         deriv_hist, position);
       step_factor = 1.0;
       break;
 
@@ -268,6 +269,76 @@ RKFehlberg78FirstOrderODEIntegrator::integrate (
    return step_factor;
 }
 
+
+// Get the order of the error estimate.
+unsigned int
+RKFehlberg78FirstOrderODEIntegrator::get_error_order ()
+const
+{
+#ifdef RKFEHLBERG78_USE_STEP_10
+   return 7;
+#else
+   return 0;
+#endif
+}
+
+
+// Estimate the error of the seventh order solution.
+bool
+RKFehlberg78FirstOrderODEIntegrator::estimate_error (
+   double dt ER7_UTILS_UNUSED,
+   double * ER7_UTILS_RESTRICT error ER7_UTILS_UNUSED)
+const
+{
+#ifdef RKFEHLBERG78_USE_STEP_10
+   // The eighth and seventh order weights differ only in the first and
+   // the last three stages.
+   double scale = 41.0/840.0 * dt;
+   for (unsigned int ii = 0; ii < state_size; ++ii) {
+      error[ii] = scale * (deriv_hist[11][ii] + deriv_hist[12][ii] -
+                           deriv_hist[0][ii] - deriv_hist[10][ii]);
+   }
+   return true;
+#else
+   return false;
+#endif
+}
+
+
+// Get the state at the start of the integration cycle.
+bool
+RKFehlberg78FirstOrderODEIntegrator::get_initial_state (
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   integ_utils::copy_array (init_state, state_size, position);
+   return true;
+}
+
+
+// Interpolate the state with a cubic Hermite over the integration cycle.
+bool
+RKFehlberg78FirstOrderODEIntegrator::interpolate_state (
+   double dt,
+   double theta,
+   double const * ER7_UTILS_RESTRICT end_state,
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   double theta2 = theta * theta;
+   double theta3 = theta2 * theta;
+   double h_00 = 2.0 * theta3 - 3.0 * theta2 + 1.0;
+   double h_10 = (theta3 - 2.0 * theta2 + theta) * dt;
+   double h_01 = 3.0 * theta2 - 2.0 * theta3;
+   double h_11 = (theta3 - theta2) * dt;
+
+   for (unsigned int ii = 0; ii < state_size; ++ii) {
+      position[ii] = h_00 * init_state[ii] + h_10 * deriv_hist[0][ii] +
+                     h_01 * end_state[ii] + h_11 * deriv_hist[12][ii];
+   }
+   return true;
+}
+
 }
 /**
  * @if Er7UtilsUseGroups
@@ -479,7 +479,11 @@ RKFehlberg78SimpleSecondOrderODEIntegrator::integrate (
 
    // Final stage (13):
    // Update state per RKF78 RKb5 (13 elements).
+   // The last derivatives are saved for the error estimate.
    case 13:
+      integ_utils::two_state_copy_array (
+         velocity, accel, state_size[0],
+         posdot_hist[12], veldot_hist[12]);
       integ_utils::two_state_weighted_step<13> (
          init_pos, init_vel, accel, posdot_hist, veldot_hist,
          RKF78_BUTCHER_TABLEAU::RKb8, dyn_dt, state_size[0],
@@ -496,6 +500,57 @@ RKFehlberg78SimpleSecondOrderODEIntegrator::integrate (
 }
 
 
+// Get the order of the error estimate.
+unsigned int
+RKFehlberg78SimpleSecondOrderODEIntegrator::get_error_order ()
+const
+{
+#ifdef RKFEHLBERG78_USE_STEP_10
+   return 7;
+#else
+   return 0;
+#endif
+}
+
+
+// Estimate the error of the seventh order solution.
+bool
+RKFehlberg78SimpleSecondOrderODEIntegrator::estimate_error (
+   double dyn_dt ER7_UTILS_UNUSED,
+   double * ER7_UTILS_RESTRICT vel_error ER7_UTILS_UNUSED,
+   double * ER7_UTILS_RESTRICT pos_error ER7_UTILS_UNUSED)
+const
+{
+#ifdef RKFEHLBERG78_USE_STEP_10
+   // The eighth and seventh order weights differ only in the first and
+   // the last three stages.
+   double scale = 41.0/840.0 * dyn_dt;
+   for (int ii = 0; ii < state_size[0]; ++ii) {
+      pos_error[ii] = scale * (posdot_hist[11][ii] + posdot_hist[12][ii] -
+                               posdot_hist[0][ii] - posdot_hist[10][ii]);
+      vel_error[ii] = scale * (veldot_hist[11][ii] + veldot_hist[12][ii] -
+                               veldot_hist[0][ii] - veldot_hist[10][ii]);
+   }
+   return true;
+#else
+   return false;
+#endif
+}
+
+
+// Get the position and velocity at the start of the integration cycle.
+bool
+RKFehlberg78SimpleSecondOrderODEIntegrator::get_initial_state (
+   double * ER7_UTILS_RESTRICT velocity,
+   double * ER7_UTILS_RESTRICT position)
+const
+{
+   integ_utils::two_state_copy_array (
+      init_pos, init_vel, state_size[0], position, velocity);
+   return true;
+}
+
+
 // Propagate state for the general case of the generalized position derivative
 // being a function of generalized position and generalized velocity.
 IntegratorResult
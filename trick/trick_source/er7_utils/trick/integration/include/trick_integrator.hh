@@ -131,9 +131,20 @@ public:
 
       integ_mode = UseFirstOrderIntegrator;
 
-      return integ_controls->integrate (
-                time_0, dt,
-                *this, *this, *this);
+      int rc = integ_controls->integrate (
+                  time_0, dt,
+                  *this, *this, *this);
+
+      // Keep the end state for interpolate_state, the caller may overwrite
+      // it with an interpolated state.
+      if ((rc == 0) && (state_in_out != state)) {
+         for (int ii = 0; ii < num_state; ++ii) {
+            state[ii] = state_in_out[ii];
+            record_dense_addr (ii, &state_in_out[ii]);
+         }
+      }
+
+      return rc;
    }
 
 
@@ -159,12 +170,59 @@ public:
 
       integ_mode = UseSecondOrderIntegrator;
 
+      // The second order integrators have no dense output.
+      num_dense_addr = 0;
+
       return integ_controls->integrate (
                 time_0, dt,
                 *this, *this, *this);
    }
 
 
+   /**
+    * Get the order of the embedded error estimate of the active integrator.
+    * @return Order of the lower order solution, 0 if there is none.
+    */
+   virtual int get_error_order ();
+
+   /**
+    * Estimate the error of the step just completed.
+    * For a second order problem the positions precede the velocities
+    * in both outputs, as in the Trick::Integrator state.
+    * @param[out] error_out  Error estimate of each state element.
+    * @param[out] state_out  State at the end of the step.
+    * @return 0 on success, 1 if the integrator has no error estimate.
+    */
+   virtual int estimate_error (
+      double * error_out,
+      double * state_out);
+
+   /**
+    * Write the state at the start of the step just completed back to the
+    * model states.
+    * @return 0 on success, 1 if the state cannot be restored.
+    */
+   virtual int restore_start_state ();
+
+
+   /**
+    * Indicates whether the active integrator can interpolate the state.
+    * Only the first order integrators of RK4, RKF45 and RKF78 can.
+    * @return True if interpolate_state is implemented.
+    */
+   virtual bool has_dense_output ();
+
+   /**
+    * Interpolate the state over the step just completed.
+    * @param[in]  theta      Fraction of the step, 0 at its start, 1 at its end.
+    * @param[out] state_out  State at time_0 + theta * dt.
+    * @return 0 on success, 1 if the state cannot be interpolated.
+    */
+   virtual int interpolate_state (
+      double theta,
+      double * state_out);
+
+
 protected:
 
    // Constructors.
@@ -360,6 +360,123 @@ TrickIntegrator::integrate_bodies (
    }
 }
 
+
+
+// Get the order of the error estimate of the active integrator.
+int
+TrickIntegrator::get_error_order (
+   void)
+{
+   switch (integ_mode) {
+   case UseFirstOrderIntegrator :
+      return first_order_integrator->get_error_order ();
+   case UseSecondOrderIntegrator :
+      return second_order_integrator->get_error_order ();
+   case InvalidIntegrationMode :
+   default :
+      return 0;
+   }
+}
+
+
+// Estimate the error of the step just completed.
+int
+TrickIntegrator::estimate_error (
+   double * error_out,
+   double * state_out)
+{
+   switch (integ_mode) {
+   case UseFirstOrderIntegrator :
+      if (! first_order_integrator->estimate_error (dt, error_out)) {
+         return 1;
+      }
+      for (int ii = 0; ii < num_state; ++ii) {
+         state_out[ii] = cached_state[ii];
+      }
+      return 0;
+
+   case UseSecondOrderIntegrator :
+      if (! second_order_integrator->estimate_error (
+               dt, error_out + half_state_size, error_out)) {
+         return 1;
+      }
+      for (int ii = 0; ii < half_state_size; ++ii) {
+         state_out[ii] = cached_position[ii];
+         state_out[ii+half_state_size] = cached_velocity[ii];
+      }
+      return 0;
+
+   case InvalidIntegrationMode :
+   default :
+      return 1;
+   }
+}
+
+
+// Write the state at the start of the last step back to the model states.
+int
+TrickIntegrator::restore_start_state (
+   void)
+{
+   // The integrate() interface propagates the internal state, which only
+   // reaches the model through the addresses recorded by state_out().
+   bool via_state = false;
+
+   switch (integ_mode) {
+   case UseFirstOrderIntegrator :
+      first_order_integrator->get_initial_state (cached_state);
+      via_state = (cached_state == state);
+      break;
+
+   case UseSecondOrderIntegrator :
+      second_order_integrator->get_initial_state (
+         cached_velocity, cached_position);
+      via_state = (cached_position == state);
+      break;
+
+   case InvalidIntegrationMode :
+   default :
+      return 1;
+   }
+
+   if (via_state) {
+      if (num_dense_addr != num_state) {
+         return 1;
+      }
+      for (int ii = 0; ii < num_state; ++ii) {
+         *dense_addr[ii] = state[ii];
+      }
+   }
+   return 0;
+}
+
+
+// Whether the active integrator can interpolate the state.
+bool
+TrickIntegrator::has_dense_output (
+   void)
+{
+   return (integ_mode != UseSecondOrderIntegrator) &&
+          (first_order_integrator != NULL) &&
+          first_order_integrator->has_dense_output ();
+}
+
+
+// Interpolate the state over the last step.
+int
+TrickIntegrator::interpolate_state (
+   double theta,
+   double * state_out)
+{
+   // The end state of a step is always in state, see integrate_1st_order_ode.
+   if ((integ_mode != UseFirstOrderIntegrator) ||
+       ! first_order_integrator->interpolate_state (
+            dt, theta, state, state_out)) {
+      return 1;
+   }
+   return 0;
+}
+
 }
 /**
  * @if Er7UtilsUseGroups
@@ -0,0 +1,653 @@
+/*
+PURPOSE:
+    (Number to text conversion shared by the ascii data recording format and the variable server.)
+*/
+
+/*
+ * Floating point numbers are converted with the Grisu algorithms of Florian Loitsch, "Printing
+ * Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010.  The shortest digits come
+ * from Grisu2, which always reads back to the same value and is the shortest possible in nearly all
+ * cases.  Digits for a printf precision come from Grisu's counted mode, which gives up on the rare
+ * values too close to a rounding boundary to decide with 64 bit integers.  Those values go to snprintf.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "trick/AsciiFormat.hh"
+
+namespace {
+
+/* A 64 bit significand and binary exponent, f * 2^e */
+struct DiyFp {
+    uint64_t f ;
+    int e ;
+    DiyFp( uint64_t in_f , int in_e ) : f(in_f) , e(in_e) {}
+} ;
+
+/* Returns x * y rounded to the upper 64 bits of the product */
+DiyFp multiply( const DiyFp & x , const DiyFp & y ) {
+    const uint64_t x_lo = x.f & 0xFFFFFFFFu ;
+    const uint64_t x_hi = x.f >> 32 ;
+    const uint64_t y_lo = y.f & 0xFFFFFFFFu ;
+    const uint64_t y_hi = y.f >> 32 ;
+
+    const uint64_t p0 = x_lo * y_lo ;
+    const uint64_t p1 = x_lo * y_hi ;
+    const uint64_t p2 = x_hi * y_lo ;
+    const uint64_t p3 = x_hi * y_hi ;
+
+    uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu) ;
+    /* round */
+    mid += uint64_t(1) << 31 ;
+
+    return DiyFp( p3 + (p2 >> 32) + (p1 >> 32) + (mid >> 32) , x.e + y.e + 64 ) ;
+}
+
+DiyFp normalize( DiyFp x ) {
+    while ( (x.f >> 63) == 0 ) {
+        x.f <<= 1 ;
+        x.e-- ;
+    }
+    return x ;
+}
+
+/* The value and the midpoints to its neighbors.  Any number strictly between the midpoints reads back
+   to the value. */
+struct Boundaries {
+    DiyFp w ;
+    DiyFp minus ;
+    DiyFp plus ;
+    Boundaries( DiyFp in_w , DiyFp in_minus , DiyFp in_plus ) : w(in_w) , minus(in_minus) , plus(in_plus) {}
+} ;
+
+/* bits is the IEEE representation of a positive finite value with significand_bits stored significand bits */
+Boundaries compute_boundaries( uint64_t bits , int significand_bits , int exponent_bias ) {
+    const uint64_t hidden_bit = uint64_t(1) << significand_bits ;
+    const int biased_e = (int)(bits >> significand_bits) ;
+    const uint64_t fraction = bits & (hidden_bit - 1) ;
+    const int min_e = 1 - exponent_bias - significand_bits ;
+
+    DiyFp v = ( biased_e == 0 ) ? DiyFp(fraction, min_e) :
+     DiyFp(fraction + hidden_bit, biased_e - exponent_bias - significand_bits) ;
+
+    /* the gap below a power of 2 is half the gap above it */
+    const bool lower_is_closer = ( fraction == 0 and biased_e > 1 ) ;
+    DiyFp plus = normalize(DiyFp(2 * v.f + 1, v.e - 1)) ;
+    DiyFp minus = lower_is_closer ? DiyFp(4 * v.f - 1, v.e - 2) : DiyFp(2 * v.f - 1, v.e - 1) ;
+    minus.f <<= minus.e - plus.e ;
+    minus.e = plus.e ;
+
+    return Boundaries( normalize(v) , minus , plus ) ;
+}
+
+/* Normalized, rounded 10^k for k = -300, -292, ..., 324 */
+struct CachedPower {
+    uint64_t f ;
+    int e ;
+    int k ;
+} ;
+
+const int cached_powers_min_k = -300 ;
+const int cached_powers_step = 8 ;
+
+const CachedPower cached_powers[] = {
+        { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+        { 0xBE5691EF416BD60CULL, -1007, -284 },
+        { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+        { 0xD3515C2831559A83ULL,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+        { 0xEA9C227723EE8BCBULL,  -901, -252 },
+        { 0xAECC49914078536DULL,  -874, -244 },
+        { 0x823C12795DB6CE57ULL,  -847, -236 },
+        { 0xC21094364DFB5637ULL,  -821, -228 },
+        { 0x9096EA6F3848984FULL,  -794, -220 },
+        { 0xD77485CB25823AC7ULL,  -768, -212 },
+        { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+        { 0xEF340A98172AACE5ULL,  -715, -196 },
+        { 0xB23867FB2A35B28EULL,  -688, -188 },
+        { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+        { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+        { 0x936B9FCEBB25C996ULL,  -608, -164 },
+        { 0xDBAC6C247D62A584ULL,  -582, -156 },
+        { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+        { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+        { 0x87625F056C7C4A8BULL,  -475, -124 },
+        { 0xC9BCFF6034C13053ULL,  -449, -116 },
+        { 0x964E858C91BA2655ULL,  -422, -108 },
+        { 0xDFF9772470297EBDULL,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+        { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+        { 0xB94470938FA89BCFULL,  -316,  -76 },
+        { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+        { 0xCDB02555653131B6ULL,  -263,  -60 },
+        { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+        { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+        { 0xAA242499697392D3ULL,  -183,  -36 },
+        { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+        { 0xBCE5086492111AEBULL,  -130,  -20 },
+        { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+        { 0xD1B71758E219652CULL,   -77,   -4 },
+        { 0x9C40000000000000ULL,   -50,    4 },
+        { 0xE8D4A51000000000ULL,   -24,   12 },
+        { 0xAD78EBC5AC620000ULL,     3,   20 },
+        { 0x813F3978F8940984ULL,    30,   28 },
+        { 0xC097CE7BC90715B3ULL,    56,   36 },
+        { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+        { 0xD5D238A4ABE98068ULL,   109,   52 },
+        { 0x9F4F2726179A2245ULL,   136,   60 },
+        { 0xED63A231D4C4FB27ULL,   162,   68 },
+        { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+        { 0x83C7088E1AAB65DBULL,   216,   84 },
+        { 0xC45D1DF942711D9AULL,   242,   92 },
+        { 0x924D692CA61BE758ULL,   269,  100 },
+        { 0xDA01EE641A708DEAULL,   295,  108 },
+        { 0xA26DA3999AEF774AULL,   322,  116 },
+        { 0xF209787BB47D6B85ULL,   348,  124 },
+        { 0xB454E4A179DD1877ULL,   375,  132 },
+        { 0x865B86925B9BC5C2ULL,   402,  140 },
+        { 0xC83553C5C8965D3DULL,   428,  148 },
+        { 0x952AB45CFA97A0B3ULL,   455,  156 },
+        { 0xDE469FBD99A05FE3ULL,   481,  164 },
+        { 0xA59BC234DB398C25ULL,   508,  172 },
+        { 0xF6C69A72A3989F5CULL,   534,  180 },
+        { 0xB7DCBF5354E9BECEULL,   561,  188 },
+        { 0x88FCF317F22241E2ULL,   588,  196 },
+        { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+        { 0x98165AF37B2153DFULL,   641,  212 },
+        { 0xE2A0B5DC971F303AULL,   667,  220 },
+        { 0xA8D9D1535CE3B396ULL,   694,  228 },
+        { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+        { 0xBB764C4CA7A44410ULL,   747,  244 },
+        { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+        { 0xD01FEF10A657842CULL,   800,  260 },
+        { 0x9B10A4E5E9913129ULL,   827,  268 },
+        { 0xE7109BFBA19C0C9DULL,   853,  276 },
+        { 0xAC2820D9623BF429ULL,   880,  284 },
+        { 0x80444B5E7AA7CF85ULL,   907,  292 },
+        { 0xBF21E44003ACDD2DULL,   933,  300 },
+        { 0x8E679C2F5E44FF8FULL,   960,  308 },
+        { 0xD433179D9C8CB841ULL,   986,  316 },
+        { 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+} ;
+
+/* The scaled value has a binary exponent between these two, so its integer part fits in 32 bits and the
+   fraction has room for one more decimal digit. */
+const int min_target_exponent = -60 ;
+const int max_target_exponent = -32 ;
+
+/* Returns the cached 10^k that brings a value with binary exponent e into the target exponent range */
+const CachedPower & cached_power_for( int e ) {
+    /* 78913 / 2^18 is a little more than log10(2) */
+    const int f = min_target_exponent - e - 1 ;
+    const int k = (f * 78913) / (1 << 18) + (f > 0) ;
+    const int index = (-cached_powers_min_k + k + (cached_powers_step - 1)) / cached_powers_step ;
+    return cached_powers[index] ;
+}
+
+/* Returns the number of decimal digits in n and sets pow10 to 10^(digits - 1) */
+int largest_pow10( uint32_t n , uint32_t & pow10 ) {
+    static const uint32_t powers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+     1000000000 } ;
+    int digits = 10 ;
+    while ( digits > 1 and n < powers[digits - 1] ) {
+        digits-- ;
+    }
+    pow10 = powers[digits - 1] ;
+    return digits ;
+}
+
+/* Moves the last digit down while the result stays inside the boundaries and gets closer to the value */
+void grisu2_round( char * digits , int len , uint64_t dist , uint64_t delta , uint64_t rest , uint64_t ten_k ) {
+    while ( rest < dist and delta - rest >= ten_k and
+     ( rest + ten_k < dist or dist - rest > rest + ten_k - dist ) ) {
+        digits[len - 1]-- ;
+        rest += ten_k ;
+    }
+}
+
+/* Generates the shortest digits of a number between minus and plus, w being the value itself */
+int grisu2_digit_gen( char * digits , int & decimal_exponent , DiyFp minus , DiyFp w , DiyFp plus ) {
+    uint64_t delta = plus.f - minus.f ;
+    uint64_t dist = plus.f - w.f ;
+    const DiyFp one( uint64_t(1) << -plus.e , plus.e ) ;
+
+    uint32_t integral = (uint32_t)(plus.f >> -one.e) ;
+    uint64_t fraction = plus.f & (one.f - 1) ;
+    uint32_t pow10 ;
+    int n = largest_pow10(integral, pow10) ;
+    int len = 0 ;
+
+    while ( n > 0 ) {
+        digits[len++] = (char)('0' + integral / pow10) ;
+        integral %= pow10 ;
+        n-- ;
+        uint64_t rest = ((uint64_t)integral << -one.e) + fraction ;
+        if ( rest <= delta ) {
+            decimal_exponent += n ;
+            grisu2_round(digits, len, dist, delta, rest, (uint64_t)pow10 << -one.e) ;
+            return len ;
+        }
+        pow10 /= 10 ;
+    }
+
+    int m = 0 ;
+    for (;;) {
+        fraction *= 10 ;
+        digits[len++] = (char)('0' + (fraction >> -one.e)) ;
+        fraction &= one.f - 1 ;
+        m++ ;
+        delta *= 10 ;
+        dist *= 10 ;
+        if ( fraction <= delta ) {
+            break ;
+        }
+    }
+    decimal_exponent -= m ;
+    grisu2_round(digits, len, dist, delta, fraction, one.f) ;
+    return len ;
+}
+
+int grisu2( const Boundaries & b , char * digits , int & decimal_exponent ) {
+    const CachedPower & cached = cached_power_for(b.plus.e) ;
+    const DiyFp c( cached.f , cached.e ) ;
+
+    DiyFp w = multiply(b.w, c) ;
+    DiyFp minus = multiply(b.minus, c) ;
+    DiyFp plus = multiply(b.plus, c) ;
+
+    /* shrink the interval by the error of the multiplications */
+    minus.f++ ;
+    plus.f-- ;
+
+    decimal_exponent = -cached.k ;
+    return grisu2_digit_gen(digits, decimal_exponent, minus, w, plus) ;
+}
+
+/* Rounds the generated digits given the remainder rest of 10^kappa, with an error of unit.  Returns false
+   if the error is too large to know which way to round. */
+bool round_counted( char * digits , int len , uint64_t rest , uint64_t ten_kappa , uint64_t unit , int & kappa ) {
+    if ( unit >= ten_kappa or ten_kappa - unit <= unit ) {
+        return false ;
+    }
+    /* 2 * (rest + unit) <= 10^kappa: round down */
+    if ( ten_kappa - rest > rest and ten_kappa - 2 * rest >= 2 * unit ) {
+        return true ;
+    }
+    /* 2 * (rest - unit) >= 10^kappa: round up */
+    if ( rest > unit and ten_kappa - (rest - unit) <= (rest - unit) ) {
+        digits[len - 1]++ ;
+        for ( int ii = len - 1 ; ii > 0 ; ii-- ) {
+            if ( digits[ii] != '0' + 10 ) {
+                break ;
+            }
+            digits[ii] = '0' ;
+            digits[ii - 1]++ ;
+        }
+        if ( digits[0] == '0' + 10 ) {
+            digits[0] = '1' ;
+            kappa++ ;
+        }
+        return true ;
+    }
+    return false ;
+}
+
+const char digit_pairs[] =
+ "00010203040506070809"
+ "10111213141516171819"
+ "20212223242526272829"
+ "30313233343536373839"
+ "40414243444546474849"
+ "50515253545556575859"
+ "60616263646566676869"
+ "70717273747576777879"
+ "80818283848586878889"
+ "90919293949596979899" ;
+
+/* Writes value backwards ending just before end.  Returns the first character. */
+char * write_uint_backwards( unsigned long long value , char * end ) {
+    while ( value >= 100 ) {
+        unsigned int pair = (unsigned int)(value % 100) * 2 ;
+        value /= 100 ;
+        *--end = digit_pairs[pair + 1] ;
+        *--end = digit_pairs[pair] ;
+    }
+    if ( value >= 10 ) {
+        unsigned int pair = (unsigned int)value * 2 ;
+        *--end = digit_pairs[pair + 1] ;
+        *--end = digit_pairs[pair] ;
+    } else {
+        *--end = (char)('0' + value) ;
+    }
+    return end ;
+}
+
+/* Writes the digits in the style of printf %g with the given precision, without padding.  out must hold
+   at least 32 characters.  Returns the number of characters written. */
+int write_general( char * out , bool negative , const char * digits , int len , int decimal_exponent , int precision ) {
+    char * p = out ;
+
+    /* %g drops trailing zeros */
+    while ( len > 1 and digits[len - 1] == '0' ) {
+        len-- ;
+        decimal_exponent++ ;
+    }
+    /* exponent of the first digit */
+    const int x = len + decimal_exponent - 1 ;
+
+    if ( negative ) {
+        *p++ = '-' ;
+    }
+    if ( x < -4 or x >= precision ) {
+        *p++ = digits[0] ;
+        if ( len > 1 ) {
+            *p++ = '.' ;
+            memcpy(p, digits + 1, len - 1) ;
+            p += len - 1 ;
+        }
+        *p++ = 'e' ;
+        int exponent = x ;
+        if ( exponent < 0 ) {
+            *p++ = '-' ;
+            exponent = -exponent ;
+        } else {
+            *p++ = '+' ;
+        }
+        if ( exponent < 10 ) {
+            *p++ = '0' ;
+            *p++ = (char)('0' + exponent) ;
+        } else {
+            char buf[4] ;
+            char * start = write_uint_backwards(exponent, buf + 4) ;
+            memcpy(p, start, buf + 4 - start) ;
+            p += buf + 4 - start ;
+        }
+    } else if ( x < 0 ) {
+        *p++ = '0' ;
+        *p++ = '.' ;
+        for ( int ii = x + 1 ; ii < 0 ; ii++ ) {
+            *p++ = '0' ;
+        }
+        memcpy(p, digits, len) ;
+        p += len ;
+    } else if ( x >= len - 1 ) {
+        memcpy(p, digits, len) ;
+        p += len ;
+        for ( int ii = len - 1 ; ii < x ; ii++ ) {
+            *p++ = '0' ;
+        }
+    } else {
+        memcpy(p, digits, x + 1) ;
+        p += x + 1 ;
+        *p++ = '.' ;
+        memcpy(p, digits + x + 1, len - x - 1) ;
+        p += len - x - 1 ;
+    }
+    return (int)(p - out) ;
+}
+
+}
+
+int Trick::shortest_digits( double value , char * digits , int & decimal_exponent ) {
+    uint64_t bits ;
+    memcpy(&bits, &value, sizeof(bits)) ;
+    return grisu2(compute_boundaries(bits, 52, 1023), digits, decimal_exponent) ;
+}
+
+int Trick::shortest_digits( float value , char * digits , int & decimal_exponent ) {
+    uint32_t bits ;
+    memcpy(&bits, &value, sizeof(bits)) ;
+    return grisu2(compute_boundaries(bits, 23, 127), digits, decimal_exponent) ;
+}
+
+int Trick::precision_digits( double value , int precision , char * digits , int & decimal_exponent ) {
+    uint64_t bits ;
+    memcpy(&bits, &value, sizeof(bits)) ;
+
+    const int biased_e = (int)(bits >> 52) ;
+    const uint64_t fraction = bits & ((uint64_t(1) << 52) - 1) ;
+    const DiyFp v = normalize( ( biased_e == 0 ) ? DiyFp(fraction, -1074) :
+     DiyFp(fraction + (uint64_t(1) << 52), biased_e - 1075) ) ;
+
+    const CachedPower & cached = cached_power_for(v.e) ;
+    const DiyFp w = multiply(v, DiyFp(cached.f, cached.e)) ;
+
+    /* w is within 1 unit of the exact product */
+    uint64_t unit = 1 ;
+    const DiyFp one( uint64_t(1) << -w.e , w.e ) ;
+    uint32_t integral = (uint32_t)(w.f >> -one.e) ;
+    uint64_t rest = w.f & (one.f - 1) ;
+    uint32_t pow10 ;
+    int kappa = largest_pow10(integral, pow10) ;
+    int len = 0 ;
+    bool ok ;
+
+    while ( kappa > 0 ) {
+        digits[len++] = (char)('0' + integral / pow10) ;
+        integral %= pow10 ;
+        kappa-- ;
+        if ( len == precision ) {
+            break ;
+        }
+        pow10 /= 10 ;
+    }
+    if ( len == precision ) {
+        ok = round_counted(digits, len, ((uint64_t)integral << -one.e) + rest, (uint64_t)pow10 << -one.e, unit, kappa) ;
+    } else {
+        while ( len < precision and rest > unit ) {
+            rest *= 10 ;
+            unit *= 10 ;
+            digits[len++] = (char)('0' + (rest >> -one.e)) ;
+            rest &= one.f - 1 ;
+            kappa-- ;
+        }
+        ok = ( len == precision ) and round_counted(digits, len, rest, one.f, unit, kappa) ;
+    }
+    if ( ! ok ) {
+        return 0 ;
+    }
+    decimal_exponent = kappa - cached.k ;
+    return len ;
+}
+
+Trick::AsciiFloatFormat::AsciiFloatFormat() : round_trip(false) {
+    set_format("%g") ;
+}
+
+Trick::AsciiFloatFormat::AsciiFloatFormat( const std::string & in_format ) : round_trip(false) {
+    set_format(in_format) ;
+}
+
+/**
+@details
+-# Save the format
+-# The format is converted without snprintf if it is '%', any number of '-' flags, an optional width,
+   an optional precision of at most 17, and a 'g' conversion, with nothing before or after it.
+   The printf rules for a missing or zero precision apply.
+*/
+int Trick::AsciiFloatFormat::set_format( const std::string & in_format ) {
+    const char * p = in_format.c_str() ;
+
+    format = in_format ;
+    fast = false ;
+    width = 0 ;
+    precision = 6 ;
+    left_justify = false ;
+
+    if ( *p++ != '%' ) {
+        return 0 ;
+    }
+    while ( *p == '-' ) {
+        left_justify = true ;
+        p++ ;
+    }
+    while ( *p >= '0' and *p <= '9' and width < 1000 ) {
+        /* a leading 0 would be the zero padding flag */
+        if ( *p == '0' and width == 0 ) {
+            return 0 ;
+        }
+        width = width * 10 + (*p++ - '0') ;
+    }
+    if ( *p == '.' ) {
+        p++ ;
+        precision = 0 ;
+        while ( *p >= '0' and *p <= '9' and precision < 1000 ) {
+            precision = precision * 10 + (*p++ - '0') ;
+        }
+        if ( precision == 0 ) {
+            precision = 1 ;
+        }
+    }
+    fast = ( p[0] == 'g' and p[1] == '\0' and precision <= 17 and width < 1000 ) ;
+    return 0 ;
+}
+
+int Trick::AsciiFloatFormat::set_round_trip( bool in_round_trip ) {
+    round_trip = in_round_trip ;
+    return 0 ;
+}
+
+Trick::AsciiRow::AsciiRow( char * in_buffer , size_t in_capacity ) :
+ buffer(in_buffer) ,
+ capacity(in_capacity) ,
+ len(0) ,
+ overflowed(false) {}
+
+bool Trick::AsciiRow::terminate() {
+    if ( len < capacity ) {
+        buffer[len] = '\0' ;
+        return true ;
+    }
+    overflowed = true ;
+    return false ;
+}
+
+void Trick::AsciiRow::append( const char * str , size_t str_len ) {
+    if ( capacity - len >= str_len ) {
+        memcpy(buffer + len, str, str_len) ;
+        len += str_len ;
+    } else {
+        overflowed = true ;
+    }
+}
+
+void Trick::AsciiRow::append( const char * str ) {
+    append(str, strlen(str)) ;
+}
+
+void Trick::AsciiRow::append_int( long long value ) {
+    char buf[24] ;
+    char * end = buf + sizeof(buf) ;
+    /* negate as unsigned so that the most negative value works */
+    unsigned long long magnitude = ( value < 0 ) ? 0ULL - (unsigned long long)value : (unsigned long long)value ;
+    char * start = write_uint_backwards(magnitude, end) ;
+    if ( value < 0 ) {
+        *--start = '-' ;
+    }
+    append(start, end - start) ;
+}
+
+void Trick::AsciiRow::append_uint( unsigned long long value ) {
+    char buf[24] ;
+    char * end = buf + sizeof(buf) ;
+    char * start = write_uint_backwards(value, end) ;
+    append(start, end - start) ;
+}
+
+void Trick::AsciiRow::append_printf( const char * format , double value ) {
+    size_t room = capacity - len ;
+    int ret = snprintf(buffer + len, room, format, value) ;
+    /* snprintf needs room for the terminator too */
+    if ( ret >= 0 and (size_t)ret < room ) {
+        len += ret ;
+    } else {
+        overflowed = true ;
+    }
+}
+
+/**
+@details
+-# Zero, infinity, and not a number are written the way printf writes them
+-# The round trip format writes the shortest digits in the style of %.16g without padding
+-# The fast formats round to the precision without printf.  Values too close to a rounding
+   boundary for the fast method and all other formats go to snprintf.
+-# Pad to the width of the format
+*/
+void Trick::AsciiRow::append_double( double value , const AsciiFloatFormat & fmt ) {
+    char digits[20] ;
+    char text[40] ;
+    int len_digits ;
+    int decimal_exponent ;
+    int text_len ;
+
+    if ( ! isfinite(value) ) {
+        append_printf(fmt.round_trip ? "%g" : fmt.format.c_str(), value) ;
+        return ;
+    }
+    const bool negative = signbit(value) ;
+    if ( fmt.round_trip ) {
+        if ( value == 0.0 ) {
+            append(negative ? "-0" : "0") ;
+        } else {
+            len_digits = shortest_digits(fabs(value), digits, decimal_exponent) ;
+            append(text, write_general(text, negative, digits, len_digits, decimal_exponent, 16)) ;
+        }
+        return ;
+    }
+    if ( ! fmt.fast ) {
+        append_printf(fmt.format.c_str(), value) ;
+        return ;
+    }
+    if ( value == 0.0 ) {
+        text_len = 0 ;
+        if ( negative ) {
+            text[text_len++] = '-' ;
+        }
+        text[text_len++] = '0' ;
+    } else {
+        len_digits = precision_digits(fabs(value), fmt.precision, digits, decimal_exponent) ;
+        if ( len_digits == 0 ) {
+            append_printf(fmt.format.c_str(), value) ;
+            return ;
+        }
+        text_len = write_general(text, negative, digits, len_digits, decimal_exponent, fmt.precision) ;
+    }
+
+    int pad = fmt.width - text_len ;
+    if ( pad <= 0 ) {
+        append(text, text_len) ;
+    } else if ( capacity - len < (size_t)fmt.width ) {
+        overflowed = true ;
+    } else if ( fmt.left_justify ) {
+        memcpy(buffer + len, text, text_len) ;
+        memset(buffer + len + text_len, ' ', pad) ;
+        len += fmt.width ;
+    } else {
+        memset(buffer + len, ' ', pad) ;
+        memcpy(buffer + len + pad, text, text_len) ;
+        len += fmt.width ;
+    }
+}
+
+/**
+@details
+-# The round trip format writes the shortest digits that read back to the float in the style of %.8g
+-# Other formats convert the float to double the way printf does
+*/
+void Trick::AsciiRow::append_float( float value , const AsciiFloatFormat & fmt ) {
+    char digits[20] ;
+    char text[40] ;
+    int decimal_exponent ;
+
+    if ( fmt.round_trip and isfinite(value) and value != 0.0f ) {
+        int len_digits = shortest_digits(fabsf(value), digits, decimal_exponent) ;
+        append(text, write_general(text, signbit(value), digits, len_digits, decimal_exponent, 8)) ;
+    } else {
+        append_double(value, fmt) ;
+    }
+}
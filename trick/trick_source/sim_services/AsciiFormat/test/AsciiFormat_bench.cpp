@@ -0,0 +1,152 @@
+/*
+   PURPOSE: (Benchmark of ascii row formatting.)
+
+   Formats rows of doubles the way the ascii data recording format and the variable server did
+   before the row builder, with sprintf, strcat, and strlen, and compares the output bytes and time
+   with Trick::AsciiRow using the same printf formats and using the round trip format.
+
+   usage: AsciiFormat_bench [num_rows [num_columns]]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "trick/AsciiFormat.hh"
+
+static double wall_time() {
+    struct timeval tv ;
+    gettimeofday(&tv, NULL) ;
+    return tv.tv_sec + tv.tv_usec * 1.0e-6 ;
+}
+
+/* The previous ascii data record row: sprintf each value then strlen to find the end */
+static size_t sprintf_row( char * buf , const double * values , unsigned int num_columns , const char * format ) {
+    char * start = buf ;
+    sprintf(buf, format, values[0]) ;
+    buf += strlen(buf) ;
+    for ( unsigned int ii = 1 ; ii < num_columns ; ii++ ) {
+        *buf++ = ',' ;
+        sprintf(buf, format, values[ii]) ;
+        buf += strlen(buf) ;
+    }
+    *buf++ = '\n' ;
+    return buf - start ;
+}
+
+/* The previous variable server message: sprintf each value then strcat it to the message */
+static size_t strcat_row( char * buf , const double * values , unsigned int num_columns , const char * format ) {
+    char val[64] ;
+    strcpy(buf, "0\t") ;
+    for ( unsigned int ii = 0 ; ii < num_columns ; ii++ ) {
+        sprintf(val, format, values[ii]) ;
+        strcat(buf, val) ;
+        strcat(buf, "\t") ;
+    }
+    size_t len = strlen(buf) ;
+    buf[len - 1] = '\n' ;
+    return len ;
+}
+
+static size_t builder_row( Trick::AsciiRow & row , const double * values , unsigned int num_columns ,
+ const Trick::AsciiFloatFormat & fmt , const char * delimiter , const char * prefix ) {
+    row.clear() ;
+    row.append(prefix) ;
+    row.append_double(values[0], fmt) ;
+    for ( unsigned int ii = 1 ; ii < num_columns ; ii++ ) {
+        row.append(delimiter) ;
+        row.append_double(values[ii], fmt) ;
+    }
+    row.append('\n') ;
+    return row.length() ;
+}
+
+int main( int argc , char * argv[] ) {
+
+    unsigned int num_rows = ( argc > 1 ) ? atoi(argv[1]) : 100000 ;
+    unsigned int num_columns = ( argc > 2 ) ? atoi(argv[2]) : 20 ;
+    std::vector< double > values(num_rows * num_columns) ;
+    std::vector< char > old_text(num_columns * 64 + 64) ;
+    std::vector< char > new_text(num_columns * 64 + 64) ;
+    Trick::AsciiRow row(&new_text[0], new_text.size()) ;
+    Trick::AsciiFloatFormat round_trip ;
+    const char * formats[] = { "%20.16g", "%.16g" } ;
+    unsigned int ii , jj ;
+    double start ;
+
+    round_trip.set_round_trip(true) ;
+
+    /* values like a simulation state: smooth functions of time over several magnitudes */
+    for ( ii = 0 ; ii < num_rows ; ii++ ) {
+        double time = ii * 0.01 ;
+        values[ii * num_columns] = time ;
+        for ( jj = 1 ; jj < num_columns ; jj++ ) {
+            values[ii * num_columns + jj] = sin(time * jj) * pow(10.0, (int)(jj % 12) - 4) ;
+        }
+    }
+
+    std::cout << num_rows << " rows of " << num_columns << " doubles" << std::endl ;
+    std::cout << std::setw(10) << "format" << std::setw(22) << "style" << std::setw(12) << "time (s)"
+              << std::setw(12) << "MB/s" << std::setw(14) << "bytes" << std::endl ;
+
+    for ( unsigned int ff = 0 ; ff < 2 ; ff++ ) {
+        const char * format = formats[ff] ;
+        const bool csv = ( ff == 0 ) ;
+        const char * name = csv ? "sprintf+strlen" : "sprintf+strcat" ;
+        Trick::AsciiFloatFormat fmt(format) ;
+        size_t old_bytes = 0 , new_bytes = 0 , rt_bytes = 0 , mismatches = 0 ;
+        double old_time , new_time , rt_time ;
+
+        start = wall_time() ;
+        for ( ii = 0 ; ii < num_rows ; ii++ ) {
+            const double * row_values = &values[ii * num_columns] ;
+            old_bytes += csv ? sprintf_row(&old_text[0], row_values, num_columns, format) :
+             strcat_row(&old_text[0], row_values, num_columns, format) ;
+        }
+        old_time = wall_time() - start ;
+
+        start = wall_time() ;
+        for ( ii = 0 ; ii < num_rows ; ii++ ) {
+            new_bytes += builder_row(row, &values[ii * num_columns], num_columns, fmt, csv ? "," : "\t",
+             csv ? "" : "0\t") ;
+        }
+        new_time = wall_time() - start ;
+
+        start = wall_time() ;
+        for ( ii = 0 ; ii < num_rows ; ii++ ) {
+            rt_bytes += builder_row(row, &values[ii * num_columns], num_columns, round_trip, csv ? "," : "\t",
+             csv ? "" : "0\t") ;
+        }
+        rt_time = wall_time() - start ;
+
+        /* the printf formats must give the same bytes as before */
+        for ( ii = 0 ; ii < num_rows ; ii++ ) {
+            const double * row_values = &values[ii * num_columns] ;
+            size_t old_len = csv ? sprintf_row(&old_text[0], row_values, num_columns, format) :
+             strcat_row(&old_text[0], row_values, num_columns, format) ;
+            size_t new_len = builder_row(row, row_values, num_columns, fmt, csv ? "," : "\t", csv ? "" : "0\t") ;
+            if ( old_len != new_len or memcmp(&old_text[0], &new_text[0], old_len) ) {
+                mismatches++ ;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(4)
+          << std::setw(10) << format << std::setw(22) << name << std::setw(12) << old_time
+          << std::setw(12) << std::setprecision(1) << old_bytes / old_time / 1.0e6 << std::setw(14) << old_bytes << std::endl
+          << std::setprecision(4)
+          << std::setw(10) << format << std::setw(22) << "AsciiRow" << std::setw(12) << new_time
+          << std::setw(12) << std::setprecision(1) << new_bytes / new_time / 1.0e6 << std::setw(14) << new_bytes << std::endl
+          << std::setprecision(4)
+          << std::setw(10) << "" << std::setw(22) << "AsciiRow round trip" << std::setw(12) << rt_time
+          << std::setw(12) << std::setprecision(1) << rt_bytes / rt_time / 1.0e6 << std::setw(14) << rt_bytes << std::endl ;
+        std::cout << std::setw(10) << "" << "  rows differing from printf: " << mismatches << std::endl ;
+    }
+
+    return 0 ;
+}
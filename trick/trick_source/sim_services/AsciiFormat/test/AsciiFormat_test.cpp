@@ -0,0 +1,157 @@
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <float.h>
+
+#include "gtest/gtest.h"
+#include "trick/AsciiFormat.hh"
+
+namespace Trick {
+
+class AsciiFormatTest : public ::testing::Test {
+
+    protected:
+        char buffer[512] ;
+
+        AsciiFormatTest() {}
+        ~AsciiFormatTest() {}
+        virtual void SetUp() {}
+        virtual void TearDown() {}
+
+        std::string format_double( double value , const AsciiFloatFormat & fmt ) {
+            AsciiRow row(buffer, sizeof(buffer)) ;
+            row.append_double(value, fmt) ;
+            return std::string(buffer, row.length()) ;
+        }
+
+        std::string format_float( float value , const AsciiFloatFormat & fmt ) {
+            AsciiRow row(buffer, sizeof(buffer)) ;
+            row.append_float(value, fmt) ;
+            return std::string(buffer, row.length()) ;
+        }
+
+        std::string printf_double( const char * format , double value ) {
+            char text[512] ;
+            snprintf(text, sizeof(text), format, value) ;
+            return std::string(text) ;
+        }
+} ;
+
+/* A repeatable spread of doubles over the whole exponent range */
+static double test_value( unsigned int ii ) {
+    unsigned long long bits = ii * 0x9E3779B97F4A7C15ULL ;
+    bits ^= bits >> 29 ;
+    double value ;
+    memcpy(&value, &bits, sizeof(value)) ;
+    if ( ! isfinite(value) ) {
+        value = ii ;
+    }
+    return value ;
+}
+
+TEST_F( AsciiFormatTest , Integers ) {
+
+    AsciiRow row(buffer, sizeof(buffer)) ;
+    char expected[256] ;
+
+    row.append_int(0) ;
+    row.append(',') ;
+    row.append_int(-7) ;
+    row.append(',') ;
+    row.append_int(LLONG_MIN) ;
+    row.append(',') ;
+    row.append_int(LLONG_MAX) ;
+    row.append(',') ;
+    row.append_uint(ULLONG_MAX) ;
+    row.append(',') ;
+    row.append_uint(1000000) ;
+    row.terminate() ;
+    snprintf(expected, sizeof(expected), "%d,%d,%lld,%lld,%llu,%u", 0, -7, LLONG_MIN, LLONG_MAX, ULLONG_MAX, 1000000) ;
+    EXPECT_STREQ( expected , buffer ) ;
+}
+
+TEST_F( AsciiFormatTest , MatchesPrintf ) {
+
+    const char * formats[] = { "%20.16g", "%20.8g", "%.16g", "%.8g", "%g", "%-14.6g", "%.17g", "%.0g",
+     "%12.4e", "%.3f" } ;
+    const double specials[] = { 0.0, -0.0, 1.0, -1.0, 0.1, 1e16, 1e15, 1e-5, 1e-4, 5e-324, DBL_MIN, DBL_MAX,
+     1125899906842624.5, 1234.5677, INFINITY, -INFINITY, NAN } ;
+    unsigned int ii , jj ;
+
+    for ( jj = 0 ; jj < sizeof(formats) / sizeof(formats[0]) ; jj++ ) {
+        AsciiFloatFormat fmt(formats[jj]) ;
+        for ( ii = 0 ; ii < sizeof(specials) / sizeof(specials[0]) ; ii++ ) {
+            EXPECT_EQ( printf_double(formats[jj], specials[ii]) , format_double(specials[ii], fmt) ) ;
+        }
+        for ( ii = 0 ; ii < 20000 ; ii++ ) {
+            double value = test_value(ii) ;
+            ASSERT_EQ( printf_double(formats[jj], value) , format_double(value, fmt) ) ;
+        }
+    }
+}
+
+TEST_F( AsciiFormatTest , FastFormats ) {
+
+    EXPECT_TRUE( AsciiFloatFormat("%20.16g").fast ) ;
+    EXPECT_TRUE( AsciiFloatFormat("%-8.3g").fast ) ;
+    EXPECT_FALSE( AsciiFloatFormat("%020.16g").fast ) ;
+    EXPECT_FALSE( AsciiFloatFormat("%+.16g").fast ) ;
+    EXPECT_FALSE( AsciiFloatFormat("%.18g").fast ) ;
+    EXPECT_FALSE( AsciiFloatFormat("%.16g ").fast ) ;
+    EXPECT_FALSE( AsciiFloatFormat("%.16e").fast ) ;
+}
+
+TEST_F( AsciiFormatTest , RoundTrip ) {
+
+    AsciiFloatFormat fmt ;
+    unsigned int ii ;
+
+    fmt.set_round_trip(true) ;
+    EXPECT_EQ( std::string("0.1") , format_double(0.1, fmt) ) ;
+    EXPECT_EQ( std::string("0.30000000000000004") , format_double(0.1 + 0.2, fmt) ) ;
+    EXPECT_EQ( std::string("-0") , format_double(-0.0, fmt) ) ;
+    EXPECT_EQ( std::string("1e+16") , format_double(1e16, fmt) ) ;
+    EXPECT_EQ( std::string("5e-324") , format_double(5e-324, fmt) ) ;
+    EXPECT_EQ( std::string("1234.5677") , format_float(1234.5677f, fmt) ) ;
+    EXPECT_EQ( std::string("0.1") , format_float(0.1f, fmt) ) ;
+
+    for ( ii = 0 ; ii < 100000 ; ii++ ) {
+        double value = test_value(ii) ;
+        std::string text = format_double(value, fmt) ;
+        ASSERT_EQ( value , strtod(text.c_str(), NULL) ) << text ;
+        if ( value != 0.0 ) {
+            char digits[20] ;
+            int decimal_exponent ;
+            ASSERT_LE( shortest_digits(fabs(value), digits, decimal_exponent) , 17 ) ;
+        }
+
+        float fvalue = (float)value ;
+        if ( isfinite(fvalue) ) {
+            text = format_float(fvalue, fmt) ;
+            ASSERT_EQ( fvalue , strtof(text.c_str(), NULL) ) << text ;
+        }
+    }
+}
+
+TEST_F( AsciiFormatTest , Overflow ) {
+
+    AsciiRow row(buffer, 10) ;
+    AsciiFloatFormat fmt("%20.16g") ;
+
+    row.append("12345") ;
+    EXPECT_FALSE( row.overflow() ) ;
+    row.append_double(1.0, fmt) ;
+    EXPECT_TRUE( row.overflow() ) ;
+    EXPECT_EQ( (size_t)5 , row.length() ) ;
+    row.rewind(2) ;
+    EXPECT_FALSE( row.overflow() ) ;
+    row.append_int(-1234567) ;
+    EXPECT_FALSE( row.overflow() ) ;
+    EXPECT_FALSE( row.terminate() ) ;
+    EXPECT_EQ( std::string("12-1234567") , std::string(buffer, row.length()) ) ;
+}
+
+}
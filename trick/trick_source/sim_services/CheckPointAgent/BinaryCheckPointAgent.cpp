@@ -0,0 +1,914 @@
+#include "trick/MemoryManager.hh"
+#include "trick/parameter_types.h"
+#include "trick/io_alloc.h"
+#include "trick/bitfield_proto.h"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+
+#include "trick/BinaryCheckPointAgent.hh"
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* A binary checkpoint is written in the byte order and pointer size of the machine that wrote it.
+
+   header : signature[8] version(uint) pointer_size(uint) id(ull) base_id(ull) base_name(string) num_blocks(uint)
+   block  : name(string) stcl(int) type(int) user_type_name(string) size(int) num(int) num_index(int)
+            index[num_index](int) hash(ull) has_data(char) [data_size(ull) data[data_size]]
+   string : length(uint) characters[length]
+
+   index  : id(ull) base_id(ull) num_blocks(uint) { name(string) hash(ull) }[num_blocks]
+   trailer: index_size(ull) index_signature[8]
+
+   The data of a block is the output of its copy plan.  A pointer is stored as a kind byte followed by the
+   allocation name and offset, or the characters of an unmanaged C string.  A block without data is unchanged
+   since the checkpoint named by base_name, where its data is found by name and hash.
+
+   The index at the end of the file repeats the block hashes, so the next incremental checkpoint can be based
+   on this one without reading the whole file.
+*/
+
+static const char binary_signature[8] = { 'T', 'r', 'i', 'c', 'k', 'B', 'C', 'P' } ;
+static const char index_signature[8] = { 'T', 'r', 'i', 'c', 'k', 'B', 'C', 'I' } ;
+static const unsigned int binary_version = 1 ;
+
+enum PointerKind {
+    POINTER_NULL = 0,
+    POINTER_ALLOCATION = 1,
+    POINTER_C_STRING = 2,
+    POINTER_UNRESOLVED = 3
+} ;
+
+template <class T> static void put( std::string& buf, T value ) {
+    buf.append((const char*)&value, sizeof(T)) ;
+}
+
+static void put_string( std::string& buf, const char* s, size_t length ) {
+    put<unsigned int>(buf, (unsigned int)length) ;
+    buf.append(s, length) ;
+}
+
+template <class T> static bool get( const std::string& buf, size_t& pos, size_t end, T& value ) {
+    if ( end - pos < sizeof(T) ) {
+        return false ;
+    }
+    memcpy(&value, buf.data() + pos, sizeof(T)) ;
+    pos += sizeof(T) ;
+    return true ;
+}
+
+static bool get_string( const std::string& buf, size_t& pos, size_t end, std::string& s ) {
+    unsigned int length ;
+    if ( ! get(buf, pos, end, length) or end - pos < length ) {
+        return false ;
+    }
+    s.assign(buf, pos, length) ;
+    pos += length ;
+    return true ;
+}
+
+// FNV-1a over 8 byte words, with a shift to fold the high bits back in.
+static unsigned long long hash_bytes( unsigned long long hash, const char* p, size_t length ) {
+    const unsigned long long prime = 0x100000001b3ULL ;
+    while ( length >= sizeof(unsigned long long) ) {
+        unsigned long long word ;
+        memcpy(&word, p, sizeof(word)) ;
+        hash = (hash ^ word) * prime ;
+        hash ^= hash >> 29 ;
+        p += sizeof(word) ;
+        length -= sizeof(word) ;
+    }
+    while ( length-- > 0 ) {
+        hash = (hash ^ (unsigned char)*p++) * prime ;
+    }
+    return hash ;
+}
+
+// The attributes of a whole allocation, as MemoryManager::make_reference_attr builds them.
+static void make_allocation_attr( ALLOC_INFO* alloc_info, ATTRIBUTES& attr ) {
+    memset(&attr, 0, sizeof(ATTRIBUTES)) ;
+    attr.name = alloc_info->name ;
+    attr.io = TRICK_VAR_OUTPUT | TRICK_VAR_INPUT | TRICK_CHKPNT_OUTPUT | TRICK_CHKPNT_INPUT ;
+    attr.type = alloc_info->type ;
+    attr.size = alloc_info->size ;
+    attr.language = alloc_info->language ;
+    attr.attr = alloc_info->attr ;
+    attr.num_index = alloc_info->num_index ;
+    for (int ii = 0 ; ii < attr.num_index ; ii++ ) {
+        attr.index[ii].size = alloc_info->index[ii] ;
+    }
+}
+
+// MEMBER FUNCTION
+Trick::BinaryCheckPointAgent::BinaryCheckPointAgent( Trick::MemoryManager *MM) {
+
+    mem_mgr = MM;
+    reduced_checkpoint = 0;
+    hexfloat_checkpoint = 0;
+    debug_level = 0;
+    incremental = false;
+    full_interval = 10;
+    last_id = 0;
+    checkpoint_count = 0;
+    restore_status = 0;
+}
+
+// MEMBER FUNCTION
+Trick::BinaryCheckPointAgent::~BinaryCheckPointAgent() {
+
+    std::map<ATTRIBUTES*, CopyPlan*>::iterator it ;
+    for ( it = plans.begin() ; it != plans.end() ; it++ ) {
+        delete it->second ;
+    }
+}
+
+// MEMBER FUNCTION
+bool Trick::BinaryCheckPointAgent::input_perm_check(ATTRIBUTES * attr) {
+    return (attr->io & TRICK_CHKPNT_INPUT) ;
+}
+
+// MEMBER FUNCTION
+bool Trick::BinaryCheckPointAgent::output_perm_check(ATTRIBUTES * attr) {
+    return (attr->io & TRICK_CHKPNT_OUTPUT) ;
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::write_decl(std::ostream& chkpnt_os __attribute__((unused)),
+                                              ALLOC_INFO *alloc_info __attribute__((unused))) {
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::assign_rvalue( std::ostream& chkpnt_os __attribute__((unused)),
+                                                  void* address __attribute__((unused)),
+                                                  ATTRIBUTES* attr __attribute__((unused)),
+                                                  int curr_dim __attribute__((unused)),
+                                                  int offset __attribute__((unused))) {
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::set_file_name( std::string in_file_name) {
+    file_name = in_file_name ;
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::set_incremental( bool flag) {
+    if ( flag != incremental ) {
+        chain.clear() ;
+        last_hashes.clear() ;
+    }
+    incremental = flag ;
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::add_op( CopyPlan& plan, const CopyOp& op) {
+
+    // Join plain copies that follow each other in the object.
+    if ( op.type == COPY_PLAIN and ! plan.empty() ) {
+        CopyOp & last = plan.back() ;
+        if ( last.type == COPY_PLAIN and ! last.absolute and ! op.absolute and last.input == op.input and
+             last.offset + (long)last.size == op.offset ) {
+            last.size += op.size ;
+            return ;
+        }
+    }
+    plan.push_back(op) ;
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::add_var_ops( CopyPlan& plan, ATTRIBUTES* attr, long offset, bool absolute, bool input) {
+
+    CopyOp op ;
+    int ii ;
+
+    // Members that are not checkpointed and C++ references are left alone.
+    if ( ! output_perm_check(attr) or (attr->mods & 1) ) {
+        return ;
+    }
+
+    memset(&op, 0, sizeof(CopyOp)) ;
+    op.absolute = absolute ;
+    op.input = input and input_perm_check(attr) ;
+    op.offset = offset ;
+    op.count = 1 ;
+
+    // Count the elements up to the first pointer dimension.
+    for ( ii = 0 ; ii < attr->num_index ; ii++ ) {
+        if ( attr->index[ii].size == 0 ) {
+            break ;
+        }
+        op.count *= attr->index[ii].size ;
+    }
+
+    if ( ii < attr->num_index or attr->type == TRICK_VOID_PTR ) {
+        op.type = COPY_POINTER ;
+        op.size = sizeof(void*) ;
+        op.char_string = (ii == attr->num_index - 1) and
+                         (attr->type == TRICK_CHARACTER or attr->type == TRICK_UNSIGNED_CHARACTER) ;
+        add_op(plan, op) ;
+        return ;
+    }
+
+    switch ( attr->type ) {
+        case TRICK_STRUCTURED : {
+            if ( attr->attr == NULL ) {
+                return ;
+            }
+            const CopyPlan * nested = get_plan((ATTRIBUTES*)attr->attr) ;
+            if ( nested->empty() ) {
+                return ;
+            }
+            const CopyOp & first = nested->front() ;
+            if ( nested->size() == 1 and first.type == COPY_PLAIN and ! first.absolute and
+                 first.offset == 0 and first.size == (size_t)attr->size ) {
+                // Structures that are all plain data are copied whole.
+                op.type = COPY_PLAIN ;
+                op.input = op.input and first.input ;
+                op.size = (size_t)op.count * attr->size ;
+            } else {
+                op.type = COPY_NESTED ;
+                op.size = attr->size ;
+                op.plan = nested ;
+            }
+        } break ;
+        case TRICK_STRING :
+            op.type = COPY_STRING ;
+            op.size = attr->size ;
+            break ;
+        case TRICK_WSTRING :
+            op.type = COPY_WSTRING ;
+            op.size = attr->size ;
+            break ;
+        case TRICK_BITFIELD :
+        case TRICK_UNSIGNED_BITFIELD :
+            op.type = COPY_BITFIELD ;
+            op.size = attr->size ;
+            op.attr = attr ;
+            break ;
+        case TRICK_STL :
+            // STLs are checkpointed through the allocations their checkpoint functions make.
+        case TRICK_OPAQUE_TYPE :
+        case TRICK_FILE_PTR :
+            return ;
+        default :
+            op.type = COPY_PLAIN ;
+            op.size = (size_t)op.count * attr->size ;
+            op.count = 1 ;
+            break ;
+    }
+    add_op(plan, op) ;
+}
+
+// MEMBER FUNCTION
+const Trick::BinaryCheckPointAgent::CopyPlan* Trick::BinaryCheckPointAgent::get_plan( ATTRIBUTES* attr_list) {
+
+    std::map<ATTRIBUTES*, CopyPlan*>::iterator it = plans.find(attr_list) ;
+    if ( it != plans.end() ) {
+        return it->second ;
+    }
+
+    CopyPlan * plan = new CopyPlan ;
+    for (int ii = 0 ; attr_list[ii].name[0] != '\0' ; ii++ ) {
+        if ( attr_list[ii].mods & 2 ) {
+            // Static members are copied from their own address.
+            add_var_ops(*plan, &attr_list[ii], attr_list[ii].offset, true, true) ;
+        } else {
+            add_var_ops(*plan, &attr_list[ii], attr_list[ii].offset, false, true) ;
+        }
+    }
+    plans[attr_list] = plan ;
+    return plan ;
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::write_pointer( std::string& buf, void* ptr, bool char_string) {
+
+    if ( ptr == NULL ) {
+        put<char>(buf, POINTER_NULL) ;
+        return ;
+    }
+
+    ALLOC_INFO * alloc_info = mem_mgr->get_alloc_info_of(ptr) ;
+    if ( alloc_info != NULL and alloc_info->name != NULL ) {
+        put<char>(buf, POINTER_ALLOCATION) ;
+        put_string(buf, alloc_info->name, strlen(alloc_info->name)) ;
+        put<long long>(buf, (long long)((char*)ptr - (char*)alloc_info->start)) ;
+    } else if ( alloc_info == NULL and char_string ) {
+        put<char>(buf, POINTER_C_STRING) ;
+        put_string(buf, (const char*)ptr, strlen((const char*)ptr)) ;
+    } else {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Pointer %p does not point to a checkpointed allocation.\n", ptr) ;
+        put<char>(buf, POINTER_UNRESOLVED) ;
+    }
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::write_plan( std::string& buf, const CopyPlan& plan, char* base) {
+
+    int ii ;
+    for ( CopyPlan::const_iterator it = plan.begin() ; it != plan.end() ; it++ ) {
+        const CopyOp & op = *it ;
+        char * address = op.absolute ? (char*)op.offset : base + op.offset ;
+        switch ( op.type ) {
+            case COPY_PLAIN :
+                buf.append(address, op.size) ;
+                break ;
+            case COPY_BITFIELD : {
+                ATTRIBUTES * attr = op.attr ;
+                int value ;
+                if ( attr->type == TRICK_BITFIELD ) {
+                    value = GET_BITFIELD(address, attr->size, attr->index[0].start, attr->index[0].size) ;
+                } else {
+                    value = (int)(GET_UNSIGNED_BITFIELD(address, attr->size, attr->index[0].start, attr->index[0].size)) ;
+                }
+                put<int>(buf, value) ;
+            } break ;
+            case COPY_POINTER :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    write_pointer(buf, ((void**)address)[ii], op.char_string) ;
+                }
+                break ;
+            case COPY_STRING :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    std::string & s = *(std::string*)(address + ii * op.size) ;
+                    put_string(buf, s.data(), s.size()) ;
+                }
+                break ;
+            case COPY_WSTRING :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    std::wstring & s = *(std::wstring*)(address + ii * op.size) ;
+                    put_string(buf, (const char*)s.data(), s.size() * sizeof(wchar_t)) ;
+                }
+                break ;
+            case COPY_NESTED :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    write_plan(buf, *op.plan, address + ii * op.size) ;
+                }
+                break ;
+        }
+    }
+}
+
+// MEMBER FUNCTION
+void Trick::BinaryCheckPointAgent::write_block_data( std::string& buf, ALLOC_INFO* alloc_info) {
+
+    ATTRIBUTES attr ;
+    CopyPlan plan ;
+
+    make_allocation_attr(alloc_info, attr) ;
+    add_var_ops(plan, &attr, 0, false, true) ;
+    write_plan(buf, plan, (char*)alloc_info->start) ;
+}
+
+// MEMBER FUNCTION
+bool Trick::BinaryCheckPointAgent::write_checkpoint( std::ostream& chkpnt_os, std::vector<ALLOC_INFO*>& allocations) {
+
+    std::map<std::string, unsigned long long> hashes ;
+    std::map<std::string, unsigned long long>::iterator hit ;
+    std::string header ;
+    std::string index ;
+    std::string decl ;
+    std::string data ;
+    unsigned long long id ;
+    struct timespec now ;
+    bool write_incremental ;
+
+    // Every checkpoint gets a new id so an incremental checkpoint can tell its base file was replaced.
+    clock_gettime(CLOCK_REALTIME, &now) ;
+    id = ((unsigned long long)now.tv_sec << 30) ^ (unsigned long long)now.tv_nsec ^
+         ((unsigned long long)getpid() << 48) ^ ++checkpoint_count ;
+
+    // A checkpoint may not replace a file of the chain it refers to.
+    write_incremental = incremental and ! file_name.empty() and ! chain.empty() and (int)chain.size() < full_interval and
+                        std::find(chain.begin(), chain.end(), file_name) == chain.end() ;
+
+    header.append(binary_signature, sizeof(binary_signature)) ;
+    put<unsigned int>(header, binary_version) ;
+    put<unsigned int>(header, (unsigned int)sizeof(void*)) ;
+    put<unsigned long long>(header, id) ;
+    if ( write_incremental ) {
+        const std::string & base = chain.back() ;
+        std::string base_name = base.substr(base.find_last_of('/') + 1) ;
+        put<unsigned long long>(header, last_id) ;
+        put_string(header, base_name.data(), base_name.size()) ;
+    } else {
+        put<unsigned long long>(header, 0) ;
+        put_string(header, "", 0) ;
+    }
+    put<unsigned int>(header, (unsigned int)allocations.size()) ;
+    chkpnt_os.write(header.data(), header.size()) ;
+
+    put<unsigned long long>(index, id) ;
+    put<unsigned long long>(index, write_incremental ? last_id : 0) ;
+
+    for ( unsigned int ii = 0 ; ii < allocations.size() ; ii++ ) {
+        ALLOC_INFO * alloc_info = allocations[ii] ;
+        const char * user_type_name = alloc_info->user_type_name ? alloc_info->user_type_name : "" ;
+        unsigned long long hash ;
+        bool write_data ;
+
+        decl.clear() ;
+        put_string(decl, alloc_info->name, strlen(alloc_info->name)) ;
+        put<int>(decl, alloc_info->stcl) ;
+        put<int>(decl, alloc_info->type) ;
+        put_string(decl, user_type_name, strlen(user_type_name)) ;
+        put<int>(decl, alloc_info->size) ;
+        put<int>(decl, alloc_info->num) ;
+        put<int>(decl, alloc_info->num_index) ;
+        for (int jj = 0 ; jj < alloc_info->num_index ; jj++ ) {
+            put<int>(decl, alloc_info->index[jj]) ;
+        }
+
+        data.clear() ;
+        write_block_data(data, alloc_info) ;
+
+        hash = hash_bytes(hash_bytes(0xcbf29ce484222325ULL, decl.data(), decl.size()), data.data(), data.size()) ;
+        hashes[alloc_info->name] = hash ;
+
+        write_data = true ;
+        if ( write_incremental ) {
+            std::map<std::string, unsigned long long>::iterator it = last_hashes.find(alloc_info->name) ;
+            write_data = ( it == last_hashes.end() or it->second != hash ) ;
+        }
+
+        put<unsigned long long>(decl, hash) ;
+        put<char>(decl, write_data) ;
+        if ( write_data ) {
+            put<unsigned long long>(decl, data.size()) ;
+        }
+        chkpnt_os.write(decl.data(), decl.size()) ;
+        if ( write_data ) {
+            chkpnt_os.write(data.data(), data.size()) ;
+        }
+        if (debug_level) {
+            std::cout << "Checkpoint block " << alloc_info->name << " " << data.size() << " bytes"
+                      << (write_data ? "" : ", unchanged") << std::endl ;
+        }
+    }
+
+    put<unsigned int>(index, (unsigned int)hashes.size()) ;
+    for ( hit = hashes.begin() ; hit != hashes.end() ; hit++ ) {
+        put_string(index, hit->first.data(), hit->first.size()) ;
+        put<unsigned long long>(index, hit->second) ;
+    }
+    put<unsigned long long>(index, index.size()) ;
+    index.append(index_signature, sizeof(index_signature)) ;
+    chkpnt_os.write(index.data(), index.size()) ;
+    chkpnt_os.flush() ;
+
+    if ( chkpnt_os.good() ) {
+        // Remember what was written for the next incremental checkpoint.
+        last_hashes.swap(hashes) ;
+        last_id = id ;
+        if ( ! write_incremental ) {
+            chain.clear() ;
+        }
+        if ( ! file_name.empty() ) {
+            chain.push_back(file_name) ;
+        } else {
+            chain.clear() ;
+        }
+    } else {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Could not write binary checkpoint %s.\n", file_name.c_str()) ;
+        chain.clear() ;
+        last_hashes.clear() ;
+    }
+    file_name.clear() ;
+
+    return true ;
+}
+
+// MEMBER FUNCTION
+int Trick::BinaryCheckPointAgent::adopt_checkpoint( std::string adopt_file_name) {
+
+    std::ifstream in_s( adopt_file_name.c_str(), std::ios::in | std::ios::binary) ;
+    std::map<std::string, unsigned long long> hashes ;
+    std::string index ;
+    char signature[sizeof(index_signature)] ;
+    unsigned long long index_size = 0 ;
+    unsigned long long id ;
+    unsigned long long base_id ;
+    unsigned int num_blocks ;
+    size_t pos = 0 ;
+    bool ok ;
+
+    // Read the index from the end of the file.
+    in_s.seekg(-(std::streamoff)(sizeof(index_size) + sizeof(signature)), std::ios::end) ;
+    in_s.read((char*)&index_size, sizeof(index_size)) ;
+    in_s.read(signature, sizeof(signature)) ;
+    ok = in_s.good() and ! memcmp(signature, index_signature, sizeof(signature)) and index_size < (1ULL << 32) ;
+    if ( ok ) {
+        index.resize((size_t)index_size) ;
+        in_s.seekg(-(std::streamoff)(index_size + sizeof(index_size) + sizeof(signature)), std::ios::end) ;
+        in_s.read(&index[0], index.size()) ;
+        ok = in_s.good() and get(index, pos, index.size(), id) and get(index, pos, index.size(), base_id) and
+             get(index, pos, index.size(), num_blocks) ;
+    }
+    for ( unsigned int ii = 0 ; ok and ii < num_blocks ; ii++ ) {
+        std::string name ;
+        unsigned long long hash ;
+        ok = get_string(index, pos, index.size(), name) and get(index, pos, index.size(), hash) ;
+        hashes[name] = hash ;
+    }
+
+    // An incremental checkpoint must be based on the last one this agent knows about.
+    if ( ! ok or ( base_id != 0 and ( chain.empty() or base_id != last_id ))) {
+        chain.clear() ;
+        last_hashes.clear() ;
+        return 1 ;
+    }
+
+    last_hashes.swap(hashes) ;
+    last_id = id ;
+    if ( base_id == 0 ) {
+        chain.clear() ;
+    }
+    chain.push_back(adopt_file_name) ;
+    return 0 ;
+}
+
+// MEMBER FUNCTION
+bool Trick::BinaryCheckPointAgent::read_file( CheckPointFile& file, std::istream* is) {
+
+    size_t pos = 0 ;
+    size_t end ;
+    char signature[sizeof(binary_signature)] ;
+    unsigned int version ;
+    unsigned int pointer_size ;
+    unsigned int num_blocks ;
+
+    file.contents.assign(std::istreambuf_iterator<char>(*is), std::istreambuf_iterator<char>()) ;
+    end = file.contents.size() ;
+
+    if ( end < sizeof(signature) or memcmp(file.contents.data(), binary_signature, sizeof(signature)) ) {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: %s is not a binary checkpoint.\n", file.file_name.c_str()) ;
+        return false ;
+    }
+    pos = sizeof(signature) ;
+    if ( ! get(file.contents, pos, end, version) or version != binary_version or
+         ! get(file.contents, pos, end, pointer_size) or pointer_size != sizeof(void*) ) {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Binary checkpoint %s was written by an incompatible version or machine.\n",
+         file.file_name.c_str()) ;
+        return false ;
+    }
+    if ( ! get(file.contents, pos, end, file.id) or ! get(file.contents, pos, end, file.base_id) or
+         ! get_string(file.contents, pos, end, file.base_name) or ! get(file.contents, pos, end, num_blocks) ) {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Binary checkpoint %s is truncated.\n", file.file_name.c_str()) ;
+        return false ;
+    }
+
+    file.blocks.resize(num_blocks) ;
+    for ( unsigned int ii = 0 ; ii < num_blocks ; ii++ ) {
+        Block & block = file.blocks[ii] ;
+        char has_data ;
+        bool ok ;
+
+        ok = get_string(file.contents, pos, end, block.name) and get(file.contents, pos, end, block.stcl) and
+             get(file.contents, pos, end, block.type) and get_string(file.contents, pos, end, block.user_type_name) and
+             get(file.contents, pos, end, block.size) and get(file.contents, pos, end, block.num) and
+             get(file.contents, pos, end, block.num_index) and block.num_index >= 0 and block.num_index <= TRICK_MAX_INDEX ;
+        for ( int jj = 0 ; ok and jj < block.num_index ; jj++ ) {
+            ok = get(file.contents, pos, end, block.index[jj]) ;
+        }
+        ok = ok and get(file.contents, pos, end, block.hash) and get(file.contents, pos, end, has_data) ;
+        block.has_data = (has_data != 0) ;
+        block.data_offset = 0 ;
+        block.data_size = 0 ;
+        if ( ok and block.has_data ) {
+            unsigned long long data_size ;
+            ok = get(file.contents, pos, end, data_size) and data_size <= end - pos ;
+            block.data_offset = pos ;
+            block.data_size = (size_t)data_size ;
+            pos += block.data_size ;
+        }
+        if ( ! ok ) {
+            message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Binary checkpoint %s is truncated.\n", file.file_name.c_str()) ;
+            return false ;
+        }
+        file.block_index[block.name] = ii ;
+    }
+    return true ;
+}
+
+// MEMBER FUNCTION
+const Trick::BinaryCheckPointAgent::Block* Trick::BinaryCheckPointAgent::find_data( std::vector<CheckPointFile*>& files,
+ size_t file_index, const Block& block, size_t& data_file) {
+
+    const Block * found = &block ;
+
+    // Follow the chain of base checkpoints until one holds the data of the block.
+    while ( ! found->has_data ) {
+        if ( file_index + 1 == files.size() ) {
+            CheckPointFile & curr = *files[file_index] ;
+            if ( curr.base_name.empty() ) {
+                message_publish(MSG_ERROR, "Checkpoint Agent ERROR: No data for %s in binary checkpoint %s.\n",
+                 block.name.c_str(), curr.file_name.c_str()) ;
+                return NULL ;
+            }
+            CheckPointFile * base = new CheckPointFile ;
+            base->file_name = curr.file_name.substr(0, curr.file_name.find_last_of('/') + 1) + curr.base_name ;
+            std::ifstream in_s( base->file_name.c_str(), std::ios::in | std::ios::binary) ;
+            if ( ! in_s.is_open() or ! read_file(*base, &in_s) or base->id != curr.base_id ) {
+                message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Incremental checkpoint %s needs %s as it was written.\n",
+                 curr.file_name.c_str(), base->file_name.c_str()) ;
+                delete base ;
+                return NULL ;
+            }
+            files.push_back(base) ;
+        }
+        file_index++ ;
+        std::map<std::string, size_t>::iterator it = files[file_index]->block_index.find(block.name) ;
+        if ( it == files[file_index]->block_index.end() or files[file_index]->blocks[it->second].hash != block.hash ) {
+            message_publish(MSG_ERROR, "Checkpoint Agent ERROR: %s is missing from binary checkpoint %s.\n",
+             block.name.c_str(), files[file_index]->file_name.c_str()) ;
+            return NULL ;
+        }
+        found = &files[file_index]->blocks[it->second] ;
+    }
+    data_file = file_index ;
+    return found ;
+}
+
+// MEMBER FUNCTION
+bool Trick::BinaryCheckPointAgent::read_pointer( const std::string& buf, size_t& pos, size_t end, void** ptr, bool input,
+ std::map<std::string, char*>& addresses) {
+
+    char kind ;
+    if ( ! get(buf, pos, end, kind) ) {
+        return false ;
+    }
+    switch ( kind ) {
+        case POINTER_NULL :
+            if ( input ) {
+                *ptr = NULL ;
+            }
+            break ;
+        case POINTER_ALLOCATION : {
+            std::string name ;
+            long long offset ;
+            if ( ! get_string(buf, pos, end, name) or ! get(buf, pos, end, offset) ) {
+                return false ;
+            }
+            if ( input ) {
+                std::map<std::string, char*>::iterator it = addresses.find(name) ;
+                if ( it != addresses.end() ) {
+                    *ptr = it->second + offset ;
+                } else {
+                    message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Pointer to unknown allocation %s not restored.\n",
+                     name.c_str()) ;
+                }
+            }
+        } break ;
+        case POINTER_C_STRING : {
+            std::string s ;
+            if ( ! get_string(buf, pos, end, s) ) {
+                return false ;
+            }
+            if ( input ) {
+                *ptr = mem_mgr->mm_strdup(s.c_str()) ;
+            }
+        } break ;
+        case POINTER_UNRESOLVED :
+            break ;
+        default :
+            return false ;
+    }
+    return true ;
+}
+
+// MEMBER FUNCTION
+bool Trick::BinaryCheckPointAgent::read_plan( const std::string& buf, size_t& pos, size_t end, const CopyPlan& plan,
+ char* base, bool input, std::map<std::string, char*>& addresses) {
+
+    int ii ;
+    for ( CopyPlan::const_iterator it = plan.begin() ; it != plan.end() ; it++ ) {
+        const CopyOp & op = *it ;
+        char * address = op.absolute ? (char*)op.offset : base + op.offset ;
+        bool op_input = input and op.input ;
+        switch ( op.type ) {
+            case COPY_PLAIN :
+                if ( end - pos < op.size ) {
+                    return false ;
+                }
+                if ( op_input ) {
+                    memcpy(address, buf.data() + pos, op.size) ;
+                }
+                pos += op.size ;
+                break ;
+            case COPY_BITFIELD : {
+                ATTRIBUTES * attr = op.attr ;
+                int value ;
+                if ( ! get(buf, pos, end, value) ) {
+                    return false ;
+                }
+                if ( op_input ) {
+                    PUT_BITFIELD(address, value, attr->size, attr->index[0].start, attr->index[0].size) ;
+                }
+            } break ;
+            case COPY_POINTER :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    if ( ! read_pointer(buf, pos, end, (void**)address + ii, op_input, addresses) ) {
+                        return false ;
+                    }
+                }
+                break ;
+            case COPY_STRING :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    std::string s ;
+                    if ( ! get_string(buf, pos, end, s) ) {
+                        return false ;
+                    }
+                    if ( op_input ) {
+                        *(std::string*)(address + ii * op.size) = s ;
+                    }
+                }
+                break ;
+            case COPY_WSTRING :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    std::string s ;
+                    if ( ! get_string(buf, pos, end, s) ) {
+                        return false ;
+                    }
+                    if ( op_input ) {
+                        ((std::wstring*)(address + ii * op.size))->assign((const wchar_t*)s.data(), s.size() / sizeof(wchar_t)) ;
+                    }
+                }
+                break ;
+            case COPY_NESTED :
+                for ( ii = 0 ; ii < op.count ; ii++ ) {
+                    if ( ! read_plan(buf, pos, end, *op.plan, address + ii * op.size, op_input, addresses) ) {
+                        return false ;
+                    }
+                }
+                break ;
+        }
+    }
+    return true ;
+}
+
+// MEMBER FUNCTION
+std::string Trick::BinaryCheckPointAgent::make_declaration( const Block& block) {
+
+    std::stringstream decl ;
+    int ii ;
+
+    // Same as the ClassicCheckPointAgent declarations.
+    decl << trickTypeCharString((TRICK_TYPE)block.type, block.user_type_name.c_str()) ;
+    ii = block.num_index - 1 ;
+    while ((ii >= 0) && (block.index[ii] == 0)) {
+        decl << "*" ;
+        ii-- ;
+    }
+    decl << " " << block.name ;
+    ii = 0 ;
+    while ((ii < block.num_index) && (block.index[ii] != 0)) {
+        decl << "[" << block.index[ii] << "]" ;
+        ii++ ;
+    }
+    return decl.str() ;
+}
+
+// MEMBER FUNCTION
+int Trick::BinaryCheckPointAgent::restore( std::istream* checkpoint_stream) {
+
+    std::vector<CheckPointFile*> files ;
+    std::map<std::string, char*> addresses ;
+    VARIABLE_MAP_ITER vit ;
+    int status = 0 ;
+
+    CheckPointFile * newest = new CheckPointFile ;
+    newest->file_name = file_name ;
+    files.push_back(newest) ;
+
+    if ( ! read_file(*newest, checkpoint_stream) ) {
+        status = 1 ;
+    } else {
+
+        // Declare the local allocations.
+        for ( unsigned int ii = 0 ; ii < newest->blocks.size() ; ii++ ) {
+            const Block & block = newest->blocks[ii] ;
+            if ( block.stcl == TRICK_LOCAL ) {
+                std::string decl = make_declaration(block) ;
+                if (debug_level) {
+                    std::cout << decl << ";" << std::endl ;
+                }
+                if ( mem_mgr->declare_var(decl.c_str()) == NULL ) {
+                    message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Could not declare %s.\n", decl.c_str()) ;
+                    status = 1 ;
+                }
+            }
+        }
+
+        // Pointers may refer to any named allocation.
+        for ( vit = mem_mgr->variable_map_begin() ; vit != mem_mgr->variable_map_end() ; vit++ ) {
+            addresses[vit->first] = (char*)vit->second->start ;
+        }
+
+        for ( unsigned int ii = 0 ; ii < newest->blocks.size() ; ii++ ) {
+            const Block & block = newest->blocks[ii] ;
+            std::map<std::string, char*>::iterator it = addresses.find(block.name) ;
+            ALLOC_INFO * alloc_info ;
+            const Block * data_block ;
+            size_t data_file ;
+
+            if ( it == addresses.end() ) {
+                // Anonymous extern allocations are not reloaded, as with the classic checkpoints.
+                if (debug_level) {
+                    std::cout << "Skipping " << block.name << std::endl ;
+                }
+                continue ;
+            }
+            alloc_info = mem_mgr->get_alloc_info_at(it->second) ;
+            if ( alloc_info == NULL or alloc_info->type != block.type or alloc_info->size != block.size or
+                 alloc_info->num != block.num ) {
+                message_publish(MSG_ERROR, "Checkpoint Agent ERROR: %s does not match its checkpoint and was not restored.\n",
+                 block.name.c_str()) ;
+                status = 1 ;
+                continue ;
+            }
+            data_block = find_data(files, 0, block, data_file) ;
+            if ( data_block == NULL ) {
+                status = 1 ;
+                continue ;
+            }
+
+            ATTRIBUTES attr ;
+            CopyPlan plan ;
+            size_t pos = data_block->data_offset ;
+            size_t end = data_block->data_offset + data_block->data_size ;
+            make_allocation_attr(alloc_info, attr) ;
+            add_var_ops(plan, &attr, 0, false, true) ;
+            if ( ! read_plan(files[data_file]->contents, pos, end, plan, (char*)alloc_info->start, true, addresses) or
+                 pos != end ) {
+                message_publish(MSG_ERROR, "Checkpoint Agent ERROR: The layout of %s changed since it was checkpointed.\n",
+                 block.name.c_str()) ;
+                status = 1 ;
+            }
+        }
+    }
+
+    for ( unsigned int ii = 0 ; ii < files.size() ; ii++ ) {
+        delete files[ii] ;
+    }
+
+    // The next checkpoint starts a new chain.
+    file_name.clear() ;
+    chain.clear() ;
+    last_hashes.clear() ;
+    restore_status = status ;
+
+    return status ;
+}
+
+// MEMBER FUNCTION
+int Trick::BinaryCheckPointAgent::write_classic_checkpoint( std::string binary_file_name, std::string classic_file_name) {
+
+    pid_t pid ;
+    int status ;
+
+    if ( ! is_binary_checkpoint(binary_file_name) ) {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: %s is not a binary checkpoint.\n", binary_file_name.c_str()) ;
+        return 1 ;
+    }
+
+    // The checkpoint is loaded over the memory of a copy of this process, then written as text.
+    if ((pid = fork()) == 0) {
+        std::ifstream in_s( binary_file_name.c_str(), std::ios::in | std::ios::binary) ;
+        set_file_name(binary_file_name) ;
+        mem_mgr->set_CheckPointAgent(this) ;
+        mem_mgr->init_from_checkpoint(&in_s) ;
+        mem_mgr->reset_CheckPointAgent() ;
+        if ( restore_status == 0 ) {
+            mem_mgr->write_checkpoint(classic_file_name.c_str()) ;
+        }
+        _exit(restore_status) ;
+    } else if ( pid < 0 ) {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Could not fork to convert %s.\n", binary_file_name.c_str()) ;
+        return 1 ;
+    }
+
+    if ( waitpid(pid, &status, 0) != pid or ! WIFEXITED(status) or WEXITSTATUS(status) != 0 ) {
+        message_publish(MSG_ERROR, "Checkpoint Agent ERROR: Could not convert %s to %s.\n",
+         binary_file_name.c_str(), classic_file_name.c_str()) ;
+        return 1 ;
+    }
+    return 0 ;
+}
+
+// STATIC MEMBER FUNCTION
+bool Trick::BinaryCheckPointAgent::is_binary_checkpoint( std::string file_name) {
+
+    char signature[sizeof(binary_signature)] ;
+    std::ifstream in_s( file_name.c_str(), std::ios::in | std::ios::binary) ;
+
+    return ( in_s.read(signature, sizeof(signature)) and ! memcmp(signature, binary_signature, sizeof(signature)) ) ;
+}
@@ -7,7 +7,13 @@
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <sched.h>
+#include <errno.h>
+#include <time.h>
 #include <string.h>
+#include <fstream>
 
 #ifdef _DMTCP
 #include "dmtcpaware.h"
@@ -16,6 +22,8 @@
 #include "trick/DMTCP.hh"
 #include "trick/CheckPointRestart.hh"
 #include "trick/MemoryManager.hh"
+#include "trick/BinaryCheckPointAgent.hh"
+#include "trick/MessagePublisher.hh"
 #include "trick/SimObject.hh"
 #include "trick/Executive.hh"
 #include "trick/exec_proto.hh"
@@ -26,6 +34,7 @@
 #include "trick/TrickConstant.hh"
 
 Trick::CheckPointRestart * the_cpr ;
+extern Trick::MessagePublisher * the_message_publisher ;
 
 Trick::CheckPointRestart::CheckPointRestart() {
 
@@ -36,6 +45,17 @@ Trick::CheckPointRestart::CheckPointRestart() {
     end_checkpoint = false ;
     safestore_enabled = false ;
     cpu_num = -1 ;
+    binary_checkpoint = false ;
+    incremental_checkpoint = false ;
+    binary_agent = NULL ;
+    async_checkpoint = false ;
+    last_checkpoint_status = 0 ;
+    last_checkpoint_write_time = 0.0 ;
+    skipped_checkpoints = 0 ;
+    async_checkpoint_timeout = 600.0 ;
+    checkpoint_pid = 0 ;
+    checkpoint_pid_print = false ;
+    checkpoint_pid_start = 0.0 ;
     safestore_time = TRICK_MAX_LONG_LONG ;
     load_checkpoint_file_name.clear() ;
 
@@ -96,6 +116,37 @@ const char * Trick::CheckPointRestart::get_output_file() {
     return output_file.c_str() ;
 }
 
+int Trick::CheckPointRestart::set_async_checkpoint(bool yes_no) {
+    async_checkpoint = yes_no ;
+    return(0) ;
+}
+
+int Trick::CheckPointRestart::set_async_checkpoint_timeout(double in_timeout) {
+    async_checkpoint_timeout = in_timeout ;
+    return(0) ;
+}
+
+int Trick::CheckPointRestart::set_binary_checkpoint(bool yes_no) {
+    binary_checkpoint = yes_no ;
+    return(0) ;
+}
+
+int Trick::CheckPointRestart::set_incremental_checkpoint(bool yes_no) {
+    incremental_checkpoint = yes_no ;
+    return(0) ;
+}
+
+Trick::BinaryCheckPointAgent * Trick::CheckPointRestart::get_binary_agent() {
+    if ( binary_agent == NULL ) {
+        binary_agent = new Trick::BinaryCheckPointAgent(trick_MM) ;
+    }
+    return binary_agent ;
+}
+
+int Trick::CheckPointRestart::convert_checkpoint(std::string binary_file_name, std::string text_file_name) {
+    return get_binary_agent()->write_classic_checkpoint(binary_file_name, text_file_name) ;
+}
+
 const char * Trick::CheckPointRestart::get_load_file() {
     return load_checkpoint_file_name.c_str() ;
 }
@@ -206,6 +257,14 @@ int Trick::CheckPointRestart::do_checkpoint(std::string file_name, bool print_st
         file_name_stream << "chkpnt_" << std::fixed << std::setprecision(6) << exec_get_sim_time() ;
         file_name = file_name_stream.str() ;
     }
+
+    // Only one checkpoint is written at a time.  Skip this one rather than stall the sim waiting for the child.
+    if ( checkpoint_in_progress() ) {
+        skipped_checkpoints++ ;
+        message_publish(MSG_WARNING, "Skipped checkpoint %s, checkpoint %s is still being written.\n",
+         file_name.c_str(), checkpoint_pid_file.c_str()) ;
+        return 1 ;
+    }
     output_file = std::string(command_line_args_get_output_dir()) + "/" + file_name ;
 
     checkpoint_queue.reset_curr_index() ;
@@ -213,10 +272,32 @@ int Trick::CheckPointRestart::do_checkpoint(std::string file_name, bool print_st
         curr_job->parent_object->call_function(curr_job) ;
     }
 
-    if ( cpu_num != -1 ) {
-    // if the user specified a cpu number for the checkpoint, fork a process to write the checkpoint
-        if ((pid = fork()) == 0) {
+    if ( binary_checkpoint ) {
+        get_binary_agent()->set_incremental(incremental_checkpoint) ;
+        binary_agent->set_file_name(output_file) ;
+        trick_MM->set_CheckPointAgent(binary_agent) ;
+    }
+
+    pid = -1 ;
+    if ( async_checkpoint or cpu_num != -1 ) {
+        // fork a process to write the checkpoint from its copy of memory while the sim continues.
+        // Another thread must not be changing the MemoryManager maps or publishing a message at the fork,
+        // the child would copy the maps half changed or find the lock held forever.
+        trick_MM->lock() ;
+        if ( the_message_publisher != NULL ) {
+            the_message_publisher->lock() ;
+        }
+        pid = fork() ;
+        if ( the_message_publisher != NULL ) {
+            the_message_publisher->unlock() ;
+        }
+        trick_MM->unlock() ;
+        if ( pid == 0 ) {
 #if __linux
+            struct sched_param param ;
+            param.sched_priority = 0 ;
+            // The child must not compete with the real-time threads of the sim.
+            sched_setscheduler(0, SCHED_OTHER, &param) ;
             if ( cpu_num >= 0 ) {
                 unsigned long mask;
                 mask = 1 << cpu_num ;
@@ -227,15 +308,20 @@ int Trick::CheckPointRestart::do_checkpoint(std::string file_name, bool print_st
             if ( cpu_num >= 0 ) {
             }
 #endif
-            if (obj_list.empty()) {
-                trick_MM->write_checkpoint(output_file.c_str()) ;
-            } else {
-                trick_MM->write_checkpoint(output_file.c_str(), obj_list);
-            }
-            _Exit(0) ;
+            _Exit(write_forked_checkpoint()) ;
+        } else if ( pid > 0 ) {
+            struct timespec now ;
+            clock_gettime(CLOCK_MONOTONIC, &now) ;
+            checkpoint_pid = pid ;
+            checkpoint_pid_file = file_name ;
+            checkpoint_pid_print = print_status ;
+            checkpoint_pid_start = now.tv_sec + now.tv_nsec * 1.0e-9 ;
+        } else {
+            message_publish(MSG_WARNING, "Could not fork to write checkpoint %s, writing it now.\n", file_name.c_str()) ;
         }
     }
-    else {
+
+    if ( pid < 0 ) {
     // no fork
         if (obj_list.empty()) {
             trick_MM->write_checkpoint(output_file.c_str()) ;
@@ -244,18 +330,130 @@ int Trick::CheckPointRestart::do_checkpoint(std::string file_name, bool print_st
         }
     }
 
+    if ( binary_checkpoint ) {
+        trick_MM->reset_CheckPointAgent() ;
+        binary_agent->set_file_name("") ;
+    }
+
     post_checkpoint_queue.reset_curr_index() ;
     while ( (curr_job = post_checkpoint_queue.get_next_job()) != NULL ) {
         curr_job->parent_object->call_function(curr_job) ;
     }
 
-    if ( print_status ) {
-        message_publish(MSG_INFO, "Dumped ASCII Checkpoint %s.\n", file_name.c_str()) ;
+    // A forked checkpoint is reported when the child finishes.
+    if ( print_status and pid < 0 ) {
+        if ( binary_checkpoint ) {
+            message_publish(MSG_INFO, "Dumped Binary Checkpoint %s.\n", file_name.c_str()) ;
+        } else {
+            message_publish(MSG_INFO, "Dumped ASCII Checkpoint %s.\n", file_name.c_str()) ;
+        }
+    }
+
+    return 0 ;
+}
+
+int Trick::CheckPointRestart::write_forked_checkpoint() {
+
+    std::string temp_file = output_file + ".tmp" ;
+    std::ofstream out_s( temp_file.c_str(), std::ios::out) ;
+
+    if ( ! out_s.is_open() ) {
+        message_publish(MSG_ERROR, "Couldn't open \"%s\".\n", temp_file.c_str()) ;
+        return 1 ;
+    }
+    if (obj_list.empty()) {
+        trick_MM->write_checkpoint(out_s) ;
+    } else {
+        trick_MM->write_checkpoint(out_s, obj_list);
+    }
+    out_s.close() ;
+    if ( out_s.fail() or rename(temp_file.c_str(), output_file.c_str()) != 0 ) {
+        unlink(temp_file.c_str()) ;
+        return 1 ;
+    }
+    return 0 ;
+}
+
+int Trick::CheckPointRestart::reap_checkpoint(bool block) {
+
+    int status = 0 ;
+    pid_t ret ;
+    struct timespec now ;
+
+    if ( checkpoint_pid <= 0 ) {
+        return 0 ;
+    }
+
+    while ( 1 ) {
+        ret = waitpid(checkpoint_pid, &status, WNOHANG) ;
+        if ( ret < 0 and errno == EINTR ) {
+            continue ;
+        }
+        if ( ret != 0 ) {
+            break ;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now) ;
+        if ( async_checkpoint_timeout > 0.0 and
+             now.tv_sec + now.tv_nsec * 1.0e-9 - checkpoint_pid_start > async_checkpoint_timeout ) {
+            // A child that is stuck would otherwise cause every later checkpoint to be skipped and hold up the shutdown.
+            message_publish(MSG_ERROR, "Checkpoint %s did not finish in %g seconds, stopping it.\n",
+             checkpoint_pid_file.c_str(), async_checkpoint_timeout) ;
+            kill(checkpoint_pid, SIGKILL) ;
+            do {
+                ret = waitpid(checkpoint_pid, &status, 0) ;
+            } while ( ret < 0 and errno == EINTR ) ;
+            unlink((std::string(command_line_args_get_output_dir()) + "/" + checkpoint_pid_file + ".tmp").c_str()) ;
+            break ;
+        }
+        if ( ! block ) {
+            break ;
+        }
+        usleep(1000) ;
     }
 
+    if ( ret == 0 ) {
+        // still writing
+        return 0 ;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now) ;
+    last_checkpoint_write_time = now.tv_sec + now.tv_nsec * 1.0e-9 - checkpoint_pid_start ;
+    checkpoint_pid = 0 ;
+
+    if ( ret > 0 and WIFEXITED(status) and WEXITSTATUS(status) == 0 ) {
+        last_checkpoint_status = 0 ;
+        if ( binary_checkpoint ) {
+            // The next incremental checkpoint builds on the one the child wrote.
+            binary_agent->adopt_checkpoint(std::string(command_line_args_get_output_dir()) + "/" + checkpoint_pid_file) ;
+        }
+        if ( checkpoint_pid_print ) {
+            message_publish(MSG_INFO, "Dumped %s Checkpoint %s in %.3f seconds.\n", binary_checkpoint ? "Binary" : "ASCII",
+             checkpoint_pid_file.c_str(), last_checkpoint_write_time) ;
+        }
+    } else {
+        last_checkpoint_status = 1 ;
+        if ( binary_checkpoint ) {
+            binary_agent->set_incremental(false) ;
+        }
+        message_publish(MSG_ERROR, "Checkpoint %s failed.\n", checkpoint_pid_file.c_str()) ;
+    }
     return 0 ;
 }
 
+bool Trick::CheckPointRestart::checkpoint_in_progress() {
+    reap_checkpoint(false) ;
+    return ( checkpoint_pid > 0 ) ;
+}
+
+int Trick::CheckPointRestart::wait_checkpoint() {
+    reap_checkpoint(true) ;
+    return last_checkpoint_status ;
+}
+
+int Trick::CheckPointRestart::poll_checkpoint() {
+    return reap_checkpoint(false) ;
+}
+
 int Trick::CheckPointRestart::write_checkpoint() {
 
     long long curr_time = exec_get_time_tics() ;
@@ -364,6 +562,7 @@ int Trick::CheckPointRestart::write_dmtcp_checkpoint() {
 
 int Trick::CheckPointRestart::write_pre_init_checkpoint() {
     if ( pre_init_checkpoint ) {
+        wait_checkpoint() ;
         checkpoint(std::string("chkpnt_pre_init")) ;
     }
     return 0  ;
@@ -371,21 +570,27 @@ int Trick::CheckPointRestart::write_pre_init_checkpoint() {
 
 int Trick::CheckPointRestart::write_post_init_checkpoint() {
     if ( post_init_checkpoint ) {
+        wait_checkpoint() ;
         checkpoint(std::string("chkpnt_post_init")) ;
     }
     return 0  ;
 }
 
 int Trick::CheckPointRestart::write_end_checkpoint() {
+    // The sim is stopping, the end checkpoint waits for the previous one instead of being skipped.
+    wait_checkpoint() ;
     if ( end_checkpoint ) {
         checkpoint(std::string("chkpnt_end")) ;
     }
+    // Do not leave a checkpoint half written when the sim exits.
+    wait_checkpoint() ;
     return 0  ;
 }
 
 int Trick::CheckPointRestart::safestore_checkpoint() {
 
     if ( safestore_enabled) {
+        // Skipped when the previous checkpoint is still being written.
         checkpoint(std::string("chkpnt_safestore"), false) ;
         safestore_time += safestore_period ;
     }
@@ -409,6 +614,8 @@ int Trick::CheckPointRestart::load_checkpoint_job() {
     if ( ! load_checkpoint_file_name.empty() ) {
 
         if ( stat( load_checkpoint_file_name.c_str() , &temp_buf) == 0 ) {
+            wait_checkpoint() ;
+
             preload_checkpoint_queue.reset_curr_index() ;
             while ( (curr_job = preload_checkpoint_queue.get_next_job()) != NULL ) {
                 curr_job->call() ;
@@ -421,7 +628,14 @@ int Trick::CheckPointRestart::load_checkpoint_job() {
             restart_queue.clear() ;
 
             message_publish(MSG_INFO, "Load checkpoint file %s.\n", load_checkpoint_file_name.c_str()) ;
-            trick_MM->init_from_checkpoint(load_checkpoint_file_name.c_str()) ;
+            if ( Trick::BinaryCheckPointAgent::is_binary_checkpoint(load_checkpoint_file_name) ) {
+                get_binary_agent()->set_file_name(load_checkpoint_file_name) ;
+                trick_MM->set_CheckPointAgent(binary_agent) ;
+                trick_MM->init_from_checkpoint(load_checkpoint_file_name.c_str()) ;
+                trick_MM->reset_CheckPointAgent() ;
+            } else {
+                trick_MM->init_from_checkpoint(load_checkpoint_file_name.c_str()) ;
+            }
 
             message_publish(MSG_INFO, "Finished loading checkpoint file.  Calling restart jobs.\n") ;
 
@@ -110,6 +110,66 @@ extern "C" int checkpoint_cpu( int in_cpu_num ) {
 }
 
 
+/**
+ * @relates Trick::CheckPointRestart
+ * @copydoc Trick::CheckPointRestart::set_binary_checkpoint
+ */
+extern "C" int checkpoint_binary( int yes_no ) {
+    the_cpr->set_binary_checkpoint(bool(yes_no)) ;
+    return(0) ;
+}
+
+/**
+ * @relates Trick::CheckPointRestart
+ * @copydoc Trick::CheckPointRestart::set_incremental_checkpoint
+ */
+extern "C" int checkpoint_incremental( int yes_no ) {
+    the_cpr->set_incremental_checkpoint(bool(yes_no)) ;
+    return(0) ;
+}
+
+/**
+ * @relates Trick::CheckPointRestart
+ * @copydoc Trick::CheckPointRestart::convert_checkpoint
+ */
+extern "C" int checkpoint_convert( const char * binary_file_name , const char * text_file_name ) {
+    return the_cpr->convert_checkpoint(std::string(binary_file_name), std::string(text_file_name)) ;
+}
+
+/**
+ * @relates Trick::CheckPointRestart
+ * @copydoc Trick::CheckPointRestart::set_async_checkpoint
+ */
+extern "C" int checkpoint_async( int yes_no ) {
+    the_cpr->set_async_checkpoint(bool(yes_no)) ;
+    return(0) ;
+}
+
+/**
+ * @relates Trick::CheckPointRestart
+ * @copydoc Trick::CheckPointRestart::set_async_checkpoint_timeout
+ */
+extern "C" int checkpoint_async_timeout( double in_timeout ) {
+    the_cpr->set_async_checkpoint_timeout(in_timeout) ;
+    return(0) ;
+}
+
+/**
+ * @relates Trick::CheckPointRestart
+ * @copydoc Trick::CheckPointRestart::checkpoint_in_progress
+ */
+extern "C" int checkpoint_in_progress() {
+    return (int)the_cpr->checkpoint_in_progress() ;
+}
+
+/**
+ * @relates Trick::CheckPointRestart
+ * @copydoc Trick::CheckPointRestart::wait_checkpoint
+ */
+extern "C" int checkpoint_wait() {
+    return the_cpr->wait_checkpoint() ;
+}
+
 /**
  * @relates Trick::CheckPointRestart
  * @copydoc Trick::CheckPointRestart::get_output_file
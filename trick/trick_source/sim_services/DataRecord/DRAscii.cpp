@@ -8,6 +8,7 @@ PROGRAMMERS:
 */
 
 #include <iostream>
+#include <sstream>
 #include <stdlib.h>
 #include <string.h>
 
@@ -23,6 +24,7 @@ Trick::DRAscii::DRAscii( std::string in_name ) : Trick::DataRecordGroup( in_name
     ascii_float_format = "%20.8g" ;
     ascii_double_format = "%20.16g" ;
     delimiter = ",";
+    ascii_round_trip = false ;
     register_group_with_mm(this, "Trick::DRAscii") ;
 }
 
@@ -35,8 +37,10 @@ int Trick::DRAscii::format_specific_header( std::fstream & out_st ) {
 @details
 -# If the #delimiter is not empty and not a comma then set the file extension to ".txt"
 -# Else set the file extension to ".csv"
--# Allocate enough memory to hold #record_size of records in memory
--# Open the log file
+-# Parse the float and double formats for the row builder
+-# Allocate enough memory to hold a block of about #write_block_size bytes plus one "worst case"
+   record of #record_size bytes per variable
+-# Open the log file, compressed if #compression is set
    -# Return an error if the open failed.
 -# Write out the title line of the log file.  The title line includes the names of
    recorded variables and the units of measurement separated by the #delimiter
@@ -46,7 +50,8 @@ int Trick::DRAscii::format_specific_header( std::fstream & out_st ) {
 int Trick::DRAscii::format_specific_init() {
 
     unsigned int jj ;
-    std::streampos before_write;
+    unsigned int buff_size ;
+    std::ostringstream title ;
 
     /* Store log information in csv/txt file */
     if ( ! delimiter.empty()  &&  delimiter.compare(",") != 0 ) {
@@ -55,84 +60,117 @@ int Trick::DRAscii::format_specific_init() {
         file_name.append(".csv");
     }
 
+    float_format.set_format(ascii_float_format) ;
+    float_format.set_round_trip(ascii_round_trip) ;
+    double_format.set_format(ascii_double_format) ;
+    double_format.set_round_trip(ascii_round_trip) ;
+
     /* Calculate a "worst case" for space used for 1 record. */
-    writer_buff = (char *)calloc(1 , record_size * rec_buffer.size()) ;
+    max_row_size = (record_size + delimiter.length()) * rec_buffer.size() + 1 ;
+    buff_size = write_block_size + max_row_size ;
+    writer_buff = (char *)calloc(1 , buff_size) ;
 
     /* This loop touches all of the memory locations in the allocation forcing the
        system to actually do the allocation */
-    for ( jj= 0 ; jj < record_size * rec_buffer.size() ; jj += 1024 ) {
+    for ( jj= 0 ; jj < buff_size ; jj += 1024 ) {
         writer_buff[jj] = 1 ;
     }
-    writer_buff[record_size * rec_buffer.size() - 1] = 1 ;
+    writer_buff[buff_size - 1] = 1 ;
 
-    out_stream.open(file_name.c_str(), std::fstream::out | std::fstream::app ) ;
-    if ( !out_stream || !out_stream.good() ) {
+    if ( out_stream.open(file_name, compression, compression_level, true) == -1 ) {
         message_publish(MSG_ERROR, "Can't open Data Record file %s.\n", file_name.c_str()) ;
         record = false ;
         return -1 ;
     }
-    before_write = out_stream.tellp();
     // Write out the title line of the recording file
     /* Start with the 1st item in the buffer which should be "sys.exec.out.time" */
-    out_stream << rec_buffer[0]->ref->reference ;
+    title << rec_buffer[0]->ref->reference ;
     if ( rec_buffer[0]->ref->attr->units != NULL ) {
         if ( rec_buffer[0]->ref->attr->mods & TRICK_MODS_UNITSDASHDASH ) {
-            out_stream << " {--}" ;
+            title << " {--}" ;
         } else {
-            out_stream << " {" << rec_buffer[0]->ref->attr->units << "}" ;
+            title << " {" << rec_buffer[0]->ref->attr->units << "}" ;
         }
     }
     
     /* Write out specified recorded parameters */
     for (jj = 1; jj < rec_buffer.size() ; jj++) {
-        out_stream << delimiter << rec_buffer[jj]->ref->reference ;
+        title << delimiter << rec_buffer[jj]->ref->reference ;
 
         if ( rec_buffer[jj]->ref->attr->units != NULL ) {
             if ( rec_buffer[jj]->ref->attr->mods & TRICK_MODS_UNITSDASHDASH ) {
-                out_stream << " {--}" ;
+                title << " {--}" ;
             } else {
-                out_stream << " {" << rec_buffer[jj]->ref->attr->units << "}" ;
+                title << " {" << rec_buffer[jj]->ref->attr->units << "}" ;
             }
         }
     }
-    out_stream << std::endl ;
-    total_bytes_written += out_stream.tellp() - before_write;
+    title << std::endl ;
+    total_bytes_written += out_stream.write(title.str().c_str(), title.str().length()) ;
     return(0) ;
 }
 
 /**
 @details
--# While there is data in memory that has not been written to disk
-   -# Write out the time to a temporary #writer_buff
-   -# Write out each of the other parameter values preceded by the delimiter to the temporary #writer_buff
-   -# Write #writer_buff to the output file
--# Flush the output file stream
--# Return the number of bytes written
+-# Append the time to the row
+-# Append each of the other parameter values preceded by the delimiter
+-# End the line
 */
-int Trick::DRAscii::format_specific_write_data(unsigned int writer_offset) {
+void Trick::DRAscii::format_row( Trick::AsciiRow & row , unsigned int writer_offset ) {
     unsigned int ii ;
-    char *buf;
-
-    buf = writer_buff ;
 
     /* Write out the first parameters (time) */
-    copy_data_ascii_item(rec_buffer[0], writer_offset, buf );
-    buf += strlen(buf);
+    copy_data_ascii_item(rec_buffer[0], writer_offset, row );
 
     /* Write out all other parameters */
     for (ii = 1; ii < rec_buffer.size() ; ii++) {
-        strcat(buf, delimiter.c_str() );
-        buf += delimiter.length() ;
-        copy_data_ascii_item(rec_buffer[ii], writer_offset, buf );
-        buf += strlen(buf);
+        row.append(delimiter) ;
+        copy_data_ascii_item(rec_buffer[ii], writer_offset, row );
     }
+    row.append('\n') ;
+}
 
-    out_stream << writer_buff << std::endl ;
+int Trick::DRAscii::format_specific_write_data(unsigned int writer_offset) {
+    return format_specific_write_rows(writer_offset, 1) ;
+}
 
-    /*! Flush the output */
-    out_stream.flush() ;
-    /*! +1 for endl */
-    return(strlen(writer_buff) + 1) ;
+/**
+@details
+-# Format consecutive records into #writer_buff
+-# A record that does not fit after the records already in the buffer, as with long strings, is formatted
+   again at the start of the buffer after the buffer is written.  A record that does not fit in the whole
+   buffer is dropped with a warning.
+-# When the buffer holds #write_block_size bytes or more, write it to the output file with one call.
+   The file is no longer flushed after every record.
+-# Return the number of bytes written
+*/
+int Trick::DRAscii::format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) {
+    unsigned int ii ;
+    int bytes = 0 ;
+    Trick::AsciiRow row(writer_buff, write_block_size + max_row_size) ;
+
+    for ( ii = 0 ; ii < num_rows ; ii++ ) {
+        size_t start = row.length() ;
+        format_row(row, writer_offset + ii) ;
+        if ( row.overflow() and start > 0 ) {
+            bytes += out_stream.write( writer_buff , start ) ;
+            row.clear() ;
+            format_row(row, writer_offset + ii) ;
+        }
+        if ( row.overflow() ) {
+            message_publish(MSG_WARNING, "Data record group %s: record too long for the buffer, SKIPPING IT.\n",
+             group_name.c_str()) ;
+            row.clear() ;
+        }
+        if ( row.length() >= write_block_size ) {
+            bytes += out_stream.write( writer_buff , row.length() ) ;
+            row.clear() ;
+        }
+    }
+    if ( row.length() > 0 ) {
+        bytes += out_stream.write( writer_buff , row.length() ) ;
+    }
+    return(bytes) ;
 }
 
 /**
@@ -149,11 +187,13 @@ int Trick::DRAscii::format_specific_shutdown() {
 
 int Trick::DRAscii::set_ascii_float_format( std::string in_float_format ) {
     ascii_float_format = in_float_format ;
+    float_format.set_format(ascii_float_format) ;
     return(0) ;
 }
 
 int Trick::DRAscii::set_ascii_double_format( std::string in_double_format ) {
     ascii_double_format = in_double_format ;
+    double_format.set_format(ascii_double_format) ;
     return(0) ;
 }
 
@@ -170,10 +210,26 @@ int Trick::DRAscii::set_single_prec_only( bool in_single_prec_only ) {
     else {
         ascii_double_format = "%20.16g";
     }
+    double_format.set_format(ascii_double_format) ;
     return(0) ;
 }
 
-int Trick::DRAscii::copy_data_ascii_item( Trick::DataRecordBuffer * DI, int item_num, char *buf ) {
+int Trick::DRAscii::set_ascii_round_trip( bool in_ascii_round_trip ) {
+    ascii_round_trip = in_ascii_round_trip ;
+    float_format.set_round_trip(ascii_round_trip) ;
+    double_format.set_round_trip(ascii_round_trip) ;
+    return(0) ;
+}
+
+/**
+@details
+-# Append the value with the same characters as the printf conversion for its type.  Integers are
+   converted without printf.
+-# Float and double values use the parsed #ascii_float_format and #ascii_double_format, or the shortest
+   round trip text if #ascii_round_trip is set.  Doubles are written as floats when #single_prec_only
+   is set with #ascii_round_trip.
+*/
+int Trick::DRAscii::copy_data_ascii_item( Trick::DataRecordBuffer * DI, int item_num, Trick::AsciiRow & row ) {
 
     char *address = 0;
 
@@ -184,26 +240,33 @@ int Trick::DRAscii::copy_data_ascii_item( Trick::DataRecordBuffer * DI, int item
 
     switch (DI->ref->attr->type) {
         case TRICK_CHARACTER:
-            sprintf(buf, "%c", *((char *) address));
+            /* printf "%c" of a null character ends the string */
+            if ( *((char *) address) != '\0' ) {
+                row.append(*((char *) address));
+            }
             break;
 
         case TRICK_UNSIGNED_CHARACTER:
 #if ( __linux | __sgi )
         case TRICK_BOOLEAN:
 #endif
-            sprintf(buf, "%u", *((unsigned char *) address));
+            row.append_uint(*((unsigned char *) address));
             break;
 
         case TRICK_STRING:
-            sprintf(buf, "%s", *((char **) address));
+            if ( *((char **) address) != NULL ) {
+                row.append(*((char **) address));
+            } else {
+                row.append("(null)");
+            }
             break;
 
         case TRICK_SHORT:
-            sprintf(buf, "%d", *((short *) address));
+            row.append_int(*((short *) address));
             break;
 
         case TRICK_UNSIGNED_SHORT:
-            sprintf(buf, "%u", *((unsigned short *) address));
+            row.append_uint(*((unsigned short *) address));
             break;
 
         case TRICK_ENUMERATED:
@@ -211,45 +274,49 @@ int Trick::DRAscii::copy_data_ascii_item( Trick::DataRecordBuffer * DI, int item
 #if ( __sun | __APPLE__ )
         case TRICK_BOOLEAN:
 #endif
-            sprintf(buf, "%d", *((int *) address));
+            row.append_int(*((int *) address));
             break;
 
         case TRICK_UNSIGNED_INTEGER:
-            sprintf(buf, "%u", *((unsigned int *) address));
+            row.append_uint(*((unsigned int *) address));
             break;
 
         case TRICK_LONG:
-            sprintf(buf, "%ld", *((long *) address));
+            row.append_int(*((long *) address));
             break;
 
         case TRICK_UNSIGNED_LONG:
-            sprintf(buf, "%lu", *((unsigned long *) address));
+            row.append_uint(*((unsigned long *) address));
             break;
 
         case TRICK_FLOAT:
-            sprintf(buf, ascii_float_format.c_str() , *((float *) address));
+            row.append_float(*((float *) address), float_format);
             break;
 
         case TRICK_DOUBLE:
-            sprintf(buf, ascii_double_format.c_str() , *((double *) address));
+            if ( single_prec_only and double_format.round_trip ) {
+                row.append_float((float)*((double *) address), double_format);
+            } else {
+                row.append_double(*((double *) address), double_format);
+            }
             break;
 
         case TRICK_BITFIELD:
             sbf = GET_BITFIELD(address, DI->ref->attr->size, DI->ref->attr->index[0].start, DI->ref->attr->index[0].size);
-            sprintf(buf, "%d", sbf);
+            row.append_int(sbf);
             break;
 
         case TRICK_UNSIGNED_BITFIELD:
             bf = GET_UNSIGNED_BITFIELD(address, DI->ref->attr->size, DI->ref->attr->index[0].start, DI->ref->attr->index[0].size);
-            sprintf(buf, "%lu", bf);
+            row.append_uint(bf);
             break;
 
         case TRICK_LONG_LONG:
-            sprintf(buf, "%lld", *((long long *) address));
+            row.append_int(*((long long *) address));
             break;
 
         case TRICK_UNSIGNED_LONG_LONG:
-            sprintf(buf, "%llu", *((unsigned long long *) address));
+            row.append_uint(*((unsigned long long *) address));
             break;
         default:
             break;
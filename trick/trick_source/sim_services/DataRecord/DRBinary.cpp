@@ -9,9 +9,8 @@ PROGRAMMERS:
 #include <iostream>
 #include <stdlib.h>
 #include <string.h>
-#include <fcntl.h>
-#include <sys/stat.h>
-#include <unistd.h>
+#include <limits.h>
+#include <vector>
 
 #include "trick/DRBinary.hh"
 #include "trick/command_line_protos.h"
@@ -36,8 +35,8 @@ int Trick::DRBinary::format_specific_header( std::fstream & out_stream ) {
 /**
 @details
 -# Set the file extension to ".trk"
--# Allocate enough memory to hold #record_size of records in memory
--# Open the log file
+-# Allocate enough memory to hold a block of records of about #write_block_size bytes
+-# Open the log file, compressed if #compression is set
    -# Return an error if the open failed
 -# Write out the magic Trick-07-[LB] keyword, L for little endian, B for big.
 -# Write out the number of variables recorded
@@ -46,15 +45,18 @@ int Trick::DRBinary::format_specific_header( std::fstream & out_stream ) {
    -# Write out the units
    -# Write out the type
    -# Write out the size
+-# The header pieces are gathered and written with writev
 -# Declare the recording group to the memory manager so that the group can be checkpointed
    and restored
 */
 int Trick::DRBinary::format_specific_init() {
 
     unsigned int jj ;
-    int write_value ;
+    unsigned int buff_size ;
     /* number of bytes written to data record */
     int bytes = 0 ;
+    std::vector< int > header_ints ;
+    std::vector< struct iovec > iov ;
 
     union {
         long l;
@@ -63,70 +65,93 @@ int Trick::DRBinary::format_specific_init() {
 
     file_name.append(".trk");
 
-    /* Calculate a "worst case" for space used for 1 record. */
-    writer_buff = (char *)calloc(1 , record_size * rec_buffer.size()) ;
+    /* A row is the sum of the variable sizes.  Hold as many rows as fit in a write block. */
+    row_size = 0 ;
+    for (jj = 0; jj < rec_buffer.size(); jj++) {
+        row_size += rec_buffer[jj]->ref->attr->size ;
+    }
+    rows_per_block = write_block_size / row_size ;
+    if ( rows_per_block == 0 ) {
+        rows_per_block = 1 ;
+    }
+    buff_size = rows_per_block * row_size ;
+    writer_buff = (char *)calloc(1 , buff_size) ;
 
     /* This loop touches all of the memory locations in the allocation forcing the
        system to actually do the allocation */
-    for ( jj= 0 ; jj < record_size * rec_buffer.size() ; jj += 1024 ) {
+    for ( jj= 0 ; jj < buff_size ; jj += 1024 ) {
         writer_buff[jj] = 1 ;
     }
-    writer_buff[record_size * rec_buffer.size() - 1] = 1 ;
+    writer_buff[buff_size - 1] = 1 ;
 
     /* start header information in trk file */
-    if ((fd = creat(file_name.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)) == -1) {
+    if ( stream.open(file_name, compression, compression_level) == -1 ) {
         record = false ;
         return (-1) ;
     }
 
+    /* Collect the integers first so the vector does not move while iovecs point into it. */
+    header_ints.push_back(rec_buffer.size()) ;
+    for (jj = 0; jj < rec_buffer.size(); jj++) {
+        const char * units = ( rec_buffer[jj]->ref->attr->mods & TRICK_MODS_UNITSDASHDASH ) ?
+         "--" : rec_buffer[jj]->ref->attr->units ;
+        header_ints.push_back(strlen(rec_buffer[jj]->ref->reference)) ;
+        header_ints.push_back(strlen(units)) ;
+        header_ints.push_back(rec_buffer[jj]->ref->attr->type) ;
+    }
 
     /* Check to see if data is being recorded in little endian
      * byte order, and add little endian line if so.
      */
     byte_order_union.l = 1 ;
     if (byte_order_union.c[sizeof(long)-1] != 1) {
-        bytes += write( fd , "Trick-10-L", (size_t)10 ) ;
-        
+        add_iovec(iov, "Trick-10-L", (size_t)10) ;
     } else {
-        bytes += write( fd , "Trick-10-B", (size_t)10 ) ;
+        add_iovec(iov, "Trick-10-B", (size_t)10) ;
     }
-    write_value = rec_buffer.size() ;
-    bytes += write( fd , &write_value , sizeof(int) ) ;
+    add_iovec(iov, &header_ints[0] , sizeof(int)) ;
 
     for (jj = 0; jj < rec_buffer.size(); jj++) {
         /* name */
-        write_value = strlen(rec_buffer[jj]->ref->reference) ;
-        bytes += write( fd , &write_value , sizeof(int)) ;
-        bytes += write( fd , rec_buffer[jj]->ref->reference , write_value ) ;
+        add_iovec(iov, &header_ints[jj*3 + 1] , sizeof(int)) ;
+        add_iovec(iov, rec_buffer[jj]->ref->reference , header_ints[jj*3 + 1]) ;
 
         /* units */
+        add_iovec(iov, &header_ints[jj*3 + 2] , sizeof(int)) ;
         if ( rec_buffer[jj]->ref->attr->mods & TRICK_MODS_UNITSDASHDASH ) {
-            write_value = strlen("--") ;
-            bytes += write( fd , &write_value , sizeof(int)) ;
-            bytes += write( fd , "--" , write_value ) ;
+            add_iovec(iov, "--" , header_ints[jj*3 + 2]) ;
         } else {
-            write_value = strlen(rec_buffer[jj]->ref->attr->units) ;
-            bytes += write( fd , &write_value , sizeof(int)) ;
-            bytes += write( fd , rec_buffer[jj]->ref->attr->units , write_value ) ;
+            add_iovec(iov, rec_buffer[jj]->ref->attr->units , header_ints[jj*3 + 2]) ;
         }
 
-        write_value = rec_buffer[jj]->ref->attr->type ;
-        bytes += write( fd , &write_value , sizeof(int)) ;
+        /* type and size */
+        add_iovec(iov, &header_ints[jj*3 + 3] , sizeof(int)) ;
+        add_iovec(iov, &rec_buffer[jj]->ref->attr->size , sizeof(int)) ;
+    }
 
-        bytes += write( fd , &rec_buffer[jj]->ref->attr->size , sizeof(int)) ;
+    /* writev takes at most IOV_MAX buffers per call */
+    for ( jj = 0 ; jj < iov.size() ; jj += IOV_MAX ) {
+        int count = ( iov.size() - jj > IOV_MAX ) ? IOV_MAX : iov.size() - jj ;
+        bytes += stream.writev( &iov[jj] , count ) ;
     }
     total_bytes_written += bytes;
     return(0) ;
 }
 
+void Trick::DRBinary::add_iovec( std::vector< struct iovec > & iov , const void * base , size_t len ) {
+    struct iovec piece ;
+    piece.iov_base = (void *)base ;
+    piece.iov_len = len ;
+    iov.push_back(piece) ;
+}
+
 /**
 @details
--# While there is data in memory that has not been written to disk
-   -# Write out each of the other parameter values to the temporary #writer_buff
-   -# Write #writer_buff to the output file
--# return the number of bytes written
+-# Copy each of the parameter values of one record to dest
+-# Bitfields are extracted to a full integer of the recorded size
+-# return the number of bytes copied
 */
-int Trick::DRBinary::format_specific_write_data(unsigned int writer_offset) {
+unsigned int Trick::DRBinary::pack_record( char * dest , unsigned int writer_offset ) {
 
 	unsigned long bf;
 	int sbf;
@@ -155,19 +180,19 @@ int Trick::DRBinary::format_specific_write_data(unsigned int writer_offset) {
             case TRICK_UNSIGNED_LONG_LONG:
             case TRICK_STRUCTURED:
             case TRICK_DOUBLE:
-                memcpy(writer_buff + len, address, (size_t)rec_buffer[ii]->ref->attr->size);
+                memcpy(dest + len, address, (size_t)rec_buffer[ii]->ref->attr->size);
                 break;
 
             case TRICK_BITFIELD:
                 sbf = GET_BITFIELD(address, rec_buffer[ii]->ref->attr->size,
                  rec_buffer[ii]->ref->attr->index[0].start, rec_buffer[ii]->ref->attr->index[0].size);
-                memcpy(writer_buff + len, &sbf, (size_t)rec_buffer[ii]->ref->attr->size);
+                memcpy(dest + len, &sbf, (size_t)rec_buffer[ii]->ref->attr->size);
                 break;
 
             case TRICK_UNSIGNED_BITFIELD:
                 bf = GET_UNSIGNED_BITFIELD(address, rec_buffer[ii]->ref->attr->size,
                  rec_buffer[ii]->ref->attr->index[0].start, rec_buffer[ii]->ref->attr->index[0].size);
-                memcpy(writer_buff + len, &bf, (size_t)rec_buffer[ii]->ref->attr->size);
+                memcpy(dest + len, &bf, (size_t)rec_buffer[ii]->ref->attr->size);
                 break;
 
             default:
@@ -177,7 +202,43 @@ int Trick::DRBinary::format_specific_write_data(unsigned int writer_offset) {
 
     }
 
-    return write( fd , writer_buff , len) ;
+    return len ;
+}
+
+/**
+@details
+-# Pack one record into #writer_buff and write it to the output file
+-# return the number of bytes written
+*/
+int Trick::DRBinary::format_specific_write_data(unsigned int writer_offset) {
+    return stream.write( writer_buff , pack_record(writer_buff, writer_offset)) ;
+}
+
+/**
+@details
+-# Pack consecutive records into #writer_buff until it holds #rows_per_block records
+-# Write each full block to the output file with one call
+-# return the number of bytes written
+*/
+int Trick::DRBinary::format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) {
+
+    unsigned int ii ;
+    unsigned int len = 0 ;
+    unsigned int rows_in_block = 0 ;
+    int bytes = 0 ;
+
+    for ( ii = 0 ; ii < num_rows ; ii++ ) {
+        len += pack_record(writer_buff + len, writer_offset + ii) ;
+        if ( ++rows_in_block == rows_per_block ) {
+            bytes += stream.write( writer_buff , len ) ;
+            len = 0 ;
+            rows_in_block = 0 ;
+        }
+    }
+    if ( len > 0 ) {
+        bytes += stream.write( writer_buff , len ) ;
+    }
+    return bytes ;
 }
 
 /**
@@ -187,7 +248,7 @@ int Trick::DRBinary::format_specific_write_data(unsigned int writer_offset) {
 int Trick::DRBinary::format_specific_shutdown() {
 
     if ( inited ) {
-        close(fd) ;
+        stream.close() ;
     }
     return(0) ;
 }
\ No newline at end of file
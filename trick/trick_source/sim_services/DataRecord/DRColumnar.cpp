@@ -0,0 +1,295 @@
+/*
+PURPOSE:
+    (Data record to disk in columnar chunks.)
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <sys/uio.h>
+
+#include "trick/DRColumnar.hh"
+#include "trick/columnar_log.h"
+#include "trick/command_line_protos.h"
+#include "trick/memorymanager_c_intf.h"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+#include "trick/bitfield_proto.h"
+
+Trick::DRColumnar::DRColumnar( std::string in_name ) :
+ Trick::DataRecordGroup(in_name) ,
+ rows_per_chunk(4096) ,
+ chunk_rows(0) ,
+ file_offset(0) {
+    register_group_with_mm(this, "Trick::DRColumnar") ;
+}
+
+int Trick::DRColumnar::set_chunk_size( unsigned int rows ) {
+    if ( rows == 0 ) {
+        return(-1) ;
+    }
+    rows_per_chunk = rows ;
+    return(0) ;
+}
+
+int Trick::DRColumnar::format_specific_header( std::fstream & out_stream ) {
+    out_stream << " byte_order is " << byte_order << " columnar" << std::endl ;
+    return(0) ;
+}
+
+/* Returns the recorded value as a double for the chunk ranges.  Types without a value range return 0. */
+static double column_value( const char * address , int type , int size ) {
+    switch ( type ) {
+        case TRICK_CHARACTER: return *(const char *)address ;
+        case TRICK_UNSIGNED_CHARACTER: return *(const unsigned char *)address ;
+        case TRICK_SHORT: return *(const short *)address ;
+        case TRICK_UNSIGNED_SHORT: return *(const unsigned short *)address ;
+        case TRICK_ENUMERATED:
+        case TRICK_INTEGER: return *(const int *)address ;
+        case TRICK_UNSIGNED_INTEGER: return *(const unsigned int *)address ;
+        case TRICK_LONG: return *(const long *)address ;
+        case TRICK_UNSIGNED_LONG: return *(const unsigned long *)address ;
+        case TRICK_LONG_LONG: return *(const long long *)address ;
+        case TRICK_UNSIGNED_LONG_LONG: return *(const unsigned long long *)address ;
+        case TRICK_FLOAT: return *(const float *)address ;
+        case TRICK_DOUBLE: return *(const double *)address ;
+        case TRICK_BOOLEAN:
+        case TRICK_BITFIELD:
+        case TRICK_UNSIGNED_BITFIELD:
+            switch ( size ) {
+                case 1: return ( type == TRICK_BITFIELD ) ? *(const char *)address : *(const unsigned char *)address ;
+                case 2: return ( type == TRICK_BITFIELD ) ? *(const short *)address : *(const unsigned short *)address ;
+                case 4: return ( type == TRICK_BITFIELD ) ? *(const int *)address : *(const unsigned int *)address ;
+                default: return 0.0 ;
+            }
+        default:
+            return 0.0 ;
+    }
+}
+
+/**
+@details
+-# Set the file extension to ".trkc"
+-# Allocate one chunk of #rows_per_chunk records.  Each variable gets a contiguous column.
+-# Open the log file.  Compression is not applied to this format.
+   -# Return an error if the open failed
+-# Write out the magic Trick-CL-[LB] keyword, L for little endian, B for big.
+-# Write out the number of variables and the name, units, type, and size of each as Trick::DRBinary does
+*/
+int Trick::DRColumnar::format_specific_init() {
+
+    unsigned int jj ;
+    unsigned int buff_size = 0 ;
+    int value ;
+    std::string header ;
+
+    union {
+        long l;
+        char c[sizeof(long)];
+    } byte_order_union;
+
+    file_name.append(".trkc");
+
+    column_offset.clear() ;
+    for (jj = 0; jj < rec_buffer.size(); jj++) {
+        column_offset.push_back(buff_size) ;
+        buff_size += rows_per_chunk * rec_buffer[jj]->ref->attr->size ;
+    }
+    column_range.assign(rec_buffer.size() * 2, 0.0) ;
+    writer_buff = (char *)calloc(1 , buff_size) ;
+
+    /* This loop touches all of the memory locations in the allocation forcing the
+       system to actually do the allocation */
+    for ( jj= 0 ; jj < buff_size ; jj += 1024 ) {
+        writer_buff[jj] = 1 ;
+    }
+    writer_buff[buff_size - 1] = 1 ;
+
+    if ( compression != DR_No_Compression ) {
+        message_publish(MSG_WARNING, "Data record group %s: the columnar format is not compressed.\n",
+         group_name.c_str()) ;
+    }
+    if ( stream.open(file_name) == -1 ) {
+        message_publish(MSG_ERROR, "Can't open Data Record file %s.\n", file_name.c_str()) ;
+        record = false ;
+        return (-1) ;
+    }
+
+    byte_order_union.l = 1 ;
+    if (byte_order_union.c[sizeof(long)-1] != 1) {
+        header.append(TRICK_COLUMNAR_MAGIC "-L") ;
+    } else {
+        header.append(TRICK_COLUMNAR_MAGIC "-B") ;
+    }
+    value = rec_buffer.size() ;
+    header.append((char *)&value, sizeof(int)) ;
+
+    for (jj = 0; jj < rec_buffer.size(); jj++) {
+        const char * units = ( rec_buffer[jj]->ref->attr->mods & TRICK_MODS_UNITSDASHDASH ) ?
+         "--" : rec_buffer[jj]->ref->attr->units ;
+
+        value = strlen(rec_buffer[jj]->ref->reference) ;
+        header.append((char *)&value, sizeof(int)) ;
+        header.append(rec_buffer[jj]->ref->reference) ;
+
+        value = strlen(units) ;
+        header.append((char *)&value, sizeof(int)) ;
+        header.append(units) ;
+
+        value = rec_buffer[jj]->ref->attr->type ;
+        header.append((char *)&value, sizeof(int)) ;
+        header.append((char *)&rec_buffer[jj]->ref->attr->size, sizeof(int)) ;
+    }
+
+    chunk_rows = 0 ;
+    chunk_offsets.clear() ;
+    file_offset = stream.write(header.c_str(), header.length()) ;
+    total_bytes_written += file_offset ;
+    return(0) ;
+}
+
+/**
+@details
+-# Copy each value of the record to the next row of its column.  Bitfields are extracted to a full
+   integer of the recorded size.
+-# Widen the range of each column to include the value.
+*/
+void Trick::DRColumnar::add_row( unsigned int writer_offset ) {
+
+	unsigned long bf;
+	int sbf;
+    unsigned int ii ;
+    char * address ;
+    char * dest ;
+    double value ;
+
+    for (ii = 0; ii < rec_buffer.size() ; ii++) {
+
+        int size = rec_buffer[ii]->ref->attr->size ;
+        address = rec_buffer[ii]->buffer + ( writer_offset * size ) ;
+        dest = writer_buff + column_offset[ii] + ( chunk_rows * size ) ;
+
+        switch (rec_buffer[ii]->ref->attr->type) {
+            case TRICK_BITFIELD:
+                sbf = GET_BITFIELD(address, size,
+                 rec_buffer[ii]->ref->attr->index[0].start, rec_buffer[ii]->ref->attr->index[0].size);
+                memcpy(dest, &sbf, (size_t)size);
+                break;
+
+            case TRICK_UNSIGNED_BITFIELD:
+                bf = GET_UNSIGNED_BITFIELD(address, size,
+                 rec_buffer[ii]->ref->attr->index[0].start, rec_buffer[ii]->ref->attr->index[0].size);
+                memcpy(dest, &bf, (size_t)size);
+                break;
+
+            default:
+                memcpy(dest, address, (size_t)size);
+                break;
+        }
+
+        value = column_value(dest, rec_buffer[ii]->ref->attr->type, size) ;
+        if ( chunk_rows == 0 or value < column_range[ii*2] ) {
+            column_range[ii*2] = value ;
+        }
+        if ( chunk_rows == 0 or value > column_range[ii*2 + 1] ) {
+            column_range[ii*2 + 1] = value ;
+        }
+    }
+    chunk_rows++ ;
+}
+
+/**
+@details
+-# Gather the chunk header, the column ranges, and the used part of each column, and write them
+   with writev.
+-# Save the file offset of the chunk for the footer and start a new chunk.
+*/
+int Trick::DRColumnar::write_chunk() {
+
+    unsigned int ii ;
+    int bytes = 0 ;
+    COLUMNAR_CHUNK_HEADER chunk_header ;
+    std::vector< struct iovec > iov ;
+    struct iovec piece ;
+    double * time_column = (double *)(writer_buff + column_offset[0]) ;
+
+    if ( chunk_rows == 0 ) {
+        return 0 ;
+    }
+
+    chunk_header.num_rows = chunk_rows ;
+    chunk_header.reserved = 0 ;
+    chunk_header.first_time = time_column[0] ;
+    chunk_header.last_time = time_column[chunk_rows - 1] ;
+
+    piece.iov_base = &chunk_header ;
+    piece.iov_len = sizeof(chunk_header) ;
+    iov.push_back(piece) ;
+    piece.iov_base = &column_range[0] ;
+    piece.iov_len = column_range.size() * sizeof(double) ;
+    iov.push_back(piece) ;
+    for (ii = 0; ii < rec_buffer.size() ; ii++) {
+        piece.iov_base = writer_buff + column_offset[ii] ;
+        piece.iov_len = chunk_rows * rec_buffer[ii]->ref->attr->size ;
+        iov.push_back(piece) ;
+    }
+
+    /* writev takes at most IOV_MAX buffers per call */
+    for ( ii = 0 ; ii < iov.size() ; ii += IOV_MAX ) {
+        int count = ( iov.size() - ii > IOV_MAX ) ? IOV_MAX : iov.size() - ii ;
+        bytes += stream.writev( &iov[ii] , count ) ;
+    }
+
+    chunk_offsets.push_back(file_offset) ;
+    file_offset += bytes ;
+    chunk_rows = 0 ;
+    return bytes ;
+}
+
+/**
+@details
+-# Add the records to the current chunk, writing the chunk each time it fills.
+-# return the number of bytes written
+*/
+int Trick::DRColumnar::format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) {
+
+    unsigned int ii ;
+    int bytes = 0 ;
+
+    for ( ii = 0 ; ii < num_rows ; ii++ ) {
+        add_row(writer_offset + ii) ;
+        if ( chunk_rows == rows_per_chunk ) {
+            bytes += write_chunk() ;
+        }
+    }
+    return bytes ;
+}
+
+int Trick::DRColumnar::format_specific_write_data(unsigned int writer_offset) {
+    return format_specific_write_rows(writer_offset, 1) ;
+}
+
+/**
+@details
+-# Write the partial chunk
+-# Write the footer: the chunk offsets, the number of chunks, and the footer marker
+-# Close the output file stream
+*/
+int Trick::DRColumnar::format_specific_shutdown() {
+
+    COLUMNAR_FOOTER footer ;
+
+    if ( inited ) {
+        total_bytes_written += write_chunk() ;
+        if ( ! chunk_offsets.empty() ) {
+            stream.write( &chunk_offsets[0] , chunk_offsets.size() * sizeof(uint64_t)) ;
+        }
+        footer.num_chunks = chunk_offsets.size() ;
+        memcpy(footer.magic, TRICK_COLUMNAR_FOOTER_MAGIC, sizeof(footer.magic)) ;
+        stream.write( &footer , sizeof(footer)) ;
+        stream.close() ;
+    }
+    return(0) ;
+}
@@ -76,6 +76,8 @@ Trick::DataRecordGroup::DataRecordGroup( std::string in_name ) :
  writer_buff(NULL),
  single_prec_only(false),
  buffer_type(DR_Buffer),
+ compression(DR_No_Compression),
+ compression_level(1),
  job_class("data_record"),
  curr_time(0.0)
 {
@@ -195,6 +197,12 @@ int Trick::DataRecordGroup::set_buffer_type( int in_buffer_type ) {
     return(0) ;
 }
 
+int Trick::DataRecordGroup::set_compression( int in_compression , int level ) {
+    compression = in_compression ;
+    compression_level = level ;
+    return(0) ;
+}
+
 int Trick::DataRecordGroup::set_max_file_size( uint64_t bytes ) {
     if(bytes == 0) {
         max_file_size = UINT64_MAX ;
@@ -595,6 +603,8 @@ int Trick::DataRecordGroup::data_record(double in_time) {
                     drb = rec_buffer[jj] ;
                     memcpy( drb->buffer + (buffer_offset * drb->ref->attr->size) , drb->last_value , drb->ref->attr->size ) ;
                 }
+                // publish the record to the writer after its data is in the buffer
+                __sync_synchronize() ;
                 buffer_num++ ;
             }
 
@@ -629,6 +639,8 @@ int Trick::DataRecordGroup::data_record(double in_time) {
                         break ;
                 }
             }
+            // publish the record to the writer after its data is in the buffer
+            __sync_synchronize() ;
             buffer_num++ ;
         }
     }
@@ -649,6 +661,8 @@ int Trick::DataRecordGroup::write_data(bool must_write) {
         // to not overwrite data being written by the asynchronous thread.
         pthread_mutex_lock(&buffer_mutex) ;
         local_buffer_num = buffer_num ;
+        // read the records only after reading the count that published them
+        __sync_synchronize() ;
         if ( (local_buffer_num - writer_num) > max_num ) {
             num_to_write = max_num ;
         } else {
@@ -656,13 +670,17 @@ int Trick::DataRecordGroup::write_data(bool must_write) {
         }
         writer_num = local_buffer_num - num_to_write ;
 
-        //! This loop pulls a "row" of time homogeneous data and writes it to the file
+        //! This loop pulls runs of rows of time homogeneous data that do not wrap and writes them to the file
         while ( writer_num != local_buffer_num ) {
 
             writer_offset = writer_num % max_num ;
+            num_to_write = local_buffer_num - writer_num ;
+            if ( num_to_write > max_num - writer_offset ) {
+                num_to_write = max_num - writer_offset ;
+            }
             //! keep record of bytes written to file. Default max is 1GB
-            total_bytes_written += format_specific_write_data(writer_offset) ;
-            writer_num++ ;
+            total_bytes_written += format_specific_write_rows(writer_offset, num_to_write) ;
+            writer_num += num_to_write ;
 
         }
         pthread_mutex_unlock(&buffer_mutex) ;
@@ -672,6 +690,21 @@ int Trick::DataRecordGroup::write_data(bool must_write) {
     return 0 ;
 }
 
+/**
+@details
+-# Write each record separately.  Formats that can gather records override this routine.
+*/
+int Trick::DataRecordGroup::format_specific_write_rows(unsigned int writer_offset , unsigned int num_rows) {
+
+    unsigned int ii ;
+    int bytes = 0 ;
+
+    for ( ii = 0 ; ii < num_rows ; ii++ ) {
+        bytes += format_specific_write_data(writer_offset + ii) ;
+    }
+    return bytes ;
+}
+
 int Trick::DataRecordGroup::enable() {
     record = true ;
     return(0) ;
@@ -0,0 +1,191 @@
+/*
+PURPOSE:
+    (Output file used by the ascii and binary data recording formats.)
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "trick/DataRecordStream.hh"
+
+/* Size of the compressed output buffer */
+#define ZBUFFER_SIZE 65536
+
+Trick::DataRecordStream::DataRecordStream() :
+ fd(-1) ,
+ compression(DR_No_Compression) ,
+ zstream(NULL) ,
+ zbuffer(NULL) {}
+
+Trick::DataRecordStream::~DataRecordStream() {
+    close() ;
+}
+
+/**
+@details
+-# Create the file with the same permissions the binary format has always used.  Appending to a
+   compressed file adds another gzip member, which gunzip reads as one stream.
+-# If compressing, initialize a deflate stream with a gzip wrapper so the file can be read with
+   gunzip or zcat.
+*/
+int Trick::DataRecordStream::open( std::string file_name , int in_compression , int level , bool append ) {
+
+    close() ;
+    compression = in_compression ;
+    if ( compression == DR_Gzip ) {
+        file_name.append(".gz") ;
+    }
+
+    fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC) ,
+     S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH) ;
+    if ( fd == -1 ) {
+        return -1 ;
+    }
+
+    if ( compression == DR_Gzip ) {
+        z_stream * zs = (z_stream *)calloc(1, sizeof(z_stream)) ;
+        if ( level < 1 or level > 9 ) {
+            level = Z_DEFAULT_COMPRESSION ;
+        }
+        /* 15 + 16 selects the largest window with a gzip header */
+        if ( deflateInit2(zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK ) {
+            free(zs) ;
+            ::close(fd) ;
+            fd = -1 ;
+            return -1 ;
+        }
+        zstream = zs ;
+        zbuffer = (char *)malloc(ZBUFFER_SIZE) ;
+    }
+
+    return 0 ;
+}
+
+bool Trick::DataRecordStream::is_open() {
+    return fd != -1 ;
+}
+
+ssize_t Trick::DataRecordStream::write_all( const char * buf , size_t len ) {
+    size_t done = 0 ;
+    while ( done < len ) {
+        ssize_t ret = ::write(fd, buf + done, len - done) ;
+        if ( ret < 0 ) {
+            if ( errno == EINTR ) {
+                continue ;
+            }
+            return -1 ;
+        }
+        done += ret ;
+    }
+    return done ;
+}
+
+int Trick::DataRecordStream::deflate_buffer( const void * buf , size_t len , int flush ) {
+    z_stream * zs = (z_stream *)zstream ;
+    zs->next_in = (Bytef *)buf ;
+    zs->avail_in = len ;
+    do {
+        zs->next_out = (Bytef *)zbuffer ;
+        zs->avail_out = ZBUFFER_SIZE ;
+        if ( deflate(zs, flush) == Z_STREAM_ERROR ) {
+            return -1 ;
+        }
+        if ( write_all(zbuffer, ZBUFFER_SIZE - zs->avail_out) < 0 ) {
+            return -1 ;
+        }
+    } while ( zs->avail_out == 0 ) ;
+    return 0 ;
+}
+
+ssize_t Trick::DataRecordStream::write( const void * buf , size_t len ) {
+    struct iovec iov ;
+    iov.iov_base = (void *)buf ;
+    iov.iov_len = len ;
+    return writev(&iov, 1) ;
+}
+
+ssize_t Trick::DataRecordStream::writev( const struct iovec * iov , int iovcnt ) {
+    if ( fd == -1 ) {
+        return -1 ;
+    }
+    if ( zstream != NULL ) {
+        return writev_compressed(iov, iovcnt) ;
+    }
+    return writev_plain(iov, iovcnt) ;
+}
+
+/**
+@details
+-# Hand all of the buffers to the kernel in one writev call.
+-# Finish a partial write one buffer at a time.
+*/
+ssize_t Trick::DataRecordStream::writev_plain( const struct iovec * iov , int iovcnt ) {
+
+    int ii ;
+    size_t total = 0 ;
+    ssize_t ret ;
+
+    for ( ii = 0 ; ii < iovcnt ; ii++ ) {
+        total += iov[ii].iov_len ;
+    }
+
+    do {
+        ret = ::writev(fd, iov, iovcnt) ;
+    } while ( ret < 0 and errno == EINTR ) ;
+    if ( ret < 0 ) {
+        return -1 ;
+    }
+    /* ret counts down the bytes the kernel already took. */
+    for ( ii = 0 ; ii < iovcnt ; ii++ ) {
+        if ( (size_t)ret >= iov[ii].iov_len ) {
+            ret -= iov[ii].iov_len ;
+        } else {
+            if ( write_all((const char *)iov[ii].iov_base + ret, iov[ii].iov_len - ret) < 0 ) {
+                return -1 ;
+            }
+            ret = 0 ;
+        }
+    }
+    return total ;
+}
+
+/**
+@details
+-# Feed each buffer through the deflate stream.  deflate_buffer writes the compressed output as it fills.
+*/
+ssize_t Trick::DataRecordStream::writev_compressed( const struct iovec * iov , int iovcnt ) {
+
+    int ii ;
+    size_t total = 0 ;
+
+    for ( ii = 0 ; ii < iovcnt ; ii++ ) {
+        if ( deflate_buffer(iov[ii].iov_base, iov[ii].iov_len, Z_NO_FLUSH) != 0 ) {
+            return -1 ;
+        }
+        total += iov[ii].iov_len ;
+    }
+    return total ;
+}
+
+int Trick::DataRecordStream::close() {
+    if ( zstream != NULL ) {
+        if ( fd != -1 ) {
+            deflate_buffer(NULL, 0, Z_FINISH) ;
+        }
+        deflateEnd((z_stream *)zstream) ;
+        free(zstream) ;
+        free(zbuffer) ;
+        zstream = NULL ;
+        zbuffer = NULL ;
+    }
+    if ( fd != -1 ) {
+        ::close(fd) ;
+        fd = -1 ;
+    }
+    return 0 ;
+}
@@ -40,6 +40,7 @@ Trick::Executive::Executive() {
     num_classes = 0 ;
     num_sim_objects = 0 ;
     rt_nap = true ;
+    job_dispatch_schedule = false ;
     scheduled_start_index = 1000 ;
     num_scheduled_job_classes = 0 ;
     signal_caused_term = false ;
@@ -196,6 +197,10 @@ bool Trick::Executive::get_rt_nap() {
     return(rt_nap) ;
 }
 
+bool Trick::Executive::get_job_dispatch_schedule() {
+    return(job_dispatch_schedule) ;
+}
+
 int Trick::Executive::get_scheduled_start_index() {
     return(scheduled_start_index) ;
 }
@@ -338,7 +343,20 @@ int Trick::Executive::set_freeze_frame(double in_frame) {
 }
 
 int Trick::Executive::set_rt_nap(bool on_off) {
+    unsigned int ii ;
     rt_nap = on_off ;
+    for ( ii = 0 ; ii < threads.size() ; ii++ ) {
+        threads[ii]->rt_nap = on_off ;
+    }
+    return(0) ;
+}
+
+int Trick::Executive::set_job_dispatch_schedule(bool on_off) {
+    unsigned int ii ;
+    job_dispatch_schedule = on_off ;
+    for ( ii = 0 ; ii < threads.size() ; ii++ ) {
+        threads[ii]->job_queue.set_dispatch_schedule(on_off) ;
+    }
     return(0) ;
 }
 
@@ -365,12 +383,20 @@ int Trick::Executive::set_time(double in_time) {
        threads[ii]->curr_time_tics = time_tics ;
     }
     reset_job_call_times() ;
+    // All job call times changed, rebuild the dispatch schedules.
+    for (unsigned int ii = 0 ; ii < threads.size() ; ii++ ) {
+       threads[ii]->job_queue.rebuild_dispatch_schedule() ;
+    }
     return(0) ;
 }
 
 int Trick::Executive::set_time_tics(long long in_tics) {
     time_tics = in_tics ;
     reset_job_call_times() ;
+    // All job call times changed, rebuild the dispatch schedules.
+    for (unsigned int ii = 0 ; ii < threads.size() ; ii++ ) {
+       threads[ii]->job_queue.rebuild_dispatch_schedule() ;
+    }
     return(0) ;
 }
 
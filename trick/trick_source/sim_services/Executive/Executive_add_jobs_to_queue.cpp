@@ -27,11 +27,12 @@
            executive, create a new Trick::Threads object.
            Requirement [@ref r_exec_thread_4]
         -# Add the new thread object to the list of threads handled by the executive.
-    -# Call Trick::Executive::add_job_to_queue(JobData *) to add job to the individual job class
+    -# Call Trick::Executive::add_job_to_queue(JobData *) to collect the job for the individual job class
        Trick::ScheduledQueue
     -# If the sim is not restarting, convert the initial start, stop, and next call times to
        simulation tics.  The next call time is based on the current simulation time + job offset.
        Requirement [@ref r_exec_jobs_3]
+-# Add the collected jobs to each queue with a single call to Trick::ScheduledJobQueue::push_all
 */
 int Trick::Executive::add_jobs_to_queue( Trick::SimObject * in_sim_object , bool restart_flag ) {
 
@@ -40,6 +41,8 @@ int Trick::Executive::add_jobs_to_queue( Trick::SimObject * in_sim_object , bool
     Trick::JobData * temp_job  ;
     Trick::Threads * curr_thread ;
     int ret ;
+    std::map< Trick::ScheduledJobQueue * , std::vector< Trick::JobData * > > batch ;
+    std::map< Trick::ScheduledJobQueue * , std::vector< Trick::JobData * > >::iterator bit ;
 
     max_time = TRICK_MAX_LONG_LONG / time_tic_value ;
 
@@ -82,12 +85,13 @@ int Trick::Executive::add_jobs_to_queue( Trick::SimObject * in_sim_object , bool
         if ( (temp_job->thread + 1) > threads.size() ) {
             for ( kk = threads.size() ; kk <= temp_job->thread ; kk++ ) {
                 curr_thread = new Trick::Threads(kk, rt_nap) ;
+                curr_thread->job_queue.set_dispatch_schedule(job_dispatch_schedule) ;
                 threads.push_back(curr_thread) ;
             }
         }
 
-        /* Call add_job_to_queue(JobData *) to add job to proper Trick::ScheduledQueue */
-        ret = add_job_to_queue(temp_job) ;
+        /* Call add_job_to_queue(JobData *) to collect the job for the proper Trick::ScheduledQueue */
+        ret = add_job_to_queue(temp_job, &batch) ;
 
         /* If add_jobs is called during initialization, restart_flag == false,
            calcluate the cycle/start/stop times for the job */
@@ -126,10 +130,27 @@ int Trick::Executive::add_jobs_to_queue( Trick::SimObject * in_sim_object , bool
         }
     }
 
+    /* Sort and merge the jobs of this sim_object into each queue once */
+    for ( bit = batch.begin() ; bit != batch.end() ; bit++ ) {
+        bit->first->push_all(bit->second) ;
+    }
+
     return(0) ;
 
 }
 
+/* Pushes the job onto the queue, or collects it in the batch for the queue if a batch is given. */
+static void push_or_batch( Trick::ScheduledJobQueue * queue , Trick::JobData * job ,
+ std::map< Trick::ScheduledJobQueue * , std::vector< Trick::JobData * > > * batch ) {
+    if ( batch != NULL ) {
+        (*batch)[queue].push_back(job) ;
+        /* The job is handled as soon as it is assigned a queue */
+        job->set_handled(true) ;
+    } else {
+        queue->push(job) ;
+    }
+}
+
 /**
 @details
 -# If the job class matches one of the following job classes: default_data, initialization,
@@ -137,8 +158,10 @@ int Trick::Executive::add_jobs_to_queue( Trick::SimObject * in_sim_object , bool
 -# If the job class is a cyclic scheduled job, add it to the Trick::ScheduledJobQueue corresponding
    to the thread number specified by the job.
 -# Else add the job the the non-cyclic job class Trick::ScheduledJobQueue.
+-# If a batch is given, jobs are collected in the batch by queue instead of pushed.
 */
-int Trick::Executive::add_job_to_queue( Trick::JobData * job ) {
+int Trick::Executive::add_job_to_queue( Trick::JobData * job ,
+ std::map< Trick::ScheduledJobQueue * , std::vector< Trick::JobData * > > * batch ) {
 
     std::map<std::string, int>::iterator class_id_it ;
     std::map<int, Trick::ScheduledJobQueue *>::iterator queue_it ;
@@ -159,35 +182,35 @@ int Trick::Executive::add_job_to_queue( Trick::JobData * job ) {
         if ( job->thread != 0 ) {
             /* Add threaded scheduled jobs to the thread scheduled queue */
             if ( job->job_class >= scheduled_start_index ) {
-                threads[job->thread]->job_queue.push(job) ;
+                push_or_batch(&threads[job->thread]->job_queue, job, batch) ;
                 // Add all scheduled jobs to the scheduled_queue for use in the multi-threaded loop
-                scheduled_queue.push(job) ;
+                push_or_batch(&scheduled_queue, job, batch) ;
                 return 0 ;
             /* Threaded top_of_frame/end_of_frame jobs go to thread specific queues. */
             } else if ( ! job->job_class_name.compare("top_of_frame")) {
-                threads[job->thread]->top_of_frame_queue.push(job) ;
+                push_or_batch(&threads[job->thread]->top_of_frame_queue, job, batch) ;
                 return 0 ;
             } else if ( ! job->job_class_name.compare("end_of_frame")) {
-                threads[job->thread]->end_of_frame_queue.push(job) ;
+                push_or_batch(&threads[job->thread]->end_of_frame_queue, job, batch) ;
                 return 0 ;
             /* Other jobs classes are put into the main thread */
             } else if ( (queue_it = class_to_queue.find(job->job_class)) != class_to_queue.end() ) {
                 /* for non-scheduled jobs, the class_to_queue map holds the correct queue to insert the job */
                 curr_queue = queue_it->second ;
-                curr_queue->push( job ) ;
+                push_or_batch(curr_queue, job, batch) ;
                 return 0 ;
             }
         } else {
             /* if the job is a "scheduled" type job, insert the job into the proper thread queue */
             if ( job->job_class >= scheduled_start_index ) {
-                threads[0]->job_queue.push(job) ;
+                push_or_batch(&threads[0]->job_queue, job, batch) ;
                 // Add all scheduled jobs to the scheduled_queue for use in the multi-threaded loop
-                scheduled_queue.push(job) ;
+                push_or_batch(&scheduled_queue, job, batch) ;
                 return 0 ;
             } else if ( (queue_it = class_to_queue.find(job->job_class)) != class_to_queue.end() ) {
                 /* for non-scheduled jobs, the class_to_queue map holds the correct queue to insert the job */
                 curr_queue = queue_it->second ;
-                curr_queue->push( job ) ;
+                push_or_batch(curr_queue, job, batch) ;
                 return 0 ;
             }
         }
@@ -216,6 +216,18 @@ extern "C" int exec_get_rt_nap() {
     return -1 ;
 }
 
+/**
+ * @relates Trick::Executive
+ * @copydoc Trick::Executive::get_job_dispatch_schedule
+ * C wrapper for Trick::Executive::get_job_dispatch_schedule
+ */
+extern "C" int exec_get_job_dispatch_schedule() {
+    if ( the_exec != NULL ) {
+        return (int)the_exec->get_job_dispatch_schedule() ;
+    }
+    return -1 ;
+}
+
 /**
  * @relates Trick::Executive
  * @copydoc Trick::Executive::get_scheduled_start_index
@@ -497,6 +509,18 @@ extern "C" int exec_set_rt_nap( int on_off ) {
     return -1 ;
 }
 
+/**
+ * @relates Trick::Executive
+ * @copydoc Trick::Executive::set_job_dispatch_schedule
+ * C wrapper for Trick::Executive::set_job_dispatch_schedule
+ */
+extern "C" int exec_set_job_dispatch_schedule( int on_off ) {
+    if ( the_exec != NULL ) {
+        return the_exec->set_job_dispatch_schedule((bool)on_off) ;
+    }
+    return -1 ;
+}
+
 /**
  * @relates Trick::Executive
  * @copydoc Trick::Executive::set_software_frame
@@ -629,6 +653,18 @@ extern "C" int exec_set_job_onoff(const char * job_name , int instance , int on)
     return -1 ;
 }
 
+/**
+ * @relates Trick::Executive
+ * @copydoc Trick::Executive::set_job_parallel
+ * C wrapper for Trick::Executive::set_job_parallel
+ */
+extern "C" int exec_set_job_parallel(const char * job_name , int instance , int on) {
+    if ( the_exec != NULL ) {
+        return the_exec->set_job_parallel( job_name , instance , on) ;
+    }
+    return -1 ;
+}
+
 /**
  * @relates Trick::Executive
  * @copydoc Trick::Executive::set_sim_object_onoff
@@ -890,6 +926,30 @@ extern "C" int exec_set_thread_process_type( unsigned int thread_id , int proces
     return -1 ;
 }
 
+/**
+ * @relates Trick::Executive
+ * @copydoc Trick::Executive::set_thread_wait_policy
+ * C wrapper for Trick::Executive::set_thread_wait_policy
+ */
+extern "C" int exec_set_thread_wait_policy( unsigned int thread_id , int policy ) {
+    if ( the_exec != NULL ) {
+        return the_exec->set_thread_wait_policy(thread_id , policy) ;
+    }
+    return -1 ;
+}
+
+/**
+ * @relates Trick::Executive
+ * @copydoc Trick::Executive::set_thread_parallel_workers
+ * C wrapper for Trick::Executive::set_thread_parallel_workers
+ */
+extern "C" int exec_set_thread_parallel_workers( unsigned int thread_id , unsigned int num_workers ) {
+    if ( the_exec != NULL ) {
+        return the_exec->set_thread_parallel_workers(thread_id , num_workers) ;
+    }
+    return -1 ;
+}
+
 /**
  * @relates Trick::Executive
  * @copydoc Trick::Executive::set_job_cycle
@@ -998,6 +1058,18 @@ Trick::JobData * exec_get_curr_job() {
     return NULL ;
 }
 
+/**
+ * @relates Trick::Executive
+ * @copydoc Trick::Executive::reschedule_job
+ * Wrapper for Trick::Executive::reschedule_job
+ */
+int exec_reschedule_job( Trick::JobData * job ) {
+    if ( the_exec != NULL ) {
+        return the_exec->reschedule_job(job) ;
+    }
+    return -1 ;
+}
+
 /**
  * @relates Trick::Executive
  * @copydoc Trick::Executive::get_thread
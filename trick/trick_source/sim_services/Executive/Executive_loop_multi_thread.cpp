@@ -5,7 +5,6 @@
 
 #include "trick/Executive.hh"
 #include "trick/exec_proto.h"
-#include "trick/release.h"
 
 /**
 @details
@@ -22,7 +21,8 @@
        Requirement  [@ref r_exec_thread_7]
     -# Signal threads to start the next time step of processing.
     -# For each scheduled jobs whose next call time is equal to the current simulation time [@ref ScheduledJobQueue]
-        -# Wait for all job dependencies to complete.  Requirement  [@ref r_exec_thread_6]
+        -# Defer jobs marked parallel to the main thread's Trick::ParallelJobPool
+        -# Wait for all job dependencies to complete using the main thread wait policy.  Requirement  [@ref r_exec_thread_6]
         -# Call the job.  Requirement  [@ref r_exec_periodic_0]
         -# If the job is a system job, check to see if the next job call time is the lowest next time by
            calling Trick::ScheduledJobQueue::test_next_job_call_time(Trick::JobData *, long long)
@@ -44,12 +44,7 @@ int Trick::Executive::loop_multi_thread() {
 
     /* Wait for all threads to finish initializing and set the child_complete flag. */
     for (ii = 1; ii < threads.size() ; ii++) {
-        Threads * curr_thread = threads[ii] ;
-        while (curr_thread->child_complete == false ) {
-            if (rt_nap == true) {
-                RELEASE();
-            }
-        }
+        threads[0]->wait_for_thread(threads[ii]) ;
     }
 
     /* The main scheduler queue is the queue in thread 0 */
@@ -123,13 +118,16 @@ int Trick::Executive::loop_multi_thread() {
         main_sched_queue->reset_curr_index() ;
         while ( (curr_job = main_sched_queue->find_next_job( time_tics )) != NULL ) {
 
+            /* Parallel jobs are batched and run on the main thread's job pool. */
+            if ( threads[0]->parallel_pool.defer_job(curr_job) ) {
+                continue ;
+            }
+
             /* Wait for all jobs that the current job depends on to complete. */
             for ( ii = 0 ; ii < curr_job->depends.size() ; ii++ ) {
                 depend_job = curr_job->depends[ii] ;
-                while (! depend_job->complete) {
-                    if (rt_nap == true) {
-                        RELEASE();
-                    }
+                if (! depend_job->complete) {
+                    threads[0]->wait_for_job(depend_job, get_thread(depend_job->thread)) ;
                 }
             }
 
@@ -143,8 +141,9 @@ int Trick::Executive::loop_multi_thread() {
             if ( curr_job->system_job_class ) {
                 main_sched_queue->test_next_job_call_time(curr_job , time_tics) ;
             }
-            curr_job->complete = true ;
+            threads[0]->set_job_complete(curr_job) ;
         }
+        threads[0]->parallel_pool.flush() ;
 
         /* Call Executive::exec_terminate_with_return(int , const char * , int , const char *)
            if exec_command equals ExitCmd. */
@@ -15,6 +15,7 @@
        Requirement  [@ref r_exec_mode_1]
     -# Set the main thread current time to the simulation time tics value
     -# For each scheduled jobs whose next call time is equal to the current simulation time [@ref ScheduledJobQueue]
+        -# Defer jobs marked parallel to the main thread's Trick::ParallelJobPool
         -# Call the job.  Requirement  [@ref r_exec_periodic_0]
         -# If the job is a system job, check to see if the next job call time is the lowest next time by
            calling Trick::ScheduledJobQueue::test_next_job_call_time(Trick::JobData *, long long)
@@ -67,6 +68,10 @@ int Trick::Executive::loop_single_thread() {
         /* Call all scheduled jobs that are scheduled to run at the current simulation time step. */
         main_sched_queue->reset_curr_index() ;
         while ( (curr_job = main_sched_queue->find_next_job( time_tics )) != NULL ) {
+            /* Parallel jobs are batched and run on the main thread's job pool. */
+            if ( threads[0]->parallel_pool.defer_job(curr_job) ) {
+                continue ;
+            }
             //std::cout << "[33mtime = " << time_tics << " " << curr_job->name << " job next = " << curr_job->next_tics << "[00m" << std::endl ;
             ret = curr_job->call() ;
             if ( ret != 0 ) {
@@ -78,6 +83,7 @@ int Trick::Executive::loop_single_thread() {
                 main_sched_queue->test_next_job_call_time(curr_job , time_tics) ;
             }
         }
+        threads[0]->parallel_pool.flush() ;
 
         /* Call Executive::exec_terminate_with_return(int , const char * , int , const char *)
            if exec_command equals ExitCmd. */
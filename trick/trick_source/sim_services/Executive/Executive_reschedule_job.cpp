@@ -0,0 +1,16 @@
+
+#include "trick/Executive.hh"
+
+/**
+@details
+-# If the job thread exists, refile the job in the thread job queue.
+-# Return -1 if the job is not handled by a thread job queue.
+*/
+int Trick::Executive::reschedule_job(Trick::JobData * job) {
+
+    if ( job != NULL and job->thread < threads.size() ) {
+        return threads[job->thread]->job_queue.reschedule_job(job) ;
+    }
+    return -1 ;
+}
+
@@ -2,12 +2,11 @@
 #include <iostream>
 
 #include "trick/Executive.hh"
-#include "trick/release.h"
 
 /**
 @design
 -# Loop through all threads.
-   -# Wait for thread to finish if the thread is PROCESS_TYPE_SCHEDULED
+   -# Wait for thread to finish if the thread is PROCESS_TYPE_SCHEDULED using the main thread wait policy
 */
 int Trick::Executive::scheduled_thread_sync() {
 
@@ -17,11 +16,7 @@ int Trick::Executive::scheduled_thread_sync() {
     for (ii = 1; ii < threads.size() ; ii++) {
         Threads * curr_thread = threads[ii] ;
         if ( curr_thread->enabled and curr_thread->process_type == PROCESS_TYPE_SCHEDULED) {
-            while (curr_thread->child_complete == false ) {
-                if (rt_nap == true) {
-                    RELEASE();
-                }
-            }
+            threads[0]->wait_for_thread(curr_thread) ;
         }
     }
 
@@ -22,6 +22,7 @@ int Trick::Executive::set_job_cycle(std::string job_name, int instance_num, doub
         // set cycle for one job (the given job_name)
         job->set_cycle(in_cycle) ;
         job->set_next_call_time(time_tics) ;
+        reschedule_job(job) ;
     } else {
         // job_name may be a tag name: find all jobs that have the given tag name and hold them in a list
         range = all_tagged_jobs.equal_range(job_name) ;
@@ -30,6 +31,7 @@ int Trick::Executive::set_job_cycle(std::string job_name, int instance_num, doub
             for ( it = range.first; it != range.second ; it++ ) {
                 (*it).second->set_cycle(in_cycle) ;
                 (*it).second->set_next_call_time(time_tics) ;
+                reschedule_job((*it).second) ;
             }
         } else {
             message_publish(MSG_WARNING, "Warning: Job %s not found in Executive::set_job_cycle\n" , job_name.c_str()) ;
@@ -0,0 +1,20 @@
+
+#include "trick/Executive.hh"
+
+int Trick::Executive::set_thread_parallel_workers(unsigned int thread_id , unsigned int num_workers) {
+
+    int ret ;
+
+    /** @par Detailed Design */
+    if ( (thread_id +1) > threads.size() ) {
+        /** @li If the thread_id does not exist, return an error */
+        ret = -2 ;
+    } else {
+        /** @li Call Trick::ParallelJobPool::set_num_workers for the thread's job pool if the thread exists.
+                The main thread is allowed. */
+        ret = threads[thread_id]->parallel_pool.set_num_workers(num_workers) ;
+    }
+
+    return(ret) ;
+
+}
@@ -0,0 +1,20 @@
+
+#include "trick/Executive.hh"
+
+int Trick::Executive::set_thread_wait_policy(unsigned int thread_id , int policy) {
+
+    int ret ;
+
+    /** @par Detailed Design */
+    if ( (thread_id +1) > threads.size() ) {
+        /** @li If the thread_id does not exist, return an error */
+        ret = -2 ;
+    } else {
+        /** @li Call Trick::Threads::set_wait_policy with the policy if the thread exists.
+                The main thread is allowed, its policy is used when it waits on child threads. */
+        ret = threads[thread_id]->set_wait_policy(policy) ;
+    }
+
+    return(ret) ;
+
+}
@@ -58,10 +58,11 @@ int Trick::Executive::set_time_tic_value(int in_tics) {
         }
     }
 
-    // reset the thread cycle times
+    // reset the thread cycle times.  All job call times changed, rebuild the dispatch schedules.
     unsigned int ii ;
     for ( ii = 0 ; ii < threads.size() ; ii++ ) {
         threads[ii]->time_tic_changed(old_time_tic_value , time_tic_value) ;
+        threads[ii]->job_queue.rebuild_dispatch_schedule() ;
     }
 
     return(0) ;
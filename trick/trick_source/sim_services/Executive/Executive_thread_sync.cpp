@@ -2,13 +2,12 @@
 #include <iostream>
 
 #include "trick/Executive.hh"
-#include "trick/release.h"
 
 /**
 @design
 -# Loop through all child threads
    -# If the thread is asynchronous must finish and the next sync time matches the sim time
-      -# Wait for the thread to finish
+      -# Wait for the thread to finish using the main thread wait policy
       -# Reset the thread queue of jobs
       -# clear all job complete flags
    -# If the thread is asynchronous and the thread is finished
@@ -28,11 +27,7 @@ int Trick::Executive::thread_sync() {
         Threads * curr_thread = threads[ii] ;
         if ( (curr_thread->process_type == PROCESS_TYPE_AMF_CHILD) &&
               (curr_thread->amf_next_tics == time_tics )) {
-            while (curr_thread->child_complete == false ) {
-                if (rt_nap == true) {
-                    RELEASE();
-                }
-            }
+            threads[0]->wait_for_thread(curr_thread) ;
         }
         else if ( curr_thread->process_type == PROCESS_TYPE_ASYNC_CHILD ) {
             if ( curr_thread->child_complete == true ) {
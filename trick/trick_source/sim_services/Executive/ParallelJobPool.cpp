@@ -0,0 +1,297 @@
+
+#include <algorithm>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux
+#include <cxxabi.h>
+#endif
+
+#include "trick/ParallelJobPool.hh"
+#include "trick/Threads.hh"
+#include "trick/JobData.hh"
+#include "trick/ExecutiveException.hh"
+#include "trick/exec_proto.h"
+#include "trick/exec_proto.hh"
+
+/* ParallelJobWorker */
+Trick::ParallelJobWorker::ParallelJobWorker( ParallelJobPool * in_pool , unsigned int in_index , std::string in_name ) :
+ Trick::ThreadBase(in_name) ,
+ pool(in_pool) ,
+ index(in_index) {}
+
+Trick::ParallelJobWorker::~ParallelJobWorker() {}
+
+/**
+@details
+-# Sleep until the pool generation changes or the pool is stopping.
+-# Run jobs until all of the deques are empty.  A job that calls exec_terminate ends the simulation
+   from this thread the same way a child thread does.
+*/
+void * Trick::ParallelJobWorker::thread_body() {
+
+    unsigned int seen = 0 ;
+    bool stop = false ;
+
+    try {
+        while ( true ) {
+            pthread_mutex_lock(&pool->batch_mutex) ;
+            while ( pool->generation == seen and ! pool->stopping ) {
+                pthread_cond_wait(&pool->batch_cv, &pool->batch_mutex) ;
+            }
+            seen = pool->generation ;
+            stop = pool->stopping ;
+            pthread_mutex_unlock(&pool->batch_mutex) ;
+            if ( stop ) {
+                break ;
+            }
+            pool->work(index) ;
+        }
+    } catch (Trick::ExecutiveException & ex ) {
+        fprintf(stderr, "\nPARALLEL JOB WORKER %s TERMINATED with exec_terminate\n  ROUTINE: %s\n  DIAGNOSTIC: %s\n"
+         "  THREAD STOP TIME: %f\n" ,
+         name.c_str(), ex.file.c_str(), ex.message.c_str(), exec_get_sim_time()) ;
+        exit(ex.ret_code) ;
+#ifdef __linux
+    } catch (abi::__forced_unwind&) {
+        //pthread_exit and pthread_cancel will cause an abi::__forced_unwind to be thrown. Rethrow it.
+        throw;
+#endif
+    }
+
+    return NULL ;
+}
+
+/* ParallelJobPool */
+Trick::ParallelJobPool::ParallelJobPool() :
+ num_batches(0) ,
+ num_pool_jobs(0) ,
+ num_steals(0) ,
+ owner(NULL) ,
+ batch_sched_jobs(true) ,
+ remaining(0) ,
+ batch_done(true) ,
+ generation(0) ,
+ stopping(false) {
+    pthread_mutex_init(&batch_mutex, NULL) ;
+    pthread_cond_init(&batch_cv, NULL) ;
+}
+
+Trick::ParallelJobPool::~ParallelJobPool() {
+    shutdown() ;
+    pthread_cond_destroy(&batch_cv) ;
+    pthread_mutex_destroy(&batch_mutex) ;
+}
+
+void Trick::ParallelJobPool::set_owner( Trick::Threads * in_owner ) {
+    owner = in_owner ;
+}
+
+/**
+@details
+-# Run any pending batch and stop the current helpers.
+-# Create one deque per participant.  Deque 0 belongs to the owning thread.
+-# Start the requested number of helper threads.
+*/
+int Trick::ParallelJobPool::set_num_workers( unsigned int num ) {
+
+    unsigned int ii ;
+
+    flush() ;
+    shutdown() ;
+
+    deques.resize(num + 1) ;
+    for ( ii = 0 ; ii < num + 1 ; ii++ ) {
+        pthread_mutex_t * mutex = new pthread_mutex_t ;
+        pthread_mutex_init(mutex, NULL) ;
+        deque_mutexes.push_back(mutex) ;
+    }
+
+    stopping = false ;
+    for ( ii = 0 ; ii < num ; ii++ ) {
+        std::ostringstream oss ;
+        oss << "Pool_" << ((owner != NULL) ? owner->thread_id : 0) << "_" << (ii + 1) ;
+        ParallelJobWorker * worker = new ParallelJobWorker(this, ii + 1, oss.str()) ;
+        workers.push_back(worker) ;
+        worker->create_thread() ;
+    }
+
+    return 0 ;
+}
+
+unsigned int Trick::ParallelJobPool::get_num_workers() {
+    return workers.size() ;
+}
+
+void Trick::ParallelJobPool::shutdown() {
+
+    unsigned int ii ;
+
+    pthread_mutex_lock(&batch_mutex) ;
+    stopping = true ;
+    pthread_cond_broadcast(&batch_cv) ;
+    pthread_mutex_unlock(&batch_mutex) ;
+
+    for ( ii = 0 ; ii < workers.size() ; ii++ ) {
+        pthread_join(workers[ii]->get_pthread_id(), NULL) ;
+        delete workers[ii] ;
+    }
+    workers.clear() ;
+
+    for ( ii = 0 ; ii < deque_mutexes.size() ; ii++ ) {
+        pthread_mutex_destroy(deque_mutexes[ii]) ;
+        delete deque_mutexes[ii] ;
+    }
+    deque_mutexes.clear() ;
+    deques.clear() ;
+}
+
+/**
+@details
+-# Jobs are not deferred if the pool has no helpers, the job is not marked parallel, or the job is a
+   system job.  A deferred batch is run first so the caller's job runs after it.
+-# If the job is a different job class or phase than the batch, or is called differently, run the
+   batch first.
+-# If the job depends on a job in the batch, run the batch first.
+-# Add the job to the batch.
+*/
+bool Trick::ParallelJobPool::defer_job( Trick::JobData * job , bool sched_job ) {
+
+    unsigned int ii ;
+
+    if ( workers.empty() or ! job->parallel or job->system_job_class ) {
+        flush() ;
+        return false ;
+    }
+
+    if ( ! batch.empty() ) {
+        if ( job->job_class != batch.front()->job_class or job->phase != batch.front()->phase or
+             sched_job != batch_sched_jobs ) {
+            flush() ;
+        } else {
+            for ( ii = 0 ; ii < job->depends.size() ; ii++ ) {
+                if ( job->depends[ii]->parallel and
+                     std::find(batch.begin(), batch.end(), job->depends[ii]) != batch.end() ) {
+                    flush() ;
+                    break ;
+                }
+            }
+        }
+    }
+
+    batch_sched_jobs = sched_job ;
+    batch.push_back(job) ;
+    return true ;
+}
+
+/**
+@details
+-# Wait for the dependencies of all jobs in the batch on other threads using the owning thread's wait
+   policy.  Dependencies on this thread ran before the batch, or were excluded from it by defer_job.
+-# Split the batch into contiguous blocks, one per participant, so jobs of the same sim object tend
+   to stay on the same thread.
+-# Wake the helpers and run jobs on this thread as well.
+-# Wait until every job in the batch has completed with the owning thread's wait policy.  The last
+   participant to complete a job sets batch_done and signals done_signal.
+*/
+void Trick::ParallelJobPool::flush() {
+
+    unsigned int ii , jj ;
+    unsigned int num_parts ;
+    unsigned int num_jobs ;
+
+    if ( batch.empty() ) {
+        return ;
+    }
+
+    num_jobs = batch.size() ;
+    for ( ii = 0 ; ii < num_jobs ; ii++ ) {
+        for ( jj = 0 ; jj < batch[ii]->depends.size() ; jj++ ) {
+            Trick::JobData * depend_job = batch[ii]->depends[jj] ;
+            if ( depend_job->thread != owner->thread_id and ! depend_job->complete ) {
+                owner->wait_for_job(depend_job, exec_get_thread(depend_job->thread)) ;
+            }
+        }
+    }
+
+    /* Set the count before filling the deques.  A helper still draining the last batch may pick up
+       a job as soon as it is queued. */
+    batch_done = false ;
+    __sync_lock_test_and_set(&remaining, num_jobs) ;
+    num_parts = deques.size() ;
+    for ( ii = 0 ; ii < num_parts ; ii++ ) {
+        unsigned int begin = (unsigned int)(((unsigned long long)num_jobs * ii) / num_parts) ;
+        unsigned int end = (unsigned int)(((unsigned long long)num_jobs * (ii + 1)) / num_parts) ;
+        pthread_mutex_lock(deque_mutexes[ii]) ;
+        deques[ii].insert(deques[ii].end(), batch.begin() + begin, batch.begin() + end) ;
+        pthread_mutex_unlock(deque_mutexes[ii]) ;
+    }
+
+    pthread_mutex_lock(&batch_mutex) ;
+    generation++ ;
+    pthread_cond_broadcast(&batch_cv) ;
+    pthread_mutex_unlock(&batch_mutex) ;
+
+    work(0) ;
+    owner->wait_control.wait( batch_done , &done_signal , owner->rt_nap ) ;
+
+    num_batches++ ;
+    num_pool_jobs += num_jobs ;
+    batch.clear() ;
+}
+
+Trick::JobData * Trick::ParallelJobPool::next_job( unsigned int index ) {
+
+    Trick::JobData * job = NULL ;
+    unsigned int ii ;
+    unsigned int num_parts = deques.size() ;
+
+    pthread_mutex_lock(deque_mutexes[index]) ;
+    if ( ! deques[index].empty() ) {
+        job = deques[index].back() ;
+        deques[index].pop_back() ;
+    }
+    pthread_mutex_unlock(deque_mutexes[index]) ;
+
+    for ( ii = 1 ; job == NULL and ii < num_parts ; ii++ ) {
+        unsigned int victim = (index + ii) % num_parts ;
+        pthread_mutex_lock(deque_mutexes[victim]) ;
+        if ( ! deques[victim].empty() ) {
+            job = deques[victim].front() ;
+            deques[victim].pop_front() ;
+            __sync_fetch_and_add(&num_steals, 1) ;
+        }
+        pthread_mutex_unlock(deque_mutexes[victim]) ;
+    }
+
+    return job ;
+}
+
+void Trick::ParallelJobPool::work( unsigned int index ) {
+    Trick::JobData * job ;
+    while ( (job = next_job(index)) != NULL ) {
+        call_job(job) ;
+        if ( __sync_sub_and_fetch(&remaining, 1) == 0 ) {
+            batch_done = true ;
+            done_signal.signal() ;
+        }
+    }
+}
+
+void Trick::ParallelJobPool::call_job( Trick::JobData * job ) {
+    int ret = job->call() ;
+    if ( batch_sched_jobs ) {
+        if ( ret != 0 ) {
+            exec_terminate_with_return(ret , job->name.c_str() , 0 , "scheduled job did not return 0") ;
+        }
+        owner->set_job_complete(job) ;
+    }
+}
+
+void Trick::ParallelJobPool::dump( std::ostream & oss ) {
+    if ( ! workers.empty() ) {
+        oss << "    parallel job workers = " << workers.size() << " batches = " << num_batches
+            << " jobs = " << num_pool_jobs << " steals = " << num_steals << std::endl ;
+    }
+}
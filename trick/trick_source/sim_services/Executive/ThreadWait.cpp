@@ -0,0 +1,206 @@
+
+#include <limits.h>
+#include <time.h>
+
+#include "trick/ThreadWait.hh"
+#include "trick/JobData.hh"
+#include "trick/release.h"
+
+#if __linux
+#include <linux/futex.h>
+#include <syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SPIN_PAUSE() __builtin_ia32_pause()
+#else
+#define SPIN_PAUSE()
+#endif
+
+static long long wait_clock_ns() {
+    struct timespec ts ;
+    clock_gettime(CLOCK_MONOTONIC, &ts) ;
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec ;
+}
+
+/* ThreadSignal */
+Trick::ThreadSignal::ThreadSignal() : seq(0) , num_waiters(0) {
+    pthread_mutex_init(&wait_mutex, NULL) ;
+    pthread_cond_init(&wait_cv, NULL) ;
+}
+
+Trick::ThreadSignal::~ThreadSignal() {
+    pthread_cond_destroy(&wait_cv) ;
+    pthread_mutex_destroy(&wait_mutex) ;
+}
+
+unsigned int Trick::ThreadSignal::get_seq() {
+    return __sync_fetch_and_add(&seq, 0) ;
+}
+
+/* The increment of seq is a full barrier.  Either a waiter has registered itself in num_waiters
+   before the increment and is woken, or it registers afterwards and sees the new seq. */
+#if __linux
+void Trick::ThreadSignal::signal() {
+    __sync_fetch_and_add(&seq, 1) ;
+    if ( num_waiters > 0 ) {
+        syscall(SYS_futex, &seq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0) ;
+    }
+}
+
+void Trick::ThreadSignal::wait( unsigned int in_seq ) {
+    __sync_fetch_and_add(&num_waiters, 1) ;
+    syscall(SYS_futex, &seq, FUTEX_WAIT_PRIVATE, in_seq, NULL, NULL, 0) ;
+    __sync_fetch_and_sub(&num_waiters, 1) ;
+}
+#else
+void Trick::ThreadSignal::signal() {
+    __sync_fetch_and_add(&seq, 1) ;
+    if ( num_waiters > 0 ) {
+        pthread_mutex_lock(&wait_mutex) ;
+        pthread_cond_broadcast(&wait_cv) ;
+        pthread_mutex_unlock(&wait_mutex) ;
+    }
+}
+
+void Trick::ThreadSignal::wait( unsigned int in_seq ) {
+    pthread_mutex_lock(&wait_mutex) ;
+    __sync_fetch_and_add(&num_waiters, 1) ;
+    while ( seq == in_seq ) {
+        pthread_cond_wait(&wait_cv, &wait_mutex) ;
+    }
+    __sync_fetch_and_sub(&num_waiters, 1) ;
+    pthread_mutex_unlock(&wait_mutex) ;
+}
+#endif
+
+/* ThreadWait */
+Trick::ThreadWait::ThreadWait() :
+ policy(TW_SPIN) ,
+ spin_count(1000) ,
+ min_spin_count(16) ,
+ max_spin_count(100000) ,
+ num_waits(0) ,
+ num_blocks(0) ,
+ total_wait_ns(0) {}
+
+int Trick::ThreadWait::set_policy( int in_policy ) {
+    if ( in_policy > TW_BLOCK || in_policy < TW_SPIN ) {
+        return(-1) ;
+    }
+    policy = (Trick::ThreadWaitPolicy)in_policy ;
+    return(0) ;
+}
+
+Trick::ThreadWaitPolicy Trick::ThreadWait::get_policy() {
+    return policy ;
+}
+
+int Trick::ThreadWait::set_spin_range( unsigned int in_min , unsigned int in_max ) {
+    if ( in_min > in_max ) {
+        return(-1) ;
+    }
+    min_spin_count = in_min ;
+    max_spin_count = in_max ;
+    if ( spin_count < min_spin_count ) {
+        spin_count = min_spin_count ;
+    } else if ( spin_count > max_spin_count ) {
+        spin_count = max_spin_count ;
+    }
+    return(0) ;
+}
+
+/**
+@details
+-# Return immediately if the flag is already set.  Nothing is counted.
+-# TW_SPIN, or no signal to block on: spin on the flag, releasing the processor if rt_nap is set.
+-# TW_SPIN_FUTEX: spin up to spin_count times.
+   -# If the flag was set while spinning, move spin_count toward twice the spins it took.
+   -# Otherwise shrink spin_count by a quarter and block.
+-# TW_SPIN_FUTEX and TW_BLOCK: block on the signal until the flag is set.  The sequence number is
+   read before the flag so a signal between the test and the block is not lost.
+-# Return the time waited.
+*/
+long long Trick::ThreadWait::wait( volatile bool & flag , ThreadSignal * signal , bool rt_nap ) {
+
+    long long start ;
+    long long waited ;
+    unsigned int seq ;
+
+    if ( flag ) {
+        return 0 ;
+    }
+
+    start = wait_clock_ns() ;
+    num_waits++ ;
+
+    if ( policy == TW_SPIN or signal == NULL ) {
+        while ( ! flag ) {
+            if ( rt_nap == true ) {
+                RELEASE() ;
+            }
+        }
+    } else {
+        if ( policy == TW_SPIN_FUTEX ) {
+            unsigned int ii ;
+            for ( ii = 0 ; ii < spin_count and ! flag ; ii++ ) {
+                SPIN_PAUSE() ;
+            }
+            if ( flag ) {
+                long long target = 2LL * ii ;
+                spin_count = (unsigned int)(spin_count + (target - (long long)spin_count) / 8) ;
+            } else {
+                spin_count -= spin_count / 4 ;
+            }
+            if ( spin_count < min_spin_count ) {
+                spin_count = min_spin_count ;
+            } else if ( spin_count > max_spin_count ) {
+                spin_count = max_spin_count ;
+            }
+        }
+        if ( ! flag ) {
+            num_blocks++ ;
+            while ( true ) {
+                seq = signal->get_seq() ;
+                if ( flag ) {
+                    break ;
+                }
+                signal->wait(seq) ;
+            }
+        }
+    }
+
+    waited = wait_clock_ns() - start ;
+    total_wait_ns += waited ;
+    return waited ;
+}
+
+void Trick::ThreadWait::wait_depend( Trick::JobData * depend_job , ThreadSignal * signal , bool rt_nap ) {
+    long long waited = wait( depend_job->complete , signal , rt_nap ) ;
+    if ( waited > 0 ) {
+        depend_wait_ns[depend_job] += waited ;
+    }
+}
+
+void Trick::ThreadWait::clear_wait_times() {
+    num_waits = 0 ;
+    num_blocks = 0 ;
+    total_wait_ns = 0 ;
+    depend_wait_ns.clear() ;
+}
+
+void Trick::ThreadWait::dump( std::ostream & oss ) {
+    std::map< Trick::JobData * , long long >::iterator it ;
+    oss << "    wait policy = " ;
+    switch ( policy ) {
+        case TW_SPIN: oss << "spin" << std::endl ; break ;
+        case TW_SPIN_FUTEX: oss << "spin then block, spin count = " << spin_count << std::endl ; break ;
+        case TW_BLOCK: oss << "block" << std::endl ; break ;
+    }
+    oss << "    waits = " << num_waits << " blocked = " << num_blocks
+        << " total wait time = " << total_wait_ns / 1.0e9 << " s" << std::endl ;
+    for ( it = depend_wait_ns.begin() ; it != depend_wait_ns.end() ; ++it ) {
+        oss << "        waited on " << it->first->name << " " << it->second / 1.0e9 << " s" << std::endl ;
+    }
+}
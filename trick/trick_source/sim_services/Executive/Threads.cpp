@@ -21,6 +21,7 @@ Trick::Threads::Threads(int in_id , bool in_rt_nap) :
     std::stringstream oss ;
     oss << "Child_" << in_id ;
     name = oss.str() ;
+    parallel_pool.set_owner(this) ;
 }
 
 void Trick::Threads::set_pthread_id(pthread_t in_pthread_id) {
@@ -46,6 +47,8 @@ void Trick::Threads::dump( std::ostream & oss ) {
         case PROCESS_TYPE_AMF_CHILD: oss << "asynchronous must finish with amf_cycle = " << amf_cycle << std::endl ; break ;
     }
     trigger_container.getThreadTrigger()->dump(oss) ;
+    wait_control.dump(oss) ;
+    parallel_pool.dump(oss) ;
     oss << "    number of scheduled jobs = " << job_queue.size() << std::endl ;
     Trick::ThreadBase::dump(oss) ;
 }
@@ -21,22 +21,22 @@
 #endif
 
 #include "trick/Threads.hh"
-#include "trick/release.h"
 #include "trick/ExecutiveException.hh"
 #include "trick/exec_proto.h"
+#include "trick/exec_proto.hh"
 #include "trick/TrickConstant.hh"
 #include "trick/message_proto.h"
 
 
 /**
 @details
--# Wait for all job dependencies to complete.  Requirement  [@ref r_exec_thread_6]
+-# Wait for all job dependencies to complete using the thread wait policy.  Requirement  [@ref r_exec_thread_6]
 -# Call the job.  Requirement  [@ref r_exec_periodic_0]
 -# If the job is a system job, check to see if the next job call time is the lowest next time by
    calling Trick::ScheduledJobQueue::test_next_job_call_time(Trick::JobData *, long long)
--# Set the job complete flag
+-# Set the job complete flag and wake threads waiting on it
 */
-static int call_next_job(Trick::JobData * curr_job, Trick::ScheduledJobQueue & job_queue, bool rt_nap, long long curr_time_tics) {
+static int call_next_job(Trick::JobData * curr_job, Trick::Threads * thread, Trick::ScheduledJobQueue & job_queue, long long curr_time_tics) {
 
     Trick::JobData * depend_job ;
     unsigned int ii ;
@@ -48,10 +48,8 @@ static int call_next_job(Trick::JobData * curr_job, Trick::ScheduledJobQueue & j
     /* Wait for all jobs that the current job depends on to complete. */
     for ( ii = 0 ; ii < curr_job->depends.size() ; ii++ ) {
         depend_job = curr_job->depends[ii] ;
-        while (! depend_job->complete) {
-            if (rt_nap == true) {
-                RELEASE();
-            }
+        if (! depend_job->complete) {
+            thread->wait_for_job(depend_job, exec_get_thread(depend_job->thread)) ;
         }
     }
 
@@ -67,7 +65,7 @@ static int call_next_job(Trick::JobData * curr_job, Trick::ScheduledJobQueue & j
         job_queue.test_next_job_call_time(curr_job , curr_time_tics) ;
     }
 
-    curr_job->complete = true ;
+    thread->set_job_complete(curr_job) ;
 
     return 0 ;
 }
@@ -82,15 +80,17 @@ static int call_next_job(Trick::JobData * curr_job, Trick::ScheduledJobQueue & j
     -# Blocks on mutex or frame trigger until master signals to start processing
     -# Switch if the child is a synchronous thread
         -# For each scheduled jobs whose next call time is equal to the current simulation time [@ref ScheduledJobQueue]
-            -# Call call_next_job(Trick::JobData * curr_job, Trick::ScheduledJobQueue & job_queue, bool rt_nap, long long curr_time_tics)
+            -# Call call_next_job(Trick::JobData * curr_job, Trick::Threads * thread, Trick::ScheduledJobQueue & job_queue, long long curr_time_tics)
     -# Switch if the child is a asynchronous must finish thread
         -# Do while the job queue time is less than the time of the next AMF sync time.
             -# For each scheduled jobs whose next call time is equal to the current queue time
-                -# Call call_next_job(Trick::JobData * curr_job, Trick::ScheduledJobQueue & job_queue, bool rt_nap, long long curr_time_tics)
+                -# Call call_next_job(Trick::JobData * curr_job, Trick::Threads * thread, Trick::ScheduledJobQueue & job_queue, long long curr_time_tics)
     -# Switch if the child is a asynchronous thread
         -# For each scheduled jobs
-            -# Call call_next_job(Trick::JobData * curr_job, Trick::ScheduledJobQueue & job_queue, bool rt_nap, long long curr_time_tics)
-    -# Set the child complete flag
+            -# Call call_next_job(Trick::JobData * curr_job, Trick::Threads * thread, Trick::ScheduledJobQueue & job_queue, long long curr_time_tics)
+    -# Jobs marked parallel are deferred to the thread's Trick::ParallelJobPool instead of being called
+       directly.  The pool is flushed after each pass through the queue.
+    -# Set the child complete flag and wake the master if it is blocked waiting on this thread
 */
 void * Trick::Threads::thread_body() {
 
@@ -98,7 +98,7 @@ void * Trick::Threads::thread_body() {
     trigger_container.getThreadTrigger()->init() ;
 
     /* signal the master that the child is ready and running */
-    child_complete = true;
+    set_child_complete() ;
     running = true ;
 
     try {
@@ -115,8 +115,11 @@ void * Trick::Threads::thread_body() {
                     job_queue.reset_curr_index() ;
                     job_queue.set_next_job_call_time(TRICK_MAX_LONG_LONG) ;
                     while ( (curr_job = job_queue.find_next_job( curr_time_tics )) != NULL ) {
-                        call_next_job(curr_job, job_queue, rt_nap, curr_time_tics) ;
+                        if ( ! parallel_pool.defer_job(curr_job) ) {
+                            call_next_job(curr_job, this, job_queue, curr_time_tics) ;
+                        }
                     }
+                    parallel_pool.flush() ;
                     break ;
 
                     case PROCESS_TYPE_AMF_CHILD:
@@ -135,8 +138,11 @@ void * Trick::Threads::thread_body() {
                         job_queue.reset_curr_index() ;
                         job_queue.set_next_job_call_time(amf_next_tics) ;
                         while ( (curr_job = job_queue.find_next_job( curr_time_tics )) != NULL ) {
-                            call_next_job(curr_job, job_queue, rt_nap, curr_time_tics) ;
+                            if ( ! parallel_pool.defer_job(curr_job) ) {
+                                call_next_job(curr_job, this, job_queue, curr_time_tics) ;
+                            }
                         }
+                        parallel_pool.flush() ;
                         curr_time_tics = job_queue.get_next_job_call_time() ;
                     } while ( curr_time_tics < amf_next_tics ) ;
 
@@ -158,8 +164,11 @@ void * Trick::Threads::thread_body() {
                         job_queue.reset_curr_index() ;
                         job_queue.set_next_job_call_time(TRICK_MAX_LONG_LONG) ;
                         while ( (curr_job = job_queue.get_next_job()) != NULL ) {
-                            call_next_job(curr_job, job_queue, rt_nap, curr_time_tics) ;
+                            if ( ! parallel_pool.defer_job(curr_job) ) {
+                                call_next_job(curr_job, this, job_queue, curr_time_tics) ;
+                            }
                         }
+                        parallel_pool.flush() ;
                     } else {
 
                         // catch up job next times to current frame.
@@ -187,8 +196,11 @@ void * Trick::Threads::thread_body() {
                             job_queue.reset_curr_index() ;
                             job_queue.set_next_job_call_time(amf_next_tics) ;
                             while ( (curr_job = job_queue.find_next_job( curr_time_tics )) != NULL ) {
-                                call_next_job(curr_job, job_queue, rt_nap, curr_time_tics) ;
+                                if ( ! parallel_pool.defer_job(curr_job) ) {
+                                    call_next_job(curr_job, this, job_queue, curr_time_tics) ;
+                                }
                             }
+                            parallel_pool.flush() ;
                             curr_time_tics = job_queue.get_next_job_call_time() ;
                         } while ( curr_time_tics < amf_next_tics ) ;
 
@@ -209,8 +221,8 @@ void * Trick::Threads::thread_body() {
                 }
             }
 
-            /* After all jobs have completed, set the child_complete flag to true. */
-            child_complete = true;
+            /* After all jobs have completed, set the child_complete flag to true and wake the master. */
+            set_child_complete() ;
 
         } while (1);
     } catch (Trick::ExecutiveException & ex ) {
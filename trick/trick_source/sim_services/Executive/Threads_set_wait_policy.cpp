@@ -0,0 +1,29 @@
+
+#include "trick/Threads.hh"
+
+int Trick::Threads::set_wait_policy(int in_policy) {
+    return wait_control.set_policy(in_policy) ;
+}
+
+/**
+@details
+-# Set the completion flag before signaling.  Waiters test the flag after reading the signal
+   sequence number so the wake up is not missed.
+*/
+void Trick::Threads::set_child_complete() {
+    child_complete = true ;
+    complete_signal.signal() ;
+}
+
+void Trick::Threads::set_job_complete( Trick::JobData * job ) {
+    job->complete = true ;
+    complete_signal.signal() ;
+}
+
+void Trick::Threads::wait_for_thread( Trick::Threads * other ) {
+    wait_control.wait( other->child_complete , &other->complete_signal , rt_nap ) ;
+}
+
+void Trick::Threads::wait_for_job( Trick::JobData * depend_job , Trick::Threads * depend_thread ) {
+    wait_control.wait_depend( depend_job , (depend_thread != NULL) ? &depend_thread->complete_signal : NULL , rt_nap ) ;
+}
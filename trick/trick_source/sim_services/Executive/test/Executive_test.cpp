@@ -1,5 +1,8 @@
 
 #include <iostream>
+#include <algorithm>
+#include <vector>
+#include <unistd.h>
 #include <sys/types.h>
 #include <signal.h>
 #include "gtest/gtest.h"
@@ -14,6 +17,7 @@
 #include "trick/SimObject.hh"
 #include "trick/MemoryManager.hh"
 #include "trick/memorymanager_c_intf.h"
+#include "trick/TrickConstant.hh"
 
 void sig_hand(int sig) ;
 void ctrl_c_hand(int sig) ;
@@ -216,6 +220,38 @@ int testSimObject::call_function( Trick::JobData * curr_job ) {
 } ;
 
 
+/* Records the order its jobs run in.  Used to run jobs through a thread's parallel job pool. */
+class poolSimObject : public Trick::SimObject {
+    public:
+        pthread_mutex_t order_mutex ;
+        std::vector< Trick::JobData * > order ;
+        bool depends_complete ;
+        int ret ;
+
+        poolSimObject() : depends_complete(true) , ret(0) {
+            pthread_mutex_init(&order_mutex, NULL) ;
+        }
+        ~poolSimObject() {
+            pthread_mutex_destroy(&order_mutex) ;
+        }
+
+        virtual int call_function( Trick::JobData * curr_job ) {
+            unsigned int ii ;
+            // Give the other pool threads time to steal.
+            usleep(1000) ;
+            pthread_mutex_lock(&order_mutex) ;
+            for ( ii = 0 ; ii < curr_job->depends.size() ; ii++ ) {
+                if ( ! curr_job->depends[ii]->complete ) {
+                    depends_complete = false ;
+                }
+            }
+            order.push_back(curr_job) ;
+            pthread_mutex_unlock(&order_mutex) ;
+            return ret ;
+        }
+        virtual double call_function_double( Trick::JobData * curr_job ) { (void)curr_job ; return 0.0 ; } ;
+} ;
+
 class ExecutiveTest : public ::testing::Test {
 
     protected:
@@ -610,6 +646,61 @@ TEST_F(ExecutiveTest , AdvanceSimTimeToBoundary) {
 
 }
 
+TEST_F(ExecutiveTest , SetTimeRebuildsDispatchSchedule) {
+
+    Trick::Threads * curr_thread ;
+    Trick::JobData * curr_job ;
+    std::vector< std::string > names ;
+    long long curr_time ;
+    int ii ;
+
+    exec.set_job_dispatch_schedule(true) ;
+    exec_add_sim_object(&so1 , "so1") ;
+    curr_thread = get_thread(0) ;
+    exec.set_time_tics(0) ;
+
+    // Run to 3 seconds.  The wheel now holds the jobs at their later call times.
+    curr_time = 0 ;
+    for ( ii = 0 ; ii < 4 ; ii++ ) {
+        curr_thread->job_queue.reset_curr_index() ;
+        curr_thread->job_queue.set_next_job_call_time(TRICK_MAX_LONG_LONG) ;
+        while ( (curr_job = curr_thread->job_queue.find_next_job(curr_time)) != NULL ) ;
+        curr_time = curr_thread->job_queue.get_next_job_call_time() ;
+    }
+    EXPECT_EQ( curr_time , 4000000 ) ;
+
+    // Jump back in time.  Every scheduled job is due at the new time.
+    exec.set_time(0.5) ;
+    curr_thread->job_queue.reset_curr_index() ;
+    curr_thread->job_queue.set_next_job_call_time(TRICK_MAX_LONG_LONG) ;
+    while ( (curr_job = curr_thread->job_queue.find_next_job(500000)) != NULL ) {
+        names.push_back(curr_job->name) ;
+    }
+    ASSERT_GE( names.size() , 3u ) ;
+    EXPECT_TRUE( std::find(names.begin(), names.end(), "so1.scheduled_1") != names.end() ) ;
+    EXPECT_TRUE( std::find(names.begin(), names.end(), "so1.scheduled_2") != names.end() ) ;
+    EXPECT_TRUE( std::find(names.begin(), names.end(), "so1.scheduled_3") != names.end() ) ;
+    EXPECT_EQ( curr_thread->job_queue.get_next_job_call_time() , 1500000 ) ;
+
+    // Jump forward with set_time_tics.  Nothing is due before the new call times.
+    exec.set_time_tics(10000000) ;
+    curr_job = exec.get_job(std::string("so1.scheduled_1")) ;
+    ASSERT_TRUE( curr_job != NULL ) ;
+    EXPECT_GE( curr_job->next_tics , 10000000 ) ;
+    curr_thread->job_queue.reset_curr_index() ;
+    curr_thread->job_queue.set_next_job_call_time(TRICK_MAX_LONG_LONG) ;
+    EXPECT_TRUE( curr_thread->job_queue.find_next_job(9000000) == NULL ) ;
+    curr_time = curr_thread->job_queue.get_next_job_call_time() ;
+    EXPECT_EQ( curr_time , curr_job->next_tics ) ;
+    curr_thread->job_queue.reset_curr_index() ;
+    curr_thread->job_queue.set_next_job_call_time(TRICK_MAX_LONG_LONG) ;
+    names.clear() ;
+    while ( (curr_job = curr_thread->job_queue.find_next_job(curr_time)) != NULL ) {
+        names.push_back(curr_job->name) ;
+    }
+    EXPECT_TRUE( std::find(names.begin(), names.end(), "so1.scheduled_1") != names.end() ) ;
+}
+
 TEST_F(ExecutiveTest , Checkpoint) {
 
     //req.add_requirement("2678139818 1653083281");
@@ -840,6 +931,139 @@ TEST_F(ExecutiveTest , JobOnOff) {
     EXPECT_EQ(exec.set_job_onoff("so1.scheduled_4" , 1 , 0), -1) ;
 }
 
+TEST_F(ExecutiveTest , JobParallel) {
+
+    Trick::JobData * curr_job ;
+
+    exec_add_sim_object(&so1 , "so1") ;
+
+    curr_job = exec.get_job( std::string("so1.scheduled_1")) ;
+    ASSERT_FALSE( curr_job == NULL ) ;
+    EXPECT_EQ( curr_job->parallel , false) ;
+
+    EXPECT_EQ(exec.set_job_parallel("so1.scheduled_1" , 1 , 1), 0) ;
+    EXPECT_EQ( curr_job->parallel , true) ;
+
+    EXPECT_EQ(exec.set_job_parallel("so1.scheduled_1" , 1 , 0), 0) ;
+    EXPECT_EQ( curr_job->parallel , false) ;
+
+    EXPECT_EQ(exec.set_job_parallel("so1.scheduled_4" , 1 , 1), -1) ;
+}
+
+TEST_F(ExecutiveTest , ParallelJobPoolRunsJobs) {
+
+    poolSimObject pso ;
+    std::vector< Trick::JobData * > jobs ;
+    Trick::Threads * curr_thread ;
+    unsigned int ii , jj ;
+    int pass ;
+
+    // Jobs 0-11 are one job class, 12-23 a later one.  Job 5 is not parallel and job 7 depends on job 6.
+    for ( ii = 0 ; ii < 24 ; ii++ ) {
+        Trick::JobData * job = new Trick::JobData(0, ii, "scheduled", NULL, 1.0, "pool_job") ;
+        job->parent_object = &pso ;
+        job->job_class = (ii < 12) ? 10 : 20 ;
+        job->parallel = (ii != 5) ;
+        jobs.push_back(job) ;
+    }
+    jobs[7]->depends.push_back(jobs[6]) ;
+
+    exec_add_sim_object(&empty_so , "empty_so") ;
+    curr_thread = get_thread(0) ;
+    EXPECT_EQ( exec.set_thread_parallel_workers(0 , 3) , 0 ) ;
+
+    // Each pass waits for the batches with another wait policy.
+    for ( pass = 0 ; pass < 3 ; pass++ ) {
+        EXPECT_EQ( curr_thread->wait_control.set_policy(pass) , 0 ) ;
+        pso.order.clear() ;
+        for ( ii = 0 ; ii < jobs.size() ; ii++ ) {
+            jobs[ii]->complete = false ;
+        }
+        // Dispatch the way the thread loops do.
+        for ( ii = 0 ; ii < jobs.size() ; ii++ ) {
+            if ( ! curr_thread->parallel_pool.defer_job(jobs[ii]) ) {
+                jobs[ii]->call() ;
+                curr_thread->set_job_complete(jobs[ii]) ;
+            }
+        }
+        curr_thread->parallel_pool.flush() ;
+
+        // Every job ran exactly once and completed.
+        ASSERT_EQ( pso.order.size() , jobs.size() ) ;
+        for ( ii = 0 ; ii < jobs.size() ; ii++ ) {
+            EXPECT_EQ( std::count(pso.order.begin(), pso.order.end(), jobs[ii]) , 1 ) ;
+            EXPECT_TRUE( jobs[ii]->complete ) ;
+        }
+
+        // The earlier job class finished before the later one started.  The serial job ran
+        // between the jobs before and after it, and job 7 ran after job 6.
+        for ( ii = 0 ; ii < pso.order.size() ; ii++ ) {
+            unsigned int id = pso.order[ii]->id ;
+            for ( jj = ii + 1 ; jj < pso.order.size() ; jj++ ) {
+                unsigned int later_id = pso.order[jj]->id ;
+                EXPECT_FALSE( pso.order[ii]->job_class == 20 and pso.order[jj]->job_class == 10 ) ;
+                EXPECT_FALSE( id == 5 and later_id < 5 ) ;
+                EXPECT_FALSE( id > 5 and id < 12 and later_id == 5 ) ;
+                EXPECT_FALSE( id == 7 and later_id == 6 ) ;
+            }
+        }
+        EXPECT_TRUE( pso.depends_complete ) ;
+    }
+
+    // Batches per pass: jobs 0-4, job 6, jobs 7-11 and jobs 12-23.
+    EXPECT_EQ( curr_thread->parallel_pool.num_batches , 12 ) ;
+    EXPECT_EQ( curr_thread->parallel_pool.num_pool_jobs , 69 ) ;
+
+    EXPECT_EQ( exec.set_thread_parallel_workers(0 , 0) , 0 ) ;
+    for ( ii = 0 ; ii < jobs.size() ; ii++ ) {
+        delete jobs[ii] ;
+    }
+}
+
+TEST_F(ExecutiveTest , ParallelJobPoolRunsDerivativeJobs) {
+
+    poolSimObject pso ;
+    std::vector< Trick::JobData * > jobs ;
+    Trick::Threads * curr_thread ;
+    unsigned int ii ;
+
+    // Derivative jobs are called by an integration loop.  Their return values are ignored and they are
+    // not marked complete.  A scheduled job does not join their batch.
+    for ( ii = 0 ; ii < 9 ; ii++ ) {
+        Trick::JobData * job = new Trick::JobData(0, ii, "derivative", NULL, 1.0, "pool_deriv_job") ;
+        job->parent_object = &pso ;
+        job->parallel = true ;
+        jobs.push_back(job) ;
+    }
+    pso.ret = 1 ;
+
+    exec_add_sim_object(&empty_so , "empty_so") ;
+    curr_thread = get_thread(0) ;
+    EXPECT_EQ( exec.set_thread_parallel_workers(0 , 3) , 0 ) ;
+    EXPECT_EQ( curr_thread->wait_control.set_policy(TW_BLOCK) , 0 ) ;
+
+    for ( ii = 0 ; ii < 8 ; ii++ ) {
+        EXPECT_TRUE( curr_thread->parallel_pool.defer_job(jobs[ii], false) ) ;
+    }
+    EXPECT_EQ( curr_thread->parallel_pool.num_batches , 0 ) ;
+    pso.ret = 0 ;
+    EXPECT_TRUE( curr_thread->parallel_pool.defer_job(jobs[8]) ) ;
+    EXPECT_EQ( curr_thread->parallel_pool.num_batches , 1 ) ;
+    curr_thread->parallel_pool.flush() ;
+
+    ASSERT_EQ( pso.order.size() , jobs.size() ) ;
+    for ( ii = 0 ; ii < jobs.size() ; ii++ ) {
+        EXPECT_EQ( std::count(pso.order.begin(), pso.order.end(), jobs[ii]) , 1 ) ;
+        EXPECT_EQ( jobs[ii]->complete , ii == 8 ) ;
+    }
+    EXPECT_EQ( curr_thread->parallel_pool.num_batches , 2 ) ;
+
+    EXPECT_EQ( exec.set_thread_parallel_workers(0 , 0) , 0 ) ;
+    for ( ii = 0 ; ii < jobs.size() ; ii++ ) {
+        delete jobs[ii] ;
+    }
+}
+
 TEST_F(ExecutiveTest , SimObjectOnOff) {
 	//req.add_requirement("3132950280");
 
@@ -898,6 +1122,55 @@ TEST_F(ExecutiveTest , SetThreadParameters) {
     EXPECT_EQ( exec.set_thread_priority(0 , 1) , 0 ) ;
     EXPECT_EQ( exec.set_thread_priority(1 , 2) , 0 ) ;
     EXPECT_EQ( exec.set_thread_priority(2 , 1) , -2 ) ;
+
+    EXPECT_EQ( exec.set_thread_wait_policy(0 , TW_BLOCK) , 0 ) ;
+    EXPECT_EQ( exec.set_thread_wait_policy(1 , TW_SPIN_FUTEX) , 0 ) ;
+    EXPECT_EQ( exec.set_thread_wait_policy(1 , 3) , -1 ) ;
+    EXPECT_EQ( exec.set_thread_wait_policy(2 , TW_SPIN) , -2 ) ;
+    EXPECT_EQ( exec.get_thread(0)->wait_control.get_policy() , TW_BLOCK ) ;
+    EXPECT_EQ( exec.get_thread(1)->wait_control.get_policy() , TW_SPIN_FUTEX ) ;
+
+    EXPECT_EQ( exec.set_thread_parallel_workers(0 , 2) , 0 ) ;
+    EXPECT_EQ( exec.get_thread(0)->parallel_pool.get_num_workers() , 2u ) ;
+    EXPECT_EQ( exec.set_thread_parallel_workers(0 , 0) , 0 ) ;
+    EXPECT_EQ( exec.get_thread(0)->parallel_pool.get_num_workers() , 0u ) ;
+    EXPECT_EQ( exec.set_thread_parallel_workers(2 , 1) , -2 ) ;
+}
+
+static void * set_complete_later( void * arg ) {
+    Trick::Threads * thread = (Trick::Threads *)arg ;
+    usleep(20000) ;
+    thread->set_child_complete() ;
+    return NULL ;
+}
+
+TEST_F(ExecutiveTest , ThreadWaitPolicies) {
+
+    int policy ;
+    for ( policy = TW_SPIN ; policy <= TW_BLOCK ; policy++ ) {
+        Trick::Threads waiter(0) ;
+        Trick::Threads child(1) ;
+        pthread_t signaler ;
+
+        EXPECT_EQ( waiter.set_wait_policy(policy) , 0 ) ;
+        child.child_complete = false ;
+        pthread_create(&signaler, NULL, set_complete_later, &child) ;
+        waiter.wait_for_thread(&child) ;
+        pthread_join(signaler, NULL) ;
+
+        EXPECT_TRUE( child.child_complete ) ;
+        EXPECT_EQ( waiter.wait_control.num_waits , 1 ) ;
+        EXPECT_GT( waiter.wait_control.total_wait_ns , 0 ) ;
+        if ( policy == TW_SPIN ) {
+            EXPECT_EQ( waiter.wait_control.num_blocks , 0 ) ;
+        } else {
+            EXPECT_EQ( waiter.wait_control.num_blocks , 1 ) ;
+        }
+
+        /* A flag that is already set does not count as a wait. */
+        waiter.wait_for_thread(&child) ;
+        EXPECT_EQ( waiter.wait_control.num_waits , 1 ) ;
+    }
 }
 
 }
@@ -0,0 +1,495 @@
+/*
+   PURPOSE: ( Event conditions compiled to expression trees )
+   REFERENCE: ( Trick Simulation Environment )
+   ASSUMPTIONS AND LIMITATIONS: ( Only a subset of Python expressions is compiled )
+   CLASS: ( N/A )
+   LIBRARY DEPENDENCY: ( None )
+*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trick/IPCondition.hh"
+#include "trick/attributes.h"
+#include "trick/memorymanager_c_intf.h"
+#include "trick/parameter_types.h"
+
+static void skip_blanks( const char *& p ) {
+    while ( *p == ' ' or *p == '\t' ) {
+        p++ ;
+    }
+}
+
+static bool is_name_char( char c ) {
+    return isalnum((unsigned char)c) or c == '_' ;
+}
+
+/* Tests for a keyword that is not the start of a longer name. */
+static bool match_keyword( const char *& p , const char * keyword ) {
+    size_t len = strlen(keyword) ;
+    if ( ! strncmp(p, keyword, len) and ! is_name_char(p[len]) ) {
+        p += len ;
+        return true ;
+    }
+    return false ;
+}
+
+static bool is_keyword( const std::string & name ) {
+    static const char * keywords[] = { "and" , "or" , "not" , "is" , "in" , "if" , "else" , "lambda" ,
+                                       "None" , "True" , "False" } ;
+    for ( unsigned int ii = 0 ; ii < sizeof(keywords) / sizeof(keywords[0]) ; ii++ ) {
+        if ( ! name.compare(keywords[ii]) ) {
+            return true ;
+        }
+    }
+    return false ;
+}
+
+/*
+   Compares an integer with a double exactly, as Python does, instead of rounding the integer to a double.  Returns
+   -1, 0, or 1 as i is less than, equal to, or greater than d, and 2 if d is NaN.
+*/
+static int compare_int_double( long long i , double d ) {
+    if ( d != d ) {
+        return 2 ;
+    }
+    // 2^63, every long long is below it and every double at or above it is past the end of long long.
+    if ( d >= 9223372036854775808.0 ) {
+        return -1 ;
+    }
+    if ( d < -9223372036854775808.0 ) {
+        return 1 ;
+    }
+    // Doubles this large are integers, and truncation of the rest is exact.
+    long long whole = (long long)d ;
+    double fraction = d - (double)whole ;
+    if ( i != whole ) {
+        return (i < whole) ? -1 : 1 ;
+    }
+    return (fraction > 0.0) ? -1 : (fraction < 0.0) ? 1 : 0 ;
+}
+
+Trick::IPCondition::IPCondition() : root(-1) {}
+
+Trick::IPCondition::~IPCondition() {
+    for ( unsigned int ii = 0 ; ii < nodes.size() ; ii++ ) {
+        if ( nodes[ii].ref != NULL ) {
+            ref_free(nodes[ii].ref) ;
+            free(nodes[ii].ref) ;
+        }
+    }
+}
+
+/**
+@details
+-# Parse the whole string with the grammar
+   or_expr := and_expr ("or" and_expr)*, and_expr := not_expr ("and" not_expr)*,
+   not_expr := "not" not_expr | operand [compare operand], operand := "(" or_expr ")" | number | True | False | variable
+-# Return NULL if anything is left over, a comparison is chained, or a variable is not a single number.
+*/
+Trick::IPCondition * Trick::IPCondition::compile( const std::string & str ) {
+
+    IPCondition * cond = new IPCondition ;
+    const char * p = str.c_str() ;
+
+    skip_blanks(p) ;
+    cond->root = cond->parse_or(p) ;
+    while ( cond->root >= 0 and isspace((unsigned char)*p) ) {
+        p++ ;
+    }
+    if ( cond->root < 0 or *p != '\0' ) {
+        delete cond ;
+        return NULL ;
+    }
+    return cond ;
+}
+
+int Trick::IPCondition::add_node( NodeType type , int left , int right ) {
+    Node node ;
+    node.type = type ;
+    node.value.is_int = true ;
+    node.value.i = 0 ;
+    node.value.d = 0.0 ;
+    node.ref = NULL ;
+    node.left = left ;
+    node.right = right ;
+    nodes.push_back(node) ;
+    return nodes.size() - 1 ;
+}
+
+int Trick::IPCondition::parse_or( const char *& p ) {
+    int left = parse_and(p) ;
+    while ( left >= 0 and match_keyword(p, "or") ) {
+        skip_blanks(p) ;
+        int right = parse_and(p) ;
+        if ( right < 0 ) {
+            return -1 ;
+        }
+        left = add_node(OR, left, right) ;
+    }
+    return left ;
+}
+
+int Trick::IPCondition::parse_and( const char *& p ) {
+    int left = parse_not(p) ;
+    while ( left >= 0 and match_keyword(p, "and") ) {
+        skip_blanks(p) ;
+        int right = parse_not(p) ;
+        if ( right < 0 ) {
+            return -1 ;
+        }
+        left = add_node(AND, left, right) ;
+    }
+    return left ;
+}
+
+int Trick::IPCondition::parse_not( const char *& p ) {
+    if ( match_keyword(p, "not") ) {
+        skip_blanks(p) ;
+        int operand = parse_not(p) ;
+        if ( operand < 0 ) {
+            return -1 ;
+        }
+        return add_node(NOT, operand) ;
+    }
+    return parse_comparison(p) ;
+}
+
+int Trick::IPCondition::parse_comparison( const char *& p ) {
+    static const struct {
+        const char * op ;
+        NodeType type ;
+    } compares[] = { { "<=" , LE } , { ">=" , GE } , { "==" , EQ } , { "!=" , NE } , { "<" , LT } , { ">" , GT } } ;
+
+    int left = parse_operand(p) ;
+    if ( left < 0 ) {
+        return -1 ;
+    }
+    for ( int pass = 0 ; pass < 2 ; pass++ ) {
+        unsigned int ii ;
+        for ( ii = 0 ; ii < sizeof(compares) / sizeof(compares[0]) ; ii++ ) {
+            if ( ! strncmp(p, compares[ii].op, strlen(compares[ii].op)) ) {
+                break ;
+            }
+        }
+        if ( ii == sizeof(compares) / sizeof(compares[0]) ) {
+            return left ;
+        }
+        // A chained comparison like a < b < c means something else in Python.
+        if ( pass == 1 ) {
+            return -1 ;
+        }
+        p += strlen(compares[ii].op) ;
+        skip_blanks(p) ;
+        int right = parse_operand(p) ;
+        if ( right < 0 ) {
+            return -1 ;
+        }
+        left = add_node(compares[ii].type, left, right) ;
+    }
+    return left ;
+}
+
+int Trick::IPCondition::parse_operand( const char *& p ) {
+
+    int index = -1 ;
+
+    if ( *p == '(' ) {
+        p++ ;
+        skip_blanks(p) ;
+        index = parse_or(p) ;
+        if ( index < 0 or *p != ')' ) {
+            return -1 ;
+        }
+        p++ ;
+    } else if ( match_keyword(p, "True") ) {
+        index = add_node(LITERAL) ;
+        nodes[index].value.i = 1 ;
+    } else if ( match_keyword(p, "False") ) {
+        index = add_node(LITERAL) ;
+    } else if ( isdigit((unsigned char)*p) or *p == '.' or *p == '-' or *p == '+' ) {
+        // A number.  Hex, octal, and numbers with underscores are left to Python.
+        std::string number ;
+        if ( *p == '-' or *p == '+' ) {
+            number += *p++ ;
+            skip_blanks(p) ;
+        }
+        const char * digits = p ;
+        bool is_int = true ;
+        while ( isdigit((unsigned char)*p) or *p == '.' or *p == 'e' or *p == 'E' or
+                ((*p == '+' or *p == '-') and (p[-1] == 'e' or p[-1] == 'E')) ) {
+            if ( ! isdigit((unsigned char)*p) ) {
+                is_int = false ;
+            }
+            p++ ;
+        }
+        if ( p == digits or is_name_char(*p) or (is_int and *digits == '0' and p - digits > 1) ) {
+            return -1 ;
+        }
+        number.append(digits, p - digits) ;
+        char * end ;
+        errno = 0 ;
+        index = add_node(LITERAL) ;
+        nodes[index].value.is_int = is_int ;
+        if ( is_int ) {
+            nodes[index].value.i = strtoll(number.c_str(), &end, 10) ;
+        } else {
+            nodes[index].value.d = strtod(number.c_str(), &end) ;
+        }
+        // Integers beyond long long are left to Python, which has no limit.
+        if ( *end != '\0' or (is_int and errno == ERANGE) ) {
+            return -1 ;
+        }
+    } else if ( isalpha((unsigned char)*p) or *p == '_' ) {
+        // A model variable, written as names separated by dots with constant indexes.
+        std::string name ;
+        std::string base ;
+        while ( true ) {
+            const char * start = p ;
+            while ( is_name_char(*p) ) {
+                p++ ;
+            }
+            std::string part(start, p - start) ;
+            if ( part.empty() or isdigit((unsigned char)part[0]) or is_keyword(part) ) {
+                return -1 ;
+            }
+            name += part ;
+            if ( base.empty() ) {
+                base = part ;
+            }
+            while ( *p == '[' ) {
+                p++ ;
+                skip_blanks(p) ;
+                start = p ;
+                while ( isdigit((unsigned char)*p) ) {
+                    p++ ;
+                }
+                std::string dim(start, p - start) ;
+                skip_blanks(p) ;
+                if ( dim.empty() or (dim[0] == '0' and dim.size() > 1) or *p != ']' ) {
+                    return -1 ;
+                }
+                p++ ;
+                name += "[" + dim + "]" ;
+            }
+            if ( *p != '.' ) {
+                break ;
+            }
+            p++ ;
+            name += "." ;
+        }
+
+        // Anything else named in Python, or a call, is left to Python.
+        skip_blanks(p) ;
+        if ( *p == '(' or ! TMM_var_exists(base.c_str()) ) {
+            return -1 ;
+        }
+        index = add_node(VARIABLE) ;
+        nodes[index].name = name ;
+        if ( ! resolve_node(nodes[index]) ) {
+            return -1 ;
+        }
+    } else {
+        return -1 ;
+    }
+
+    skip_blanks(p) ;
+    return index ;
+}
+
+bool Trick::IPCondition::resolve() {
+    bool ok = true ;
+    for ( unsigned int ii = 0 ; ii < nodes.size() ; ii++ ) {
+        if ( nodes[ii].type == VARIABLE and ! resolve_node(nodes[ii]) ) {
+            ok = false ;
+        }
+    }
+    return ok ;
+}
+
+/**
+@details
+-# Free the reference and look up the variable by name.
+-# The variable must be a single number, bool, or enumeration.  Characters and strings are different objects in
+   Python.
+*/
+bool Trick::IPCondition::resolve_node( Node & node ) {
+
+    if ( node.ref != NULL ) {
+        ref_free(node.ref) ;
+        free(node.ref) ;
+    }
+    node.ref = ref_attributes((char *)node.name.c_str()) ;
+    if ( node.ref == NULL ) {
+        return false ;
+    }
+
+    bool single = (node.ref->num_index == node.ref->attr->num_index) ;
+    switch ( node.ref->attr->type ) {
+        case TRICK_SHORT:
+        case TRICK_UNSIGNED_SHORT:
+        case TRICK_INTEGER:
+        case TRICK_UNSIGNED_INTEGER:
+        case TRICK_LONG:
+        case TRICK_UNSIGNED_LONG:
+        case TRICK_LONG_LONG:
+        case TRICK_UNSIGNED_LONG_LONG:
+        case TRICK_FLOAT:
+        case TRICK_DOUBLE:
+        case TRICK_BOOLEAN:
+            break ;
+        case TRICK_ENUMERATED:
+            single &= (node.ref->attr->size == sizeof(char) or node.ref->attr->size == sizeof(short) or
+                       node.ref->attr->size == sizeof(int)) ;
+            break ;
+        default:
+            single = false ;
+            break ;
+    }
+    if ( ! single ) {
+        ref_free(node.ref) ;
+        free(node.ref) ;
+        node.ref = NULL ;
+    }
+    return single ;
+}
+
+bool Trick::IPCondition::get_value( int index , Value & value ) {
+
+    Node & node = nodes[index] ;
+
+    if ( node.type == LITERAL ) {
+        value = node.value ;
+        return true ;
+    }
+    if ( node.type != VARIABLE ) {
+        bool result ;
+        if ( ! get_bool(index, result) ) {
+            return false ;
+        }
+        value.is_int = true ;
+        value.i = result ;
+        return true ;
+    }
+
+    if ( node.ref->pointer_present ) {
+        node.ref->address = follow_address_path(node.ref) ;
+    }
+    void * address = node.ref->address ;
+    if ( address == NULL ) {
+        return false ;
+    }
+
+    value.is_int = true ;
+    switch ( node.ref->attr->type ) {
+        case TRICK_SHORT:              value.i = *(short *)address ; break ;
+        case TRICK_UNSIGNED_SHORT:     value.i = *(unsigned short *)address ; break ;
+        case TRICK_INTEGER:            value.i = *(int *)address ; break ;
+        case TRICK_UNSIGNED_INTEGER:   value.i = *(unsigned int *)address ; break ;
+        case TRICK_LONG:               value.i = *(long *)address ; break ;
+        case TRICK_LONG_LONG:          value.i = *(long long *)address ; break ;
+        case TRICK_BOOLEAN:            value.i = *(bool *)address ; break ;
+        case TRICK_UNSIGNED_LONG:
+        case TRICK_UNSIGNED_LONG_LONG: {
+            unsigned long long ull = (node.ref->attr->type == TRICK_UNSIGNED_LONG) ?
+                                     *(unsigned long *)address : *(unsigned long long *)address ;
+            // Python compares this exactly, leave it to Python rather than round it to a double.
+            if ( ull > (unsigned long long)LLONG_MAX ) {
+                return false ;
+            }
+            value.i = (long long)ull ;
+            break ;
+        }
+        case TRICK_ENUMERATED:
+            if ( node.ref->attr->size == sizeof(char) ) {
+                value.i = *(char *)address ;
+            } else if ( node.ref->attr->size == sizeof(short) ) {
+                value.i = *(short *)address ;
+            } else {
+                value.i = *(int *)address ;
+            }
+            break ;
+        case TRICK_FLOAT:
+            value.is_int = false ;
+            value.d = *(float *)address ;
+            break ;
+        default:
+            value.is_int = false ;
+            value.d = *(double *)address ;
+            break ;
+    }
+    return true ;
+}
+
+bool Trick::IPCondition::get_bool( int index , bool & result ) {
+
+    Node & node = nodes[index] ;
+    bool left ;
+    Value lvalue , rvalue ;
+
+    switch ( node.type ) {
+        case NOT:
+            if ( ! get_bool(node.left, left) ) {
+                return false ;
+            }
+            result = ! left ;
+            return true ;
+        case AND:
+        case OR:
+            // Short circuit like Python, the right side may not be reachable.
+            if ( ! get_bool(node.left, left) ) {
+                return false ;
+            }
+            if ( left == (node.type == OR) ) {
+                result = left ;
+                return true ;
+            }
+            return get_bool(node.right, result) ;
+        case LITERAL:
+        case VARIABLE:
+            if ( ! get_value(index, lvalue) ) {
+                return false ;
+            }
+            result = lvalue.is_int ? (lvalue.i != 0) : (lvalue.d != 0.0) ;
+            return true ;
+        default:
+            break ;
+    }
+
+    if ( ! get_value(node.left, lvalue) or ! get_value(node.right, rvalue) ) {
+        return false ;
+    }
+    int cmp ;
+    if ( lvalue.is_int and rvalue.is_int ) {
+        cmp = (lvalue.i < rvalue.i) ? -1 : (lvalue.i > rvalue.i) ? 1 : 0 ;
+    } else if ( lvalue.is_int ) {
+        cmp = compare_int_double(lvalue.i, rvalue.d) ;
+    } else if ( rvalue.is_int ) {
+        cmp = compare_int_double(rvalue.i, lvalue.d) ;
+        cmp = (cmp == 2) ? 2 : -cmp ;
+    } else {
+        // NaN compares unequal to everything, as in Python.
+        cmp = (lvalue.d < rvalue.d) ? -1 : (lvalue.d > rvalue.d) ? 1 : (lvalue.d == rvalue.d) ? 0 : 2 ;
+    }
+    switch ( node.type ) {
+        case LT: result = (cmp == -1) ; break ;
+        case LE: result = (cmp == -1 or cmp == 0) ; break ;
+        case GT: result = (cmp == 1) ; break ;
+        case GE: result = (cmp == 1 or cmp == 0) ; break ;
+        case EQ: result = (cmp == 0) ; break ;
+        default: result = (cmp != 0) ; break ;
+    }
+    return true ;
+}
+
+bool Trick::IPCondition::evaluate( int & result ) {
+    bool value ;
+    if ( ! get_bool(root, value) ) {
+        return false ;
+    }
+    result = value ;
+    return true ;
+}
@@ -186,6 +186,58 @@ int Trick::IPPython::parse_condition(std::string in_string, int & cond_return_va
 
 }
 
+/**
+@details
+-# Compile the same statement parse_condition(std::string, int &) runs.  A string that does not compile returns
+   NULL, and is parsed as a string each time so that the error is reported as before.
+*/
+void * Trick::IPPython::compile_condition(std::string in_string) {
+
+    PyObject * code = NULL ;
+
+    pthread_mutex_lock(&ip_mutex);
+    if ( Py_IsInitialized() ) {
+        in_string =  std::string("trick_ip.ip.return_val = ") + in_string + "\n" ;
+        code = Py_CompileString(in_string.c_str(), "<event condition>", Py_file_input) ;
+        if ( code == NULL ) {
+            PyErr_Clear() ;
+        }
+    }
+    pthread_mutex_unlock(&ip_mutex);
+
+    return code ;
+}
+
+int Trick::IPPython::parse_condition(void * in_code, int & cond_return_val ) {
+
+    pthread_mutex_lock(&ip_mutex);
+    // Run the code in __main__ like PyRun_SimpleString.
+    PyObject * globals = PyModule_GetDict(PyImport_AddModule("__main__")) ;
+#if PY_MAJOR_VERSION >= 3
+    PyObject * result = PyEval_EvalCode((PyObject *)in_code, globals, globals) ;
+#else
+    PyObject * result = PyEval_EvalCode((PyCodeObject *)in_code, globals, globals) ;
+#endif
+    if ( result == NULL ) {
+        PyErr_Print() ;
+    } else {
+        Py_DECREF(result) ;
+    }
+    cond_return_val = return_val ;
+    pthread_mutex_unlock(&ip_mutex);
+
+    return 0 ;
+}
+
+void Trick::IPPython::delete_condition(void * in_code) {
+
+    pthread_mutex_lock(&ip_mutex);
+    if ( Py_IsInitialized() ) {
+        Py_XDECREF((PyObject *)in_code) ;
+    }
+    pthread_mutex_unlock(&ip_mutex);
+}
+
 //Restart job that reloads event_list from checkpointable structures
 int Trick::IPPython::restart() {
     /* Make shortcut names for all known sim_objects. */
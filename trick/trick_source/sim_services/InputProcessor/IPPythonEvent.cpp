@@ -11,9 +11,11 @@
 #include <string>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "trick/IPPythonEvent.hh"
 #include "trick/IPPython.hh"
+#include "trick/IPCondition.hh"
 #include "trick/MemoryManager.hh"
 #include "trick/exec_proto.h"
 #include "trick/message_proto.h"
@@ -30,6 +32,12 @@ Trick::IPPython * Trick::IPPythonEvent::ip ;
 Trick::MTV * Trick::IPPythonEvent::mtv ;
 bool Trick::IPPythonEvent::info_msg = false ;
 
+static double monotonic_time() {
+    struct timespec ts ;
+    clock_gettime(CLOCK_MONOTONIC, &ts) ;
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9 ;
+}
+
 Trick::condition_t::condition_t() {
     enabled = 0 ;
     hold = 0 ;
@@ -38,6 +46,8 @@ Trick::condition_t::condition_t() {
     fired_time = -1.0 ;
     ref = NULL ;
     job = NULL ;
+    expr = NULL ;
+    code = NULL ;
 }
 
 Trick::action_t::action_t() {
@@ -61,6 +71,7 @@ Trick::IPPythonEvent::IPPythonEvent() {
     action_count = 0 ;
     fired_count = 0 ;
     fired_time = -1.0 ;
+    cond_eval_time = 0.0 ;
     ran_count = 0 ;
     ran_time = -1.0 ;
     fired = false ;
@@ -73,6 +84,7 @@ Trick::IPPythonEvent::IPPythonEvent() {
 Trick::IPPythonEvent::~IPPythonEvent() {
 
     for (int ii=0; ii<condition_count; ii++) {
+        delete_compiled_condition(condition_list[ii]);
         TMM_delete_var_a(condition_list[ii]);
     }
     TMM_delete_var_a(condition_list);
@@ -163,6 +175,9 @@ void Trick::IPPythonEvent::restart() {
         if (condition_list[jj]->cond_type==2) { // condition job
             condition_list[jj]->job = exec_get_job(condition_list[jj]->str.c_str(),1);
         }
+        if (condition_list[jj]->cond_type==0) { // condition string, compiled again for the restored variables
+            compile_condition(condition_list[jj]);
+        }
     }
     for (jj=0; jj<action_count; jj++) {
         if (action_list[jj]->act_type!=0) { // action job
@@ -240,6 +255,8 @@ int Trick::IPPythonEvent::condition(int num, std::string str, std::string commen
             condition_list[num]->cond_type = 2;
         } else condition_list[num]->cond_type = 0;
         condition_list[num]->str = str;
+        /** @li Compile a python condition string once instead of parsing it each time it is evaluated. */
+        compile_condition(condition_list[num]);
         // comment is for display in mtv, if not supplied create a comment containing up to 50 characters of cond string
         if (comment.empty()) {
             condition_list[num]->comment = str.substr(0,50);
@@ -254,6 +271,60 @@ int Trick::IPPythonEvent::condition(int num, std::string str, std::string commen
     return(0);
 }
 
+/**
+@details
+-# Delete the previous compiled forms of the condition.
+-# A string condition that only compares model variables and literals is compiled to an IPCondition.  The variables
+   are looked up here, and again when a checkpoint is loaded.
+-# Any other string condition is compiled to a python code object.
+*/
+void Trick::IPPythonEvent::compile_condition(condition_t * cond) {
+
+    delete_compiled_condition(cond) ;
+    if (cond->cond_type != 0) {
+        return ;
+    }
+    cond->expr = Trick::IPCondition::compile(cond->str) ;
+    if (cond->expr == NULL and ip != NULL) {
+        cond->code = ip->compile_condition(cond->str) ;
+    }
+}
+
+void Trick::IPPythonEvent::delete_compiled_condition(condition_t * cond) {
+
+    delete cond->expr ;
+    cond->expr = NULL ;
+    if (cond->code != NULL and ip != NULL) {
+        ip->delete_condition(cond->code) ;
+    }
+    cond->code = NULL ;
+}
+
+/**
+@details
+-# A string compiled to an expression tree is evaluated without python.
+-# If there is no expression tree, or one of its variables could not be reached, run the compiled python code.
+-# If the string did not compile, use python to evaluate the string.
+*/
+int Trick::IPPythonEvent::evaluate_condition_string(condition_t * cond) {
+
+    int return_val = 0 ;
+
+    if (cond->expr != NULL and cond->expr->evaluate(return_val)) {
+        return return_val ;
+    }
+    if (cond->code == NULL and cond->expr != NULL and ip != NULL) {
+        // the expression tree could not be evaluated this time, compile the string for python once
+        cond->code = ip->compile_condition(cond->str) ;
+    }
+    if (cond->code != NULL) {
+        ip->parse_condition(cond->code, return_val) ;
+    } else {
+        ip->parse_condition(cond->str, return_val) ;
+    }
+    return return_val ;
+}
+
 //Command to set an existing condition to hold, so that when it fires it stays in the fired state.
 int Trick::IPPythonEvent::condition_hold_on(int num) {
 
@@ -524,6 +595,8 @@ bool Trick::IPPythonEvent::process_user_event( long long curr_time ) {
     ran = false ;
     /** @li No need to evaluate any conditions if in manual mode. */
     if (! manual) {
+        /** @li Time the condition evaluation for the event's cond_eval_time. */
+        double eval_start = monotonic_time() ;
         hold = false ;
         /** @li Loop thru all conditions. */
         for (ii=0; ii<condition_count; ii++) {
@@ -554,9 +627,8 @@ bool Trick::IPPythonEvent::process_user_event( long long curr_time ) {
                     return_val = condition_list[ii]->job->call();
                     condition_list[ii]->job->disabled = save_disabled_state;
                 } else {
-                // otherwise use python to evaluate string
-                    std::string full_in_string ;
-                    ip->parse_condition(condition_list[ii]->str, return_val) ;
+                // otherwise it's a python string
+                    return_val = evaluate_condition_string(condition_list[ii]) ;
                 }
                 if (return_val) {
                 //TODO: write to log/send_hs that trigger fired
@@ -579,6 +651,7 @@ bool Trick::IPPythonEvent::process_user_event( long long curr_time ) {
                 }
             }
         } //end condition loop
+        cond_eval_time += monotonic_time() - eval_start ;
     }
     it_fired = manual_fired || fired ;
     /** @li Set the event's fired state...cond_all: if all conditions fired , otherwise if any condition fired. */
@@ -0,0 +1,338 @@
+
+#include <Python.h>
+#include <stdio.h>
+#include <limits>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+#define protected public
+#define private public
+#include "trick/IPCondition.hh"
+#include "trick/IPPython.hh"
+#include "trick/IPPythonEvent.hh"
+#include "trick/MemoryManager.hh"
+
+namespace Trick {
+
+static IPPython * test_ip ;
+
+/* Stands in for the SWIG wrapped trick_ip.ip.return_val that compiled and string conditions assign. */
+static PyObject * set_return_val( PyObject * , PyObject * value ) {
+    test_ip->return_val = PyObject_IsTrue(value) ;
+    Py_RETURN_NONE ;
+}
+
+static PyMethodDef set_return_val_def = { "set_return_val" , set_return_val , METH_O , NULL } ;
+
+/* Evaluates conditions with the expression tree and with Python, over the same model variables. */
+class IPConditionTest : public ::testing::Test {
+
+    protected:
+        IPConditionTest() {}
+        ~IPConditionTest() {}
+
+        void SetUp() {
+            if ( ! Py_IsInitialized() ) {
+                Py_Initialize() ;
+                PyObject * func = PyCFunction_New(&set_return_val_def, NULL) ;
+                PyDict_SetItemString(globals(), "set_return_val", func) ;
+                Py_DECREF(func) ;
+                PyRun_SimpleString(
+                 "class _IP(object):\n"
+                 "    def __setattr__(self, name, value):\n"
+                 "        set_return_val(value)\n"
+                 "class _TrickIP(object):\n"
+                 "    ip = _IP()\n"
+                 "trick_ip = _TrickIP()\n") ;
+            }
+            test_ip = &ip ;
+            IPPythonEvent::set_python_processor(&ip) ;
+
+            memmgr = new Trick::MemoryManager ;
+            s = (short *)memmgr->declare_var("short s") ;
+            us = (unsigned short *)memmgr->declare_var("unsigned short us") ;
+            i = (int *)memmgr->declare_var("int i") ;
+            ui = (unsigned int *)memmgr->declare_var("unsigned int ui") ;
+            l = (long *)memmgr->declare_var("long l") ;
+            ul = (unsigned long *)memmgr->declare_var("unsigned long ul") ;
+            ll = (long long *)memmgr->declare_var("long long ll") ;
+            ull = (unsigned long long *)memmgr->declare_var("unsigned long long ull") ;
+            f = (float *)memmgr->declare_var("float f") ;
+            d = (double *)memmgr->declare_var("double d") ;
+            b = (bool *)memmgr->declare_var("bool b") ;
+            ptr = (int **)memmgr->declare_var("int * ptr") ;
+        }
+
+        void TearDown() {
+            delete memmgr ;
+        }
+
+        static PyObject * globals() {
+            return PyModule_GetDict(PyImport_AddModule("__main__")) ;
+        }
+
+        /* Sets a Python global to the repr of a value. */
+        void set_python( const char * name , const std::string & value ) {
+            std::string statement = std::string(name) + " = " + value ;
+            ASSERT_EQ(0, PyRun_SimpleString(statement.c_str())) << statement ;
+        }
+
+        template <class T> void set( const char * name , T * var , T value ) {
+            *var = value ;
+            set_python(name, std::to_string(value)) ;
+        }
+
+        void set( const char * name , bool * var , bool value ) {
+            *var = value ;
+            set_python(name, value ? "True" : "False") ;
+        }
+
+        template <class T> void set_real( const char * name , T * var , double value ) {
+            *var = (T)value ;
+            char buf[64] ;
+            double exact = *var ;
+            if ( exact != exact ) {
+                snprintf(buf, sizeof(buf), "float('nan')") ;
+            } else if ( exact == std::numeric_limits<double>::infinity() or
+                        exact == -std::numeric_limits<double>::infinity() ) {
+                snprintf(buf, sizeof(buf), "float('%sinf')", exact < 0 ? "-" : "") ;
+            } else {
+                snprintf(buf, sizeof(buf), "%.17g", exact) ;
+            }
+            set_python(name, buf) ;
+        }
+
+        /* Evaluates a condition in Python as IPPython does, returning its truth or -1 if it raised. */
+        int python_eval( const std::string & expr ) {
+            std::string statement = "cond_result = " + expr + "\n" ;
+            PyObject * result = PyRun_String(statement.c_str(), Py_file_input, globals(), globals()) ;
+            if ( result == NULL ) {
+                PyErr_Clear() ;
+                return -1 ;
+            }
+            Py_DECREF(result) ;
+            return PyObject_IsTrue(PyDict_GetItemString(globals(), "cond_result")) ;
+        }
+
+        /* Expects expr to compile to an expression tree that agrees with Python, returns false if it fell back. */
+        bool expect_same( const std::string & expr ) {
+            IPCondition * cond = IPCondition::compile(expr) ;
+            EXPECT_TRUE(cond != NULL) << expr ;
+            if ( cond == NULL ) {
+                return false ;
+            }
+            int result = -1 ;
+            bool evaluated = cond->evaluate(result) ;
+            if ( evaluated ) {
+                EXPECT_EQ(python_eval(expr), result) << expr ;
+            }
+            delete cond ;
+            return evaluated ;
+        }
+
+        Trick::MemoryManager * memmgr ;
+        IPPython ip ;
+        short * s ;
+        unsigned short * us ;
+        int * i ;
+        unsigned int * ui ;
+        long * l ;
+        unsigned long * ul ;
+        long long * ll ;
+        unsigned long long * ull ;
+        float * f ;
+        double * d ;
+        bool * b ;
+        int ** ptr ;
+} ;
+
+TEST_F( IPConditionTest , Precedence ) {
+    const char * exprs[] = {
+        "not i < 3 or d > 1.5 and b" ,
+        "(not i < 3 or d > 1.5) and b" ,
+        "not (i < 3 or d > 1.5) and b" ,
+        "not i < 3 or (d > 1.5 and b)" ,
+        "i == 3 or i == 4 and False" ,
+        "(i == 3 or i == 4) and False" ,
+        "not not b" ,
+        "not b == False" ,
+        "True and not False or i" ,
+        "i and d" ,
+        "b or i and not d" ,
+        "- 2 < i" ,
+        "i != -3.5" ,
+        "1e3 >= d" ,
+        ".5 < d" ,
+        "5. > d" ,
+        "1E-3 <= d" ,
+        "+4 == i" ,
+        "((i < 4)) and (((b)))" ,
+        "  d < 2  " ,
+        "i < 4 or i > 2 or i == 5 or not b" ,
+    } ;
+    int ivals[] = { 0 , 3 , 4 , 5 , -2 } ;
+    double dvals[] = { 0.0 , 0.5 , 1.5 , 2.0 , 1.0e3 , -0.25 } ;
+    for ( unsigned int ii = 0 ; ii < sizeof(ivals) / sizeof(ivals[0]) ; ii++ ) {
+        for ( unsigned int jj = 0 ; jj < sizeof(dvals) / sizeof(dvals[0]) ; jj++ ) {
+            for ( int kk = 0 ; kk < 2 ; kk++ ) {
+                set("i", i, ivals[ii]) ;
+                set_real("d", d, dvals[jj]) ;
+                set("b", b, (bool)kk) ;
+                for ( unsigned int ee = 0 ; ee < sizeof(exprs) / sizeof(exprs[0]) ; ee++ ) {
+                    EXPECT_TRUE(expect_same(exprs[ee])) << exprs[ee] ;
+                }
+            }
+        }
+    }
+}
+
+TEST_F( IPConditionTest , VariableTypes ) {
+    const char * vars[] = { "s" , "us" , "i" , "ui" , "l" , "ul" , "ll" , "ull" , "f" , "d" , "b" } ;
+    const char * ops[] = { "<" , "<=" , ">" , ">=" , "==" , "!=" } ;
+    const char * literals[] = { "0" , "1" , "-1" , "2" , "2.5" , "-0.5" , "65535" , "4294967296" ,
+                                "9007199254740993" , "9223372036854775807" , "-9223372036854775808" ,
+                                "9007199254740992.0" , "1e300" , "True" , "False" } ;
+    long long ivals[] = { 0 , 1 , -1 , 2 , 65535 , 9007199254740993LL , std::numeric_limits<long long>::min() ,
+                          std::numeric_limits<long long>::max() } ;
+    double dvals[] = { 0.0 , 1.0 , -1.0 , 2.5 , -0.5 , 9007199254740992.0 , 1.0e300 , 9.3e18 ,
+                       std::numeric_limits<double>::quiet_NaN() , std::numeric_limits<double>::infinity() } ;
+    unsigned int num_evaluated = 0 ;
+    unsigned int num_fell_back = 0 ;
+
+    for ( unsigned int vv = 0 ; vv < sizeof(ivals) / sizeof(ivals[0]) ; vv++ ) {
+        set("s", s, (short)ivals[vv]) ;
+        set("us", us, (unsigned short)ivals[vv]) ;
+        set("i", i, (int)ivals[vv]) ;
+        set("ui", ui, (unsigned int)ivals[vv]) ;
+        set("l", l, (long)ivals[vv]) ;
+        set("ul", ul, (unsigned long)ivals[vv]) ;
+        set("ll", ll, ivals[vv]) ;
+        set("ull", ull, (unsigned long long)ivals[vv]) ;
+        set("b", b, ivals[vv] != 0) ;
+        set_real("f", f, dvals[vv]) ;
+        set_real("d", d, dvals[(vv + 3) % (sizeof(dvals) / sizeof(dvals[0]))]) ;
+
+        for ( unsigned int xx = 0 ; xx < sizeof(vars) / sizeof(vars[0]) ; xx++ ) {
+            for ( unsigned int oo = 0 ; oo < sizeof(ops) / sizeof(ops[0]) ; oo++ ) {
+                std::vector< std::string > exprs ;
+                for ( unsigned int ll_ = 0 ; ll_ < sizeof(literals) / sizeof(literals[0]) ; ll_++ ) {
+                    exprs.push_back(std::string(vars[xx]) + " " + ops[oo] + " " + literals[ll_]) ;
+                    exprs.push_back(std::string(literals[ll_]) + " " + ops[oo] + " " + vars[xx]) ;
+                }
+                for ( unsigned int yy = 0 ; yy < sizeof(vars) / sizeof(vars[0]) ; yy++ ) {
+                    exprs.push_back(std::string(vars[xx]) + " " + ops[oo] + " " + vars[yy]) ;
+                }
+                for ( unsigned int ee = 0 ; ee < exprs.size() ; ee++ ) {
+                    if ( expect_same(exprs[ee]) ) {
+                        num_evaluated++ ;
+                    } else {
+                        num_fell_back++ ;
+                    }
+                }
+            }
+        }
+    }
+    // Only unsigned values beyond long long are left to Python.
+    EXPECT_GT(num_evaluated, 10 * num_fell_back) ;
+}
+
+TEST_F( IPConditionTest , UnsignedBeyondLongLong ) {
+    // Python compares these exactly, the expression tree leaves them to Python.
+    set("ull", ull, std::numeric_limits<unsigned long long>::max()) ;
+    IPCondition * cond = IPCondition::compile("ull > 18446744073709551614.0") ;
+    ASSERT_TRUE(cond != NULL) ;
+    int result ;
+    EXPECT_FALSE(cond->evaluate(result)) ;
+    delete cond ;
+}
+
+TEST_F( IPConditionTest , MustFallBack ) {
+    const char * exprs[] = {
+        "" ,
+        "i < d < 3" ,
+        "i + 1 > 2" ,
+        "-i < 0" ,
+        "abs(i) > 1" ,
+        "0x10 > i" ,
+        "010 > i" ,
+        "1_000 > i" ,
+        "1j != i" ,
+        "99999999999999999999 > ll" ,
+        "b is True" ,
+        "i in (1, 2)" ,
+        "i > 2 if b else False" ,
+        "not_a_variable > 1" ,
+        "ptr > 0" ,
+        "i[0] > 1" ,
+        "i.x > 1" ,
+        "'a' == 'a'" ,
+        "None" ,
+        "i > 1 and" ,
+        "(i > 1" ,
+        "i > 1)" ,
+        "i = 1" ,
+        "i < > 1" ,
+        "i >> 1" ,
+        "i > 1 ; d > 1" ,
+        "i > 1 # comment" ,
+        "i.__class__ == int" ,
+        "lambda: i" ,
+    } ;
+    set("i", i, 3) ;
+    set_real("d", d, 1.5) ;
+    set("b", b, true) ;
+    set("ll", ll, 7LL) ;
+    for ( unsigned int ee = 0 ; ee < sizeof(exprs) / sizeof(exprs[0]) ; ee++ ) {
+        EXPECT_TRUE(IPCondition::compile(exprs[ee]) == NULL) << exprs[ee] ;
+    }
+}
+
+TEST_F( IPConditionTest , FallbackOrder ) {
+    IPPythonEvent event ;
+    condition_t cond ;
+    cond.cond_type = 0 ;
+
+    // The expression tree is evaluated without Python, which sees a different i here.
+    *i = 3 ;
+    set_python("i", "0") ;
+    cond.str = "i > 2" ;
+    event.compile_condition(&cond) ;
+    ASSERT_TRUE(cond.expr != NULL) ;
+    EXPECT_TRUE(cond.code == NULL) ;
+    EXPECT_EQ(1, event.evaluate_condition_string(&cond)) ;
+
+    // A string that is not compiled to a tree is compiled once to Python code.
+    set("i", i, 3) ;
+    cond.str = "i + 1 > 2" ;
+    event.compile_condition(&cond) ;
+    EXPECT_TRUE(cond.expr == NULL) ;
+    ASSERT_TRUE(cond.code != NULL) ;
+    EXPECT_EQ(python_eval(cond.str), event.evaluate_condition_string(&cond)) ;
+    set("i", i, 0) ;
+    EXPECT_EQ(python_eval(cond.str), event.evaluate_condition_string(&cond)) ;
+
+    // A string that does not compile is parsed each time so that its error is reported.
+    cond.str = "i >" ;
+    event.compile_condition(&cond) ;
+    EXPECT_TRUE(cond.expr == NULL) ;
+    EXPECT_TRUE(cond.code == NULL) ;
+    ip.return_val = 0 ;
+    EXPECT_EQ(0, event.evaluate_condition_string(&cond)) ;
+
+    // A tree whose variable cannot be reached falls back to Python code.
+    *ptr = NULL ;
+    set_python("ptr", "[5]") ;
+    cond.str = "ptr[0] > 2" ;
+    event.compile_condition(&cond) ;
+    ASSERT_TRUE(cond.expr != NULL) ;
+    EXPECT_EQ(1, event.evaluate_condition_string(&cond)) ;
+    EXPECT_TRUE(cond.code != NULL) ;
+    int target = 1 ;
+    *ptr = &target ;
+    EXPECT_EQ(0, event.evaluate_condition_string(&cond)) ;
+
+    event.delete_compiled_condition(&cond) ;
+}
+
+}
@@ -0,0 +1,239 @@
+/*******************************************************************************
+
+Purpose:
+  (Define the class IntegBatchGroup, which integrates the states of many
+   objects that use the same integration technique with one integrator.)
+
+*******************************************************************************/
+
+
+// Local includes
+#include "trick/IntegBatchGroup.hh"
+
+// System includes
+#include <algorithm>
+
+
+/**
+ Constructor.
+ @param in_alg The integration technique of the members.
+ @param in_size The size of the state vector, or of the position vector, of each member.
+ @param in_second_order True if the members are second order ODEs.
+ */
+Trick::IntegBatchGroup::IntegBatchGroup (
+    Integrator_type in_alg,
+    unsigned int in_size,
+    bool in_second_order)
+:
+    alg (in_alg),
+    size (in_size),
+    second_order (in_second_order),
+    rebuild (true),
+    states (),
+    rates (),
+    accels (),
+    state_buf (),
+    rate_buf (),
+    accel_buf (),
+    integ (NULL)
+{}
+
+/**
+ Destructor.
+ */
+Trick::IntegBatchGroup::~IntegBatchGroup ()
+{
+    reset_integrator();
+}
+
+/**
+ Determine if states with the given technique and size belong to this group.
+ */
+bool Trick::IntegBatchGroup::matches (
+    Integrator_type in_alg,
+    unsigned int in_size,
+    bool in_second_order) const
+{
+    return (alg == in_alg) && (size == in_size) &&
+           (second_order == in_second_order);
+}
+
+/**
+ Add a member to a first order group.
+ */
+void Trick::IntegBatchGroup::add_state (
+    double * state,
+    double * deriv)
+{
+    states.push_back (state);
+    rates.push_back (deriv);
+    rebuild = true;
+}
+
+/**
+ Add a member to a second order group.
+ */
+void Trick::IntegBatchGroup::add_state (
+    double * position,
+    double * velocity,
+    double * accel)
+{
+    states.push_back (position);
+    rates.push_back (velocity);
+    accels.push_back (accel);
+    rebuild = true;
+}
+
+/**
+ Remove a member from the group.
+ */
+bool Trick::IntegBatchGroup::remove_state (
+    double * state)
+{
+    std::vector<double *>::iterator iter =
+        std::find (states.begin(), states.end(), state);
+    if (iter == states.end()) {
+        return false;
+    }
+
+    size_t index = iter - states.begin();
+    states.erase (iter);
+    rates.erase (rates.begin() + index);
+    if (second_order) {
+        accels.erase (accels.begin() + index);
+    }
+    rebuild = true;
+    return true;
+}
+
+/**
+ Get the integrator, creating it for the current members if needed.
+ The integrator of a changed group is replaced, so a multistep technique
+ restarts its history when members are added or removed.
+ */
+Trick::Integrator * Trick::IntegBatchGroup::get_integrator ()
+{
+    if (rebuild) {
+        reset_integrator();
+        rebuild = false;
+
+        if (! states.empty()) {
+            size_t buf_size = states.size() * size;
+            state_buf.assign (buf_size, 0.0);
+            rate_buf.assign (buf_size, 0.0);
+            accel_buf.assign (second_order ? buf_size : 0, 0.0);
+
+            // A second order integrator holds both position and velocity.
+            integ = Trick::getIntegrator (
+                alg, (unsigned int)(second_order ? 2 * buf_size : buf_size));
+        }
+    }
+    return integ;
+}
+
+/**
+ Delete the integrator.
+ */
+void Trick::IntegBatchGroup::reset_integrator ()
+{
+    if (integ != NULL) {
+        Trick::deleteIntegrator (integ);
+    }
+    rebuild = true;
+}
+
+/**
+ Perform one integration pass for all members.
+ */
+int Trick::IntegBatchGroup::integrate (
+    double beg_time,
+    double dt,
+    int ex_pass)
+{
+    Trick::Integrator * integrator = get_integrator();
+    if (integrator == NULL) {
+        return 0;
+    }
+
+    if (ex_pass == 1) {
+        integrator->time = beg_time;
+        integrator->dt   = dt;
+    }
+
+    const size_t num_members = states.size();
+
+    // Gather. Element k of member m goes to k * num_members + m.
+    for (size_t mm = 0; mm < num_members; ++mm) {
+        const double * state = states[mm];
+        const double * rate  = rates[mm];
+        for (size_t kk = 0; kk < size; ++kk) {
+            state_buf[kk * num_members + mm] = state[kk];
+            rate_buf[kk * num_members + mm]  = rate[kk];
+        }
+        if (second_order) {
+            const double * accel = accels[mm];
+            for (size_t kk = 0; kk < size; ++kk) {
+                accel_buf[kk * num_members + mm] = accel[kk];
+            }
+        }
+    }
+
+    // Advance every member with a single call.
+    int rc;
+    if (second_order) {
+        rc = integrator->integrate_2nd_order_ode (
+                 &accel_buf[0], &rate_buf[0], &state_buf[0]);
+    }
+    else {
+        rc = integrator->integrate_1st_order_ode (
+                 &rate_buf[0], &state_buf[0]);
+    }
+
+    scatter();
+
+    return rc;
+}
+
+int Trick::IntegBatchGroup::set_dense_state (double theta)
+{
+    // The integrator interpolates into the buffers it unloaded to.
+    if ((integ == NULL) || rebuild || (integ->set_dense_state (theta) != 0)) {
+        return 1;
+    }
+    scatter();
+    return 0;
+}
+
+bool Trick::IntegBatchGroup::has_dense_state ()
+{
+    return (integ != NULL) && ! rebuild && integ->has_dense_state();
+}
+
+int Trick::IntegBatchGroup::restore_start_state ()
+{
+    if ((integ == NULL) || rebuild || (integ->restore_start_state () != 0)) {
+        return 1;
+    }
+    scatter();
+    return 0;
+}
+
+void Trick::IntegBatchGroup::scatter ()
+{
+    const size_t num_members = states.size();
+
+    // Scatter. Only the state, and the velocity of a second order ODE,
+    // are changed by the integrator.
+    for (size_t mm = 0; mm < num_members; ++mm) {
+        double * state = states[mm];
+        for (size_t kk = 0; kk < size; ++kk) {
+            state[kk] = state_buf[kk * num_members + mm];
+        }
+        if (second_order) {
+            double * velocity = rates[mm];
+            for (size_t kk = 0; kk < size; ++kk) {
+                velocity[kk] = rate_buf[kk * num_members + mm];
+            }
+        }
+    }
+}
@@ -8,6 +8,8 @@
 
 // Trick includes
 #include "trick/exec_proto.h"
+#include "trick/exec_proto.hh"
+#include "trick/Threads.hh"
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
 
@@ -15,6 +17,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cstdarg>
+#include <cmath>
 
 
 // Anonymous namespace for local functions
@@ -32,6 +35,30 @@ namespace {
             curr_job->call();
         }
     }
+
+    /**
+     * Process the enabled derivative jobs.  Jobs marked parallel run on the
+     * parallel job pool of the thread running the integration loop.
+     * @param job_queue  Derivative job queue to be processed.
+     */
+    inline void call_derivative_jobs (
+        Trick::ScheduledJobQueue & job_queue)
+    {
+        Trick::Threads * thread = exec_get_thread (exec_get_process_id());
+        if ((thread == NULL) || (thread->parallel_pool.get_num_workers() == 0)) {
+            call_jobs (job_queue);
+            return;
+        }
+
+        Trick::JobData * curr_job;
+        job_queue.reset_curr_index();
+        while ((curr_job = job_queue.get_next_job()) != NULL) {
+            if (! thread->parallel_pool.defer_job (curr_job, false)) {
+                curr_job->call();
+            }
+        }
+        thread->parallel_pool.flush();
+    }
 }
 
 
@@ -59,17 +86,28 @@ Trick::IntegLoopScheduler::IntegLoopScheduler(
     verbosity (0),
     last_step_deriv (false),
     first_step_deriv (false),
+    dense_events (false),
+    adaptive_step (false),
+    min_substep (0.0),
+    max_substep (0.0),
+    substep (0.0),
+    num_substeps (0),
+    num_rejected_substeps (0),
+    min_substep_taken (0.0),
+    max_substep_taken (0.0),
     integ_ptr (NULL),
     sim_objects (),
 
     nominal_cycle (in_cycle),
     next_cycle (in_cycle),
     parent_sim_object (in_parent_so),
+    last_substep (in_cycle),
     pre_integ_jobs (),
     deriv_jobs (),
     integ_jobs (),
     dynamic_event_jobs (),
-    post_integ_jobs ()
+    post_integ_jobs (),
+    batch_groups ()
 {
     complete_construction();
 }
@@ -84,21 +122,45 @@ Trick::IntegLoopScheduler::IntegLoopScheduler()
     verbosity (0),
     last_step_deriv (false),
     first_step_deriv (false),
+    dense_events (false),
+    adaptive_step (false),
+    min_substep (0.0),
+    max_substep (0.0),
+    substep (0.0),
+    num_substeps (0),
+    num_rejected_substeps (0),
+    min_substep_taken (0.0),
+    max_substep_taken (0.0),
     integ_ptr (NULL),
     sim_objects (),
 
     nominal_cycle (),
     next_cycle (),
     parent_sim_object (NULL),
+    last_substep (),
     pre_integ_jobs (),
     deriv_jobs (),
     integ_jobs (),
     dynamic_event_jobs (),
-    post_integ_jobs ()
+    post_integ_jobs (),
+    batch_groups ()
 {
     complete_construction();
 }
 
+/**
+ Destructor
+ */
+Trick::IntegLoopScheduler::~IntegLoopScheduler()
+{
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        delete *iter;
+    }
+}
+
 /**
  Complete the construction of an integration loop.
  All constructors but the copy constructor call this method.
@@ -134,6 +196,96 @@ Trick::IntegLoopScheduler::find_sim_object(Trick::SimObject & sim_obj)
     return std::find (sim_objects.begin(), sim_objects.end(), &sim_obj);
 }
 
+/**
+ Find the batch group for the specified technique and state size,
+ creating the group if there is none.
+ */
+Trick::IntegBatchGroup * Trick::IntegLoopScheduler::get_batch_group (
+    Integrator_type alg, unsigned int size, bool second_order)
+{
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        if ((*iter)->matches (alg, size, second_order)) {
+            return *iter;
+        }
+    }
+    batch_groups.push_back (new Trick::IntegBatchGroup (alg, size, second_order));
+    return batch_groups.back();
+}
+
+/**
+ Add a first order state to the batch group for its technique and size.
+ @param alg The integration technique.
+ @param size The number of elements in the state and derivative vectors.
+ @param state The state vector.
+ @param deriv The derivative vector.
+ */
+int Trick::IntegLoopScheduler::add_batch_state (
+    Integrator_type alg, unsigned int size,
+    double * state, double * deriv)
+{
+    if ((state == NULL) || (deriv == NULL) || (size == 0)) {
+        message_publish (
+            MSG_ERROR,
+            "Integ Scheduler ERROR: Batch state has no elements.\n");
+        return 1;
+    }
+    get_batch_group (alg, size, false)->add_state (state, deriv);
+    return 0;
+}
+
+/**
+ Add a second order state to the batch group for its technique and size.
+ @param alg The integration technique.
+ @param size The number of elements in each vector.
+ @param position The position vector.
+ @param velocity The velocity vector.
+ @param accel The acceleration vector.
+ */
+int Trick::IntegLoopScheduler::add_batch_state (
+    Integrator_type alg, unsigned int size,
+    double * position, double * velocity, double * accel)
+{
+    if ((position == NULL) || (velocity == NULL) || (accel == NULL) ||
+        (size == 0)) {
+        message_publish (
+            MSG_ERROR,
+            "Integ Scheduler ERROR: Batch state has no elements.\n");
+        return 1;
+    }
+    get_batch_group (alg, size, true)->add_state (position, velocity, accel);
+    return 0;
+}
+
+/**
+ Remove a state from its batch group. Empty groups are deleted.
+ @param state The state, or position, vector given to add_batch_state.
+ */
+int Trick::IntegLoopScheduler::remove_batch_state (
+    double * state)
+{
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        Trick::IntegBatchGroup * group = *iter;
+        if (group->remove_state (state)) {
+            if (group->get_num_states() == 0) {
+                delete group;
+                batch_groups.erase (iter);
+            }
+            return 0;
+        }
+    }
+    message_publish (
+        MSG_ERROR,
+        "Integ Scheduler ERROR: "
+        "Batch state is not managed by this integration loop.\n");
+    return 1;
+}
+
 /**
  Add jobs from specified object.
  @param in_obj Pointer to the sim object from which the integration jobs
@@ -254,6 +406,15 @@ int Trick::IntegLoopScheduler::remove_sim_object(Trick::SimObject & sim_obj)
 void Trick::IntegLoopScheduler::restart_checkpoint()
 {
     manager.clear_sim_object_info();
+
+    // The batch integrators are not part of the checkpoint.
+    // New ones are created on the first integration after the restart.
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        (*iter)->reset_integrator();
+    }
 }
 
 /**
@@ -319,7 +480,7 @@ void Trick::IntegLoopScheduler::clear_queue (
  */
 void Trick::IntegLoopScheduler::call_deriv_jobs ()
 {
-    call_jobs (deriv_jobs);
+    call_derivative_jobs (deriv_jobs);
 }
 
 /**
@@ -337,7 +498,12 @@ int Trick::IntegLoopScheduler::integrate()
     call_jobs (pre_integ_jobs);
 
     // Integrate sim objects to the current time.
-    status = integrate_dt (beg_time, next_cycle);
+    last_substep = next_cycle;
+    if (adaptive_step) {
+        status = integrate_adaptive (beg_time, next_cycle);
+    } else {
+        status = integrate_dt (beg_time, next_cycle);
+    }
     if (status != 0) {
         return status;
     }
@@ -352,7 +518,7 @@ int Trick::IntegLoopScheduler::integrate()
 
     // Call the jobs in the derivative job queue one more time if indicated.
     if (get_last_step_deriv()) {
-         call_jobs (deriv_jobs);
+         call_derivative_jobs (deriv_jobs);
     }
 
     // Call all of the jobs in the post-integration job queue.
@@ -393,6 +559,17 @@ bool Trick::IntegLoopScheduler::get_first_step_deriv_from_integrator()
         }
     }
 
+    // The batch groups have integrators of their own.
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        Trick::Integrator* trick_integrator = (*iter)->get_integrator();
+        if ((trick_integrator != NULL) && trick_integrator->first_step_deriv) {
+            return true;
+        }
+    }
+
     return false;
 }
 
@@ -428,6 +605,17 @@ bool Trick::IntegLoopScheduler::get_last_step_deriv()
         }
     }
 
+    // The batch groups have integrators of their own.
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        Trick::Integrator* trick_integrator = (*iter)->get_integrator();
+        if ((trick_integrator != NULL) && trick_integrator->last_step_deriv) {
+            return true;
+        }
+    }
+
     return false;
 }
 
@@ -446,7 +634,7 @@ int Trick::IntegLoopScheduler::integrate_dt (
         ex_pass ++;
         // Call all of the jobs in the derivative job queue if needed.
         if (need_derivs) {
-             call_jobs (deriv_jobs);
+             call_derivative_jobs (deriv_jobs);
         }
         need_derivs = true;
 
@@ -500,11 +688,243 @@ int Trick::IntegLoopScheduler::integrate_dt (
                 return 1;
             }
         }
+
+        // Advance the batch groups, which march to the same beat.
+        for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+                 batch_groups.begin();
+             iter != batch_groups.end();
+             ++iter) {
+            Trick::IntegBatchGroup * group = *iter;
+
+            if (group->get_integrator() == NULL) {
+                message_publish (
+                    MSG_ERROR,
+                    "Integ Scheduler ERROR: "
+                    "Batch group has no associated Integrator.\n");
+                return 1;
+            }
+
+            if (verbosity || group->get_integrator()->verbosity) {
+                message_publish (MSG_DEBUG,
+                                 "Batch: %u states, time: %f, dt: %f\n",
+                                 group->get_num_states(), beg_time, dt);
+            }
+
+            ipass = group->integrate (beg_time, dt, ex_pass);
+
+            if ((ipass != 0) && (ipass != ex_pass)) {
+                message_publish (
+                    MSG_ERROR,
+                    "Integ Scheduler ERROR: Integrators not in sync.\n");
+                return 1;
+            }
+        }
     } while (ipass);
 
     return 0;
 }
 
+/**
+ Integrate over the specified time interval in substeps sized to keep the
+ error estimate of every integrator within its tolerance. The size of the
+ next substep is 0.9 * ratio^(-1/(order+1)) times the size of the last one,
+ bounded to a fifth and five times, where ratio is the error ratio of the
+ last substep and order the error order of the integrators. The last substep
+ of the interval is shortened to end on the end of the interval.
+ */
+int Trick::IntegLoopScheduler::integrate_adaptive (
+    double beg_time,
+    double dt)
+{
+    double end_time = beg_time + dt;
+    double end_offset = 1e-12 * dt;
+    double max_step = (max_substep > 0.0) ? max_substep : nominal_cycle;
+    double step = (substep > 0.0) ? substep : dt;
+    double curr_time = beg_time;
+    int status;
+
+    if (step > max_step) {
+        step = max_step;
+    }
+
+    while (end_time - curr_time > end_offset) {
+        double step_dt = step;
+        bool last_step = false;
+        int order;
+
+        if (curr_time + step_dt >= end_time - end_offset) {
+            step_dt = end_time - curr_time;
+            last_step = true;
+        }
+
+        status = integrate_dt (curr_time, step_dt);
+        if (status != 0) {
+            return status;
+        }
+
+        double ratio = get_error_ratio (order);
+
+        // Without an error estimate the rest of the interval is one step.
+        if (ratio < 0.0) {
+            message_publish (
+                MSG_WARNING,
+                "Integ Scheduler WARNING: "
+                "An integrator has no error estimate, adaptive substeps are turned off.\n");
+            adaptive_step = false;
+            curr_time += step_dt;
+            last_substep = step_dt;
+            if (end_time - curr_time > end_offset) {
+                last_substep = end_time - curr_time;
+                return integrate_dt (curr_time, end_time - curr_time);
+            }
+            return 0;
+        }
+
+        double factor = 5.0;
+        if (ratio > 0.0) {
+            factor = 0.9 * pow (ratio, -1.0 / (order + 1));
+            if (! (factor >= 0.2)) {
+                factor = 0.2;
+            } else if (factor > 5.0) {
+                factor = 5.0;
+            }
+        }
+
+        if ((ratio <= 1.0) || (step_dt <= min_substep) || (step_dt <= end_offset)) {
+            curr_time += step_dt;
+            last_substep = step_dt;
+            if ((num_substeps == 0) || (step_dt < min_substep_taken)) {
+                min_substep_taken = step_dt;
+            }
+            if ((num_substeps == 0) || (step_dt > max_substep_taken)) {
+                max_substep_taken = step_dt;
+            }
+            num_substeps ++;
+
+            // A shortened last step says little about how large a step may be.
+            if (! last_step || (step_dt * factor < step)) {
+                step = step_dt * factor;
+            }
+        } else {
+            if (verbosity) {
+                message_publish (MSG_DEBUG,
+                                 "Substep rejected, time: %f, dt: %g, error ratio: %g\n",
+                                 curr_time, step_dt, ratio);
+            }
+            status = restore_start_state();
+            if (status != 0) {
+                return status;
+            }
+            num_rejected_substeps ++;
+            step = step_dt * factor;
+        }
+
+        if (step < min_substep) {
+            step = min_substep;
+        }
+        if (step > max_step) {
+            step = max_step;
+        }
+    }
+
+    substep = step;
+
+    return 0;
+}
+
+/**
+ Get the largest error ratio of the integrators of this loop.
+ */
+double Trick::IntegLoopScheduler::get_error_ratio (int & order)
+{
+    Trick::JobData * curr_job;
+    Trick::Integrator * trick_integrator;
+    double max_ratio = 0.0;
+    bool have_order = false;
+
+    order = 0;
+
+    integ_jobs.reset_curr_index();
+    while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+        if (curr_job->sup_class_data == NULL) {
+            trick_integrator = integ_ptr;
+        } else {
+            trick_integrator = *(static_cast<Trick::Integrator**>(curr_job->sup_class_data));
+        }
+        double ratio = trick_integrator->get_error_ratio();
+        if (ratio < 0.0) {
+            return -1.0;
+        }
+        if (! (ratio <= max_ratio)) {
+            max_ratio = ratio;
+        }
+        if (! have_order || (trick_integrator->get_error_order() < order)) {
+            order = trick_integrator->get_error_order();
+            have_order = true;
+        }
+    }
+
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        trick_integrator = (*iter)->get_integrator();
+        double ratio = trick_integrator->get_error_ratio();
+        if (ratio < 0.0) {
+            return -1.0;
+        }
+        if (! (ratio <= max_ratio)) {
+            max_ratio = ratio;
+        }
+        if (! have_order || (trick_integrator->get_error_order() < order)) {
+            order = trick_integrator->get_error_order();
+            have_order = true;
+        }
+    }
+
+    return max_ratio;
+}
+
+/**
+ Write the states of this loop at the start of the step just completed.
+ */
+int Trick::IntegLoopScheduler::restore_start_state ()
+{
+    Trick::JobData * curr_job;
+    Trick::Integrator * trick_integrator;
+
+    integ_jobs.reset_curr_index();
+    while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+        if (curr_job->sup_class_data == NULL) {
+            trick_integrator = integ_ptr;
+        } else {
+            trick_integrator = *(static_cast<Trick::Integrator**>(curr_job->sup_class_data));
+        }
+        if (trick_integrator->restore_start_state() != 0) {
+            message_publish (
+                MSG_ERROR,
+                "Integ Scheduler ERROR: "
+                "Cannot restore the state of job %s.\n", curr_job->name.c_str());
+            return 1;
+        }
+    }
+
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        if ((*iter)->restore_start_state() != 0) {
+            message_publish (
+                MSG_ERROR,
+                "Integ Scheduler ERROR: "
+                "Cannot restore the state of a batch group.\n");
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 /**
  Process the dynamic event queue.
  @param end_time The time the curr_time variable is set and be used for integration time.
@@ -514,6 +934,10 @@ int Trick::IntegLoopScheduler::process_dynamic_events (double end_time)
     bool fired = false;
     double end_offset = 1e-15 * nominal_cycle;
     double curr_time = end_time;
+    // The step the states can be interpolated over, if dense.
+    double step_beg = end_time - last_substep;
+    double step_end = end_time;
+    bool dense = dense_events && has_dense_state();
     Trick::JobData * curr_job;
     dynamic_event_jobs.reset_curr_index();
     while ((curr_job = dynamic_event_jobs.get_next_job()) != NULL) {
@@ -529,8 +953,19 @@ int Trick::IntegLoopScheduler::process_dynamic_events (double end_time)
             // Dynamic events return 0.0, exactly, to indicate that the
             // event has been found and has been triggered.
             while (tgo != 0.0) {
-                // Integrate to the estimated event time.
-                int status = integrate_dt (curr_time, tgo);
+                int status;
+                double est_time = curr_time + tgo;
+
+                // Interpolate to the estimated event time when it is in the
+                // last step, otherwise integrate to it.
+                if (dense && (est_time >= step_beg) && (est_time <= step_end)) {
+                    status = set_dense_state (est_time, step_beg, step_end - step_beg);
+                } else {
+                    status = integrate_dt (curr_time, tgo);
+                    step_beg = curr_time;
+                    step_end = est_time;
+                    dense = dense_events && has_dense_state();
+                }
                 if (status != 0) {
                     return status;
                 }
@@ -540,6 +975,10 @@ int Trick::IntegLoopScheduler::process_dynamic_events (double end_time)
                 curr_time  += tgo;
                 tgo = curr_job->call_double();
             }
+
+            // The event changed the state or the derivatives, the last step
+            // no longer describes how the state evolves.
+            dense = false;
         }
     }
 
@@ -547,6 +986,9 @@ int Trick::IntegLoopScheduler::process_dynamic_events (double end_time)
     // in an event-dependent manner. Integrate back to the end of
     // the integration cycle using the updated derivatives.
     if (fired) {
+        if (adaptive_step) {
+            return integrate_adaptive (curr_time, end_time-curr_time);
+        }
         return integrate_dt (curr_time, end_time-curr_time);
     }
     else {
@@ -554,6 +996,92 @@ int Trick::IntegLoopScheduler::process_dynamic_events (double end_time)
     }
 }
 
+/**
+ Determine whether the integrators of this loop can interpolate over the step
+ just completed.
+ */
+bool Trick::IntegLoopScheduler::has_dense_state ()
+{
+    Trick::JobData * curr_job;
+    Trick::Integrator * trick_integrator;
+
+    integ_jobs.reset_curr_index();
+    while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+        if (curr_job->sup_class_data == NULL) {
+            trick_integrator = integ_ptr;
+        } else {
+            trick_integrator = *(static_cast<Trick::Integrator**>(curr_job->sup_class_data));
+        }
+        if ((trick_integrator == NULL) || ! trick_integrator->has_dense_state()) {
+            return false;
+        }
+    }
+
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        if (! (*iter)->has_dense_state()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ Interpolate the states of this loop to a time in the step just completed.
+ The integrators are given the time as well, for event jobs that read it.
+ */
+int Trick::IntegLoopScheduler::set_dense_state (
+    double time, double beg_time, double del_time)
+{
+    Trick::JobData * curr_job;
+    Trick::Integrator * trick_integrator;
+    double theta = (del_time > 0.0) ? (time - beg_time) / del_time : 1.0;
+
+    integ_jobs.reset_curr_index();
+    while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+        if (curr_job->sup_class_data == NULL) {
+            trick_integrator = integ_ptr;
+        } else {
+            trick_integrator = *(static_cast<Trick::Integrator**>(curr_job->sup_class_data));
+        }
+        if (trick_integrator->set_dense_state (theta) != 0) {
+            message_publish (
+                MSG_ERROR,
+                "Integ Scheduler ERROR: "
+                "Integrator has no dense output for job %s.\n", curr_job->name.c_str());
+            return 1;
+        }
+    }
+
+    for (std::vector<Trick::IntegBatchGroup*>::iterator iter =
+             batch_groups.begin();
+         iter != batch_groups.end();
+         ++iter) {
+        if ((*iter)->set_dense_state (theta) != 0) {
+            message_publish (
+                MSG_ERROR,
+                "Integ Scheduler ERROR: "
+                "Batch group has no dense output.\n");
+            return 1;
+        }
+    }
+
+    integ_jobs.reset_curr_index();
+    while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+        if (curr_job->sup_class_data == NULL) {
+            trick_integrator = integ_ptr;
+        } else {
+            trick_integrator = *(static_cast<Trick::Integrator**>(curr_job->sup_class_data));
+        }
+        trick_integrator->time = time;
+    }
+
+    return 0;
+}
+
 /**
  Utility function to get an integrator.
  @param alg The integration algorithm to use.
@@ -608,6 +1136,7 @@ int Trick::IntegLoopScheduler::set_integ_cycle (
         long long curr_tics = exec_get_time_tics();
         found_job->set_cycle (in_cycle);
         found_job->set_next_call_time (curr_tics);
+        exec_reschedule_job (found_job);
         nominal_cycle = in_cycle;
         next_cycle = double((found_job->next_tics - prev_tics)) /
                      double(found_job->time_tic_value);
@@ -3,6 +3,7 @@
 #include "trick/message_type.h"
 #include <cstdarg>
 #include <iostream>
+#include <math.h>
 
 /**
  */
@@ -22,6 +23,161 @@ Trick::Integrator::Integrator() {
    time = 0.0;
    time_0 = 0.0;
    verbosity = 0 ;
+   dense_addr = NULL;
+   num_dense_addr = 0;
+   dense_time = 0.0;
+   dense_ws = NULL;
+   rel_tol = 1.0e-8;
+   abs_tol = 1.0e-8;
+   state_rel_tol = NULL;
+   state_abs_tol = NULL;
+   error_ws = NULL;
+}
+
+/**
+ */
+Trick::Integrator::~Integrator() {
+    if (dense_addr) INTEG_FREE(dense_addr);
+    if (dense_ws) INTEG_FREE(dense_ws);
+    if (state_rel_tol) INTEG_FREE(state_rel_tol);
+    if (state_abs_tol) INTEG_FREE(state_abs_tol);
+    if (error_ws) INTEG_FREE(error_ws);
+}
+
+/**
+ Remember the address of one element of the model state unloaded at the end of a step.
+ */
+void Trick::Integrator::record_dense_addr (int index, double* addr) {
+    if (index >= num_state) {
+        return;
+    }
+    if (dense_addr == NULL) {
+        dense_addr = INTEG_ALLOC( double*, num_state);
+    }
+    dense_addr[index] = addr;
+    num_dense_addr = index + 1;
+    dense_time = time;
+}
+
+/**
+ Cubic Hermite interpolation of one element of the state over a step of size h.
+ */
+double Trick::Integrator::hermite (double theta, double h, double y0, double f0, double y1, double f1) {
+    double theta2 = theta * theta;
+    double theta3 = theta2 * theta;
+    return (2.0 * theta3 - 3.0 * theta2 + 1.0) * y0
+         + (theta3 - 2.0 * theta2 + theta) * h * f0
+         + (3.0 * theta2 - 2.0 * theta3) * y1
+         + (theta3 - theta2) * h * f1;
+}
+
+/**
+ */
+int Trick::Integrator::interpolate_state (
+    double theta __attribute__ ((unused)), double* state_out __attribute__ ((unused))) {
+    return 1;
+}
+
+/**
+ */
+bool Trick::Integrator::has_dense_state() {
+    return (has_dense_output() &&
+            (intermediate_step == 0) &&
+            (num_dense_addr == num_state) &&
+            (dense_time == time));
+}
+
+/**
+ */
+int Trick::Integrator::set_dense_state (double theta) {
+
+    // The time is not checked, it is moved to the interpolated state by the caller.
+    if (! has_dense_output() || (intermediate_step != 0) || (num_dense_addr != num_state)) {
+        return 1;
+    }
+    if (dense_ws == NULL) {
+        dense_ws = INTEG_ALLOC( double, num_state);
+    }
+    if (interpolate_state (theta, dense_ws) != 0) {
+        return 1;
+    }
+    for (int ii = 0; ii < num_state; ++ii) {
+        *dense_addr[ii] = dense_ws[ii];
+    }
+    return 0;
+}
+
+/**
+ */
+int Trick::Integrator::estimate_error (
+    double* error_out __attribute__ ((unused)), double* state_out __attribute__ ((unused))) {
+    return 1;
+}
+
+/**
+ The state at the start of the step is the dense output at theta = 0.
+ */
+int Trick::Integrator::restore_start_state() {
+    return set_dense_state (0.0);
+}
+
+/**
+ */
+double Trick::Integrator::get_error_ratio() {
+
+    double ratio = 0.0;
+
+    if (intermediate_step != 0) {
+        return -1.0;
+    }
+    if (error_ws == NULL) {
+        error_ws = INTEG_ALLOC( double, 2 * num_state);
+    }
+    if (estimate_error (error_ws, error_ws + num_state) != 0) {
+        return -1.0;
+    }
+    for (int ii = 0; ii < num_state; ++ii) {
+        double elem_rel_tol = state_rel_tol ? state_rel_tol[ii] : rel_tol;
+        double elem_abs_tol = state_abs_tol ? state_abs_tol[ii] : abs_tol;
+        double tol = elem_abs_tol + elem_rel_tol * fabs(error_ws[num_state + ii]);
+        double elem_ratio = fabs(error_ws[ii]) / tol;
+        // A NaN error never passes.
+        if (! (elem_ratio <= ratio)) {
+            ratio = elem_ratio;
+        }
+    }
+    return ratio;
+}
+
+/**
+ */
+void Trick::Integrator::set_tolerance (double in_rel_tol, double in_abs_tol) {
+    rel_tol = in_rel_tol;
+    abs_tol = in_abs_tol;
+    for (int ii = 0; state_rel_tol && (ii < num_state); ++ii) {
+        state_rel_tol[ii] = in_rel_tol;
+        state_abs_tol[ii] = in_abs_tol;
+    }
+}
+
+/**
+ */
+int Trick::Integrator::set_state_tolerance (int index, double in_rel_tol, double in_abs_tol) {
+    if ((index < 0) || (index >= num_state)) {
+        message_publish(MSG_ERROR, "Integrator ERROR: state tolerance index %d is out of range.\n", index);
+        return 1;
+    }
+    if (state_rel_tol == NULL) {
+        state_rel_tol = INTEG_ALLOC( double, num_state);
+        state_abs_tol = INTEG_ALLOC( double, num_state);
+        for (int ii = 0; ii < num_state; ++ii) {
+            state_rel_tol[ii] = rel_tol;
+            state_abs_tol[ii] = abs_tol;
+        }
+    }
+    state_rel_tol[index] = in_rel_tol;
+    state_abs_tol[index] = in_abs_tol;
+    return 0;
 }
 
 /**
@@ -48,6 +204,12 @@ int Trick::Integrator::integrate_1st_order_ode (
         state_in_out[ii] = state_ws[intermediate_step][ii];
     }
 
+    if (rc == 0) {
+        for (int ii = 0; ii < num_state; ++ii) {
+            record_dense_addr (ii, &state_in_out[ii]);
+        }
+    }
+
     return rc;
 }
 
@@ -82,6 +244,16 @@ int Trick::Integrator::integrate_2nd_order_ode (
         velocity[ii] = state_ws[intermediate_step][ii+half_size];
     }
 
+    // The state of a technique that uses deriv2 holds only the positions.
+    if (use_deriv2) {
+        num_dense_addr = 0;
+    } else if (rc == 0) {
+        for (int ii = 0; ii < half_size; ++ii) {
+            record_dense_addr (ii, &position[ii]);
+            record_dense_addr (ii+half_size, &velocity[ii]);
+        }
+    }
+
     return rc;
 }
 
@@ -152,6 +324,9 @@ void Trick::Integrator::state_out (double* arg1, va_list argp) {
     while (next_arg != (double*) NULL) {
         *next_arg = state_ws[intermediate_step][i];
         if (verbosity) message_publish(MSG_DEBUG,"  %g", *next_arg);
+        if (intermediate_step == 0) {
+            record_dense_addr (i, next_arg);
+        }
         next_arg = va_arg(argp, double*);
         i++;
     }
@@ -171,6 +171,24 @@ Trick::getIntegrator ( Integrator_type alg, unsigned int state_size, double delt
    }
 }
 
+/**
+ * Delete an integrator created by getIntegrator and set the pointer to NULL.
+ * @param[in,out] integ  Integrator to be deleted
+ */
+void
+Trick::deleteIntegrator ( Integrator*& integ) {
+#ifdef USE_ER7_UTILS_INTEGRATORS
+   er7_utils::alloc::delete_object (integ);
+#elif defined(TRICK_VER)
+   if (integ != NULL) {
+      TMM_delete_var_a (dynamic_cast<void*>(integ));
+   }
+#else
+   delete integ;
+#endif
+   integ = NULL;
+}
+
 #if 0
 /**
  * Create an integrator of the specified type.
@@ -0,0 +1,272 @@
+/*
+   PURPOSE: (Benchmark of the adaptive substeps of the IntegLoopScheduler.)
+
+   Integrates the translational dynamics of SIM_cannon_aero (gravity, drag and Magnus lift on a
+   spinning baseball, RUN_test initial state) and of SIM_satellite (point mass Earth, 500 km circular
+   orbit) with fixed steps and with adaptive substeps of Runge_Kutta_Fehlberg_45.  The loop cycle of
+   each sim is used, as well as a longer cycle as a batch run that only logs at that rate would use.
+   The position error is measured against a fixed step reference with a step ten times smaller than the
+   cycle of the sim.
+
+   usage: IntegLoop_adaptive_bench [repeat]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "trick/MemoryManager.hh"
+#include "trick/IntegLoopScheduler.hh"
+#include "trick/SimObject.hh"
+#include "trick/Integrator.hh"
+
+/* The integrators are allocated by the memory manager. */
+static Trick::MemoryManager * memmgr ;
+
+static double wall_time() {
+    struct timeval tv ;
+    gettimeofday(&tv, NULL) ;
+    return tv.tv_sec + tv.tv_usec * 1.0e-6 ;
+}
+
+/* A sim object with the derivative and integration jobs of a translational state. */
+class BenchObject : public Trick::SimObject {
+    public:
+        double pos[3] ;
+        double vel[3] ;
+        double acc[3] ;
+        Trick::Integrator * integ ;
+        long num_derivs ;
+
+        BenchObject() : integ(NULL), num_derivs(0) {
+            add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+            add_job(0, 1, "integration", &integ, 1, "integration", "TRK") ;
+            for ( unsigned int ii = 0 ; ii < jobs.size() ; ii++ ) {
+                jobs[ii]->parent_object = this ;
+            }
+        }
+        virtual ~BenchObject() {}
+
+        virtual void init() = 0 ;
+        virtual void deriv() = 0 ;
+
+        virtual int call_function( Trick::JobData * curr_job ) {
+            int ipass ;
+            if ( curr_job->id == 0 ) {
+                deriv() ;
+                num_derivs++ ;
+                return 0 ;
+            }
+            integ->state_in(&pos[0], &pos[1], &pos[2], &vel[0], &vel[1], &vel[2], NULL) ;
+            integ->deriv_in(&vel[0], &vel[1], &vel[2], &acc[0], &acc[1], &acc[2], NULL) ;
+            ipass = integ->integrate() ;
+            integ->state_out(&pos[0], &pos[1], &pos[2], &vel[0], &vel[1], &vel[2], NULL) ;
+            return ipass ;
+        }
+        virtual double call_function_double( Trick::JobData * curr_job __attribute__ ((unused)) ) {
+            return 0.0 ;
+        }
+} ;
+
+/* models/cannon/aero with cannon_aero_default_data and RUN_test. */
+class CannonBall : public BenchObject {
+    public:
+        double omega[3] ;
+
+        void init() {
+            const double theta = -90.0 * M_PI / 180.0 ;
+            const double phi = 1.0 * M_PI / 180.0 ;
+            const double omega0 = 30.0 * 2.0 * M_PI ;
+            pos[0] = 16.0 ; pos[1] = 0.1 ; pos[2] = 2.0 ;
+            vel[0] = -30.0 ; vel[1] = -0.1 ; vel[2] = 1.0 ;
+            omega[0] = omega0 * sin(M_PI / 2.0 - phi) * cos(theta) ;
+            omega[1] = omega0 * sin(M_PI / 2.0 - phi) * sin(theta) ;
+            omega[2] = omega0 * cos(M_PI / 2.0 - phi) ;
+        }
+
+        void deriv() {
+            const double mass = 0.145 , rho = 1.29 , radius = 0.0363 , area = 41.59e-4 ;
+            const double cd = 0.45 , c_cross = 0.044 ;
+            double speed = sqrt(vel[0] * vel[0] + vel[1] * vel[1] + vel[2] * vel[2]) ;
+            double w_mag = sqrt(omega[0] * omega[0] + omega[1] * omega[1] + omega[2] * omega[2]) ;
+            double cl = 0.54 * pow(radius * w_mag / speed, 0.4) ;
+            double drag[3] , magnus[3] , cross[3] , w_x_v[3] , m_x_d[3] ;
+            double k , norm ;
+            int ii ;
+
+            k = -0.5 * rho * cd * area * speed ;
+            for ( ii = 0 ; ii < 3 ; ii++ ) {
+                drag[ii] = k * vel[ii] ;
+            }
+
+            w_x_v[0] = omega[1] * vel[2] - omega[2] * vel[1] ;
+            w_x_v[1] = omega[2] * vel[0] - omega[0] * vel[2] ;
+            w_x_v[2] = omega[0] * vel[1] - omega[1] * vel[0] ;
+            norm = sqrt(w_x_v[0] * w_x_v[0] + w_x_v[1] * w_x_v[1] + w_x_v[2] * w_x_v[2]) ;
+            k = 0.5 * rho * cl * area * speed * speed / norm ;
+            for ( ii = 0 ; ii < 3 ; ii++ ) {
+                magnus[ii] = k * w_x_v[ii] ;
+            }
+
+            m_x_d[0] = magnus[1] * drag[2] - magnus[2] * drag[1] ;
+            m_x_d[1] = magnus[2] * drag[0] - magnus[0] * drag[2] ;
+            m_x_d[2] = magnus[0] * drag[1] - magnus[1] * drag[0] ;
+            norm = sqrt(m_x_d[0] * m_x_d[0] + m_x_d[1] * m_x_d[1] + m_x_d[2] * m_x_d[2]) ;
+            k = -0.5 * rho * c_cross * area * speed * speed / norm ;
+            for ( ii = 0 ; ii < 3 ; ii++ ) {
+                cross[ii] = k * m_x_d[ii] ;
+            }
+
+            for ( ii = 0 ; ii < 3 ; ii++ ) {
+                acc[ii] = (drag[ii] + magnus[ii] + cross[ii]) / mass ;
+            }
+            acc[2] += -9.81 ;
+        }
+} ;
+
+/* models/Satellite translational state about a point mass Earth. */
+class Satellite : public BenchObject {
+    public:
+        void init() {
+            const double mu = 6.674e-11 * 5.9721986e24 ;
+            pos[0] = 6367500.0 + 500000.0 ; pos[1] = 0.0 ; pos[2] = 0.0 ;
+            vel[0] = 0.0 ; vel[1] = sqrt(mu / pos[0]) ; vel[2] = 0.0 ;
+        }
+
+        void deriv() {
+            const double mu = 6.674e-11 * 5.9721986e24 ;
+            double r = sqrt(pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2]) ;
+            double k = -mu / (r * r * r) ;
+            for ( int ii = 0 ; ii < 3 ; ii++ ) {
+                acc[ii] = k * pos[ii] ;
+            }
+        }
+} ;
+
+/* Gives access to the integration of one loop cycle without an Executive. */
+class BenchLoop : public Trick::IntegLoopScheduler {
+    public:
+        BenchLoop( double in_cycle , Trick::SimObject * parent_so ) : Trick::IntegLoopScheduler(in_cycle, parent_so) {}
+        int cycle( double beg_time , double del_time ) {
+            if ( adaptive_step ) {
+                return integrate_adaptive(beg_time, del_time) ;
+            }
+            return integrate_dt(beg_time, del_time) ;
+        }
+} ;
+
+struct RunResult {
+    double pos[3] ;
+    long num_derivs ;
+    long long num_substeps ;
+    long long num_rejected ;
+    double seconds ;
+} ;
+
+/* Integrate from 0 to stop_time in loop cycles of the given size.  A tolerance of zero takes one fixed step
+   of step_size per cycle, or as many as fit, otherwise the steps are adaptive. */
+static RunResult run( BenchObject & obj , Integrator_type alg , double stop_time , double cycle , double step_size ,
+                      double tol , int repeat ) {
+
+    RunResult result ;
+    double start = wall_time() ;
+
+    for ( int rr = 0 ; rr < repeat ; rr++ ) {
+        obj.init() ;
+        obj.num_derivs = 0 ;
+        obj.integ = Trick::getIntegrator(alg, 6, cycle) ;
+        obj.integ->set_tolerance(tol, tol) ;
+
+        BenchLoop loop(cycle, &obj) ;
+        loop.add_integ_jobs_from_sim_object(&obj) ;
+        loop.set_adaptive_step(tol > 0.0) ;
+
+        long num_cycles = (long)(stop_time / cycle + 0.5) ;
+        int steps_per_cycle = (int)ceil(cycle / step_size - 1.0e-9) ;
+        for ( long cc = 0 ; cc < num_cycles ; cc++ ) {
+            double beg_time = cc * cycle ;
+            if ( tol > 0.0 ) {
+                loop.cycle(beg_time, cycle) ;
+            } else {
+                for ( int ss = 0 ; ss < steps_per_cycle ; ss++ ) {
+                    loop.cycle(beg_time + ss * cycle / steps_per_cycle, cycle / steps_per_cycle) ;
+                }
+            }
+        }
+
+        result.num_substeps = (tol > 0.0) ? loop.num_substeps : num_cycles * steps_per_cycle ;
+        result.num_rejected = loop.num_rejected_substeps ;
+        memmgr->delete_var(obj.integ) ;
+    }
+
+    result.seconds = (wall_time() - start) / repeat ;
+    result.num_derivs = obj.num_derivs ;
+    for ( int ii = 0 ; ii < 3 ; ii++ ) {
+        result.pos[ii] = obj.pos[ii] ;
+    }
+    return result ;
+}
+
+static void print( const char * name , double cycle , const RunResult & result , const RunResult & reference ) {
+    double err = sqrt(pow(result.pos[0] - reference.pos[0], 2) + pow(result.pos[1] - reference.pos[1], 2) +
+                      pow(result.pos[2] - reference.pos[2], 2)) ;
+    std::cout << std::setw(26) << name << std::setw(10) << std::fixed << std::setprecision(4) << cycle
+              << std::setw(12) << std::scientific << std::setprecision(2) << err << std::fixed
+              << std::setw(10) << result.num_substeps << std::setw(8) << result.num_rejected
+              << std::setw(10) << result.num_derivs
+              << std::setw(12) << std::setprecision(6) << result.seconds << std::endl ;
+}
+
+static void bench( const char * sim , BenchObject & obj , double stop_time , double sim_cycle , double batch_cycle ,
+                   int repeat ) {
+
+    static const double fixed_divisors[] = { 10.0, 5.0, 2.0, 1.0 } ;
+    static const double tolerances[] = { 1.0e-6, 1.0e-8, 1.0e-10 } ;
+    const double cycles[] = { sim_cycle, batch_cycle } ;
+    char name[64] ;
+    unsigned int ii , jj ;
+
+    RunResult reference = run(obj, Runge_Kutta_Fehlberg_45, stop_time, sim_cycle, sim_cycle / 10.0, 0.0, 1) ;
+
+    std::cout.unsetf(std::ios_base::floatfield) ;
+    std::cout << sim << ", " << stop_time << " s" << std::endl ;
+    std::cout << std::setw(26) << "integration" << std::setw(10) << "cycle" << std::setw(12) << "pos error"
+              << std::setw(10) << "steps" << std::setw(8) << "reject" << std::setw(10) << "derivs"
+              << std::setw(12) << "wall (s)" << std::endl ;
+
+    snprintf(name, sizeof(name), "RK4 fixed %g", sim_cycle) ;
+    print(name, sim_cycle, run(obj, Runge_Kutta_4, stop_time, sim_cycle, sim_cycle, 0.0, repeat), reference) ;
+    snprintf(name, sizeof(name), "RKF45 fixed %g", sim_cycle) ;
+    print(name, sim_cycle, run(obj, Runge_Kutta_Fehlberg_45, stop_time, sim_cycle, sim_cycle, 0.0, repeat), reference) ;
+    for ( ii = 0 ; ii < sizeof(fixed_divisors) / sizeof(fixed_divisors[0]) ; ii++ ) {
+        double step = batch_cycle / fixed_divisors[ii] ;
+        snprintf(name, sizeof(name), "RKF45 fixed %g", step) ;
+        print(name, batch_cycle, run(obj, Runge_Kutta_Fehlberg_45, stop_time, batch_cycle, step, 0.0, repeat),
+              reference) ;
+    }
+    for ( ii = 0 ; ii < sizeof(cycles) / sizeof(cycles[0]) ; ii++ ) {
+        for ( jj = 0 ; jj < sizeof(tolerances) / sizeof(tolerances[0]) ; jj++ ) {
+            snprintf(name, sizeof(name), "RKF45 adaptive %g", tolerances[jj]) ;
+            print(name, cycles[ii], run(obj, Runge_Kutta_Fehlberg_45, stop_time, cycles[ii], cycles[ii], tolerances[jj],
+                                        repeat), reference) ;
+        }
+    }
+    std::cout << std::endl ;
+}
+
+int main( int argc , char * argv[] ) {
+
+    int repeat = (argc > 1) ? atoi(argv[1]) : 20 ;
+    memmgr = new Trick::MemoryManager ;
+    CannonBall cannon ;
+    Satellite satellite ;
+
+    /* The ball lands after about 0.7 s, the impact event is not part of the benchmark. */
+    bench("SIM_cannon_aero", cannon, 0.7, 0.01, 0.1, repeat * 50) ;
+    bench("SIM_satellite", satellite, 5400.0, 0.1, 60.0, repeat) ;
+
+    delete memmgr ;
+    return 0 ;
+}
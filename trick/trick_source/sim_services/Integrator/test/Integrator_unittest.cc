@@ -11,9 +11,13 @@
 #include "trick/exec_proto.h"
 #include "trick/exec_proto.hh"
 #include "trick/SimObject.hh"
+#include "er7_utils/integration/rk4/include/rk4_steps.hh"
+#include "er7_utils/integration/rkf45/include/rkf45_steps.hh"
 //#include "trick/RequirementScribe.hh"
 #include <math.h>
+#include <string.h>
 #include <iostream>
+#include <vector>
 
 #define PI 3.141592653589793
 #define RAD_PER_DEG (2.0*PI/180.0)
@@ -483,6 +487,327 @@ TEST_F(IntegratorTest, Ball_Runge_Kutta_Fehlberg_78) {
     memmgr->delete_var( integrator);
 }
 
+TEST_F(IntegratorLoopTest, Ball_Batch_Runge_Kutta_4) {
+
+    const int num_balls = 5;
+    BALL single[num_balls];
+    BALL batch[num_balls];
+    Trick::Integrator *integrators[num_balls];
+
+    for (int ii = 0; ii < num_balls; ii++) {
+        init(&single[ii]);
+        single[ii].vel[0] += ii;
+        deriv(&single[ii]);
+        batch[ii] = single[ii];
+        integrators[ii] = Trick::getIntegrator( Runge_Kutta_4, 4, 0.01);
+        EXPECT_EQ(IntegLoop->add_batch_state( Runge_Kutta_4, 2,
+                  batch[ii].pos, batch[ii].vel, batch[ii].acc), 0);
+    }
+    EXPECT_EQ(IntegLoop->batch_groups.size(), 1u);
+
+    for (int tick = 0; tick < 100; tick++) {
+        double sim_time = tick * 0.01;
+        for (int ii = 0; ii < num_balls; ii++) {
+            integrators[ii]->time = sim_time;
+            integrators[ii]->dt = 0.01;
+            while (integrators[ii]->integrate_2nd_order_ode(
+                       single[ii].acc, single[ii].vel, single[ii].pos)) {}
+        }
+        EXPECT_EQ(IntegLoop->integrate_dt( sim_time, 0.01), 0);
+    }
+
+    // The batched states match the states integrated one at a time bit for bit.
+    for (int ii = 0; ii < num_balls; ii++) {
+        EXPECT_EQ(batch[ii].pos[0], single[ii].pos[0]);
+        EXPECT_EQ(batch[ii].pos[1], single[ii].pos[1]);
+        EXPECT_EQ(batch[ii].vel[0], single[ii].vel[0]);
+        EXPECT_EQ(batch[ii].vel[1], single[ii].vel[1]);
+        memmgr->delete_var( integrators[ii]);
+    }
+
+    EXPECT_EQ(IntegLoop->remove_batch_state( batch[0].pos), 0);
+    EXPECT_EQ(IntegLoop->remove_batch_state( batch[0].pos), 1);
+    for (int ii = 1; ii < num_balls; ii++) {
+        EXPECT_EQ(IntegLoop->remove_batch_state( batch[ii].pos), 0);
+    }
+    EXPECT_EQ(IntegLoop->batch_groups.size(), 0u);
+}
+
+// A ball thrown straight up.  Its crossing of a height is a dynamic event.
+class eventSimObject : public Trick::SimObject {
+    public:
+
+    Trick::Integrator * integ;
+    double pos;
+    double vel;
+    double acc;
+    double height;
+    double event_time;
+    int integ_passes;
+
+    eventSimObject() : integ(NULL), pos(0.0), vel(10.0), acc(0.0), height(0.05), event_time(-1.0), integ_passes(0) {
+        add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+        add_job(0, 1, "integration", NULL, 1, "integration", "TRK") ;
+        add_job(0, 2, "dynamic_event", NULL, 1, "dynamic_event", "TRK") ;
+        for ( unsigned int ii = 0 ; ii < jobs.size() ; ii++ ) {
+            jobs[ii]->parent_object = this ;
+        }
+    }
+
+    virtual int call_function(Trick::JobData* curr_job) {
+        switch (curr_job->id) {
+            case 0:
+                acc = -9.81;
+                return 0;
+            case 1:
+                integ_passes++;
+                integ->state_in( &pos, &vel, NULL);
+                integ->deriv_in( &vel, &acc, NULL);
+                integ->integrate();
+                integ->state_out( &pos, &vel, NULL);
+                return integ->intermediate_step;
+            default:
+                return -1;
+        }
+    }
+
+    // Newton's estimate of the time to go to the height, 0.0 once the ball is there.
+    virtual double call_function_double(Trick::JobData* curr_job) {
+        if (curr_job->id != 2) {
+            return -1.0;
+        }
+        double error = pos - height;
+        if (fabs(error) < 1.0e-12) {
+            event_time = integ->time;
+            return 0.0;
+        }
+        return -error / vel;
+    }
+};
+
+// Integrates the ball over one cycle and processes its event.  Returns the integration passes of the event search.
+// The caller deletes the integrator.
+static int ball_event_passes( eventSimObject & ball, bool dense_events) {
+    const double cycle = 0.01;
+    Trick::IntegLoopScheduler loop(cycle, &ball);
+    ball.integ = loop.getIntegrator( Runge_Kutta_4, 2);
+    loop.add_integ_jobs_from_sim_object(&ball);
+    loop.set_dense_events(dense_events);
+
+    EXPECT_EQ(loop.integrate_dt( 0.0, cycle), 0);
+    int passes = ball.integ_passes;
+    EXPECT_EQ(loop.process_dynamic_events( cycle), 0);
+    return ball.integ_passes - passes;
+}
+
+TEST_F(IntegratorLoopTest, Dense_Dynamic_Event) {
+
+    // The ball reaches the height once in the first cycle.
+    const double g = 9.81;
+    eventSimObject integrated;
+    eventSimObject dense;
+    double event_time = (integrated.vel - sqrt(integrated.vel * integrated.vel - 2.0 * g * integrated.height)) / g;
+
+    // Searching by integration integrates to every estimate and back to the end of the cycle.
+    int integrated_passes = ball_event_passes(integrated, false);
+    EXPECT_NEAR(integrated.event_time, event_time, 1.0e-12);
+    EXPECT_GT(integrated_passes, 8);
+
+    // Searching on the dense output only integrates back to the end of the cycle, four RK4 passes.
+    int dense_passes = ball_event_passes(dense, true);
+    EXPECT_NEAR(dense.event_time, event_time, 1.0e-12);
+    EXPECT_NEAR(dense.event_time, integrated.event_time, 1.0e-12);
+    EXPECT_EQ(dense_passes, 4);
+
+    // Both end the cycle in the same state.
+    EXPECT_NEAR(dense.pos, 10.0 * 0.01 - 0.5 * g * 0.01 * 0.01, 1.0e-12);
+    EXPECT_NEAR(dense.pos, integrated.pos, 1.0e-12);
+    EXPECT_NEAR(dense.vel, integrated.vel, 1.0e-12);
+
+    memmgr->delete_var( integrated.integ);
+    memmgr->delete_var( dense.integ);
+}
+
+// An oscillator stiff enough for a whole loop cycle to fail the error tolerance.
+class oscillatorSimObject : public Trick::SimObject {
+    public:
+
+    // The time, size and state of an integration substep when it starts.
+    struct Substep {
+        double time;
+        double dt;
+        double pos;
+        double vel;
+    };
+
+    Trick::Integrator * integ;
+    double omega;
+    double pos;
+    double vel;
+    double acc;
+    std::vector<Substep> substeps;
+
+    oscillatorSimObject() : integ(NULL), omega(20.0), pos(1.0), vel(0.0), acc(0.0) {
+        add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+        add_job(0, 1, "integration", NULL, 1, "integration", "TRK") ;
+        for ( unsigned int ii = 0 ; ii < jobs.size() ; ii++ ) {
+            jobs[ii]->parent_object = this ;
+        }
+    }
+
+    virtual int call_function(Trick::JobData* curr_job) {
+        switch (curr_job->id) {
+            case 0:
+                acc = -omega * omega * pos;
+                return 0;
+            case 1:
+                if (integ->intermediate_step == 0) {
+                    Substep start = { integ->time, integ->dt, pos, vel };
+                    substeps.push_back(start);
+                }
+                integ->state_in( &pos, &vel, NULL);
+                integ->deriv_in( &vel, &acc, NULL);
+                integ->integrate();
+                integ->state_out( &pos, &vel, NULL);
+                return integ->intermediate_step;
+            default:
+                return -1;
+        }
+    }
+
+    virtual double call_function_double(Trick::JobData* curr_job) {
+        return 0.0;
+    }
+};
+
+TEST_F(IntegratorLoopTest, Adaptive_Substeps) {
+
+    const double cycle = 0.1;
+    const int num_cycles = 3;
+    oscillatorSimObject osc;
+    Trick::IntegLoopScheduler loop(cycle, &osc);
+    osc.integ = loop.getIntegrator( Runge_Kutta_Fehlberg_45, 2);
+    osc.integ->set_tolerance( 1.0e-8, 1.0e-8);
+    loop.add_integ_jobs_from_sim_object(&osc);
+    loop.set_adaptive_step(true);
+
+    // The last substep of every cycle ends on the end of the cycle.
+    for (int ii = 0; ii < num_cycles; ii++) {
+        double end_time = (ii + 1) * cycle;
+        EXPECT_EQ(loop.integrate_adaptive( ii * cycle, cycle), 0);
+        const oscillatorSimObject::Substep & last = osc.substeps.back();
+        EXPECT_DOUBLE_EQ(last.time + last.dt, end_time);
+        EXPECT_NEAR(osc.pos, cos(osc.omega * end_time), 1.0e-6);
+    }
+    EXPECT_TRUE(loop.adaptive_step);
+
+    // A substep that starts where the one before it started was taken again after a rejection, from the same state.
+    long long accepted = 0;
+    long long rejected = 0;
+    double min_taken = 0.0;
+    double max_taken = 0.0;
+    for (size_t ii = 0; ii < osc.substeps.size(); ii++) {
+        const oscillatorSimObject::Substep & curr = osc.substeps[ii];
+        bool is_rejected = (ii + 1 < osc.substeps.size()) && (osc.substeps[ii + 1].time == curr.time);
+        if (is_rejected) {
+            const oscillatorSimObject::Substep & again = osc.substeps[ii + 1];
+            EXPECT_LT(again.dt, curr.dt);
+            EXPECT_EQ(again.pos, curr.pos);
+            EXPECT_EQ(again.vel, curr.vel);
+            rejected++;
+        } else {
+            if (ii + 1 < osc.substeps.size()) {
+                EXPECT_DOUBLE_EQ(osc.substeps[ii + 1].time, curr.time + curr.dt);
+            }
+            if ((accepted == 0) || (curr.dt < min_taken)) {
+                min_taken = curr.dt;
+            }
+            if ((accepted == 0) || (curr.dt > max_taken)) {
+                max_taken = curr.dt;
+            }
+            accepted++;
+        }
+    }
+
+    // The whole first cycle is too large a step.
+    EXPECT_EQ(osc.substeps[0].dt, cycle);
+    EXPECT_GT(rejected, 0);
+    EXPECT_GT(accepted, num_cycles);
+    EXPECT_EQ(loop.num_rejected_substeps, rejected);
+    EXPECT_EQ(loop.num_substeps, accepted);
+    EXPECT_EQ(loop.min_substep_taken, min_taken);
+    EXPECT_EQ(loop.max_substep_taken, max_taken);
+    EXPECT_LT(loop.min_substep_taken, loop.max_substep_taken);
+
+    memmgr->delete_var( osc.integ);
+}
+
+TEST_F(IntegratorLoopTest, Adaptive_Substeps_Without_Error_Estimate) {
+
+    // RK4 has no error estimate.  The loop warns, turns adaptive substeps off and integrates the cycle in one step.
+    const double cycle = 0.1;
+    oscillatorSimObject osc;
+    Trick::IntegLoopScheduler loop(cycle, &osc);
+    osc.integ = loop.getIntegrator( Runge_Kutta_4, 2);
+    loop.add_integ_jobs_from_sim_object(&osc);
+    loop.set_adaptive_step(true);
+
+    testing::internal::CaptureStdout();
+    EXPECT_EQ(loop.integrate_adaptive( 0.0, cycle), 0);
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("adaptive substeps are turned off"), std::string::npos);
+
+    EXPECT_FALSE(loop.adaptive_step);
+    ASSERT_EQ(osc.substeps.size(), 1u);
+    EXPECT_EQ(osc.substeps[0].time, 0.0);
+    EXPECT_EQ(osc.substeps[0].dt, cycle);
+    EXPECT_EQ(loop.num_substeps, 0);
+    EXPECT_EQ(loop.num_rejected_substeps, 0);
+
+    memmgr->delete_var( osc.integ);
+}
+
+TEST_F(IntegratorTest, Ball_ABM_Dense_Output) {
+
+    // ABM interpolates the priming cycles with its primer and its own cycles with a cubic Hermite.
+    // Both are exact for the polynomial trajectory of the ball.
+    const double dt = 0.1 ;
+    Trick::Integrator *integrator = Trick::getIntegrator( ABM_Method, 4, dt);
+    ASSERT_TRUE( (void*)integrator != NULL);
+    EXPECT_TRUE( integrator->has_dense_output());
+
+    BALL ball ;
+    init(&ball);
+    BALL start = ball ;
+
+    for ( int cycle = 0 ; cycle < 6 ; cycle++ ) {
+        integrator->time = cycle * dt;
+        do {
+            deriv( &ball);
+            integrator->state_in( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+            integrator->deriv_in( &ball.vel[0], &ball.vel[1], &ball.acc[0], &ball.acc[1], NULL);
+            integrator->integrate();
+            integrator->state_out( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+        } while ( integrator->intermediate_step);
+
+        EXPECT_TRUE( integrator->has_dense_state());
+
+        // Cycles 0 to 2 prime, 4 and 5 are ABM.
+        if ( cycle == 0 || cycle == 5 ) {
+            const double theta[] = { 0.0, 0.25, 0.5, 1.0 } ;
+            for ( unsigned int jj = 0 ; jj < sizeof(theta)/sizeof(theta[0]) ; jj++ ) {
+                double t = (cycle + theta[jj]) * dt ;
+                EXPECT_EQ( integrator->set_dense_state(theta[jj]), 0);
+                verify_ball_sim_results(&ball, 0.000000001,
+                 start.pos[0] + start.vel[0] * t - 0.5 * 9.81 * t * t, start.pos[1] + start.vel[1] * t,
+                 start.vel[0] - 9.81 * t, start.vel[1]) ;
+            }
+        }
+    }
+
+    memmgr->delete_var( integrator);
+}
+
 #if 0
 TEST_F(IntegratorTest, Ball_ABM) {
 
@@ -512,6 +837,104 @@ TEST_F(IntegratorTest, Ball_ABM) {
 }
 #endif
 
+TEST_F(IntegratorTest, Ball_Dense_Output) {
+
+    // The ball trajectory is a polynomial of degree 2, which the dense output interpolates exactly.
+    Integrator_type types[] = { Runge_Kutta_4, Runge_Kutta_Fehlberg_45, Runge_Kutta_Fehlberg_78 } ;
+    const double dt = 0.1 ;
+
+    for ( unsigned int ii = 0 ; ii < sizeof(types)/sizeof(types[0]) ; ii++ ) {
+        Trick::Integrator *integrator = Trick::getIntegrator( types[ii], 4, dt);
+        ASSERT_TRUE( (void*)integrator != NULL);
+        EXPECT_TRUE( integrator->has_dense_output());
+
+        BALL ball ;
+        init(&ball);
+        BALL start = ball ;
+        EXPECT_FALSE( integrator->has_dense_state());
+
+        integrator->time = 0.0;
+        do {
+            deriv( &ball);
+            integrator->state_in( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+            integrator->deriv_in( &ball.vel[0], &ball.vel[1], &ball.acc[0], &ball.acc[1], NULL);
+            integrator->integrate();
+            integrator->state_out( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+        } while ( integrator->intermediate_step);
+
+        EXPECT_TRUE( integrator->has_dense_state());
+
+        const double theta[] = { 0.0, 0.25, 0.5, 1.0 } ;
+        for ( unsigned int jj = 0 ; jj < sizeof(theta)/sizeof(theta[0]) ; jj++ ) {
+            double t = theta[jj] * dt ;
+            EXPECT_EQ( integrator->set_dense_state(theta[jj]), 0);
+            verify_ball_sim_results(&ball, 0.000000001,
+             start.pos[0] + start.vel[0] * t - 0.5 * 9.81 * t * t, start.pos[1] + start.vel[1] * t,
+             start.vel[0] - 9.81 * t, start.vel[1]) ;
+        }
+
+        memmgr->delete_var( integrator);
+    }
+}
+
+TEST_F(IntegratorTest, Euler_No_Dense_Output) {
+
+    Trick::Integrator *integrator = Trick::getIntegrator( Euler, 4, 0.01);
+    ASSERT_TRUE( (void*)integrator != NULL);
+    EXPECT_FALSE( integrator->has_dense_output());
+
+    Ball_sim( integrator);
+    EXPECT_FALSE( integrator->has_dense_state());
+    EXPECT_NE( integrator->set_dense_state(0.5), 0);
+
+    memmgr->delete_var( integrator);
+}
+
+TEST_F(IntegratorTest, Ball_Error_Estimate) {
+
+    // Both solutions of the embedded pair are exact for the ball, the error is round off.
+    Trick::Integrator *integrator = Trick::getIntegrator( Runge_Kutta_Fehlberg_45, 4, 0.1);
+    ASSERT_TRUE( (void*)integrator != NULL);
+
+    BALL ball ;
+    init(&ball);
+    BALL start = ball ;
+
+    integrator->time = 0.0;
+    do {
+        deriv( &ball);
+        integrator->state_in( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+        integrator->deriv_in( &ball.vel[0], &ball.vel[1], &ball.acc[0], &ball.acc[1], NULL);
+        integrator->integrate();
+        integrator->state_out( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+    } while ( integrator->intermediate_step);
+
+    EXPECT_EQ( integrator->get_error_order(), 4);
+    integrator->set_tolerance(1.0e-10, 1.0e-10);
+    double ratio = integrator->get_error_ratio();
+    EXPECT_GE( ratio, 0.0);
+    EXPECT_LT( ratio, 1.0);
+
+    // A looser tolerance on one element cannot raise the ratio.
+    EXPECT_NE( integrator->set_state_tolerance(4, 0.0, 0.0), 0);
+    EXPECT_EQ( integrator->set_state_tolerance(0, 1.0, 1.0), 0);
+    EXPECT_LE( integrator->get_error_ratio(), ratio);
+
+    EXPECT_EQ( integrator->restore_start_state(), 0);
+    verify_ball_sim_results(&ball, 0.000000001, start.pos[0], start.pos[1], start.vel[0], start.vel[1]) ;
+
+    memmgr->delete_var( integrator);
+
+    // Techniques without an embedded error estimate.
+    integrator = Trick::getIntegrator( Runge_Kutta_4, 4, 0.1);
+    ASSERT_TRUE( (void*)integrator != NULL);
+    Ball_sim( integrator);
+    EXPECT_EQ( integrator->get_error_order(), 0);
+    EXPECT_LT( integrator->get_error_ratio(), 0.0);
+
+    memmgr->delete_var( integrator);
+}
+
 namespace Trick {
     class Donna_Integrator : public Integrator {
         public:
@@ -544,3 +967,140 @@ TEST_F(IntegratorTest, Ball_UserDefined) {
 
     EXPECT_EQ(integrator->get_Integrator_type(), 10);
 }
+
+// Integrates x' = -x + c with the RK4 step for fixed_size, or for the run time size if fixed_size is 0.
+template <unsigned int fixed_size>
+static std::vector<double> rk4_first_order_cycles( unsigned int size ) {
+    std::vector<double> pos(size), deriv(size), init(size), hist(4 * size);
+    double * deriv_hist[4] = { &hist[0], &hist[size], &hist[2 * size], &hist[3 * size] };
+    for (unsigned int ii = 0; ii < size; ii++) {
+        pos[ii] = 1.0 + 0.1 * ii;
+    }
+    for (int cycle = 0; cycle < 100; cycle++) {
+        for (unsigned int stage = 1; stage <= 4; stage++) {
+            for (unsigned int ii = 0; ii < size; ii++) {
+                deriv[ii] = -pos[ii] + 0.3 * ii;
+            }
+            er7_utils::rk4_steps::rk4_step<fixed_size>( 0.01, stage, size,
+             &deriv[0], &init[0], deriv_hist, &pos[0]);
+        }
+    }
+    return pos;
+}
+
+// Integrates x'' = -x - 0.1 x' with the RK4 step for fixed_size, or for the run time size if fixed_size is 0.
+template <unsigned int fixed_size>
+static std::vector<double> rk4_second_order_cycles( unsigned int size ) {
+    std::vector<double> state(2 * size), accel(size), init(2 * size), hist(8 * size);
+    double * pos = &state[0];
+    double * vel = &state[size];
+    double * posdot_hist[4] = { &hist[0], &hist[size], &hist[2 * size], &hist[3 * size] };
+    double * veldot_hist[4] = { &hist[4 * size], &hist[5 * size], &hist[6 * size], &hist[7 * size] };
+    for (unsigned int ii = 0; ii < size; ii++) {
+        pos[ii] = 1.0 + 0.1 * ii;
+        vel[ii] = -0.5 * ii;
+    }
+    for (int cycle = 0; cycle < 100; cycle++) {
+        for (unsigned int stage = 1; stage <= 4; stage++) {
+            for (unsigned int ii = 0; ii < size; ii++) {
+                accel[ii] = -pos[ii] - 0.1 * vel[ii];
+            }
+            er7_utils::rk4_steps::rk4_simple_step<fixed_size>( 0.01, stage, size,
+             &accel[0], &init[0], &init[size], posdot_hist, veldot_hist, vel, pos);
+        }
+    }
+    return state;
+}
+
+template <unsigned int fixed_size>
+static void expect_rk4_fixed_size_matches_generic() {
+    std::vector<double> fixed = rk4_first_order_cycles<fixed_size>(fixed_size);
+    std::vector<double> generic = rk4_first_order_cycles<0>(fixed_size);
+    EXPECT_EQ(memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)), 0) << "first order size " << fixed_size;
+
+    fixed = rk4_second_order_cycles<fixed_size>(fixed_size);
+    generic = rk4_second_order_cycles<0>(fixed_size);
+    EXPECT_EQ(memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)), 0) << "second order size " << fixed_size;
+}
+
+TEST(RK4StepsTest, FixedSizeMatchesGeneric) {
+
+    // The fixed size steps give the same bits as the run time size step.
+    expect_rk4_fixed_size_matches_generic<3>();
+    expect_rk4_fixed_size_matches_generic<4>();
+    expect_rk4_fixed_size_matches_generic<6>();
+    expect_rk4_fixed_size_matches_generic<7>();
+    expect_rk4_fixed_size_matches_generic<13>();
+}
+
+// Integrates x' = -x + c with the RKF45 step for fixed_size, or for the run time size if fixed_size is 0.
+template <unsigned int fixed_size>
+static std::vector<double> rkf45_first_order_cycles( unsigned int size ) {
+    std::vector<double> pos(size), deriv(size), init(size), hist(6 * size);
+    double * deriv_hist[6];
+    for (int jj = 0; jj < 6; jj++) {
+        deriv_hist[jj] = &hist[jj * size];
+    }
+    for (unsigned int ii = 0; ii < size; ii++) {
+        pos[ii] = 1.0 + 0.1 * ii;
+    }
+    for (int cycle = 0; cycle < 100; cycle++) {
+        for (unsigned int stage = 1; stage <= 6; stage++) {
+            for (unsigned int ii = 0; ii < size; ii++) {
+                deriv[ii] = -pos[ii] + 0.3 * ii;
+            }
+            er7_utils::rkf45_steps::rkf45_step<fixed_size>( 0.01, stage, size,
+             &deriv[0], &init[0], deriv_hist, &pos[0]);
+        }
+    }
+    return pos;
+}
+
+// Integrates x'' = -x - 0.1 x' with the RKF45 step for fixed_size, or for the run time size if fixed_size is 0.
+template <unsigned int fixed_size>
+static std::vector<double> rkf45_second_order_cycles( unsigned int size ) {
+    std::vector<double> state(2 * size), accel(size), init(2 * size), hist(12 * size);
+    double * pos = &state[0];
+    double * vel = &state[size];
+    double * posdot_hist[6];
+    double * veldot_hist[6];
+    for (int jj = 0; jj < 6; jj++) {
+        posdot_hist[jj] = &hist[jj * size];
+        veldot_hist[jj] = &hist[(6 + jj) * size];
+    }
+    for (unsigned int ii = 0; ii < size; ii++) {
+        pos[ii] = 1.0 + 0.1 * ii;
+        vel[ii] = -0.5 * ii;
+    }
+    for (int cycle = 0; cycle < 100; cycle++) {
+        for (unsigned int stage = 1; stage <= 6; stage++) {
+            for (unsigned int ii = 0; ii < size; ii++) {
+                accel[ii] = -pos[ii] - 0.1 * vel[ii];
+            }
+            er7_utils::rkf45_steps::rkf45_simple_step<fixed_size>( 0.01, stage, size,
+             &accel[0], &init[0], &init[size], posdot_hist, veldot_hist, vel, pos);
+        }
+    }
+    return state;
+}
+
+template <unsigned int fixed_size>
+static void expect_rkf45_fixed_size_matches_generic() {
+    std::vector<double> fixed = rkf45_first_order_cycles<fixed_size>(fixed_size);
+    std::vector<double> generic = rkf45_first_order_cycles<0>(fixed_size);
+    EXPECT_EQ(memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)), 0) << "first order size " << fixed_size;
+
+    fixed = rkf45_second_order_cycles<fixed_size>(fixed_size);
+    generic = rkf45_second_order_cycles<0>(fixed_size);
+    EXPECT_EQ(memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)), 0) << "second order size " << fixed_size;
+}
+
+TEST(RKF45StepsTest, FixedSizeMatchesGeneric) {
+
+    // The fixed size steps give the same bits as the run time size step.
+    expect_rkf45_fixed_size_matches_generic<3>();
+    expect_rkf45_fixed_size_matches_generic<4>();
+    expect_rkf45_fixed_size_matches_generic<6>();
+    expect_rkf45_fixed_size_matches_generic<7>();
+    expect_rkf45_fixed_size_matches_generic<13>();
+}
@@ -0,0 +1,116 @@
+/*
+   PURPOSE: (Benchmark of the fixed size RK4 steps of er7_utils.)
+
+   Times the RK4 steps of the first order and simple second order integrators with the state size
+   known at compile time against the same steps with the size known at run time, for state sizes
+   common in vehicle dynamics.  The integrators use the fixed size step for the sizes that gain.
+   Each cycle is the four stages of one RK4 step of a damped oscillator, including the derivative.
+   The final states of both steps are compared bit for bit.
+
+   usage: RK4_steps_bench [cycles]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "er7_utils/integration/rk4/include/rk4_steps.hh"
+
+static double wall_time() {
+    struct timeval tv ;
+    gettimeofday(&tv, NULL) ;
+    return tv.tv_sec + tv.tv_usec * 1.0e-6 ;
+}
+
+/* Runs cycles RK4 steps of x' = -x + c and returns the time per step in ns. */
+template <unsigned int fixed_size>
+static double first_order( unsigned int size , long cycles , std::vector< double > & pos ) {
+    std::vector< double > deriv(size), init(size), hist(4 * size) ;
+    double * deriv_hist[4] = { &hist[0], &hist[size], &hist[2 * size], &hist[3 * size] } ;
+    pos.assign(size, 0.0) ;
+    for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+        pos[ii] = 1.0 + 0.1 * ii ;
+    }
+    double start = wall_time() ;
+    for ( long cycle = 0 ; cycle < cycles ; cycle++ ) {
+        for ( unsigned int stage = 1 ; stage <= 4 ; stage++ ) {
+            for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+                deriv[ii] = -pos[ii] + 0.3 * ii ;
+            }
+            er7_utils::rk4_steps::rk4_step<fixed_size>( 1.0e-6, stage, size,
+             &deriv[0], &init[0], deriv_hist, &pos[0]) ;
+        }
+    }
+    return (wall_time() - start) * 1.0e9 / cycles ;
+}
+
+/* Runs cycles RK4 steps of x'' = -x - 0.1 x' and returns the time per step in ns. */
+template <unsigned int fixed_size>
+static double second_order( unsigned int size , long cycles , std::vector< double > & state ) {
+    std::vector< double > accel(size), init(2 * size), hist(8 * size) ;
+    double * posdot_hist[4] = { &hist[0], &hist[size], &hist[2 * size], &hist[3 * size] } ;
+    double * veldot_hist[4] = { &hist[4 * size], &hist[5 * size], &hist[6 * size], &hist[7 * size] } ;
+    state.assign(2 * size, 0.0) ;
+    double * pos = &state[0] ;
+    double * vel = &state[size] ;
+    for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+        pos[ii] = 1.0 + 0.1 * ii ;
+        vel[ii] = -0.5 * ii ;
+    }
+    double start = wall_time() ;
+    for ( long cycle = 0 ; cycle < cycles ; cycle++ ) {
+        for ( unsigned int stage = 1 ; stage <= 4 ; stage++ ) {
+            for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+                accel[ii] = -pos[ii] - 0.1 * vel[ii] ;
+            }
+            er7_utils::rk4_steps::rk4_simple_step<fixed_size>( 1.0e-6, stage, size,
+             &accel[0], &init[0], &init[size], posdot_hist, veldot_hist, vel, pos) ;
+        }
+    }
+    return (wall_time() - start) * 1.0e9 / cycles ;
+}
+
+template <unsigned int fixed_size>
+static bool bench( long cycles ) {
+    std::vector< double > fixed , generic ;
+    bool same = true ;
+
+    double fixed_time = first_order<fixed_size>(fixed_size, cycles, fixed) ;
+    double generic_time = first_order<0>(fixed_size, cycles, generic) ;
+    same = same and ! memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)) ;
+    std::cout << std::setw(6) << fixed_size << "  first order  "
+     << std::setw(10) << fixed_time << std::setw(10) << generic_time << std::endl ;
+
+    fixed_time = second_order<fixed_size>(fixed_size, cycles, fixed) ;
+    generic_time = second_order<0>(fixed_size, cycles, generic) ;
+    same = same and ! memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)) ;
+    std::cout << std::setw(6) << fixed_size << "  second order "
+     << std::setw(10) << fixed_time << std::setw(10) << generic_time << std::endl ;
+
+    return same ;
+}
+
+int main( int argc , char * argv[] ) {
+
+    long cycles = (argc > 1) ? atol(argv[1]) : 2000000 ;
+    bool same = true ;
+
+    std::cout << "ns per RK4 step over " << cycles << " steps" << std::endl ;
+    std::cout << "  size  form              fixed  run time" << std::endl ;
+    std::cout << std::fixed << std::setprecision(1) ;
+    same = bench<3>(cycles) and same ;
+    same = bench<4>(cycles) and same ;
+    same = bench<6>(cycles) and same ;
+    same = bench<7>(cycles) and same ;
+    same = bench<13>(cycles) and same ;
+
+    if ( ! same ) {
+        std::cout << "the fixed size and run time size steps differ" << std::endl ;
+        return 1 ;
+    }
+    std::cout << "the fixed size and run time size steps are bit identical" << std::endl ;
+    return 0 ;
+}
@@ -0,0 +1,123 @@
+/*
+   PURPOSE: (Benchmark of the fixed size RKF45 steps of er7_utils.)
+
+   Times the RKF45 steps of the first order and simple second order integrators with the state size
+   known at compile time against the same steps with the size known at run time, for state sizes
+   common in vehicle dynamics.  The integrators use the fixed size step for the sizes that gain.
+   Each cycle is the six stages of one RKF45 step of a damped oscillator, including the derivative.
+   The final states of both steps are compared bit for bit.
+
+   usage: RKF45_steps_bench [cycles]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "er7_utils/integration/rkf45/include/rkf45_steps.hh"
+
+static double wall_time() {
+    struct timeval tv ;
+    gettimeofday(&tv, NULL) ;
+    return tv.tv_sec + tv.tv_usec * 1.0e-6 ;
+}
+
+/* Runs cycles RKF45 steps of x' = -x + c and returns the time per step in ns. */
+template <unsigned int fixed_size>
+static double first_order( unsigned int size , long cycles , std::vector< double > & pos ) {
+    std::vector< double > deriv(size), init(size), hist(6 * size) ;
+    double * deriv_hist[6] ;
+    for ( int jj = 0 ; jj < 6 ; jj++ ) {
+        deriv_hist[jj] = &hist[jj * size] ;
+    }
+    pos.assign(size, 0.0) ;
+    for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+        pos[ii] = 1.0 + 0.1 * ii ;
+    }
+    double start = wall_time() ;
+    for ( long cycle = 0 ; cycle < cycles ; cycle++ ) {
+        for ( unsigned int stage = 1 ; stage <= 6 ; stage++ ) {
+            for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+                deriv[ii] = -pos[ii] + 0.3 * ii ;
+            }
+            er7_utils::rkf45_steps::rkf45_step<fixed_size>( 1.0e-6, stage, size,
+             &deriv[0], &init[0], deriv_hist, &pos[0]) ;
+        }
+    }
+    return (wall_time() - start) * 1.0e9 / cycles ;
+}
+
+/* Runs cycles RKF45 steps of x'' = -x - 0.1 x' and returns the time per step in ns. */
+template <unsigned int fixed_size>
+static double second_order( unsigned int size , long cycles , std::vector< double > & state ) {
+    std::vector< double > accel(size), init(2 * size), hist(12 * size) ;
+    double * posdot_hist[6] ;
+    double * veldot_hist[6] ;
+    for ( int jj = 0 ; jj < 6 ; jj++ ) {
+        posdot_hist[jj] = &hist[jj * size] ;
+        veldot_hist[jj] = &hist[(6 + jj) * size] ;
+    }
+    state.assign(2 * size, 0.0) ;
+    double * pos = &state[0] ;
+    double * vel = &state[size] ;
+    for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+        pos[ii] = 1.0 + 0.1 * ii ;
+        vel[ii] = -0.5 * ii ;
+    }
+    double start = wall_time() ;
+    for ( long cycle = 0 ; cycle < cycles ; cycle++ ) {
+        for ( unsigned int stage = 1 ; stage <= 6 ; stage++ ) {
+            for ( unsigned int ii = 0 ; ii < size ; ii++ ) {
+                accel[ii] = -pos[ii] - 0.1 * vel[ii] ;
+            }
+            er7_utils::rkf45_steps::rkf45_simple_step<fixed_size>( 1.0e-6, stage, size,
+             &accel[0], &init[0], &init[size], posdot_hist, veldot_hist, vel, pos) ;
+        }
+    }
+    return (wall_time() - start) * 1.0e9 / cycles ;
+}
+
+template <unsigned int fixed_size>
+static bool bench( long cycles ) {
+    std::vector< double > fixed , generic ;
+    bool same = true ;
+
+    double fixed_time = first_order<fixed_size>(fixed_size, cycles, fixed) ;
+    double generic_time = first_order<0>(fixed_size, cycles, generic) ;
+    same = same and ! memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)) ;
+    std::cout << std::setw(6) << fixed_size << "  first order  "
+     << std::setw(10) << fixed_time << std::setw(10) << generic_time << std::endl ;
+
+    fixed_time = second_order<fixed_size>(fixed_size, cycles, fixed) ;
+    generic_time = second_order<0>(fixed_size, cycles, generic) ;
+    same = same and ! memcmp(&fixed[0], &generic[0], fixed.size() * sizeof(double)) ;
+    std::cout << std::setw(6) << fixed_size << "  second order "
+     << std::setw(10) << fixed_time << std::setw(10) << generic_time << std::endl ;
+
+    return same ;
+}
+
+int main( int argc , char * argv[] ) {
+
+    long cycles = (argc > 1) ? atol(argv[1]) : 2000000 ;
+    bool same = true ;
+
+    std::cout << "ns per RKF45 step over " << cycles << " steps" << std::endl ;
+    std::cout << "  size  form              fixed  run time" << std::endl ;
+    std::cout << std::fixed << std::setprecision(1) ;
+    same = bench<3>(cycles) and same ;
+    same = bench<4>(cycles) and same ;
+    same = bench<6>(cycles) and same ;
+    same = bench<7>(cycles) and same ;
+    same = bench<13>(cycles) and same ;
+
+    if ( ! same ) {
+        std::cout << "the fixed size and run time size steps differ" << std::endl ;
+        return 1 ;
+    }
+    std::cout << "the fixed size and run time size steps are bit identical" << std::endl ;
+    return 0 ;
+}
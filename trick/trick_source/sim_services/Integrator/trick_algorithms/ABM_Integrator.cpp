@@ -26,6 +26,8 @@ void Trick::ABM_Integrator::initialize(int State_size, double Dt) {
         state_ws[i] = INTEG_ALLOC( double, num_state);
     }
 
+    priming_step = true;
+
     /** Allocate the stored data.*/
     stored_data = INTEG_ALLOC( double*, 8);
     for(i=0; i<8 ; i++) {
@@ -86,6 +88,7 @@ int Trick::ABM_Integrator::integrate() {
                 /* Save initial time and compute time increments */
                 time_0 = time;
                 dto2 = dt / 2.0;
+                priming_step = true;
 
                 /* Save initial state and compute state at t = t + dt/2 */
                 for (i = 0; i < num_state; i++) {
@@ -136,6 +139,8 @@ int Trick::ABM_Integrator::integrate() {
     } else {
         switch (intermediate_step) {
             case 0:
+                priming_step = false;
+
                 /* Use the predictor method to calc deriv */
                 for (i = 0; i < num_state; i++) {
                     state_ws[0][i] = state[i];
@@ -180,3 +185,34 @@ int Trick::ABM_Integrator::integrate() {
     return( intermediate_step);
 }
 
+/**
+ Dense output of the last step.  A priming step uses the continuous extension of Runge Kutta 4.  A
+ predictor-corrector step uses cubic Hermite interpolation with the derivatives at both ends of the
+ step, which are the last two entries of stored_data.
+ */
+int Trick::ABM_Integrator::interpolate_state( double theta, double* state_out) {
+
+    int i;
+    double y_0;
+
+    if (priming_step) {
+        double theta2 = theta * theta;
+        double theta3 = theta2 * theta;
+        double b_1 = (theta - 1.5 * theta2 + theta3 * 2.0 / 3.0 - 1.0 / 6.0) * dt;
+        double b_2 = (theta2 - theta3 * 2.0 / 3.0 - 1.0 / 3.0) * dt;
+        double b_4 = (theta3 * 2.0 / 3.0 - 0.5 * theta2 - 1.0 / 6.0) * dt;
+        for (i = 0; i < num_state; i++) {
+            state_out[i] = state_ws[0][i]
+                + deriv[0][i] * b_1 + (deriv[1][i] + deriv[2][i]) * b_2 + deriv[3][i] * b_4;
+        }
+    } else {
+        for (i = 0; i < num_state; i++) {
+            y_0 = state_ws[0][i] - dt / 24.0 * (9.0 * deriv[1][i]
+                                                + 19.0 * stored_data[6][i]
+                                                - 5.0 * stored_data[5][i]
+                                                + stored_data[4][i]);
+            state_out[i] = hermite(theta, dt, y_0, stored_data[6][i], state_ws[0][i], stored_data[7][i]);
+        }
+    }
+    return 0;
+}
@@ -121,3 +121,22 @@ int Trick::RK4_Integrator::integrate() {
     return( intermediate_step);
 }
 
+/**
+ Third order continuous extension of the classical Runge Kutta method, written relative to the
+ state at the end of the step.
+ */
+int Trick::RK4_Integrator::interpolate_state( double theta, double* state_out) {
+
+    int i;
+    double theta2 = theta * theta;
+    double theta3 = theta2 * theta;
+    double b_1 = (theta - 1.5 * theta2 + theta3 * 2.0 / 3.0 - 1.0 / 6.0) * dt;
+    double b_2 = (theta2 - theta3 * 2.0 / 3.0 - 1.0 / 3.0) * dt;
+    double b_4 = (theta3 * 2.0 / 3.0 - 0.5 * theta2 - 1.0 / 6.0) * dt;
+
+    for (i = 0; i < num_state; i++) {
+        state_out[i] = state_ws[0][i]
+            + deriv[0][i] * b_1 + (deriv[1][i] + deriv[2][i]) * b_2 + deriv[3][i] * b_4;
+    }
+    return 0;
+}
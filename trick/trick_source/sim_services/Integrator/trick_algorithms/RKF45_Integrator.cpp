@@ -1,6 +1,12 @@
 #include "trick/RKF45_Integrator.hh"
 #include "trick/message_proto.h"
 
+/* Weights of the stages in the fifth order state at the end of the step. */
+static const double ch_45[] = { 0.0, 16.0 / 135.0, 0.0, 6656.0 / 12825.0, 28561.0 / 56430.0, -9.0 / 50.0, 2.0 / 55.0 };
+
+/* Weights of the stages in the difference between the fifth and the fourth order states. */
+static const double ce_45[] = { 0.0, 1.0 / 360.0, 0.0, -128.0 / 4275.0, -2197.0 / 75240.0, 1.0 / 50.0, 2.0 / 55.0 };
+
 /**
  */
 void Trick::RKF45_Integrator::initialize(int State_size, double Dt) {
@@ -70,7 +76,6 @@ int Trick::RKF45_Integrator::integrate() {
     double b_1, b_2, b_3, b_4, b_5;     /* dt workspace */
     double c_1, c_3, c_4, c_5, c_6;     /* dt workspace */
 
-    static const double ch_45[] = { 0.0, 16.0 / 135.0, 0.0, 6656.0 / 12825.0, 28561.0 / 56430.0, -9.0 / 50.0, 2.0 / 55.0 };
     static const double b3_45[] = { 0.0, 3.0 / 32.0, 9.0 / 32.0 };
     static const double b4_45[] = { 0.0, 1932.0 / 2197.0, -7200.0 / 2197.0, 7296.0 / 2197.0 };
     static const double b5_45[] = { 0.0, 439.0 / 216.0, -8.0, 3680.0 / 513.0, -845.0 / 4104.0 };
@@ -171,3 +176,39 @@ void Trick::RKF45_Integrator::set_first_step_deriv(bool first_step) {
     first_step_deriv = first_step;
 }
 
+/**
+ Cubic Hermite interpolation between the states at the start and end of the step.  The fifth stage
+ is evaluated at t + dt and stands in for the derivative at the end of the step.
+ */
+int Trick::RKF45_Integrator::interpolate_state( double theta, double* state_out) {
+
+    int i;
+    double y_0;
+
+    for (i = 0; i < num_state; i++) {
+        y_0 = state_ws[0][i] - (deriv[0][i] * ch_45[1]
+                                  + deriv[2][i] * ch_45[3]
+                                  + deriv[3][i] * ch_45[4] + deriv[4][i] * ch_45[5] + deriv[5][i] * ch_45[6]) * dt;
+        state_out[i] = hermite(theta, dt, y_0, deriv[0][i], state_ws[0][i], deriv[4][i]);
+    }
+    return 0;
+}
+
+/**
+ The error is the difference between the fifth and the fourth order states at the end of the step.
+ */
+int Trick::RKF45_Integrator::estimate_error( double* error_out, double* state_out) {
+
+    int i;
+
+    if (intermediate_step != 0) {
+        return 1;
+    }
+    for (i = 0; i < num_state; i++) {
+        error_out[i] = (deriv[0][i] * ce_45[1]
+                          + deriv[2][i] * ce_45[3]
+                          + deriv[3][i] * ce_45[4] + deriv[4][i] * ce_45[5] + deriv[5][i] * ce_45[6]) * dt;
+        state_out[i] = state_ws[0][i];
+    }
+    return 0;
+}
@@ -1,6 +1,10 @@
 #include "trick/RKF78_Integrator.hh"
 #include "trick/message_proto.h"
 
+/* Weights of the stages in the eighth order state at the end of the step. */
+static const double ch_78[] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 34.0 / 105.0, 9.0 / 35.0, 9.0 / 35.0, 9.0 / 280.0,
+                                9.0 / 280.0, 0.0, 41.0 / 840.0, 41.0 / 840.0 };
+
 /**
  */
 void Trick::RKF78_Integrator::initialize(int State_size, double Dt) {
@@ -68,8 +72,6 @@ int Trick::RKF78_Integrator::integrate() {
     double b_1, b_2, b_3, b_4, b_5, b_6, b_7;   /* temporary dt values */
     double c_1, c_2, c_3, c_4;  /* temporary dt values */
 
-    static double ch_78[] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 34.0 / 105.0, 9.0 / 35.0, 9.0 / 35.0, 9.0 / 280.0,
-                              9.0 / 280.0, 0.0, 41.0 / 840.0, 41.0 / 840.0 };
     static double b2_78[] = { 0.0, 2.0 / 27.0 };
     static double b3_78[] = { 0.0, 1.0 / 36.0, 1.0 / 12.0 };
     static double b4_78[] = { 0.0, 1.0 / 24.0, 0.0, 1.0 / 8.0 };
@@ -238,3 +240,22 @@ int Trick::RKF78_Integrator::integrate() {
     }
     return ( intermediate_step);
 }
+
+/**
+ Cubic Hermite interpolation between the states at the start and end of the step.  The last stage
+ is evaluated at t + dt and stands in for the derivative at the end of the step.
+ */
+int Trick::RKF78_Integrator::interpolate_state( double theta, double* state_out) {
+
+    int i;
+    double y_0;
+
+    for (i = 0; i < num_state; i++) {
+        y_0 = state_ws[0][i] - (deriv[5][i] * ch_78[6]
+                                  + (deriv[6][i] + deriv[7][i]) * ch_78[7]
+                                  + (deriv[8][i] + deriv[9][i]) * ch_78[9]
+                                  + (deriv[10][i] + deriv[11][i]) * ch_78[12]) * dt;
+        state_out[i] = hermite(theta, dt, y_0, deriv[0][i], state_ws[0][i], deriv[11][i]);
+    }
+    return 0;
+}
@@ -2,17 +2,97 @@
 #include <iostream>
 #include <sstream>
 #include <cstring> // for memcpy
+#include <algorithm>
+#include <climits>
 #include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 #include "trick/MSSharedMem.hh"
 #include "trick/tsm_proto.h"
 #include "trick/command_line_protos.h"
 
+namespace {
+
+double monotonic_time() {
+    struct timespec ts ;
+    clock_gettime(CLOCK_MONOTONIC, &ts) ;
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0 ;
+}
+
+void ring_init( Trick::MSRing * ring , unsigned int size ) {
+    ring->head = ring->tail = 0 ;
+    ring->head_waiters = ring->tail_waiters = 0 ;
+    ring->size = size ;
+}
+
+/* Bytes written and not yet read.  The writer publishes head after the data, so the data below head is visible. */
+unsigned int ring_used( Trick::MSRing * ring ) {
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) ;
+}
+
+unsigned int ring_free( Trick::MSRing * ring ) {
+    return ring->size - ring_used(ring) ;
+}
+
+void ring_wake( unsigned int * word , unsigned int * waiters ) {
+#ifdef __linux__
+    if ( __atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0 ) {
+        syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0) ;
+    }
+#else
+    (void)word ;
+    (void)waiters ;
+#endif
+}
+
+/* Copies size bytes at byte offset pos of the ring, which may wrap around the end of data. */
+void ring_copy_in( Trick::MSRing * ring , char * data , unsigned int pos , const void * in , unsigned int size ) {
+    unsigned int offset = pos & (ring->size - 1) ;
+    unsigned int first = std::min(size, ring->size - offset) ;
+    memcpy(data + offset, in, first) ;
+    memcpy(data, (const char *)in + first, size - first) ;
+}
+
+void ring_copy_out( Trick::MSRing * ring , const char * data , unsigned int pos , void * out , unsigned int size ) {
+    unsigned int offset = pos & (ring->size - 1) ;
+    unsigned int first = std::min(size, ring->size - offset) ;
+    memcpy(out, data + offset, first) ;
+    memcpy((char *)out + first, data, size - first) ;
+}
+
+/* Writes one record.  The caller made sure there is room. */
+void ring_push( Trick::MSRing * ring , char * data , const void * in , unsigned int size ) {
+    unsigned int head = ring->head ;
+    ring_copy_in(ring, data, head, in, size) ;
+    __atomic_store_n(&ring->head, head + size, __ATOMIC_SEQ_CST) ;
+    ring_wake(&ring->head, &ring->head_waiters) ;
+}
+
+/* Reads one record.  The caller made sure it is there. */
+void ring_pop( Trick::MSRing * ring , const char * data , void * out , unsigned int size , unsigned int skip = 0 ) {
+    unsigned int tail = ring->tail ;
+    ring_copy_out(ring, data, tail, out, size) ;
+    __atomic_store_n(&ring->tail, tail + size + skip, __ATOMIC_SEQ_CST) ;
+    ring_wake(&ring->tail, &ring->tail_waiters) ;
+}
+
+/* Payloads are a length followed by the data, padded to the record size. */
+unsigned int payload_space( unsigned int size ) {
+    return MS_RING_RECORD_SIZE + ((size + MS_RING_RECORD_SIZE - 1) & ~(MS_RING_RECORD_SIZE - 1)) ;
+}
+
+}
+
 Trick::MSSharedMem::MSSharedMem() : tsm_dev() {
     tsm_dev.default_val = -1;
 
     // default is a non-zero sync wait limit; helpful when slave reading initial data from master
     sync_wait_limit = 5.0 ;
+
+    reset_round_trip_stats() ;
 }
 
 Trick::MSSharedMem::~MSSharedMem() {
@@ -71,9 +151,11 @@ int Trick::MSSharedMem::accept() {
     if (ret==TSM_SUCCESS) {
         shm_addr->master_pid = getpid();
 //fprintf(stderr, "====accept master=%d\n", getpid());
-        MSQ_INIT(shm_addr->master_time);
-        MSQ_INIT(shm_addr->master_command);
-        MSQ_INIT(shm_addr->slave_command);
+        ring_init(&shm_addr->master_time, MS_RING_RECORDS_SIZE);
+        ring_init(&shm_addr->master_command, MS_RING_RECORDS_SIZE);
+        ring_init(&shm_addr->slave_command, MS_RING_RECORDS_SIZE);
+        ring_init(&shm_addr->master_payload, MS_RING_PAYLOAD_SIZE);
+        ring_init(&shm_addr->slave_payload, MS_RING_PAYLOAD_SIZE);
         shm_addr->slave_port = MS_ERROR_PORT;
         shm_addr->chkpnt_name[0] = MS_ERROR_NAME;
     } else {
@@ -106,7 +188,7 @@ double Trick::MSSharedMem::read_wait(struct timespec *in_start) {
     struct timespec ts_Current, ts_Difference;
 
     RELEASE();
-    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts_Current);
+    clock_gettime(CLOCK_MONOTONIC, &ts_Current);
     if ((ts_Current.tv_nsec - in_start->tv_nsec) < 0) {
         ts_Difference.tv_sec = ts_Current.tv_sec - in_start->tv_sec - 1;
         ts_Difference.tv_nsec = 1000000000 + ts_Current.tv_nsec - in_start->tv_nsec;
@@ -118,82 +200,115 @@ double Trick::MSSharedMem::read_wait(struct timespec *in_start) {
     return ((double)ts_Difference.tv_nsec / 1000000000.0) + ts_Difference.tv_sec;
 }
 
+/**
+@details
+-# If the ring does not hold need bytes to read (or room for need bytes to write), sleep on the ring's head (or
+   tail) with a futex until the other side changes it or the sync wait limit expires.  Other systems poll with
+   RELEASE().
+-# Return whether the bytes (or room) are there.
+*/
+bool Trick::MSSharedMem::ring_wait(MSRing * ring , unsigned int need , bool reader) {
+
+    unsigned int * word = reader ? &ring->head : &ring->tail ;
+    unsigned int * waiters = reader ? &ring->head_waiters : &ring->tail_waiters ;
+    double start = 0.0 ;
+
+    while ( true ) {
+        // Read the word before testing, a change after the test makes the futex wait return at once.
+        unsigned int seen = __atomic_load_n(word, __ATOMIC_SEQ_CST) ;
+        if ( (reader ? ring_used(ring) : ring_free(ring)) >= need ) {
+            return true ;
+        }
+        double now = monotonic_time() ;
+        if ( start == 0.0 ) {
+            start = now ;
+        }
+        double remaining = sync_wait_limit - (now - start) ;
+        if ( remaining <= 0.0 ) {
+            return false ;
+        }
+#ifdef __linux__
+        struct timespec timeout ;
+        timeout.tv_sec = (time_t)remaining ;
+        timeout.tv_nsec = (long)((remaining - timeout.tv_sec) * 1000000000.0) ;
+        __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST) ;
+        syscall(SYS_futex, word, FUTEX_WAIT, seen, (sync_wait_limit >= TSM_MAX_TIMEOUT_LIMIT) ? NULL : &timeout,
+         NULL, 0) ;
+        __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST) ;
+#else
+        (void)seen ;
+        (void)waiters ;
+        RELEASE();
+#endif
+    }
+}
+
+void Trick::MSSharedMem::start_round_trip() {
+    if ( round_trip_start == 0.0 ) {
+        round_trip_start = monotonic_time() ;
+    }
+}
+
+void Trick::MSSharedMem::end_round_trip() {
+    if ( round_trip_start != 0.0 ) {
+        double round_trip = monotonic_time() - round_trip_start ;
+        round_trip_start = 0.0 ;
+        if ( round_trip_count == 0 or round_trip < round_trip_min ) {
+            round_trip_min = round_trip ;
+        }
+        if ( round_trip > round_trip_max ) {
+            round_trip_max = round_trip ;
+        }
+        round_trip_total += round_trip ;
+        round_trip_count++ ;
+        round_trip_avg = round_trip_total / round_trip_count ;
+    }
+}
+
+void Trick::MSSharedMem::reset_round_trip_stats() {
+    round_trip_count = 0 ;
+    round_trip_min = round_trip_max = round_trip_avg = 0.0 ;
+    round_trip_start = round_trip_total = 0.0 ;
+}
+
 long long Trick::MSSharedMem::read_time() {
 
     long long in_time;
-    double readtry_time = 0.0;
-    struct timespec ts_Start;
 
     /** @par Detailed Design */
-    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts_Start);
-
-    /** @li Get time from shared memory */
-    while (MSQ_ISEMPTY(shm_addr->master_time)) {
-        if (readtry_time >= sync_wait_limit) {
-            break;
-        }
-        readtry_time = read_wait(&ts_Start);
-    }
-    if (!MSQ_ISEMPTY(shm_addr->master_time)) {
-        in_time = MSQ_FRONT(shm_addr->master_time);
-//fprintf(stderr, "+++++read_time pid=%d time=%lld readtry=%f\n", getpid(), in_time, readtry_time);
-        MSQ_POP(shm_addr->master_time);
+    /** @li Wait for the time in shared memory */
+    if ( ring_wait(&shm_addr->master_time, MS_RING_RECORD_SIZE, true) ) {
+        ring_pop(&shm_addr->master_time, shm_addr->master_time_data, &in_time, MS_RING_RECORD_SIZE) ;
+        end_round_trip() ;
         return (in_time) ;
-    /** @li If no new data before timeout limit, return "error" time */
-    } else {
-//fprintf(stderr, "+++++read_time pid=%d time=%lld ERROR readtry=%f\n", getpid(), in_time, readtry_time,); fflush(stderr);
-        return (MS_ERROR_TIME) ;
     }
+    /** @li If no new data before timeout limit, return "error" time */
+    return (MS_ERROR_TIME) ;
 }
 
 MS_SIM_COMMAND Trick::MSSharedMem::read_command() {
 
-    MS_SIM_COMMAND command;
-    double readtry_time = 0.0;
-    struct timespec ts_Start;
+    long long command;
+    MSRing * ring ;
+    char * data ;
 
     /** @par Detailed Design */
-    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts_Start);
-
     if (getpid() == shm_addr->master_pid) {
-    /** @li Get slave command from shared memory */
-    // I am master, so read slave command
-        while (MSQ_ISEMPTY(shm_addr->slave_command)) {
-            if (readtry_time >= sync_wait_limit) {
-                break;
-            }
-            readtry_time = read_wait(&ts_Start);
-        }
-        if (!MSQ_ISEMPTY(shm_addr->slave_command)) {
-            command = MSQ_FRONT(shm_addr->slave_command);
-//fprintf(stderr, "+++++read_command pid=%d command=%d (from slave)\n", getpid(), command);
-            MSQ_POP(shm_addr->slave_command);
-            return (command) ;
-        /** @li If no new data before timeout limit, return "error" command */
-        } else {
-//fprintf(stderr, "+++++read_command pid=%d command=%d (from slave) ERROR readtry=%f\n", getpid(), command, readtry_time);
-            return (MS_ErrorCmd) ;
-        }
+    /** @li I am master, so read slave command */
+        ring = &shm_addr->slave_command ;
+        data = shm_addr->slave_command_data ;
     } else {
-    /** @li Get master command from shared memory */
-    // I am slave, so read master command
-        while (MSQ_ISEMPTY(shm_addr->master_command)) {
-            if (readtry_time >= sync_wait_limit) {
-                break;
-            }
-            readtry_time = read_wait(&ts_Start);
-        }
-        if (!MSQ_ISEMPTY(shm_addr->master_command)) {
-            command = MSQ_FRONT(shm_addr->master_command);
-//fprintf(stderr, "+++++read_command pid=%d command=%d (from master)\n", getpid(), command);
-            MSQ_POP(shm_addr->master_command);
-            return (command) ;
-        /** @li If no new data before timeout limit, return "error" command */
-        } else {
-//fprintf(stderr, "+++++read_command pid=%d command=%d (from master) ERROR readtry=%f\n", getpid(), command, readtry_time);
-            return (MS_ErrorCmd) ;
-        }
+    /** @li I am slave, so read master command */
+        ring = &shm_addr->master_command ;
+        data = shm_addr->master_command_data ;
     }
+    if ( ring_wait(ring, MS_RING_RECORD_SIZE, true) ) {
+        ring_pop(ring, data, &command, MS_RING_RECORD_SIZE) ;
+        end_round_trip() ;
+        return ((MS_SIM_COMMAND)command) ;
+    }
+    /** @li If no new data before timeout limit, return "error" command */
+    return (MS_ErrorCmd) ;
 }
 
 int Trick::MSSharedMem::read_port() {
@@ -203,7 +318,7 @@ int Trick::MSSharedMem::read_port() {
     struct timespec ts_Start;
 
     /** @par Detailed Design */
-    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts_Start);
+    clock_gettime(CLOCK_MONOTONIC, &ts_Start);
 
     /** @li Get port number from shared memory */
     while (shm_addr->slave_port == MS_ERROR_PORT) {
@@ -228,7 +343,7 @@ char Trick::MSSharedMem::read_name(char * read_data, size_t size) {
     struct timespec ts_Start;
 
     /** @par Detailed Design */
-    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts_Start);
+    clock_gettime(CLOCK_MONOTONIC, &ts_Start);
 
     /** @li Get name (character array) from shared memory */
     while (shm_addr->chkpnt_name[0] == MS_ERROR_NAME) {
@@ -250,9 +365,13 @@ char Trick::MSSharedMem::read_name(char * read_data, size_t size) {
 int Trick::MSSharedMem::write_time(long long in_time) {
 
     /** @par Detailed Design */
-    /** @li Write time to shared memory */
+    /** @li Write time to shared memory.  If the slave has stopped reading and the ring is full, drop it. */
 //fprintf(stderr, "====write_time pid=%d time=%lld\n", getpid(), in_time);
-    MSQ_PUSH(shm_addr->master_time, in_time);
+    if ( ring_free(&shm_addr->master_time) < MS_RING_RECORD_SIZE ) {
+        return(0) ;
+    }
+    ring_push(&shm_addr->master_time, shm_addr->master_time_data, &in_time, MS_RING_RECORD_SIZE) ;
+    start_round_trip() ;
 
     /** @li Return the number of bytes written */
     return(sizeof(long long)) ;
@@ -260,15 +379,26 @@ int Trick::MSSharedMem::write_time(long long in_time) {
 
 int Trick::MSSharedMem::write_command(MS_SIM_COMMAND command) {
 
+    long long out_command = command ;
+    MSRing * ring ;
+    char * data ;
+
     /** @par Detailed Design */
-    /** @li Write command to shared memory */
+    /** @li Write command to shared memory.  If the other side has stopped reading and the ring is full, drop it. */
     if (getpid() == shm_addr->master_pid) {
 //fprintf(stderr, "====write_command pid=%d command=%d (master)\n", getpid(), command);
-        MSQ_PUSH(shm_addr->master_command, command);
+        ring = &shm_addr->master_command ;
+        data = shm_addr->master_command_data ;
     } else {
 //fprintf(stderr, "====write_command pid=%d command=%d (slave)\n", getpid(), command);
-        MSQ_PUSH(shm_addr->slave_command, command);
+        ring = &shm_addr->slave_command ;
+        data = shm_addr->slave_command_data ;
     }
+    if ( ring_free(ring) < MS_RING_RECORD_SIZE ) {
+        return(0) ;
+    }
+    ring_push(ring, data, &out_command, MS_RING_RECORD_SIZE) ;
+    start_round_trip() ;
 
     /** @li Return the number of bytes written */
     return(sizeof(MS_SIM_COMMAND)) ;
@@ -293,3 +423,70 @@ int Trick::MSSharedMem::write_name(char * in_data, size_t size) {
     /** @li Return the number of bytes written */
     return(size);
 }
+
+int Trick::MSSharedMem::read_payload(void * in_data, size_t size) {
+
+    long long payload_size ;
+    MSRing * ring ;
+    char * data ;
+
+    /** @par Detailed Design */
+    if (getpid() == shm_addr->master_pid) {
+        ring = &shm_addr->slave_payload ;
+        data = shm_addr->slave_payload_data ;
+    } else {
+        ring = &shm_addr->master_payload ;
+        data = shm_addr->master_payload_data ;
+    }
+
+    /** @li Wait for the length of the next payload.  The writer publishes the length and data together. */
+    if ( ! ring_wait(ring, MS_RING_RECORD_SIZE, true) ) {
+        return(-1) ;
+    }
+    ring_copy_out(ring, data, ring->tail, &payload_size, MS_RING_RECORD_SIZE) ;
+
+    /** @li Copy out as much of the payload as fits and skip the rest. */
+    unsigned int copy = (unsigned int)std::min((size_t)payload_size, size) ;
+    ring_copy_out(ring, data, ring->tail + MS_RING_RECORD_SIZE, in_data, copy) ;
+    ring_pop(ring, data, &payload_size, 0, payload_space((unsigned int)payload_size)) ;
+    end_round_trip() ;
+
+    return((int)copy) ;
+}
+
+int Trick::MSSharedMem::write_payload(const void * in_data, size_t size) {
+
+    long long payload_size = size ;
+    MSRing * ring ;
+    char * data ;
+
+    /** @par Detailed Design */
+    if (getpid() == shm_addr->master_pid) {
+        ring = &shm_addr->master_payload ;
+        data = shm_addr->master_payload_data ;
+    } else {
+        ring = &shm_addr->slave_payload ;
+        data = shm_addr->slave_payload_data ;
+    }
+
+    /** @li A payload larger than the ring can never be sent. */
+    if ( size > MS_RING_PAYLOAD_SIZE - MS_RING_RECORD_SIZE ) {
+        return(-1) ;
+    }
+    unsigned int space = payload_space((unsigned int)size) ;
+
+    /** @li Wait for the reader to make room, up to the sync wait limit. */
+    if ( ! ring_wait(ring, space, false) ) {
+        return(-1) ;
+    }
+
+    /** @li Copy the length and data, then publish both by moving head. */
+    unsigned int head = ring->head ;
+    ring_copy_in(ring, data, head, &payload_size, MS_RING_RECORD_SIZE) ;
+    ring_copy_in(ring, data, head + MS_RING_RECORD_SIZE, in_data, (unsigned int)size) ;
+    __atomic_store_n(&ring->head, head + space, __ATOMIC_SEQ_CST) ;
+    ring_wake(&ring->head, &ring->head_waiters) ;
+    start_round_trip() ;
+
+    return((int)size) ;
+}
@@ -236,3 +236,42 @@ int Trick::MSSocket::write_name(char * in_data, size_t size) {
     /** @li Return the number of bytes written */
     return(size) ;
 }
+
+int Trick::MSSocket::read_payload(void * in_data, size_t size) {
+
+    int payload_size = 0 ;
+    int copy ;
+    char discard[1024] ;
+
+    /** @par Detailed Design */
+    /** @li Call tc_read to get the size of the payload */
+    if ( tc_read(&tc_dev , (char *)&payload_size, sizeof(int)) != sizeof(int) or payload_size < 0 ) {
+        return(-1) ;
+    }
+
+    /** @li Call tc_read to get as much of the payload as fits, then read and drop the rest */
+    copy = ( (size_t)payload_size < size ) ? payload_size : (int)size ;
+    if ( tc_read(&tc_dev , (char *)in_data, copy) != copy ) {
+        return(-1) ;
+    }
+    for ( int left = payload_size - copy ; left > 0 ; left -= (int)sizeof(discard) ) {
+        int num = ( left < (int)sizeof(discard) ) ? left : (int)sizeof(discard) ;
+        if ( tc_read(&tc_dev , discard, num) != num ) {
+            return(-1) ;
+        }
+    }
+    return(copy) ;
+}
+
+int Trick::MSSocket::write_payload(const void * in_data, size_t size) {
+
+    int payload_size = (int)size ;
+
+    /** @par Detailed Design */
+    /** @li Call tc_write to write the size of the payload, then the payload */
+    if ( tc_write(&tc_dev , (char *)&payload_size, sizeof(int)) != sizeof(int) or
+         tc_write(&tc_dev , (char *)in_data, payload_size) != payload_size ) {
+        return(-1) ;
+    }
+    return(payload_size) ;
+}
@@ -0,0 +1,199 @@
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include <sys/shm.h>
+#include <sys/wait.h>
+#include "gtest/gtest.h"
+
+#define protected public
+#define private public
+#include "trick/MSSharedMem.hh"
+
+namespace Trick {
+
+static double now() {
+    struct timespec ts ;
+    clock_gettime(CLOCK_MONOTONIC, &ts) ;
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9 ;
+}
+
+/* Waits up to 5 seconds for a process to sleep on a ring counter. */
+static bool wait_for_sleeper( unsigned int * waiters ) {
+    double start = now() ;
+    while ( __atomic_load_n(waiters, __ATOMIC_SEQ_CST) == 0 ) {
+        if ( now() - start > 5.0 ) {
+            return false ;
+        }
+        usleep(1000) ;
+    }
+    return true ;
+}
+
+/* The parent is the master.  A forked child is the slave, attached to the same shared memory. */
+class MSSharedMemTest : public ::testing::Test {
+
+    protected:
+        MSSharedMemTest() {}
+        ~MSSharedMemTest() {}
+
+        void SetUp() {
+            // Key the segment on this file so that it does not collide with a running sim.
+            strncpy(master.tsm_dev.key_file, __FILE__, sizeof(master.tsm_dev.key_file) - 1) ;
+            ASSERT_EQ(TSM_SUCCESS, master.accept()) ;
+            shm = master.shm_addr ;
+        }
+
+        void TearDown() {
+            shmctl(master.tsm_dev.shmid, IPC_RMID, NULL) ;
+        }
+
+        /* Runs body as the slave in a child process and returns the child, which exits with body's return. */
+        pid_t fork_slave( int (*body)( MSSharedMem & slave ) ) {
+            pid_t pid = fork() ;
+            if ( pid == 0 ) {
+                MSSharedMem slave ;
+                slave.shm_addr = shm ;
+                slave.set_sync_wait_limit(10.0) ;
+                _exit(body(slave)) ;
+            }
+            return pid ;
+        }
+
+        /* Waits for the slave and returns its exit status, -1 if it did not exit. */
+        int join_slave( pid_t pid ) {
+            int status ;
+            if ( waitpid(pid, &status, 0) != pid or ! WIFEXITED(status) ) {
+                return -1 ;
+            }
+            return WEXITSTATUS(status) ;
+        }
+
+        MSSharedMem master ;
+        MSSharedMemData * shm ;
+} ;
+
+static const int num_frames = 2000 ;
+
+/* The size of the master's payload of a frame, chosen so that payloads wrap around the ring end at odd offsets. */
+static int frame_payload_size( int frame ) {
+    return (frame * 37) % 5000 + 1 ;
+}
+
+static int slave_frames( MSSharedMem & slave ) {
+    char buf[5000] ;
+    for ( int ii = 0 ; ii < num_frames ; ii++ ) {
+        if ( slave.write_command((MS_SIM_COMMAND)(ii % 7)) != sizeof(MS_SIM_COMMAND) ) return 1 ;
+        if ( slave.read_time() != ii ) return 2 ;
+        if ( slave.read_command() != (MS_SIM_COMMAND)((ii + 1) % 5) ) return 3 ;
+        int size = slave.read_payload(buf, sizeof(buf)) ;
+        if ( size != frame_payload_size(ii) or buf[0] != (char)ii or buf[size - 1] != (char)ii ) return 4 ;
+        memset(buf, ii + 1, 100) ;
+        if ( slave.write_payload(buf, 100) != 100 ) return 5 ;
+    }
+    return 0 ;
+}
+
+TEST_F( MSSharedMemTest , RoundTripWrapsAround ) {
+    // Start the counters just below 2^32 so that they wrap, the data wraps around the ring ends every few frames.
+    MSRing * rings[] = { &shm->master_time , &shm->master_command , &shm->slave_command , &shm->master_payload ,
+                         &shm->slave_payload } ;
+    for ( unsigned int ii = 0 ; ii < sizeof(rings) / sizeof(rings[0]) ; ii++ ) {
+        rings[ii]->head = rings[ii]->tail = 0u - 3 * MS_RING_RECORD_SIZE ;
+    }
+
+    pid_t pid = fork_slave(slave_frames) ;
+    char buf[5000] ;
+    master.set_sync_wait_limit(10.0) ;
+    for ( int ii = 0 ; ii < num_frames ; ii++ ) {
+        ASSERT_EQ((MS_SIM_COMMAND)(ii % 7), master.read_command()) << "frame " << ii ;
+        master.write_time(ii) ;
+        master.write_command((MS_SIM_COMMAND)((ii + 1) % 5)) ;
+        int size = frame_payload_size(ii) ;
+        memset(buf, ii, size) ;
+        ASSERT_EQ(size, master.write_payload(buf, size)) << "frame " << ii ;
+        ASSERT_EQ(100, master.read_payload(buf, sizeof(buf))) << "frame " << ii ;
+        ASSERT_EQ((char)(ii + 1), buf[99]) << "frame " << ii ;
+    }
+    EXPECT_EQ(0, join_slave(pid)) ;
+
+    for ( unsigned int ii = 0 ; ii < sizeof(rings) / sizeof(rings[0]) ; ii++ ) {
+        EXPECT_LT(rings[ii]->head, 0x80000000u) ;
+        EXPECT_EQ(rings[ii]->head, rings[ii]->tail) ;
+    }
+    EXPECT_EQ(num_frames, master.round_trip_count) ;
+    EXPECT_LE(master.round_trip_min, master.round_trip_avg) ;
+    EXPECT_LE(master.round_trip_avg, master.round_trip_max) ;
+}
+
+TEST_F( MSSharedMemTest , FullRing ) {
+    // A full time ring drops new times rather than overwrite unread ones.
+    const long long num_records = MS_RING_RECORDS_SIZE / MS_RING_RECORD_SIZE ;
+    for ( long long ii = 0 ; ii < num_records ; ii++ ) {
+        EXPECT_EQ((int)sizeof(long long), master.write_time(ii)) ;
+    }
+    EXPECT_EQ(0, master.write_time(num_records)) ;
+    for ( long long ii = 0 ; ii < num_records ; ii++ ) {
+        EXPECT_EQ(ii, master.read_time()) ;
+    }
+    master.set_sync_wait_limit(0.01) ;
+    EXPECT_EQ(MS_ERROR_TIME, master.read_time()) ;
+
+    // A full payload ring fails the write after the wait limit.  A payload that never fits fails at once.
+    char buf[4000] ;
+    int num_payloads = 0 ;
+    while ( master.write_payload(buf, sizeof(buf)) == (int)sizeof(buf) ) {
+        num_payloads++ ;
+    }
+    EXPECT_EQ(MS_RING_PAYLOAD_SIZE / (MS_RING_RECORD_SIZE + sizeof(buf)), (unsigned int)num_payloads) ;
+    std::vector< char > too_big(MS_RING_PAYLOAD_SIZE) ;
+    EXPECT_EQ(-1, master.write_payload(&too_big[0], too_big.size())) ;
+}
+
+static int slave_read_time( MSSharedMem & slave ) {
+    double start = now() ;
+    if ( slave.read_time() != 42 ) return 1 ;
+    return ( now() - start < 5.0 ) ? 0 : 2 ;
+}
+
+TEST_F( MSSharedMemTest , BlockedReaderWakes ) {
+    // The slave sleeps on the empty time ring until the master writes.
+    pid_t pid = fork_slave(slave_read_time) ;
+    EXPECT_TRUE(wait_for_sleeper(&shm->master_time.head_waiters)) ;
+    master.write_time(42) ;
+    EXPECT_EQ(0, join_slave(pid)) ;
+    EXPECT_EQ(0u, shm->master_time.head_waiters) ;
+}
+
+static int slave_drain_payloads( MSSharedMem & slave ) {
+    char buf[4000] ;
+    // Let the master fall asleep on the full ring before making room.
+    if ( ! wait_for_sleeper(&slave.shm_addr->master_payload.tail_waiters) ) return 1 ;
+    const int num_payloads = MS_RING_PAYLOAD_SIZE / (MS_RING_RECORD_SIZE + sizeof(buf)) + 1 ;
+    for ( int ii = 0 ; ii < num_payloads ; ii++ ) {
+        if ( slave.read_payload(buf, sizeof(buf)) != (int)sizeof(buf) or buf[0] != (char)ii ) return 2 ;
+    }
+    return 0 ;
+}
+
+TEST_F( MSSharedMemTest , BlockedWriterWakes ) {
+    // The master fills the payload ring, then sleeps on it until the slave reads.
+    char buf[4000] ;
+    int num_payloads = 0 ;
+    master.set_sync_wait_limit(0.01) ;
+    memset(buf, num_payloads, sizeof(buf)) ;
+    while ( master.write_payload(buf, sizeof(buf)) == (int)sizeof(buf) ) {
+        memset(buf, ++num_payloads, sizeof(buf)) ;
+    }
+
+    pid_t pid = fork_slave(slave_drain_payloads) ;
+    master.set_sync_wait_limit(10.0) ;
+    double start = now() ;
+    EXPECT_EQ((int)sizeof(buf), master.write_payload(buf, sizeof(buf))) ;
+    EXPECT_LT(now() - start, 5.0) ;
+    EXPECT_EQ(0, join_slave(pid)) ;
+    EXPECT_EQ(0u, shm->master_payload.tail_waiters) ;
+}
+
+}
@@ -1,5 +1,6 @@
 #include <dlfcn.h>
 #include <stdlib.h>
+#include <string.h>
 #include "trick/MemoryManager.hh"
 #include "trick/ClassicCheckPointAgent.hh"
 // Global pointer to the (singleton) MemoryManager for the C language interface.
@@ -28,6 +29,10 @@ Trick::MemoryManager::MemoryManager()
     alloc_info_map_counter = 100000000 ;
     // start counter at 0.  This forces extern vars to appear in front of actual allocations in checkpoint.
     extern_alloc_info_map_counter = 0 ;
+    alloc_generation = 0 ;
+    alloc_index = NULL ;
+    memset(alloc_index_readers, 0, sizeof(alloc_index_readers)) ;
+    alloc_index_misses = 0 ;
     pthread_mutex_init(&mm_mutex, NULL);
 
     defaultCheckPointAgent = new ClassicCheckPointAgent( this);
@@ -93,6 +98,12 @@ Trick::MemoryManager::~MemoryManager() {
         free(ai_ptr) ;
     }
     alloc_info_map.clear() ;
+    alloc_generation++ ;
+
+    delete alloc_index ;
+    for ( unsigned int ii = 0 ; ii < retired_alloc_indexes.size() ; ii++ ) {
+        delete retired_alloc_indexes[ii] ;
+    }
 }
 
 #include <sstream>
@@ -553,6 +553,19 @@ extern "C" ALLOC_INFO* get_alloc_info_at(void * addr) {
     }
 }
 
+/**
+ @relates Trick::MemoryManager
+ This is the C Language version of Trick::MemoryManager::get_alloc_generation().
+ */
+extern "C" unsigned long long get_alloc_generation(void) {
+    if (trick_MM != NULL) {
+        return( trick_MM->get_alloc_generation());
+    } else {
+        Trick::MemoryManager::emitError("get_alloc_generation() called before MemoryManager instantiation.\n") ;
+        return (0);
+    }
+}
+
 extern "C" int set_alloc_name_at(void * addr, const char * name ) {
     if (trick_MM != NULL) {
         return( trick_MM->set_name_at(addr, name));
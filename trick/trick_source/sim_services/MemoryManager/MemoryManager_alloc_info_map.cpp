@@ -1,17 +1,101 @@
 #include "trick/MemoryManager.hh"
 #include <sstream>
+#include <algorithm>
 #include <string.h>
 
 ALLOC_INFO* Trick::MemoryManager::get_alloc_info_of( void* addr) {
 
+    ALLOC_INFO* alloc_info = NULL ;
+    AllocIndex* index ;
+    unsigned int* readers = &alloc_index_readers[(((unsigned long)pthread_self() >> 8) % alloc_index_reader_slots) * 16] ;
+
+    /* Search the flat index when it is current.  Readers take no lock, they are counted so that
+       update_alloc_index does not free an index while it is being searched. */
+    __atomic_add_fetch(readers, 1, __ATOMIC_SEQ_CST) ;
+    index = __atomic_load_n(&alloc_index, __ATOMIC_SEQ_CST) ;
+    if ( index != NULL and index->generation == __atomic_load_n(&alloc_generation, __ATOMIC_ACQUIRE) ) {
+        // Find the block of starts from the top level, then the last start <= addr in the block.
+        size_t block = std::upper_bound(index->top.begin(), index->top.end(), (char*)addr) - index->top.begin() ;
+        if ( block > 0 ) {
+            std::vector<char*>::const_iterator first = index->starts.begin() + (block - 1) * alloc_index_stride ;
+            std::vector<char*>::const_iterator last = index->starts.end() ;
+            if ( (size_t)(last - first) > alloc_index_stride ) {
+                last = first + alloc_index_stride ;
+            }
+            size_t ii = (std::upper_bound(first, last, (char*)addr) - index->starts.begin()) - 1 ;
+            if ( (char*)addr <= index->entries[ii].end ) {
+                alloc_info = index->entries[ii].info ;
+            }
+        }
+        __atomic_sub_fetch(readers, 1, __ATOMIC_SEQ_CST) ;
+        return alloc_info ;
+    }
+    __atomic_sub_fetch(readers, 1, __ATOMIC_SEQ_CST) ;
+
     ALLOC_INFO_MAP::iterator pos = alloc_info_map.lower_bound(addr);
     if (pos != alloc_info_map.end()) {
-        ALLOC_INFO* alloc_info = pos->second;
-        if (( addr >= alloc_info->start) && ( addr <= alloc_info->end)) {
-            return(alloc_info);
+        if (( addr >= pos->second->start) && ( addr <= pos->second->end)) {
+            alloc_info = pos->second;
+        }
+    }
+
+    /* Rebuild the index once the misses have paid for it, so that interleaved declarations and
+       lookups (restoring STLs, checkpoint dependencies) do not rebuild it on every call. */
+    if ( __atomic_add_fetch(&alloc_index_misses, 1, __ATOMIC_RELAXED) > alloc_info_map.size() / 32 ) {
+        update_alloc_index() ;
+    }
+    return alloc_info ;
+}
+
+void Trick::MemoryManager::update_alloc_index() {
+
+    /* Lookups are made while mm_mutex is held by this thread, skip the update rather than deadlock. */
+    if ( pthread_mutex_trylock(&mm_mutex) != 0 ) {
+        return ;
+    }
+
+    if ( alloc_index == NULL or alloc_index->generation != alloc_generation ) {
+        AllocIndex* new_index = new AllocIndex ;
+        ALLOC_INFO_MAP::reverse_iterator rit ;
+
+        new_index->generation = alloc_generation ;
+        new_index->top.reserve(alloc_info_map.size() / alloc_index_stride + 1) ;
+        new_index->starts.reserve(alloc_info_map.size()) ;
+        new_index->entries.reserve(alloc_info_map.size()) ;
+        // alloc_info_map is sorted by descending address
+        for ( rit = alloc_info_map.rbegin() ; rit != alloc_info_map.rend() ; ++rit ) {
+            AllocIndex::Entry entry ;
+            entry.end = (char*)rit->second->end ;
+            entry.info = rit->second ;
+            if ( new_index->starts.size() % alloc_index_stride == 0 ) {
+                new_index->top.push_back((char*)rit->second->start) ;
+            }
+            new_index->starts.push_back((char*)rit->second->start) ;
+            new_index->entries.push_back(entry) ;
+        }
+        if ( alloc_index != NULL ) {
+            retired_alloc_indexes.push_back(alloc_index) ;
         }
+        __atomic_store_n(&alloc_index, new_index, __ATOMIC_SEQ_CST) ;
     }
-    return NULL;
+    __atomic_store_n(&alloc_index_misses, 0, __ATOMIC_RELAXED) ;
+
+    /* A reader that starts after the store above finds the new index.  Once no reader is counted,
+       none can still be searching a retired one. */
+    if ( ! retired_alloc_indexes.empty() ) {
+        unsigned int readers = 0 ;
+        for ( unsigned int ii = 0 ; ii < alloc_index_reader_slots ; ii++ ) {
+            readers += __atomic_load_n(&alloc_index_readers[ii * 16], __ATOMIC_SEQ_CST) ;
+        }
+        if ( readers == 0 ) {
+            for ( unsigned int ii = 0 ; ii < retired_alloc_indexes.size() ; ii++ ) {
+                delete retired_alloc_indexes[ii] ;
+            }
+            retired_alloc_indexes.clear() ;
+        }
+    }
+
+    pthread_mutex_unlock(&mm_mutex) ;
 }
 
 ALLOC_INFO* Trick::MemoryManager::get_alloc_info_at( void* addr) {
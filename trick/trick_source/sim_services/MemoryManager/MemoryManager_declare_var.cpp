@@ -182,6 +182,7 @@ void* Trick::MemoryManager::declare_var( TRICK_TYPE type,
         /** @li Insert the <address, ALLOC_INFO> key-value pair into the alloc_info_map.*/
         pthread_mutex_lock(&mm_mutex);
         alloc_info_map[address] = new_alloc;
+        alloc_generation++ ;
 
         /** @li If this is a named allocation: then insert the <variable-name, ALLOC_INFO>
             key-value pair into the variable map.*/
@@ -361,6 +362,7 @@ void* Trick::MemoryManager::declare_operatornew_var( std::string user_type_name,
         /** @li Insert the <address, ALLOC_INFO> key-value pair into the alloc_info_map.*/
         pthread_mutex_lock(&mm_mutex);
         alloc_info_map[address] = new_alloc;
+        alloc_generation++ ;
         pthread_mutex_unlock(&mm_mutex);
     } else {
         emitError("Out of memory.") ;
@@ -28,6 +28,7 @@ int Trick::MemoryManager::delete_var(void* address, bool destroy ) {
         // BEGIN PROTECTION of the alloc_info_map.
         pthread_mutex_lock(&mm_mutex);
         alloc_info_map.erase( address);
+        alloc_generation++ ;
         // END PROTECTION of the alloc_info_map.
         pthread_mutex_unlock(&mm_mutex);
 
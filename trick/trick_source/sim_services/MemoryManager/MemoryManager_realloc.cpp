@@ -177,6 +177,7 @@ void* Trick::MemoryManager::resize_array( void *address, int n_cdims, int *cdims
 
     /** @li Insert the new <address, ALLOC_INFO> key-value pair into the alloc_info_map.*/
     alloc_info_map[alloc_info->start] = alloc_info;
+    alloc_generation++ ;
     pthread_mutex_unlock(&mm_mutex);
 
     /** @li If debug is enabled, show what happened.*/
@@ -19,10 +19,6 @@ void Trick::MemoryManager::execute_checkpoint( std::ostream& out_s ) {
     int local_anon_var_number;
     int extern_anon_var_number;
 
-    // 1) Generate declaration statements for each the allocations that we are managing.
-    out_s << "// Variable Declarations." << std::endl;
-    out_s.flush();
-
     local_anon_var_number = 0;
     extern_anon_var_number = 0;
 
@@ -49,29 +45,38 @@ void Trick::MemoryManager::execute_checkpoint( std::ostream& out_s ) {
         get_stl_dependencies(alloc_info);
     }
 
-    // Write a declaration statement for all of the LOCAL variables,
     n_depends = dependencies.size();
-    for (int ii = 0 ; ii < n_depends ; ii ++) {
-        alloc_info = dependencies[ii];
-        if ( alloc_info->stcl == TRICK_LOCAL) {
-            currentCheckPointAgent->write_decl( out_s, alloc_info);
+
+    // Agents that write their own format take all of the allocations at once.
+    if ( ! currentCheckPointAgent->write_checkpoint( out_s, dependencies)) {
+
+        // 1) Generate declaration statements for each the allocations that we are managing.
+        out_s << "// Variable Declarations." << std::endl;
+        out_s.flush();
+
+        // Write a declaration statement for all of the LOCAL variables,
+        for (int ii = 0 ; ii < n_depends ; ii ++) {
+            alloc_info = dependencies[ii];
+            if ( alloc_info->stcl == TRICK_LOCAL) {
+                currentCheckPointAgent->write_decl( out_s, alloc_info);
+            }
         }
-    }
 
-    // Write a "clear_all_vars" command.
-    if (reduced_checkpoint) {
-        out_s << std::endl << std::endl << "// Clear all allocations to 0." << std::endl;
-        out_s << "clear_all_vars();" << std::endl;
-    }
+        // Write a "clear_all_vars" command.
+        if (reduced_checkpoint) {
+            out_s << std::endl << std::endl << "// Clear all allocations to 0." << std::endl;
+            out_s << "clear_all_vars();" << std::endl;
+        }
 
-    // 2) Dump the contents of each of the dynamic and mapped allocations.
-    out_s << std::endl << std::endl << "// Variable Assignments." << std::endl;
-    out_s.flush();
+        // 2) Dump the contents of each of the dynamic and mapped allocations.
+        out_s << std::endl << std::endl << "// Variable Assignments." << std::endl;
+        out_s.flush();
 
-    for (int ii = 0 ; ii < n_depends ; ii ++) {
-        alloc_info = dependencies[ii];
-        write_var( out_s, alloc_info);
-        out_s << std::endl;
+        for (int ii = 0 ; ii < n_depends ; ii ++) {
+            alloc_info = dependencies[ii];
+            write_var( out_s, alloc_info);
+            out_s << std::endl;
+        }
     }
 
     // Free all of the temporary names that were created for the checkpoint.
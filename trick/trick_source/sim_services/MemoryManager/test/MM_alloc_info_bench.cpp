@@ -0,0 +1,103 @@
+/*
+   PURPOSE: (Lookup benchmark for MemoryManager::get_alloc_info_of with many allocations.)
+
+   Declares the allocations, then counts the lookups of addresses inside random allocations
+   that 1, 2, 4 and 8 reader threads make in one second.  Compares the previous lower_bound
+   search of the allocation map with get_alloc_info_of.
+
+   usage: MM_alloc_info_bench [num_allocations]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "trick/MemoryManager.hh"
+
+/* number of reader threads in the last run */
+static const unsigned int max_readers = 8 ;
+
+static Trick::MemoryManager * memmgr ;
+static Trick::ALLOC_INFO_MAP map_copy ;
+static std::vector< double * > allocations ;
+static volatile bool stop ;
+static bool use_map ;
+
+/* The previous MemoryManager::get_alloc_info_of. */
+static ALLOC_INFO * map_lookup( void * addr ) {
+    Trick::ALLOC_INFO_MAP::iterator pos = map_copy.lower_bound(addr) ;
+    if ( pos != map_copy.end() and addr >= pos->second->start and addr <= pos->second->end ) {
+        return pos->second ;
+    }
+    return NULL ;
+}
+
+static void * reader( void * arg ) {
+    unsigned int seed = (unsigned int)(long)arg ;
+    long * count = new long(0) ;
+    while ( ! stop ) {
+        for ( unsigned int ii = 0 ; ii < 64 ; ii++ ) {
+            double * dbl = allocations[rand_r(&seed) % allocations.size()] ;
+            ALLOC_INFO * alloc_info = use_map ? map_lookup(&dbl[1]) : memmgr->get_alloc_info_of(&dbl[1]) ;
+            if ( alloc_info == NULL or alloc_info->start != dbl ) {
+                std::cerr << "lookup of " << (void *)&dbl[1] << " failed" << std::endl ;
+                abort() ;
+            }
+        }
+        *count += 64 ;
+    }
+    return count ;
+}
+
+static double run( unsigned int num_readers ) {
+    std::vector< pthread_t > threads(num_readers) ;
+    double total = 0 ;
+    stop = false ;
+    for ( unsigned int ii = 0 ; ii < num_readers ; ii++ ) {
+        pthread_create(&threads[ii], NULL, reader, (void *)(long)(ii + 1)) ;
+    }
+    sleep(1) ;
+    stop = true ;
+    for ( unsigned int ii = 0 ; ii < num_readers ; ii++ ) {
+        void * count ;
+        pthread_join(threads[ii], &count) ;
+        total += *(long *)count ;
+        delete (long *)count ;
+    }
+    return total ;
+}
+
+int main( int argc , char * argv[] ) {
+
+    unsigned int num_allocations = 1000000 ;
+    int cdims[1] = { 2 } ;
+
+    if ( argc > 1 ) {
+        num_allocations = atoi(argv[1]) ;
+    }
+
+    memmgr = new Trick::MemoryManager ;
+    for ( unsigned int ii = 0 ; ii < num_allocations ; ii++ ) {
+        allocations.push_back((double *)memmgr->declare_var(TRICK_DOUBLE, "", 0, "", 1, cdims)) ;
+    }
+    map_copy.insert(memmgr->alloc_info_map_begin(), memmgr->alloc_info_map_end()) ;
+
+    std::cout << num_allocations << " allocations" << std::endl ;
+    std::cout << std::setw(10) << "readers" << std::setw(20) << "map (lookups/s)"
+              << std::setw(24) << "alloc_index (lookups/s)" << std::endl ;
+
+    for ( unsigned int num_readers = 1 ; num_readers <= max_readers ; num_readers *= 2 ) {
+        double map_rate , index_rate ;
+        use_map = true ;
+        map_rate = run(num_readers) ;
+        use_map = false ;
+        index_rate = run(num_readers) ;
+        std::cout << std::setw(10) << num_readers << std::fixed << std::setprecision(0)
+                  << std::setw(20) << map_rate << std::setw(24) << index_rate << std::endl ;
+    }
+
+    return 0 ;
+}
@@ -0,0 +1,164 @@
+
+#include "gtest/gtest.h"
+#include "MM_test.hh"
+#include "MM_write_checkpoint.hh"
+#include "trick/BinaryCheckPointAgent.hh"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+/*
+ This tests writing and restoring checkpoints with the BinaryCheckPointAgent.
+ */
+class MM_binary_checkpoint : public ::testing::Test {
+
+        protected:
+                Trick::MemoryManager *memmgr;
+                Trick::BinaryCheckPointAgent *agent;
+                MM_binary_checkpoint() {
+                        memmgr = new Trick::MemoryManager;
+                        agent = new Trick::BinaryCheckPointAgent(memmgr);
+                        memmgr->set_CheckPointAgent(agent);
+                }
+                ~MM_binary_checkpoint() {
+                        memmgr->reset_CheckPointAgent();
+                        delete agent;
+                        delete memmgr;
+                }
+                void SetUp() {}
+                void TearDown() {}
+
+                void * address_of( const char * name ) {
+                        REF2 * ref = memmgr->ref_attributes(name);
+                        void * address = NULL;
+                        if ( ref != NULL ) {
+                                address = ref->address;
+                                free(ref);
+                        }
+                        return address;
+                }
+};
+
+static long file_size( const char * file_name ) {
+    struct stat buf;
+    if ( stat(file_name, &buf) != 0 ) {
+        return -1;
+    }
+    return (long)buf.st_size;
+}
+
+// ================================================================================
+TEST_F(MM_binary_checkpoint, round_trip) {
+
+    std::stringstream ss;
+
+    UDT1 *udt1_p = (UDT1*)memmgr->declare_var("UDT1 udt1");
+    UDT1 *udt2_p = (UDT1*)memmgr->declare_var("UDT1 udt2");
+    double *dbl_p = (double*)memmgr->declare_var("double dbls[3]");
+    std::string *string_p = (std::string*)memmgr->declare_var("std::string str");
+
+    udt1_p->x = 3.1415;
+    udt1_p->udt_p = udt2_p;
+    udt1_p->dbl_p = &dbl_p[2];
+    udt2_p->x = 2.7183;
+    udt2_p->udt_p = udt2_p;
+    dbl_p[0] = 1.0;
+    dbl_p[1] = 2.0;
+    dbl_p[2] = 3.0;
+    *string_p = "binary_checkpoint_test";
+
+    memmgr->write_checkpoint(ss);
+
+    memmgr->init_from_checkpoint(&ss);
+
+    udt1_p = (UDT1*)address_of("udt1");
+    udt2_p = (UDT1*)address_of("udt2");
+    dbl_p = (double*)address_of("dbls");
+    string_p = (std::string*)address_of("str");
+
+    ASSERT_TRUE(udt1_p != NULL);
+    ASSERT_TRUE(udt2_p != NULL);
+    ASSERT_TRUE(dbl_p != NULL);
+    ASSERT_TRUE(string_p != NULL);
+
+    EXPECT_EQ(udt1_p->x, 3.1415);
+    EXPECT_EQ(udt1_p->udt_p, udt2_p);
+    EXPECT_EQ(udt1_p->dbl_p, &dbl_p[2]);
+    EXPECT_TRUE(udt1_p->month_p == NULL);
+    EXPECT_EQ(udt2_p->x, 2.7183);
+    EXPECT_EQ(udt2_p->udt_p, udt2_p);
+    EXPECT_EQ(dbl_p[0], 1.0);
+    EXPECT_EQ(dbl_p[1], 2.0);
+    EXPECT_EQ(dbl_p[2], 3.0);
+    EXPECT_EQ(*string_p, "binary_checkpoint_test");
+}
+
+// ================================================================================
+TEST_F(MM_binary_checkpoint, incremental) {
+
+    double *big_p = (double*)memmgr->declare_var("double big[1000]");
+    double *small_p = (double*)memmgr->declare_var("double small[2]");
+
+    for (int ii = 0 ; ii < 1000 ; ii++ ) {
+        big_p[ii] = ii;
+    }
+    small_p[0] = 1.0;
+    small_p[1] = 2.0;
+
+    agent->set_incremental(true);
+    agent->set_file_name("bin_chkpnt_1");
+    memmgr->write_checkpoint("bin_chkpnt_1");
+
+    small_p[1] = 20.0;
+    agent->set_file_name("bin_chkpnt_2");
+    memmgr->write_checkpoint("bin_chkpnt_2");
+
+    // The unchanged array is only in the first checkpoint.
+    EXPECT_GT(file_size("bin_chkpnt_1"), (long)(1000 * sizeof(double)));
+    EXPECT_LT(file_size("bin_chkpnt_2"), (long)(1000 * sizeof(double)));
+    EXPECT_TRUE(Trick::BinaryCheckPointAgent::is_binary_checkpoint("bin_chkpnt_2"));
+
+    big_p[500] = -1.0;
+    small_p[0] = -1.0;
+
+    agent->set_file_name("bin_chkpnt_2");
+    memmgr->init_from_checkpoint("bin_chkpnt_2");
+
+    big_p = (double*)address_of("big");
+    small_p = (double*)address_of("small");
+
+    ASSERT_TRUE(big_p != NULL);
+    ASSERT_TRUE(small_p != NULL);
+    EXPECT_EQ(big_p[500], 500.0);
+    EXPECT_EQ(small_p[0], 1.0);
+    EXPECT_EQ(small_p[1], 20.0);
+}
+
+// ================================================================================
+TEST_F(MM_binary_checkpoint, convert_to_classic) {
+
+    std::stringstream classic_ss;
+    std::stringstream converted_ss;
+
+    UDT1 *udt1_p = (UDT1*)memmgr->declare_var("UDT1 udt1");
+    double *dbl_p = (double*)memmgr->declare_var("double dbl1");
+
+    udt1_p->x = 3.1415;
+    udt1_p->udt_p = udt1_p;
+    udt1_p->dbl_p = dbl_p;
+    *dbl_p = 2.0;
+
+    memmgr->write_checkpoint("bin_chkpnt_convert");
+
+    EXPECT_EQ(agent->write_classic_checkpoint("bin_chkpnt_convert", "classic_chkpnt_convert"), 0);
+
+    memmgr->reset_CheckPointAgent();
+    memmgr->write_checkpoint(classic_ss);
+    memmgr->set_CheckPointAgent(agent);
+
+    std::ifstream converted("classic_chkpnt_convert");
+    converted_ss << converted.rdbuf();
+
+    EXPECT_EQ(converted_ss.str(), classic_ss.str());
+}
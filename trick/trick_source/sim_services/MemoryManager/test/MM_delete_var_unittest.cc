@@ -167,3 +167,34 @@ TEST_F(MM_delete_var_unittest, externByName) {
 }
 
 
+TEST_F(MM_delete_var_unittest, alloc_info_of_after_delete) {
+
+    std::vector<double*> dbls;
+
+    for (int ii = 0 ; ii < 1000 ; ii++ ) {
+        dbls.push_back((double*)memmgr->declare_var("double", 4));
+    }
+
+    // Enough lookups to search the sorted index instead of the allocation map.
+    for (int jj = 0 ; jj < 2 ; jj++ ) {
+        for (int ii = 0 ; ii < 1000 ; ii++ ) {
+            ALLOC_INFO * alloc_info = memmgr->get_alloc_info_of(&dbls[ii][3]);
+            ASSERT_TRUE(alloc_info != NULL);
+            EXPECT_EQ(dbls[ii], alloc_info->start);
+        }
+    }
+
+    // A deleted allocation is not found right after the delete.
+    memmgr->delete_var(dbls[500]);
+    EXPECT_TRUE(memmgr->get_alloc_info_of(dbls[500]) == NULL);
+    for (int ii = 0 ; ii < 1000 ; ii++ ) {
+        if ( ii != 500 ) {
+            EXPECT_EQ(dbls[ii], memmgr->get_alloc_info_of(&dbls[ii][1])->start);
+        }
+    }
+    EXPECT_TRUE(memmgr->get_alloc_info_of(dbls[500]) == NULL);
+
+    // Nor is an address past the end of an allocation.
+    ALLOC_INFO * alloc_info = memmgr->get_alloc_info_of(dbls[0]);
+    EXPECT_TRUE(memmgr->get_alloc_info_of((char*)alloc_info->end + 1) != alloc_info);
+}
@@ -22,6 +22,7 @@ Trick::MessagePublisher::MessagePublisher() {
 
     tics_per_sec = 1000000 ;
     set_print_format() ;
+    pthread_mutex_init(&publish_mutex, NULL) ;
 
 }
 
@@ -58,6 +59,7 @@ int Trick::MessagePublisher::publish(int level , std::string message) {
     header = header_buf ;
 
     /** @li Go through all its subscribers and send a message update to the subscriber that is enabled. */
+    pthread_mutex_lock(&publish_mutex) ;
     if ( ! subscribers.empty() ) {
         for ( p = subscribers.begin() ; p != subscribers.end() ; p++ ) {
             if ( (*p)->enabled ) {
@@ -71,7 +73,10 @@ int Trick::MessagePublisher::publish(int level , std::string message) {
         // multithreaded sims from interleaving header and message elements.
         std::ostringstream oss;
         oss << header << message ;
-        std::cout << oss.str() << std::flush ; } return(0) ;
+        std::cout << oss.str() << std::flush ; }
+    pthread_mutex_unlock(&publish_mutex) ;
+
+    return(0) ;
 
 }
 
@@ -11,6 +11,7 @@ Trick::MonteCarlo::MonteCarlo() :
     timeout(120),
     max_tries(2),
     verbosity(INFORMATIONAL),
+    batch_size(0),
     num_runs(0),
     actual_num_runs(0),
     num_results(0),
@@ -27,6 +28,8 @@ Trick::MonteCarlo::MonteCarlo() :
 
     memset(&listen_device, 0, sizeof(TCDevice)) ;
     memset(&connection_device, 0, sizeof(TCDevice)) ;
+    memset(&batch_device, 0, sizeof(TCDevice)) ;
+    batch_device.socket = TRICKCOMM_INVALID_SOCKET ;
 
     listen_device.port = 0;
     connection_device.port = 0;
@@ -91,6 +91,19 @@ extern "C" unsigned int mc_get_max_tries() {
     return 0 ;
 }
 
+extern "C" void mc_set_batch_size(unsigned int batch_size) {
+    if ( the_mc != NULL ) {
+        the_mc->set_batch_size(batch_size);
+    }
+}
+
+extern "C" unsigned int mc_get_batch_size() {
+    if ( the_mc != NULL ) {
+        return the_mc->get_batch_size();
+    }
+    return 0 ;
+}
+
 extern "C" void mc_set_user_cmd_string(const char *user_cmd_string) {
     if ( the_mc != NULL ) {
         the_mc->set_user_cmd_string(std::string(user_cmd_string ? user_cmd_string : ""));
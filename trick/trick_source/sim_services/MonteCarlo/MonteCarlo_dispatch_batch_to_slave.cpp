@@ -0,0 +1,159 @@
+
+#include <algorithm>
+#include <sys/time.h>
+
+#include "trick/MonteCarlo.hh"
+#include "trick/tc_proto.h"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+
+static void append_int(std::string &buffer, int value) {
+    value = htonl(value);
+    buffer.append((char *)&value, sizeof(value));
+}
+
+static void append_string(std::string &buffer, const std::string &value) {
+    append_int(buffer, value.length());
+    buffer += value;
+}
+
+/** @par Detailed Design: */
+void Trick::MonteCarlo::dispatch_batch_to_slave(MonteSlave *slave) {
+    if (!slave) {
+        return;
+    }
+
+    /** <ul><li> Prepare up to #batch_size runs. */
+    std::vector<MonteRun *> batch;
+    MonteRun *run;
+    bool reduced_num_runs = false;
+    while (batch.size() < batch_size && (run = get_next_dispatch()) != NULL) {
+        if (prepare_run(run) == -1) {
+            reduced_num_runs = true;
+            break;
+        }
+        batch.push_back(run);
+        ++run->num_tries;
+    }
+    if (batch.empty()) {
+        return;
+    }
+
+    /** <li> Open the slave's batch connection if it is not open yet. */
+    if (slave->batch_device.socket == TRICKCOMM_INVALID_SOCKET) {
+        tc_dev_copy(&slave->batch_device, &connection_device);
+        slave->batch_device.hostname = (char*)slave->machine_name.c_str();
+        slave->batch_device.port = slave->port;
+        if (tc_connect(&slave->batch_device) != TC_SUCCESS) {
+            slave->batch_device.socket = TRICKCOMM_INVALID_SOCKET;
+        }
+    }
+
+    /** <li> Send the batch in a single write. */
+    std::string buffer;
+    pack_batch(batch, buffer);
+    std::string message;
+    append_int(message, MonteSlave::PROCESS_BATCH);
+    append_int(message, buffer.length());
+    message += buffer;
+
+    if (slave->batch_device.socket == TRICKCOMM_INVALID_SOCKET ||
+        tc_write(&slave->batch_device, (char *)message.c_str(), (int)message.length()) != (int)message.length()) {
+        /**
+         * <li> If the slave cannot be reached, put the runs back at the front of the queue. Their values were already
+         * drawn, so they are sent again as they are.
+         */
+        if (slave->batch_device.socket != TRICKCOMM_INVALID_SOCKET) {
+            tc_disconnect(&slave->batch_device);
+        }
+        slave->state = Trick::MonteSlave::DISCONNECTED;
+        if (verbosity >= ERROR) {
+            message_publish(MSG_ERROR, "Monte [Master] Failed to connect to %s:%d to dispatch run.\n",
+                            slave->machine_name.c_str(), slave->id) ;
+        }
+        runs.insert(runs.begin(), batch.begin(), batch.end());
+        if (reduced_num_runs) {
+            update_actual_num_runs();
+        }
+        return;
+    }
+
+    if (verbosity >= INFORMATIONAL) {
+        message_publish(MSG_INFO, "Monte [Master] Dispatching runs %d to %d to %s:%d.\n",
+             batch.front()->id, batch.back()->id, slave->machine_name.c_str(), slave->id) ;
+    }
+
+    /**
+     * <li> Update the bookkeeping. The first run of the batch becomes the slave's current run. The slave reports the
+     * runs in order, and each following run starts when the previous one is reported.
+     */
+    struct timeval time_val;
+    gettimeofday(&time_val, NULL);
+    slave->state = MonteSlave::RUNNING;
+    slave->num_dispatches += batch.size();
+    slave->current_run = batch.front();
+    slave->current_run->start_time = time_val.tv_sec + (double)time_val.tv_usec / 1000000;
+    slave->batch_runs.assign(batch.begin() + 1, batch.end());
+
+    /** <li> A file variable that reached end-of-file reduced the number of runs. Count the runs of this batch. </ul> */
+    if (reduced_num_runs) {
+        update_actual_num_runs();
+    }
+}
+
+/**
+ * @par Detailed Design:
+ * See #unpack_batch for the message layout. The raw values are sent so the slave can assign them without the input
+ * processor.
+ */
+void Trick::MonteCarlo::pack_batch(std::vector<MonteRun *> &batch, std::string &buffer) {
+    append_int(buffer, variables.size());
+    for (std::vector<MonteVar *>::size_type i = 0; i < variables.size(); ++i) {
+        append_string(buffer, variables[i]->name);
+        append_string(buffer, variables[i]->unit);
+    }
+    append_string(buffer, run_directory);
+    append_int(buffer, batch.size());
+    for (std::vector<MonteRun *>::size_type i = 0; i < batch.size(); ++i) {
+        append_int(buffer, batch[i]->id);
+        for (std::vector<MonteVar *>::size_type j = 0; j < variables.size(); ++j) {
+            append_string(buffer, j < batch[i]->values.size() ? batch[i]->values[j] : std::string());
+        }
+    }
+}
+
+/** @par Detailed Design: */
+bool Trick::MonteCarlo::next_batch_run(MonteSlave &slave) {
+    if (slave.batch_runs.empty()) {
+        return false;
+    }
+    /** <ul><li> Make the next run of the batch current and start its clock. */
+    struct timeval time_val;
+    gettimeofday(&time_val, NULL);
+    slave.current_run = slave.batch_runs.front();
+    slave.batch_runs.pop_front();
+    slave.current_run->start_time = time_val.tv_sec + (double)time_val.tv_usec / 1000000;
+
+    /** <li> The slave is responsive again if it timed out on the previous run. </ul> */
+    if (slave.state == MonteSlave::UNRESPONSIVE_RUNNING) {
+        slave.state = MonteSlave::RUNNING;
+    } else if (slave.state == MonteSlave::UNRESPONSIVE_STOPPING) {
+        slave.state = MonteSlave::STOPPING;
+    }
+    return true;
+}
+
+/**
+ * @par Detailed Design:
+ * The runs stay in MonteSlave::batch_runs. If the slave reports them after all, the results are kept and the
+ * requeued copies are removed or discarded as for any run that timed out.
+ */
+void Trick::MonteCarlo::requeue_batch_runs(MonteSlave &slave) {
+    for (std::deque<MonteRun *>::size_type i = 0; i < slave.batch_runs.size(); ++i) {
+        MonteRun *run = slave.batch_runs[i];
+        if (run->exit_status == MonteRun::INCOMPLETE &&
+            std::find(runs.begin(), runs.end(), run) == runs.end()) {
+            runs.push_back(run);
+        }
+    }
+}
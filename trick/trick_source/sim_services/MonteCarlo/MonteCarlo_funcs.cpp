@@ -103,6 +103,14 @@ Trick::MonteCarlo::Verbosity Trick::MonteCarlo::get_verbosity() {
     return verbosity;
 }
 
+void Trick::MonteCarlo::set_batch_size(unsigned int in_batch_size) {
+    this->batch_size = in_batch_size;
+}
+
+unsigned int Trick::MonteCarlo::get_batch_size() {
+    return batch_size;
+}
+
 void Trick::MonteCarlo::set_num_runs(unsigned int in_num_runs) {
     while (this->num_runs < in_num_runs) {
         runs.push_back(new Trick::MonteRun(this->num_runs++));
@@ -285,6 +293,10 @@ int Trick::MonteCarlo::shutdown() {
             }
             int id = htonl(slave_id);
             tc_write(&connection_device, (char*)&id, (int)sizeof(id));
+            if (batch_size > 0) {
+                id = htonl(current_run);
+                tc_write(&connection_device, (char*)&id, (int)sizeof(id));
+            }
             exit_status = htonl(exit_status);
             tc_write(&connection_device, (char*)&exit_status, (int)sizeof(exit_status));
             run_queue(&slave_post_queue, "in slave_post queue");
@@ -359,6 +371,8 @@ void Trick::MonteCarlo::check_timeouts() {
                 }
                 handle_retry(*slaves[i], MonteRun::TIMEDOUT);
             }
+            /** <li> Requeue the rest of the slave's batch in case the slave is gone. */
+            requeue_batch_runs(*slaves[i]);
             /** </ul><li> Update the slave's state. */
             slaves[i]->state = slaves[i]->state == MonteSlave::RUNNING ?
                MonteSlave::UNRESPONSIVE_RUNNING : MonteSlave::UNRESPONSIVE_STOPPING;
@@ -421,6 +435,7 @@ int  Trick::MonteCarlo::prepare_run(MonteRun *curr_run) {
         /** <li> Add the variables to the curr_run and check for end of file and value generation failures. */
         for (std::vector<std::string>::size_type i = 0; i < variables.size(); ++i) {
             curr_run->variables.push_back(variables[i]->get_next_value());
+            curr_run->values.push_back(variables[i]->value);
             if (curr_run->variables.back() == "EOF") {
                 if (verbosity >= ALL) {
                     message_publish(MSG_WARNING, "Monte [Master] File variable '%s' reached end-of-file. Reducing number of runs to %d.\n",
@@ -482,10 +497,11 @@ void Trick::MonteCarlo::update_actual_num_runs() {
             ++actual_num_runs;
         }
     }
-    /** <li> Add one for every currently dispatched run. */
+    /** <li> Add one for every currently dispatched run and the runs waiting behind it in a batch. */
     for (std::vector<MonteSlave *>::size_type i = 0; i < slaves.size(); ++i) {
         if (slaves[i]->state == MonteSlave::RUNNING || slaves[i]->state == MonteSlave::STOPPING) {
             ++actual_num_runs;
+            actual_num_runs += slaves[i]->batch_runs.size();
         }
     }
 }
@@ -31,8 +31,12 @@ int Trick::MonteCarlo::master() {
             /** <li> Check to see if any dispatched units have timed out. */
             check_timeouts();
 
-            /** <li> Dispatch the next run to a ready slave. </ul> */
-            dispatch_run_to_slave(get_next_dispatch(), get_ready_slave());
+            /** <li> Dispatch the next run, or the next batch of runs, to a ready slave. </ul> */
+            if (batch_size > 0) {
+                dispatch_batch_to_slave(get_ready_slave());
+            } else {
+                dispatch_run_to_slave(get_next_dispatch(), get_ready_slave());
+            }
         }
     } catch (Trick::ExecutiveException & ex ) {
 
@@ -53,6 +53,12 @@ void Trick::MonteCarlo::shutdown_slaves() {
 
     for (std::vector<MonteSlave *>::size_type i = 0; i < slaves.size() ; ++i) {
         slaves[i]->state = MonteSlave::FINISHED;
+        if (slaves[i]->batch_device.socket != TRICKCOMM_INVALID_SOCKET) {
+            int command = htonl(MonteSlave::SHUTDOWN);
+            tc_write(&slaves[i]->batch_device, (char*)&command, sizeof(command));
+            tc_disconnect(&slaves[i]->batch_device);
+            continue;
+        }
         connection_device.hostname = (char*)slaves[i]->machine_name.c_str();
         connection_device.port = slaves[i]->port;
         if (tc_connect(&connection_device) == TC_SUCCESS) {
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "trick/MonteCarlo.hh"
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
@@ -75,13 +77,44 @@ void Trick::MonteCarlo::handle_initialization(Trick::MonteSlave& slave) {
 }
 
 void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
+    /** <ul><li> When running batches, read the run id and make that run the slave's current run. */
+    if (batch_size > 0) {
+        int run_id;
+        if (tc_read(&connection_device, (char*)&run_id, (int)sizeof(run_id)) != (int)sizeof(run_id)) {
+            set_disconnected_state(slave);
+            return;
+        }
+        run_id = ntohl(run_id);
+        bool in_batch = slave.current_run && slave.current_run->id == (unsigned int)run_id;
+        for (std::deque<MonteRun *>::size_type i = 0; i < slave.batch_runs.size(); ++i) {
+            in_batch = in_batch || slave.batch_runs[i]->id == (unsigned int)run_id;
+        }
+        /** <ul><li> Discard a late report for a run that was already reported, such as a crash in the post run jobs. */
+        if (!in_batch) {
+            if (verbosity >= ALL) {
+                message_publish(MSG_INFO, "Monte [Master] Discarding late results for run %d from %s:%d.\n",
+                     run_id, slave.machine_name.c_str(), slave.id) ;
+            }
+            tc_disconnect(&connection_device);
+            return;
+        }
+        /** <li> Retry the runs of the batch before this one, the slave did not report them. </ul> */
+        while (slave.current_run->id != (unsigned int)run_id) {
+            if (slave.current_run->exit_status == MonteRun::INCOMPLETE &&
+                std::find(runs.begin(), runs.end(), slave.current_run) == runs.end()) {
+                handle_retry(slave, MonteRun::UNKNOWN);
+            }
+            next_batch_run(slave);
+        }
+    }
+
     if (verbosity >= INFORMATIONAL) {
         message_publish(MSG_INFO, "Monte [Master] Receiving results for run %d from %s:%d.\n",
              slave.current_run->id, slave.machine_name.c_str(), slave.id) ;
     }
 
     /**
-     * <ul><li> Try to remove this run from the queue in case it was requeue by #check_timeouts.
+     * <li> Try to remove this run from the queue in case it was requeue by #check_timeouts.
      * This covers the case in which the master determines that a slave has timed out, requeues
      * the run, and then the slave reports results.
      */
@@ -104,6 +137,13 @@ void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
               slave.current_run->id) ;
         }
         tc_disconnect(&connection_device);
+        if (batch_size > 0 && !next_batch_run(slave)) {
+            if (slave.state == MonteSlave::RUNNING || slave.state == MonteSlave::UNRESPONSIVE_RUNNING) {
+                slave.state = MonteSlave::READY;
+            } else if (slave.state == MonteSlave::STOPPING || slave.state == MonteSlave::UNRESPONSIVE_STOPPING) {
+                slave.state = MonteSlave::STOPPED;
+            }
+        }
         return;
     }
 
@@ -185,7 +225,10 @@ void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
 
     tc_disconnect(&connection_device);
 
-    /** <li> Update the slave's state. */
+    /** <li> Update the slave's state. A slave with runs left in its batch keeps running. */
+    if (batch_size > 0 && next_batch_run(slave)) {
+        return;
+    }
     if (slave.state == MonteSlave::RUNNING || slave.state == MonteSlave::UNRESPONSIVE_RUNNING) {
         slave.state = MonteSlave::READY;
     } else if (slave.state == MonteSlave::STOPPING || slave.state == MonteSlave::UNRESPONSIVE_STOPPING) {
@@ -193,6 +236,10 @@ void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
     }
 }
 
+/**
+ * @par Detailed Design:
+ * The slave will not report the rest of its batch, so those runs are requeued as when the slave times out.
+ */
 void Trick::MonteCarlo::set_disconnected_state(Trick::MonteSlave& slave) {
     slave.state = Trick::MonteSlave::DISCONNECTED;
     if (verbosity >= ERROR) {
@@ -200,4 +247,5 @@ void Trick::MonteCarlo::set_disconnected_state(Trick::MonteSlave& slave) {
                         slave.machine_name.c_str(), slave.id) ;
     }
     tc_disconnect(&connection_device);
+    requeue_batch_runs(slave);
 }
@@ -13,16 +13,23 @@ int Trick::MonteCarlo::execute_as_slave() {
             message_publish(MSG_INFO, "Monte [%s:%d] Waiting for new run.\n",
                             machine_name.c_str(), slave_id) ;
         }
-        /** <ul><li> On a blocking read, wait for a MonteSlave::Command from the master. */
-        if (tc_accept(&listen_device, &connection_device) != TC_SUCCESS) {
-            if (verbosity >= ERROR) {
-                message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master. Shutting down.\n",
-                                machine_name.c_str(), slave_id) ;
+        /**
+         * <ul><li> On a blocking read, wait for a MonteSlave::Command from the master. Commands arrive on a new
+         * connection unless the master has opened the #batch_device connection by sending a batch.
+         */
+        TCDevice *command_device = &batch_device;
+        if (batch_device.socket == TRICKCOMM_INVALID_SOCKET) {
+            command_device = &connection_device;
+            if (tc_accept(&listen_device, &connection_device) != TC_SUCCESS) {
+                if (verbosity >= ERROR) {
+                    message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master. Shutting down.\n",
+                                    machine_name.c_str(), slave_id) ;
+                }
+                slave_shutdown();
             }
-            slave_shutdown();
         }
         int command;
-        if (tc_read(&connection_device, (char *)&command, (int)sizeof(command)) != (int)sizeof(command)) {
+        if (tc_read(command_device, (char *)&command, (int)sizeof(command)) != (int)sizeof(command)) {
             if (verbosity >= ERROR) {
                 message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master while receiving instructions. Shutting down.\n",
                                 machine_name.c_str(), slave_id) ;
@@ -41,6 +48,16 @@ int Trick::MonteCarlo::execute_as_slave() {
                     return return_value;
                 }
                 break;
+            case MonteSlave::PROCESS_BATCH:
+                /**
+                 * <li> MonteSlave::PROCESS_BATCH: Call #slave_process_batch. This will return a non-zero value when run
+                 * in a child process to indicate that this function should return so that the sim can complete.
+                 */
+                return_value = slave_process_batch();
+                if (return_value != 0) {
+                    return return_value;
+                }
+                break;
             case MonteSlave::SHUTDOWN:
                 /** <li> MonteSlave::SHUTDOWN: Call #slave_shutdown. */
                 if (verbosity >= INFORMATIONAL) {
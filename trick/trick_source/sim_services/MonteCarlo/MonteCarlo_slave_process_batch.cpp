@@ -0,0 +1,256 @@
+
+#include <iomanip>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "trick/MonteCarlo.hh"
+#include "trick/command_line_protos.h"
+#include "trick/input_processor_proto.h"
+#include "trick/memorymanager_c_intf.h"
+#include "trick/map_trick_units_to_udunits.hh"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+#include "trick/tc_proto.h"
+
+static bool read_int(const char *buffer, int size, int &offset, int &value) {
+    if (offset + (int)sizeof(value) > size) {
+        return false;
+    }
+    memcpy(&value, buffer + offset, sizeof(value));
+    value = ntohl(value);
+    offset += sizeof(value);
+    return true;
+}
+
+static bool read_string(const char *buffer, int size, int &offset, std::string &value) {
+    int length;
+    if (!read_int(buffer, size, offset, length) || length < 0 || offset + length > size) {
+        return false;
+    }
+    value.assign(buffer + offset, length);
+    offset += length;
+    return true;
+}
+
+/** @par Detailed Design: */
+int Trick::MonteCarlo::slave_process_batch() {
+
+    /**
+     * <ul><li> Keep the connection over which the batch arrived. The master sends the following commands over it
+     * instead of connecting for each command.
+     */
+    if (batch_device.socket == TRICKCOMM_INVALID_SOCKET) {
+        tc_dev_copy(&batch_device, &connection_device);
+        connection_device.socket = TRICKCOMM_INVALID_SOCKET;
+    }
+
+    /** <li> Read the length of the incoming message and the message. */
+    int size;
+    if (tc_read(&batch_device, (char *)&size, (int)sizeof(size)) != (int)sizeof(size) || (size = ntohl(size)) < 0) {
+        if (verbosity >= ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master while receiving new batch.\nShutting down.\n",
+                            machine_name.c_str(), slave_id) ;
+        }
+        slave_shutdown();
+    }
+    std::vector<char> buffer(size + 1);
+    if (tc_read(&batch_device, &buffer[0], size) != size) {
+        if (verbosity >= ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master while receiving new batch.\nShutting down.\n",
+                            machine_name.c_str(), slave_id) ;
+        }
+        slave_shutdown();
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::string> units;
+    std::vector<MonteRun *> batch;
+    if (unpack_batch(&buffer[0], size, names, units, batch) != 0) {
+        if (verbosity >= ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Received a malformed batch from Master.\nShutting down.\n",
+                            machine_name.c_str(), slave_id) ;
+        }
+        slave_shutdown();
+    }
+
+    /**
+     * <li> For each run of the batch, fork() a child process to execute the simulation. The runs are executed one
+     * at a time so that each run is reported before the next one starts.
+     */
+    for (std::vector<MonteRun *>::size_type i = 0; i < batch.size(); ++i) {
+        MonteRun *run = batch[i];
+        pid_t pid = fork();
+        if (pid == -1) {
+            if (verbosity >= ERROR) {
+                message_publish(MSG_ERROR, "Monte [%s:%d] Unable to fork new process for run.\nShutting down.\n",
+                                machine_name.c_str(), slave_id) ;
+            }
+            slave_shutdown();
+        /** <ul><li> Parent process: wait for the child to finish. */
+        } else if (pid != 0) {
+            slave_wait_for_run(pid, run->id);
+        /** <li> Child process: */
+        } else {
+            /**
+             * <ul><li> Close the child's copy of the batch connection. The connection stays open in the parent, so
+             * it must not be shut down.
+             */
+            close(batch_device.socket);
+            batch_device.socket = TRICKCOMM_INVALID_SOCKET;
+
+            std::stringstream output_dir;
+            output_dir << run_directory << "/RUN_" << std::setw(5) << std::setfill('0') << run->id;
+            set_output_dir(output_dir.str().c_str());
+            current_run = run->id;
+
+            /**
+             * <li> Assign the variables through the memory manager. Values the memory manager cannot assign, such
+             * as expressions, are given to the input processor.
+             */
+            std::string input;
+            std::string python;
+            for (std::vector<std::string>::size_type j = 0; j < names.size(); ++j) {
+                std::string line = names[j] + " = " + run->values[j];
+                if (!units[j].empty()) {
+                    line = names[j] + " = trick.attach_units(\"" + units[j] + "\", " + run->values[j] + ")";
+                }
+                input += line + "\n";
+                if (!assign_variable(names[j], units[j], run->values[j])) {
+                    python += line + "\n";
+                }
+            }
+            input += std::string("trick.set_output_dir(\"") + output_dir.str() + std::string("\")\n");
+            output_dir.str("");
+            output_dir << run->id;
+            input += std::string("trick.mc_set_current_run(") + output_dir.str() + std::string(")\n");
+
+            for (std::vector<MonteRun *>::size_type j = 0; j < batch.size(); ++j) {
+                delete batch[j];
+            }
+
+            if (!python.empty() && ip_parse(python.c_str()) != 0) {
+                exit(MonteRun::BAD_INPUT);
+            }
+
+            /** <li> Start the run. </ul> */
+            slave_start_run(input);
+
+            /**
+             * <li> Return a non-zero result so the calling function (#slave)
+             * will return, allowing the slave sim to complete. </ul>
+             */
+            return 1;
+        }
+    }
+
+    for (std::vector<MonteRun *>::size_type i = 0; i < batch.size(); ++i) {
+        delete batch[i];
+    }
+    return 0;
+}
+
+/**
+ * @par Detailed Design:
+ * The message holds the number of variables, the name and units of each variable, the run directory, the number of
+ * runs, and for each run its id and the value of each variable. Integers are in network byte order. Strings are an
+ * integer length followed by the characters.
+ */
+int Trick::MonteCarlo::unpack_batch(const char *buffer, int size, std::vector<std::string> &names,
+                                    std::vector<std::string> &units, std::vector<MonteRun *> &batch) {
+    int offset = 0;
+    int num_variables;
+    int num_batch_runs;
+
+    if (!read_int(buffer, size, offset, num_variables) || num_variables < 0) {
+        return -1;
+    }
+    names.resize(num_variables);
+    units.resize(num_variables);
+    for (int i = 0; i < num_variables; ++i) {
+        if (!read_string(buffer, size, offset, names[i]) || !read_string(buffer, size, offset, units[i])) {
+            return -1;
+        }
+    }
+    if (!read_string(buffer, size, offset, run_directory) ||
+        !read_int(buffer, size, offset, num_batch_runs) || num_batch_runs < 0) {
+        return -1;
+    }
+    for (int i = 0; i < num_batch_runs; ++i) {
+        int id;
+        if (!read_int(buffer, size, offset, id)) {
+            return -1;
+        }
+        MonteRun *run = new MonteRun(id);
+        batch.push_back(run);
+        run->values.resize(num_variables);
+        for (int j = 0; j < num_variables; ++j) {
+            if (!read_string(buffer, size, offset, run->values[j])) {
+                return -1;
+            }
+        }
+    }
+    return offset == size ? 0 : -1;
+}
+
+/**
+ * @par Detailed Design:
+ * Only a number assigned to a single, input-enabled variable of a numeric type is assigned here.
+ */
+bool Trick::MonteCarlo::assign_variable(const std::string &name, const std::string &unit, const std::string &value) {
+    const char *text = value.c_str();
+    char *end;
+
+    /** <ul><li> The value must be a number. Integer values are assigned as integers to keep their full precision. */
+    V_DATA v_data;
+    v_data.value.ll = strtoll(text, &end, 10);
+    v_data.type = TRICK_LONG_LONG;
+    if (end == text || *end != '\0') {
+        v_data.value.d = strtod(text, &end);
+        v_data.type = TRICK_DOUBLE;
+        if (end == text || *end != '\0') {
+            return false;
+        }
+    }
+
+    /** <li> Look up the variable and check that it is a single input-enabled number. */
+    REF2 *ref = ref_attributes((char *)name.c_str());
+    if (ref == NULL) {
+        return false;
+    }
+    bool assigned = false;
+    switch (ref->attr->type) {
+        case TRICK_CHARACTER:
+        case TRICK_UNSIGNED_CHARACTER:
+        case TRICK_SHORT:
+        case TRICK_UNSIGNED_SHORT:
+        case TRICK_INTEGER:
+        case TRICK_UNSIGNED_INTEGER:
+        case TRICK_LONG:
+        case TRICK_UNSIGNED_LONG:
+        case TRICK_FLOAT:
+        case TRICK_DOUBLE:
+        case TRICK_LONG_LONG:
+        case TRICK_UNSIGNED_LONG_LONG:
+        case TRICK_BOOLEAN:
+            if ((ref->attr->io & TRICK_VAR_INPUT) && ref->num_index == ref->attr->num_index) {
+                /** <li> Assign the value, converting it from its units. </ul> */
+                V_TREE v_tree;
+                memset(&v_tree, 0, sizeof(V_TREE));
+                v_tree.v_data = &v_data;
+                std::string udunits;
+                if (!unit.empty()) {
+                    udunits = map_trick_units_to_udunits(unit);
+                    ref->units = (char *)udunits.c_str();
+                }
+                assigned = ref_assignment(ref, &v_tree) == 0;
+                ref->units = NULL;
+            }
+            break;
+        default:
+            break;
+    }
+    ref_free(ref);
+    free(ref);
+    return assigned;
+}
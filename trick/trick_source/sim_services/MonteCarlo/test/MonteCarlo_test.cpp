@@ -7,6 +7,11 @@
 #include <string>
 #include <sstream>
 #include <cmath>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 
 #include "gtest/gtest.h"
 #include "trick/ExecutiveException.hh"
@@ -24,6 +29,7 @@
 #include "trick/MemoryManager.hh"
 #include "trick/memorymanager_c_intf.h"
 #include "trick/rand_generator.h"
+#include "trick/tc_proto.h"
 //#include "trick/RequirementScribe.hh"
 
 void sig_hand(int sig) ;
@@ -245,6 +251,7 @@ TEST_F(MonteCarloTest , TestDefaultValues) {
     EXPECT_EQ(exec.get_custom_slave_dispatch(), false) ;
     EXPECT_EQ(exec.get_timeout(), 120) ;
     EXPECT_EQ(exec.get_max_tries(), 2) ;
+    EXPECT_EQ(exec.get_batch_size(), 0) ;
     EXPECT_EQ(exec.get_verbosity(), exec.INFORMATIONAL) ;
     EXPECT_EQ(exec.get_num_runs(), 0) ;
     EXPECT_EQ(exec.get_slave_id(), 0) ;
@@ -268,6 +275,8 @@ TEST_F(MonteCarloTest, TestSettingValues) {
     EXPECT_EQ(exec.get_timeout(), 60) ;
     exec.set_max_tries(4) ;
     EXPECT_EQ(exec.get_max_tries(), 4) ;
+    exec.set_batch_size(16) ;
+    EXPECT_EQ(exec.get_batch_size(), 16) ;
     exec.set_verbosity(exec.NONE) ;
     EXPECT_EQ(exec.get_verbosity(), exec.NONE) ;
     exec.set_verbosity(exec.ERROR) ;
@@ -291,6 +300,99 @@ TEST_F(MonteCarloTest, TestRanges) {
     EXPECT_EQ(exec.in_range(exec.runs[10]), false) ;
 }
 
+TEST_F(MonteCarloTest, TestBatch) {
+    Trick::MonteVarFixed var0("test.x", 1.5, "m") ;
+    Trick::MonteVarFixed var1("test.y", 2) ;
+    exec.add_variable(&var0) ;
+    exec.add_variable(&var1) ;
+    exec.run_directory = "MONTE_RUN_test" ;
+
+    std::vector<Trick::MonteRun *> batch ;
+    Trick::MonteRun run3(3) ;
+    run3.values.push_back("1.5") ;
+    run3.values.push_back("2") ;
+    Trick::MonteRun run4(4) ;
+    run4.values.push_back("-0.25") ;
+    run4.values.push_back("math.pi") ;
+    batch.push_back(&run3) ;
+    batch.push_back(&run4) ;
+
+    std::string buffer ;
+    exec.pack_batch(batch, buffer) ;
+
+    exec.run_directory = "" ;
+    std::vector<std::string> names ;
+    std::vector<std::string> units ;
+    std::vector<Trick::MonteRun *> received ;
+    EXPECT_EQ(exec.unpack_batch(buffer.data(), buffer.length(), names, units, received), 0) ;
+    EXPECT_EQ(exec.run_directory, "MONTE_RUN_test") ;
+    ASSERT_EQ(names.size(), 2) ;
+    EXPECT_EQ(names[0], "test.x") ;
+    EXPECT_EQ(units[0], "m") ;
+    EXPECT_EQ(names[1], "test.y") ;
+    EXPECT_EQ(units[1], "") ;
+    ASSERT_EQ(received.size(), 2) ;
+    EXPECT_EQ(received[0]->id, 3) ;
+    EXPECT_EQ(received[0]->values, run3.values) ;
+    EXPECT_EQ(received[1]->id, 4) ;
+    EXPECT_EQ(received[1]->values, run4.values) ;
+    for (unsigned int ii = 0 ; ii < received.size() ; ii++) {
+        delete received[ii] ;
+    }
+
+    // A truncated message is rejected.
+    received.clear() ;
+    EXPECT_EQ(exec.unpack_batch(buffer.data(), buffer.length() - 1, names, units, received), -1) ;
+    for (unsigned int ii = 0 ; ii < received.size() ; ii++) {
+        delete received[ii] ;
+    }
+}
+
+TEST_F(MonteCarloTest, TestBatchDisconnect) {
+    // Stands in for the slave's batch port.
+    struct sockaddr_in addr ;
+    socklen_t addr_len = sizeof(addr) ;
+    memset(&addr, 0, sizeof(addr)) ;
+    addr.sin_family = AF_INET ;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1") ;
+    int listen_socket = socket(AF_INET, SOCK_STREAM, 0) ;
+    ASSERT_EQ(bind(listen_socket, (struct sockaddr *)&addr, sizeof(addr)), 0) ;
+    listen(listen_socket, 1) ;
+    getsockname(listen_socket, (struct sockaddr *)&addr, &addr_len) ;
+
+    exec.run_data_file = tmpfile() ;
+    exec.set_batch_size(3) ;
+    exec.set_num_runs(4) ;
+    Trick::MonteSlave slave("127.0.0.1") ;
+    slave.port = ntohs(addr.sin_port) ;
+    slave.state = Trick::MonteSlave::READY ;
+
+    // The first three runs go to the slave.
+    exec.dispatch_batch_to_slave(&slave) ;
+    EXPECT_EQ(slave.state, Trick::MonteSlave::RUNNING) ;
+    ASSERT_EQ(exec.runs.size(), 1) ;
+    EXPECT_EQ(exec.runs[0]->id, 3) ;
+    ASSERT_TRUE(slave.current_run != NULL) ;
+    EXPECT_EQ(slave.current_run->id, 0) ;
+    ASSERT_EQ(slave.batch_runs.size(), 2) ;
+
+    // Losing the slave requeues the runs of its batch it has not reported.
+    exec.set_disconnected_state(slave) ;
+    EXPECT_EQ(slave.state, Trick::MonteSlave::DISCONNECTED) ;
+    ASSERT_EQ(exec.runs.size(), 3) ;
+    EXPECT_EQ(exec.runs[1]->id, 1) ;
+    EXPECT_EQ(exec.runs[2]->id, 2) ;
+
+    // A second loss does not queue them twice.
+    exec.set_disconnected_state(slave) ;
+    EXPECT_EQ(exec.runs.size(), 3) ;
+
+    tc_disconnect(&slave.batch_device) ;
+    close(listen_socket) ;
+    fclose(exec.run_data_file) ;
+    exec.run_data_file = NULL ;
+}
+
 TEST_F(MonteCarloTest, TestSlaves) {
     //req.add_requirement("1098748189");
 
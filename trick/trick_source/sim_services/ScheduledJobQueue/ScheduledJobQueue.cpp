@@ -1,27 +1,46 @@
 
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "trick/ScheduledJobQueue.hh"
 #include "trick/ScheduledJobQueueInstrument.hh"
 #include "trick/TrickConstant.hh"
 
+/* dispatch_filed value of a job whose next call time fell behind the current time */
+#define DISPATCH_PARKED (-TRICK_MAX_LONG_LONG - 1)
+/* dispatch_filed value of a job that is due in the current pass */
+#define DISPATCH_DUE (-TRICK_MAX_LONG_LONG)
+/* dispatch_swept value before the first sweep of a new timing wheel */
+#define DISPATCH_UNSWEPT (-TRICK_MAX_LONG_LONG - 1)
+
 /**
 @design
 -# Set #list to NULL
--# Set #list_list to 0
+-# Set #list_list and #list_capacity to 0
 -# Set #curr_index to 0
 -# Set #next_job_time to TRICK_MAX_LONG_LONG
+-# Disable the dispatch schedule
 */
 Trick::ScheduledJobQueue::ScheduledJobQueue( ) {
 
     list = NULL ;
     list_size = 0 ;
+    list_capacity = 0 ;
     curr_index = 0 ;
     next_job_time = TRICK_MAX_LONG_LONG ;
 
+    dispatch_schedule = false ;
+    dispatch_dirty = true ;
+    dispatch_due_valid = false ;
+    dispatch_tics = 0 ;
+    dispatch_pos = 0 ;
+    dispatch_num_slots = 0 ;
+    dispatch_slot_tics = 1 ;
+    dispatch_swept = DISPATCH_UNSWEPT ;
 }
 
 /**
@@ -36,84 +55,160 @@ Trick::ScheduledJobQueue::~ScheduledJobQueue( ) {
 
 /**
 @design
--# Allocate additional memory for the incoming job
--# Find the insertion point in the queue based on the job_class, the phase,
-   the sim_object id, and the job_id
--# While searching for the correct insertion spot, copy all jobs that precede
-   the incoming job to the newly allocated queue space followed by the new job.
--# Copy jobs that are ordered after the incoming job to the new queue
+-# Returns true if job a is ordered before job b in the queue.  Jobs are compared by
+   the job_class, the phase, the sim_object id, and the job_id in that order.
+*/
+static bool job_order_less( const Trick::JobData * a , const Trick::JobData * b ) {
+    if ( a->job_class != b->job_class ) {
+        return a->job_class < b->job_class ;
+    }
+    if ( a->phase != b->phase ) {
+        return a->phase < b->phase ;
+    }
+    if ( a->sim_object_id != b->sim_object_id ) {
+        return a->sim_object_id < b->sim_object_id ;
+    }
+    return a->id < b->id ;
+}
+
+/**
+@design
+-# If the list capacity is less than the requested size, grow the capacity to the larger
+   of the requested size or double the current capacity.
+*/
+void Trick::ScheduledJobQueue::reserve( unsigned int in_size ) {
+
+    unsigned int new_capacity ;
+
+    if ( in_size <= list_capacity ) {
+        return ;
+    }
+
+    new_capacity = ( list_capacity == 0 ) ? 16 : list_capacity * 2 ;
+    if ( new_capacity < in_size ) {
+        new_capacity = in_size ;
+    }
+
+    list = (JobData **)realloc( list , new_capacity * sizeof(JobData *)) ;
+    list_capacity = new_capacity ;
+}
+
+/**
+@design
+-# Grow the list capacity if the list is full
+-# Binary search for the insertion point in the queue based on the job_class, the phase,
+   the sim_object id, and the job_id.  The incoming job is placed after all jobs with
+   the same ordering values.
+-# Move the jobs ordered after the incoming job down one spot and insert the job.
+-# Increment #curr_index if the job was inserted before the current job.
 -# Increment the size of the queue.
 */
 int Trick::ScheduledJobQueue::push( JobData * new_job ) {
 
-    unsigned int ii , jj ;
-
-    /* Allocate additional memory for the additional job in the queue */
-    JobData ** new_list = (JobData **)calloc( list_size + 1 , sizeof(JobData *)) ;
+    unsigned int lower , upper , mid ;
 
     new_job->set_handled(true) ;
 
-    /* Find the correct insertion spot in the queue by comparing
-       the job_class, the phase, the sim_object id, and the job_id in that order. */
-    /* While searching for the correct insertion spot, copy all jobs that precede
-       the incoming job to the newly allocated queue space. */
-    for ( ii = jj = 0 ; ii < list_size ; ii++ ) {
-        if ( list[ii]->job_class == new_job->job_class ) {
-            if ( list[ii]->phase == new_job->phase ) {
-                if ( list[ii]->sim_object_id ==  new_job->sim_object_id ) {
-                    if ( list[ii]->id <= new_job->id ) {
-                        new_list[jj++] = list[ii] ;
-                    } else {
-                        new_list[jj++] = new_job ;
-                        break ;
-                    }
-                } else if ( list[ii]->sim_object_id < new_job->sim_object_id ) {
-                    new_list[jj++] = list[ii] ;
-                } else {
-                    new_list[jj++] = new_job ;
-                    break ;
-                }
-            } else if ( list[ii]->phase < new_job->phase ) {
-                new_list[jj++] = list[ii] ;
-            } else {
-                new_list[jj++] = new_job ;
-                break ;
-            }
-        } else if ( list[ii]->job_class < new_job->job_class ) {
-            new_list[jj++] = list[ii] ;
+    reserve( list_size + 1 ) ;
+
+    /* Find the first job that is ordered after the incoming job. */
+    lower = 0 ;
+    upper = list_size ;
+    while ( lower < upper ) {
+        mid = lower + (upper - lower) / 2 ;
+        if ( job_order_less( new_job , list[mid] )) {
+            upper = mid ;
         } else {
-            new_list[jj++] = new_job ;
-            break ;
+            lower = mid + 1 ;
         }
     }
 
-    /* Copy remaining jobs that execute after the incoming job to the new queue space. */
-    if ( ii == list_size ) {
-        /* ii == list_size means the incoming job is the last job */
-        new_list[list_size] = new_job ;
-    } else {
-        /* Inserted new job before the current job. Increment curr_index to point to the correct job */
-        if ( ii < curr_index ) {
-            curr_index++ ;
-        }
-        for ( ; ii < list_size ; ii++ ) {
-            new_list[jj++] = list[ii] ;
-        }
+    /* Shift the jobs that execute after the incoming job and insert the new job. */
+    memmove( &list[lower + 1] , &list[lower] , (list_size - lower) * sizeof(JobData *)) ;
+    list[lower] = new_job ;
+
+    /* Inserted new job before the current job. Increment curr_index to point to the correct job */
+    if ( lower < curr_index ) {
+        curr_index++ ;
     }
 
     /* Increment the size of the queue */
     list_size++ ;
 
-    /* Free the old queue space */
-    if ( list ) {
-        free(list) ;
+    /* Job indexes have shifted, the dispatch schedule must be rebuilt */
+    dispatch_dirty = true ;
+    dispatch_due_valid = false ;
+
+    return(0) ;
+
+}
+
+/**
+@design
+-# Sort the incoming jobs by the job_class, the phase, the sim_object id, and the job_id.
+   The sort is stable so jobs with the same ordering values keep their incoming order.
+-# Count the incoming jobs that will be placed before the current job.
+-# Grow the list capacity to hold all of the incoming jobs.
+-# Merge the incoming jobs into the queue from the back.  For each incoming job, starting with
+   the last, binary search for its insertion point and move the block of jobs that follow it
+   to their final position.  Each job already in the queue is moved at most once.  Jobs already
+   in the queue are placed before incoming jobs with the same ordering values.
+-# Increment #curr_index by the number of jobs placed before the current job.
+-# Increment the size of the queue.
+*/
+int Trick::ScheduledJobQueue::push_all( std::vector< JobData * > & in_jobs ) {
+
+    std::vector< JobData * > new_jobs ;
+    unsigned int ii ;
+    unsigned int num_before = 0 ;
+    unsigned int lower , upper , mid ;
+    unsigned int list_end , write_end ;
+
+    if ( in_jobs.empty() ) {
+        return(0) ;
     }
 
-    /* Assign the queue pointer to the new space */
-    list = new_list ;
+    new_jobs = in_jobs ;
+    std::stable_sort( new_jobs.begin() , new_jobs.end() , job_order_less ) ;
 
-    return(0) ;
+    for ( ii = 0 ; ii < new_jobs.size() ; ii++ ) {
+        new_jobs[ii]->set_handled(true) ;
+        if ( curr_index > 0 and curr_index <= list_size and job_order_less( new_jobs[ii] , list[curr_index - 1] )) {
+            num_before++ ;
+        }
+    }
+
+    reserve( list_size + new_jobs.size() ) ;
+
+    /* list[0, list_end) holds the jobs not moved yet, list[write_end, ...) is merged. */
+    list_end = list_size ;
+    write_end = list_size + new_jobs.size() ;
+    for ( ii = new_jobs.size() ; ii > 0 ; ii-- ) {
+        /* Find the first unmoved job that is ordered after the incoming job. */
+        lower = 0 ;
+        upper = list_end ;
+        while ( lower < upper ) {
+            mid = lower + (upper - lower) / 2 ;
+            if ( job_order_less( new_jobs[ii - 1] , list[mid] )) {
+                upper = mid ;
+            } else {
+                lower = mid + 1 ;
+            }
+        }
+        write_end -= list_end - lower ;
+        memmove( &list[write_end] , &list[lower] , (list_end - lower) * sizeof(JobData *)) ;
+        list_end = lower ;
+        list[--write_end] = new_jobs[ii - 1] ;
+    }
+
+    curr_index += num_before ;
+    list_size += new_jobs.size() ;
 
+    /* Job indexes have shifted, the dispatch schedule must be rebuilt */
+    dispatch_dirty = true ;
+    dispatch_due_valid = false ;
+
+    return(0) ;
 }
 
 /**
@@ -142,39 +237,27 @@ int Trick::ScheduledJobQueue::push_ignore_sim_object( JobData * new_job ) {
 @design
 -# Traverse the list of jobs looking for the job to delete.
  -# If the job to delete is found
-  -# Allocate a new list that holds 1 less job than the current list
-  -# Copy all of the jobs that precede the deleted job to the new list
-  -# Copy all of the jobs that are after the delete job to the new list
+  -# Move all of the jobs that are after the deleted job up one spot
+  -# Decrement #curr_index if the job was at or before the current job
   -# Decrement the size of the list
-  -# Free the memory associated with the current list
-  -# Point the current list to the newly allocated list
 */
 int Trick::ScheduledJobQueue::remove( JobData * delete_job ) {
 
-    unsigned int ii , jj ;
+    unsigned int ii ;
 
     /* Find the job to delete in the queue. */
     for ( ii = 0 ; ii < list_size ; ii++ ) {
         if ( list[ii] == delete_job ) {
-            /* allocate a new list that holds one less element than the current list. */
-            JobData ** new_list = (JobData **)calloc( list_size - 1 , sizeof(JobData *)) ;
-            /* copy all of the jobs that are before the deleted job to the new list */
-            for ( jj = 0 ; jj < ii ; jj++ ) {
-                new_list[jj] = list[jj] ;
-            }
-            /* copy all of the jobs that are after the deleted job to the new list */
-            for ( jj = ii + 1 ; jj < list_size ; jj++ ) {
-                new_list[jj-1] = list[jj] ;
-            }
+            /* move all of the jobs that are after the deleted job up one spot */
+            memmove( &list[ii] , &list[ii + 1] , (list_size - ii - 1) * sizeof(JobData *)) ;
             if ( ii <= curr_index ) {
                 curr_index-- ;
             }
             /* Decrement the size of the queue */
             list_size-- ;
-            /* Free the old queue space */
-            free(list) ;
-            /* Assign the queue pointer to the new space */
-            list = new_list ;
+            /* Job indexes have shifted, the dispatch schedule must be rebuilt */
+            dispatch_dirty = true ;
+            dispatch_due_valid = false ;
             return 0 ;
         }
     }
@@ -197,6 +280,7 @@ int Trick::ScheduledJobQueue::set_curr_index(unsigned int value ) {
 
     if ( value < list_size ) {
         curr_index = value ;
+        dispatch_due_valid = false ;
     }
     return 0 ;
 }
@@ -208,6 +292,7 @@ int Trick::ScheduledJobQueue::set_curr_index(unsigned int value ) {
 int Trick::ScheduledJobQueue::reset_curr_index() {
 
     curr_index = 0 ;
+    dispatch_due_valid = false ;
     return(0) ;
 }
 
@@ -231,7 +316,7 @@ bool Trick::ScheduledJobQueue::empty() {
 @design
 -# If #list is not NULL free it.
 -# Set #list to NULL
--# Set #list_list to 0
+-# Set #list_list and #list_capacity to 0
 -# Set #curr_index to 0
 -# Set #next_job_time to TRICK_MAX_LONG_LONG
 */
@@ -244,8 +329,11 @@ int Trick::ScheduledJobQueue::clear() {
     /* set all list variables to initial cleared values */
     list = NULL ;
     list_size = 0 ;
+    list_capacity = 0 ;
     curr_index = 0 ;
     next_job_time = TRICK_MAX_LONG_LONG ;
+    dispatch_dirty = true ;
+    dispatch_due_valid = false ;
     return(0) ;
 }
 
@@ -295,6 +383,7 @@ Trick::JobData * Trick::ScheduledJobQueue::get_next_job() {
 
 /**
 @design
+-# If the dispatch schedule is enabled return the result of find_next_dispatch_job(long long)
 -# While the list #curr_list is less than the list size
     -# If the current queue job next call matches the incoming simulation time
         -# If the job class is not a system class job, calculate the next
@@ -316,6 +405,10 @@ Trick::JobData * Trick::ScheduledJobQueue::find_next_job(long long time_tics ) {
     JobData * curr_job ;
     long long next_call ;
 
+    if ( dispatch_schedule ) {
+        return find_next_dispatch_job(time_tics) ;
+    }
+
     /* Search through the rest of the queue starting at curr_index looking for
        the next job with it's next execution time is equal to the current simulation time. */
     while (curr_index < list_size ) {
@@ -420,6 +513,439 @@ int Trick::ScheduledJobQueue::test_next_job_call_time(Trick::JobData * curr_job,
     return(0) ;
 }
 
+/**
+@details
+-# Sets the dispatch schedule flag
+-# Marks the dispatch schedule for a full rebuild
+*/
+int Trick::ScheduledJobQueue::set_dispatch_schedule(bool yes_no) {
+    dispatch_schedule = yes_no ;
+    dispatch_dirty = true ;
+    dispatch_due_valid = false ;
+    return(0) ;
+}
+
+/**
+@details
+-# Returns #dispatch_schedule
+*/
+bool Trick::ScheduledJobQueue::get_dispatch_schedule() {
+    return(dispatch_schedule) ;
+}
+
+/**
+@details
+-# Marks the dispatch schedule for a full rebuild
+*/
+int Trick::ScheduledJobQueue::rebuild_dispatch_schedule() {
+    dispatch_dirty = true ;
+    dispatch_due_valid = false ;
+    return(0) ;
+}
+
+/**
+@details
+-# Find the list index of the incoming job from the index recorded in the job when the timing wheel
+   was built.  Search the list if the recorded index is out of date.  Return -1 if the job is not in
+   the queue.
+-# Return if the dispatch schedule is not in use or will be rebuilt.
+-# If the job is now due in the pass that is in progress and has not been reached yet, add
+   it to the due jobs of the pass.
+-# Else move the job to the wheel slot of its next call time.  System jobs are tested every pass
+   and are not on the timing wheel.
+*/
+int Trick::ScheduledJobQueue::reschedule_job(JobData * in_job) {
+
+    unsigned int ii ;
+
+    ii = in_job->queue_index ;
+    if ( ii >= list_size or list[ii] != in_job ) {
+        for ( ii = 0 ; ii < list_size ; ii++ ) {
+            if ( list[ii] == in_job ) {
+                break ;
+            }
+        }
+        if ( ii == list_size ) {
+            return -1 ;
+        }
+    }
+
+    if ( ! dispatch_schedule or dispatch_dirty ) {
+        return 0 ;
+    }
+
+    if ( dispatch_due_valid and in_job->next_tics == dispatch_tics and ii >= curr_index ) {
+        if ( in_job->system_job_class ) {
+            dispatch_due[ii / 64] |= 1ULL << (ii % 64) ;
+        } else if ( dispatch_filed[ii] != DISPATCH_DUE ) {
+            unlink_dispatch_node(ii) ;
+            dispatch_filed[ii] = DISPATCH_DUE ;
+            dispatch_due[ii / 64] |= 1ULL << (ii % 64) ;
+        }
+    } else if ( ! in_job->system_job_class ) {
+        file_dispatch_job(ii, in_job->next_tics) ;
+    }
+
+    return 0 ;
+}
+
+/**
+@design
+-# Join the node's neighbors and link the node to itself.  Unlinked nodes already link to themselves.
+*/
+void Trick::ScheduledJobQueue::unlink_dispatch_node( unsigned int node ) {
+    dispatch_next[dispatch_prev[node]] = dispatch_next[node] ;
+    dispatch_prev[dispatch_next[node]] = dispatch_prev[node] ;
+    dispatch_next[node] = dispatch_prev[node] = node ;
+}
+
+/**
+@design
+-# Link the node at the end of the list that starts at head.
+*/
+void Trick::ScheduledJobQueue::link_dispatch_node( unsigned int node , unsigned int head ) {
+    dispatch_prev[node] = dispatch_prev[head] ;
+    dispatch_next[node] = head ;
+    dispatch_next[dispatch_prev[head]] = node ;
+    dispatch_prev[head] = node ;
+}
+
+/**
+@design
+-# Return the head node of the wheel slot holding the time.  The slots repeat every
+   #dispatch_num_slots times #dispatch_slot_tics tics.
+*/
+unsigned int Trick::ScheduledJobQueue::dispatch_slot_head( long long slot ) {
+    return list_size + (unsigned int)(slot & (dispatch_num_slots - 1)) ;
+}
+
+/**
+@design
+-# Unlink the job index from the wheel slot or parked list it is in.
+-# Record the time the job index is filed under.
+-# Jobs that will never be called again are not linked.  Jobs at or behind the times already swept
+   from the wheel are parked.  All other jobs are linked into the wheel slot of their time.
+*/
+void Trick::ScheduledJobQueue::file_dispatch_job( unsigned int index , long long time_tics ) {
+    unlink_dispatch_node(index) ;
+    if ( time_tics == TRICK_MAX_LONG_LONG ) {
+        dispatch_filed[index] = time_tics ;
+    } else if ( time_tics <= dispatch_swept ) {
+        dispatch_filed[index] = DISPATCH_PARKED ;
+        link_dispatch_node(index, list_size + dispatch_num_slots) ;
+    } else {
+        dispatch_filed[index] = time_tics ;
+        link_dispatch_node(index, dispatch_slot_head(time_tics / dispatch_slot_tics)) ;
+    }
+}
+
+/**
+@design
+-# Size the slots to the greatest common divisor of the job cycles, and use enough slots to hold the
+   longest cycle up to a limit of 4096 slots.
+-# Allocate the links of the job indexes, the slot heads and the parked list head, the filed times
+   and the due bits.  This is the only place the dispatch schedule allocates memory.
+-# For each job in the list
+    -# Record the list index in the job for reschedule_job.
+    -# If the job is a system job add it to the polled list.  System jobs set their
+       own next call times.
+    -# Else file the job on the timing wheel at its next call time.
+*/
+void Trick::ScheduledJobQueue::build_dispatch_wheel() {
+
+    unsigned int ii ;
+    long long gcd = 0 ;
+    long long max_cycle = 0 ;
+    long long aa , bb , tt ;
+
+    for ( ii = 0 ; ii < list_size ; ii++ ) {
+        if ( ! list[ii]->system_job_class and list[ii]->cycle_tics > 0 ) {
+            aa = list[ii]->cycle_tics ;
+            bb = gcd ;
+            while ( bb != 0 ) {
+                tt = aa % bb ;
+                aa = bb ;
+                bb = tt ;
+            }
+            gcd = aa ;
+            if ( list[ii]->cycle_tics > max_cycle ) {
+                max_cycle = list[ii]->cycle_tics ;
+            }
+        }
+    }
+    dispatch_slot_tics = ( gcd > 0 ) ? gcd : 1 ;
+    dispatch_num_slots = 16 ;
+    while ( dispatch_num_slots < 4096 and dispatch_num_slots * dispatch_slot_tics <= max_cycle ) {
+        dispatch_num_slots *= 2 ;
+    }
+
+    dispatch_next.resize(list_size + dispatch_num_slots + 1) ;
+    dispatch_prev.resize(list_size + dispatch_num_slots + 1) ;
+    for ( ii = 0 ; ii < dispatch_next.size() ; ii++ ) {
+        dispatch_next[ii] = dispatch_prev[ii] = ii ;
+    }
+    dispatch_filed.assign(list_size, TRICK_MAX_LONG_LONG) ;
+    dispatch_due.assign(list_size / 64 + 1, 0) ;
+    dispatch_polled.clear() ;
+    dispatch_pos = 0 ;
+    dispatch_swept = DISPATCH_UNSWEPT ;
+
+    for ( ii = 0 ; ii < list_size ; ii++ ) {
+        list[ii]->queue_index = ii ;
+        if ( list[ii]->system_job_class ) {
+            dispatch_polled.push_back(ii) ;
+        } else {
+            file_dispatch_job(ii, list[ii]->next_tics) ;
+        }
+    }
+
+    dispatch_dirty = false ;
+}
+
+/**
+@design
+-# Move the job to the due jobs of the pass if its next call time matches the incoming time and
+   the job has not been passed by #curr_index.
+-# Else refile the job at its next call time.  Jobs behind the current time are parked and
+   will not be called, the same as a job in the list scan.
+*/
+void Trick::ScheduledJobQueue::sweep_dispatch_job( unsigned int index , long long time_tics ) {
+    if ( list[index]->next_tics == time_tics and index >= curr_index ) {
+        unlink_dispatch_node(index) ;
+        dispatch_filed[index] = DISPATCH_DUE ;
+        dispatch_due[index / 64] |= 1ULL << (index % 64) ;
+    } else {
+        file_dispatch_job(index, list[index]->next_tics) ;
+    }
+}
+
+/**
+@design
+-# Rebuild the timing wheel if it is marked dirty or time went backwards.  Otherwise return jobs
+   left over from an unfinished pass to the wheel.
+-# Sweep the parked jobs.  Jobs whose next call time caught up to the incoming time leave the list.
+-# Sweep the wheel slots of the times after the last sweep up to the incoming time, at most one
+   turn of the wheel.  Entries of later turns stay in their slots.
+-# Add all polled jobs with a next call time matching the incoming time to the due jobs.
+*/
+void Trick::ScheduledJobQueue::build_dispatch_due( long long time_tics ) {
+
+    unsigned int ii ;
+    unsigned int node , next ;
+    unsigned int parked_head ;
+    unsigned int head ;
+    unsigned long long bits ;
+    long long first_slot , last_slot , slot ;
+
+    if ( dispatch_dirty or time_tics < dispatch_swept ) {
+        build_dispatch_wheel() ;
+    } else {
+        for ( ii = 0 ; ii < dispatch_due.size() ; ii++ ) {
+            for ( bits = dispatch_due[ii] ; bits != 0 ; bits &= bits - 1 ) {
+                node = ii * 64 + __builtin_ctzll(bits) ;
+                if ( dispatch_filed[node] == DISPATCH_DUE ) {
+                    file_dispatch_job(node, list[node]->next_tics) ;
+                }
+            }
+            dispatch_due[ii] = 0 ;
+        }
+    }
+
+    parked_head = list_size + dispatch_num_slots ;
+    for ( node = dispatch_next[parked_head] ; node != parked_head ; node = next ) {
+        next = dispatch_next[node] ;
+        if ( list[node]->next_tics >= time_tics ) {
+            sweep_dispatch_job(node, time_tics) ;
+        }
+    }
+
+    last_slot = time_tics / dispatch_slot_tics ;
+    if ( dispatch_swept == DISPATCH_UNSWEPT or
+         last_slot - (dispatch_swept + 1) / dispatch_slot_tics >= dispatch_num_slots ) {
+        first_slot = last_slot - dispatch_num_slots + 1 ;
+    } else {
+        first_slot = (dispatch_swept + 1) / dispatch_slot_tics ;
+    }
+    if ( time_tics > dispatch_swept ) {
+        /* Jobs refiled during the sweep go to later times, or are parked. */
+        dispatch_swept = time_tics ;
+        for ( slot = first_slot ; slot <= last_slot ; slot++ ) {
+            head = dispatch_slot_head(slot) ;
+            for ( node = dispatch_next[head] ; node != head ; node = next ) {
+                next = dispatch_next[node] ;
+                if ( dispatch_filed[node] <= time_tics ) {
+                    sweep_dispatch_job(node, time_tics) ;
+                }
+            }
+        }
+    }
+
+    for ( ii = 0 ; ii < dispatch_polled.size() ; ii++ ) {
+        node = dispatch_polled[ii] ;
+        if ( node >= curr_index and list[node]->next_tics == time_tics ) {
+            dispatch_due[node / 64] |= 1ULL << (node % 64) ;
+        }
+    }
+
+    dispatch_pos = curr_index ;
+    dispatch_tics = time_tics ;
+    dispatch_due_valid = true ;
+}
+
+/**
+@design
+-# If the due jobs were not collected for the incoming time, collect them.
+-# While there are due jobs left in the pass, in list index order
+    -# Clear the job's due bit and set #curr_index to follow the due job.
+    -# If the job is a system job return it if its next call time still matches the incoming time
+       and the job is enabled.
+    -# Skip the job if it was rescheduled during the pass.  Refile the job if its next call time
+       was changed without rescheduling.
+    -# Calculate the next time the job will be called the same as the list scan and track the
+       next lowest job call time.
+    -# File the job on the timing wheel at its next call time.
+    -# Return the job if the job is enabled.
+-# Set #curr_index to the end of the list.
+-# Fold the earliest timing wheel and system job call times into the next lowest job call time.
+-# Return NULL when the due jobs are exhausted.
+*/
+Trick::JobData * Trick::ScheduledJobQueue::find_next_dispatch_job( long long time_tics ) {
+
+    JobData * curr_job ;
+    unsigned int index ;
+    unsigned int word ;
+    unsigned long long bits ;
+    long long next_call ;
+
+    if ( ! dispatch_due_valid or dispatch_tics != time_tics ) {
+        build_dispatch_due(time_tics) ;
+    }
+
+    word = dispatch_pos / 64 ;
+    bits = ( word < dispatch_due.size() ) ? dispatch_due[word] & (~0ULL << (dispatch_pos % 64)) : 0 ;
+    while ( word < dispatch_due.size() ) {
+
+        if ( bits == 0 ) {
+            if ( ++word < dispatch_due.size() ) {
+                bits = dispatch_due[word] ;
+            }
+            continue ;
+        }
+        index = word * 64 + __builtin_ctzll(bits) ;
+        bits &= bits - 1 ;
+        dispatch_due[word] &= ~(1ULL << (index % 64)) ;
+        dispatch_pos = index + 1 ;
+        curr_job = list[index] ;
+        curr_index = index + 1 ;
+
+        if ( curr_job->system_job_class ) {
+            if ( curr_job->next_tics == time_tics and !curr_job->disabled ) {
+                return(curr_job) ;
+            }
+            continue ;
+        }
+
+        if ( dispatch_filed[index] != DISPATCH_DUE ) {
+            continue ;
+        }
+
+        if ( curr_job->next_tics != time_tics ) {
+            file_dispatch_job(index, curr_job->next_tics) ;
+            continue ;
+        }
+
+        // calculate the next job call time
+        next_call = curr_job->next_tics + curr_job->cycle_tics ;
+        /* If the next time does not exceed the stop time, set the next call time for the module */
+        if (next_call > curr_job->stop_tics) {
+            curr_job->next_tics = TRICK_MAX_LONG_LONG ;
+        } else {
+            curr_job->next_tics = next_call;
+        }
+        /* Track next lowest job call time after the current time for jobs that match the current time. */
+        if ( curr_job->next_tics <  next_job_time ) {
+            next_job_time = curr_job->next_tics ;
+        }
+        file_dispatch_job(index, curr_job->next_tics) ;
+
+        if ( !curr_job->disabled ) {
+            return(curr_job) ;
+        }
+    }
+
+    curr_index = list_size ;
+    dispatch_pos = list_size ;
+    test_next_dispatch_time(time_tics) ;
+    return(NULL) ;
+}
+
+/**
+@design
+-# Check the entries of one wheel slot.  Refile jobs whose next call time was changed without
+   rescheduling and track their new time.
+-# Return the earliest time of the remaining entries before the incoming limit.
+*/
+long long Trick::ScheduledJobQueue::earliest_dispatch_time( unsigned int head , long long time_tics , long long limit ) {
+
+    unsigned int node , next ;
+    long long curr_next ;
+    long long earliest = TRICK_MAX_LONG_LONG ;
+
+    for ( node = dispatch_next[head] ; node != head ; node = next ) {
+        next = dispatch_next[node] ;
+        curr_next = list[node]->next_tics ;
+        if ( curr_next != dispatch_filed[node] ) {
+            file_dispatch_job(node, curr_next) ;
+            if ( curr_next > time_tics and curr_next < next_job_time ) {
+                next_job_time = curr_next ;
+            }
+        } else if ( curr_next < limit and curr_next < earliest ) {
+            earliest = curr_next ;
+        }
+    }
+    return earliest ;
+}
+
+/**
+@design
+-# For each polled system job, track its next call time if it is after the incoming time.
+-# Walk one turn of the wheel slots from the incoming time until the slot times reach the next
+   lowest job call time.  The first slot holding a time of the current turn holds the earliest
+   time on the wheel.
+-# If no slot does, every job on the wheel is more than a turn away.  Check every slot.
+*/
+void Trick::ScheduledJobQueue::test_next_dispatch_time( long long time_tics ) {
+
+    unsigned int ii ;
+    long long slot , first_slot ;
+    long long earliest ;
+
+    for ( ii = 0 ; ii < dispatch_polled.size() ; ii++ ) {
+        test_next_job_call_time(list[dispatch_polled[ii]], time_tics) ;
+    }
+
+    first_slot = time_tics / dispatch_slot_tics ;
+    for ( slot = first_slot ; slot < first_slot + dispatch_num_slots ; slot++ ) {
+        if ( slot * dispatch_slot_tics >= next_job_time ) {
+            return ;
+        }
+        earliest = earliest_dispatch_time(dispatch_slot_head(slot), time_tics, (slot + 1) * dispatch_slot_tics) ;
+        if ( earliest != TRICK_MAX_LONG_LONG ) {
+            if ( earliest < next_job_time ) {
+                next_job_time = earliest ;
+            }
+            return ;
+        }
+    }
+
+    for ( slot = first_slot ; slot < first_slot + dispatch_num_slots ; slot++ ) {
+        earliest = earliest_dispatch_time(dispatch_slot_head(slot), time_tics, TRICK_MAX_LONG_LONG) ;
+        if ( earliest < next_job_time ) {
+            next_job_time = earliest ;
+        }
+    }
+}
+
 // Executes the jobs in a queue.  saves and restores Trick::Executive::curr_job
 int Trick::ScheduledJobQueue::execute_all_jobs() {
     Trick::JobData * curr_job ;
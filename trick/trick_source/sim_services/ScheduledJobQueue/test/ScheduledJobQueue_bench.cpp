@@ -0,0 +1,144 @@
+/*
+   PURPOSE: (Startup benchmark for building ScheduledJobQueues with many jobs.)
+
+   Builds queues the way the Executive does during startup: one sim_object at a time with
+   jobs spread over many job classes.  Compares the previous copy-on-insert push, push, and
+   push_all for each queue size.
+
+   usage: ScheduledJobQueue_bench [num_jobs ...]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "trick/ScheduledJobQueue.hh"
+
+/* number of jobs in each sim_object */
+static const unsigned int jobs_per_object = 10 ;
+/* number of scheduled job classes jobs are spread over */
+static const unsigned int num_classes = 20 ;
+
+static double wall_time() {
+    struct timeval tv ;
+    gettimeofday(&tv, NULL) ;
+    return tv.tv_sec + tv.tv_usec * 1.0e-6 ;
+}
+
+/* The previous ScheduledJobQueue::push.  Allocates a new list and copies every job for each insertion. */
+static void copy_on_insert_push( Trick::JobData ** & list , unsigned int & list_size , Trick::JobData * new_job ) {
+
+    unsigned int ii , jj ;
+    Trick::JobData ** new_list = (Trick::JobData **)calloc( list_size + 1 , sizeof(Trick::JobData *)) ;
+
+    for ( ii = jj = 0 ; ii < list_size ; ii++ ) {
+        if ( list[ii]->job_class == new_job->job_class ) {
+            if ( list[ii]->phase == new_job->phase ) {
+                if ( list[ii]->sim_object_id ==  new_job->sim_object_id ) {
+                    if ( list[ii]->id <= new_job->id ) {
+                        new_list[jj++] = list[ii] ;
+                    } else {
+                        new_list[jj++] = new_job ;
+                        break ;
+                    }
+                } else if ( list[ii]->sim_object_id < new_job->sim_object_id ) {
+                    new_list[jj++] = list[ii] ;
+                } else {
+                    new_list[jj++] = new_job ;
+                    break ;
+                }
+            } else if ( list[ii]->phase < new_job->phase ) {
+                new_list[jj++] = list[ii] ;
+            } else {
+                new_list[jj++] = new_job ;
+                break ;
+            }
+        } else if ( list[ii]->job_class < new_job->job_class ) {
+            new_list[jj++] = list[ii] ;
+        } else {
+            new_list[jj++] = new_job ;
+            break ;
+        }
+    }
+    if ( ii == list_size ) {
+        new_list[list_size] = new_job ;
+    } else {
+        for ( ; ii < list_size ; ii++ ) {
+            new_list[jj++] = list[ii] ;
+        }
+    }
+    list_size++ ;
+    free(list) ;
+    list = new_list ;
+}
+
+int main( int argc , char * argv[] ) {
+
+    std::vector< unsigned int > sizes ;
+    unsigned int ii , jj , kk ;
+
+    for ( ii = 1 ; ii < (unsigned int)argc ; ii++ ) {
+        sizes.push_back(atoi(argv[ii])) ;
+    }
+    if ( sizes.empty() ) {
+        sizes.push_back(10000) ;
+        sizes.push_back(30000) ;
+        sizes.push_back(100000) ;
+    }
+
+    std::cout << std::setw(10) << "jobs" << std::setw(20) << "copy_on_insert (s)"
+              << std::setw(12) << "push (s)" << std::setw(16) << "push_all (s)" << std::endl ;
+
+    for ( ii = 0 ; ii < sizes.size() ; ii++ ) {
+        std::vector< Trick::JobData * > jobs ;
+        double start , copy_time , push_time , push_all_time ;
+
+        for ( jj = 0 ; jj < sizes[ii] ; jj++ ) {
+            Trick::JobData * job = new Trick::JobData(0, jj % jobs_per_object , "scheduled", NULL, 1.0 , "job") ;
+            job->sim_object_id = jj / jobs_per_object + 1 ;
+            job->job_class = 1000 + (jj * 7) % num_classes ;
+            jobs.push_back(job) ;
+        }
+
+        Trick::JobData ** list = NULL ;
+        unsigned int list_size = 0 ;
+        start = wall_time() ;
+        for ( jj = 0 ; jj < jobs.size() ; jj++ ) {
+            copy_on_insert_push(list, list_size, jobs[jj]) ;
+        }
+        copy_time = wall_time() - start ;
+        free(list) ;
+
+        Trick::ScheduledJobQueue push_queue ;
+        start = wall_time() ;
+        for ( jj = 0 ; jj < jobs.size() ; jj++ ) {
+            push_queue.push(jobs[jj]) ;
+        }
+        push_time = wall_time() - start ;
+
+        /* The Executive adds the jobs of each sim_object with one push_all call */
+        Trick::ScheduledJobQueue push_all_queue ;
+        start = wall_time() ;
+        for ( jj = 0 ; jj < jobs.size() ; jj += jobs_per_object ) {
+            std::vector< Trick::JobData * > object_jobs ;
+            for ( kk = jj ; kk < jj + jobs_per_object and kk < jobs.size() ; kk++ ) {
+                object_jobs.push_back(jobs[kk]) ;
+            }
+            push_all_queue.push_all(object_jobs) ;
+        }
+        push_all_time = wall_time() - start ;
+
+        std::cout << std::setw(10) << sizes[ii] << std::fixed << std::setprecision(4)
+                  << std::setw(20) << copy_time << std::setw(12) << push_time
+                  << std::setw(16) << push_all_time << std::endl ;
+
+        for ( jj = 0 ; jj < jobs.size() ; jj++ ) {
+            delete jobs[jj] ;
+        }
+    }
+
+    return 0 ;
+}
@@ -1,5 +1,7 @@
 
 #include <iostream>
+#include <new>
+#include <stdlib.h>
 #include <sys/types.h>
 #include <signal.h>
 
@@ -7,6 +9,22 @@
 #include "trick/ScheduledJobQueue.hh"
 //#include "trick/RequirementScribe.hh"
 
+/* Counts allocations while count_allocations is set, to check that dispatching does not allocate.
+   The library operator delete frees memory from malloc. */
+static bool count_allocations = false ;
+static unsigned int num_allocations = 0 ;
+
+void * operator new( size_t size ) {
+    if ( count_allocations ) {
+        num_allocations++ ;
+    }
+    void * ptr = malloc(size ? size : 1) ;
+    if ( ptr == NULL ) {
+        throw std::bad_alloc() ;
+    }
+    return ptr ;
+}
+
 namespace Trick {
 
 class ScheduledJobQueueTest : public ::testing::Test {
@@ -242,6 +260,105 @@ TEST_F( ScheduledJobQueueTest , PushJobsIgnoreSimObject ) {
 
 }
 
+TEST_F( ScheduledJobQueueTest , PushAllMatchesPush ) {
+
+    Trick::ScheduledJobQueue push_sjq ;
+    std::vector< Trick::JobData * > jobs ;
+    Trick::JobData * job_ptr ;
+    Trick::JobData * push_job_ptr ;
+    unsigned int ii , jj ;
+
+    // Fill both queues with the first group of jobs one at a time, then add the rest in groups.
+    for ( ii = 0 ; ii < 500 ; ii++ ) {
+        job_ptr = new Trick::JobData(0, (ii * 7) % 13 , "class_100", NULL, 1.0 , "job") ;
+        job_ptr->job_class = 100 + (ii * 3) % 5 ;
+        job_ptr->phase = (ii % 4 == 0) ? 1 : 60000 ;
+        job_ptr->sim_object_id = ii / 25 ;
+        if ( ii < 100 ) {
+            sjq.push(job_ptr) ;
+        } else {
+            jobs.push_back(job_ptr) ;
+        }
+        push_sjq.push(job_ptr) ;
+        if ( jobs.size() == 50 ) {
+            sjq.push_all(jobs) ;
+            jobs.clear() ;
+        }
+    }
+
+    EXPECT_EQ( sjq.size() , push_sjq.size() ) ;
+    for ( jj = 0 ; jj < sjq.size() ; jj++ ) {
+        job_ptr = sjq.get_next_job() ;
+        push_job_ptr = push_sjq.get_next_job() ;
+        EXPECT_EQ( job_ptr , push_job_ptr ) ;
+        EXPECT_TRUE( job_ptr->handled ) ;
+    }
+}
+
+TEST_F( ScheduledJobQueueTest , PushAllKeepsCurrentJob ) {
+
+    std::vector< Trick::JobData * > jobs ;
+    Trick::JobData * job_ptr ;
+
+    job_ptr = new Trick::JobData(0, 1 , "class_100", NULL, 1.0 , "job_1") ;
+    job_ptr->job_class = 100 ;
+    sjq.push(job_ptr) ;
+
+    job_ptr = new Trick::JobData(0, 1 , "class_300", NULL, 1.0 , "job_3") ;
+    job_ptr->job_class = 300 ;
+    sjq.push(job_ptr) ;
+
+    job_ptr = sjq.get_next_job() ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_1") ;
+
+    job_ptr = new Trick::JobData(0, 1 , "class_50", NULL, 1.0 , "job_0") ;
+    job_ptr->job_class = 50 ;
+    jobs.push_back(job_ptr) ;
+    job_ptr = new Trick::JobData(0, 1 , "class_200", NULL, 1.0 , "job_2") ;
+    job_ptr->job_class = 200 ;
+    jobs.push_back(job_ptr) ;
+    sjq.push_all(jobs) ;
+
+    EXPECT_EQ( sjq.size() , (unsigned int)4) ;
+    EXPECT_EQ( sjq.get_curr_index() , (unsigned int)2) ;
+
+    job_ptr = sjq.get_next_job() ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_2") ;
+    job_ptr = sjq.get_next_job() ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_3") ;
+
+    sjq.reset_curr_index() ;
+    job_ptr = sjq.get_next_job() ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_0") ;
+}
+
+TEST_F( ScheduledJobQueueTest , RemoveJob ) {
+
+    Trick::JobData * job_ptr ;
+    Trick::JobData * remove_ptr ;
+
+    job_ptr = new Trick::JobData(0, 1 , "class_100", NULL, 1.0 , "job_1") ;
+    job_ptr->job_class = 100 ;
+    sjq.push(job_ptr) ;
+
+    remove_ptr = new Trick::JobData(0, 2 , "class_100", NULL, 1.0 , "job_2") ;
+    remove_ptr->job_class = 100 ;
+    sjq.push(remove_ptr) ;
+
+    job_ptr = new Trick::JobData(0, 3 , "class_100", NULL, 1.0 , "job_3") ;
+    job_ptr->job_class = 100 ;
+    sjq.push(job_ptr) ;
+
+    sjq.get_next_job() ;
+    sjq.get_next_job() ;
+    EXPECT_EQ( sjq.remove(remove_ptr) , 0 ) ;
+    EXPECT_EQ( sjq.remove(remove_ptr) , -1 ) ;
+    EXPECT_EQ( sjq.size() , (unsigned int)2) ;
+
+    job_ptr = sjq.get_next_job() ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_3") ;
+}
+
 TEST_F( ScheduledJobQueueTest , TopJob ) {
 	//req.add_requirement("");
 
@@ -516,6 +633,303 @@ TEST_F( ScheduledJobQueueTest , TestNextJob ) {
     EXPECT_TRUE( job_ptr == NULL ) ;
 }
 
+TEST_F( ScheduledJobQueueTest , DispatchScheduleFindNextJob ) {
+
+    Trick::JobData * job_ptr ;
+    Trick::JobData * job_2_ptr ;
+    long long curr_time ;
+
+    sjq.set_dispatch_schedule(true) ;
+    EXPECT_TRUE( sjq.get_dispatch_schedule() ) ;
+
+    job_ptr = new Trick::JobData(0, 2 , "class_100", NULL, 4.0 , "job_3") ;
+    job_ptr->sim_object_id = 2 ;
+    job_ptr->job_class = 100 ;
+    job_ptr->cycle_tics = (long long)(job_ptr->cycle * 1000000) ;
+    job_ptr->stop_tics = 1000000000 ;
+    sjq.push(job_ptr) ;
+
+    job_2_ptr = new Trick::JobData(0, 2 , "class_100", NULL, 2.0 , "job_2") ;
+    job_2_ptr->sim_object_id = 1 ;
+    job_2_ptr->job_class = 100 ;
+    job_2_ptr->cycle_tics = (long long)(job_2_ptr->cycle * 1000000) ;
+    job_2_ptr->stop_tics = 1000000000 ;
+    sjq.push(job_2_ptr) ;
+
+    job_ptr = new Trick::JobData(0, 2 , "class_100", NULL, 1.0 , "job_1") ;
+    job_ptr->sim_object_id = 1 ;
+    job_ptr->job_class = 50 ;
+    job_ptr->cycle_tics = (long long)(job_ptr->cycle * 1000000) ;
+    job_ptr->stop_tics = 1000000000 ;
+    sjq.push(job_ptr) ;
+
+    // Time = 0.0
+    curr_time = 0 ;
+    sjq.reset_curr_index() ;
+    sjq.set_next_job_call_time(1000000000) ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_1") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_2") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_3") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_TRUE( job_ptr == NULL ) ;
+
+    // Time = 1.0
+    curr_time = sjq.get_next_job_call_time() ;
+    EXPECT_EQ( curr_time , 1000000 ) ;
+    sjq.reset_curr_index() ;
+    sjq.set_next_job_call_time(1000000000) ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_1") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_TRUE( job_ptr == NULL ) ;
+
+    // Time = 2.0, job_2 is disabled but its next call time still advances
+    curr_time = sjq.get_next_job_call_time() ;
+    EXPECT_EQ( curr_time , 2000000 ) ;
+    job_2_ptr->disabled = true ;
+    sjq.reset_curr_index() ;
+    sjq.set_next_job_call_time(1000000000) ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_1") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_TRUE( job_ptr == NULL ) ;
+
+    // Time = 3.0, job_2 set to run at 3.5 and enabled
+    curr_time = sjq.get_next_job_call_time() ;
+    EXPECT_EQ( curr_time , 3000000 ) ;
+    EXPECT_EQ( job_2_ptr->next_tics , 4000000 ) ;
+    job_2_ptr->disabled = false ;
+    job_2_ptr->next_tics = 3500000 ;
+    EXPECT_EQ( sjq.reschedule_job(job_2_ptr) , 0 ) ;
+
+    sjq.reset_curr_index() ;
+    sjq.set_next_job_call_time(1000000000) ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_1") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_TRUE( job_ptr == NULL ) ;
+
+    // Time = 3.5
+    curr_time = sjq.get_next_job_call_time() ;
+    EXPECT_EQ( curr_time , 3500000 ) ;
+    sjq.reset_curr_index() ;
+    sjq.set_next_job_call_time(1000000000) ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_2") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_TRUE( job_ptr == NULL ) ;
+
+    // Time = 4.0
+    curr_time = sjq.get_next_job_call_time() ;
+    EXPECT_EQ( curr_time , 4000000 ) ;
+    sjq.reset_curr_index() ;
+    sjq.set_next_job_call_time(1000000000) ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_1") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_STREQ( job_ptr->name.c_str() , "job_3") ;
+
+    job_ptr = sjq.find_next_job(curr_time) ;
+    EXPECT_TRUE( job_ptr == NULL ) ;
+
+    // Time = 5.0
+    curr_time = sjq.get_next_job_call_time() ;
+    EXPECT_EQ( curr_time , 5000000 ) ;
+}
+
+TEST_F( ScheduledJobQueueTest , DispatchScheduleMatchesListScan ) {
+
+    Trick::ScheduledJobQueue list_sjq ;
+    Trick::JobData * job_ptr ;
+    Trick::JobData * list_job_ptr ;
+    long long curr_time , list_curr_time ;
+    unsigned int ii ;
+    int cycles[] = { 1 , 2 , 3 , 5 , 10 , 4 } ;
+
+    sjq.set_dispatch_schedule(true) ;
+
+    for ( ii = 0 ; ii < 60 ; ii++ ) {
+        job_ptr = new Trick::JobData(0, ii % 7 , "class_100", NULL, 0.001 * cycles[ii % 6] , "job") ;
+        job_ptr->sim_object_id = ii % 5 ;
+        job_ptr->job_class = 100 + (ii % 3) ;
+        job_ptr->cycle_tics = 1000 * cycles[ii % 6] ;
+        job_ptr->stop_tics = 1000000000 ;
+        job_ptr->next_tics = 1000 * (ii % 4) ;
+        job_ptr->system_job_class = ((ii % 11) == 0) ;
+        sjq.push(job_ptr) ;
+
+        list_job_ptr = new Trick::JobData(*job_ptr) ;
+        list_sjq.push(list_job_ptr) ;
+    }
+
+    curr_time = list_curr_time = 0 ;
+    for ( ii = 0 ; ii < 200 ; ii++ ) {
+        sjq.reset_curr_index() ;
+        sjq.set_next_job_call_time(1000000000) ;
+        list_sjq.reset_curr_index() ;
+        list_sjq.set_next_job_call_time(1000000000) ;
+        do {
+            job_ptr = sjq.find_next_job(curr_time) ;
+            list_job_ptr = list_sjq.find_next_job(list_curr_time) ;
+            ASSERT_EQ( job_ptr == NULL , list_job_ptr == NULL ) ;
+            if ( job_ptr != NULL ) {
+                EXPECT_EQ( job_ptr->job_class , list_job_ptr->job_class ) ;
+                EXPECT_EQ( job_ptr->sim_object_id , list_job_ptr->sim_object_id ) ;
+                EXPECT_EQ( job_ptr->id , list_job_ptr->id ) ;
+                EXPECT_EQ( job_ptr->next_tics , list_job_ptr->next_tics ) ;
+                // system jobs set their own next call time
+                if ( job_ptr->system_job_class ) {
+                    job_ptr->next_tics += 7000 ;
+                    sjq.test_next_job_call_time(job_ptr , curr_time) ;
+                    list_job_ptr->next_tics += 7000 ;
+                    list_sjq.test_next_job_call_time(list_job_ptr , list_curr_time) ;
+                }
+            }
+        } while ( job_ptr != NULL ) ;
+        curr_time = sjq.get_next_job_call_time() ;
+        list_curr_time = list_sjq.get_next_job_call_time() ;
+        ASSERT_EQ( curr_time , list_curr_time ) ;
+    }
+}
+
+TEST_F( ScheduledJobQueueTest , DispatchScheduleRandomMatchesListScan ) {
+
+    // Jobs are rescheduled earlier, moved later with and without reschedule_job, and stopped, while
+    // some cycles are longer than a turn of the timing wheel.
+    Trick::ScheduledJobQueue list_sjq ;
+    std::vector< Trick::JobData * > jobs , list_jobs ;
+    Trick::JobData * job_ptr ;
+    Trick::JobData * list_job_ptr ;
+    long long curr_time , list_curr_time , prev_time ;
+    unsigned int ii , jj ;
+    int cycles[] = { 1 , 2 , 3 , 7 , 10 , 5000 , 4 } ;
+
+    sjq.set_dispatch_schedule(true) ;
+    srand(1) ;
+
+    for ( ii = 0 ; ii < 50 ; ii++ ) {
+        job_ptr = new Trick::JobData(0, ii , "class_100", NULL, 0.001 * cycles[ii % 7] , "job") ;
+        job_ptr->sim_object_id = ii % 5 ;
+        job_ptr->job_class = 100 + (ii % 3) ;
+        job_ptr->cycle_tics = 1000 * cycles[ii % 7] ;
+        job_ptr->stop_tics = ( ii % 9 == 0 ) ? 40000 : 1000000000 ;
+        job_ptr->next_tics = 1000 * (ii % 4) ;
+        job_ptr->system_job_class = ((ii % 13) == 0) ;
+        sjq.push(job_ptr) ;
+        jobs.push_back(job_ptr) ;
+
+        list_job_ptr = new Trick::JobData(*job_ptr) ;
+        list_sjq.push(list_job_ptr) ;
+        list_jobs.push_back(list_job_ptr) ;
+    }
+
+    curr_time = list_curr_time = 0 ;
+    for ( ii = 0 ; ii < 2000 ; ii++ ) {
+        sjq.reset_curr_index() ;
+        sjq.set_next_job_call_time(1000000000) ;
+        list_sjq.reset_curr_index() ;
+        list_sjq.set_next_job_call_time(1000000000) ;
+        do {
+            job_ptr = sjq.find_next_job(curr_time) ;
+            list_job_ptr = list_sjq.find_next_job(list_curr_time) ;
+            ASSERT_EQ( job_ptr == NULL , list_job_ptr == NULL ) << "pass " << ii ;
+            if ( job_ptr != NULL ) {
+                ASSERT_EQ( job_ptr->id , list_job_ptr->id ) << "pass " << ii ;
+                if ( job_ptr->system_job_class ) {
+                    job_ptr->next_tics += 3000 ;
+                    sjq.test_next_job_call_time(job_ptr , curr_time) ;
+                    list_job_ptr->next_tics += 3000 ;
+                    list_sjq.test_next_job_call_time(list_job_ptr , list_curr_time) ;
+                }
+            }
+            // Change the next call time of a random job not reached yet in the pass, sometimes to the
+            // current time.  The list scan does not see changes to jobs it has passed.
+            jj = rand() % jobs.size() ;
+            if ( rand() % 4 == 0 and jobs[jj]->queue_index >= sjq.get_curr_index() ) {
+                prev_time = jobs[jj]->next_tics ;
+                switch ( rand() % 3 ) {
+                    case 0:
+                        jobs[jj]->next_tics = curr_time ;
+                        break ;
+                    case 1:
+                        jobs[jj]->next_tics = curr_time + 1000 * (rand() % 20 + 1) ;
+                        break ;
+                    default:
+                        jobs[jj]->next_tics = curr_time + 1000 * (rand() % 20000 + 1) ;
+                        break ;
+                }
+                list_jobs[jj]->next_tics = jobs[jj]->next_tics ;
+                // Only earlier times, and times due in the pass in progress, need to be refiled.
+                if ( jobs[jj]->next_tics < prev_time or jobs[jj]->next_tics == curr_time or rand() % 2 == 0 ) {
+                    EXPECT_EQ( sjq.reschedule_job(jobs[jj]) , 0 ) ;
+                }
+            }
+        } while ( job_ptr != NULL ) ;
+        curr_time = sjq.get_next_job_call_time() ;
+        list_curr_time = list_sjq.get_next_job_call_time() ;
+        ASSERT_EQ( curr_time , list_curr_time ) << "pass " << ii ;
+    }
+
+    job_ptr = new Trick::JobData(0, 100 , "class_100", NULL, 1.0 , "other") ;
+    EXPECT_EQ( sjq.reschedule_job(job_ptr) , -1 ) ;
+}
+
+TEST_F( ScheduledJobQueueTest , DispatchScheduleDoesNotAllocate ) {
+
+    Trick::JobData * job_ptr ;
+    long long curr_time ;
+    unsigned int ii ;
+
+    sjq.set_dispatch_schedule(true) ;
+    for ( ii = 0 ; ii < 200 ; ii++ ) {
+        job_ptr = new Trick::JobData(0, ii , "class_100", NULL, 0.001 * (ii % 10 + 1) , "job") ;
+        job_ptr->job_class = 100 ;
+        job_ptr->cycle_tics = 1000 * (ii % 10 + 1) ;
+        job_ptr->stop_tics = 1000000000 ;
+        job_ptr->next_tics = 1000 * (ii % 3) ;
+        sjq.push(job_ptr) ;
+    }
+
+    // The first pass builds the wheel.
+    curr_time = 0 ;
+    sjq.reset_curr_index() ;
+    while ( sjq.find_next_job(curr_time) != NULL ) ;
+
+    count_allocations = true ;
+    num_allocations = 0 ;
+    for ( ii = 0 ; ii < 1000 ; ii++ ) {
+        curr_time = sjq.get_next_job_call_time() ;
+        sjq.reset_curr_index() ;
+        sjq.set_next_job_call_time(1000000000) ;
+        while ( (job_ptr = sjq.find_next_job(curr_time)) != NULL ) {
+            if ( job_ptr->id % 7 == 0 ) {
+                job_ptr->next_tics = curr_time + 500 ;
+                sjq.reschedule_job(job_ptr) ;
+            }
+        }
+    }
+    count_allocations = false ;
+    EXPECT_EQ( num_allocations , 0u ) ;
+    EXPECT_GT( curr_time , 100000 ) ;
+}
+
 TEST_F( ScheduledJobQueueTest , InstrumentBeforeAll ) {
 	//req.add_requirement("3990429752");
 
@@ -22,6 +22,7 @@ Trick::JobData::JobData() {
     start = 0.0 ;
     stop = 0.0 ;
     complete = false ;
+    parallel = false ;
     rt_start_time = -1;
     phase = 60000 ;
     system_job_class = 0 ;
@@ -30,6 +31,7 @@ Trick::JobData::JobData() {
     start_tics = 0 ;
     stop_tics = 0 ;
     next_tics = 0 ;
+    queue_index = 0 ;
 
     frame_time = 0 ;
 }
@@ -53,6 +55,7 @@ Trick::JobData::JobData(int in_thread, int in_id, std::string in_job_class_name
     start = in_start ;
     stop = in_stop ;
     complete = false ;
+    parallel = false ;
     name = in_name ;
     add_tag(in_tag) ;
     rt_start_time = -1;
@@ -63,6 +66,7 @@ Trick::JobData::JobData(int in_thread, int in_id, std::string in_job_class_name
     start_tics = 0 ;
     stop_tics = 0 ;
     next_tics = 0 ;
+    queue_index = 0 ;
 
     frame_time = 0 ;
 }
@@ -221,6 +225,7 @@ int Trick::JobData::copy_from_checkpoint( JobData * in_job ) {
 
     disabled = in_job->disabled ;
     complete = in_job->complete ;
+    parallel = in_job->parallel ;
 
     handled = in_job->handled ;
 
@@ -0,0 +1,221 @@
+
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <algorithm>
+#include <pthread.h>
+
+#include "trick/VariableCopyPlan.hh"
+#include "trick/VariableServer.hh"
+#include "trick/variable_server_sync_types.h"
+
+/** One snapshot of grouped variables shared by the clients whose plans have the same segments. */
+struct Trick::VariableCopyPlan::SharedSnapshot {
+    std::string signature ;
+    std::vector< char > data ;
+    int phase ;
+    long long tics ;
+    unsigned int users ;
+    pthread_mutex_t mutex ;
+} ;
+
+/* The shared snapshots by signature, the bytes of the segment list */
+static std::map< std::string , Trick::VariableCopyPlan::SharedSnapshot * > shared_snapshots ;
+static pthread_mutex_t shared_snapshots_mutex = PTHREAD_MUTEX_INITIALIZER ;
+
+/* Destination alignment.  The offset of a segment in the block is congruent to its source address
+   modulo this so every value in the segment keeps the alignment it has in the simulation. */
+static const size_t segment_alignment = 16 ;
+
+Trick::VariableCopyPlan::VariableCopyPlan() :
+ valid(false) ,
+ generation(0) ,
+ block_size(0) ,
+ shared(NULL) {
+    blocks[0] = blocks[1] = NULL ;
+}
+
+Trick::VariableCopyPlan::~VariableCopyPlan() {
+    release() ;
+}
+
+void Trick::VariableCopyPlan::release() {
+    if ( shared != NULL ) {
+        pthread_mutex_lock(&shared_snapshots_mutex) ;
+        if ( --shared->users == 0 ) {
+            shared_snapshots.erase(shared->signature) ;
+            pthread_mutex_destroy(&shared->mutex) ;
+            delete shared ;
+        }
+        pthread_mutex_unlock(&shared_snapshots_mutex) ;
+        shared = NULL ;
+    }
+    free(blocks[0]) ;
+    free(blocks[1]) ;
+    blocks[0] = blocks[1] = NULL ;
+    block_size = 0 ;
+}
+
+static bool by_address( Trick::VariableReference * a , Trick::VariableReference * b ) {
+    return (char *)a->address < (char *)b->address ;
+}
+
+/**
+@details
+-# Group the variables that are resolved, have no pointer in their address path, are not dereferenced,
+   are not strings, and do not belong to the client.  The rest are copied one at a time.
+-# Sort the grouped variables by address.  Lay their buffers out in that order keeping the source
+   alignment, and merge variables whose memory touches into one segment.
+-# Allocate the in and out blocks and move the grouped buffers into them with their contents.  Variables
+   that are no longer grouped go back to their own buffers.  Only variables in the current list are touched,
+   removed variables are already deleted.
+-# Free the previous blocks.
+-# If sharing, join the snapshot with the same segment list, creating it if needed.
+-# Remember the allocation generation.  The plan is out of date when it changes.
+*/
+void Trick::VariableCopyPlan::build( std::vector< VariableReference * > & vars , void * private_address , bool share ,
+ unsigned long long alloc_generation ) {
+
+    unsigned int ii ;
+    std::vector< VariableReference * > new_grouped ;
+    std::vector< size_t > new_offsets ;
+    std::vector< Segment > new_segments ;
+    size_t new_size = 0 ;
+
+    single_vars.clear() ;
+    for ( ii = 0 ; ii < vars.size() ; ii++ ) {
+        VariableReference * var = vars[ii] ;
+        /* unresolved variables have the error type */
+        if ( var->ref->attr->type != TRICK_NUMBER_OF_TYPES and
+             var->ref->pointer_present != 1 and
+             ! var->need_deref and
+             var->string_type != TRICK_STRING and
+             var->string_type != TRICK_WSTRING and
+             var->address != private_address and
+             var->address != NULL and
+             var->size > 0 ) {
+            new_grouped.push_back(var) ;
+        } else {
+            single_vars.push_back(var) ;
+        }
+    }
+
+    std::stable_sort(new_grouped.begin(), new_grouped.end(), by_address) ;
+
+    for ( ii = 0 ; ii < new_grouped.size() ; ii++ ) {
+        const char * source = (const char *)new_grouped[ii]->address ;
+        size_t size = new_grouped[ii]->size ;
+
+        if ( ! new_segments.empty() ) {
+            Segment & last = new_segments.back() ;
+            if ( source >= last.source and source <= last.source + last.size ) {
+                /* overlaps or touches the previous segment */
+                size_t end = std::max(last.size, (size_t)(source - last.source) + size) ;
+                new_offsets.push_back(last.offset + (source - last.source)) ;
+                new_size += end - last.size ;
+                last.size = end ;
+                continue ;
+            }
+        }
+        Segment seg ;
+        seg.source = source ;
+        seg.offset = (new_size + segment_alignment - 1) / segment_alignment * segment_alignment +
+         (size_t)source % segment_alignment ;
+        seg.size = size ;
+        new_offsets.push_back(seg.offset) ;
+        new_segments.push_back(seg) ;
+        new_size = seg.offset + size ;
+    }
+
+    char * new_blocks[2] = { NULL , NULL } ;
+    if ( new_size > 0 ) {
+        new_blocks[0] = (char *)calloc(new_size, 1) ;
+        new_blocks[1] = (char *)calloc(new_size, 1) ;
+    }
+
+    /* move the buffers keeping the data that is waiting to be written */
+    for ( ii = 0 ; ii < vars.size() ; ii++ ) {
+        VariableReference * var = vars[ii] ;
+        if ( var->buffer_in != var->own_buffer_in ) {
+            memcpy(var->own_buffer_in, var->buffer_in, var->size) ;
+            memcpy(var->own_buffer_out, var->buffer_out, var->size) ;
+            var->buffer_in = var->own_buffer_in ;
+            var->buffer_out = var->own_buffer_out ;
+        }
+    }
+    for ( ii = 0 ; ii < new_grouped.size() ; ii++ ) {
+        VariableReference * var = new_grouped[ii] ;
+        memcpy(new_blocks[0] + new_offsets[ii], var->buffer_in, var->size) ;
+        memcpy(new_blocks[1] + new_offsets[ii], var->buffer_out, var->size) ;
+        var->buffer_in = new_blocks[0] + new_offsets[ii] ;
+        var->buffer_out = new_blocks[1] + new_offsets[ii] ;
+    }
+
+    release() ;
+    blocks[0] = new_blocks[0] ;
+    blocks[1] = new_blocks[1] ;
+    block_size = new_size ;
+    grouped_vars.swap(new_grouped) ;
+    grouped_offsets.swap(new_offsets) ;
+    segments.swap(new_segments) ;
+
+    if ( share and ! segments.empty() ) {
+        std::string signature((const char *)&segments[0], segments.size() * sizeof(Segment)) ;
+        pthread_mutex_lock(&shared_snapshots_mutex) ;
+        std::map< std::string , SharedSnapshot * >::iterator it = shared_snapshots.find(signature) ;
+        if ( it == shared_snapshots.end() ) {
+            shared = new SharedSnapshot ;
+            shared->signature = signature ;
+            shared->data.resize(block_size) ;
+            shared->phase = VS_COPY_ASYNC ;
+            shared->tics = -1 ;
+            shared->users = 0 ;
+            pthread_mutex_init(&shared->mutex, NULL) ;
+            shared_snapshots[signature] = shared ;
+        } else {
+            shared = it->second ;
+        }
+        shared->users++ ;
+        pthread_mutex_unlock(&shared_snapshots_mutex) ;
+    }
+
+    generation = alloc_generation ;
+    valid = true ;
+}
+
+void Trick::VariableCopyPlan::gather( char * block ) {
+    std::vector< Segment >::const_iterator it ;
+    for ( it = segments.begin() ; it != segments.end() ; ++it ) {
+        memcpy(block + it->offset, it->source, it->size) ;
+    }
+}
+
+/**
+@details
+-# Find the block the grouped variables are using for buffer_in.  write_data swaps buffer_in and
+   buffer_out of every variable together so all of them use the same block.
+-# If sharing and another client already copied in this phase at this time, copy the snapshot.
+   Otherwise gather the segments and, if sharing, save them as the snapshot of this phase and time.
+*/
+void Trick::VariableCopyPlan::copy( long long tics , int share_phase ) {
+
+    if ( grouped_vars.empty() ) {
+        return ;
+    }
+    char * block = (char *)grouped_vars[0]->buffer_in - grouped_offsets[0] ;
+
+    if ( share_phase != VS_COPY_ASYNC and shared != NULL ) {
+        pthread_mutex_lock(&shared->mutex) ;
+        if ( shared->phase == share_phase and shared->tics == tics ) {
+            memcpy(block, &shared->data[0], block_size) ;
+        } else {
+            gather(block) ;
+            memcpy(&shared->data[0], block, block_size) ;
+            shared->phase = share_phase ;
+            shared->tics = tics ;
+        }
+        pthread_mutex_unlock(&shared->mutex) ;
+    } else {
+        gather(block) ;
+    }
+}
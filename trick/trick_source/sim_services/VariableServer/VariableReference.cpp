@@ -57,14 +57,16 @@ Trick::VariableReference::VariableReference(REF2 * in_ref ) {
         size = MAX_ARRAY_LENGTH ;
     }
 
-    buffer_in  = calloc( size, 1 ) ;
-    buffer_out = calloc( size, 1 ) ;
+    buffer_in  = own_buffer_in  = calloc( size, 1 ) ;
+    buffer_out = own_buffer_out = calloc( size, 1 ) ;
 
+    validated_address = NULL ;
+    validated_generation = 0 ;
 
 }
 
 Trick::VariableReference::~VariableReference() {
     free(ref) ;
-    free(buffer_in) ;
-    free(buffer_out) ;
+    free(own_buffer_in) ;
+    free(own_buffer_out) ;
 }
@@ -1,5 +1,6 @@
 
 #include <netdb.h>
+#include <algorithm>
 #include "trick/VariableServer.hh"
 #include "trick/tc_proto.h"
 
@@ -8,7 +9,9 @@ Trick::VariableServer * the_vs ;
 Trick::VariableServer::VariableServer() :
  enabled(true) ,
  info_msg(false),
- log(false)
+ log(false),
+ num_event_loops(0),
+ event_output_limit(1048576)
 {
     the_vs = this ;
     pthread_mutex_init(&map_mutex, NULL);
@@ -44,19 +47,23 @@ bool Trick::VariableServer::get_log() {
 void Trick::VariableServer::set_var_server_log_on() {
     log = true;
     // turn log on for all current vs clients
-    std::map < pthread_t , VariableServerThread * >::iterator it ;
-    for ( it = var_server_threads.begin() ; it != var_server_threads.end() ; it++ ) {
-        (*it).second->set_log_on();
+    std::vector < VariableServerThread * >::iterator it ;
+    pthread_mutex_lock(&map_mutex) ;
+    for ( it = clients.begin() ; it != clients.end() ; it++ ) {
+        (*it)->set_log_on();
     }
+    pthread_mutex_unlock(&map_mutex) ;
 }
 
 void Trick::VariableServer::set_var_server_log_off() {
     log = false;
     // turn log off for all current vs clients
-    std::map < pthread_t , VariableServerThread * >::iterator it ;
-    for ( it = var_server_threads.begin() ; it != var_server_threads.end() ; it++ ) {
-        (*it).second->set_log_off();
+    std::vector < VariableServerThread * >::iterator it ;
+    pthread_mutex_lock(&map_mutex) ;
+    for ( it = clients.begin() ; it != clients.end() ; it++ ) {
+        (*it)->set_log_off();
     }
+    pthread_mutex_unlock(&map_mutex) ;
 }
 
 const char * Trick::VariableServer::get_hostname() {
@@ -70,6 +77,7 @@ Trick::VariableServerListenThread & Trick::VariableServer::get_listen_thread() {
 void Trick::VariableServer::add_vst(pthread_t in_thread_id, VariableServerThread * in_vst) {
     pthread_mutex_lock(&map_mutex) ;
     var_server_threads[in_thread_id] = in_vst ;
+    clients.push_back(in_vst) ;
     pthread_mutex_unlock(&map_mutex) ;
 }
 
@@ -80,17 +88,76 @@ Trick::VariableServerThread * Trick::VariableServer::get_vst(pthread_t thread_id
     it = var_server_threads.find(thread_id) ;
     if ( it != var_server_threads.end() ) {
         ret = (*it).second ;
+    } else {
+        it = event_loop_vsts.find(thread_id) ;
+        if ( it != event_loop_vsts.end() ) {
+            ret = (*it).second ;
+        }
     }
     pthread_mutex_unlock(&map_mutex) ;
     return ret ;
 }
 
 void Trick::VariableServer::delete_vst(pthread_t thread_id) {
+    std::map < pthread_t , Trick::VariableServerThread * >::iterator it ;
     pthread_mutex_lock(&map_mutex) ;
-    var_server_threads.erase(thread_id) ;
+    it = var_server_threads.find(thread_id) ;
+    if ( it != var_server_threads.end() ) {
+        clients.erase(std::remove(clients.begin(), clients.end(), (*it).second), clients.end()) ;
+        var_server_threads.erase(it) ;
+    }
     pthread_mutex_unlock(&map_mutex) ;
 }
 
+void Trick::VariableServer::add_event_client(VariableServerThread * in_vst) {
+    pthread_mutex_lock(&map_mutex) ;
+    clients.push_back(in_vst) ;
+    pthread_mutex_unlock(&map_mutex) ;
+}
+
+void Trick::VariableServer::delete_event_client(VariableServerThread * in_vst) {
+    pthread_mutex_lock(&map_mutex) ;
+    clients.erase(std::remove(clients.begin(), clients.end(), in_vst), clients.end()) ;
+    pthread_mutex_unlock(&map_mutex) ;
+}
+
+void Trick::VariableServer::set_event_loop_vst(pthread_t thread_id, VariableServerThread * in_vst) {
+    pthread_mutex_lock(&map_mutex) ;
+    if ( in_vst == NULL ) {
+        event_loop_vsts.erase(thread_id) ;
+    } else {
+        event_loop_vsts[thread_id] = in_vst ;
+    }
+    pthread_mutex_unlock(&map_mutex) ;
+}
+
+void Trick::VariableServer::set_num_event_loops(unsigned int num_loops) {
+    num_event_loops = num_loops ;
+}
+
+unsigned int Trick::VariableServer::get_num_event_loops() {
+    return num_event_loops ;
+}
+
+void Trick::VariableServer::set_event_output_limit(unsigned int in_limit) {
+    event_output_limit = in_limit ;
+}
+
+unsigned int Trick::VariableServer::get_event_output_limit() {
+    return event_output_limit ;
+}
+
+Trick::VariableServerEventLoop * Trick::VariableServer::get_event_loop() {
+    Trick::VariableServerEventLoop * ret = NULL ;
+    unsigned int ii ;
+    for ( ii = 0 ; ii < event_loops.size() ; ii++ ) {
+        if ( ret == NULL or event_loops[ii]->get_num_clients() < ret->get_num_clients() ) {
+            ret = event_loops[ii] ;
+        }
+    }
+    return ret ;
+}
+
 void Trick::VariableServer::set_copy_data_job( Trick::JobData * in_job ) {
     copy_data_job = in_job ;
 }
@@ -0,0 +1,230 @@
+
+#include <algorithm>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+#include "trick/VariableServerEventLoop.hh"
+#include "trick/VariableServer.hh"
+#include "trick/ExecutiveException.hh"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+#include "trick/tc_proto.h"
+
+/* Number of events handled per epoll_wait */
+static const int max_events = 256 ;
+
+/* Longest wait in milliseconds when no client is due */
+static const int max_wait_ms = 100 ;
+
+static double monotonic_time() {
+    struct timespec ts ;
+    clock_gettime(CLOCK_MONOTONIC, &ts) ;
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9 ;
+}
+
+static void exit_event_loop(void * in_loop) {
+    ((Trick::VariableServerEventLoop *)in_loop)->remove_all_clients() ;
+}
+
+Trick::VariableServerEventLoop::VariableServerEventLoop() :
+ Trick::ThreadBase("VarServEvent") ,
+ epoll_fd(-1) ,
+ wake_fd(-1) ,
+ num_clients(0) {
+    pthread_mutex_init(&new_clients_mutex, NULL) ;
+}
+
+Trick::VariableServerEventLoop::~VariableServerEventLoop() {
+    if ( epoll_fd != -1 ) {
+        close(epoll_fd) ;
+    }
+    if ( wake_fd != -1 ) {
+        close(wake_fd) ;
+    }
+    pthread_mutex_destroy(&new_clients_mutex) ;
+}
+
+int Trick::VariableServerEventLoop::init() {
+#ifdef __linux
+    struct epoll_event ev ;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC) ;
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) ;
+    if ( epoll_fd == -1 or wake_fd == -1 ) {
+        message_publish(MSG_ERROR, "Variable Server event loop could not create epoll descriptors: %s\n", strerror(errno)) ;
+        return -1 ;
+    }
+    ev.events = EPOLLIN ;
+    ev.data.ptr = NULL ;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) ;
+    return 0 ;
+#else
+    message_publish(MSG_WARNING, "Variable Server event loops require epoll, serving each client on its own thread.\n") ;
+    return -1 ;
+#endif
+}
+
+void Trick::VariableServerEventLoop::add_client( VariableServerThread * vst ) {
+    pthread_mutex_lock(&new_clients_mutex) ;
+    new_clients.push_back(vst) ;
+    num_clients++ ;
+    pthread_mutex_unlock(&new_clients_mutex) ;
+#ifdef __linux
+    uint64_t one = 1 ;
+    if ( write(wake_fd, &one, sizeof(one)) < 0 ) {
+        // The counter is already nonzero, the loop will wake up.
+    }
+#endif
+}
+
+unsigned int Trick::VariableServerEventLoop::get_num_clients() {
+    return num_clients ;
+}
+
+void Trick::VariableServerEventLoop::register_new_clients() {
+#ifdef __linux
+    std::vector < VariableServerThread * > added ;
+    struct epoll_event ev ;
+    uint64_t count ;
+
+    if ( read(wake_fd, &count, sizeof(count)) < 0 ) {
+        // Another add_client may have been drained already.
+    }
+
+    pthread_mutex_lock(&new_clients_mutex) ;
+    added.swap(new_clients) ;
+    pthread_mutex_unlock(&new_clients_mutex) ;
+
+    for ( unsigned int ii = 0 ; ii < added.size() ; ii++ ) {
+        VariableServerThread * vst = added[ii] ;
+        // Edge triggered, read_event_commands reads and flush_event_output sends until the socket would block.
+        // EPOLLOUT only comes when a full socket has room again.
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET ;
+        ev.data.ptr = vst ;
+        vst->get_vs()->add_event_client(vst) ;
+        clients.push_back(vst) ;
+        if ( epoll_ctl(epoll_fd, EPOLL_CTL_ADD, vst->get_connection().socket, &ev) != 0 ) {
+            message_publish(MSG_ERROR, "Variable Server event loop could not wait on client socket: %s\n", strerror(errno)) ;
+            remove_client(vst) ;
+        }
+    }
+#endif
+}
+
+void Trick::VariableServerEventLoop::remove_client( VariableServerThread * vst ) {
+#ifdef __linux
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, vst->get_connection().socket, NULL) ;
+#endif
+    // After this the main thread copy jobs no longer see the client.
+    vst->get_vs()->delete_event_client(vst) ;
+    clients.erase(std::find(clients.begin(), clients.end(), vst)) ;
+    pthread_mutex_lock(&new_clients_mutex) ;
+    num_clients-- ;
+    pthread_mutex_unlock(&new_clients_mutex) ;
+    tc_disconnect(&vst->get_connection()) ;
+    delete vst ;
+}
+
+void Trick::VariableServerEventLoop::remove_all_clients() {
+    while ( ! clients.empty() ) {
+        remove_client(clients.back()) ;
+    }
+    pthread_mutex_lock(&new_clients_mutex) ;
+    for ( unsigned int ii = 0 ; ii < new_clients.size() ; ii++ ) {
+        tc_disconnect(&new_clients[ii]->get_connection()) ;
+        delete new_clients[ii] ;
+    }
+    new_clients.clear() ;
+    num_clients = 0 ;
+    pthread_mutex_unlock(&new_clients_mutex) ;
+}
+
+/**
+@details
+-# Wait for a readable client socket, a new client, or the next client cycle time.
+-# Register new clients
+-# Send the data held for each writable client.  Read and parse the commands of each readable client.
+   Remove clients that disconnected, sent var_exit, or hold too much data.  Commands such as var_cycle
+   may move the next cycle time earlier.
+-# When the earliest cycle time of the clients is reached, service every client that is due and
+   find the next cycle time.  Remove clients whose write failed.  Writes never block the loop, what a
+   client's socket does not take is held until EPOLLOUT.
+*/
+void * Trick::VariableServerEventLoop::thread_body() {
+
+#ifdef __linux
+    struct epoll_event events[max_events] ;
+    double now ;
+    double next_service = 0.0 ;
+    int timeout_ms ;
+    int num_events ;
+    int ii ;
+
+    pthread_cleanup_push(exit_event_loop, (void *) this);
+
+    try {
+        while (1) {
+
+            now = monotonic_time() ;
+            if ( next_service <= now ) {
+                timeout_ms = 0 ;
+            } else {
+                timeout_ms = (int)((next_service - now) * 1000.0) + 1 ;
+                if ( timeout_ms > max_wait_ms ) {
+                    timeout_ms = max_wait_ms ;
+                }
+            }
+
+            num_events = epoll_wait(epoll_fd, events, max_events, timeout_ms) ;
+            if ( num_events < 0 and errno != EINTR ) {
+                message_publish(MSG_ERROR, "Variable Server event loop epoll_wait failed: %s\n", strerror(errno)) ;
+                break ;
+            }
+
+            for ( ii = 0 ; ii < num_events ; ii++ ) {
+                VariableServerThread * vst = (VariableServerThread *)events[ii].data.ptr ;
+                if ( vst == NULL ) {
+                    register_new_clients() ;
+                    next_service = 0.0 ;
+                } else if ( ((events[ii].events & EPOLLOUT) and vst->flush_event_output() < 0) or
+                            ((events[ii].events & ~EPOLLOUT) and vst->read_event_commands() < 0) ) {
+                    remove_client(vst) ;
+                } else {
+                    next_service = std::min(next_service, vst->get_next_event_time()) ;
+                }
+            }
+
+            now = monotonic_time() ;
+            if ( next_service <= now ) {
+                next_service = now + max_wait_ms * 1.0e-3 ;
+                for ( ii = (int)clients.size() - 1 ; ii >= 0 ; ii-- ) {
+                    VariableServerThread * vst = clients[ii] ;
+                    if ( vst->service_event(now) < 0 ) {
+                        remove_client(vst) ;
+                    } else {
+                        next_service = std::min(next_service, vst->get_next_event_time()) ;
+                    }
+                }
+            }
+        }
+    } catch (Trick::ExecutiveException & ex ) {
+        message_publish(MSG_ERROR, "\nVARIABLE SERVER COMMANDED exec_terminate\n  ROUTINE: %s\n  DIAGNOSTIC: %s\n" ,
+         ex.file.c_str(), ex.message.c_str()) ;
+        exit(ex.ret_code) ;
+    } catch (const std::exception &ex) {
+        message_publish(MSG_ERROR, "\nVARIABLE SERVER caught std::exception\n  DIAGNOSTIC: %s\n" ,
+         ex.what()) ;
+        exit(-1) ;
+    }
+
+    pthread_cleanup_pop(1);
+#endif
+    return NULL ;
+}
@@ -3,7 +3,7 @@
 #include <pwd.h>
 
 #include "trick/VariableServerListenThread.hh"
-#include "trick/VariableServerThread.hh"
+#include "trick/VariableServer.hh"
 #include "trick/tc_proto.h"
 #include "trick/exec_proto.h"
 #include "trick/command_line_protos.h"
@@ -112,6 +112,7 @@ void * Trick::VariableServerListenThread::thread_body() {
     char buf1[1024] = { 0 } ;
     struct passwd * passp ;
     Trick::VariableServerThread * vst ;
+    Trick::VariableServerEventLoop * event_loop ;
     int value;
     std::string version;
     char * user_name ;
@@ -173,9 +174,19 @@ void * Trick::VariableServerListenThread::thread_body() {
             // pause here during restart
             pthread_mutex_lock(&restart_pause) ;
             vst = new Trick::VariableServerThread(&listen_dev) ;
-            vst->copy_cpus(get_cpus()) ;
-            vst->create_thread() ;
-            vst->wait_for_accept() ;
+            event_loop = var_server_get_var_server()->get_event_loop() ;
+            if ( event_loop != NULL ) {
+                // Serve the client on the least busy event loop instead of its own thread
+                if ( vst->accept_event_connection(var_server_get_var_server()->get_event_output_limit()) == 0 ) {
+                    event_loop->add_client(vst) ;
+                } else {
+                    delete vst ;
+                }
+            } else {
+                vst->copy_cpus(get_cpus()) ;
+                vst->create_thread() ;
+                vst->wait_for_accept() ;
+            }
             pthread_mutex_unlock(&restart_pause) ;
         } else {
             if ( broadcast ) {
@@ -22,6 +22,8 @@ Trick::VariableServerThread::VariableServerThread(TCDevice * in_listen_dev) :
     freeze_frame_multiple = 1 ;
     freeze_frame_offset = 0 ;
     binary_data = false;
+    ascii_round_trip = false;
+    share_snapshot = false;
     multicast = false;
     byteswap = false ;
 
@@ -49,9 +51,13 @@ Trick::VariableServerThread::VariableServerThread(TCDevice * in_listen_dev) :
 
     pthread_mutex_init(&copy_mutex, NULL);
     pthread_mutex_init(&restart_pause, NULL);
+    pthread_mutex_init(&event_output_mutex, NULL);
 
     var_data_staged = false;
     packets_copied = 0 ;
+    next_event_time = 0.0 ;
+    event_client = false ;
+    event_output_limit = 0 ;
 
     incoming_msg = (char *) calloc(1, MAX_CMD_LEN);
     stripped_msg = (char *) calloc(1, MAX_CMD_LEN);
@@ -101,4 +107,8 @@ TCDevice & Trick::VariableServerThread::get_connection() {
     return connection ;
 }
 
+double Trick::VariableServerThread::get_next_event_time() {
+    return next_event_time ;
+}
+
 
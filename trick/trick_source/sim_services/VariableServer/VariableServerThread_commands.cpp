@@ -83,6 +83,7 @@ int Trick::VariableServerThread::var_add(std::string in_name) {
 
     new_var = new VariableReference(new_ref) ;
     vars.push_back(new_var) ;
+    copy_plan.invalidate() ;
 
     return(0) ;
 }
@@ -93,12 +94,29 @@ int Trick::VariableServerThread::var_add(std::string var_name, std::string units
     return(0) ;
 }
 
+int Trick::VariableServerThread::var_add_list(std::string in_names) {
+
+    std::stringstream names(in_names) ;
+    std::string name ;
+
+    while ( std::getline(names, name, ',') ) {
+        size_t first = name.find_first_not_of(" \t") ;
+        if ( first != std::string::npos ) {
+            size_t last = name.find_last_not_of(" \t") ;
+            var_add(name.substr(first, last - first + 1)) ;
+        }
+    }
+
+    return(0) ;
+}
+
 int Trick::VariableServerThread::var_remove(std::string in_name) {
 
     unsigned int ii ;
     for ( ii = 0 ; ii < vars.size() ; ii++ ) {
         std::string var_name = vars[ii]->ref->reference;
         if ( ! var_name.compare(in_name) ) {
+            copy_plan.invalidate() ;
             delete vars[ii];
             vars.erase(vars.begin() + ii) ;
             break ;
@@ -195,20 +213,21 @@ int Trick::VariableServerThread::var_exists(std::string in_name) {
         if (debug >= 2) {
             message_publish(MSG_DEBUG, "%p tag=<%s> var_server sending 1 binary byte\n", &connection, connection.client_tag);
         }
-        tc_write(&connection, (char *) buf1, 5);
+        write_connection(buf1, 5);
     } else {
         /* send ascii "1" or "0" */
         sprintf(buf1, "%d\t%d\n", VS_VAR_EXISTS, (error==false));
         if (debug >= 2) {
             message_publish(MSG_DEBUG, "%p tag=<%s> var_server sending:\n%s\n", &connection, connection.client_tag, buf1) ;
         }
-        tc_write(&connection, (char *) buf1, strlen(buf1));
+        write_connection(buf1, strlen(buf1));
     }
 
     return(0) ;
 }
 
 int Trick::VariableServerThread::var_clear() {
+    copy_plan.invalidate() ;
     while( !vars.empty() ) {
         delete vars.back();
         vars.pop_back();
@@ -267,6 +286,17 @@ int Trick::VariableServerThread::var_binary_nonames() {
     return(0) ;
 }
 
+int Trick::VariableServerThread::var_ascii_round_trip(bool on_off) {
+    ascii_round_trip = on_off ;
+    return(0) ;
+}
+
+int Trick::VariableServerThread::var_share_snapshot(bool on_off) {
+    share_snapshot = on_off ;
+    copy_plan.invalidate() ;
+    return(0) ;
+}
+
 int Trick::VariableServerThread::var_set_copy_mode(int mode) {
     if ( mode >= VS_COPY_ASYNC and mode <= VS_COPY_TOP_OF_FRAME ) {
         copy_mode = (VS_COPY_MODE)mode ;
@@ -388,14 +418,14 @@ int Trick::VariableServerThread::send_list_size() {
         if (debug >= 2) {
             message_publish(MSG_DEBUG, "%p tag=<%s> var_server sending %d event variables\n", &connection, connection.client_tag, var_count);
         }
-        tc_write(&connection, (char *) buf1, 12);
+        write_connection(buf1, 12);
     } else {
         // ascii
         sprintf(buf1, "%d\t%d\n", VS_LIST_SIZE, var_count);
         if (debug >= 2) {
             message_publish(MSG_DEBUG, "%p tag=<%s> var_server sending number of event variables:\n%s\n", &connection, connection.client_tag, buf1) ;
         }
-        tc_write(&connection, (char *) buf1, strlen(buf1));
+        write_connection(buf1, strlen(buf1));
     }
 
     return 0 ;
@@ -417,7 +447,7 @@ int Trick::VariableServerThread::transmit_file(std::string sie_file) {
     if ((fp = fopen(sie_file.c_str() , "r")) == NULL ) {
         message_publish(MSG_ERROR,"Variable Server Error: Cannot open %s.\n", sie_file.c_str()) ;
         sprintf(buffer, "%d\t-1\n", VS_SIE_RESOURCE) ;
-        tc_write(&connection , buffer , strlen(buffer)) ;
+        write_connection(buffer , strlen(buffer)) ;
         return(-1) ;
     }
 
@@ -425,17 +455,18 @@ int Trick::VariableServerThread::transmit_file(std::string sie_file) {
     file_size = ftell(fp) ;
 
     sprintf(buffer, "%d\t%d\n" , VS_SIE_RESOURCE, file_size) ;
-    tc_write(&connection , buffer , strlen(buffer)) ;
+    write_connection(buffer , strlen(buffer)) ;
     rewind(fp) ;
 
-    // Switch to blocking writes since this could be a large transfer.
-    if (tc_blockio(&connection, TC_COMM_BLOCKIO)) {
+    // Switch to blocking writes since this could be a large transfer.  An event loop must not block, it
+    // holds the whole file for the client instead.
+    if (!event_client and tc_blockio(&connection, TC_COMM_BLOCKIO)) {
         message_publish(MSG_DEBUG,"Variable Server Error: Failed to set TCDevice to TC_COMM_BLOCKIO.\n");
     }
 
     while ( current_size < file_size ) {
         bytes_read = fread(buffer , 1 , packet_size , fp) ;
-        ret = tc_write(&connection , buffer , bytes_read ) ;
+        ret = write_connection(buffer , bytes_read , false ) ;
         if (ret != (int)bytes_read) {
             message_publish(MSG_ERROR,"Variable Server Error: Failed to send SIE file.\n", sie_file.c_str()) ;
             return(-1);
@@ -444,7 +475,7 @@ int Trick::VariableServerThread::transmit_file(std::string sie_file) {
     }
 
     // Switch back to non-blocking writes.
-    if (tc_blockio(&connection, TC_COMM_NOBLOCKIO)) {
+    if (!event_client and tc_blockio(&connection, TC_COMM_NOBLOCKIO)) {
         message_publish(MSG_ERROR,"Variable Server Error: Failed to set TCDevice to TC_COMM_NOBLOCKIO.\n");
         return(-1);
     }
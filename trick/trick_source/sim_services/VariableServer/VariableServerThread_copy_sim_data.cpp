@@ -6,88 +6,126 @@
 #include "trick/memorymanager_c_intf.h"
 #include "trick/exec_proto.h"
 
-int Trick::VariableServerThread::copy_sim_data() {
-
-    unsigned int ii ;
-    VariableReference * curr_var ;
-
-    if ( vars.size() == 0 ) {
-        return 0 ;
+/**
+@details
+-# If the variable is unresolved, try to resolve it
+-# If there is a pointer in the address path, follow it in case the pointer changed.  With validate_address
+   on, the memory manager is searched for the address only when the address or the memory manager's
+   allocations changed since the last search.
+-# Find the address and size of strings and dereferenced pointers
+-# Copy the variable to buffer_in
+*/
+void Trick::VariableServerThread::copy_variable( VariableReference * curr_var ) {
+
+    // if this variable is unresolved, try to resolve it
+    if (curr_var->ref->address == &bad_ref_int) {
+        REF2 *new_ref = ref_attributes(const_cast<char*>(curr_var->ref->reference));
+        if (new_ref != NULL) {
+            curr_var->ref = new_ref;
+        }
     }
 
-    if ( pthread_mutex_trylock(&copy_mutex) == 0 ) {
-
-        // Get the simulation time we start this copy
-        time = (double)exec_get_time_tics() / exec_get_time_tic_value() ;
-
-        for ( ii = 0 ; ii < vars.size() ; ii++ ) {
-            curr_var = vars[ii] ;
-
-            // if this variable is unresolved, try to resolve it
-            if (curr_var->ref->address == &bad_ref_int) {
-                REF2 *new_ref = ref_attributes(const_cast<char*>(curr_var->ref->reference));
-                if (new_ref != NULL) {
-                    curr_var->ref = new_ref;
-                }
-            }
-
-            // if there's a pointer somewhere in the address path, follow it in case pointer changed
-            if ( curr_var->ref->pointer_present == 1 ) {
-                curr_var->address = follow_address_path(curr_var->ref) ;
-                if (curr_var->address == NULL) {
-                    std::string save_name(curr_var->ref->reference) ;
-                    free(curr_var->ref) ;
-                    curr_var->ref = make_error_ref(save_name) ;
-                    curr_var->address = curr_var->ref->address ;
-                } else if ( validate_address ) {
-                    // The address is not NULL.
-                    // If validate_address is on, check the memory manager if the address falls into
-                    // any of the memory blocks it knows of.  Don't do this if we have a std::string or
-                    // wstring type, or we already are pointing to a bad ref.
-                    if ( (curr_var->string_type != TRICK_STRING) and
-                         (curr_var->string_type != TRICK_WSTRING) and
-                         (curr_var->ref->address != &bad_ref_int) and
-                         (get_alloc_info_of(curr_var->address) == NULL) ) {
+    // if there's a pointer somewhere in the address path, follow it in case pointer changed
+    if ( curr_var->ref->pointer_present == 1 ) {
+        curr_var->address = follow_address_path(curr_var->ref) ;
+        if (curr_var->address == NULL) {
+            std::string save_name(curr_var->ref->reference) ;
+            free(curr_var->ref) ;
+            curr_var->ref = make_error_ref(save_name) ;
+            curr_var->address = curr_var->ref->address ;
+        } else if ( validate_address ) {
+            // The address is not NULL.
+            // If validate_address is on, check the memory manager if the address falls into
+            // any of the memory blocks it knows of.  Don't do this if we have a std::string or
+            // wstring type, or we already are pointing to a bad ref.  The last good address is
+            // remembered until the memory manager adds or removes an allocation.
+            if ( (curr_var->string_type != TRICK_STRING) and
+                 (curr_var->string_type != TRICK_WSTRING) and
+                 (curr_var->ref->address != &bad_ref_int) ) {
+                unsigned long long generation = get_alloc_generation() ;
+                if ( curr_var->address != curr_var->validated_address or
+                     generation != curr_var->validated_generation ) {
+                    if ( get_alloc_info_of(curr_var->address) == NULL ) {
                         std::string save_name(curr_var->ref->reference) ;
                         free(curr_var->ref) ;
                         curr_var->ref = make_error_ref(save_name) ;
                         curr_var->address = curr_var->ref->address ;
+                        curr_var->validated_address = NULL ;
+                    } else {
+                        curr_var->validated_address = curr_var->address ;
+                        curr_var->validated_generation = generation ;
                     }
-                } else {
-                    curr_var->ref->address = curr_var->address ;
                 }
-
             }
+        } else {
+            curr_var->ref->address = curr_var->address ;
+        }
 
-            // if this variable is a string we need to get the raw character string out of it.
-            if (( curr_var->string_type == TRICK_STRING ) && !curr_var->need_deref) {
-                std::string * str_ptr = (std::string *)curr_var->ref->address ;
-                curr_var->address = (void *)(str_ptr->c_str()) ;
-            }
+    }
 
-            // if this variable itself is a pointer, dereference it
-            if ( curr_var->need_deref) {
-                curr_var->address = *(void**)curr_var->ref->address ;
-            }
+    // if this variable is a string we need to get the raw character string out of it.
+    if (( curr_var->string_type == TRICK_STRING ) && !curr_var->need_deref) {
+        std::string * str_ptr = (std::string *)curr_var->ref->address ;
+        curr_var->address = (void *)(str_ptr->c_str()) ;
+    }
 
-            // handle c++ string and char*
-            if ( curr_var->string_type == TRICK_STRING ) {
-                if (curr_var->address == NULL) {
-                    curr_var->size = 0 ;
-                } else {
-                    curr_var->size = strlen((char*)curr_var->address) + 1 ;
-                }
+    // if this variable itself is a pointer, dereference it
+    if ( curr_var->need_deref) {
+        curr_var->address = *(void**)curr_var->ref->address ;
+    }
+
+    // handle c++ string and char*
+    if ( curr_var->string_type == TRICK_STRING ) {
+        if (curr_var->address == NULL) {
+            curr_var->size = 0 ;
+        } else {
+            curr_var->size = strlen((char*)curr_var->address) + 1 ;
+        }
+    }
+    // handle c++ wstring and wchar_t*
+    if ( curr_var->string_type == TRICK_WSTRING ) {
+        if (curr_var->address == NULL) {
+            curr_var->size = 0 ;
+        } else {
+            curr_var->size = wcslen((wchar_t *)curr_var->address) * sizeof(wchar_t);
+        }
+    }
+
+    memcpy( curr_var->buffer_in , curr_var->address , curr_var->size ) ;
+}
+
+/**
+@details
+-# Get the simulation time of the copy
+-# If the copy plan matches the variable list and the memory manager's allocations, copy the grouped variables with the plan, sharing the
+   snapshot if the client asked for it and the copy comes from the top of frame or scheduled copy job
+   of a running sim, then copy the other variables one at a time.
+-# Else copy every variable one at a time.  write_data rebuilds the plan.
+*/
+int Trick::VariableServerThread::copy_sim_data( int share_phase ) {
+
+    unsigned int ii ;
+
+    if ( vars.size() == 0 ) {
+        return 0 ;
+    }
+
+    if ( pthread_mutex_trylock(&copy_mutex) == 0 ) {
+
+        // Get the simulation time we start this copy
+        long long tics = exec_get_time_tics() ;
+        time = (double)tics / exec_get_time_tic_value() ;
+
+        if ( copy_plan.is_valid( get_alloc_generation() ) ) {
+            const std::vector< VariableReference * > & single_vars = copy_plan.get_single_vars() ;
+            copy_plan.copy( tics , share_snapshot ? share_phase : (int)VS_COPY_ASYNC ) ;
+            for ( ii = 0 ; ii < single_vars.size() ; ii++ ) {
+                copy_variable(single_vars[ii]) ;
             }
-            // handle c++ wstring and wchar_t*
-            if ( curr_var->string_type == TRICK_WSTRING ) {
-                if (curr_var->address == NULL) {
-                    curr_var->size = 0 ;
-                } else {
-                    curr_var->size = wcslen((wchar_t *)curr_var->address) * sizeof(wchar_t);
-                }
+        } else {
+            for ( ii = 0 ; ii < vars.size() ; ii++ ) {
+                copy_variable(vars[ii]) ;
             }
-
-            memcpy( curr_var->buffer_in , curr_var->address , curr_var->size ) ;
         }
 
         // Indicate that sim data has been written and is now ready in the buffer_in's of the vars variable list.
@@ -101,4 +139,3 @@ int Trick::VariableServerThread::copy_sim_data() {
     return (0) ;
 
 }
-
@@ -0,0 +1,231 @@
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "trick/VariableServer.hh"
+#include "trick/tc_proto.h"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+
+/**
+@details
+-# Accept the pending connection on the listen device
+-# Set the connection non-blocking.  Writes never wait for the client, see write_connection.
+-# If log is set on for the variable server, turn log on for this client
+*/
+int Trick::VariableServerThread::accept_event_connection( unsigned int output_limit ) {
+
+    if ( tc_accept(listen_dev, &connection) != TC_SUCCESS ) {
+        return -1 ;
+    }
+    tc_blockio(&connection, TC_COMM_NOBLOCKIO) ;
+    event_client = true ;
+    event_output_limit = output_limit ;
+    connection_accepted = true ;
+
+    if (vs->get_log()) {
+        log = true ;
+    }
+
+    return 0 ;
+}
+
+/* Sends from buffer until the socket would block.  sent is the number of bytes sent.  Returns -1 if the
+   send failed. */
+static int send_without_blocking( int socket , const char * buffer , size_t size , size_t & sent ) {
+
+    ssize_t nbytes ;
+
+    sent = 0 ;
+    while ( sent < size ) {
+        nbytes = send( socket, buffer + sent, size - sent, MSG_DONTWAIT | MSG_NOSIGNAL ) ;
+        if ( nbytes > 0 ) {
+            sent += nbytes ;
+        } else if ( nbytes < 0 and errno == EINTR ) {
+            continue ;
+        } else if ( nbytes < 0 and (errno == EAGAIN or errno == EWOULDBLOCK) ) {
+            break ;
+        } else {
+            return -1 ;
+        }
+    }
+    return 0 ;
+}
+
+/**
+@details
+-# Clients with their own thread write with tc_write
+-# If nothing is held for the client, send directly without blocking.  Hold what the socket did not take
+   behind anything already held, the event loop sends it when the socket is writable.
+-# A client holding more than event_output_limit bytes is not reading.  Disconnect it rather than hold
+   an ever growing backlog.
+-# Set exit_cmd when the write fails so the event loop removes the client
+*/
+int Trick::VariableServerThread::write_connection( const char * buffer , int size , bool limit_output ) {
+
+    int ret = size ;
+    size_t sent = 0 ;
+
+    if ( ! event_client ) {
+        return tc_write(&connection, (char *) buffer, size) ;
+    }
+
+    pthread_mutex_lock(&event_output_mutex) ;
+    if ( event_output.empty() and send_without_blocking(connection.socket, buffer, size, sent) < 0 ) {
+        ret = -1 ;
+    } else {
+        event_output.append(buffer + sent, size - sent) ;
+        if ( limit_output and event_output.size() > event_output_limit ) {
+            message_publish(MSG_WARNING, "%p tag=<%s> var_server client is not reading, %u bytes waiting, disconnecting.\n",
+             &connection, connection.client_tag, (unsigned int)event_output.size()) ;
+            ret = -1 ;
+        }
+    }
+    if ( ret < 0 ) {
+        event_output.clear() ;
+        exit_cmd = true ;
+    }
+    pthread_mutex_unlock(&event_output_mutex) ;
+
+    return ret ;
+}
+
+/**
+@details
+-# Send what write_connection held until the socket would block
+-# Return -1 if the send failed or the client sent var_exit
+*/
+int Trick::VariableServerThread::flush_event_output() {
+
+    size_t sent = 0 ;
+
+    pthread_mutex_lock(&event_output_mutex) ;
+    if ( send_without_blocking(connection.socket, event_output.data(), event_output.size(), sent) < 0 ) {
+        exit_cmd = true ;
+    }
+    event_output.erase(0, sent) ;
+    pthread_mutex_unlock(&event_output_mutex) ;
+
+    return exit_cmd ? -1 : 0 ;
+}
+
+/**
+@details
+-# Read everything on the socket without blocking and save it in event_msg.  A read of 0 bytes means
+   the client closed the connection.
+-# Parse the complete commands
+-# If the first command left in event_msg is MAX_CMD_LEN or longer, it can never be parsed, disconnect
+   the client.
+-# Return -1 if the client sent var_exit
+*/
+int Trick::VariableServerThread::read_event_commands() {
+
+    char buf[4096] ;
+    ssize_t nbytes ;
+
+    while (1) {
+        nbytes = recv( connection.socket, buf, sizeof(buf), MSG_DONTWAIT ) ;
+        if ( nbytes > 0 ) {
+            event_msg.append(buf, nbytes) ;
+        } else if ( nbytes == 0 ) {
+            return -1 ;
+        } else if ( errno == EINTR ) {
+            continue ;
+        } else if ( errno == EAGAIN or errno == EWOULDBLOCK ) {
+            break ;
+        } else {
+            return -1 ;
+        }
+    }
+
+    parse_event_commands() ;
+
+    size_t first_len = event_msg.find('\n') ;
+    if ( first_len == std::string::npos ) {
+        first_len = event_msg.size() ;
+    }
+    if ( first_len >= MAX_CMD_LEN - 1 ) {
+        message_publish(MSG_ERROR, "%p tag=<%s> var_server command longer than %d bytes, disconnecting.\n",
+         &connection, connection.client_tag, MAX_CMD_LEN) ;
+        return -1 ;
+    }
+
+    return exit_cmd ? -1 : 0 ;
+}
+
+/**
+@details
+-# If there is no complete command or the client is paused for a checkpoint reload, leave the commands
+   for the next cycle
+-# Point get_vst at this client for the commands that look it up
+-# Parse the complete commands in chunks that fit in incoming_msg with its null terminator.  Each chunk
+   ends on a newline.  Stop at a command that does not fit, read_event_commands disconnects the client,
+   or when the client sends var_exit.
+-# Remove the parsed commands from event_msg
+*/
+void Trick::VariableServerThread::parse_event_commands() {
+
+    size_t last_newline ;
+    size_t begin = 0 ;
+    size_t size ;
+
+    last_newline = event_msg.rfind('\n') ;
+    if ( last_newline == std::string::npos ) {
+        return ;
+    }
+
+    if ( pthread_mutex_trylock(&restart_pause) != 0 ) {
+        return ;
+    }
+
+    vs->set_event_loop_vst( pthread_self() , this ) ;
+    while ( begin <= last_newline and ! exit_cmd ) {
+        size = last_newline + 1 - begin ;
+        if ( size > MAX_CMD_LEN - 1 ) {
+            size_t end = event_msg.rfind('\n', begin + MAX_CMD_LEN - 2) ;
+            if ( end == std::string::npos or end < begin ) {
+                break ;
+            }
+            size = end + 1 - begin ;
+        }
+        memcpy(incoming_msg, event_msg.data() + begin, size) ;
+        begin += size ;
+        parse_commands( incoming_msg , (int)size ) ;
+    }
+    vs->set_event_loop_vst( pthread_self() , NULL ) ;
+
+    event_msg.erase(0, begin) ;
+
+    pthread_mutex_unlock(&restart_pause) ;
+}
+
+/**
+@details
+-# Return -1 if the client sent var_exit or a write in the main thread failed
+-# If the next cycle time is reached, parse any commands left during a checkpoint reload, copy and
+   write the data unless the client is paused for a checkpoint reload, and set the next cycle time one
+   update_rate later.
+*/
+int Trick::VariableServerThread::service_event( double now ) {
+
+    int ret = 0 ;
+
+    if ( exit_cmd ) {
+        return -1 ;
+    }
+
+    if ( now >= next_event_time ) {
+        parse_event_commands() ;
+        if ( exit_cmd ) {
+            return -1 ;
+        }
+        if ( pthread_mutex_trylock(&restart_pause) == 0 ) {
+            ret = copy_and_write_async() ;
+            pthread_mutex_unlock(&restart_pause) ;
+        }
+        next_event_time = now + update_rate ;
+    }
+
+    return ret ;
+}
@@ -20,11 +20,66 @@
 
 void exit_var_thread(void *in_vst) ;
 
+/**
+@details
+-# Print the received commands if debugging or info messages are on, and log them if logging is on.
+-# Remove the '\r' characters
+-# Run the commands natively if they are all core var_* commands.  Otherwise send them to the input processor.
+*/
+void Trick::VariableServerThread::parse_commands( char * msg , int msg_len ) {
+
+    int ii , jj ;
+
+    if (debug >= 3) {
+        message_publish(MSG_DEBUG, "%p tag=<%s> var_server received bytes = msg_len = %d\n", &connection, connection.client_tag, msg_len);
+    }
+
+    msg[msg_len] = '\0' ;
+
+    if (vs->get_info_msg() || (debug >= 1)) {
+        message_publish(MSG_DEBUG, "%p tag=<%s> var_server received: %s", &connection, connection.client_tag, msg) ;
+    }
+    if (log) {
+        message_publish(MSG_PLAYBACK, "tag=<%s> time=%f %s", connection.client_tag, exec_get_sim_time(), msg) ;
+    }
+
+    for( ii = 0 , jj = 0 ; ii <= msg_len ; ii++ ) {
+        if ( msg[ii] != '\r' ) {
+            stripped_msg[jj++] = msg[ii] ;
+        }
+    }
+
+    if ( ! parse_native_commands(stripped_msg) ) {
+        ip_parse(stripped_msg); /* returns 0 if no parsing error */
+    }
+}
+
+/**
+@details
+-# Copy the variables if the copy mode is asynchronous
+-# Write the variables if the write mode is asynchronous, if the copy mode and write mode are both
+   asynchronous, or if the sim is not running real-time, unless the client paused the data.
+*/
+int Trick::VariableServerThread::copy_and_write_async() {
+
+    int ret = 0 ;
+
+    if ( copy_mode == VS_COPY_ASYNC ) {
+        copy_sim_data() ;
+    }
+
+    if ( (write_mode == VS_WRITE_ASYNC) or
+         ((copy_mode == VS_COPY_ASYNC) and (write_mode == VS_WRITE_WHEN_COPIED)) or
+         (! is_real_time()) ) {
+        if ( !pause_cmd ) {
+            ret = write_data() ;
+        }
+    }
+    return ret < 0 ? -1 : 0 ;
+}
+
 void * Trick::VariableServerThread::thread_body() {
 
-    int ii , jj;
-    int msg_len;
-    int ret;
     int nbytes = -1;
     char *last_newline ;
     unsigned int size ;
@@ -36,7 +91,7 @@ void * Trick::VariableServerThread::thread_body() {
     vs->add_vst( pthread_self() , this ) ;
 
     if ( listen_dev->socket_type == SOCK_STREAM ) {
-        ret = tc_accept(listen_dev, &connection);
+        tc_accept(listen_dev, &connection);
         tc_blockio(&connection, TC_COMM_ALL_OR_NOTHING);
     }
     connection_accepted = true ;
@@ -110,29 +165,7 @@ void * Trick::VariableServerThread::thread_body() {
             }
 
             if ( nbytes > 0 ) {
-
-                msg_len = nbytes ;
-                if (debug >= 3) {
-                    message_publish(MSG_DEBUG, "%p tag=<%s> var_server received bytes = msg_len = %d\n", &connection, connection.client_tag, nbytes);
-                }
-
-                incoming_msg[msg_len] = '\0' ;
-
-                if (vs->get_info_msg() || (debug >= 1)) {
-                    message_publish(MSG_DEBUG, "%p tag=<%s> var_server received: %s", &connection, connection.client_tag, incoming_msg) ;
-                }
-                if (log) {
-                    message_publish(MSG_PLAYBACK, "tag=<%s> time=%f %s", connection.client_tag, exec_get_sim_time(), incoming_msg) ;
-                }
-
-                for( ii = 0 , jj = 0 ; ii <= msg_len ; ii++ ) {
-                    if ( incoming_msg[ii] != '\r' ) {
-                        stripped_msg[jj++] = incoming_msg[ii] ;
-                    }
-                }
-
-                ip_parse(stripped_msg); /* returns 0 if no parsing error */
-
+                parse_commands( incoming_msg , nbytes ) ;
             }
 
             /* break out of loop if exit command found */
@@ -140,19 +173,8 @@ void * Trick::VariableServerThread::thread_body() {
                 break;
             }
 
-            if ( copy_mode == VS_COPY_ASYNC ) {
-                ret = copy_sim_data() ;
-            }
-
-            if ( (write_mode == VS_WRITE_ASYNC) or
-                 ((copy_mode == VS_COPY_ASYNC) and (write_mode == VS_WRITE_WHEN_COPIED)) or
-                 (! is_real_time()) ) {
-                if ( !pause_cmd ) {
-                    ret = write_data() ;
-                    if ( ret < 0 ) {
-                        break ;
-                    }
-                }
+            if ( copy_and_write_async() < 0 ) {
+                break ;
             }
             pthread_mutex_unlock(&restart_pause) ;
 
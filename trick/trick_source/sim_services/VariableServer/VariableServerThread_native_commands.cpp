@@ -0,0 +1,345 @@
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "trick/VariableServer.hh"
+#include "trick/variable_server_sync_types.h"
+
+namespace {
+
+/* A literal argument of a command. type is 's' for a string, 'n' for a number, and 'b' for True or False. */
+struct NativeArg {
+    char type ;
+    bool integer ;
+    double number ;
+    std::string text ;
+} ;
+
+typedef std::vector< NativeArg > NativeArgs ;
+
+typedef void (*NativeHandler)( Trick::VariableServerThread * vst , Trick::VariableServer * vs , const NativeArgs & args ) ;
+
+/*
+   A command run without the input processor.  Each character of signature is an argument:  's' a string, 'd' a
+   number, 'i' an integer or True/False, 'b' True/False.
+*/
+struct NativeCommand {
+    const char * name ;
+    const char * signature ;
+    NativeHandler handler ;
+} ;
+
+/* A parsed command ready to run. */
+struct NativeCall {
+    const NativeCommand * command ;
+    NativeArgs args ;
+} ;
+
+int int_arg( const NativeArg & arg ) {
+    return (int)arg.number ;
+}
+
+void native_var_add( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_add(args[0].text) ;
+}
+
+void native_var_add_units( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_add(args[0].text, args[1].text) ;
+}
+
+void native_var_add_list( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_add_list(args[0].text) ;
+}
+
+void native_var_remove( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_remove(args[0].text) ;
+}
+
+void native_var_units( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_units(args[0].text, args[1].text) ;
+}
+
+void native_var_exists( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_exists(args[0].text) ;
+}
+
+void native_var_send( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->var_send() ;
+}
+
+void native_var_clear( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->var_clear() ;
+}
+
+void native_var_cycle( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_cycle(args[0].number) ;
+}
+
+void native_var_pause( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->set_pause(true) ;
+}
+
+void native_var_unpause( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->set_pause(false) ;
+}
+
+void native_var_exit( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->var_exit() ;
+}
+
+void native_var_ascii( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->var_ascii() ;
+}
+
+void native_var_binary( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->var_binary() ;
+}
+
+void native_var_binary_nonames( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->var_binary_nonames() ;
+}
+
+void native_var_debug( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_debug(int_arg(args[0])) ;
+}
+
+void native_var_validate_address( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_validate_address((bool)int_arg(args[0])) ;
+}
+
+void native_var_sync( Trick::VariableServerThread * vst , Trick::VariableServer * vs , const NativeArgs & args ) {
+    int mode = int_arg(args[0]) ;
+    vst->var_sync(mode) ;
+    if ( mode ) {
+        vs->get_next_sync_call_time() ;
+        vs->get_next_freeze_call_time() ;
+    }
+}
+
+void native_var_set_copy_mode( Trick::VariableServerThread * vst , Trick::VariableServer * vs , const NativeArgs & args ) {
+    int mode = int_arg(args[0]) ;
+    vst->var_set_copy_mode(mode) ;
+    if ( mode == VS_COPY_SCHEDULED ) {
+        vs->get_next_sync_call_time() ;
+        vs->get_next_freeze_call_time() ;
+    }
+}
+
+void native_var_set_write_mode( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_set_write_mode(int_arg(args[0])) ;
+}
+
+void native_var_byteswap( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & args ) {
+    vst->var_byteswap(args[0].number != 0.0) ;
+}
+
+void native_var_send_list_size( Trick::VariableServerThread * vst , Trick::VariableServer * , const NativeArgs & ) {
+    vst->send_list_size() ;
+}
+
+/* The commands that do the same as their var_server_ext.cpp counterparts. */
+const NativeCommand native_commands[] = {
+    { "var_add" ,              "s" ,  native_var_add } ,
+    { "var_add" ,              "ss" , native_var_add_units } ,
+    { "var_add_list" ,         "s" ,  native_var_add_list } ,
+    { "var_remove" ,           "s" ,  native_var_remove } ,
+    { "var_units" ,            "ss" , native_var_units } ,
+    { "var_exists" ,           "s" ,  native_var_exists } ,
+    { "var_send" ,             "" ,   native_var_send } ,
+    { "var_clear" ,            "" ,   native_var_clear } ,
+    { "var_cycle" ,            "d" ,  native_var_cycle } ,
+    { "var_pause" ,            "" ,   native_var_pause } ,
+    { "var_unpause" ,          "" ,   native_var_unpause } ,
+    { "var_exit" ,             "" ,   native_var_exit } ,
+    { "var_ascii" ,            "" ,   native_var_ascii } ,
+    { "var_binary" ,           "" ,   native_var_binary } ,
+    { "var_binary_nonames" ,   "" ,   native_var_binary_nonames } ,
+    { "var_debug" ,            "i" ,  native_var_debug } ,
+    { "var_validate_address" , "i" ,  native_var_validate_address } ,
+    { "var_sync" ,             "i" ,  native_var_sync } ,
+    { "var_set_copy_mode" ,    "i" ,  native_var_set_copy_mode } ,
+    { "var_set_write_mode" ,   "i" ,  native_var_set_write_mode } ,
+    { "var_byteswap" ,         "b" ,  native_var_byteswap } ,
+    { "var_send_list_size" ,   "" ,   native_var_send_list_size } ,
+} ;
+
+void skip_blanks( const char *& p ) {
+    while ( *p == ' ' or *p == '\t' ) {
+        p++ ;
+    }
+}
+
+/*
+   Parses a string, number, True, or False literal.  Anything the input processor could read differently, like
+   escapes, string prefixes, and hex or octal numbers, is not a literal here.
+*/
+bool parse_literal( const char *& p , NativeArg & arg ) {
+
+    if ( *p == '"' or *p == '\'' ) {
+        const char quote = *p++ ;
+        const char * start = p ;
+        while ( *p != quote ) {
+            if ( *p == '\0' or *p == '\n' or *p == '\\' ) {
+                return false ;
+            }
+            p++ ;
+        }
+        arg.type = 's' ;
+        arg.text.assign(start, p - start) ;
+        p++ ;
+        return true ;
+    }
+
+    if ( ! strncmp(p, "True", 4) or ! strncmp(p, "False", 5) ) {
+        arg.type = 'b' ;
+        arg.integer = true ;
+        arg.number = (*p == 'T') ? 1.0 : 0.0 ;
+        p += (*p == 'T') ? 4 : 5 ;
+        return true ;
+    }
+
+    const char * start = p ;
+    if ( *p == '+' or *p == '-' ) {
+        p++ ;
+    }
+    const char * digits = p ;
+    arg.integer = true ;
+    while ( isdigit((unsigned char)*p) or *p == '.' or *p == 'e' or *p == 'E' or
+            ((*p == '+' or *p == '-') and (p[-1] == 'e' or p[-1] == 'E')) ) {
+        if ( ! isdigit((unsigned char)*p) ) {
+            arg.integer = false ;
+        }
+        p++ ;
+    }
+    if ( p == digits or (arg.integer and *digits == '0' and p - digits > 1) ) {
+        return false ;
+    }
+    char * end ;
+    std::string number(start, p - start) ;
+    arg.number = strtod(number.c_str(), &end) ;
+    arg.type = 'n' ;
+    return *end == '\0' ;
+}
+
+/* Checks the arguments against a signature. */
+bool match_signature( const char * signature , const NativeArgs & args ) {
+    if ( strlen(signature) != args.size() ) {
+        return false ;
+    }
+    for ( unsigned int ii = 0 ; ii < args.size() ; ii++ ) {
+        switch ( signature[ii] ) {
+            case 's':
+                if ( args[ii].type != 's' ) return false ;
+                break ;
+            case 'd':
+                if ( args[ii].type != 'n' ) return false ;
+                break ;
+            case 'i':
+                if ( args[ii].type == 's' or ! args[ii].integer ) return false ;
+                break ;
+            case 'b':
+                if ( args[ii].type != 'b' ) return false ;
+                break ;
+            default:
+                return false ;
+        }
+    }
+    return true ;
+}
+
+/* Parses one trick.<command>(<literals>) statement. */
+bool parse_call( const char *& p , NativeCall & call ) {
+
+    if ( strncmp(p, "trick.", 6) ) {
+        return false ;
+    }
+    p += 6 ;
+    const char * start = p ;
+    while ( isalnum((unsigned char)*p) or *p == '_' ) {
+        p++ ;
+    }
+    std::string name(start, p - start) ;
+    skip_blanks(p) ;
+    if ( *p++ != '(' ) {
+        return false ;
+    }
+
+    call.args.clear() ;
+    skip_blanks(p) ;
+    while ( *p != ')' ) {
+        NativeArg arg ;
+        if ( ! parse_literal(p, arg) ) {
+            return false ;
+        }
+        call.args.push_back(arg) ;
+        skip_blanks(p) ;
+        if ( *p == ',' ) {
+            p++ ;
+            skip_blanks(p) ;
+        } else if ( *p != ')' ) {
+            return false ;
+        }
+    }
+    p++ ;
+
+    for ( unsigned int ii = 0 ; ii < sizeof(native_commands) / sizeof(native_commands[0]) ; ii++ ) {
+        if ( ! name.compare(native_commands[ii].name) and match_signature(native_commands[ii].signature, call.args) ) {
+            call.command = &native_commands[ii] ;
+            return true ;
+        }
+    }
+    return false ;
+}
+
+}
+
+/**
+@details
+-# Parse every line of msg.  A line holds trick.var_* commands separated by semicolons, and may end with a comment.
+   Blank and comment lines are skipped.
+-# If any line is indented, holds other Python, or calls a command with arguments that are not literals, return false
+   without running anything.  The whole message goes to the input processor so that the commands run in order.
+-# Run the commands in order with the same calls as var_server_ext.cpp and return true.
+*/
+bool Trick::VariableServerThread::parse_native_commands( const char * msg ) {
+
+    std::vector< NativeCall > calls ;
+    const char * p = msg ;
+
+    while ( *p != '\0' ) {
+        if ( *p == ' ' or *p == '\t' ) {
+            skip_blanks(p) ;
+            if ( *p != '\n' and *p != '\0' and *p != '#' ) {
+                return false ;
+            }
+        }
+        while ( *p != '\n' and *p != '\0' and *p != '#' ) {
+            NativeCall call ;
+            if ( ! parse_call(p, call) ) {
+                return false ;
+            }
+            calls.push_back(call) ;
+            skip_blanks(p) ;
+            if ( *p == ';' ) {
+                p++ ;
+                skip_blanks(p) ;
+            } else if ( *p != '\n' and *p != '\0' and *p != '#' ) {
+                return false ;
+            }
+        }
+        while ( *p != '\n' and *p != '\0' ) {
+            p++ ;
+        }
+        if ( *p == '\n' ) {
+            p++ ;
+        }
+    }
+
+    for ( unsigned int ii = 0 ; ii < calls.size() ; ii++ ) {
+        calls[ii].command->handler(this, vs, calls[ii].args) ;
+    }
+    return true ;
+}
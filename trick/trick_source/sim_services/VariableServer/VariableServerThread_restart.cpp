@@ -28,6 +28,9 @@ void Trick::VariableServerThread::preload_checkpoint() {
         (*it)->ref->attr->size = sizeof(int) ;
     }
 
+    // Copy the variables one at a time until they are resolved again.
+    copy_plan.invalidate() ;
+
     // Allow data copying to continue.
     pthread_mutex_unlock(&copy_mutex);
 
@@ -13,6 +13,7 @@ PROGRAMMERS: (((Alex Lin) (NASA) (8/06) (--)))
 #include "trick/tc_proto.h"
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
+#include "trick/memorymanager_c_intf.h"
 
 
 extern "C" {
@@ -167,7 +168,7 @@ int Trick::VariableServerThread::write_binary_data( int Start, char *buf1, int P
     }
 
     len = offset + sizeof(msg_type) ;
-    ret = tc_write(&connection, (char *) buf1, len);
+    ret = write_connection(buf1, len);
     if ( ret != (int)len ) {
         return(-1) ;
     }
@@ -200,6 +201,13 @@ int Trick::VariableServerThread::write_data() {
         }
         var_data_staged = false;
 
+        // Rebuild the copy plan after the variable list or the allocations changed.  This is the client
+        // thread so no buffers are being formatted.
+        unsigned long long generation = get_alloc_generation() ;
+        if ( ! copy_plan.is_valid( generation ) ) {
+            copy_plan.build( vars , &time , share_snapshot , generation ) ;
+        }
+
         /* Relinquish sole access to vars[ii]->buffer_in. */
         pthread_mutex_unlock(&copy_mutex) ;
 
@@ -218,58 +226,62 @@ int Trick::VariableServerThread::write_data() {
             } while( Index < (int)vars.size() );
 
         } else { /* ascii mode */
-            char val[MAX_MSG_LEN];
+            /* leave room for a null so the message can be printed */
+            Trick::AsciiRow row(buf1, MAX_MSG_LEN - 1) ;
 
-            sprintf(buf1, "0\t") ;
+            row.append("0\t") ;
 
             for (i = 0; i < vars.size(); i++) {
+                size_t start = row.length() ;
 
-                ret = vs_format_ascii( vars[i] , val);
+                ret = vs_format_ascii( vars[i] , row , ascii_round_trip );
+                row.append('\t') ;
 
                 if (ret < 0) {
                     message_publish(MSG_WARNING, "%p Variable Server string buffer[%d] too small for symbol %s, TRUNCATED IT.\n",
                                     &connection, MAX_MSG_LEN, vars[i]->ref->reference );
                 }
 
-                /* make sure this message will fit in a packet by itself */
-                if( strlen( val ) + 2 > MAX_MSG_LEN ) {
-                    message_publish(MSG_WARNING, "%p Variable Server buffer[%d] too small for symbol %s, TRUNCATED IT.\n",
-                                    &connection, MAX_MSG_LEN, vars[i]->ref->reference );
-                    val[MAX_MSG_LEN - 1] = '\0';
-                }
-
-                len = strlen(buf1) ;
-
-                /* make sure there is space for the next tab or next newline and null */
-                if( len + strlen( val ) + 2 > MAX_MSG_LEN ) {
+                /* the value does not fit after the values already in the message, send those and start a new message */
+                if ( row.overflow() and start > 0 ) {
 
+                    row.rewind(start) ;
                     if (debug >= 2) {
+                        row.terminate() ;
                         message_publish(MSG_DEBUG, "%p tag=<%s> var_server sending %d ascii bytes:\n%s\n",
-                                        &connection, connection.client_tag, (int)strlen(buf1), buf1) ;
+                                        &connection, connection.client_tag, (int)start, buf1) ;
                     }
 
-                    ret = tc_write(&connection, (char *) buf1, len);
-                    if ( ret != len ) {
+                    ret = write_connection(buf1, (int)start);
+                    if ( ret != (int)start ) {
                         return(-1) ;
                     }
-                    buf1[0] = '\0';
+                    row.clear() ;
+                    vs_format_ascii( vars[i] , row , ascii_round_trip );
+                    row.append('\t') ;
                 }
 
-                strcat(buf1, val);
-                strcat(buf1, "\t");
+                /* make sure this message will fit in a packet by itself */
+                if ( row.overflow() ) {
+                    message_publish(MSG_WARNING, "%p Variable Server buffer[%d] too small for symbol %s, TRUNCATED IT.\n",
+                                    &connection, MAX_MSG_LEN, vars[i]->ref->reference );
+                    row.rewind( row.length() > MAX_MSG_LEN - 2 ? MAX_MSG_LEN - 2 : row.length() ) ;
+                    row.append('\t') ;
+                }
             }
 
-            len = strlen(buf1) ;
+            len = row.length() ;
 
             if ( len > 0 ) {
-                buf1[ strlen(buf1) - 1 ] = '\n';
+                buf1[ len - 1 ] = '\n';
+                row.terminate() ;
 
                 if (debug >= 2) {
                     message_publish(MSG_DEBUG, "%p tag=<%s> var_server sending %d ascii bytes:\n%s\n",
-                                    &connection, connection.client_tag, (int)strlen(buf1), buf1) ;
+                                    &connection, connection.client_tag, len, buf1) ;
                 }
-                ret = tc_write(&connection, (char *) buf1, (int)strlen(buf1));
-                if ( ret != (int)strlen(buf1) ) {
+                ret = write_connection(buf1, len);
+                if ( ret != len ) {
                     return(-1) ;
                 }
             }
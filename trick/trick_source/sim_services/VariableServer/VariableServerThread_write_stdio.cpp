@@ -7,7 +7,7 @@ int Trick::VariableServerThread::write_stdio(int stream, std::string text) {
 
     char header[16] ;
     sprintf(header, "%-2d %1d %8d\n" , VS_STDIO, stream , (int)text.length()) ;
-    tc_write(&connection , (char *) header , strlen(header)) ;
-    tc_write(&connection , (char *) text.c_str() , text.length()) ;
+    write_connection(header , strlen(header)) ;
+    write_connection(text.c_str() , text.length()) ;
     return 0 ;
 }
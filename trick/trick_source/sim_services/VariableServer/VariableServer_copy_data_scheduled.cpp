@@ -9,13 +9,13 @@ int Trick::VariableServer::copy_data_scheduled() {
 
     long long next_call_tics ;
     VariableServerThread * vst ;
-    std::map < pthread_t , VariableServerThread * >::iterator it ;
+    std::vector < VariableServerThread * >::iterator it ;
 
     next_call_tics = TRICK_MAX_LONG_LONG ;
 
     pthread_mutex_lock(&map_mutex) ;
-    for ( it = var_server_threads.begin() ; it != var_server_threads.end() ; it++ ) {
-        vst = (*it).second ;
+    for ( it = clients.begin() ; it != clients.end() ; it++ ) {
+        vst = (*it) ;
         vst->copy_data_scheduled(copy_data_job->next_tics) ;
         if ( vst->get_next_tics() < next_call_tics ) {
             next_call_tics = vst->get_next_tics() ;
@@ -11,13 +11,13 @@ int Trick::VariableServer::freeze_init() {
 
     long long next_call_tics ;
     VariableServerThread * vst ;
-    std::map < pthread_t , VariableServerThread * >::iterator it ;
+    std::vector < VariableServerThread * >::iterator it ;
 
     next_call_tics = TRICK_MAX_LONG_LONG ;
 
     pthread_mutex_lock(&map_mutex) ;
-    for ( it = var_server_threads.begin() ; it != var_server_threads.end() ; it++ ) {
-        vst = (*it).second ;
+    for ( it = clients.begin() ; it != clients.end() ; it++ ) {
+        vst = (*it) ;
         vst->freeze_init() ;
         if ( vst->get_freeze_next_tics() < next_call_tics ) {
             next_call_tics = vst->get_freeze_next_tics() ;
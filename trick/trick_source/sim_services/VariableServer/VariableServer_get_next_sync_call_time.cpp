@@ -6,7 +6,7 @@
 
 int Trick::VariableServer::get_next_sync_call_time() {
 
-    std::map < pthread_t , VariableServerThread * >::iterator it ;
+    std::vector < VariableServerThread * >::iterator it ;
     VariableServerThread * vst ;
 
     long long next_call_tics ;
@@ -14,8 +14,8 @@ int Trick::VariableServer::get_next_sync_call_time() {
     next_call_tics = TRICK_MAX_LONG_LONG ;
 
     pthread_mutex_lock(&map_mutex) ;
-    for ( it = var_server_threads.begin() ; it != var_server_threads.end() ; it++ ) {
-        vst = (*it).second ;
+    for ( it = clients.begin() ; it != clients.end() ; it++ ) {
+        vst = (*it) ;
         if ( vst->get_next_tics() < next_call_tics ) {
             next_call_tics = vst->get_next_tics() ;
         }
@@ -12,6 +12,16 @@ int Trick::VariableServer::init() {
         if ( ret != 0 ) {
             return ret ;
         }
+        for ( unsigned int ii = 0 ; ii < num_event_loops ; ii++ ) {
+            VariableServerEventLoop * loop = new VariableServerEventLoop() ;
+            if ( loop->init() != 0 ) {
+                delete loop ;
+                break ;
+            }
+            loop->copy_cpus(listen_thread.get_cpus()) ;
+            loop->create_thread() ;
+            event_loops.push_back(loop) ;
+        }
         listen_thread.create_thread() ;
     }
 
@@ -23,13 +23,13 @@ int Trick::VariableServer::restart() {
 
 // Suspend variable server processing prior to reloading a checkpoint.
 int Trick::VariableServer::suspendPreCheckpointReload() {
-    std::map<pthread_t, VariableServerThread*>::iterator pos ;
+    std::vector<VariableServerThread*>::iterator pos ;
 
     listen_thread.pause_listening() ;
 
     pthread_mutex_lock(&map_mutex) ;
-    for ( pos = var_server_threads.begin() ; pos != var_server_threads.end() ; pos++ ) {
-        VariableServerThread* vst = (*pos).second ;
+    for ( pos = clients.begin() ; pos != clients.end() ; pos++ ) {
+        VariableServerThread* vst = (*pos) ;
         vst->preload_checkpoint() ;
     }
     pthread_mutex_unlock(&map_mutex) ;
@@ -39,12 +39,12 @@ int Trick::VariableServer::suspendPreCheckpointReload() {
 
 // Resume variable server processing after reloading a MemoryManager (ASCII) checkpoint.
 int Trick::VariableServer::resumePostCheckpointReload() {
-    std::map<pthread_t, VariableServerThread*>::iterator pos ;
+    std::vector<VariableServerThread*>::iterator pos ;
 
     pthread_mutex_lock(&map_mutex) ;
     // For each Variable Server Thread ...
-    for ( pos = var_server_threads.begin() ; pos != var_server_threads.end() ; pos++ ) {
-        VariableServerThread* vst = (*pos).second ;
+    for ( pos = clients.begin() ; pos != clients.end() ; pos++ ) {
+        VariableServerThread* vst = (*pos) ;
         vst->restart() ;
     }
     pthread_mutex_unlock(&map_mutex) ;
@@ -8,6 +8,10 @@ int Trick::VariableServer::shutdown() {
         (*it).second->cancel_thread() ;
         // cancelling causes each var_server_thread map element to be erased by the exit_var_thread function
     }
+    for ( unsigned int ii = 0 ; ii < event_loops.size() ; ii++ ) {
+        // cancelling disconnects and erases the clients of the loop
+        event_loops[ii]->cancel_thread() ;
+    }
 
     return 0 ;
 }
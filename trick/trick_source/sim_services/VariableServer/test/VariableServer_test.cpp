@@ -0,0 +1,456 @@
+#include <string>
+#include <vector>
+#include <list>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "gtest/gtest.h"
+
+#define protected public
+#include "trick/VariableServer.hh"
+#include "trick/VariableServerThread.hh"
+#include "trick/VariableCopyPlan.hh"
+#include "trick/variable_server_sync_types.h"
+
+namespace Trick {
+
+/* Serves one client as an event loop does, through one end of a socket pair. */
+class VariableServerTest : public ::testing::Test {
+
+    protected:
+        VariableServerTest() : vst(NULL) {}
+        ~VariableServerTest() {}
+
+        void SetUp() {
+            socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) ;
+            vst.set_vs_ptr(&vs) ;
+            vst.get_connection().socket = sockets[0] ;
+        }
+
+        void TearDown() {
+            close(sockets[0]) ;
+            close(sockets[1]) ;
+        }
+
+        /* Sends text to the client and lets it read and parse everything sent so far. */
+        int send_commands( const std::string & text ) {
+            int ret = 0 ;
+            size_t sent = 0 ;
+            while ( sent < text.size() and ret == 0 ) {
+                ssize_t nbytes = send(sockets[1], text.data() + sent, text.size() - sent, MSG_DONTWAIT) ;
+                if ( nbytes > 0 ) {
+                    sent += nbytes ;
+                }
+                ret = vst.read_event_commands() ;
+            }
+            return ret ;
+        }
+
+        /* Reads everything the client sent so far. */
+        std::string receive_output() {
+            std::string text ;
+            char buf[4096] ;
+            ssize_t nbytes ;
+            while ( (nbytes = recv(sockets[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0 ) {
+                text.append(buf, nbytes) ;
+            }
+            return text ;
+        }
+
+        /* Numbered messages so that lost or reordered bytes show. */
+        static std::string numbered_message( int num ) {
+            char buf[64] ;
+            snprintf(buf, sizeof(buf), "%8d message of some length to fill the socket\n", num) ;
+            return std::string(buf) ;
+        }
+
+        VariableServer vs ;
+        VariableServerThread vst ;
+        int sockets[2] ;
+} ;
+
+TEST_F( VariableServerTest , ManyShortCommands ) {
+    // More than MAX_CMD_LEN bytes of complete commands are parsed in chunks, none are dropped.
+    std::string text ;
+    int num_commands = 0 ;
+    while ( text.size() < 3 * VariableServerThread::MAX_CMD_LEN ) {
+        text += (num_commands % 2) ? "trick.var_unpause()\n" : "trick.var_pause()\n" ;
+        num_commands++ ;
+    }
+    text += "trick.var_cycle(2.5)\n" ;
+
+    EXPECT_EQ(0, send_commands(text)) ;
+    EXPECT_EQ(0, vst.read_event_commands()) ;
+    EXPECT_EQ(0u, vst.event_msg.size()) ;
+    EXPECT_EQ(2.5, vst.update_rate) ;
+    EXPECT_EQ((num_commands % 2) == 1, vst.get_pause()) ;
+}
+
+TEST_F( VariableServerTest , PartialCommand ) {
+    // A command without its newline waits for the rest.
+    EXPECT_EQ(0, send_commands("trick.var_cycle(1.5)\ntrick.var_cyc")) ;
+    EXPECT_EQ(1.5, vst.update_rate) ;
+    EXPECT_EQ(std::string("trick.var_cyc"), vst.event_msg) ;
+    EXPECT_EQ(0, send_commands("le(3.0)\n")) ;
+    EXPECT_EQ(3.0, vst.update_rate) ;
+    EXPECT_EQ(0u, vst.event_msg.size()) ;
+}
+
+TEST_F( VariableServerTest , CommandTooLong ) {
+    // A single command that can never fit disconnects the client.
+    std::string text("trick.var_cycle(1.5)\ntrick.var_add(\"") ;
+    text.append(VariableServerThread::MAX_CMD_LEN, 'a') ;
+    EXPECT_EQ(-1, send_commands(text)) ;
+    EXPECT_EQ(1.5, vst.update_rate) ;
+}
+
+TEST_F( VariableServerTest , WriteHeldWhenSocketFull ) {
+    // Writes to an event client that is not reading never block.  What the socket does not take is held
+    // and sent in order once the client reads.
+    vst.event_client = true ;
+    vst.event_output_limit = 1 << 30 ;
+    std::string expected ;
+    int num = 0 ;
+    while ( vst.event_output.empty() ) {
+        std::string msg = numbered_message(num++) ;
+        EXPECT_EQ((int)msg.size(), vst.write_connection(msg.data(), msg.size())) ;
+        expected += msg ;
+    }
+    for ( int ii = 0 ; ii < 100 ; ii++ ) {
+        std::string msg = numbered_message(num++) ;
+        EXPECT_EQ((int)msg.size(), vst.write_connection(msg.data(), msg.size())) ;
+        expected += msg ;
+    }
+    size_t held = vst.event_output.size() ;
+    EXPECT_GT(held, 100 * numbered_message(0).size() - 1) ;
+
+    std::string received = receive_output() ;
+    EXPECT_EQ(held, vst.event_output.size()) ;
+    while ( ! vst.event_output.empty() ) {
+        EXPECT_EQ(0, vst.flush_event_output()) ;
+        received += receive_output() ;
+    }
+    EXPECT_TRUE(received == expected) ;
+    EXPECT_FALSE(vst.exit_cmd) ;
+}
+
+TEST_F( VariableServerTest , OutputLimitDisconnects ) {
+    // A client holding more than event_output_limit bytes is disconnected instead of holding the loop.
+    vst.event_client = true ;
+    vst.event_output_limit = 10000 ;
+    std::string msg = numbered_message(0) ;
+    int ret = 0 ;
+    int num = 0 ;
+    while ( ret >= 0 and num < 1000000 ) {
+        ret = vst.write_connection(msg.data(), msg.size()) ;
+        num++ ;
+    }
+    EXPECT_EQ(-1, ret) ;
+    EXPECT_TRUE(vst.exit_cmd) ;
+    EXPECT_EQ(0u, vst.event_output.size()) ;
+    EXPECT_EQ(-1, vst.flush_event_output()) ;
+}
+
+TEST_F( VariableServerTest , FileHeldPastOutputLimit ) {
+    // A file the client asked for is held whole even past the limit.
+    vst.event_client = true ;
+    vst.event_output_limit = 10000 ;
+    std::string text ;
+    while ( vst.event_output.size() <= vst.event_output_limit ) {
+        std::string msg = numbered_message(text.size()) ;
+        EXPECT_EQ((int)msg.size(), vst.write_connection(msg.data(), msg.size(), false)) ;
+        text += msg ;
+    }
+    EXPECT_FALSE(vst.exit_cmd) ;
+}
+
+TEST_F( VariableServerTest , NativeCommands ) {
+    // Commands separated by newlines and semicolons, comments, and blank lines run without the input processor.
+    EXPECT_TRUE(vst.parse_native_commands(
+     "trick.var_pause()\ntrick.var_cycle( 0.25 ) ; trick.var_debug(3) # comment\n\n# only a comment\n")) ;
+    EXPECT_TRUE(vst.get_pause()) ;
+    EXPECT_EQ(0.25, vst.update_rate) ;
+    EXPECT_EQ(3, vst.debug) ;
+    EXPECT_TRUE(vst.parse_native_commands("trick.var_unpause() ; trick.var_cycle(1e-1,)\n")) ;
+    EXPECT_FALSE(vst.get_pause()) ;
+    EXPECT_EQ(0.1, vst.update_rate) ;
+    EXPECT_TRUE(vst.parse_native_commands("trick.var_debug(False)\n")) ;
+    EXPECT_EQ(0, vst.debug) ;
+}
+
+TEST_F( VariableServerTest , NativeQuoting ) {
+    // Either quote may enclose a name, and may hold the other quote, blanks, commas, and parentheses.
+    EXPECT_TRUE(vst.parse_native_commands(
+     "trick.var_add(\"ball.obj.x\")\ntrick.var_add('ball.obj.y')\n"
+     "trick.var_add(\"it's (a, b)\") ; trick.var_add('say \"hi\" # not a comment')\n")) ;
+    ASSERT_EQ(4u, vst.vars.size()) ;
+    EXPECT_STREQ("ball.obj.x", vst.vars[0]->ref->reference) ;
+    EXPECT_STREQ("ball.obj.y", vst.vars[1]->ref->reference) ;
+    EXPECT_STREQ("it's (a, b)", vst.vars[2]->ref->reference) ;
+    EXPECT_STREQ("say \"hi\" # not a comment", vst.vars[3]->ref->reference) ;
+    EXPECT_TRUE(vst.parse_native_commands("trick.var_remove('ball.obj.x')\n")) ;
+    EXPECT_EQ(3u, vst.vars.size()) ;
+}
+
+TEST_F( VariableServerTest , NativeEscapes ) {
+    // Escapes and string prefixes are left to the input processor, and nothing in the message runs.
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.var_add(\"a\\\"b\")\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.var_add('a\\x41')\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.var_add(r'a')\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.var_add('a\n')\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.var_add('a)\n")) ;
+    EXPECT_FALSE(vst.get_pause()) ;
+    EXPECT_EQ(0u, vst.vars.size()) ;
+}
+
+TEST_F( VariableServerTest , NativeMalformedArguments ) {
+    // Argument lists that are not literals matching the command are left to the input processor.
+    const char * malformed[] = {
+        "trick.var_cycle(1.5\n" ,
+        "trick.var_cycle 1.5\n" ,
+        "trick.var_cycle(1.5 2.5)\n" ,
+        "trick.var_cycle(1.5,,)\n" ,
+        "trick.var_cycle(,1.5)\n" ,
+        "trick.var_cycle()\n" ,
+        "trick.var_cycle(1.5, 2.5)\n" ,
+        "trick.var_cycle('1.5')\n" ,
+        "trick.var_cycle(1.5 * 2)\n" ,
+        "trick.var_cycle(x)\n" ,
+        "trick.var_cycle(0x10)\n" ,
+        "trick.var_cycle(1.5) trick.var_pause()\n" ,
+        "trick.var_debug(1.5)\n" ,
+        "trick.var_debug(007)\n" ,
+        "trick.var_byteswap(1)\n" ,
+        "trick.var_add('a', 2)\n" ,
+    } ;
+    for ( unsigned int ii = 0 ; ii < sizeof(malformed) / sizeof(malformed[0]) ; ii++ ) {
+        std::string msg = std::string("trick.var_pause()\n") + malformed[ii] ;
+        EXPECT_FALSE(vst.parse_native_commands(msg.c_str())) << malformed[ii] ;
+    }
+    EXPECT_FALSE(vst.get_pause()) ;
+    EXPECT_EQ(0, vst.debug) ;
+    EXPECT_EQ(0u, vst.vars.size()) ;
+}
+
+TEST_F( VariableServerTest , NativeUnknownCommands ) {
+    // Commands without a native counterpart are left to the input processor.
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.var_not_a_command()\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.exec_terminate()\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\ntrick.var_pause\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_pause()\nvar_pause()\n")) ;
+    EXPECT_FALSE(vst.get_pause()) ;
+}
+
+TEST_F( VariableServerTest , NativePythonFallback ) {
+    // Any other Python sends the whole message to the input processor so that the commands run in order.
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_cycle(1.5)\nx = 1\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_cycle(1.5)\nprint(1)\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("if True:\n    trick.var_cycle(1.5)\n")) ;
+    EXPECT_FALSE(vst.parse_native_commands("trick.var_cycle(1.5)\n  trick.var_pause()\n")) ;
+    EXPECT_NE(1.5, vst.update_rate) ;
+    EXPECT_FALSE(vst.get_pause()) ;
+}
+
+/* Builds copy plans over variables of a block of test memory. */
+class VariableCopyPlanTest : public ::testing::Test {
+
+    protected:
+        void SetUp() {
+            for ( unsigned int ii = 0 ; ii < sizeof(sim) ; ii++ ) {
+                sim[ii] = (char)ii ;
+            }
+        }
+
+        void TearDown() {
+            for ( unsigned int ii = 0 ; ii < all_vars.size() ; ii++ ) {
+                delete all_vars[ii] ;
+            }
+        }
+
+        /* Makes a variable of size bytes at offset in sim, a char array without a pointer in its path. */
+        VariableReference * make_var( size_t offset , int size ) {
+            attrs.push_back(ATTRIBUTES()) ;
+            ATTRIBUTES & attr = attrs.back() ;
+            memset(&attr, 0, sizeof(attr)) ;
+            attr.type = TRICK_CHARACTER ;
+            attr.size = 1 ;
+            attr.num_index = 1 ;
+            attr.index[0].size = size ;
+            REF2 * ref = (REF2 *)calloc(1, sizeof(REF2)) ;
+            ref->reference = (char *)"sim" ;
+            ref->address = sim + offset ;
+            ref->attr = &attr ;
+            VariableReference * var = new VariableReference(ref) ;
+            all_vars.push_back(var) ;
+            return var ;
+        }
+
+        /* Returns true if the buffer_in of every variable holds its simulation memory. */
+        static bool copied( std::vector< VariableReference * > & vars ) {
+            for ( unsigned int ii = 0 ; ii < vars.size() ; ii++ ) {
+                if ( memcmp(vars[ii]->buffer_in, vars[ii]->address, vars[ii]->size) ) {
+                    return false ;
+                }
+            }
+            return true ;
+        }
+
+        /* Aligned so that offsets in sim have the alignment of their value modulo 16. */
+        union {
+            char sim[256] ;
+            long double align ;
+        } ;
+        std::list< ATTRIBUTES > attrs ;
+        std::vector< VariableReference * > all_vars ;
+} ;
+
+TEST_F( VariableCopyPlanTest , MergesTouchingAndOverlappingVariables ) {
+    VariableCopyPlan plan ;
+    std::vector< VariableReference * > vars ;
+    vars.push_back(make_var(32, 8)) ;
+    vars.push_back(make_var(8, 8)) ;
+    vars.push_back(make_var(0, 8)) ;
+    vars.push_back(make_var(4, 8)) ;
+    vars.push_back(make_var(64, 8)) ;
+    vars.push_back(make_var(66, 2)) ;
+
+    // [0,8) [4,12) [8,16) are one run, [32,40) is another, [64,72) contains [66,68).
+    plan.build(vars, NULL, false, 0) ;
+    EXPECT_EQ(3u, plan.get_num_segments()) ;
+    EXPECT_TRUE(plan.get_single_vars().empty()) ;
+
+    // Variables of one segment sit at their source distance in the block.
+    EXPECT_EQ((char *)vars[2]->buffer_in + 4, (char *)vars[3]->buffer_in) ;
+    EXPECT_EQ((char *)vars[2]->buffer_in + 8, (char *)vars[1]->buffer_in) ;
+    EXPECT_EQ((char *)vars[4]->buffer_in + 2, (char *)vars[5]->buffer_in) ;
+    EXPECT_EQ((char *)vars[2]->buffer_out + 8, (char *)vars[1]->buffer_out) ;
+
+    plan.copy(0, VS_COPY_ASYNC) ;
+    EXPECT_TRUE(copied(vars)) ;
+}
+
+TEST_F( VariableCopyPlanTest , KeepsSourceAlignment ) {
+    VariableCopyPlan plan ;
+    std::vector< VariableReference * > vars ;
+    vars.push_back(make_var(3, 5)) ;
+    vars.push_back(make_var(40, 8)) ;
+    vars.push_back(make_var(100, 12)) ;
+    vars.push_back(make_var(121, 1)) ;
+
+    plan.build(vars, NULL, false, 0) ;
+    EXPECT_EQ(4u, plan.get_num_segments()) ;
+    for ( unsigned int ii = 0 ; ii < vars.size() ; ii++ ) {
+        EXPECT_EQ((size_t)vars[ii]->address % 16, (size_t)vars[ii]->buffer_in % 16) << "variable " << ii ;
+        EXPECT_EQ((size_t)vars[ii]->address % 16, (size_t)vars[ii]->buffer_out % 16) << "variable " << ii ;
+    }
+    plan.copy(0, VS_COPY_ASYNC) ;
+    EXPECT_TRUE(copied(vars)) ;
+}
+
+TEST_F( VariableCopyPlanTest , RebuildMovesBuffers ) {
+    VariableCopyPlan plan ;
+    std::vector< VariableReference * > vars ;
+    vars.push_back(make_var(0, 8)) ;
+    vars.push_back(make_var(16, 8)) ;
+    VariableReference * pointer_var = make_var(32, 8) ;
+    pointer_var->ref->pointer_present = 1 ;
+    vars.push_back(pointer_var) ;
+
+    // Grouped variables use the plan's blocks, the others keep their own buffers.
+    plan.build(vars, NULL, false, 0) ;
+    ASSERT_EQ(1u, plan.get_single_vars().size()) ;
+    EXPECT_EQ(pointer_var, plan.get_single_vars()[0]) ;
+    EXPECT_EQ(pointer_var->own_buffer_in, pointer_var->buffer_in) ;
+    EXPECT_NE(vars[0]->own_buffer_in, vars[0]->buffer_in) ;
+    EXPECT_NE(vars[0]->own_buffer_out, vars[0]->buffer_out) ;
+
+    // Data waiting in the buffers survives the rebuild.
+    memcpy(vars[0]->buffer_in, "in-data", 8) ;
+    memcpy(vars[0]->buffer_out, "outdata", 8) ;
+    memcpy(vars[1]->buffer_in, "in-two", 7) ;
+
+    // A variable at the client's private address goes back to its own buffers.
+    plan.build(vars, vars[0]->address, false, 0) ;
+    EXPECT_EQ(2u, plan.get_single_vars().size()) ;
+    EXPECT_EQ(vars[0]->own_buffer_in, vars[0]->buffer_in) ;
+    EXPECT_EQ(vars[0]->own_buffer_out, vars[0]->buffer_out) ;
+    EXPECT_STREQ("in-data", (char *)vars[0]->buffer_in) ;
+    EXPECT_STREQ("outdata", (char *)vars[0]->buffer_out) ;
+    EXPECT_NE(vars[1]->own_buffer_in, vars[1]->buffer_in) ;
+    EXPECT_STREQ("in-two", (char *)vars[1]->buffer_in) ;
+
+    // A variable that is grouped again moves back into the new block.
+    plan.build(vars, NULL, false, 0) ;
+    EXPECT_NE(vars[0]->own_buffer_in, vars[0]->buffer_in) ;
+    EXPECT_STREQ("in-data", (char *)vars[0]->buffer_in) ;
+    EXPECT_STREQ("outdata", (char *)vars[0]->buffer_out) ;
+    EXPECT_STREQ("in-two", (char *)vars[1]->buffer_in) ;
+
+    // Swapped buffers, as write_data leaves them, are moved too.
+    void * temp = vars[1]->buffer_in ;
+    vars[1]->buffer_in = vars[1]->buffer_out ;
+    vars[1]->buffer_out = temp ;
+    plan.build(vars, NULL, false, 0) ;
+    EXPECT_STREQ("in-two", (char *)vars[1]->buffer_out) ;
+}
+
+TEST_F( VariableCopyPlanTest , InvalidWhenAllocationsChange ) {
+    VariableCopyPlan plan ;
+    std::vector< VariableReference * > vars ;
+    vars.push_back(make_var(0, 8)) ;
+
+    EXPECT_FALSE(plan.is_valid(0)) ;
+    plan.build(vars, NULL, false, 5) ;
+    EXPECT_TRUE(plan.is_valid(5)) ;
+    EXPECT_FALSE(plan.is_valid(6)) ;
+
+    plan.build(vars, NULL, false, 6) ;
+    EXPECT_TRUE(plan.is_valid(6)) ;
+    plan.invalidate() ;
+    EXPECT_FALSE(plan.is_valid(6)) ;
+}
+
+TEST_F( VariableCopyPlanTest , SharedSnapshotMatchesPhaseAndTime ) {
+    VariableCopyPlan first , second , unshared ;
+    std::vector< VariableReference * > first_vars , second_vars , unshared_vars ;
+    first_vars.push_back(make_var(0, 8)) ;
+    first_vars.push_back(make_var(24, 4)) ;
+    second_vars.push_back(make_var(24, 4)) ;
+    second_vars.push_back(make_var(0, 8)) ;
+    unshared_vars.push_back(make_var(0, 8)) ;
+    unshared_vars.push_back(make_var(24, 4)) ;
+    first.build(first_vars, NULL, true, 0) ;
+    second.build(second_vars, NULL, true, 0) ;
+    unshared.build(unshared_vars, NULL, false, 0) ;
+
+    // The first copy of a phase and time gathers, the others copy the snapshot.
+    first.copy(10, VS_COPY_SCHEDULED) ;
+    EXPECT_TRUE(copied(first_vars)) ;
+    sim[0] = 100 ;
+    second.copy(10, VS_COPY_SCHEDULED) ;
+    EXPECT_EQ(0, ((char *)second_vars[1]->buffer_in)[0]) ;
+    unshared.copy(10, VS_COPY_SCHEDULED) ;
+    EXPECT_TRUE(copied(unshared_vars)) ;
+
+    // Another phase at the same time, or another time, gathers again.
+    second.copy(10, VS_COPY_TOP_OF_FRAME) ;
+    EXPECT_TRUE(copied(second_vars)) ;
+    sim[0] = 101 ;
+    first.copy(11, VS_COPY_TOP_OF_FRAME) ;
+    EXPECT_TRUE(copied(first_vars)) ;
+    sim[24] = 102 ;
+    second.copy(11, VS_COPY_TOP_OF_FRAME) ;
+    EXPECT_EQ(101, ((char *)second_vars[1]->buffer_in)[0]) ;
+    EXPECT_EQ(24, ((char *)second_vars[0]->buffer_in)[0]) ;
+
+    // Asynchronous copies always gather and leave the snapshot alone.
+    second.copy(11, VS_COPY_ASYNC) ;
+    EXPECT_TRUE(copied(second_vars)) ;
+    sim[0] = 103 ;
+    first.copy(11, VS_COPY_TOP_OF_FRAME) ;
+    EXPECT_EQ(101, ((char *)first_vars[0]->buffer_in)[0]) ;
+}
+
+}
@@ -32,6 +32,15 @@ int var_add(std::string in_name, std::string in_units) {
     return(0) ;
 }
 
+int var_add_list(std::string in_names) {
+    Trick::VariableServerThread * vst ;
+    vst = get_vst() ;
+    if (vst != NULL ) {
+        vst->var_add_list(in_names) ;
+    }
+    return(0) ;
+}
+
 int var_remove(std::string in_name) {
     Trick::VariableServerThread * vst ;
     vst = get_vst() ;
@@ -165,6 +174,24 @@ int var_binary_nonames() {
     return(0) ;
 }
 
+int var_ascii_round_trip(bool on_off) {
+    Trick::VariableServerThread * vst ;
+    vst = get_vst() ;
+    if (vst != NULL ) {
+        vst->var_ascii_round_trip(on_off) ;
+    }
+    return(0) ;
+}
+
+int var_share_snapshot(bool on_off) {
+    Trick::VariableServerThread * vst ;
+    vst = get_vst() ;
+    if (vst != NULL ) {
+        vst->var_share_snapshot(on_off) ;
+    }
+    return(0) ;
+}
+
 int var_set_copy_mode(int mode) {
     Trick::VariableServerThread * vst ;
     vst = get_vst() ;
@@ -459,6 +486,33 @@ extern "C" void var_server_set_enabled(int on_off) {
     the_vs->set_enabled((bool)on_off) ;
 }
 
+/**
+ * @relates Trick::VariableServer
+ * @copydoc Trick::VariableServer::get_num_event_loops
+ * C wrapper Trick::VariableServer::get_num_event_loops
+ */
+extern "C" unsigned int var_server_get_event_loops() {
+    return(the_vs->get_num_event_loops()) ;
+}
+
+/**
+ * @relates Trick::VariableServer
+ * @copydoc Trick::VariableServer::set_num_event_loops
+ * C wrapper Trick::VariableServer::set_num_event_loops
+ */
+extern "C" void var_server_set_event_loops(unsigned int num_loops) {
+    the_vs->set_num_event_loops(num_loops) ;
+}
+
+/**
+ * @relates Trick::VariableServer
+ * @copydoc Trick::VariableServer::set_event_output_limit
+ * C wrapper Trick::VariableServer::set_event_output_limit
+ */
+extern "C" void var_server_set_event_output_limit(unsigned int in_limit) {
+    the_vs->set_event_output_limit(in_limit) ;
+}
+
 /**
  * @relates Trick::VariableServer
  * @copydoc Trick::VariableServer::create_udp_socket
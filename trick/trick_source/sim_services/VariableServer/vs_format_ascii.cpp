@@ -22,16 +22,30 @@ size_t escape_str(const char *in_s, char *out_s);
 
 #define MAX_VAL_STRLEN 2048
 
-int vs_format_ascii(Trick::VariableReference * var, char *value) {
+/* The formats of the ascii protocol */
+static const Trick::AsciiFloatFormat float_format("%.8g") ;
+static const Trick::AsciiFloatFormat double_format("%.16g") ;
+
+static Trick::AsciiFloatFormat make_round_trip_format() {
+    Trick::AsciiFloatFormat fmt ;
+    fmt.set_round_trip(true) ;
+    return fmt ;
+}
+static const Trick::AsciiFloatFormat round_trip_format = make_round_trip_format() ;
+
+int vs_format_ascii(Trick::VariableReference * var, Trick::AsciiRow & row, bool round_trip) {
 
     /* for string types, return -1 if string is too big to fit in buffer (MAX_VAL_STRLEN) */
     REF2 * ref ;
     ref = var->ref ;
     std::string var_name = ref->reference;
+    char value[MAX_VAL_STRLEN] ;
+    const size_t start = row.length() ;
+    const Trick::AsciiFloatFormat & float_fmt = round_trip ? round_trip_format : float_format ;
+    const Trick::AsciiFloatFormat & double_fmt = round_trip ? round_trip_format : double_format ;
 
     // handle returning an array
     int size = 0 ;
-    value[0] = '\0' ;
     // data to send was copied to buffer in copy_sim_data
     void * buf_ptr = var->buffer_out ;
     while (size < var->size) {
@@ -41,26 +55,28 @@ int vs_format_ascii(Trick::VariableReference * var, char *value) {
 
         case TRICK_CHARACTER:
             if (ref->attr->num_index == ref->num_index) {
-                sprintf(value, "%s%d", value,(char)cv_convert_double(var->conversion_factor, *(char *)buf_ptr));
+                row.append_int((char)cv_convert_double(var->conversion_factor, *(char *)buf_ptr));
             } else {
                 /* All but last dim specified, leaves a char array */
                 escape_str((char *) buf_ptr, value);
+                row.append(value) ;
                 size = var->size ;
             }
             break;
         case TRICK_UNSIGNED_CHARACTER:
             if (ref->attr->num_index == ref->num_index) {
-                sprintf(value, "%s%u", value,(unsigned char)cv_convert_double(var->conversion_factor,*(unsigned char *)buf_ptr));
+                row.append_uint((unsigned char)cv_convert_double(var->conversion_factor,*(unsigned char *)buf_ptr));
             } else {
                 /* All but last dim specified, leaves a char array */
                 escape_str((char *) buf_ptr, value);
+                row.append(value) ;
                 size = var->size ;
             }
             break;
 
         case TRICK_WCHAR:{
                 if (ref->attr->num_index == ref->num_index) {
-                    sprintf(value, "%s%d", value,*(wchar_t *) buf_ptr);
+                    row.append_int(*(wchar_t *) buf_ptr);
                 } else {
                     // convert wide char string char string
                     size_t len = wcs_to_ncs_len((wchar_t *)buf_ptr) + 1 ;
@@ -68,6 +84,7 @@ int vs_format_ascii(Trick::VariableReference * var, char *value) {
                         return (-1);
                     }
                     wcs_to_ncs((wchar_t *) buf_ptr, value, len);
+                    row.append(value) ;
                     size = var->size ;
                 }
             }
@@ -76,9 +93,8 @@ int vs_format_ascii(Trick::VariableReference * var, char *value) {
         case TRICK_STRING:
             if ((char *) buf_ptr != NULL) {
                 escape_str((char *) buf_ptr, value);
+                row.append(value) ;
                 size = var->size ;
-            } else {
-                value[0] = '\0';
             }
             break;
 
@@ -90,24 +106,23 @@ int vs_format_ascii(Trick::VariableReference * var, char *value) {
                     return (-1);
                 }
                 wcs_to_ncs((wchar_t *) buf_ptr, value, len);
+                row.append(value) ;
                 size = var->size ;
-            } else {
-                value[0] = '\0';
             }
             break;
 
 #if ( __linux | __sgi )
         case TRICK_BOOLEAN:
-            sprintf(value, "%s%d", value,(unsigned char)cv_convert_double(var->conversion_factor,*(unsigned char *)buf_ptr));
+            row.append_int((unsigned char)cv_convert_double(var->conversion_factor,*(unsigned char *)buf_ptr));
             break;
 #endif
 
         case TRICK_SHORT:
-            sprintf(value, "%s%d", value, (short)cv_convert_double(var->conversion_factor,*(short *)buf_ptr));
+            row.append_int((short)cv_convert_double(var->conversion_factor,*(short *)buf_ptr));
             break;
 
         case TRICK_UNSIGNED_SHORT:
-            sprintf(value, "%s%u", value,(unsigned short)cv_convert_double(var->conversion_factor,*(unsigned short *)buf_ptr));
+            row.append_uint((unsigned short)cv_convert_double(var->conversion_factor,*(unsigned short *)buf_ptr));
             break;
 
         case TRICK_INTEGER:
@@ -115,34 +130,36 @@ int vs_format_ascii(Trick::VariableReference * var, char *value) {
 #if ( __sun | __APPLE__ )
         case TRICK_BOOLEAN:
 #endif
-            sprintf(value, "%s%d", value, (int)cv_convert_double(var->conversion_factor,*(int *)buf_ptr));
+            row.append_int((int)cv_convert_double(var->conversion_factor,*(int *)buf_ptr));
             break;
 
         case TRICK_BITFIELD:
-            sprintf(value, "%d", GET_BITFIELD(buf_ptr, ref->attr->size, ref->attr->index[0].start, ref->attr->index[0].size));
+            row.rewind(start) ;
+            row.append_int(GET_BITFIELD(buf_ptr, ref->attr->size, ref->attr->index[0].start, ref->attr->index[0].size));
             break;
 
         case TRICK_UNSIGNED_BITFIELD:
-            sprintf(value, "%u", GET_UNSIGNED_BITFIELD(buf_ptr, ref->attr->size, ref->attr->index[0].start, ref->attr->index[0].size));
+            row.rewind(start) ;
+            row.append_uint(GET_UNSIGNED_BITFIELD(buf_ptr, ref->attr->size, ref->attr->index[0].start, ref->attr->index[0].size));
             break;
         case TRICK_UNSIGNED_INTEGER:
-            sprintf(value, "%s%u", value, (unsigned int)cv_convert_double(var->conversion_factor,*(unsigned int *)buf_ptr));
+            row.append_uint((unsigned int)cv_convert_double(var->conversion_factor,*(unsigned int *)buf_ptr));
             break;
 
         case TRICK_LONG:
-            sprintf(value, "%s%ld", value, (long)cv_convert_double(var->conversion_factor,*(long *)buf_ptr));
+            row.append_int((long)cv_convert_double(var->conversion_factor,*(long *)buf_ptr));
             break;
 
         case TRICK_UNSIGNED_LONG:
-            sprintf(value, "%s%lu", value, (unsigned long)cv_convert_double(var->conversion_factor,*(unsigned long *)buf_ptr));
+            row.append_uint((unsigned long)cv_convert_double(var->conversion_factor,*(unsigned long *)buf_ptr));
             break;
 
         case TRICK_FLOAT:
-            sprintf(value, "%s%.8g", value, cv_convert_float(var->conversion_factor,*(float *)buf_ptr));
+            row.append_float(cv_convert_float(var->conversion_factor,*(float *)buf_ptr), float_fmt);
             break;
 
         case TRICK_DOUBLE:
-            sprintf(value, "%s%.16g", value, cv_convert_double(var->conversion_factor,*(double *)buf_ptr));
+            row.append_double(cv_convert_double(var->conversion_factor,*(double *)buf_ptr), double_fmt);
             break;
 
         case TRICK_LONG_LONG:
@@ -151,18 +168,19 @@ int vs_format_ascii(Trick::VariableReference * var, char *value) {
             // The unit conversion calculation will throw floating point exception.
             // For trick_sys.sched.terminate_time, there is no need to perform such conversion.
             if (!var_name.compare("trick_sys.sched.terminate_time")) {
-                    sprintf(value, "%s%lld", value, *(long long *)buf_ptr);
+                    row.append_int(*(long long *)buf_ptr);
             } else {
-                    sprintf(value, "%s%lld", value, (long long)cv_convert_double(var->conversion_factor,*(long long *)buf_ptr));
+                    row.append_int((long long)cv_convert_double(var->conversion_factor,*(long long *)buf_ptr));
             }
             break;
 
         case TRICK_UNSIGNED_LONG_LONG:
-            sprintf(value, "%s%llu", value,(unsigned long long)cv_convert_double(var->conversion_factor,*(unsigned long long *)buf_ptr));
+            row.append_uint((unsigned long long)cv_convert_double(var->conversion_factor,*(unsigned long long *)buf_ptr));
             break;
 
         case TRICK_NUMBER_OF_TYPES:
-            sprintf(value, "BAD_REF" );
+            row.rewind(start) ;
+            row.append("BAD_REF") ;
             break;
 
         default:{
@@ -172,16 +190,18 @@ int vs_format_ascii(Trick::VariableReference * var, char *value) {
 
         if (size < var->size) {
         // if returning an array, continue array as comma separated values
-            strcat(value, ",") ;
+            row.append(',') ;
             buf_ptr = (void*) ((long)buf_ptr + var->ref->attr->size) ;
         }
     } //end while
 
     if (ref->units) {
         if ( ref->attr->mods & TRICK_MODS_UNITSDASHDASH ) {
-            sprintf(value, "%s {--}", value);
+            row.append(" {--}") ;
         } else {
-            sprintf(value, "%s {%s}", value, ref->units);
+            row.append(" {") ;
+            row.append(ref->units) ;
+            row.append('}') ;
         }
     }
 
@@ -1,56 +1,253 @@
 
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include <stdarg.h>
 #include "trick/Interpolator.hh"
 
-double Trick::Interpolator::eval (double param[], unsigned int param_index, unsigned int offset)
-{
+// Number of points interpolated together by evalBatch.
+static const unsigned int batchBlockSize = 64 ;
 
-    double x, x_lower, x_upper;
-    double f_x, f_x_lower, f_x_upper;
-    double *breakPoint;
-    unsigned int breakPointArraySize;
-    unsigned int ii;
+Trick::Interpolator::Interpolator (double* Table, double** BreakPointArrays, unsigned int* BreakPointArraySizes, unsigned int NParams)
+: table(Table),
+  breakPointArrays(BreakPointArrays),
+  breakPointArraySizes(BreakPointArraySizes),
+  nParams(NParams),
+  lastBracket(NParams, 0),
+  strides(NParams, 1) {
 
-    x = param[param_index];
+    unsigned int ii, jj ;
 
-    breakPoint = breakPointArrays[param_index];
-    breakPointArraySize = breakPointArraySizes[param_index];
+    for ( ii = NParams ; ii > 1 ; ii-- ) {
+        strides[ii-2] = strides[ii-1] * breakPointArraySizes[ii-1] ;
+    }
 
-    for ( ii=0 ; ((ii+2 < breakPointArraySize) && (x > breakPoint[ii+1])) ; ii++ ) ;
+    // Corner bit (nParams-1-ii) selects the upper breakpoint of dimension ii, so corners that differ
+    // only in the last dimension are adjacent.
+    cornerOffsets.resize(1u << NParams) ;
+    for ( jj = 0 ; jj < cornerOffsets.size() ; jj++ ) {
+        cornerOffsets[jj] = 0 ;
+        for ( ii = 0 ; ii < NParams ; ii++ ) {
+            if ( jj & (1u << (NParams - 1 - ii)) ) {
+                cornerOffsets[jj] += strides[ii] ;
+            }
+        }
+    }
 
-    x_lower = breakPoint[ii];
-    x_upper = breakPoint[ii+1];
+    weights.resize(2 * NParams) ;
+    corners.resize(cornerOffsets.size()) ;
+}
 
-    if ((x < x_lower) ||  (x > x_upper)) {
+// Returns the index of the first breakpoint interval whose upper breakpoint is not less than x.
+unsigned int Trick::Interpolator::findBracket (unsigned int param_index, double x)
+{
+
+    double *breakPoint = breakPointArrays[param_index];
+    unsigned int last = breakPointArraySizes[param_index] - 2;
+    unsigned int ii = lastBracket[param_index];
+
+    if ((x < breakPoint[0]) ||  (x > breakPoint[last+1])) {
         std::stringstream ss;
 
         ss << "Interpolation parameter[" << param_index << "] is outside of its specified breakpoint range." ;
         throw std::logic_error( ss.str() );
     }
 
-    if (param_index == nParams-1) {
-        f_x_lower = table[offset * breakPointArraySize + ii];
-        f_x_upper = table[offset * breakPointArraySize + ii + 1];
+    if ((x <= breakPoint[ii+1]) && ((ii == 0) || (x > breakPoint[ii]))) {
+        return ii ;
+    }
+
+    if ((ii < last) && (x > breakPoint[ii+1]) && (x <= breakPoint[ii+2])) {
+        ii++ ;
+    } else if ((ii > 0) && (x <= breakPoint[ii]) && ((ii == 1) || (x > breakPoint[ii-1]))) {
+        ii-- ;
     } else {
-        f_x_lower = eval( param, param_index+1, offset * breakPointArraySize + ii);
-        f_x_upper = eval( param, param_index+1, offset * breakPointArraySize + ii + 1);
+        // Binary search for the first upper breakpoint not less than x.  The range check above
+        // guarantees there is one.  Written without a data dependent branch so random lookups do
+        // not pay for mispredictions.
+        const double * upper = breakPoint + 1 ;
+        unsigned int count = last + 1 ;
+        while ( count > 1 ) {
+            unsigned int half = count / 2 ;
+            upper = (upper[half-1] < x) ? upper + half : upper ;
+            count -= half ;
+        }
+        ii = upper - (breakPoint + 1) ;
     }
+    lastBracket[param_index] = ii ;
 
-    f_x = (x_upper - x)/(x_upper - x_lower) * f_x_lower +
-          (x - x_lower)/(x_upper - x_lower) * f_x_upper ;
+    return ii ;
+}
 
-    return(f_x);
+void Trick::Interpolator::precomputeSlopes ()
+{
+
+    double *breakPoint = breakPointArrays[nParams-1];
+    unsigned int breakPointArraySize = breakPointArraySizes[nParams-1];
+    unsigned int tableSize = strides[0] * breakPointArraySizes[0];
+    unsigned int ii;
+
+    slopes.assign(tableSize, 0.0) ;
+    for ( ii = 0 ; ii + 1 < tableSize ; ii++ ) {
+        unsigned int jj = ii % breakPointArraySize ;
+        if ( jj + 1 < breakPointArraySize ) {
+            slopes[ii] = (table[ii+1] - table[ii]) / (breakPoint[jj+1] - breakPoint[jj]) ;
+        }
+    }
+}
 
+void Trick::Interpolator::clearSlopes ()
+{
+    slopes.clear() ;
 }
 
 double Trick::Interpolator::eval (double params[])
 {
 
-    return ( eval( params, 0,0));
+    double x, x_lower, x_upper;
+    double *breakPoint;
+    unsigned int offset = 0;
+    unsigned int nCorners;
+    unsigned int ii, jj;
+
+    for ( ii = 0 ; ii < nParams ; ii++ ) {
+        x = params[ii];
+        breakPoint = breakPointArrays[ii];
+        jj = findBracket(ii, x) ;
+        offset += jj * strides[ii] ;
+
+        x_lower = breakPoint[jj];
+        x_upper = breakPoint[jj+1];
+        weights[2*ii] = (x_upper - x)/(x_upper - x_lower) ;
+        weights[2*ii+1] = (x - x_lower)/(x_upper - x_lower) ;
+    }
+
+    if ( slopes.empty() ) {
+        nCorners = cornerOffsets.size() ;
+        for ( jj = 0 ; jj < nCorners ; jj++ ) {
+            corners[jj] = table[offset + cornerOffsets[jj]] ;
+        }
+        ii = nParams ;
+    } else {
+        // Interpolate the last dimension with the slopes while gathering the corners of the others.
+        breakPoint = breakPointArrays[nParams-1];
+        x = params[nParams-1] - breakPoint[lastBracket[nParams-1]] ;
+        nCorners = cornerOffsets.size() / 2 ;
+        for ( jj = 0 ; jj < nCorners ; jj++ ) {
+            unsigned int corner = offset + cornerOffsets[2*jj] ;
+            corners[jj] = table[corner] + slopes[corner] * x ;
+        }
+        ii = nParams - 1 ;
+    }
+
+    // Interpolate one dimension at a time, last dimension first, halving the corners each time.
+    while ( ii > 0 ) {
+        ii-- ;
+        nCorners /= 2 ;
+        for ( jj = 0 ; jj < nCorners ; jj++ ) {
+            corners[jj] = weights[2*ii] * corners[2*jj] + weights[2*ii+1] * corners[2*jj+1] ;
+        }
+    }
+
+    return(corners[0]);
+}
+
+void Trick::Interpolator::evalBatch (unsigned int nPoints, double params[], double results[])
+{
+
+    unsigned int nCorners = cornerOffsets.size() ;
+    unsigned int first, count;
+    unsigned int ii, jj, pp;
+
+    if ( batchOffsets.size() < batchBlockSize ) {
+        batchOffsets.resize(batchBlockSize) ;
+    }
+    if ( weights.size() < 2 * nParams * batchBlockSize ) {
+        weights.resize(2 * nParams * batchBlockSize) ;
+    }
+    if ( corners.size() < nCorners * batchBlockSize ) {
+        corners.resize(nCorners * batchBlockSize) ;
+    }
+
+    for ( first = 0 ; first < nPoints ; first += count ) {
+
+        count = std::min(batchBlockSize, nPoints - first) ;
+        unsigned int * offsets = &batchOffsets[0] ;
+        double * corner = &corners[0] ;
+
+        // Brackets and weights of each point.
+        for ( pp = 0 ; pp < count ; pp++ ) {
+            offsets[pp] = 0 ;
+        }
+        for ( ii = 0 ; ii < nParams ; ii++ ) {
+            double * breakPoint = breakPointArrays[ii];
+            double * w_lower = &weights[2 * ii * batchBlockSize] ;
+            double * w_upper = w_lower + batchBlockSize ;
+            bool last_with_slopes = (ii == nParams - 1) && !slopes.empty() ;
+            for ( pp = 0 ; pp < count ; pp++ ) {
+                double x = params[(first + pp) * nParams + ii] ;
+                jj = findBracket(ii, x) ;
+                offsets[pp] += jj * strides[ii] ;
+                double x_lower = breakPoint[jj];
+                double x_upper = breakPoint[jj+1];
+                if ( last_with_slopes ) {
+                    w_lower[pp] = x - x_lower ;
+                } else {
+                    w_lower[pp] = (x_upper - x)/(x_upper - x_lower) ;
+                    w_upper[pp] = (x - x_lower)/(x_upper - x_lower) ;
+                }
+            }
+        }
+
+        // Gather the corners of each point.
+        if ( slopes.empty() ) {
+            nCorners = cornerOffsets.size() ;
+            for ( jj = 0 ; jj < nCorners ; jj++ ) {
+                double * value = corner + jj * batchBlockSize ;
+                unsigned int cornerOffset = cornerOffsets[jj] ;
+                for ( pp = 0 ; pp < count ; pp++ ) {
+                    value[pp] = table[offsets[pp] + cornerOffset] ;
+                }
+            }
+            ii = nParams ;
+        } else {
+            double * dx = &weights[2 * (nParams - 1) * batchBlockSize] ;
+            nCorners = cornerOffsets.size() / 2 ;
+            for ( jj = 0 ; jj < nCorners ; jj++ ) {
+                double * value = corner + jj * batchBlockSize ;
+                unsigned int cornerOffset = cornerOffsets[2*jj] ;
+                for ( pp = 0 ; pp < count ; pp++ ) {
+                    unsigned int index = offsets[pp] + cornerOffset ;
+                    value[pp] = table[index] + slopes[index] * dx[pp] ;
+                }
+            }
+            ii = nParams - 1 ;
+        }
+
+        // Interpolate one dimension at a time for all points of the block.
+        while ( ii > 0 ) {
+            ii-- ;
+            nCorners /= 2 ;
+            const double * w_lower = &weights[2 * ii * batchBlockSize] ;
+            const double * w_upper = w_lower + batchBlockSize ;
+            for ( jj = 0 ; jj < nCorners ; jj++ ) {
+                double * value = corner + jj * batchBlockSize ;
+                const double * lower = corner + 2 * jj * batchBlockSize ;
+                const double * upper = lower + batchBlockSize ;
+                for ( pp = 0 ; pp < count ; pp++ ) {
+                    value[pp] = w_lower[pp] * lower[pp] + w_upper[pp] * upper[pp] ;
+                }
+            }
+        }
+
+        for ( pp = 0 ; pp < count ; pp++ ) {
+            results[first + pp] = corner[pp] ;
+        }
+    }
 }
 
+// Variadic arguments cannot be indexed, so they are gathered into an array for eval(double[]).
+// The copy is nParams doubles, small next to the bracket search.
 double Trick::Interpolator::eval (double param1, ...)
 {
 
@@ -58,6 +255,10 @@ double Trick::Interpolator::eval (double param1, ...)
     va_list ap;
     unsigned int i=0;
 
+    if ( nParams > 256 ) {
+        return(0);
+    }
+
     va_start(ap, param1);
     params[i] = param1;
     i++;
@@ -68,9 +269,8 @@ double Trick::Interpolator::eval (double param1, ...)
     va_end(ap);
 
     if (i == nParams ) {
-       return ( eval( params, 0,0));
+       return ( eval( params ));
     } else {
        return(0);
     }
 }
-
@@ -0,0 +1,154 @@
+/*
+   PURPOSE: (Benchmark of Trick::Interpolator against the linear search interpolator it replaced.)
+
+   Evaluates 1 to 4 dimensional tables with 50 breakpoints per dimension, both along a slowly
+   changing trajectory, as an aero or engine table sees from frame to frame, and at random points.
+   Each case is timed with the previous implementation (linear bracket search from the first
+   breakpoint and one recursive call per corner), with eval(), with evalBatch(), and with both after
+   precomputeSlopes().  The largest difference from the previous implementation is reported.
+
+   usage: Interpolator_bench [evaluations]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "trick/Interpolator.hh"
+
+static double wall_time() {
+    struct timeval tv ;
+    gettimeofday(&tv, NULL) ;
+    return tv.tv_sec + tv.tv_usec * 1.0e-6 ;
+}
+
+/* The interpolation of the previous Trick::Interpolator::eval, without its range checks. */
+static double previous_eval( double* table, double** breakPointArrays, unsigned int* breakPointArraySizes,
+ unsigned int nParams, double param[], unsigned int param_index, unsigned int offset) {
+
+    double x, x_lower, x_upper;
+    double f_x_lower, f_x_upper;
+    double *breakPoint = breakPointArrays[param_index];
+    unsigned int breakPointArraySize = breakPointArraySizes[param_index];
+    unsigned int ii;
+
+    x = param[param_index];
+    for ( ii=0 ; ((ii+2 < breakPointArraySize) && (x > breakPoint[ii+1])) ; ii++ ) ;
+
+    x_lower = breakPoint[ii];
+    x_upper = breakPoint[ii+1];
+
+    if (param_index == nParams-1) {
+        f_x_lower = table[offset * breakPointArraySize + ii];
+        f_x_upper = table[offset * breakPointArraySize + ii + 1];
+    } else {
+        f_x_lower = previous_eval( table, breakPointArrays, breakPointArraySizes, nParams, param,
+         param_index+1, offset * breakPointArraySize + ii);
+        f_x_upper = previous_eval( table, breakPointArrays, breakPointArraySizes, nParams, param,
+         param_index+1, offset * breakPointArraySize + ii + 1);
+    }
+
+    return (x_upper - x)/(x_upper - x_lower) * f_x_lower + (x - x_lower)/(x_upper - x_lower) * f_x_upper ;
+}
+
+static void report( const char * name, double seconds, unsigned int evaluations, double max_diff ) {
+    std::cout << "    " << std::setw(20) << std::left << name
+              << std::setw(10) << std::right << std::fixed << std::setprecision(1)
+              << seconds * 1.0e9 / evaluations << " ns/eval"
+              << "    max diff " << std::scientific << std::setprecision(1) << max_diff << std::endl ;
+}
+
+static void run_case( unsigned int nParams, unsigned int evaluations, bool trajectory ) {
+
+    const unsigned int size = 50 ;
+    std::vector< std::vector<double> > breakPoints(nParams) ;
+    std::vector<double*> breakPointArrays(nParams) ;
+    std::vector<unsigned int> breakPointArraySizes(nParams, size) ;
+    unsigned int tableSize = 1 ;
+    unsigned int ii, jj ;
+
+    /* Unevenly spaced breakpoints, as tables usually are. */
+    for ( ii = 0 ; ii < nParams ; ii++ ) {
+        breakPoints[ii].resize(size) ;
+        for ( jj = 0 ; jj < size ; jj++ ) {
+            breakPoints[ii][jj] = jj + 0.3 * sin(jj * 1.7 + ii) ;
+        }
+        breakPointArrays[ii] = &breakPoints[ii][0] ;
+        tableSize *= size ;
+    }
+    std::vector<double> table(tableSize) ;
+    for ( jj = 0 ; jj < tableSize ; jj++ ) {
+        table[jj] = sin(jj * 0.37) + 0.001 * jj ;
+    }
+
+    /* The evaluation points, parameter after parameter. */
+    std::vector<double> params(evaluations * nParams) ;
+    srand(1234) ;
+    for ( jj = 0 ; jj < evaluations ; jj++ ) {
+        for ( ii = 0 ; ii < nParams ; ii++ ) {
+            double fraction ;
+            if ( trajectory ) {
+                fraction = 0.5 + 0.49 * sin(jj * 1.0e-3 * (ii + 1)) ;
+            } else {
+                fraction = (double)rand() / RAND_MAX ;
+            }
+            params[jj * nParams + ii] = breakPoints[ii][0] + fraction * (breakPoints[ii][size-1] - breakPoints[ii][0]) ;
+        }
+    }
+
+    std::vector<double> expected(evaluations) ;
+    std::vector<double> results(evaluations) ;
+    Trick::Interpolator interpolator( &table[0], &breakPointArrays[0], &breakPointArraySizes[0], nParams) ;
+    double start, max_diff ;
+
+    std::cout << nParams << "D table, " << (trajectory ? "trajectory" : "random points") << std::endl ;
+
+    start = wall_time() ;
+    for ( jj = 0 ; jj < evaluations ; jj++ ) {
+        expected[jj] = previous_eval( &table[0], &breakPointArrays[0], &breakPointArraySizes[0], nParams,
+         &params[jj * nParams], 0, 0) ;
+    }
+    report("previous eval", wall_time() - start, evaluations, 0.0) ;
+
+    for ( int slopes = 0 ; slopes < 2 ; slopes++ ) {
+        if ( slopes ) {
+            interpolator.precomputeSlopes() ;
+        }
+
+        start = wall_time() ;
+        for ( jj = 0 ; jj < evaluations ; jj++ ) {
+            results[jj] = interpolator.eval(&params[jj * nParams]) ;
+        }
+        double seconds = wall_time() - start ;
+        for ( max_diff = 0.0, jj = 0 ; jj < evaluations ; jj++ ) {
+            max_diff = std::max(max_diff, fabs(results[jj] - expected[jj])) ;
+        }
+        report(slopes ? "eval, slopes" : "eval", seconds, evaluations, max_diff) ;
+
+        start = wall_time() ;
+        interpolator.evalBatch(evaluations, &params[0], &results[0]) ;
+        seconds = wall_time() - start ;
+        for ( max_diff = 0.0, jj = 0 ; jj < evaluations ; jj++ ) {
+            max_diff = std::max(max_diff, fabs(results[jj] - expected[jj])) ;
+        }
+        report(slopes ? "evalBatch, slopes" : "evalBatch", seconds, evaluations, max_diff) ;
+    }
+}
+
+int main( int argc, char * argv[] ) {
+
+    unsigned int evaluations = 200000 ;
+    if ( argc > 1 ) {
+        evaluations = atoi(argv[1]) ;
+    }
+
+    for ( unsigned int nParams = 1 ; nParams <= 4 ; nParams++ ) {
+        run_case(nParams, evaluations, true) ;
+        run_case(nParams, evaluations, false) ;
+    }
+
+    return 0 ;
+}
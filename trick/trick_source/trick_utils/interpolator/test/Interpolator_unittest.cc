@@ -139,3 +139,75 @@ TEST(Interpolator_unittest, TwoDimension) {
    EXPECT_NEAR(bmi, 28.1, EXCEPTABLE_ERROR);
 
 }
+
+TEST(Interpolator_unittest, CachedBracket) {
+   // Evaluations in any order must not depend on the bracket cached by the previous one.
+
+   double x_bp[] = { 0.0, 1.0, 2.5, 3.0, 4.0, 6.0, 7.0, 9.0 };
+   double y_bp[] = { -1.0, 0.0, 1.0, 3.0 };
+   double* break_point_arrays[2] = { x_bp, y_bp };
+   unsigned int break_point_array_sizes[2] = { 8, 4 };
+   double table[32];
+   for (int ii = 0 ; ii < 32 ; ii++ ) {
+       table[ii] = (ii * 7) % 11 ;
+   }
+
+   Trick::Interpolator cached( table, break_point_arrays, break_point_array_sizes, 2);
+   double params[2];
+   double xs[] = { 0.5, 0.7, 2.0, 2.5, 8.9, 9.0, 0.0, 3.5, 2.6, 1.0, 6.5 };
+   double ys[] = { -1.0, 2.9, 0.0, 0.5, 3.0, -0.5, 1.5, 1.0, 0.1, 2.0, -0.9 };
+
+   for (int ii = 0 ; ii < 11 ; ii++ ) {
+       Trick::Interpolator fresh( table, break_point_arrays, break_point_array_sizes, 2);
+       params[0] = xs[ii];
+       params[1] = ys[ii];
+       EXPECT_EQ(cached.eval(params), fresh.eval(params));
+   }
+}
+
+TEST(Interpolator_unittest, Batch) {
+   // evalBatch must give the same results as eval, and precomputed slopes nearly the same.
+
+   double a_bp[] = { 0.0, 1.0, 2.0, 4.0 };
+   double b_bp[] = { 10.0, 20.0, 25.0 };
+   double c_bp[] = { -1.0, 1.0, 2.0, 3.0, 5.0 };
+   double* break_point_arrays[3] = { a_bp, b_bp, c_bp };
+   unsigned int break_point_array_sizes[3] = { 4, 3, 5 };
+   double table[60];
+   for (int ii = 0 ; ii < 60 ; ii++ ) {
+       table[ii] = (ii * 13) % 17 - 8.0 ;
+   }
+
+   Trick::Interpolator interpolator( table, break_point_arrays, break_point_array_sizes, 3);
+   const unsigned int n_points = 150 ;
+   double params[3 * n_points];
+   double results[n_points];
+   for (unsigned int ii = 0 ; ii < n_points ; ii++ ) {
+       params[3*ii] = 4.0 * ((ii * 37) % 101) / 100.0 ;
+       params[3*ii+1] = 10.0 + 15.0 * ((ii * 53) % 97) / 96.0 ;
+       params[3*ii+2] = -1.0 + 6.0 * ((ii * 29) % 89) / 88.0 ;
+   }
+
+   interpolator.evalBatch( n_points, params, results );
+   for (unsigned int ii = 0 ; ii < n_points ; ii++ ) {
+       EXPECT_EQ(results[ii], interpolator.eval(&params[3*ii]));
+   }
+
+   interpolator.precomputeSlopes();
+   interpolator.evalBatch( n_points, params, results );
+   interpolator.clearSlopes();
+   for (unsigned int ii = 0 ; ii < n_points ; ii++ ) {
+       EXPECT_NEAR(results[ii], interpolator.eval(&params[3*ii]), 1.0e-12);
+   }
+
+   params[3*7+1] = 26.0 ;
+   EXPECT_THROW(interpolator.evalBatch( n_points, params, results ), std::logic_error);
+}
+
+TEST(Interpolator_unittest, NoParameters) {
+   // A table with no parameters evaluates to 0 through the variadic eval, as it always has.
+
+   double table[] = { 5.0 };
+   Trick::Interpolator my_interpolator( table, 0, 0, 0);
+   EXPECT_EQ(0.0, my_interpolator.eval(1.0));
+}
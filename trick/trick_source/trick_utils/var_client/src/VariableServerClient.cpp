@@ -0,0 +1,246 @@
+/*
+PURPOSE:
+    (C++ client of the variable server binary protocol.)
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "trick/VariableServerClient.hh"
+#include "trick/tc_proto.h"
+
+/* Room for several of the server's 8192 byte messages.  The buffer grows when a frame needs more. */
+static const size_t initial_buffer_size = 65536 ;
+
+Trick::VariableServerClient::VariableServerClient() :
+ connected(false) ,
+ buffer(initial_buffer_size) ,
+ begin(0) ,
+ end(0) ,
+ num_frames(0) ,
+ num_bytes(0) {
+    memset(&connection, 0, sizeof(connection)) ;
+}
+
+Trick::VariableServerClient::~VariableServerClient() {
+    disconnect() ;
+}
+
+int Trick::VariableServerClient::connect( const std::string & host , int port , bool send_names ) {
+
+    disconnect() ;
+
+    memset(&connection, 0, sizeof(connection)) ;
+    connection.hostname = strdup(host.c_str()) ;
+    connection.port = port ;
+    connection.disable_handshaking = TC_COMM_TRUE ;
+    connection.blockio_type = TC_COMM_BLOCKIO ;
+    if ( tc_connect(&connection) != TC_SUCCESS ) {
+        free(connection.hostname) ;
+        connection.hostname = NULL ;
+        return -1 ;
+    }
+    connected = true ;
+    begin = end = 0 ;
+
+    // Subscribe in one write.
+    decoder.set_names(send_names) ;
+    std::string commands = send_names ? "trick.var_binary()\n" : "trick.var_binary_nonames()\n" ;
+    for ( unsigned int ii = 0 ; ii < names.size() ; ii++ ) {
+        commands += "trick.var_add(\"" + names[ii] + "\")\n" ;
+    }
+    if ( tc_write(&connection, (char *)commands.c_str(), commands.length()) != (int)commands.length() ) {
+        disconnect() ;
+        return -1 ;
+    }
+    return 0 ;
+}
+
+int Trick::VariableServerClient::disconnect() {
+    if ( connected ) {
+        send_command("trick.var_exit()") ;
+        tc_disconnect(&connection) ;
+        connected = false ;
+    }
+    free(connection.hostname) ;
+    connection.hostname = NULL ;
+    return 0 ;
+}
+
+bool Trick::VariableServerClient::is_connected() const {
+    return connected ;
+}
+
+int Trick::VariableServerClient::send_command( const std::string & command ) {
+    if ( ! connected ) {
+        return -1 ;
+    }
+    std::string line = command + "\n" ;
+    if ( tc_write(&connection, (char *)line.c_str(), line.length()) != (int)line.length() ) {
+        return -1 ;
+    }
+    return 0 ;
+}
+
+int Trick::VariableServerClient::add_variable( const std::string & name , void * dest , unsigned int dest_size ) {
+    names.push_back(name) ;
+    decoder.add_variable(name, dest, dest_size) ;
+    if ( connected ) {
+        return send_command("trick.var_add(\"" + name + "\")") ;
+    }
+    return 0 ;
+}
+
+int Trick::VariableServerClient::clear_variables() {
+    names.clear() ;
+    decoder.clear() ;
+    if ( connected ) {
+        return send_command("trick.var_clear()") ;
+    }
+    return 0 ;
+}
+
+int Trick::VariableServerClient::set_cycle( double period ) {
+    char command[64] ;
+    snprintf(command, sizeof(command), "trick.var_cycle(%.17g)", period) ;
+    return send_command(command) ;
+}
+
+int Trick::VariableServerClient::set_copy_mode( int mode ) {
+    char command[64] ;
+    snprintf(command, sizeof(command), "trick.var_set_copy_mode(%d)", mode) ;
+    return send_command(command) ;
+}
+
+int Trick::VariableServerClient::set_write_mode( int mode ) {
+    char command[64] ;
+    snprintf(command, sizeof(command), "trick.var_set_write_mode(%d)", mode) ;
+    return send_command(command) ;
+}
+
+int Trick::VariableServerClient::pause( bool on_off ) {
+    return send_command(on_off ? "trick.var_pause()" : "trick.var_unpause()") ;
+}
+
+int Trick::VariableServerClient::request_frame() {
+    return send_command("trick.var_send()") ;
+}
+
+int Trick::VariableServerClient::var_exists( const std::string & name ) {
+    if ( send_command("trick.var_exists(\"" + name + "\")") != 0 ) {
+        return -1 ;
+    }
+    if ( wait_for(VariableServerDecoder::EXISTS) != 1 ) {
+        return -1 ;
+    }
+    return decoder.get_message_value() != 0 ;
+}
+
+/*
+   Read what the socket has into the buffer.  The part of the buffer that is not decoded yet, and
+   the frame being decoded, are first moved to the front of the buffer.
+   Returns the number of bytes read, 0 if nothing was there and wait is false, or -1.
+*/
+int Trick::VariableServerClient::read_socket( bool wait ) {
+
+    if ( ! connected ) {
+        return -1 ;
+    }
+
+    size_t keep = decoder.in_frame() ? decoder.get_frame_begin() : begin ;
+    if ( keep > 0 ) {
+        memmove(&buffer[0], &buffer[keep], end - keep) ;
+        end -= keep ;
+        begin -= keep ;
+        decoder.shift(keep) ;
+    }
+    if ( end == buffer.size() ) {
+        buffer.resize(buffer.size() * 2) ;
+    }
+
+    ssize_t ret ;
+    while ( (ret = recv(connection.socket, &buffer[end], buffer.size() - end, wait ? 0 : MSG_DONTWAIT)) < 0 and
+            errno == EINTR ) ;
+
+    if ( ret > 0 ) {
+        end += ret ;
+        num_bytes += ret ;
+        return (int)ret ;
+    }
+    if ( ret < 0 and ! wait and (errno == EAGAIN or errno == EWOULDBLOCK) ) {
+        return 0 ;
+    }
+    // The server closed the connection or it failed.
+    tc_disconnect(&connection) ;
+    connected = false ;
+    return -1 ;
+}
+
+/*
+   Decode the messages in the buffer until one of wanted_kind.
+   Returns 1 when one was decoded, 0 when the buffer ran out first, -1 on a message that cannot be decoded.
+*/
+int Trick::VariableServerClient::decode_buffer( int wanted_kind ) {
+    while ( begin < end ) {
+        int length = decoder.decode(&buffer[0], begin, end) ;
+        if ( length < 0 ) {
+            return -1 ;
+        }
+        if ( length == 0 ) {
+            return 0 ;
+        }
+        begin += length ;
+        if ( decoder.get_message_kind() == VariableServerDecoder::FRAME ) {
+            num_frames++ ;
+        }
+        if ( decoder.get_message_kind() == wanted_kind ) {
+            return 1 ;
+        }
+    }
+    return 0 ;
+}
+
+int Trick::VariableServerClient::wait_for( int wanted_kind ) {
+    int ret ;
+    while ( (ret = decode_buffer(wanted_kind)) == 0 ) {
+        if ( read_socket(true) < 0 ) {
+            return -1 ;
+        }
+    }
+    return ret ;
+}
+
+int Trick::VariableServerClient::receive() {
+    return wait_for(VariableServerDecoder::FRAME) ;
+}
+
+int Trick::VariableServerClient::poll() {
+    int ret ;
+    while ( (ret = decode_buffer(VariableServerDecoder::FRAME)) == 0 ) {
+        ret = read_socket(false) ;
+        if ( ret <= 0 ) {
+            return ret ;
+        }
+    }
+    return ret ;
+}
+
+const std::vector< Trick::VariableServerValue > & Trick::VariableServerClient::get_values() const {
+    return decoder.get_values() ;
+}
+
+unsigned long Trick::VariableServerClient::get_num_frames() const {
+    return num_frames ;
+}
+
+unsigned long Trick::VariableServerClient::get_num_bytes() const {
+    return num_bytes ;
+}
+
+unsigned long Trick::VariableServerClient::get_num_size_mismatches() const {
+    return decoder.get_num_size_mismatches() ;
+}
@@ -0,0 +1,317 @@
+/*
+PURPOSE:
+    (Decodes the binary messages of the variable server.)
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "trick/VariableServerDecoder.hh"
+#include "trick/variable_server_message_types.h"
+#include "trick/parameter_types.h"
+
+/* Longest message the server writes, MAX_MSG_LEN in VariableServerThread_write_data.cpp. */
+static const uint32_t max_message_size = 8192 ;
+
+/* Length of the text header of a VS_STDIO message, "%-2d %1d %8d\n". */
+static const size_t stdio_header_size = 14 ;
+
+static uint32_t swap32( uint32_t value ) {
+    return ((value & 0x000000ff) << 24) | ((value & 0x0000ff00) << 8) |
+           ((value & 0x00ff0000) >> 8) | ((value & 0xff000000) >> 24) ;
+}
+
+static uint32_t read32( const char * data , bool swap ) {
+    uint32_t value ;
+    memcpy(&value, data, sizeof(value)) ;
+    return swap ? swap32(value) : value ;
+}
+
+/* Size of the elements of a value that have to be byte swapped, 1 if none. */
+static unsigned int element_size( int type ) {
+    switch ( type ) {
+        case TRICK_SHORT:
+        case TRICK_UNSIGNED_SHORT:
+            return 2 ;
+        case TRICK_INTEGER:
+        case TRICK_UNSIGNED_INTEGER:
+        case TRICK_BITFIELD:
+        case TRICK_UNSIGNED_BITFIELD:
+        case TRICK_FLOAT:
+        case TRICK_ENUMERATED:
+            return 4 ;
+        case TRICK_DOUBLE:
+        case TRICK_LONG_LONG:
+        case TRICK_UNSIGNED_LONG_LONG:
+            return 8 ;
+        case TRICK_LONG:
+        case TRICK_UNSIGNED_LONG:
+            return sizeof(long) ;
+        case TRICK_WCHAR:
+        case TRICK_WSTRING:
+            return sizeof(wchar_t) ;
+        default:
+            return 1 ;
+    }
+}
+
+static void swap_elements( char * data , unsigned int size , unsigned int elem_size ) {
+    if ( elem_size == 1 or (size % elem_size) != 0 ) {
+        return ;
+    }
+    for ( unsigned int ii = 0 ; ii < size ; ii += elem_size ) {
+        char * lo = data + ii ;
+        char * hi = data + ii + elem_size - 1 ;
+        while ( lo < hi ) {
+            char temp = *lo ;
+            *lo++ = *hi ;
+            *hi-- = temp ;
+        }
+    }
+}
+
+Trick::VariableServerDecoder::VariableServerDecoder() :
+ next_variable(0) ,
+ frame_begin(0) ,
+ names(false) ,
+ server_swapped(false) ,
+ message_kind(VALUES) ,
+ message_value(0) ,
+ num_size_mismatches(0) {}
+
+void Trick::VariableServerDecoder::set_names( bool names_sent ) {
+    names = names_sent ;
+}
+
+unsigned int Trick::VariableServerDecoder::add_variable( const std::string & name , void * dest , unsigned int dest_size ) {
+    Binding binding ;
+    binding.name = name ;
+    binding.dest = dest ;
+    binding.dest_size = dest_size ;
+    binding.type = TRICK_VOID ;
+    binding.size = 0 ;
+    binding.offset = 0 ;
+    bindings.push_back(binding) ;
+
+    VariableServerValue value = { TRICK_VOID , 0 , NULL } ;
+    values.push_back(value) ;
+    return bindings.size() - 1 ;
+}
+
+void Trick::VariableServerDecoder::clear() {
+    bindings.clear() ;
+    values.clear() ;
+    next_variable = 0 ;
+}
+
+unsigned int Trick::VariableServerDecoder::num_variables() const {
+    return bindings.size() ;
+}
+
+Trick::VariableServerDecoder::MessageKind Trick::VariableServerDecoder::get_message_kind() const {
+    return message_kind ;
+}
+
+int Trick::VariableServerDecoder::get_message_value() const {
+    return message_value ;
+}
+
+const std::vector< Trick::VariableServerValue > & Trick::VariableServerDecoder::get_values() const {
+    return values ;
+}
+
+void Trick::VariableServerDecoder::shift( size_t shift ) {
+    if ( next_variable > 0 ) {
+        for ( unsigned int ii = 0 ; ii < next_variable ; ii++ ) {
+            bindings[ii].offset -= shift ;
+        }
+        frame_begin -= shift ;
+    }
+}
+
+size_t Trick::VariableServerDecoder::get_frame_begin() const {
+    return frame_begin ;
+}
+
+bool Trick::VariableServerDecoder::in_frame() const {
+    return next_variable > 0 ;
+}
+
+unsigned long Trick::VariableServerDecoder::get_num_size_mismatches() const {
+    return num_size_mismatches ;
+}
+
+bool Trick::VariableServerDecoder::get_server_swapped() const {
+    return server_swapped ;
+}
+
+void Trick::VariableServerDecoder::store( Binding & binding , char * data , int type , unsigned int size , size_t offset ) {
+
+    if ( server_swapped ) {
+        swap_elements(data, size, element_size(type)) ;
+    }
+    binding.type = type ;
+    binding.size = size ;
+    binding.offset = offset ;
+
+    if ( binding.dest == NULL ) {
+        return ;
+    }
+    if ( type == TRICK_STRING ) {
+        // Strings vary in length.  Copy what fits and terminate.
+        if ( binding.dest_size > 0 ) {
+            unsigned int length = (size < binding.dest_size) ? size : binding.dest_size - 1 ;
+            memcpy(binding.dest, data, length) ;
+            ((char *)binding.dest)[length] = '\0' ;
+        }
+    } else if ( size == binding.dest_size ) {
+        memcpy(binding.dest, data, size) ;
+    } else {
+        memcpy(binding.dest, data, (size < binding.dest_size) ? size : binding.dest_size) ;
+        num_size_mismatches++ ;
+    }
+}
+
+/*
+   A VS_VAR_LIST message is
+       <message type><message size><number of variables>
+   followed for each variable by
+       [<name length><name>]<type><size><value>
+   The message size counts every byte after itself.
+*/
+int Trick::VariableServerDecoder::decode_values( char * buffer , size_t begin , size_t length ) {
+
+    const bool swap = server_swapped ;
+    char * data = buffer + begin + 3 * sizeof(uint32_t) ;
+    char * message_end = buffer + begin + length ;
+    uint32_t count = read32(buffer + begin + 2 * sizeof(uint32_t), swap) ;
+
+    if ( next_variable == 0 ) {
+        frame_begin = begin ;
+    }
+    for ( uint32_t ii = 0 ; ii < count ; ii++ ) {
+        const char * name = NULL ;
+        uint32_t name_length = 0 ;
+        if ( names ) {
+            if ( data + sizeof(uint32_t) > message_end ) {
+                return -1 ;
+            }
+            name_length = read32(data, swap) ;
+            name = data + sizeof(uint32_t) ;
+            data += sizeof(uint32_t) + name_length ;
+        }
+        if ( data + 2 * sizeof(uint32_t) > message_end ) {
+            return -1 ;
+        }
+        int type = (int)read32(data, swap) ;
+        uint32_t size = read32(data + sizeof(uint32_t), swap) ;
+        data += 2 * sizeof(uint32_t) ;
+        if ( data + size > message_end ) {
+            return -1 ;
+        }
+
+        // Variables arrive in the order they were added.  With names, a variable the server
+        // skipped is found by name.
+        unsigned int index = next_variable ;
+        if ( names and ( index >= bindings.size() or
+             bindings[index].name.compare(0, std::string::npos, name, name_length) ) ) {
+            for ( index = 0 ; index < bindings.size() ; index++ ) {
+                if ( ! bindings[index].name.compare(0, std::string::npos, name, name_length) ) {
+                    break ;
+                }
+            }
+        }
+        if ( index < bindings.size() ) {
+            store(bindings[index], data, type, size, data - buffer) ;
+            next_variable = index + 1 ;
+        }
+        data += size ;
+    }
+
+    message_kind = VALUES ;
+    if ( next_variable >= bindings.size() ) {
+        for ( unsigned int ii = 0 ; ii < bindings.size() ; ii++ ) {
+            values[ii].type = bindings[ii].type ;
+            values[ii].size = bindings[ii].size ;
+            values[ii].data = buffer + bindings[ii].offset ;
+        }
+        next_variable = 0 ;
+        message_kind = FRAME ;
+    }
+    return length ;
+}
+
+int Trick::VariableServerDecoder::decode( char * buffer , size_t begin , size_t end ) {
+
+    size_t available = end - begin ;
+    const char * message = buffer + begin ;
+
+    if ( available < sizeof(uint32_t) ) {
+        return 0 ;
+    }
+
+    // Redirected stdio has a text header.
+    if ( message[0] == '0' + VS_STDIO ) {
+        if ( available < stdio_header_size ) {
+            return 0 ;
+        }
+        int type , stream , text_length ;
+        if ( sscanf(message, "%d %d %d", &type, &stream, &text_length) != 3 or text_length < 0 ) {
+            return -1 ;
+        }
+        if ( available < stdio_header_size + text_length ) {
+            return 0 ;
+        }
+        message_kind = STDIO ;
+        message_value = stream ;
+        return stdio_header_size + text_length ;
+    }
+
+    // The message type is not swapped by the server.  Anything but VS_VAR_LIST, which is 0,
+    // shows the byte order of the server.
+    uint32_t type = read32(message, false) ;
+    if ( type > 0xffff ) {
+        type = swap32(type) ;
+        server_swapped = true ;
+    } else if ( type != VS_VAR_LIST ) {
+        server_swapped = false ;
+    }
+
+    switch ( type ) {
+        case VS_VAR_LIST: {
+            if ( available < 3 * sizeof(uint32_t) ) {
+                return 0 ;
+            }
+            uint32_t size = read32(message + sizeof(uint32_t), false) ;
+            server_swapped = ( size > max_message_size ) ;
+            if ( server_swapped ) {
+                size = swap32(size) ;
+            }
+            if ( size > max_message_size ) {
+                return -1 ;
+            }
+            size_t length = sizeof(uint32_t) + size ;
+            if ( available < length ) {
+                return 0 ;
+            }
+            return decode_values(buffer, begin, length) ;
+        }
+        case VS_VAR_EXISTS:
+            if ( available < sizeof(uint32_t) + 1 ) {
+                return 0 ;
+            }
+            message_kind = EXISTS ;
+            message_value = message[sizeof(uint32_t)] ;
+            return sizeof(uint32_t) + 1 ;
+        case VS_LIST_SIZE:
+            if ( available < 3 * sizeof(uint32_t) ) {
+                return 0 ;
+            }
+            message_kind = LIST_SIZE ;
+            message_value = (int)read32(message + 2 * sizeof(uint32_t), server_swapped) ;
+            return 3 * sizeof(uint32_t) ;
+        default:
+            return -1 ;
+    }
+}
@@ -0,0 +1,199 @@
+/*
+   PURPOSE: (Throughput and latency benchmark of Trick::VariableServerClient.)
+
+   Without arguments, times decoding prepared var_binary_nonames frames against parsing the same
+   values from var_ascii text, which is what the Python client does for each frame.
+
+   With the host and port of a running sim, subscribes to the given variables, by default
+   trick_sys.sched.time_tics, and measures
+     - frames and bytes per second at the given var_cycle, with and without names, in the
+       VS_COPY_ASYNC and VS_COPY_SCHEDULED copy modes.
+     - the round trip time of var_send while paused.
+
+   usage: VariableServerClient_bench [host port [cycle [seconds [variable ...]]]]
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "trick/VariableServerClient.hh"
+#include "trick/variable_server_message_types.h"
+#include "trick/variable_server_sync_types.h"
+#include "trick/parameter_types.h"
+
+static double wall_time() {
+    struct timeval tv ;
+    gettimeofday(&tv, NULL) ;
+    return tv.tv_sec + tv.tv_usec * 1.0e-6 ;
+}
+
+static void decode_bench() {
+
+    const unsigned int num_frames = 20000 ;
+    const unsigned int num_vars = 50 ;
+
+    std::vector< char > binary ;
+    std::string ascii ;
+    std::vector< double > dest(num_vars) ;
+    Trick::VariableServerDecoder decoder ;
+
+    for ( unsigned int ii = 0 ; ii < num_vars ; ii++ ) {
+        std::ostringstream name ;
+        name << "sim.values[" << ii << "]" ;
+        decoder.add_variable(name.str(), &dest[ii], sizeof(double)) ;
+    }
+
+    for ( unsigned int ff = 0 ; ff < num_frames ; ff++ ) {
+        uint32_t header[3] = { VS_VAR_LIST , (uint32_t)(2 * sizeof(uint32_t) + num_vars * 16) , num_vars } ;
+        binary.insert(binary.end(), (char *)header, (char *)header + sizeof(header)) ;
+        std::ostringstream line ;
+        line << std::setprecision(17) << VS_VAR_LIST ;
+        for ( unsigned int ii = 0 ; ii < num_vars ; ii++ ) {
+            uint32_t fields[2] = { TRICK_DOUBLE , sizeof(double) } ;
+            double value = ff * 0.001 + ii ;
+            binary.insert(binary.end(), (char *)fields, (char *)fields + sizeof(fields)) ;
+            binary.insert(binary.end(), (char *)&value, (char *)&value + sizeof(value)) ;
+            line << '\t' << value ;
+        }
+        ascii += line.str() + "\n" ;
+    }
+
+    double start = wall_time() ;
+    double sum = 0.0 ;
+    size_t begin = 0 ;
+    int length ;
+    while ( (length = decoder.decode(&binary[0], begin, binary.size())) > 0 ) {
+        begin += length ;
+        sum += dest[num_vars - 1] ;
+    }
+    double binary_time = wall_time() - start ;
+
+    start = wall_time() ;
+    const char * text = ascii.c_str() ;
+    while ( *text ) {
+        char * next ;
+        strtol(text, &next, 10) ;
+        for ( unsigned int ii = 0 ; ii < num_vars ; ii++ ) {
+            dest[ii] = strtod(next, &next) ;
+        }
+        sum -= dest[num_vars - 1] ;
+        text = next + 1 ;
+    }
+    double ascii_time = wall_time() - start ;
+
+    std::cout << "decode " << num_frames << " frames of " << num_vars << " doubles (check " << sum << ")" << std::endl ;
+    std::cout << "  binary " << std::setw(10) << binary.size() << " bytes " << std::setw(10) << binary_time * 1.0e9 / num_frames << " ns/frame" << std::endl ;
+    std::cout << "  ascii  " << std::setw(10) << ascii.size() << " bytes " << std::setw(10) << ascii_time * 1.0e9 / num_frames << " ns/frame" << std::endl ;
+}
+
+static int throughput_bench( const std::string & host , int port , double cycle , double seconds ,
+ const std::vector< std::string > & variables , bool names , int copy_mode ) {
+
+    Trick::VariableServerClient client ;
+    for ( unsigned int ii = 0 ; ii < variables.size() ; ii++ ) {
+        client.add_variable(variables[ii], NULL, 0) ;
+    }
+    if ( client.connect(host, port, names) != 0 ) {
+        std::cerr << "could not connect to " << host << ":" << port << std::endl ;
+        return -1 ;
+    }
+    client.set_copy_mode(copy_mode) ;
+    client.set_cycle(cycle) ;
+
+    // Skip the first frame, it waits for the subscription.
+    if ( client.receive() < 0 ) {
+        return -1 ;
+    }
+    unsigned long frames = client.get_num_frames() ;
+    unsigned long bytes = client.get_num_bytes() ;
+    double start = wall_time() ;
+    double now = start ;
+    while ( now - start < seconds ) {
+        if ( client.receive() < 0 ) {
+            return -1 ;
+        }
+        now = wall_time() ;
+    }
+    frames = client.get_num_frames() - frames ;
+    bytes = client.get_num_bytes() - bytes ;
+
+    std::cout << "  " << (names ? "names  " : "nonames") << " copy mode " << copy_mode
+     << std::setw(12) << frames / (now - start) << " frames/s"
+     << std::setw(12) << bytes / (now - start) / 1024.0 << " KiB/s" << std::endl ;
+    return 0 ;
+}
+
+static int latency_bench( const std::string & host , int port , const std::vector< std::string > & variables ) {
+
+    const unsigned int num_requests = 2000 ;
+    Trick::VariableServerClient client ;
+    std::vector< double > times ;
+
+    for ( unsigned int ii = 0 ; ii < variables.size() ; ii++ ) {
+        client.add_variable(variables[ii], NULL, 0) ;
+    }
+    if ( client.connect(host, port) != 0 ) {
+        return -1 ;
+    }
+    client.pause(true) ;
+    // Frames sent before the pause took effect are read here.
+    double start = wall_time() ;
+    while ( wall_time() - start < 0.2 ) {
+        if ( client.poll() < 0 ) {
+            return -1 ;
+        }
+    }
+
+    for ( unsigned int ii = 0 ; ii < num_requests ; ii++ ) {
+        start = wall_time() ;
+        client.request_frame() ;
+        if ( client.receive() < 0 ) {
+            return -1 ;
+        }
+        times.push_back(wall_time() - start) ;
+    }
+    std::sort(times.begin(), times.end()) ;
+    std::cout << "var_send round trip over " << num_requests << " requests" << std::endl ;
+    std::cout << "  median " << times[num_requests / 2] * 1.0e6 << " us"
+     << "  99% " << times[num_requests * 99 / 100] * 1.0e6 << " us"
+     << "  max " << times.back() * 1.0e6 << " us" << std::endl ;
+    return 0 ;
+}
+
+int main( int argc , char * argv[] ) {
+
+    decode_bench() ;
+    if ( argc < 3 ) {
+        return 0 ;
+    }
+
+    std::string host = argv[1] ;
+    int port = atoi(argv[2]) ;
+    double cycle = (argc > 3) ? atof(argv[3]) : 0.001 ;
+    double seconds = (argc > 4) ? atof(argv[4]) : 5.0 ;
+    std::vector< std::string > variables ;
+    for ( int ii = 5 ; ii < argc ; ii++ ) {
+        variables.push_back(argv[ii]) ;
+    }
+    if ( variables.empty() ) {
+        variables.push_back("trick_sys.sched.time_tics") ;
+    }
+
+    std::cout << variables.size() << " variables every " << cycle << " s for " << seconds << " s" << std::endl ;
+    if ( throughput_bench(host, port, cycle, seconds, variables, false, VS_COPY_ASYNC) or
+         throughput_bench(host, port, cycle, seconds, variables, true, VS_COPY_ASYNC) or
+         throughput_bench(host, port, cycle, seconds, variables, false, VS_COPY_SCHEDULED) or
+         latency_bench(host, port, variables) ) {
+        std::cerr << "the connection failed" << std::endl ;
+        return 1 ;
+    }
+    return 0 ;
+}
@@ -0,0 +1,191 @@
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "trick/VariableServerClient.hh"
+#include "trick/variable_server_message_types.h"
+#include "trick/parameter_types.h"
+
+/* Stands in for the variable server: reads the commands and writes a prepared byte stream. */
+class FakeServer {
+
+    public:
+
+        FakeServer() : listen_socket(-1) , socket(-1) , port(0) , chunk_size(0) {
+            struct sockaddr_in addr ;
+            socklen_t addr_len = sizeof(addr) ;
+            memset(&addr, 0, sizeof(addr)) ;
+            addr.sin_family = AF_INET ;
+            addr.sin_addr.s_addr = inet_addr("127.0.0.1") ;
+            listen_socket = ::socket(AF_INET, SOCK_STREAM, 0) ;
+            bind(listen_socket, (struct sockaddr *)&addr, sizeof(addr)) ;
+            listen(listen_socket, 1) ;
+            getsockname(listen_socket, (struct sockaddr *)&addr, &addr_len) ;
+            port = ntohs(addr.sin_port) ;
+        }
+
+        ~FakeServer() {
+            close(socket) ;
+            close(listen_socket) ;
+        }
+
+        void accept_client() {
+            socket = accept(listen_socket, NULL, NULL) ;
+        }
+
+        /* Reads commands until one that contains text. */
+        void read_until( const std::string & text ) {
+            char buf[1024] ;
+            while ( commands.find(text) == std::string::npos ) {
+                ssize_t ret = recv(socket, buf, sizeof(buf), 0) ;
+                if ( ret <= 0 ) {
+                    return ;
+                }
+                commands.append(buf, ret) ;
+            }
+        }
+
+        /* Writes the stream from another thread in chunks of chunk_size bytes. */
+        void write_stream() {
+            pthread_create(&writer, NULL, write_thread, this) ;
+        }
+
+        void join() {
+            pthread_join(writer, NULL) ;
+        }
+
+        static void * write_thread( void * arg ) {
+            FakeServer * server = (FakeServer *)arg ;
+            size_t chunk = server->chunk_size ? server->chunk_size : server->stream.size() ;
+            for ( size_t ii = 0 ; ii < server->stream.size() ; ii += chunk ) {
+                size_t length = std::min(chunk, server->stream.size() - ii) ;
+                if ( send(server->socket, &server->stream[ii], length, 0) != (ssize_t)length ) {
+                    break ;
+                }
+            }
+            return NULL ;
+        }
+
+        int listen_socket ;
+        int socket ;
+        int port ;
+        std::string commands ;
+        std::vector< char > stream ;
+        size_t chunk_size ;
+        pthread_t writer ;
+} ;
+
+/* Appends a var_binary_nonames message with one double and one int per variable. */
+static void add_message( std::vector< char > & stream , const double * dvalue , const int * ivalue ) {
+    std::vector< char > body ;
+    uint32_t field ;
+    unsigned int count = 0 ;
+    if ( dvalue ) {
+        field = TRICK_DOUBLE ; body.insert(body.end(), (char *)&field, (char *)&field + 4) ;
+        field = sizeof(double) ; body.insert(body.end(), (char *)&field, (char *)&field + 4) ;
+        body.insert(body.end(), (char *)dvalue, (char *)dvalue + sizeof(double)) ;
+        count++ ;
+    }
+    if ( ivalue ) {
+        field = TRICK_INTEGER ; body.insert(body.end(), (char *)&field, (char *)&field + 4) ;
+        field = sizeof(int) ; body.insert(body.end(), (char *)&field, (char *)&field + 4) ;
+        body.insert(body.end(), (char *)ivalue, (char *)ivalue + sizeof(int)) ;
+        count++ ;
+    }
+    uint32_t header[3] = { VS_VAR_LIST , (uint32_t)(body.size() + 8) , count } ;
+    stream.insert(stream.end(), (char *)header, (char *)header + sizeof(header)) ;
+    stream.insert(stream.end(), body.begin(), body.end()) ;
+}
+
+TEST( VariableServerClientTest , Subscribe ) {
+    FakeServer server ;
+    Trick::VariableServerClient client ;
+    double time = 0.0 ;
+    int count = 0 ;
+
+    client.add_variable("trick_sys.sched.time", &time) ;
+    ASSERT_EQ(0, client.connect("127.0.0.1", server.port)) ;
+    EXPECT_TRUE(client.is_connected()) ;
+    client.add_variable("ball.count", &count) ;
+    client.set_cycle(0.1) ;
+    server.accept_client() ;
+    server.read_until("var_cycle") ;
+    EXPECT_NE(std::string::npos, server.commands.find("trick.var_binary_nonames()\n")) ;
+    EXPECT_NE(std::string::npos, server.commands.find("trick.var_add(\"trick_sys.sched.time\")\n")) ;
+    EXPECT_NE(std::string::npos, server.commands.find("trick.var_add(\"ball.count\")\n")) ;
+    EXPECT_NE(std::string::npos, server.commands.find("trick.var_cycle(0.10000000000000001)\n")) ;
+
+    // Frames of two messages each, written a few bytes at a time.
+    const int num_frames = 5000 ;
+    for ( int ii = 0 ; ii < num_frames ; ii++ ) {
+        double dvalue = ii * 0.5 ;
+        add_message(server.stream, &dvalue, NULL) ;
+        add_message(server.stream, NULL, &ii) ;
+    }
+    server.chunk_size = 7 ;
+    server.write_stream() ;
+
+    for ( int ii = 0 ; ii < num_frames ; ii++ ) {
+        ASSERT_EQ(1, client.receive()) ;
+        EXPECT_EQ(ii * 0.5, time) ;
+        EXPECT_EQ(ii, count) ;
+        EXPECT_EQ(0, memcmp(&time, client.get_values()[0].data, sizeof(time))) ;
+    }
+    server.join() ;
+    EXPECT_EQ((unsigned long)num_frames, client.get_num_frames()) ;
+    EXPECT_EQ(server.stream.size(), client.get_num_bytes()) ;
+    EXPECT_EQ(0, client.poll()) ;
+
+    client.disconnect() ;
+    server.read_until("var_exit") ;
+    EXPECT_FALSE(client.is_connected()) ;
+}
+
+TEST( VariableServerClientTest , VarExists ) {
+    FakeServer server ;
+    Trick::VariableServerClient client ;
+    double time = 0.0 ;
+
+    client.add_variable("trick_sys.sched.time", &time) ;
+    ASSERT_EQ(0, client.connect("127.0.0.1", server.port)) ;
+    server.accept_client() ;
+
+    // A frame that arrives before the answer is still decoded.
+    double dvalue = 2.5 ;
+    add_message(server.stream, &dvalue, NULL) ;
+    uint32_t type = VS_VAR_EXISTS ;
+    server.stream.insert(server.stream.end(), (char *)&type, (char *)&type + sizeof(type)) ;
+    server.stream.push_back(1) ;
+    server.write_stream() ;
+
+    EXPECT_EQ(1, client.var_exists("trick_sys.sched.time")) ;
+    server.join() ;
+    EXPECT_EQ(2.5, time) ;
+    EXPECT_EQ(1ul, client.get_num_frames()) ;
+    server.read_until("var_exists") ;
+    EXPECT_NE(std::string::npos, server.commands.find("trick.var_exists(\"trick_sys.sched.time\")\n")) ;
+}
+
+TEST( VariableServerClientTest , ServerCloses ) {
+    FakeServer * server = new FakeServer ;
+    Trick::VariableServerClient client ;
+    double time = 0.0 ;
+
+    client.add_variable("trick_sys.sched.time", &time) ;
+    ASSERT_EQ(0, client.connect("127.0.0.1", server->port)) ;
+    server->accept_client() ;
+    delete server ;
+
+    EXPECT_EQ(-1, client.receive()) ;
+    EXPECT_FALSE(client.is_connected()) ;
+    EXPECT_EQ(-1, client.request_frame()) ;
+}
@@ -0,0 +1,302 @@
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+
+#include "trick/VariableServerDecoder.hh"
+#include "trick/variable_server_message_types.h"
+#include "trick/parameter_types.h"
+
+/* Builds messages the way VariableServerThread::write_binary_data does. */
+class MessageBuilder {
+
+    public:
+
+        MessageBuilder( bool in_names , bool in_swap ) : names(in_names) , swap(in_swap) , count(0) {
+            begin() ;
+        }
+
+        void add( const std::string & name , int type , const void * value , unsigned int size , unsigned int elem_size ) {
+            if ( names ) {
+                put32(name.length()) ;
+                body.insert(body.end(), name.begin(), name.end()) ;
+            }
+            put32(type) ;
+            put32(size) ;
+            const char * bytes = (const char *)value ;
+            for ( unsigned int ii = 0 ; ii < size ; ii += elem_size ) {
+                for ( unsigned int jj = 0 ; jj < elem_size ; jj++ ) {
+                    body.push_back(bytes[ii + (swap ? elem_size - 1 - jj : jj)]) ;
+                }
+            }
+            count++ ;
+        }
+
+        /* Ends the message and appends it to stream. */
+        void end( std::vector< char > & stream ) {
+            uint32_t header[3] ;
+            header[0] = VS_VAR_LIST ;
+            header[1] = order(body.size() + 2 * sizeof(uint32_t)) ;
+            header[2] = order(count) ;
+            stream.insert(stream.end(), (char *)header, (char *)header + sizeof(header)) ;
+            stream.insert(stream.end(), body.begin(), body.end()) ;
+            begin() ;
+        }
+
+        uint32_t order( uint32_t value ) {
+            return swap ? __builtin_bswap32(value) : value ;
+        }
+
+    private:
+
+        void begin() {
+            body.clear() ;
+            count = 0 ;
+        }
+
+        void put32( uint32_t value ) {
+            value = order(value) ;
+            body.insert(body.end(), (char *)&value, (char *)&value + sizeof(value)) ;
+        }
+
+        bool names ;
+        bool swap ;
+        uint32_t count ;
+        std::vector< char > body ;
+} ;
+
+struct State {
+    double position[3] ;
+    int mode ;
+    long long tics ;
+} ;
+
+class VariableServerDecoderTest : public ::testing::Test {
+
+    protected:
+
+        VariableServerDecoderTest() {
+            memset(&state, 0, sizeof(state)) ;
+            position[0] = 1.5 ; position[1] = -2.25 ; position[2] = 1.0e10 ;
+            mode = 7 ;
+            tics = 123456789012LL ;
+        }
+
+        void bind() {
+            decoder.add_variable("ball.position", state.position, sizeof(state.position)) ;
+            decoder.add_variable("ball.mode", &state.mode, sizeof(state.mode)) ;
+            decoder.add_variable("trick_sys.sched.time_tics", &state.tics, sizeof(state.tics)) ;
+        }
+
+        void add_all( MessageBuilder & builder ) {
+            builder.add("ball.position", TRICK_DOUBLE, position, sizeof(position), sizeof(double)) ;
+            builder.add("ball.mode", TRICK_INTEGER, &mode, sizeof(mode), sizeof(int)) ;
+            builder.add("trick_sys.sched.time_tics", TRICK_LONG_LONG, &tics, sizeof(tics), sizeof(long long)) ;
+        }
+
+        void expect_state() {
+            EXPECT_EQ(position[0], state.position[0]) ;
+            EXPECT_EQ(position[1], state.position[1]) ;
+            EXPECT_EQ(position[2], state.position[2]) ;
+            EXPECT_EQ(mode, state.mode) ;
+            EXPECT_EQ(tics, state.tics) ;
+        }
+
+        Trick::VariableServerDecoder decoder ;
+        State state ;
+        double position[3] ;
+        int mode ;
+        long long tics ;
+} ;
+
+TEST_F( VariableServerDecoderTest , NoNames ) {
+    std::vector< char > stream ;
+    MessageBuilder builder(false, false) ;
+    add_all(builder) ;
+    builder.end(stream) ;
+
+    bind() ;
+    EXPECT_EQ((int)stream.size(), decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::FRAME, decoder.get_message_kind()) ;
+    EXPECT_FALSE(decoder.in_frame()) ;
+    expect_state() ;
+    EXPECT_EQ(0u, decoder.get_num_size_mismatches()) ;
+
+    const std::vector< Trick::VariableServerValue > & values = decoder.get_values() ;
+    ASSERT_EQ(3u, values.size()) ;
+    EXPECT_EQ(TRICK_DOUBLE, values[0].type) ;
+    EXPECT_EQ(sizeof(position), values[0].size) ;
+    EXPECT_EQ(0, memcmp(position, values[0].data, sizeof(position))) ;
+    EXPECT_EQ(TRICK_LONG_LONG, values[2].type) ;
+}
+
+TEST_F( VariableServerDecoderTest , Names ) {
+    std::vector< char > stream ;
+    MessageBuilder builder(true, false) ;
+    add_all(builder) ;
+    builder.end(stream) ;
+
+    bind() ;
+    decoder.set_names(true) ;
+    EXPECT_EQ((int)stream.size(), decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::FRAME, decoder.get_message_kind()) ;
+    expect_state() ;
+}
+
+TEST_F( VariableServerDecoderTest , NamesSkippedVariable ) {
+    // The server skips variables that do not fit in a message.
+    std::vector< char > stream ;
+    MessageBuilder builder(true, false) ;
+    builder.add("ball.position", TRICK_DOUBLE, position, sizeof(position), sizeof(double)) ;
+    builder.add("trick_sys.sched.time_tics", TRICK_LONG_LONG, &tics, sizeof(tics), sizeof(long long)) ;
+    builder.end(stream) ;
+
+    bind() ;
+    decoder.set_names(true) ;
+    EXPECT_EQ((int)stream.size(), decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::FRAME, decoder.get_message_kind()) ;
+    EXPECT_EQ(0, state.mode) ;
+    EXPECT_EQ(tics, state.tics) ;
+}
+
+TEST_F( VariableServerDecoderTest , PartialMessages ) {
+    std::vector< char > stream ;
+    MessageBuilder builder(false, false) ;
+    builder.add("ball.position", TRICK_DOUBLE, position, sizeof(position), sizeof(double)) ;
+    builder.end(stream) ;
+    size_t first_length = stream.size() ;
+    builder.add("ball.mode", TRICK_INTEGER, &mode, sizeof(mode), sizeof(int)) ;
+    builder.add("trick_sys.sched.time_tics", TRICK_LONG_LONG, &tics, sizeof(tics), sizeof(long long)) ;
+    builder.end(stream) ;
+
+    bind() ;
+
+    // Nothing is decoded until a message is complete.
+    for ( size_t end = 0 ; end < first_length ; end++ ) {
+        EXPECT_EQ(0, decoder.decode(&stream[0], 0, end)) ;
+    }
+    EXPECT_EQ((int)first_length, decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::VALUES, decoder.get_message_kind()) ;
+    EXPECT_TRUE(decoder.in_frame()) ;
+    EXPECT_EQ(0u, decoder.get_frame_begin()) ;
+
+    EXPECT_EQ(0, decoder.decode(&stream[0], first_length, stream.size() - 1)) ;
+    EXPECT_EQ((int)(stream.size() - first_length), decoder.decode(&stream[0], first_length, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::FRAME, decoder.get_message_kind()) ;
+    expect_state() ;
+}
+
+TEST_F( VariableServerDecoderTest , Shift ) {
+    // A frame whose first message was moved to the front of the buffer before the rest arrived.
+    std::vector< char > stream(100, 'x') ;
+    MessageBuilder builder(false, false) ;
+    builder.add("ball.position", TRICK_DOUBLE, position, sizeof(position), sizeof(double)) ;
+    builder.end(stream) ;
+    size_t first_end = stream.size() ;
+    builder.add("ball.mode", TRICK_INTEGER, &mode, sizeof(mode), sizeof(int)) ;
+    builder.add("trick_sys.sched.time_tics", TRICK_LONG_LONG, &tics, sizeof(tics), sizeof(long long)) ;
+    builder.end(stream) ;
+
+    bind() ;
+    EXPECT_LT(0, decoder.decode(&stream[0], 100, first_end)) ;
+    EXPECT_EQ(100u, decoder.get_frame_begin()) ;
+
+    stream.erase(stream.begin(), stream.begin() + 100) ;
+    decoder.shift(100) ;
+    EXPECT_EQ(0u, decoder.get_frame_begin()) ;
+    EXPECT_LT(0, decoder.decode(&stream[0], first_end - 100, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::FRAME, decoder.get_message_kind()) ;
+    EXPECT_EQ(0, memcmp(position, decoder.get_values()[0].data, sizeof(position))) ;
+}
+
+TEST_F( VariableServerDecoderTest , Swapped ) {
+    std::vector< char > stream ;
+    MessageBuilder builder(true, true) ;
+    add_all(builder) ;
+    builder.end(stream) ;
+
+    bind() ;
+    decoder.set_names(true) ;
+    EXPECT_EQ((int)stream.size(), decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_TRUE(decoder.get_server_swapped()) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::FRAME, decoder.get_message_kind()) ;
+    expect_state() ;
+    EXPECT_EQ(TRICK_INTEGER, decoder.get_values()[1].type) ;
+    EXPECT_EQ(0, memcmp(&mode, decoder.get_values()[1].data, sizeof(mode))) ;
+}
+
+TEST_F( VariableServerDecoderTest , ExistsAndListSize ) {
+    std::vector< char > stream ;
+    uint32_t type = VS_VAR_EXISTS ;
+    stream.insert(stream.end(), (char *)&type, (char *)&type + sizeof(type)) ;
+    stream.push_back(1) ;
+    uint32_t list_size[3] = { VS_LIST_SIZE , 0 , 3 } ;
+    stream.insert(stream.end(), (char *)list_size, (char *)list_size + sizeof(list_size)) ;
+
+    EXPECT_EQ(0, decoder.decode(&stream[0], 0, 4)) ;
+    EXPECT_EQ(5, decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::EXISTS, decoder.get_message_kind()) ;
+    EXPECT_EQ(1, decoder.get_message_value()) ;
+
+    EXPECT_EQ(12, decoder.decode(&stream[0], 5, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::LIST_SIZE, decoder.get_message_kind()) ;
+    EXPECT_EQ(3, decoder.get_message_value()) ;
+}
+
+TEST_F( VariableServerDecoderTest , Stdio ) {
+    std::vector< char > stream ;
+    char header[32] ;
+    snprintf(header, sizeof(header), "%-2d %1d %8d\n", VS_STDIO, 1, 6) ;
+    std::string text = std::string(header) + "hello\n" ;
+    stream.insert(stream.end(), text.begin(), text.end()) ;
+    MessageBuilder builder(false, false) ;
+    add_all(builder) ;
+    builder.end(stream) ;
+
+    bind() ;
+    EXPECT_EQ(0, decoder.decode(&stream[0], 0, 16)) ;
+    EXPECT_EQ((int)text.length(), decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_EQ(Trick::VariableServerDecoder::STDIO, decoder.get_message_kind()) ;
+    EXPECT_LT(0, decoder.decode(&stream[0], text.length(), stream.size())) ;
+    expect_state() ;
+}
+
+TEST_F( VariableServerDecoderTest , StringsAndSizeMismatch ) {
+    std::vector< char > stream ;
+    MessageBuilder builder(false, false) ;
+    std::string name = "a rather long name" ;
+    short small = 5 ;
+    builder.add("ball.name", TRICK_STRING, name.c_str(), name.length(), 1) ;
+    builder.add("ball.small", TRICK_SHORT, &small, sizeof(small), sizeof(small)) ;
+    builder.end(stream) ;
+
+    char text[8] ;
+    int value = -1 ;
+    decoder.add_variable("ball.name", text, sizeof(text)) ;
+    decoder.add_variable("ball.small", &value, sizeof(value)) ;
+    EXPECT_LT(0, decoder.decode(&stream[0], 0, stream.size())) ;
+    EXPECT_STREQ("a rathe", text) ;
+    EXPECT_EQ(1u, decoder.get_num_size_mismatches()) ;
+    EXPECT_EQ(small, *(short *)&value) ;
+    EXPECT_EQ(name.length(), decoder.get_values()[0].size) ;
+}
+
+TEST_F( VariableServerDecoderTest , BadMessages ) {
+    std::vector< char > stream(16, 0) ;
+    uint32_t type = 12345 ;
+    memcpy(&stream[0], &type, sizeof(type)) ;
+    EXPECT_EQ(-1, decoder.decode(&stream[0], 0, stream.size())) ;
+
+    // A value that runs past the end of its message.
+    stream.clear() ;
+    MessageBuilder builder(false, false) ;
+    add_all(builder) ;
+    builder.end(stream) ;
+    uint32_t size = 3 * sizeof(uint32_t) ;
+    memcpy(&stream[sizeof(uint32_t)], &size, sizeof(size)) ;
+    bind() ;
+    EXPECT_EQ(-1, decoder.decode(&stream[0], 0, stream.size())) ;
+}